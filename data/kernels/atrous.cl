@@ -85,3 +85,31 @@ eaw_synthesize (__write_only image2d_t out, __read_only image2d_t coarse, __read
   write_imagef (out, (int2)(x, y), sum);
 }
 
+
+__kernel void
+eaw_zero (__write_only image2d_t out, const int width, const int height)
+{
+  const int x = get_global_id(0);
+  const int y = get_global_id(1);
+
+  if(x >= width || y >= height) return;
+
+  write_imagef (out, (int2)(x, y), (float4)(0.0f));
+}
+
+
+__kernel void
+eaw_addbuffers (__write_only image2d_t out, __read_only image2d_t a, __read_only image2d_t b,
+     const int width, const int height)
+{
+  const int x = get_global_id(0);
+  const int y = get_global_id(1);
+
+  if(x >= width || y >= height) return;
+
+  const float4 pa = read_imagef(a, sampleri, (int2)(x, y));
+  const float4 pb = read_imagef(b, sampleri, (int2)(x, y));
+
+  write_imagef (out, (int2)(x, y), pa + pb);
+}
+
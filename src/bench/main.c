@@ -0,0 +1,332 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2026 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* headless pixelpipe benchmark harness.
+
+   Loads a raw (optionally with an XMP), builds an export pixelpipe just
+   like dt_imageio_export_with_flags() does, runs it a configurable
+   number of warmup and measured iterations and prints machine readable
+   JSON to stdout: per-iop wall time, pixelpipe cache statistics and the
+   peak RSS. Meant to quantify pipeline regressions between builds:
+
+     darktable-benchmark image.raw [image.raw.xmp] [--iterations N]
+*/
+
+#include "common/darktable.h"
+#include "common/exif.h"
+#include "common/film.h"
+#include "common/image.h"
+#include "common/image_cache.h"
+#include "common/mipmap_cache.h"
+#include "develop/develop.h"
+#include "develop/imageop.h"
+#include "develop/pixelpipe.h"
+#include "imageio/imageio_common.h"
+
+#include <glib.h>
+#include <inttypes.h>
+#include <libintl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __APPLE__
+#include "osx/osx.h"
+#endif
+
+#ifdef _WIN32
+#include "win/main_wrapper.h"
+#endif
+
+static void usage(const char *progname)
+{
+  fprintf(stderr,
+          "usage: %s <image file> [xmp file]\n"
+          "  [--iterations <N> (default = 5)] [--warmup <N> (default = 1)]\n"
+          "  [--width <max width>] [--height <max height>]\n"
+          "  [-h, --help; --version]\n"
+          "  [--core <darktable options>]\n"
+          "\n"
+          "Runs the export pixelpipe on the given image and prints JSON\n"
+          "with per-module wall time, pixelpipe cache statistics and the\n"
+          "peak RSS to stdout.\n",
+          progname);
+}
+
+static size_t _peak_rss_mb()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+  return ru.ru_maxrss / (1024lu * 1024lu); // bytes
+#else
+  return ru.ru_maxrss / 1024lu;            // kilobytes
+#endif
+}
+
+int main(int argc, char *arg[])
+{
+#ifdef __APPLE__
+  dt_osx_prepare_environment();
+#endif
+
+  // get valid locale dir
+  dt_loc_init(NULL, NULL, NULL, NULL, NULL, NULL);
+  char localedir[PATH_MAX] = { 0 };
+  dt_loc_get_localedir(localedir, sizeof(localedir));
+  bindtextdomain(GETTEXT_PACKAGE, localedir);
+
+  char *input_filename = NULL;
+  char *xmp_filename = NULL;
+  int iterations = 5;
+  int warmup = 1;
+  int max_width = 0, max_height = 0;
+  int file_counter = 0;
+
+  int k;
+  for(k = 1; k < argc; k++)
+  {
+    if(!strcmp(arg[k], "-h") || !strcmp(arg[k], "--help"))
+    {
+      usage(arg[0]);
+      exit(EXIT_FAILURE);
+    }
+    else if(!strcmp(arg[k], "--version"))
+    {
+      printf("this is darktable-benchmark %s\n", darktable_package_version);
+      exit(EXIT_FAILURE);
+    }
+    else if(!strcmp(arg[k], "--iterations") && argc > k + 1)
+    {
+      k++;
+      iterations = MAX(atoi(arg[k]), 1);
+    }
+    else if(!strcmp(arg[k], "--warmup") && argc > k + 1)
+    {
+      k++;
+      warmup = MAX(atoi(arg[k]), 0);
+    }
+    else if(!strcmp(arg[k], "--width") && argc > k + 1)
+    {
+      k++;
+      max_width = MAX(atoi(arg[k]), 0);
+    }
+    else if(!strcmp(arg[k], "--height") && argc > k + 1)
+    {
+      k++;
+      max_height = MAX(atoi(arg[k]), 0);
+    }
+    else if(!strcmp(arg[k], "--core"))
+    {
+      // everything from here on should be passed to the core
+      k++;
+      break;
+    }
+    else if(arg[k][0] != '-')
+    {
+      if(file_counter == 0)
+        input_filename = arg[k];
+      else if(file_counter == 1)
+        xmp_filename = arg[k];
+      file_counter++;
+    }
+    else
+    {
+      fprintf(stderr, _("warning: unknown option '%s'\n"), arg[k]);
+    }
+  }
+
+  if(!input_filename || file_counter > 2)
+  {
+    usage(arg[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  int m_argc = 0;
+  char **m_arg = malloc(sizeof(char *) * (5 + argc - k + 1));
+  m_arg[m_argc++] = "darktable-benchmark";
+  m_arg[m_argc++] = "--library";
+  m_arg[m_argc++] = ":memory:";
+  m_arg[m_argc++] = "--conf";
+  m_arg[m_argc++] = "write_sidecar_files=never";
+  for(; k < argc; k++) m_arg[m_argc++] = arg[k];
+  m_arg[m_argc] = NULL;
+
+  // init dt without gui and without data.db:
+  if(dt_init(m_argc, m_arg, FALSE, TRUE, NULL))
+  {
+    free(m_arg);
+    exit(EXIT_FAILURE);
+  }
+
+  // the per-piece wall clocks are only maintained with perf debugging on
+  darktable.unmuted |= DT_DEBUG_PERF;
+
+  gchar *directory = g_path_get_dirname(input_filename);
+  dt_film_t film;
+  const dt_filmid_t filmid = dt_film_new(&film, directory);
+  g_free(directory);
+  const dt_imgid_t imgid = dt_image_import(filmid, input_filename, TRUE, TRUE);
+  if(!dt_is_valid_imgid(imgid))
+  {
+    fprintf(stderr, _("error: can't open file %s\n"), input_filename);
+    dt_cleanup();
+    free(m_arg);
+    exit(EXIT_FAILURE);
+  }
+
+  if(xmp_filename)
+  {
+    dt_image_t *image = dt_image_cache_get(imgid, 'w');
+    if(dt_exif_xmp_read(image, xmp_filename, FALSE))
+    {
+      fprintf(stderr, _("error: can't open XMP file %s\n"), xmp_filename);
+      dt_cleanup();
+      free(m_arg);
+      exit(EXIT_FAILURE);
+    }
+    dt_image_cache_write_release(image, DT_IMAGE_CACHE_RELAXED);
+  }
+
+  dt_develop_t dev;
+  dt_dev_init(&dev, FALSE);
+  dt_dev_load_image(&dev, imgid);
+
+  dt_mipmap_buffer_t buf;
+  dt_mipmap_cache_get(&buf, imgid, DT_MIPMAP_FULL, DT_MIPMAP_BLOCKING, 'r');
+  if(!buf.buf || !buf.width || !buf.height)
+  {
+    fprintf(stderr, _("error: can't load image %s\n"), input_filename);
+    dt_dev_cleanup(&dev);
+    dt_cleanup();
+    free(m_arg);
+    exit(EXIT_FAILURE);
+  }
+
+  dt_dev_pixelpipe_t pipe;
+  if(!dt_dev_pixelpipe_init_export(&pipe, buf.width, buf.height,
+                                   IMAGEIO_RGB | IMAGEIO_INT8, FALSE))
+  {
+    fprintf(stderr, _("error: failed to allocate the pixelpipe\n"));
+    dt_mipmap_cache_release(&buf);
+    dt_dev_cleanup(&dev);
+    dt_cleanup();
+    free(m_arg);
+    exit(EXIT_FAILURE);
+  }
+
+  dt_dev_pixelpipe_set_input(&pipe, &dev, (float *)buf.buf,
+                             buf.width, buf.height, buf.iscale);
+  dt_dev_pixelpipe_create_nodes(&pipe, &dev);
+  dt_dev_pixelpipe_synch_all(&pipe, &dev);
+  dt_dev_pixelpipe_get_dimensions(&pipe, &dev, pipe.iwidth, pipe.iheight,
+                                  &pipe.processed_width,
+                                  &pipe.processed_height);
+
+  double scale = 1.0;
+  if(max_width > 0)
+    scale = fmin(scale, (double)max_width / (double)pipe.processed_width);
+  if(max_height > 0)
+    scale = fmin(scale, (double)max_height / (double)pipe.processed_height);
+  const int width = floor(scale * pipe.processed_width);
+  const int height = floor(scale * pipe.processed_height);
+
+  const int pieces = g_list_length(pipe.nodes);
+  double *piece_wall = calloc(pieces, sizeof(double));
+  double wall_sum = 0.0, wall_min = INFINITY, wall_max = 0.0;
+  int failed = 0;
+
+  for(int run = 0; run < warmup + iterations; run++)
+  {
+    for(GList *nodes = pipe.nodes; nodes; nodes = g_list_next(nodes))
+      ((dt_dev_pixelpipe_iop_t *)nodes->data)->process_wall = 0.0;
+
+    // every run shall do the full work
+    dt_dev_pixelpipe_cache_flush(&pipe);
+
+    dt_times_t start, end;
+    dt_get_times(&start);
+    if(dt_dev_pixelpipe_process(&pipe, &dev, 0, 0, width, height, scale,
+                                DT_DEVICE_NONE))
+    {
+      fprintf(stderr, _("error: pixelpipe processing failed\n"));
+      failed = 1;
+      break;
+    }
+    dt_get_times(&end);
+
+    if(run < warmup) continue;
+
+    const double wall = end.clock - start.clock;
+    wall_sum += wall;
+    wall_min = fmin(wall_min, wall);
+    wall_max = fmax(wall_max, wall);
+
+    int n = 0;
+    for(GList *nodes = pipe.nodes; nodes; nodes = g_list_next(nodes), n++)
+      piece_wall[n] += ((dt_dev_pixelpipe_iop_t *)nodes->data)->process_wall;
+  }
+
+  if(!failed)
+  {
+    printf("{\n");
+    printf("  \"file\": \"%s\",\n", input_filename);
+    printf("  \"xmp\": \"%s\",\n", xmp_filename ? xmp_filename : "");
+    printf("  \"width\": %d,\n  \"height\": %d,\n", width, height);
+    printf("  \"warmup\": %d,\n  \"iterations\": %d,\n", warmup, iterations);
+    printf("  \"wall_time\": { \"mean\": %.6f, \"min\": %.6f, \"max\": %.6f },\n",
+           wall_sum / iterations, wall_min, wall_max);
+
+    printf("  \"modules\": [\n");
+    int n = 0;
+    for(GList *nodes = pipe.nodes; nodes; nodes = g_list_next(nodes), n++)
+    {
+      const dt_dev_pixelpipe_iop_t *piece = nodes->data;
+      printf("    { \"op\": \"%s\", \"instance\": %d, \"enabled\": %s,"
+             " \"mean\": %.6f }%s\n",
+             piece->module->op, piece->module->multi_priority,
+             piece->enabled ? "true" : "false",
+             piece_wall[n] / iterations,
+             g_list_next(nodes) ? "," : "");
+    }
+    printf("  ],\n");
+
+    printf("  \"cache\": { \"tests\": %" PRIu64 ", \"hits\": %" PRIu64
+           ", \"hit_rate\": %.3f },\n",
+           pipe.cache.tests, pipe.cache.hits,
+           (double)pipe.cache.hits / fmax(1.0, (double)pipe.cache.tests));
+    printf("  \"peak_rss_mb\": %zu\n", _peak_rss_mb());
+    printf("}\n");
+  }
+
+  free(piece_wall);
+  dt_dev_pixelpipe_cleanup(&pipe);
+  dt_mipmap_cache_release(&buf);
+  dt_dev_cleanup(&dev);
+
+  dt_cleanup();
+  free(m_arg);
+  exit(failed);
+}
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
@@ -46,6 +46,10 @@
 #include <sys/time.h>
 #include <unistd.h>
 
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
 #ifdef __APPLE__
 #include "osx/osx.h"
 #endif
@@ -88,6 +92,24 @@ static void usage(const char *progname) {
 
       "   --hq <0|1|false|true> default: true\n"
       "   --upscale <0|1|false|true>, default: false\n"
+      "   --batch            keep running and serve export requests read\n"
+      "                      from stdin, one per line as\n"
+      "                      'input TAB [xmp] TAB output'; amortizes\n"
+      "                      startup and OpenCL kernel compilation over\n"
+      "                      many renders and reports 'done'/'failed'\n"
+      "                      per request on stdout\n"
+      "   --benchmark <runs> repeat the export <runs> times and report\n"
+      "                      cold/warm wall clock timings on stdout;\n"
+      "                      combine with '--core -d perf' or '-d trace'\n"
+      "                      for per-module attribution\n"
+      "   --parallel <workers> spawn that many isolated worker\n"
+      "                      processes, each exporting a disjoint shard\n"
+      "                      of the job (not supported on Windows)\n"
+      "   --shard <index>/<count> export only every <count>-th image of\n"
+      "                      the import list, starting at <index>\n"
+      "                      (1-based); run one instance per machine\n"
+      "                      with the same inputs and a different index\n"
+      "                      to fan a job out across nodes\n"
       "   --style <style name>\n"
       "   --style-overwrite\n"
       "   --out-ext <extension>, default from output destination or '.jpg'\n"
@@ -205,6 +227,126 @@ static dt_iop_color_intent_t get_icc_intent(const char *option) {
 }
 #undef ICC_INTENT_FROM_STR
 
+// export a single image in batch mode; returns 0 on success
+static int export_one(const char *input, const char *xmp, const char *output,
+                      const int width, const int height,
+                      const gboolean high_quality, const gboolean upscale,
+                      const gboolean export_masks,
+                      const gboolean custom_presets, const char *style,
+                      const gboolean style_overwrite,
+                      const dt_colorspaces_color_profile_type_t icc_type,
+                      const char *icc_filename,
+                      const dt_iop_color_intent_t icc_intent) {
+  gchar *directory = g_path_get_dirname(input);
+  dt_film_t film;
+  const dt_filmid_t filmid = dt_film_new(&film, directory);
+  g_free(directory);
+  const dt_imgid_t id = dt_image_import(filmid, input, TRUE, TRUE);
+  if (!dt_is_valid_imgid(id)) {
+    fprintf(stderr, _("error: can't open file %s"), input);
+    fprintf(stderr, "\n");
+    return 1;
+  }
+
+  if (xmp && *xmp) {
+    dt_image_t *image = dt_image_cache_get(id, 'w');
+    const int err = dt_exif_xmp_read(image, xmp, FALSE);
+    // don't write new xmp:
+    dt_image_cache_write_release(image, DT_IMAGE_CACHE_RELAXED);
+    if (err) {
+      fprintf(stderr, _("error: can't open XMP file %s"), xmp);
+      fprintf(stderr, "\n");
+      return 1;
+    }
+  }
+
+  gchar *filename = g_strdup(output);
+  char *ext = strrchr(filename, '.');
+  if (!ext || strlen(ext) <= 1 ||
+      strlen(ext) > DT_MAX_OUTPUT_EXT_LENGTH + 1) {
+    fprintf(stderr, _("no output file extension given\n"));
+    g_free(filename);
+    return 1;
+  }
+  *ext = '\0';
+  ext++;
+  if (!strcmp(ext, "jpg"))
+    ext = "jpeg";
+  else if (!strcmp(ext, "tif"))
+    ext = "tiff";
+  else if (!strcmp(ext, "jxl"))
+    ext = "jpegxl";
+
+  dt_imageio_module_storage_t *storage = dt_imageio_get_storage_by_name("disk");
+  dt_imageio_module_format_t *format = dt_imageio_get_format_by_name(ext);
+  if (storage == NULL || format == NULL) {
+    fprintf(stderr, _("unknown extension '.%s'"), ext);
+    fprintf(stderr, "\n");
+    g_free(filename);
+    return 1;
+  }
+
+  dt_imageio_module_data_t *sdata = storage->get_params(storage);
+  dt_imageio_module_data_t *fdata = format->get_params(format);
+  if (sdata == NULL || fdata == NULL) {
+    fprintf(stderr, "%s\n",
+            _("failed to get parameters from modules, aborting export ..."));
+    if (sdata)
+      storage->free_params(storage, sdata);
+    if (fdata)
+      format->free_params(format, fdata);
+    g_free(filename);
+    return 1;
+  }
+
+  g_strlcpy((char *)sdata, filename, DT_MAX_PATH_FOR_PARAMS);
+  g_free(filename);
+
+  fdata->max_width = width;
+  fdata->max_height = height;
+  fdata->style[0] = '\0';
+  fdata->style_append = 1;
+  if (style) {
+    g_strlcpy((char *)fdata->style, style, DT_MAX_STYLE_NAME_LENGTH);
+    fdata->style[127] = '\0';
+    if (style_overwrite)
+      fdata->style_append = 0;
+  }
+
+  GList *id_list = g_list_append(NULL, GINT_TO_POINTER(id));
+  if (storage->initialize_store) {
+    storage->initialize_store(storage, sdata, &format, &fdata, &id_list,
+                              high_quality, upscale);
+    format->set_params(format, fdata, format->params_size(format));
+    storage->set_params(storage, sdata, storage->params_size(storage));
+  }
+
+  dt_export_metadata_t metadata;
+  if (custom_presets) {
+    metadata.flags = dt_lib_export_metadata_get_conf_flags();
+    metadata.list =
+        dt_util_str_to_glist("\1", dt_lib_export_metadata_get_conf());
+    if (metadata.list)
+      metadata.list = g_list_remove(metadata.list, metadata.list->data);
+  } else {
+    metadata.flags = dt_lib_export_metadata_default_flags();
+    metadata.list = NULL;
+  }
+
+  const int res = storage->store(storage, sdata, id, format, fdata, 1, 1,
+                                 high_quality, upscale, FALSE, 1.0,
+                                 export_masks, icc_type, icc_filename,
+                                 icc_intent, &metadata) != 0;
+
+  if (storage->finalize_store)
+    storage->finalize_store(storage, sdata);
+  storage->free_params(storage, sdata);
+  format->free_params(format, fdata);
+  g_list_free(id_list);
+
+  return res;
+}
+
 int main(int argc, char *arg[]) {
 #ifdef __APPLE__
   dt_osx_prepare_environment();
@@ -237,6 +379,11 @@ int main(int argc, char *arg[]) {
   gchar *icc_filename = NULL;
   dt_iop_color_intent_t icc_intent = DT_INTENT_LAST;
 
+  int benchmark = 0;
+  int shard_index = 1, shard_count = 1;
+  int parallel = 1;
+  gboolean batch_mode = FALSE;
+
   int k;
   for (k = 1; k < argc; k++) {
     if (arg[k][0] == '-') {
@@ -310,6 +457,29 @@ int main(int argc, char *arg[]) {
           exit(1);
         }
         g_free(str);
+      } else if (!strcmp(arg[k], "--batch")) {
+        batch_mode = TRUE;
+      } else if (!strcmp(arg[k], "--benchmark") && argc > k + 1) {
+        k++;
+        benchmark = MAX(atoi(arg[k]), 0);
+      } else if (!strcmp(arg[k], "--parallel") && argc > k + 1) {
+        k++;
+        parallel = MAX(atoi(arg[k]), 1);
+#ifdef _WIN32
+        if (parallel > 1) {
+          fprintf(stderr,
+                  _("notice: --parallel is not supported on Windows\n"));
+          parallel = 1;
+        }
+#endif
+      } else if (!strcmp(arg[k], "--shard") && argc > k + 1) {
+        k++;
+        if (sscanf(arg[k], "%d/%d", &shard_index, &shard_count) != 2 ||
+            shard_count < 1 || shard_index < 1 || shard_index > shard_count) {
+          fprintf(stderr, "%s: %s\n", _("unknown option for --shard"), arg[k]);
+          usage(arg[0]);
+          exit(1);
+        }
       } else if (!strcmp(arg[k], "--style") && argc > k + 1) {
         k++;
         style = arg[k];
@@ -404,6 +574,58 @@ int main(int argc, char *arg[]) {
     }
   }
 
+#ifndef _WIN32
+  // worker pool: respawn ourselves once per worker with a disjoint
+  // shard of the job. each worker runs a fully isolated process (own
+  // caches, own in-memory library, no shared locks), and a crash on
+  // one image only loses the remainder of that worker's shard
+  if (parallel > 1 && shard_count == 1) {
+    int res = 0;
+    GPid *pids = calloc(parallel, sizeof(GPid));
+    for (int w = 0; w < parallel; w++) {
+      GPtrArray *child = g_ptr_array_new();
+      gchar *shard = g_strdup_printf("%d/%d", w + 1, parallel);
+      g_ptr_array_add(child, arg[0]);
+      g_ptr_array_add(child, "--shard");
+      g_ptr_array_add(child, shard);
+      for (int i = 1; i < argc; i++) {
+        if (!strcmp(arg[i], "--parallel")) {
+          i++; // don't let the workers spawn workers of their own
+          continue;
+        }
+        g_ptr_array_add(child, arg[i]);
+      }
+      g_ptr_array_add(child, NULL);
+      GError *error = NULL;
+      if (!g_spawn_async(NULL, (char **)child->pdata, NULL,
+                         G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD |
+                             G_SPAWN_CHILD_INHERITS_STDIN,
+                         NULL, NULL, &pids[w], &error)) {
+        fprintf(stderr, _("error: can't start worker %d: %s\n"), w + 1,
+                error->message);
+        g_error_free(error);
+        res = 1;
+      }
+      g_ptr_array_free(child, TRUE);
+      g_free(shard);
+    }
+    for (int w = 0; w < parallel; w++) {
+      if (!pids[w])
+        continue;
+      int status = 0;
+      waitpid(pids[w], &status, 0);
+      if (WIFSIGNALED(status))
+        fprintf(stderr, _("error: worker %d crashed with signal %d\n"), w + 1,
+                WTERMSIG(status));
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        res = 1;
+      g_spawn_close_pid(pids[w]);
+    }
+    free(pids);
+    exit(res);
+  }
+#endif
+
   int m_argc = 0;
   char **m_arg = malloc(sizeof(char *) * (5 + argc - k + 1));
   m_arg[m_argc++] = "darktable-cli";
@@ -415,8 +637,9 @@ int main(int argc, char *arg[]) {
     m_arg[m_argc++] = arg[k];
   m_arg[m_argc] = NULL;
 
-  if ((inputs && file_counter < 1) || (!inputs && file_counter < 2) ||
-      file_counter > 3) {
+  if (!batch_mode &&
+      ((inputs && file_counter < 1) || (!inputs && file_counter < 2) ||
+       file_counter > 3)) {
     usage(arg[0]);
     free(m_arg);
     if (output_filename)
@@ -464,7 +687,7 @@ int main(int argc, char *arg[]) {
     input_filename = NULL;
   }
 
-  if (g_file_test(output_filename, G_FILE_TEST_IS_DIR)) {
+  if (!batch_mode && g_file_test(output_filename, G_FILE_TEST_IS_DIR)) {
     output_to_dir = TRUE;
     if (!output_ext) {
       output_ext = g_strdup("jpg");
@@ -483,7 +706,8 @@ int main(int argc, char *arg[]) {
   }
 
   // the output file already exists, so there will be a sequence number added
-  if (g_file_test(output_filename, G_FILE_TEST_EXISTS) && !output_to_dir) {
+  if (!batch_mode && g_file_test(output_filename, G_FILE_TEST_EXISTS) &&
+      !output_to_dir) {
     if (!output_ext ||
         (output_ext && g_str_has_suffix(output_filename, output_ext) &&
          !g_strcmp0(output_ext, strrchr(output_filename, '.') + 1))) {
@@ -507,6 +731,49 @@ int main(int argc, char *arg[]) {
     exit(1);
   }
 
+  // batch mode: the process stays up with warm caches and compiled
+  // OpenCL kernels and serves export requests read from stdin until
+  // EOF, so scripted single-image renders only pay the pipe time
+  if (batch_mode) {
+    char line[3 * PATH_MAX];
+    int res = 0;
+    while (fgets(line, sizeof(line), stdin)) {
+      g_strchomp(line);
+      if (!*line)
+        continue;
+      gchar **fields = g_strsplit(line, "\t", 3);
+      const guint n = g_strv_length(fields);
+      const char *b_input = n > 0 ? fields[0] : NULL;
+      const char *b_xmp = n == 3 ? fields[1] : NULL;
+      const char *b_output = n >= 2 ? fields[n - 1] : NULL;
+      int job = 1;
+      if (b_input && b_output)
+        job = export_one(b_input, b_xmp, b_output, width, height, high_quality,
+                         upscale, export_masks, custom_presets, style,
+                         style_overwrite, icc_type, icc_filename, icc_intent);
+      else
+        fprintf(stderr, _("error: batch request needs input, optional XMP and "
+                          "output separated by tabs\n"));
+      if (job)
+        res = 1;
+      printf("%s\t%s\n", job ? "failed" : "done", b_output ? b_output : "");
+      fflush(stdout);
+      g_strfreev(fields);
+    }
+
+    if (inputs)
+      g_list_free_full(inputs, g_free);
+    if (output_filename)
+      g_free(output_filename);
+    if (output_ext)
+      g_free(output_ext);
+    if (icc_filename)
+      g_free(icc_filename);
+    dt_cleanup();
+    free(m_arg);
+    exit(res);
+  }
+
   GList *id_list = NULL;
 
   for (GList *l = inputs; l != NULL; l = g_list_next(l)) {
@@ -572,6 +839,19 @@ int main(int argc, char *arg[]) {
     g_list_free_full(inputs, g_free);
   inputs = NULL;
 
+  // keep only this shard of the job. the list order is the import
+  // order, so every worker given the same inputs and a different
+  // index selects a disjoint subset
+  if (shard_count > 1) {
+    GList *sharded = NULL;
+    int pos = 0;
+    for (GList *iter = id_list; iter; iter = g_list_next(iter), pos++)
+      if (pos % shard_count == shard_index - 1)
+        sharded = g_list_append(sharded, iter->data);
+    g_list_free(id_list);
+    id_list = sharded;
+  }
+
   const int total = g_list_length(id_list);
 
   if (total == 0) {
@@ -750,25 +1030,57 @@ int main(int argc, char *arg[]) {
 
   // TODO: add a callback to set the bpp without going through the config
 
-  int num = 1, res = 0;
-  for (GList *iter = id_list; iter; iter = g_list_next(iter), num++) {
-    const int id = GPOINTER_TO_INT(iter->data);
-    dt_export_metadata_t metadata;
-    // TODO: have a parameter in command line to get the export presets
-    if (custom_presets) {
-      metadata.flags = dt_lib_export_metadata_get_conf_flags();
-      metadata.list =
-          dt_util_str_to_glist("\1", dt_lib_export_metadata_get_conf());
-      if (metadata.list)
-        metadata.list = g_list_remove(metadata.list, metadata.list->data);
+  // with --benchmark the whole export is repeated; the first run works
+  // on cold caches, later runs profit from whatever decode and mipmap
+  // state the first one left behind
+  const int runs = MAX(benchmark, 1);
+  double *run_wall = benchmark ? calloc(runs, sizeof(double)) : NULL;
+
+  int res = 0;
+  for (int run = 0; run < runs; run++) {
+    const double run_start = dt_get_wtime();
+    int num = 1;
+    for (GList *iter = id_list; iter; iter = g_list_next(iter), num++) {
+      const int id = GPOINTER_TO_INT(iter->data);
+      dt_export_metadata_t metadata;
+      // TODO: have a parameter in command line to get the export presets
+      if (custom_presets) {
+        metadata.flags = dt_lib_export_metadata_get_conf_flags();
+        metadata.list =
+            dt_util_str_to_glist("\1", dt_lib_export_metadata_get_conf());
+        if (metadata.list)
+          metadata.list = g_list_remove(metadata.list, metadata.list->data);
+      } else {
+        metadata.flags = dt_lib_export_metadata_default_flags();
+        metadata.list = NULL;
+      }
+      if (storage->store(storage, sdata, id, format, fdata, num, total,
+                         high_quality, upscale, FALSE, 1.0, export_masks,
+                         icc_type, icc_filename, icc_intent, &metadata) != 0)
+        res = 1;
+    }
+    if (benchmark) {
+      run_wall[run] = dt_get_wtime() - run_start;
+      printf("benchmark;run=%d;%s;wall=%.3f\n", run + 1,
+             run == 0 ? "cold" : "warm", run_wall[run]);
+    }
+  }
+
+  if (benchmark) {
+    if (runs > 1) {
+      double wmin = run_wall[1], wmax = run_wall[1], wsum = 0.0;
+      for (int run = 1; run < runs; run++) {
+        wmin = MIN(wmin, run_wall[run]);
+        wmax = MAX(wmax, run_wall[run]);
+        wsum += run_wall[run];
+      }
+      printf("benchmark;runs=%d;cold=%.3f;warm_min=%.3f;warm_mean=%.3f;"
+             "warm_max=%.3f\n",
+             runs, run_wall[0], wmin, wsum / (runs - 1), wmax);
     } else {
-      metadata.flags = dt_lib_export_metadata_default_flags();
-      metadata.list = NULL;
+      printf("benchmark;runs=1;cold=%.3f\n", run_wall[0]);
     }
-    if (storage->store(storage, sdata, id, format, fdata, num, total,
-                       high_quality, upscale, FALSE, 1.0, export_masks,
-                       icc_type, icc_filename, icc_intent, &metadata) != 0)
-      res = 1;
+    free(run_wall);
   }
 
   // cleanup time
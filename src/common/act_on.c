@@ -58,11 +58,10 @@ static void _insert_in_list(GList **list,
     return;
   }
 
-  const dt_image_t *image = dt_image_cache_get(imgid, 'r');
-  if(image)
+  dt_image_hot_t hot;
+  if(dt_image_cache_get_hot(imgid, &hot))
   {
-    const dt_imgid_t img_group_id = image->group_id;
-    dt_image_cache_read_release(image);
+    const dt_imgid_t img_group_id = hot.group_id;
 
     if(!darktable.gui
        || !darktable.gui->grouping
@@ -129,6 +129,19 @@ size_t dt_bilateral_singlebuffer_size2(const int width, const int height,
 }
 #endif /* !HAVE_OPENCL */
 
+// The iops running the CPU bilateral grid (shadows&highlights,
+// monochrome, ...) create and destroy it on every pipe run, which
+// means a fresh multi-megabyte allocation plus its page faults on
+// every slider move.  Keep the buffer of the most recently freed grid
+// in a single-slot pool and hand it back to the next init if it is
+// large enough; export sized grids beyond the cap are freed normally
+// so the pool never pins more than a bounded amount of memory.
+#define DT_COMMON_BILATERAL_POOL_FLOATS (1 << 24) // 64MB
+
+static float *_grid_pool = NULL;
+static size_t _grid_pool_floats = 0;
+static GMutex _grid_pool_mutex;
+
 static size_t image_to_grid(const dt_bilateral_t *const b, const int i,
                             const int j, const float L, float *xf, float *yf,
                             float *zf) {
@@ -170,8 +183,26 @@ dt_bilateral_init(const int width,     // width of input image
   b->numslices = dt_get_num_threads();
   b->sliceheight = (height + b->numslices - 1) / b->numslices;
   b->slicerows = (b->size_y + b->numslices - 1) / b->numslices + 2;
-  b->buf = dt_calloc_align_float(b->size_x * b->size_z * b->numslices *
-                                 b->slicerows);
+  const size_t bufsize =
+      b->size_x * b->size_z * b->numslices * b->slicerows;
+  b->bufsize = bufsize;
+  b->buf = NULL;
+
+  g_mutex_lock(&_grid_pool_mutex);
+  if (_grid_pool && _grid_pool_floats >= bufsize) {
+    b->buf = _grid_pool;
+    b->bufsize = _grid_pool_floats;
+    _grid_pool = NULL;
+    _grid_pool_floats = 0;
+  }
+  g_mutex_unlock(&_grid_pool_mutex);
+
+  if (b->buf) {
+    // the pooled buffer's pages are already faulted in, so clearing
+    // the part we use is much cheaper than a fresh allocation
+    memset(b->buf, 0, sizeof(float) * bufsize);
+  } else
+    b->buf = dt_calloc_align_float(bufsize);
   if (!b->buf) {
     dt_print(DT_DEBUG_ALWAYS,
              "[bilateral] unable to allocate buffer for %zux%zux%zu grid",
@@ -424,6 +455,15 @@ void dt_bilateral_slice_to_output(const dt_bilateral_t *const b,
 void dt_bilateral_free(dt_bilateral_t *b) {
   if (!b)
     return;
+  if (b->buf && b->bufsize <= DT_COMMON_BILATERAL_POOL_FLOATS) {
+    g_mutex_lock(&_grid_pool_mutex);
+    if (!_grid_pool) {
+      _grid_pool = b->buf;
+      _grid_pool_floats = b->bufsize;
+      b->buf = NULL;
+    }
+    g_mutex_unlock(&_grid_pool_mutex);
+  }
   dt_free_align(b->buf);
   free(b);
 }
@@ -27,6 +27,7 @@ typedef struct dt_bilateral_t
   int numslices, sliceheight, slicerows; //height--in input image, rows--in grid
   float sigma_s, sigma_r;
   float sigma_s_inv, sigma_r_inv;  // reciprocals of sigma_s and sigma_r to avoid divisions
+  size_t bufsize; // allocated grid buffer capacity in floats
   float *buf __attribute__((aligned(64)));
 } __attribute__((packed)) dt_bilateral_t;
 
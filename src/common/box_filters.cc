@@ -386,35 +386,43 @@ static void _box_mean(float *const buf,
   dt_free_align(scanlines);
 }
 
-static inline float _window_max(const float *x, int n)
-{
-  float m = -(FLT_MAX);
-  for(int j = 0; j < n; j++)
-    m = MAX(m, x[j]);
-  return m;
-}
-
 // calculate the one-dimensional moving maximum over a window of size 2*w+1
+// using the van Herk/Gil-Werman algorithm: running maxima restarted at
+// every block boundary (blocks being one window wide) let us combine just
+// one suffix and one prefix value per output pixel, so the cost stays
+// constant regardless of the window size.  'x' is clobbered (it ends up
+// holding the per-block suffix maxima), 'prefix' must have room for N floats
 static inline void box_max_1d(const int N,
-                              const float *const __restrict__ x,
+                              float *const __restrict__ x,
                               float *const __restrict__ y,
+                              float *const __restrict__ prefix,
                               const int w)
 {
-  float m = _window_max(x, MIN(w + 1, N));
+  const int window = 2 * w + 1;
+  // forward pass: running maxima, restarted at every block boundary
+  float m = -(FLT_MAX);
   for(int i = 0; i < N; i++)
   {
-    // store maximum of current window at center position
-    y[i] = m;
-    // if the earliest member of the current window is the max, we need to
-    // rescan the window to determine the new maximum
-    if(i - w >= 0 && x[i - w] == m)
-    {
-      const int start = i - w + 1;
-      m = _window_max(x + start, MIN(i + w + 2, N) - start);
-    }
-    // if the window has not yet exceeded the end of the row/column, update the maximum value
-    if(i + w + 1 < N)
-      m = MAX(x[i + w + 1], m);
+    m = (i % window == 0) ? x[i] : MAX(m, x[i]);
+    prefix[i] = m;
+  }
+  // backward pass: per-block suffix maxima, computed in place
+  for(int i = N - 2; i >= 0; i--)
+  {
+    if((i + 1) % window != 0)
+      x[i] = MAX(x[i], x[i + 1]);
+  }
+  // combine: the window around each pixel spans at most two adjacent blocks
+  for(int i = 0; i < N; i++)
+  {
+    const int l = i - w;
+    const int r = MIN(i + w, N - 1);
+    if(l < 0)
+      y[i] = prefix[r];
+    else if(l / window == r / window)
+      y[i] = x[l];
+    else
+      y[i] = MAX(x[l], prefix[r]);
   }
 }
 
@@ -469,7 +477,8 @@ static void _box_max_1ch(float *const buf,
                         const unsigned w)
 {
   const size_t eff_height = _compute_effective_height(height, w);
-  const size_t scratch_size = MAX(width,MAX(height,MAX_VECT*eff_height));
+  // the horizontal pass needs a second scratch row for the prefix maxima
+  const size_t scratch_size = MAX(2*width,MAX(height,MAX_VECT*eff_height));
   size_t allocsize;
   float *const __restrict__ scratch_buffers = dt_alloc_perthread_float(scratch_size, &allocsize);
   if(scratch_buffers == NULL) return;
@@ -479,7 +488,7 @@ static void _box_max_1ch(float *const buf,
   {
     float *const __restrict__ scratch = (float*)dt_get_perthread(scratch_buffers,allocsize);
     memcpy(scratch, buf + row * width, sizeof(float) * width);
-    box_max_1d(width, scratch, buf + row * width, w);
+    box_max_1d(width, scratch, buf + row * width, scratch + width, w);
   }
   DT_OMP_FOR()
   for(size_t col = 0; col < (width & ~(MAX_VECT-1)); col += MAX_VECT)
@@ -496,29 +505,37 @@ static void _box_max_1ch(float *const buf,
   dt_free_align(scratch_buffers);
 }
 
-static inline float _window_min(const float *x, int n)
-{
-  float m = FLT_MAX;
-  for(int j = 0; j < n; j++)
-    m = MIN(m, x[j]);
-  return m;
-}
-
 // calculate the one-dimensional moving minimum over a window of size 2*w+1
-static inline void _box_min_1d(int N, const float *x, float *y, int w)
+// via van Herk/Gil-Werman, see box_max_1d above for the details.
+// 'x' is clobbered, 'prefix' must have room for N floats
+static inline void _box_min_1d(const int N,
+                               float *const __restrict__ x,
+                               float *const __restrict__ y,
+                               float *const __restrict__ prefix,
+                               const int w)
 {
-  float m = _window_min(x, MIN(w + 1, N));
+  const int window = 2 * w + 1;
+  float m = FLT_MAX;
   for(int i = 0; i < N; i++)
   {
-    y[i] = m;
-    if(i - w >= 0 && x[i - w] == m)
-    {
-      const int start = (i - w + 1);
-      m = _window_min(x + start, MIN((i + w + 2), N) - start);
-    }
-    // if the window has not yet exceeded the end of the row/column, update the minimum value
-    if(i + w + 1 < N)
-      m = MIN(x[i + w + 1], m);
+    m = (i % window == 0) ? x[i] : MIN(m, x[i]);
+    prefix[i] = m;
+  }
+  for(int i = N - 2; i >= 0; i--)
+  {
+    if((i + 1) % window != 0)
+      x[i] = MIN(x[i], x[i + 1]);
+  }
+  for(int i = 0; i < N; i++)
+  {
+    const int l = i - w;
+    const int r = MIN(i + w, N - 1);
+    if(l < 0)
+      y[i] = prefix[r];
+    else if(l / window == r / window)
+      y[i] = x[l];
+    else
+      y[i] = MIN(x[l], prefix[r]);
   }
 }
 
@@ -573,7 +590,8 @@ static void _box_min_1ch(float *const buf,
                         const unsigned w)
 {
   const size_t eff_height = _compute_effective_height(height, w);
-  const size_t scratch_size = MAX(width,MAX(height,MAX_VECT*eff_height));
+  // the horizontal pass needs a second scratch row for the prefix minima
+  const size_t scratch_size = MAX(2*width,MAX(height,MAX_VECT*eff_height));
   size_t allocsize;
   float *const __restrict__ scratch_buffers = dt_alloc_perthread_float(scratch_size,&allocsize);
   if(scratch_buffers == NULL) return;
@@ -583,7 +601,7 @@ static void _box_min_1ch(float *const buf,
   {
     float *const __restrict__ scratch = (float*)dt_get_perthread(scratch_buffers,allocsize);
     memcpy(scratch, buf + row * width, sizeof(float) * width);
-    _box_min_1d(width, scratch, buf + row * width, w);
+    _box_min_1d(width, scratch, buf + row * width, scratch + width, w);
   }
   DT_OMP_FOR()
   for(size_t col = 0; col < (width & ~(MAX_VECT-1)); col += MAX_VECT)
@@ -25,54 +25,94 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-// this implements a concurrent LRU cache
+// this implements a concurrent LRU cache, sharded into independently
+// locked buckets with per-shard LRU lists so threads only serialize
+// when they access the same shard.
+
+static inline dt_cache_shard_t *_get_shard(dt_cache_t *cache,
+                                           const uint32_t key)
+{
+  // multiplicative hashing spreads the imgid/mip bit patterns evenly
+  return &cache->shards[(key * 2654435761u) >> (32 - DT_CACHE_SHARD_BITS)];
+}
+
+static inline void _add_cost(dt_cache_t *cache,
+                             dt_cache_shard_t *shard,
+                             const size_t cost)
+{
+  shard->cost += cost;
+  __atomic_add_fetch(&cache->cost, cost, __ATOMIC_RELAXED);
+}
+
+static inline void _sub_cost(dt_cache_t *cache,
+                             dt_cache_shard_t *shard,
+                             const size_t cost)
+{
+  shard->cost -= cost;
+  __atomic_sub_fetch(&cache->cost, cost, __ATOMIC_RELAXED);
+}
+
+static inline size_t _total_cost(dt_cache_t *cache)
+{
+  return __atomic_load_n(&cache->cost, __ATOMIC_RELAXED);
+}
 
 void dt_cache_init(dt_cache_t *cache,
                    const size_t entry_size,
                    const size_t cost_quota)
 {
   cache->cost = 0;
-  cache->lru = 0;
   cache->entry_size = entry_size;
   cache->cost_quota = cost_quota;
-  dt_pthread_mutex_init(&cache->lock, 0);
   cache->allocate = 0;
   cache->allocate_data = 0;
   cache->cleanup = 0;
   cache->cleanup_data = 0;
-  cache->hashtable = g_hash_table_new(0, 0);
+  for(int s = 0; s < DT_CACHE_NUM_SHARDS; s++)
+  {
+    dt_cache_shard_t *shard = &cache->shards[s];
+    shard->cost = 0;
+    shard->lru = 0;
+    dt_pthread_mutex_init(&shard->lock, 0);
+    shard->hashtable = g_hash_table_new(0, 0);
+  }
 }
 
 void dt_cache_cleanup(dt_cache_t *cache)
 {
-  g_hash_table_destroy(cache->hashtable);
-  for(GList *l = cache->lru; l; l = g_list_next(l))
+  for(int s = 0; s < DT_CACHE_NUM_SHARDS; s++)
   {
-    dt_cache_entry_t *entry = l->data;
-
-    if(cache->cleanup)
+    dt_cache_shard_t *shard = &cache->shards[s];
+    g_hash_table_destroy(shard->hashtable);
+    for(GList *l = shard->lru; l; l = g_list_next(l))
     {
-      assert(entry->data_size);
-      ASAN_UNPOISON_MEMORY_REGION(entry->data, entry->data_size);
+      dt_cache_entry_t *entry = l->data;
 
-      cache->cleanup(cache->cleanup_data, entry);
-    }
-    else
-      dt_free_align(entry->data);
+      if(cache->cleanup)
+      {
+        assert(entry->data_size);
+        ASAN_UNPOISON_MEMORY_REGION(entry->data, entry->data_size);
 
-    dt_pthread_rwlock_destroy(&entry->lock);
-    g_slice_free1(sizeof(*entry), entry);
+        cache->cleanup(cache->cleanup_data, entry);
+      }
+      else
+        dt_free_align(entry->data);
+
+      dt_pthread_rwlock_destroy(&entry->lock);
+      g_slice_free1(sizeof(*entry), entry);
+    }
+    g_list_free(shard->lru);
+    dt_pthread_mutex_destroy(&shard->lock);
   }
-  g_list_free(cache->lru);
-  dt_pthread_mutex_destroy(&cache->lock);
 }
 
 gboolean dt_cache_contains(dt_cache_t *cache,
                           const uint32_t key)
 {
-  dt_pthread_mutex_lock(&cache->lock);
-  const gboolean result = g_hash_table_contains(cache->hashtable, GINT_TO_POINTER(key));
-  dt_pthread_mutex_unlock(&cache->lock);
+  dt_cache_shard_t *shard = _get_shard(cache, key);
+  dt_pthread_mutex_lock(&shard->lock);
+  const gboolean result = g_hash_table_contains(shard->hashtable, GINT_TO_POINTER(key));
+  dt_pthread_mutex_unlock(&shard->lock);
   return result;
 }
 
@@ -84,8 +124,9 @@ dt_cache_entry_t *dt_cache_testget(dt_cache_t *cache,
 {
   gpointer orig_key, value;
   const double start = dt_get_debug_wtime();
-  dt_pthread_mutex_lock(&cache->lock);
-  const gboolean res = g_hash_table_lookup_extended(cache->hashtable,
+  dt_cache_shard_t *shard = _get_shard(cache, key);
+  dt_pthread_mutex_lock(&shard->lock);
+  const gboolean res = g_hash_table_lookup_extended(shard->hashtable,
                                                     GINT_TO_POINTER(key),
                                                     &orig_key,
                                                     &value);
@@ -99,13 +140,13 @@ dt_cache_entry_t *dt_cache_testget(dt_cache_t *cache,
     if(result)
     { // need to give up mutex so other threads have a chance to get in between and
       // free the lock we're trying to acquire:
-      dt_pthread_mutex_unlock(&cache->lock);
+      dt_pthread_mutex_unlock(&shard->lock);
       return NULL;
     }
     // bubble up in lru list:
-    cache->lru = g_list_remove_link(cache->lru, entry->link);
-    cache->lru = g_list_concat(cache->lru, entry->link);
-    dt_pthread_mutex_unlock(&cache->lock);
+    shard->lru = g_list_remove_link(shard->lru, entry->link);
+    shard->lru = g_list_concat(shard->lru, entry->link);
+    dt_pthread_mutex_unlock(&shard->lock);
     const double end = dt_get_debug_wtime();
     if(end - start > 0.1)
       dt_print(DT_DEBUG_ALWAYS, "try+ wait time %.06fs mode %c", end - start, mode);
@@ -120,7 +161,7 @@ dt_cache_entry_t *dt_cache_testget(dt_cache_t *cache,
 
     return entry;
   }
-  dt_pthread_mutex_unlock(&cache->lock);
+  dt_pthread_mutex_unlock(&shard->lock);
   const double end = dt_get_debug_wtime();
   if(end - start > 0.1)
     dt_print(DT_DEBUG_ALWAYS, "try- wait time %.06fs", end - start);
@@ -138,9 +179,11 @@ dt_cache_entry_t *dt_cache_get_with_caller(dt_cache_t *cache,
 {
   gpointer orig_key, value;
   const double start = dt_get_debug_wtime();
+  dt_cache_shard_t *shard = _get_shard(cache, key);
+  gboolean tried_gc = FALSE;
 restart:
-  dt_pthread_mutex_lock(&cache->lock);
-  const gboolean res = g_hash_table_lookup_extended(cache->hashtable,
+  dt_pthread_mutex_lock(&shard->lock);
+  const gboolean res = g_hash_table_lookup_extended(shard->hashtable,
                                                     GINT_TO_POINTER(key),
                                                     &orig_key,
                                                     &value);
@@ -153,14 +196,14 @@ restart:
     if(result)
     { // need to give up mutex so other threads have a chance to get in between and
       // free the lock we're trying to acquire:
-      dt_pthread_mutex_unlock(&cache->lock);
+      dt_pthread_mutex_unlock(&shard->lock);
       g_usleep(5);
       goto restart;
     }
     // bubble up in lru list:
-    cache->lru = g_list_remove_link(cache->lru, entry->link);
-    cache->lru = g_list_concat(cache->lru, entry->link);
-    dt_pthread_mutex_unlock(&cache->lock);
+    shard->lru = g_list_remove_link(shard->lru, entry->link);
+    shard->lru = g_list_concat(shard->lru, entry->link);
+    dt_pthread_mutex_unlock(&shard->lock);
 
 #ifdef _DEBUG
     const pthread_t writer = dt_pthread_rwlock_get_writer(&entry->lock);
@@ -189,10 +232,14 @@ restart:
 
   // first try to clean up.
   // also wait if we can't free more than the requested fill ratio.
-  if(cache->cost > 0.8f * cache->cost_quota)
+  // we drop our shard lock for that so the eviction pass can walk all
+  // shards without any lock nesting.
+  if(!tried_gc && _total_cost(cache) > 0.8f * cache->cost_quota)
   {
-    // need to roll back all the way to get a consistent lock state:
+    tried_gc = TRUE;
+    dt_pthread_mutex_unlock(&shard->lock);
     dt_cache_gc(cache, 0.8f);
+    goto restart;
   }
 
   // here dies your 32-bit system:
@@ -206,7 +253,7 @@ restart:
   entry->key = key;
   entry->_lock_demoting = FALSE;
 
-  g_hash_table_insert(cache->hashtable, GINT_TO_POINTER(key), entry);
+  g_hash_table_insert(shard->hashtable, GINT_TO_POINTER(key), entry);
 
   assert(cache->allocate || entry->data_size);
 
@@ -226,12 +273,12 @@ restart:
   else
     dt_pthread_rwlock_rdlock_with_caller(&entry->lock, file, line);
 
-  cache->cost += entry->cost;
+  _add_cost(cache, shard, entry->cost);
 
   // put at end of lru list (most recently used):
-  cache->lru = g_list_concat(cache->lru, entry->link);
+  shard->lru = g_list_concat(shard->lru, entry->link);
 
-  dt_pthread_mutex_unlock(&cache->lock);
+  dt_pthread_mutex_unlock(&shard->lock);
   const double end = dt_get_debug_wtime();
   if(end - start > 0.1)
     dt_print(DT_DEBUG_ALWAYS, "wait time %.06fs", end - start);
@@ -246,23 +293,24 @@ gboolean dt_cache_remove(dt_cache_t *cache,
 {
   dt_cache_entry_t *entry;
   gpointer orig_key, value;
+  dt_cache_shard_t *shard = _get_shard(cache, key);
 restart:
-  dt_pthread_mutex_lock(&cache->lock);
+  dt_pthread_mutex_lock(&shard->lock);
 
-  const gboolean res = g_hash_table_lookup_extended(cache->hashtable,
+  const gboolean res = g_hash_table_lookup_extended(shard->hashtable,
                                                     GINT_TO_POINTER(key),
                                                     &orig_key,
                                                     &value);
   entry = (dt_cache_entry_t *)value;
   if(!res)
   { // not found in cache, not deleting.
-    dt_pthread_mutex_unlock(&cache->lock);
+    dt_pthread_mutex_unlock(&shard->lock);
     return TRUE;
   }
   // need write lock to be able to delete:
   if(dt_pthread_rwlock_trywrlock(&entry->lock))
   {
-    dt_pthread_mutex_unlock(&cache->lock);
+    dt_pthread_mutex_unlock(&shard->lock);
     g_usleep(5);
     goto restart;
   }
@@ -272,15 +320,15 @@ restart:
     // oops, we are currently demoting (rw -> r) lock to this entry in
     // some thread. do not touch!
     dt_pthread_rwlock_unlock(&entry->lock);
-    dt_pthread_mutex_unlock(&cache->lock);
+    dt_pthread_mutex_unlock(&shard->lock);
     g_usleep(5);
     goto restart;
   }
 
-  const gboolean removed = g_hash_table_remove(cache->hashtable, GINT_TO_POINTER(key));
+  const gboolean removed = g_hash_table_remove(shard->hashtable, GINT_TO_POINTER(key));
   (void)removed; // make non-assert compile happy
   assert(removed);
-  cache->lru = g_list_delete_link(cache->lru, entry->link);
+  shard->lru = g_list_delete_link(shard->lru, entry->link);
 
   if(cache->cleanup)
   {
@@ -294,19 +342,19 @@ restart:
 
   dt_pthread_rwlock_unlock(&entry->lock);
   dt_pthread_rwlock_destroy(&entry->lock);
-  cache->cost -= entry->cost;
+  _sub_cost(cache, shard, entry->cost);
   g_slice_free1(sizeof(*entry), entry);
 
-  dt_pthread_mutex_unlock(&cache->lock);
+  dt_pthread_mutex_unlock(&shard->lock);
   return FALSE;
 }
 
-// best-effort garbage collection. never blocks, never fails. well,
-// sometimes it just doesn't free anything.
-void dt_cache_gc(dt_cache_t *cache,
-                 const float fill_ratio)
+// evict from one shard, lock held by caller
+static void _shard_gc(dt_cache_t *cache,
+                      dt_cache_shard_t *shard,
+                      const float fill_ratio)
 {
-  GList *l = cache->lru;
+  GList *l = shard->lru;
   while(l)
   {
     dt_cache_entry_t *entry = l->data;
@@ -314,7 +362,7 @@ void dt_cache_gc(dt_cache_t *cache,
     l = g_list_next(l); // we might remove this element, so walk to
                         // the next one while we still have the
                         // pointer..
-    if(cache->cost < cache->cost_quota * fill_ratio)
+    if(_total_cost(cache) < cache->cost_quota * fill_ratio)
       break;
 
     // if still locked by anyone else give up:
@@ -330,9 +378,9 @@ void dt_cache_gc(dt_cache_t *cache,
     }
 
     // delete!
-    g_hash_table_remove(cache->hashtable, GINT_TO_POINTER(entry->key));
-    cache->lru = g_list_delete_link(cache->lru, entry->link);
-    cache->cost -= entry->cost;
+    g_hash_table_remove(shard->hashtable, GINT_TO_POINTER(entry->key));
+    shard->lru = g_list_delete_link(shard->lru, entry->link);
+    _sub_cost(cache, shard, entry->cost);
 
     if(cache->cleanup)
     {
@@ -350,6 +398,26 @@ void dt_cache_gc(dt_cache_t *cache,
   }
 }
 
+// best-effort garbage collection. never blocks, never fails. well,
+// sometimes it just doesn't free anything. locks one shard at a time
+// so it never nests shard locks.
+void dt_cache_gc(dt_cache_t *cache,
+                 const float fill_ratio)
+{
+  for(int s = 0; s < DT_CACHE_NUM_SHARDS; s++)
+  {
+    if(_total_cost(cache) < cache->cost_quota * fill_ratio)
+      break;
+
+    dt_cache_shard_t *shard = &cache->shards[s];
+    if(dt_pthread_mutex_trylock(&shard->lock))
+      continue; // contended shard, the holder will clean up on its next miss
+
+    _shard_gc(cache, shard, fill_ratio);
+    dt_pthread_mutex_unlock(&shard->lock);
+  }
+}
+
 void dt_cache_release_with_caller(dt_cache_t *cache,
                                   dt_cache_entry_t *entry,
                                   const char *file,
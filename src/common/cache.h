@@ -37,17 +37,27 @@ typedef struct dt_cache_entry_t
 typedef void((*dt_cache_allocate_t)(void *userdata, dt_cache_entry_t *entry));
 typedef void((*dt_cache_cleanup_t)(void *userdata, dt_cache_entry_t *entry));
 
+#define DT_CACHE_SHARD_BITS 4
+#define DT_CACHE_NUM_SHARDS (1 << DT_CACHE_SHARD_BITS)
+
+typedef struct dt_cache_shard_t
+{
+  dt_pthread_mutex_t lock;
+  GHashTable *hashtable; // stores (key, entry) pairs
+  GList *lru;            // last element is most recently used, first is about to be kicked from cache.
+  size_t cost;           // cost of the entries held by this shard
+} dt_cache_shard_t;
+
 typedef struct dt_cache_t
 {
-  dt_pthread_mutex_t lock; // big fat lock. we're only expecting a couple hand full of cpu threads to use this concurrently.
+  // keys are spread over independently locked shards so get/release from
+  // many threads only serialize when they hit the same shard.
+  dt_cache_shard_t shards[DT_CACHE_NUM_SHARDS];
 
   size_t entry_size; // cache line allocation
-  size_t cost;       // user supplied cost per cache line (bytes?)
+  size_t cost;       // aggregate cost over all shards, updated atomically
   size_t cost_quota; // quota to try and meet. but don't use as hard limit.
 
-  GHashTable *hashtable; // stores (key, entry) pairs
-  GList *lru;            // last element is most recently used, first is about to be kicked from cache.
-
   // callback functions for cache misses/garbage collection
   dt_cache_allocate_t allocate;
   dt_cache_allocate_t cleanup;
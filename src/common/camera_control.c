@@ -369,50 +369,24 @@ static void _camera_process_job(const dt_camctl_t *c,
       // gp_file_get_data_and_size returns GP_OK.
       else if(data && data_size > 0)
       {
-        // everything worked
-        dt_imageio_jpeg_t jpg;
-        if(dt_imageio_jpeg_decompress_header(data, data_size, &jpg))
+        // hand the still compressed preview over to the decoder thread
+        // so the camera can be asked for the next frame right away. the
+        // CameraFile carries the jpeg data, no copy is made. if the
+        // decoder hasn't picked up the previous frame yet it is stale
+        // anyway, so drop it in favor of this one.
+        dt_pthread_mutex_lock(&cam->live_view_pending_mutex);
+        if(cam->live_view_pending)
         {
-          dt_print(DT_DEBUG_CAMCTL,
-                   "[camera_control] live view failed to decompress jpeg header");
-        }
-        else
-        {
-          // FIXME: is the live view ever tagged with a profile?
-          // testing so far (limited to Canon EOS 5D Mark III) hasn't
-          // found one
-          // dt_colorspaces_color_profile_type_t color_space = dt_imageio_jpeg_read_color_space(&jpg);
-          //if(color_space == DT_COLORSPACE_DISPLAY)
-          //  color_space = DT_COLORSPACE_SRGB;
-          // no embedded colorspace, assume is sRGB
-          uint8_t *const buffer =
-            (uint8_t *)dt_alloc_align_uint8(4 * jpg.width * jpg.height);
-          if(!buffer)
-          {
-            dt_print(DT_DEBUG_CAMCTL,
-                     "[camera_control] live view could not allocate image buffer");
-          }
-          else if(dt_imageio_jpeg_decompress(&jpg, buffer))
-          {
-            dt_print(DT_DEBUG_CAMCTL,
-                     "[camera_control] live view failed to decompress jpeg");
-          }
-          else
-          {
-            dt_pthread_mutex_lock(&cam->live_view_buffer_mutex);
-            // FIXME: don't need to alloc/dealloc if the image dimensions haven't changed
-            if(cam->live_view_buffer) dt_free_align(cam->live_view_buffer);
-            cam->live_view_buffer = buffer;
-            cam->live_view_width = jpg.width;
-            cam->live_view_height = jpg.height;
-            //cam->live_view_color_space = color_space;
-            dt_pthread_mutex_unlock(&cam->live_view_buffer_mutex);
-          }
+          gp_file_free(cam->live_view_pending);
+          cam->live_view_dropped++;
         }
+        cam->live_view_pending = fp;
+        fp = NULL;
+        pthread_cond_signal(&cam->live_view_pending_cond);
+        dt_pthread_mutex_unlock(&cam->live_view_pending_mutex);
       }
       if(fp) gp_file_free(fp);
       dt_pthread_mutex_BAD_unlock(&cam->live_view_synch);
-      dt_control_queue_redraw_center();
     }
     break;
 
@@ -565,6 +539,90 @@ static void _camera_process_job(const dt_camctl_t *c,
 /* LIVE VIEW */
 /*************/
 
+static void *dt_camctl_camera_decode_live_view(void *data)
+{
+  dt_camctl_t *camctl = (dt_camctl_t *)data;
+  dt_camera_t *cam = (dt_camera_t *)camctl->active_camera;
+
+  dt_pthread_setname("live view decode");
+
+  dt_print(DT_DEBUG_CAMCTL, "[camera_control] live view decoder thread started");
+
+  while(TRUE)
+  {
+    dt_pthread_mutex_lock(&cam->live_view_pending_mutex);
+    while(!cam->live_view_pending && cam->is_live_viewing)
+      dt_pthread_cond_wait(&cam->live_view_pending_cond,
+                           &cam->live_view_pending_mutex);
+    CameraFile *fp = cam->live_view_pending;
+    cam->live_view_pending = NULL;
+    dt_pthread_mutex_unlock(&cam->live_view_pending_mutex);
+
+    if(!fp) break; // live view was stopped and nothing is left to decode
+
+    const gchar *data_ptr = NULL;
+    unsigned long int data_size = 0;
+    dt_imageio_jpeg_t jpg;
+    if(gp_file_get_data_and_size(fp, &data_ptr, &data_size) != GP_OK)
+    {
+      dt_print(DT_DEBUG_CAMCTL,
+               "[camera_control] live view failed to get preview data");
+    }
+    else if(dt_imageio_jpeg_decompress_header(data_ptr, data_size, &jpg))
+    {
+      dt_print(DT_DEBUG_CAMCTL,
+               "[camera_control] live view failed to decompress jpeg header");
+    }
+    else
+    {
+      // FIXME: is the live view ever tagged with a profile?
+      // testing so far (limited to Canon EOS 5D Mark III) hasn't
+      // found one
+      // dt_colorspaces_color_profile_type_t color_space = dt_imageio_jpeg_read_color_space(&jpg);
+      //if(color_space == DT_COLORSPACE_DISPLAY)
+      //  color_space = DT_COLORSPACE_SRGB;
+      // no embedded colorspace, assume is sRGB
+
+      // decode into the next frame of the recycled pool. the published
+      // frame is left alone, so this doesn't have to wait for a reader
+      // holding the buffer mutex, and the buffers are only reallocated
+      // when the preview dimensions change.
+      const int idx = (cam->live_view_front + 1) % 3;
+      const size_t needed = sizeof(uint8_t) * 4 * jpg.width * jpg.height;
+      if(cam->live_view_frame_size[idx] != needed)
+      {
+        dt_free_align(cam->live_view_frames[idx]);
+        cam->live_view_frames[idx] = dt_alloc_align_uint8(needed);
+        cam->live_view_frame_size[idx] = cam->live_view_frames[idx] ? needed : 0;
+      }
+      if(!cam->live_view_frames[idx])
+      {
+        dt_print(DT_DEBUG_CAMCTL,
+                 "[camera_control] live view could not allocate image buffer");
+      }
+      else if(dt_imageio_jpeg_decompress(&jpg, cam->live_view_frames[idx]))
+      {
+        dt_print(DT_DEBUG_CAMCTL,
+                 "[camera_control] live view failed to decompress jpeg");
+      }
+      else
+      {
+        dt_pthread_mutex_lock(&cam->live_view_buffer_mutex);
+        cam->live_view_buffer = cam->live_view_frames[idx];
+        cam->live_view_front = idx;
+        cam->live_view_width = jpg.width;
+        cam->live_view_height = jpg.height;
+        //cam->live_view_color_space = color_space;
+        dt_pthread_mutex_unlock(&cam->live_view_buffer_mutex);
+        dt_control_queue_redraw_center();
+      }
+    }
+    gp_file_free(fp);
+  }
+  dt_print(DT_DEBUG_CAMCTL, "[camera_control] live view decoder thread stopped");
+  return NULL;
+}
+
 static void *dt_camctl_camera_get_live_view(void *data)
 {
   dt_camctl_t *camctl = (dt_camctl_t *)data;
@@ -587,7 +645,11 @@ static void *dt_camctl_camera_get_live_view(void *data)
     if(current_time - capture_time >= 1.0)
     {
       // a second has passed
-      dt_print(DT_DEBUG_CAMCTL, "%d fps", frames + 1);
+      dt_pthread_mutex_lock(&cam->live_view_pending_mutex);
+      const guint dropped = cam->live_view_dropped;
+      cam->live_view_dropped = 0;
+      dt_pthread_mutex_unlock(&cam->live_view_pending_mutex);
+      dt_print(DT_DEBUG_CAMCTL, "%d fps, %u dropped", frames + 1, dropped);
       frames = 0;
       capture_time = current_time;
     }
@@ -629,9 +691,12 @@ gboolean dt_camctl_camera_start_live_view(const dt_camctl_t *c)
     return FALSE;
   }
   cam->is_live_viewing = TRUE;
+  cam->live_view_dropped = 0;
   dt_camctl_camera_set_property_int(camctl, NULL, "eosviewfinder", 1);
   dt_camctl_camera_set_property_int(camctl, NULL, "viewfinder", 1);
 
+  dt_pthread_create(&cam->live_view_decode_thread,
+                    &dt_camctl_camera_decode_live_view, (void *)camctl);
   dt_pthread_create(&cam->live_view_thread,
                     &dt_camctl_camera_get_live_view, (void *)camctl);
 
@@ -652,6 +717,11 @@ void dt_camctl_camera_stop_live_view(const dt_camctl_t *c)
   dt_print(DT_DEBUG_CAMCTL, "[camera_control] Stopping live view");
   cam->is_live_viewing = FALSE;
   dt_pthread_join(cam->live_view_thread);
+  // wake the decoder so it notices live view is over
+  dt_pthread_mutex_lock(&cam->live_view_pending_mutex);
+  pthread_cond_signal(&cam->live_view_pending_cond);
+  dt_pthread_mutex_unlock(&cam->live_view_pending_mutex);
+  dt_pthread_join(cam->live_view_decode_thread);
   // tell camera to get back to normal state (close mirror)
   dt_camctl_camera_set_property_int(camctl, NULL, "eosviewfinder", 0);
   dt_camctl_camera_set_property_int(camctl, NULL, "viewfinder", 0);
@@ -714,16 +784,25 @@ dt_camctl_t *dt_camctl_new()
 static void dt_camctl_camera_destroy_struct(dt_camera_t *cam)
 {
   if(!cam) return;
-  if(cam->live_view_buffer)
+  cam->live_view_buffer = NULL; // just in case someone else is using this
+  for(int k = 0; k < 3; k++)
+  {
+    dt_free_align(cam->live_view_frames[k]);
+    cam->live_view_frames[k] = NULL;
+    cam->live_view_frame_size[k] = 0;
+  }
+  if(cam->live_view_pending)
   {
-    dt_free_align(cam->live_view_buffer);
-    cam->live_view_buffer = NULL; // just in case someone else is using this
+    gp_file_free(cam->live_view_pending);
+    cam->live_view_pending = NULL;
   }
   g_free(cam->model);
   g_free(cam->port);
   dt_pthread_mutex_destroy(&cam->jobqueue_lock);
   dt_pthread_mutex_destroy(&cam->config_lock);
   dt_pthread_mutex_destroy(&cam->live_view_buffer_mutex);
+  dt_pthread_mutex_destroy(&cam->live_view_pending_mutex);
+  pthread_cond_destroy(&cam->live_view_pending_cond);
   dt_pthread_mutex_destroy(&cam->live_view_synch);
   // TODO: cam->jobqueue
   g_free(cam);
@@ -1210,6 +1289,8 @@ static gboolean _camera_initialize(const dt_camctl_t *c,
     dt_pthread_mutex_init(&cam->jobqueue_lock, NULL);
     dt_pthread_mutex_init(&cam->config_lock, NULL);
     dt_pthread_mutex_init(&cam->live_view_buffer_mutex, NULL);
+    dt_pthread_mutex_init(&cam->live_view_pending_mutex, NULL);
+    pthread_cond_init(&cam->live_view_pending_cond, NULL);
     dt_pthread_mutex_init(&cam->live_view_synch, NULL);
 
     dt_print(DT_DEBUG_CAMCTL,
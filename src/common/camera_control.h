@@ -99,6 +99,17 @@ typedef struct dt_camera_t
   uint8_t *live_view_buffer;
   int live_view_width, live_view_height;
   //dt_colorspaces_color_profile_type_t live_view_color_space;
+  /** Recycled frame pool backing live_view_buffer. The entry currently
+      published through live_view_buffer must not be written to */
+  uint8_t *live_view_frames[3];
+  size_t live_view_frame_size[3];
+  int live_view_front;
+  /** Hand-over slot between the camera thread and the decoder thread,
+      holding the most recent undecoded preview. If the decoder is still
+      busy when the next preview arrives the pending one is dropped */
+  CameraFile *live_view_pending;
+  /** Number of previews dropped because the decoder couldn't keep up */
+  guint live_view_dropped;
   /** Rotation of live view, multiples of 90° */
   int32_t live_view_rotation;
   /** Zoom level for live view */
@@ -111,8 +122,14 @@ typedef struct dt_camera_t
   gboolean live_view_flip;
   /** The thread adding the live view jobs */
   pthread_t live_view_thread;
+  /** The thread decompressing the previews captured by the camera thread */
+  pthread_t live_view_decode_thread;
   /** A guard so that writing and reading the live view buffer don't interfere */
   dt_pthread_mutex_t live_view_buffer_mutex;
+  /** Guards live_view_pending and live_view_dropped */
+  dt_pthread_mutex_t live_view_pending_mutex;
+  /** Signalled when a new preview is put into the hand-over slot */
+  pthread_cond_t live_view_pending_cond;
   /** A flag to tell the live view thread that the last job was completed */
   dt_pthread_mutex_t live_view_synch;
 } dt_camera_t;
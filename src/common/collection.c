@@ -18,6 +18,7 @@
 
 #include "common/collection.h"
 #include "common/debug.h"
+#include "common/fts.h"
 #include "common/image.h"
 #include "common/image_cache.h"
 #include "common/metadata.h"
@@ -147,6 +148,82 @@ static char * and_operator(int *term)
   assert(0); // Not reached.
 }
 
+// the imgid sequence of the previous memory table content and the
+// diff of the latest update against it
+static struct
+{
+  GArray *prev;
+  dt_collection_diff_t diff;
+} _memory_diff = { 0 };
+
+const dt_collection_diff_t *dt_collection_get_diff(void)
+{
+  return &_memory_diff.diff;
+}
+
+static void _collection_update_diff(GArray *new_ids)
+{
+  dt_collection_diff_t *d = &_memory_diff.diff;
+  g_list_free(d->added);
+  g_list_free(d->removed);
+  d->added = d->removed = NULL;
+  d->moved = FALSE;
+  d->valid = _memory_diff.prev != NULL;
+
+  if(d->valid)
+  {
+    GArray *prev = _memory_diff.prev;
+    GHashTable *old_set = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTable *new_set = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for(guint i = 0; i < prev->len; i++)
+      g_hash_table_add(old_set, GINT_TO_POINTER(g_array_index(prev, dt_imgid_t, i)));
+    for(guint i = 0; i < new_ids->len; i++)
+      g_hash_table_add(new_set, GINT_TO_POINTER(g_array_index(new_ids, dt_imgid_t, i)));
+
+    for(guint i = 0; i < new_ids->len; i++)
+    {
+      const dt_imgid_t id = g_array_index(new_ids, dt_imgid_t, i);
+      if(!g_hash_table_contains(old_set, GINT_TO_POINTER(id)))
+        d->added = g_list_prepend(d->added, GINT_TO_POINTER(id));
+    }
+    for(guint i = 0; i < prev->len; i++)
+    {
+      const dt_imgid_t id = g_array_index(prev, dt_imgid_t, i);
+      if(!g_hash_table_contains(new_set, GINT_TO_POINTER(id)))
+        d->removed = g_list_prepend(d->removed, GINT_TO_POINTER(id));
+    }
+
+    // walk both sequences over the images present in both results and
+    // see whether their relative order changed
+    guint i = 0, j = 0;
+    while(i < prev->len && j < new_ids->len)
+    {
+      const dt_imgid_t old_id = g_array_index(prev, dt_imgid_t, i);
+      const dt_imgid_t new_id = g_array_index(new_ids, dt_imgid_t, j);
+      if(!g_hash_table_contains(new_set, GINT_TO_POINTER(old_id)))
+        i++;
+      else if(!g_hash_table_contains(old_set, GINT_TO_POINTER(new_id)))
+        j++;
+      else if(old_id != new_id)
+      {
+        d->moved = TRUE;
+        break;
+      }
+      else
+      {
+        i++;
+        j++;
+      }
+    }
+
+    g_hash_table_destroy(old_set);
+    g_hash_table_destroy(new_set);
+  }
+
+  if(_memory_diff.prev) g_array_unref(_memory_diff.prev);
+  _memory_diff.prev = new_ids;
+}
+
 void dt_collection_memory_update()
 {
   if(!darktable.collection || !darktable.db) return;
@@ -182,6 +259,20 @@ void dt_collection_memory_update()
   sqlite3_step(stmt);
   sqlite3_finalize(stmt);
 
+  // 3. diff the new result against the previous one so listeners can
+  // apply incremental updates instead of rebuilding their model
+  GArray *new_ids = g_array_new(FALSE, FALSE, sizeof(dt_imgid_t));
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                              "SELECT imgid FROM memory.collected_images ORDER BY rowid",
+                              -1, &stmt, NULL);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    const dt_imgid_t id = sqlite3_column_int(stmt, 0);
+    g_array_append_val(new_ids, id);
+  }
+  sqlite3_finalize(stmt);
+  _collection_update_diff(new_ids);
+
   g_free(query);
   g_free(ins_query);
 }
@@ -244,6 +335,33 @@ static void _dt_collection_set_selq_pre_sort(const dt_collection_t *collection,
   g_free(fields);
 }
 
+static void _collection_log_query_plan(const char *query)
+{
+  if(!(darktable.unmuted & DT_DEBUG_SQL)) return;
+
+  gchar *explain = g_strconcat("EXPLAIN QUERY PLAN ", query, NULL);
+  sqlite3_stmt *stmt = NULL;
+  // plain prepare here, the debug macro would log the explain
+  // statement on top of the plan rows
+  if(sqlite3_prepare_v2(dt_database_get(darktable.db), explain,
+                        -1, &stmt, NULL) == SQLITE_OK)
+  {
+    while(sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      const char *detail = (const char *)sqlite3_column_text(stmt, 3);
+      if(!detail) continue;
+      // a bare "SCAN <table>" without an index means sqlite walks the
+      // whole table on every refresh of the collection
+      const gboolean full_scan = g_str_has_prefix(detail, "SCAN")
+                                 && !strstr(detail, "USING");
+      dt_print(DT_DEBUG_SQL, "[collection] query plan: %s%s",
+               detail, full_scan ? "  <-- full table scan" : "");
+    }
+    sqlite3_finalize(stmt);
+  }
+  g_free(explain);
+}
+
 int dt_collection_update(const dt_collection_t *collection)
 {
   uint32_t result;
@@ -371,6 +489,7 @@ int dt_collection_update(const dt_collection_t *collection)
                   (collection->params.query_flags & COLLECTION_QUERY_USE_LIMIT)
                   ? " " LIMIT_QUERY : "");
   result = _dt_collection_store(collection, query, query_no_group);
+  _collection_log_query_plan(query);
 
   /* free memory used */
   g_free(sq);
@@ -2165,8 +2284,37 @@ static gchar *get_query_string(const dt_collection_properties_t property, const
 
       case DT_COLLECTION_PROP_TEXTSEARCH: // text search
       {
+        // the big tables (metadata values, tags, filenames) are served
+        // by the fts5 shadow index when it is up and the pattern is the
+        // plain default search.  maker/model/folder stay as LIKE scans
+        // over their small dimension tables.
+        gchar *match = dt_fts_ready() ? dt_fts_match_from_like(escaped_text) : NULL;
         // clang-format off
-        if(g_strcmp0(escaped_text, "%%") != 0)
+        if(match)
+        {
+          query = g_strdup_printf
+            ("(mi.id IN (SELECT id FROM main.meta_data WHERE rowid IN"
+             "            (SELECT rowid FROM memory.metadata_fts"
+             "              WHERE memory.metadata_fts MATCH '%s')"
+             " UNION SELECT imgid AS id"
+             "         FROM main.tagged_images"
+             "         WHERE tagid IN (SELECT rowid FROM memory.tags_fts"
+             "                          WHERE memory.tags_fts MATCH '%s')"
+             " UNION SELECT rowid AS id"
+             "         FROM memory.filename_fts"
+             "         WHERE memory.filename_fts MATCH '%s'"
+             " UNION SELECT miu.id"
+             "         FROM main.images AS miu"
+             "         WHERE miu.maker_id IN (SELECT id FROM main.makers WHERE name LIKE '%s')"
+             "            OR miu.model_id IN (SELECT id FROM main.models WHERE name LIKE '%s')"
+             " UNION SELECT i.id"
+             "         FROM main.images AS i, main.film_rolls AS fr"
+             "         WHERE fr.id=i.film_id AND fr.folder LIKE '%s'))",
+             match, match, match,
+             escaped_text, escaped_text, escaped_text);
+          g_free(match);
+        }
+        else if(g_strcmp0(escaped_text, "%%") != 0)
           query = g_strdup_printf
             ("(mi.id IN (SELECT id FROM main.meta_data WHERE value LIKE '%s'"
              " UNION SELECT imgid AS id"
@@ -278,6 +278,22 @@ void dt_collection_move_before(const dt_imgid_t image_id, GList * selected_image
 /* initialize memory table */
 void dt_collection_memory_update();
 
+/** difference between the two most recent results of
+ * dt_collection_memory_update(), so listeners can apply incremental
+ * updates instead of rebuilding their whole model on every reload. */
+typedef struct dt_collection_diff_t
+{
+  GList *added;    // imgids present now but not in the previous result
+  GList *removed;  // imgids gone from the collection
+  gboolean moved;  // TRUE when images kept changed their relative order
+  gboolean valid;  // FALSE when there is no previous result to compare with
+} dt_collection_diff_t;
+
+/** get the diff of the last memory table update. the returned struct
+ * and its lists belong to the collection and stay valid until the
+ * next dt_collection_memory_update(). */
+const dt_collection_diff_t *dt_collection_get_diff(void);
+
 /** save the current collection for recentcollect module and collect history */
 void dt_collection_history_save();
 
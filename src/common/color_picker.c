@@ -304,6 +304,144 @@ static void _color_picker_work_1ch(const float *const pixel,
     pick[DT_PICK_MEAN][c] = weights[c] ? (acc[c] / (float)weights[c]) : 0.0f;
 }
 
+// edge length of the square regions summarized by dt_color_picker_cells_build
+#define DT_PICKER_CELL_SIZE 32
+
+static void _cells_scan(const float *const pixel,
+                        const int width,
+                        const int *const box,
+                        dt_aligned_pixel_t acc,
+                        dt_aligned_pixel_t low,
+                        dt_aligned_pixel_t high)
+{
+  for(size_t j = box[1]; j < (size_t)box[3]; j++)
+  {
+    const float *const row = pixel + 4 * (j * width + box[0]);
+    const size_t stride = 4 * (size_t)(box[2] - box[0]);
+    for(size_t i = 0; i < stride; i += 4)
+      for_each_channel(k, aligned(acc,low,high:16))
+        _update_stats_by_ch(acc, low, high, k, row[i + k]);
+  }
+}
+
+dt_color_picker_cells_t *dt_color_picker_cells_build(const float *const pixel,
+                                                     const dt_iop_roi_t *roi)
+{
+  const int width = roi->width;
+  const int height = roi->height;
+  const int cells_x = (width + DT_PICKER_CELL_SIZE - 1) / DT_PICKER_CELL_SIZE;
+  const int cells_y = (height + DT_PICKER_CELL_SIZE - 1) / DT_PICKER_CELL_SIZE;
+
+  dt_color_picker_cells_t *cells = calloc(1, sizeof(dt_color_picker_cells_t));
+  if(!cells) return NULL;
+
+  const size_t ncells = 4 * (size_t)cells_x * cells_y;
+  cells->sum = dt_alloc_align_float(ncells);
+  cells->low = dt_alloc_align_float(ncells);
+  cells->high = dt_alloc_align_float(ncells);
+  if(!cells->sum || !cells->low || !cells->high)
+  {
+    dt_color_picker_cells_free(cells);
+    return NULL;
+  }
+
+  cells->width = width;
+  cells->height = height;
+  cells->cells_x = cells_x;
+  cells->cells_y = cells_y;
+
+  DT_OMP_FOR(collapse(2))
+  for(int cy = 0; cy < cells_y; cy++)
+  {
+    for(int cx = 0; cx < cells_x; cx++)
+    {
+      dt_aligned_pixel_t acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+      dt_aligned_pixel_t low = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+      dt_aligned_pixel_t high = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+      const int cbox[4] = { cx * DT_PICKER_CELL_SIZE,
+                            cy * DT_PICKER_CELL_SIZE,
+                            MIN(width, (cx + 1) * DT_PICKER_CELL_SIZE),
+                            MIN(height, (cy + 1) * DT_PICKER_CELL_SIZE) };
+      _cells_scan(pixel, width, cbox, acc, low, high);
+
+      const size_t idx = 4 * ((size_t)cy * cells_x + cx);
+      for_four_channels(k)
+      {
+        cells->sum[idx + k] = acc[k];
+        cells->low[idx + k] = low[k];
+        cells->high[idx + k] = high[k];
+      }
+    }
+  }
+  return cells;
+}
+
+void dt_color_picker_cells_free(dt_color_picker_cells_t *cells)
+{
+  if(!cells) return;
+  dt_free_align(cells->sum);
+  dt_free_align(cells->low);
+  dt_free_align(cells->high);
+  free(cells);
+}
+
+void dt_color_picker_cells_helper(const dt_color_picker_cells_t *cells,
+                                  const float *const pixel,
+                                  const dt_iop_roi_t *roi,
+                                  const int *const box,
+                                  lib_colorpicker_stats pick)
+{
+  // cells entirely inside the box; the edge strips are scanned directly
+  const int cx0 = (box[0] + DT_PICKER_CELL_SIZE - 1) / DT_PICKER_CELL_SIZE;
+  const int cy0 = (box[1] + DT_PICKER_CELL_SIZE - 1) / DT_PICKER_CELL_SIZE;
+  const int cx1 = box[2] / DT_PICKER_CELL_SIZE;
+  const int cy1 = box[3] / DT_PICKER_CELL_SIZE;
+
+  if(cx1 <= cx0 || cy1 <= cy0)
+  {
+    // small box, no whole cell inside, just scan it as before
+    _color_picker_work_4ch(pixel, roi, box, pick, NULL, _color_picker_rgb_or_lab, 100);
+    return;
+  }
+
+  dt_aligned_pixel_t acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+  dt_aligned_pixel_t low = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+  dt_aligned_pixel_t high = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+  for(int cy = cy0; cy < cy1; cy++)
+  {
+    for(int cx = cx0; cx < cx1; cx++)
+    {
+      const size_t idx = 4 * ((size_t)cy * cells->cells_x + cx);
+      for_four_channels(k, aligned(acc,low,high:16))
+      {
+        acc[k] += cells->sum[idx + k];
+        low[k] = MIN(low[k], cells->low[idx + k]);
+        high[k] = MAX(high[k], cells->high[idx + k]);
+      }
+    }
+  }
+
+  const int top[4]    = { box[0], box[1], box[2], cy0 * DT_PICKER_CELL_SIZE };
+  const int bottom[4] = { box[0], cy1 * DT_PICKER_CELL_SIZE, box[2], box[3] };
+  const int left[4]   = { box[0], cy0 * DT_PICKER_CELL_SIZE,
+                          cx0 * DT_PICKER_CELL_SIZE, cy1 * DT_PICKER_CELL_SIZE };
+  const int right[4]  = { cx1 * DT_PICKER_CELL_SIZE, cy0 * DT_PICKER_CELL_SIZE,
+                          box[2], cy1 * DT_PICKER_CELL_SIZE };
+  _cells_scan(pixel, roi->width, top, acc, low, high);
+  _cells_scan(pixel, roi->width, bottom, acc, low, high);
+  _cells_scan(pixel, roi->width, left, acc, low, high);
+  _cells_scan(pixel, roi->width, right, acc, low, high);
+
+  const size_t size = _box_size(box);
+  for_four_channels(c)
+  {
+    pick[DT_PICK_MEAN][c] = acc[c] / (float)size;
+    pick[DT_PICK_MIN][c] = low[c];
+    pick[DT_PICK_MAX][c] = high[c];
+  }
+}
+
 void dt_color_picker_backtransform_box(dt_develop_t *dev,
                                        const int num,
                                        const float *in,
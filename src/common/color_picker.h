@@ -45,6 +45,25 @@ gboolean dt_color_picker_box(dt_iop_module_t *module,
                              const dt_colorpicker_sample_t *const sample,
                              dt_pixelpipe_picker_source_t picker_source,
                              int *box);
+// per-cell channel aggregates of a 4-channel buffer, so that many
+// boxes can be sampled without rescanning their pixels each time
+typedef struct dt_color_picker_cells_t
+{
+  int width, height;   // dimensions of the summarized buffer
+  int cells_x, cells_y;
+  float *sum;          // per cell: 4 channel sums
+  float *low;          // per cell: 4 channel minima
+  float *high;         // per cell: 4 channel maxima
+} dt_color_picker_cells_t;
+
+dt_color_picker_cells_t *dt_color_picker_cells_build(const float *const pixel,
+                                                     const struct dt_iop_roi_t *roi);
+void dt_color_picker_cells_free(dt_color_picker_cells_t *cells);
+void dt_color_picker_cells_helper(const dt_color_picker_cells_t *cells,
+                                  const float *const pixel,
+                                  const struct dt_iop_roi_t *roi,
+                                  const int *const box,
+                                  lib_colorpicker_stats pick);
 void dt_color_picker_helper(const struct dt_iop_buffer_dsc_t *dsc,
                             const float *const pixel,
                             const struct dt_iop_roi_t *roi,
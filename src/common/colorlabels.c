@@ -224,7 +224,7 @@ static void _colorlabels_execute(const GList *imgs,
       undocolorlabels->imgid = imgid;
       undocolorlabels->before = before;
       undocolorlabels->after = after;
-      *undo = g_list_append(*undo, undocolorlabels);
+      *undo = g_list_prepend(*undo, undocolorlabels);
     }
 
     _pop_undo_execute(imgid, before, after);
@@ -243,7 +243,11 @@ void dt_colorlabels_set_labels(const GList *img,
     if(undo_on)
       dt_undo_start_group(darktable.undo, DT_UNDO_COLORLABELS);
 
+    // one transaction for the whole list so we commit once instead of
+    // once per label change
+    dt_database_start_transaction(darktable.db);
     _colorlabels_execute(img, labels, &undo, undo_on, clear_on ? DT_CA_SET : DT_CA_ADD);
+    dt_database_release_transaction(darktable.db);
 
     if(undo_on)
     {
@@ -265,6 +269,7 @@ void dt_colorlabels_toggle_label_on_list(const GList *list,
   GList *undo = NULL;
   if(undo_on) dt_undo_start_group(darktable.undo, DT_UNDO_COLORLABELS);
 
+  dt_database_start_transaction(darktable.db);
   if(color == 5)
   {
     _colorlabels_execute(list, 0, &undo, undo_on, DT_CA_SET);
@@ -273,6 +278,7 @@ void dt_colorlabels_toggle_label_on_list(const GList *list,
   {
     _colorlabels_execute(list, label, &undo, undo_on, DT_CA_TOGGLE);
   }
+  dt_database_release_transaction(darktable.db);
 
   // synchronise xmp files
   dt_image_synch_xmps(list);
@@ -1064,6 +1064,236 @@ cmsHPROFILE dt_colorspaces_make_temporary_profile(cmsHPROFILE profile)
   return profile;
 }
 
+// small shared cache of lcms2 transforms. building a transform for a
+// LUT based profile walks and inverts its curves and tables, which can
+// take longer than applying the transform to a whole image -- and with
+// several pipes asking for the same conversion (export workers,
+// thumbnail, darkroom + preview) that work was redone per pipe. the
+// cache is keyed by the profile handles themselves, which is why only
+// transforms between session-stable profiles (the ones owned by
+// darktable.color_profiles) may go through it; per-image profiles have
+// their transforms created the classic way. entries are refcounted
+// since several pipes may run the same transform concurrently, and
+// eviction is LRU among the currently unused ones.
+
+typedef struct _transform_cache_entry_t
+{
+  cmsHPROFILE input, output;
+  cmsUInt32Number input_format, output_format;
+  cmsUInt32Number intent;
+  cmsHTRANSFORM transform;
+  int refcount;
+  guint64 age;
+  gboolean stale; // underlying profile got replaced, delete on last release
+} _transform_cache_entry_t;
+
+#define MAX_CACHED_TRANSFORMS 32
+
+static GMutex _transform_cache_mutex;
+static GList *_transform_cache = NULL;
+static guint64 _transform_cache_time = 0;
+
+cmsHTRANSFORM dt_colorspaces_get_transform(cmsHPROFILE input,
+                                           const cmsUInt32Number input_format,
+                                           cmsHPROFILE output,
+                                           const cmsUInt32Number output_format,
+                                           const cmsUInt32Number intent)
+{
+  g_mutex_lock(&_transform_cache_mutex);
+
+  for(GList *l = _transform_cache; l; l = g_list_next(l))
+  {
+    _transform_cache_entry_t *e = l->data;
+    if(!e->stale
+       && e->input == input
+       && e->output == output
+       && e->input_format == input_format
+       && e->output_format == output_format
+       && e->intent == intent)
+    {
+      e->refcount++;
+      e->age = ++_transform_cache_time;
+      g_mutex_unlock(&_transform_cache_mutex);
+      return e->transform;
+    }
+  }
+
+  // build the transform while holding the lock so concurrent pipes
+  // asking for the same conversion wait for this one instead of all
+  // redoing the expensive construction
+  cmsHTRANSFORM transform =
+    cmsCreateTransform(input, input_format, output, output_format, intent, 0);
+  if(transform)
+  {
+    _transform_cache_entry_t *e = calloc(1, sizeof(_transform_cache_entry_t));
+    e->input = input;
+    e->output = output;
+    e->input_format = input_format;
+    e->output_format = output_format;
+    e->intent = intent;
+    e->transform = transform;
+    e->refcount = 1;
+    e->age = ++_transform_cache_time;
+    _transform_cache = g_list_prepend(_transform_cache, e);
+
+    // evict the least recently used idle entries
+    while(g_list_length(_transform_cache) > MAX_CACHED_TRANSFORMS)
+    {
+      GList *victim = NULL;
+      for(GList *l = _transform_cache; l; l = g_list_next(l))
+      {
+        _transform_cache_entry_t *c = l->data;
+        if(c->refcount == 0
+           && (!victim
+               || c->age < ((_transform_cache_entry_t *)victim->data)->age))
+          victim = l;
+      }
+      if(!victim) break;
+      _transform_cache_entry_t *c = victim->data;
+      cmsDeleteTransform(c->transform);
+      free(c);
+      _transform_cache = g_list_delete_link(_transform_cache, victim);
+    }
+  }
+
+  g_mutex_unlock(&_transform_cache_mutex);
+  return transform;
+}
+
+void dt_colorspaces_release_transform(cmsHTRANSFORM transform)
+{
+  if(!transform) return;
+  g_mutex_lock(&_transform_cache_mutex);
+  for(GList *l = _transform_cache; l; l = g_list_next(l))
+  {
+    _transform_cache_entry_t *e = l->data;
+    if(e->transform == transform)
+    {
+      e->refcount--;
+      if(e->stale && e->refcount == 0)
+      {
+        cmsDeleteTransform(e->transform);
+        free(e);
+        _transform_cache = g_list_delete_link(_transform_cache, l);
+      }
+      break;
+    }
+  }
+  g_mutex_unlock(&_transform_cache_mutex);
+}
+
+void dt_colorspaces_flush_transform_cache(void)
+{
+  g_mutex_lock(&_transform_cache_mutex);
+  GList *l = _transform_cache;
+  while(l)
+  {
+    GList *next = g_list_next(l);
+    _transform_cache_entry_t *e = l->data;
+    if(e->refcount == 0)
+    {
+      cmsDeleteTransform(e->transform);
+      free(e);
+      _transform_cache = g_list_delete_link(_transform_cache, l);
+    }
+    else
+      // still used by a running pipe; drop the key so it can't be
+      // handed out again, the last release deletes it
+      e->stale = TRUE;
+    l = next;
+  }
+  g_mutex_unlock(&_transform_cache_mutex);
+}
+
+// parsed-profile cache for profiles that don't live in the session
+// profile list. embedded per-image ICC blobs in particular get
+// re-parsed by every pipe committing colorin's params (darkroom,
+// preview, thumbnails, every export worker). entries are keyed by a
+// hash of the blob content and refcounted; released entries stay
+// cached so the next pipe for the same image - or another image
+// shipping the same profile - skips the parse.
+
+typedef struct _profile_cache_entry_t
+{
+  dt_hash_t hash;
+  cmsHPROFILE profile;
+  int refcount;
+  guint64 age;
+} _profile_cache_entry_t;
+
+#define MAX_CACHED_PROFILES 16
+
+static GMutex _profile_cache_mutex;
+static GList *_profile_cache = NULL;
+static guint64 _profile_cache_time = 0;
+
+cmsHPROFILE dt_colorspaces_get_cached_rgb_profile_from_mem(const uint8_t *data,
+                                                           const uint32_t size)
+{
+  const dt_hash_t hash = dt_hash(DT_INITHASH, data, size);
+
+  g_mutex_lock(&_profile_cache_mutex);
+  for(GList *l = _profile_cache; l; l = g_list_next(l))
+  {
+    _profile_cache_entry_t *e = l->data;
+    if(e->hash == hash)
+    {
+      e->refcount++;
+      e->age = ++_profile_cache_time;
+      g_mutex_unlock(&_profile_cache_mutex);
+      return e->profile;
+    }
+  }
+
+  cmsHPROFILE profile = _ensure_rgb_profile(cmsOpenProfileFromMem(data, size));
+  if(profile)
+  {
+    _profile_cache_entry_t *e = calloc(1, sizeof(_profile_cache_entry_t));
+    e->hash = hash;
+    e->profile = profile;
+    e->refcount = 1;
+    e->age = ++_profile_cache_time;
+    _profile_cache = g_list_prepend(_profile_cache, e);
+
+    // evict the least recently used idle entries
+    while(g_list_length(_profile_cache) > MAX_CACHED_PROFILES)
+    {
+      GList *victim = NULL;
+      for(GList *l = _profile_cache; l; l = g_list_next(l))
+      {
+        _profile_cache_entry_t *c = l->data;
+        if(c->refcount == 0
+           && (!victim
+               || c->age < ((_profile_cache_entry_t *)victim->data)->age))
+          victim = l;
+      }
+      if(!victim) break;
+      _profile_cache_entry_t *c = victim->data;
+      cmsCloseProfile(c->profile);
+      free(c);
+      _profile_cache = g_list_delete_link(_profile_cache, victim);
+    }
+  }
+  g_mutex_unlock(&_profile_cache_mutex);
+  return profile;
+}
+
+void dt_colorspaces_release_cached_rgb_profile(cmsHPROFILE profile)
+{
+  if(!profile) return;
+  g_mutex_lock(&_profile_cache_mutex);
+  for(GList *l = _profile_cache; l; l = g_list_next(l))
+  {
+    _profile_cache_entry_t *e = l->data;
+    if(e->profile == profile)
+    {
+      e->refcount--;
+      break;
+    }
+  }
+  g_mutex_unlock(&_profile_cache_mutex);
+}
+
 void dt_colorspaces_get_profile_name(cmsHPROFILE p,
                                      const char *language,
                                      const char *country,
@@ -1262,6 +1492,9 @@ static void _update_display_profile(guchar *tmp_data,
         // update cached transforms for color management of thumbnails
         dt_colorspaces_update_display_transforms();
 
+        // the old profile handle is gone, drop transforms keyed on it
+        dt_colorspaces_flush_transform_cache();
+
         break;
       }
     }
@@ -1292,6 +1525,9 @@ static void _update_display2_profile(guchar *tmp_data,
         // update cached transforms for color management of thumbnails
         dt_colorspaces_update_display2_transforms();
 
+        // the old profile handle is gone, drop transforms keyed on it
+        dt_colorspaces_flush_transform_cache();
+
         break;
       }
     }
@@ -1709,6 +1945,8 @@ void dt_colorspaces_cleanup(dt_colorspaces_t *self)
     cmsDeleteTransform(self->transform_adobe_rgb_to_display2);
   self->transform_adobe_rgb_to_display2 = NULL;
 
+  dt_colorspaces_flush_transform_cache();
+
   for(GList *iter = self->profiles; iter; iter = g_list_next(iter))
   {
     dt_colorspaces_color_profile_t *p = iter->data;
@@ -249,6 +249,16 @@ const dt_colorspaces_color_profile_t *dt_colorspaces_get_output_profile
 cmsHPROFILE dt_colorspaces_get_rgb_profile_from_mem(uint8_t *data,
                                                     const uint32_t size);
 
+/** like dt_colorspaces_get_rgb_profile_from_mem, but the parsed profile is
+ * shared across callers via a cache keyed by the blob content. give the
+ * handle back with dt_colorspaces_release_cached_rgb_profile() instead of
+ * closing it. */
+cmsHPROFILE dt_colorspaces_get_cached_rgb_profile_from_mem(const uint8_t *data,
+                                                           const uint32_t size);
+
+/** give back a profile obtained from dt_colorspaces_get_cached_rgb_profile_from_mem. */
+void dt_colorspaces_release_cached_rgb_profile(cmsHPROFILE profile);
+
 /** free the resources of a profile created with the functions above. */
 void dt_colorspaces_cleanup_profile(cmsHPROFILE p);
 
@@ -273,6 +283,22 @@ int dt_colorspaces_get_matrix_from_output_profile(cmsHPROFILE prof,
 /** create a temporary profile to be removed by dt_colorspaces_cleanup_profile */
 cmsHPROFILE dt_colorspaces_make_temporary_profile(cmsHPROFILE profile);
 
+/** get a possibly shared lcms2 transform between two profiles. the cache is
+ * keyed by the profile handles, so only pass handles owned by
+ * darktable.color_profiles here; release the result with
+ * dt_colorspaces_release_transform() instead of cmsDeleteTransform(). */
+cmsHTRANSFORM dt_colorspaces_get_transform(cmsHPROFILE input,
+                                           const cmsUInt32Number input_format,
+                                           cmsHPROFILE output,
+                                           const cmsUInt32Number output_format,
+                                           const cmsUInt32Number intent);
+
+/** give back a transform obtained from dt_colorspaces_get_transform. */
+void dt_colorspaces_release_transform(cmsHTRANSFORM transform);
+
+/** drop all cached transforms, e.g. after a display profile was replaced. */
+void dt_colorspaces_flush_transform_cache(void);
+
 /** wrapper to get the name from a color profile. this tries to handle character encodings. */
 void dt_colorspaces_get_profile_name(cmsHPROFILE p,
                                      const char *language,
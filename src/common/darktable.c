@@ -40,16 +40,20 @@
 #include "common/action.h"
 #include "common/file_location.h"
 #include "common/film.h"
+#include "common/fts.h"
 #include "common/grealpath.h"
 #include "common/image.h"
 #include "common/image_cache.h"
 #include "common/iop_order.h"
 #include "common/l10n.h"
 #include "common/mipmap_cache.h"
+#include "common/module_stats.h"
 #include "common/noiseprofiles.h"
 #include "common/opencl.h"
 #include "common/points.h"
 #include "common/resource_limits.h"
+#include "common/thumbinfo.h"
+#include "common/trace.h"
 #include "common/undo.h"
 #include "common/gimp.h"
 #include "common/pfm.h"
@@ -84,6 +88,9 @@
 #include <string.h>
 #include <sys/param.h>
 #include <sys/types.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 #include <unistd.h>
 #include <locale.h>
 #include <limits.h>
@@ -265,6 +272,8 @@ static int usage(const char *argv0)
          "\n"
          "    all     -> to debug all signals\n"
          "    common  -> to debug dev, imageio, masks, opencl, params, pipe\n"
+         "    trace   -> record pipe/job/io events and write them as\n"
+         "               chrome://tracing JSON into the cache directory on exit\n"
          "    verbose -> when combined with debug options like '-d opencl'\n"
          "               provides more detailed output. To activate verbosity,\n"
          "               use the additional option '-d verbose'\n"
@@ -1116,6 +1125,7 @@ int dt_init(int argc,
           !strcmp(darg, "pipe") ? DT_DEBUG_PIPE :
           !strcmp(darg, "expose") ? DT_DEBUG_EXPOSE :
           !strcmp(darg, "picker") ? DT_DEBUG_PICKER :
+          !strcmp(darg, "trace") ? DT_DEBUG_TRACE : // record events for chrome://tracing
           0;
         if(dadd)
           darktable.unmuted |= dadd;
@@ -1421,6 +1431,11 @@ int dt_init(int argc,
 
   dt_print_mem_usage("at startup");
 
+  // the debug flags are final here, set up the event buffer and the
+  // allocation accounting if requested
+  dt_trace_init();
+  dt_alloc_tracking_init();
+
   char sharedir[PATH_MAX] = { 0 };
   dt_loc_get_sharedir(sharedir, sizeof(sharedir));
 
@@ -1711,24 +1726,6 @@ int dt_init(int argc,
     dt_film_set_folder_status();
   }
 
-  // the update crawl needs to run after db and conf are up, but before LUA
-  // starts any scripts
-  GList *changed_xmp_files = NULL;
-  if(init_gui)
-  {
-    if(dt_conf_get_bool("run_crawler_on_start") && !dt_gimpmode())
-    {
-      darktable_splash_screen_create(NULL, TRUE); // force the splash screen for the crawl even if user-disabled
-      // scan for cases where the database and xmp files have different timestamps
-      changed_xmp_files = dt_control_crawler_run();
-      if(!dt_conf_get_bool("show_splash_screen"))
-      {
-        darktable_splash_screen_destroy();
-        dt_gui_process_events(); // ensure that the splash screen is removed right away
-      }
-    }
-  }
-
   /* for every resourcelevel we have 4 ints defined, either absolute or a fraction
      0 cpu available
      1 cpu singlebuffer
@@ -1831,8 +1828,9 @@ int dt_init(int argc,
 
   dt_wb_presets_init(NULL);
 
-  darktable_splash_screen_set_progress(_("loading noise profiles"));
-  darktable.noiseprofile_parser = dt_noiseprofile_init(noiseprofiles_from_command);
+  // only records the file location; the json is parsed when the first
+  // denoise module asks for profiles
+  dt_noiseprofile_init(noiseprofiles_from_command);
 
   // must come before mipmap_cache, because that one will need to access
   // image dimensions stored in here:
@@ -1840,6 +1838,8 @@ int dt_init(int argc,
 
   dt_mipmap_cache_init();
 
+  dt_pressure_watchdog_start();
+
   // set up the list of exiv2 metadata
   dt_exif_set_exiv2_taglist();
 
@@ -1874,6 +1874,14 @@ int dt_init(int argc,
     }
     dt_bauhaus_init();
 
+    // the columnar thumbnail info index is only useful with a gui
+    dt_thumbinfo_init();
+
+    // same for the full-text search index backing the filtering module
+    dt_fts_init();
+
+    dt_control_start_database_maintenance();
+
     darktable.backthumbs.state = DT_JOB_STATE_FINISHED;
     darktable.backthumbs.capable =
         !dt_gimpmode()
@@ -2007,16 +2015,15 @@ int dt_init(int argc,
   }
   free(config_info);
 
-  if(init_gui && !dt_gimpmode() && changed_xmp_files)
-  {
-    // construct the popup that asks the user how to handle images whose xmp
-    // files are newer than the db entry
-    dt_control_crawler_show_image_list(changed_xmp_files);
-  }
-
   // fire up a background job to perform sidecar writes
   dt_control_sidecar_synch_start();
 
+  // schedule the scan for updated sidecar files; it runs as a
+  // rate-limited background job once the main window is up and pops up
+  // the usual dialog if it finds anything
+  if(init_gui && !dt_gimpmode() && dt_conf_get_bool("run_crawler_on_start"))
+    dt_control_start_crawler();
+
 #if defined(WIN32)
   dt_capabilities_add("windows");
   dt_capabilities_add("nonapple");
@@ -2157,6 +2164,7 @@ void dt_cleanup()
 
   if(init_gui)
   {
+    dt_thumbinfo_cleanup();
     dt_lib_cleanup(darktable.lib);
     free(darktable.lib);
     darktable.lib = NULL;
@@ -2176,10 +2184,13 @@ void dt_cleanup()
     dt_control_cleanup(FALSE);
 
 
+  dt_pressure_watchdog_shutdown();
+
   dt_image_cache_cleanup();
   dt_mipmap_cache_cleanup();
 
   dt_colorspaces_cleanup(darktable.color_profiles);
+  dt_module_stats_cleanup(); // merge the counters into the conf before it is written
   dt_conf_cleanup(darktable.conf);
   free(darktable.conf);
   darktable.conf = NULL;
@@ -2272,6 +2283,8 @@ void dt_cleanup()
 
   dt_exif_cleanup();
 
+  dt_trace_cleanup();
+
   if(init_gui)
     darktable_exit_screen_destroy();
 }
@@ -2303,28 +2316,192 @@ void dt_print_nts_ext(const char *msg, ...)
   fflush(stdout);
 }
 
+#if defined(__linux__) && defined(MADV_HUGEPAGE) && !defined(_DEBUG)
+// buffers at least this large are backed by transparent huge pages
+#define DT_HUGEPAGE_THRESHOLD (16lu << 20)
+#define DT_HUGEPAGE_SIZE (2lu << 20)
+
+static gboolean _alloc_use_hugepages()
+{
+  static gint enabled = -1;
+  if(enabled == -1)
+  {
+    // allocations happen before the config is up, don't latch the
+    // default until we can read the real preference
+    if(!darktable.conf) return TRUE;
+    enabled = dt_conf_get_bool("use_hugepages");
+  }
+  return enabled;
+}
+#endif
+
+// optional accounting of the aligned allocations (-d memory): every
+// allocation is attributed to the subsystem tag its thread pushed via
+// dt_alloc_tag_push(), so OOM reports can tell who holds the memory.
+#define DT_ALLOC_MAX_TAGS 16
+#define DT_ALLOC_TAG_DEPTH 8
+
+typedef struct _alloc_tag_stack_t
+{
+  const char *tag[DT_ALLOC_TAG_DEPTH];
+  int depth;
+} _alloc_tag_stack_t;
+
+typedef struct _alloc_stats_t
+{
+  const char *tag;
+  uint64_t allocs;  // allocations since startup
+  size_t live;      // currently held bytes
+  size_t peak;      // maximum of live
+} _alloc_stats_t;
+
+typedef struct _alloc_entry_t
+{
+  size_t size;
+  int tag;
+} _alloc_entry_t;
+
+static gboolean _alloc_tracking = FALSE;
+static _alloc_stats_t _alloc_stats[DT_ALLOC_MAX_TAGS];
+static int _alloc_ntags = 0;
+static GHashTable *_alloc_entries = NULL; // allocation -> _alloc_entry_t
+static GMutex _alloc_mutex;
+static GPrivate _alloc_tags = G_PRIVATE_INIT(g_free);
+
+void dt_alloc_tracking_init(void)
+{
+  if(!(darktable.unmuted & DT_DEBUG_MEMORY)) return;
+  g_mutex_lock(&_alloc_mutex);
+  _alloc_entries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+  _alloc_stats[0].tag = "untagged";
+  _alloc_ntags = 1;
+  _alloc_tracking = TRUE;
+  g_mutex_unlock(&_alloc_mutex);
+}
+
+void dt_alloc_tag_push(const char *tag)
+{
+  if(!_alloc_tracking) return;
+  _alloc_tag_stack_t *stack = g_private_get(&_alloc_tags);
+  if(!stack)
+  {
+    stack = g_malloc0(sizeof(_alloc_tag_stack_t));
+    g_private_set(&_alloc_tags, stack);
+  }
+  if(stack->depth < DT_ALLOC_TAG_DEPTH) stack->tag[stack->depth] = tag;
+  stack->depth++;
+}
+
+void dt_alloc_tag_pop(void)
+{
+  if(!_alloc_tracking) return;
+  _alloc_tag_stack_t *stack = g_private_get(&_alloc_tags);
+  if(stack && stack->depth > 0) stack->depth--;
+}
+
+// requires _alloc_mutex to be held
+static int _alloc_tag_index(void)
+{
+  const _alloc_tag_stack_t *stack = g_private_get(&_alloc_tags);
+  const char *tag = stack && stack->depth > 0 && stack->depth <= DT_ALLOC_TAG_DEPTH
+                    ? stack->tag[stack->depth - 1]
+                    : "untagged";
+  for(int t = 0; t < _alloc_ntags; t++)
+    if(!strcmp(_alloc_stats[t].tag, tag)) return t;
+  // too many distinct tags, account to "untagged" instead of losing the allocation
+  if(_alloc_ntags == DT_ALLOC_MAX_TAGS) return 0;
+  _alloc_stats[_alloc_ntags].tag = tag;
+  return _alloc_ntags++;
+}
+
+static void _alloc_track(void *ptr, const size_t size)
+{
+  g_mutex_lock(&_alloc_mutex);
+  const int t = _alloc_tag_index();
+  _alloc_stats[t].allocs++;
+  _alloc_stats[t].live += size;
+  _alloc_stats[t].peak = MAX(_alloc_stats[t].peak, _alloc_stats[t].live);
+  _alloc_entry_t *entry = g_malloc(sizeof(_alloc_entry_t));
+  entry->size = size;
+  entry->tag = t;
+  g_hash_table_replace(_alloc_entries, ptr, entry);
+  g_mutex_unlock(&_alloc_mutex);
+}
+
+static void _alloc_untrack(void *ptr)
+{
+  g_mutex_lock(&_alloc_mutex);
+  const _alloc_entry_t *entry = g_hash_table_lookup(_alloc_entries, ptr);
+  if(entry)
+  {
+    // allocations made before tracking was enabled simply miss here
+    _alloc_stats[entry->tag].live -= entry->size;
+    g_hash_table_remove(_alloc_entries, ptr);
+  }
+  g_mutex_unlock(&_alloc_mutex);
+}
+
+void dt_alloc_stats_print(void)
+{
+  if(!_alloc_tracking) return;
+  g_mutex_lock(&_alloc_mutex);
+  for(int t = 0; t < _alloc_ntags; t++)
+    dt_print(DT_DEBUG_MEMORY,
+             "[alloc_stats] %-12s live=%6zuMB peak=%6zuMB allocs=%" PRIu64,
+             _alloc_stats[t].tag,
+             _alloc_stats[t].live / (1lu << 20),
+             _alloc_stats[t].peak / (1lu << 20),
+             _alloc_stats[t].allocs);
+  g_mutex_unlock(&_alloc_mutex);
+}
+
 void *dt_alloc_aligned(const size_t size)
 {
   const size_t alignment = DT_CACHELINE_BYTES;
   const size_t aligned_size = dt_round_size(size, alignment);
+  size_t tracked_size = aligned_size;
+  void *ptr = NULL;
 #if defined(__FreeBSD_version) && __FreeBSD_version < 700013
-  return malloc(aligned_size);
+  ptr = malloc(aligned_size);
 #elif defined(_WIN32)
-  return _aligned_malloc(aligned_size, alignment);
+  ptr = _aligned_malloc(aligned_size, alignment);
 #elif defined(_DEBUG)
   // for a debug build, ensure that we get a crash if we use plain
   // free() to release the allocated memory, by returning a pointer
   // which isn't a valid memory block address
-  void *ptr = NULL;
-  if(posix_memalign(&ptr, alignment, aligned_size + alignment)) return NULL;
-  short *offset = (short*)(((char*)ptr) + alignment - sizeof(short));
-  *offset = alignment;
-  return ((char*)ptr) + alignment ;
+  void *base = NULL;
+  if(posix_memalign(&base, alignment, aligned_size + alignment)) base = NULL;
+  if(base)
+  {
+    short *offset = (short*)(((char*)base) + alignment - sizeof(short));
+    *offset = alignment;
+    ptr = ((char*)base) + alignment;
+  }
 #else
-  void *ptr = NULL;
-  if(posix_memalign(&ptr, alignment, aligned_size)) return NULL;
-  return ptr;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // full-size image buffers are swept linearly by the pixel kernels,
+  // where 4K pages cost a TLB miss every 64 cachelines. aligning the
+  // allocation to the huge page size makes the whole range eligible
+  // for 2MB pages, madvise is only a hint and free() stays valid, so
+  // there is nothing to fall back from.
+  if(aligned_size >= DT_HUGEPAGE_THRESHOLD && _alloc_use_hugepages())
+  {
+    tracked_size = dt_round_size(aligned_size, DT_HUGEPAGE_SIZE);
+    if(posix_memalign(&ptr, DT_HUGEPAGE_SIZE, tracked_size)) ptr = NULL;
+    if(ptr) madvise(ptr, tracked_size, MADV_HUGEPAGE);
+  }
+  else
 #endif
+  if(posix_memalign(&ptr, alignment, aligned_size)) ptr = NULL;
+#endif
+  if(_alloc_tracking)
+  {
+    if(ptr)
+      _alloc_track(ptr, tracked_size);
+    else
+      dt_alloc_stats_print(); // out of memory, show who holds it
+  }
+  return ptr;
 }
 
 size_t dt_round_size(const size_t size, const size_t alignment)
@@ -2336,6 +2513,7 @@ size_t dt_round_size(const size_t size, const size_t alignment)
 #ifdef _WIN32
 void dt_free_align(void *mem)
 {
+  if(mem && _alloc_tracking) _alloc_untrack(mem);
   _aligned_free(mem);
 }
 #elif defined(_DEBUG)
@@ -2345,10 +2523,17 @@ void dt_free_align(void *mem)
   // from dt_alloc_align, so eliminate the offset
   if(mem)
   {
+    if(_alloc_tracking) _alloc_untrack(mem);
     short offset = ((short*)mem)[-1];
     free(((char*)mem)-offset);
   }
 }
+#else
+void dt_free_align(void *mem)
+{
+  if(mem && _alloc_tracking) _alloc_untrack(mem);
+  free(mem);
+}
 #endif
 
 void dt_show_times(const dt_times_t *start, const char *prefix)
@@ -2698,6 +2883,7 @@ void dt_print_mem_usage(char *info)
 #else
   dt_print(DT_DEBUG_ALWAYS, "dt_print_mem_usage() currently unsupported on this platform");
 #endif
+  dt_alloc_stats_print();
 }
 
 // clang-format off
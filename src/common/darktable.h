@@ -314,7 +314,10 @@ typedef enum dt_debug_thread_t {
   DT_DEBUG_PIPE = 1 << 25,
   DT_DEBUG_EXPOSE = 1 << 26,
   DT_DEBUG_PICKER = 1 << 27,
-  DT_DEBUG_ALL = 0xffffffff & ~DT_DEBUG_VERBOSE,
+  DT_DEBUG_TRACE = 1 << 28,
+  // tracing allocates an event buffer and writes a file on exit, so like
+  // verbose it stays strictly opt-in and is not part of 'all'
+  DT_DEBUG_ALL = 0xffffffff & ~(DT_DEBUG_VERBOSE | DT_DEBUG_TRACE),
   DT_DEBUG_COMMON = DT_DEBUG_OPENCL | DT_DEBUG_DEV | DT_DEBUG_MASKS |
                     DT_DEBUG_PARAMS | DT_DEBUG_IMAGEIO | DT_DEBUG_PIPE,
   DT_DEBUG_RESTRICT = DT_DEBUG_VERBOSE | DT_DEBUG_PERF,
@@ -529,17 +532,23 @@ static inline gboolean dt_check_aligned(void *addr) {
 
 size_t dt_round_size(const size_t size, const size_t alignment);
 
-#ifdef _WIN32
-void dt_free_align(void *mem);
-#define dt_free_align_ptr dt_free_align
-#elif _DEBUG // debug build makes sure that we get a crash on using
-             // plain free() on an aligned allocation
+// always a function: a debug build deliberately offsets the returned
+// pointer to catch plain free() on an aligned allocation, and the
+// optional allocation accounting must see the release
 void dt_free_align(void *mem);
 #define dt_free_align_ptr dt_free_align
-#else
-#define dt_free_align(A) free(A)
-#define dt_free_align_ptr free
-#endif
+
+/* optional accounting of the aligned allocations, enabled by
+   -d memory.  subsystems bracket their work with dt_alloc_tag_push()
+   and dt_alloc_tag_pop() and every aligned allocation made by the
+   thread in between is attributed to the innermost tag (pass a string
+   literal, the pointer is kept).  per-tag live totals and peaks are
+   printed by dt_print_mem_usage() and whenever an aligned allocation
+   fails, so OOM reports show who holds the memory. */
+void dt_alloc_tracking_init(void);
+void dt_alloc_tag_push(const char *tag);
+void dt_alloc_tag_pop(void);
+void dt_alloc_stats_print(void);
 
 static inline void dt_lock_image(const dt_imgid_t imgid)
     ACQUIRE(darktable.db_image[imgid & (DT_IMAGE_DBLOCKS - 1)]) {
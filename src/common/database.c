@@ -51,8 +51,8 @@
 #define LAST_FULL_DATABASE_VERSION_DATA    10
 
 // You HAVE TO bump THESE versions whenever you add an update branches to _upgrade_*_schema_step()!
-#define CURRENT_DATABASE_VERSION_LIBRARY 57
-#define CURRENT_DATABASE_VERSION_DATA    13
+#define CURRENT_DATABASE_VERSION_LIBRARY 60
+#define CURRENT_DATABASE_VERSION_DATA    14
 
 #define USE_NESTED_TRANSACTIONS
 #define MAX_NESTED_TRANSACTIONS 5
@@ -72,10 +72,24 @@ typedef struct dt_database_t
   /* ondisk DB */
   sqlite3 *handle;
 
+  /* prepared statements reused across calls, keyed by their SQL text */
+  GHashTable *stmt_cache;   // sql text -> dt_database_cached_stmt_t*
+  GHashTable *stmt_lookup;  // sqlite3_stmt* -> dt_database_cached_stmt_t*
+  dt_pthread_mutex_t stmt_cache_lock;
+
   gchar *error_message, *error_dbfilename;
   int error_other_pid;
 } dt_database_t;
 
+typedef struct dt_database_cached_stmt_t
+{
+  sqlite3_stmt *stmt;
+  gboolean busy;  // handed out and not yet released
+} dt_database_cached_stmt_t;
+
+
+/* finalize and forget all cached prepared statements */
+static void _stmt_cache_flush(dt_database_t *db);
 
 /* migrates database from old place to new */
 static void _database_migrate_to_xdg_structure();
@@ -2967,6 +2981,41 @@ static int _upgrade_library_schema_step(dt_database_t *db,
              "[init] can't add `flash_tagvalue' column to images table in database\n");
     new_version = 57;
   }
+  else if(version == 57)
+  {
+    // covering indexes for the standard collection sort orders. the
+    // filename and datetime_taken orders are already served by
+    // images_filename_index and images_datetime_taken_nc (id rides
+    // along for free as the rowid), but the rating order sorts on an
+    // expression over flags and always fell back to a full sort pass.
+    // the expression below has to match the ORDER BY clause built in
+    // _dt_collection_get_sort_text() verbatim for sqlite to use it.
+    TRY_EXEC("CREATE INDEX main.images_rating_index"
+             " ON images (CASE WHEN flags & 8 = 8 THEN -1 ELSE flags & 7 END, id)",
+             "[init] can't create rating index on images table\n");
+    new_version = 58;
+  }
+  else if(version == 58)
+  {
+    // remember when each film roll's folder was last crawled for
+    // changed sidecar files, so that the startup crawler can skip
+    // directories whose timestamp has not moved since
+    TRY_EXEC("ALTER TABLE main.film_rolls ADD COLUMN last_crawl INTEGER NOT NULL DEFAULT 0",
+             "[init] can't add `last_crawl' column to film_rolls table in database\n");
+    new_version = 59;
+  }
+  else if(version == 59)
+  {
+    // 64-bit hash of the raw file contents, filled at import time and
+    // indexed so duplicates of a file can be found across film rolls
+    // without re-reading the data. images imported before this version
+    // keep the default 0 until they are re-imported.
+    TRY_EXEC("ALTER TABLE main.images ADD COLUMN content_hash INTEGER NOT NULL DEFAULT 0",
+             "[init] can't add `content_hash' column to images table in database\n");
+    TRY_EXEC("CREATE INDEX main.images_content_hash_index ON images (content_hash)",
+             "[init] can't create content hash index on images table\n");
+    new_version = 60;
+  }
   else
     new_version = version; // should be the fallback so that calling code sees that we are in an infinite loop
 
@@ -3268,6 +3317,18 @@ static int _upgrade_data_schema_step(dt_database_t *db, const int version)
 
     new_version = 13;
   }
+  else if(version == 13)
+  {
+    // speed up auto-apply preset matching at image load: only a small
+    // subset of the presets is auto-applied but the matching queries
+    // scanned the whole table, including a correlated per-operation
+    // subquery doing the same scan again for every candidate row
+    TRY_EXEC("CREATE INDEX IF NOT EXISTS data.presets_autoapply_idx"
+             " ON presets (operation, writeprotect) WHERE autoapply = 1",
+             "can't create index `presets_autoapply_idx' in database");
+
+    new_version = 14;
+  }
   else
     new_version = version; // should be the fallback so that calling code sees that we are in an infinite loop
 
@@ -3686,6 +3747,11 @@ static void _create_data_schema(dt_database_t *db)
                NULL, NULL, NULL);
   sqlite3_exec(db->handle, "CREATE UNIQUE INDEX data.presets_idx ON presets (name, operation, op_version)",
                NULL, NULL, NULL);
+  // partial index so the per-image auto-apply matching only ever
+  // touches the auto-applied subset of the presets
+  sqlite3_exec(db->handle, "CREATE INDEX data.presets_autoapply_idx ON presets"
+                           " (operation, writeprotect) WHERE autoapply = 1",
+               NULL, NULL, NULL);
   ////////////////////////////// (map) locations
   sqlite3_exec(db->handle, "CREATE TABLE data.locations (tagid INTEGER PRIMARY KEY, "
                "type INTEGER, longitude REAL, latitude REAL, delta1 REAL, delta2 REAL, ratio FLOAT, polygons BLOB, "
@@ -4334,6 +4400,9 @@ start:
   dt_database_t *db = g_malloc0(sizeof(dt_database_t));
   db->dbfilename_data = g_strdup(dbfilename_data);
   db->dbfilename_library = g_strdup(dbfilename_library);
+  db->stmt_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  db->stmt_lookup = g_hash_table_new(g_direct_hash, g_direct_equal);
+  dt_pthread_mutex_init(&db->stmt_cache_lock, NULL);
 
   dt_atomic_set_int(&_trxid, 0);
 
@@ -4411,8 +4480,29 @@ start:
   sqlite3_finalize(stmt);
 
   // some sqlite3 config
-  sqlite3_exec(db->handle, "PRAGMA synchronous = OFF", NULL, NULL, NULL);
-  sqlite3_exec(db->handle, "PRAGMA journal_mode = MEMORY", NULL, NULL, NULL);
+  // WAL lets readers run while a write transaction is open and turns
+  // journal traffic into sequential appends; synchronous = NORMAL is
+  // safe in WAL mode and skips the fsync per transaction. sqlite
+  // refuses WAL on filesystems without shared-memory support (some
+  // network mounts) and reports the mode actually in effect, in which
+  // case we fall back to the old in-memory rollback journal.
+  gchar *main_mode = _get_pragma_string_val(db->handle, "main.journal_mode = WAL");
+  gchar *data_mode = _get_pragma_string_val(db->handle, "data.journal_mode = WAL");
+  if(!g_ascii_strcasecmp(main_mode ? main_mode : "", "wal"))
+  {
+    sqlite3_exec(db->handle, "PRAGMA synchronous = NORMAL", NULL, NULL, NULL);
+    // bound the wal file so a long session can't grow it unchecked
+    sqlite3_exec(db->handle, "PRAGMA wal_autocheckpoint = 1000", NULL, NULL, NULL);
+  }
+  else
+  {
+    dt_print(DT_DEBUG_SQL, "[init] WAL not available (`%s'), using in-memory journal",
+             main_mode ? main_mode : "?");
+    sqlite3_exec(db->handle, "PRAGMA synchronous = OFF", NULL, NULL, NULL);
+    sqlite3_exec(db->handle, "PRAGMA journal_mode = MEMORY", NULL, NULL, NULL);
+  }
+  g_free(main_mode);
+  g_free(data_mode);
   sqlite3_exec(db->handle, "PRAGMA page_size = 32768", NULL, NULL, NULL);
 
   // WARNING: the foreign_keys pragma must not be used, the integrity of the
@@ -4880,6 +4970,11 @@ void dt_upgrade_maker_model(const dt_database_t *db)
 
 void dt_database_destroy(const dt_database_t *db)
 {
+  dt_database_t *d = (dt_database_t *)db;
+  _stmt_cache_flush(d);
+  g_hash_table_destroy(d->stmt_cache);
+  g_hash_table_destroy(d->stmt_lookup);
+  dt_pthread_mutex_destroy(&d->stmt_cache_lock);
   sqlite3_close(db->handle);
   if(db->lockfile_data)
   {
@@ -4903,6 +4998,76 @@ sqlite3 *dt_database_get(const dt_database_t *db)
   return db ? db->handle : NULL;
 }
 
+// used on shutdown and before the busy-statement sweep which
+// finalizes statements behind our back
+static void _stmt_cache_flush(dt_database_t *db)
+{
+  dt_pthread_mutex_lock(&db->stmt_cache_lock);
+  GHashTableIter iter;
+  gpointer key, value;
+  g_hash_table_iter_init(&iter, db->stmt_cache);
+  while(g_hash_table_iter_next(&iter, &key, &value))
+    sqlite3_finalize(((dt_database_cached_stmt_t *)value)->stmt);
+  g_hash_table_remove_all(db->stmt_cache);
+  g_hash_table_remove_all(db->stmt_lookup);
+  dt_pthread_mutex_unlock(&db->stmt_cache_lock);
+}
+
+sqlite3_stmt *dt_database_get_statement(const dt_database_t *db, const char *sql)
+{
+  dt_database_t *d = (dt_database_t *)db;
+  sqlite3_stmt *stmt = NULL;
+
+  dt_pthread_mutex_lock(&d->stmt_cache_lock);
+  dt_database_cached_stmt_t *cached = g_hash_table_lookup(d->stmt_cache, sql);
+  if(cached && !cached->busy)
+  {
+    cached->busy = TRUE;
+    stmt = cached->stmt;
+    dt_pthread_mutex_unlock(&d->stmt_cache_lock);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return stmt;
+  }
+  if(!cached && sqlite3_prepare_v2(d->handle, sql, -1, &stmt, NULL) == SQLITE_OK)
+  {
+    cached = g_malloc0(sizeof(dt_database_cached_stmt_t));
+    cached->stmt = stmt;
+    cached->busy = TRUE;
+    g_hash_table_insert(d->stmt_cache, g_strdup(sql), cached);
+    g_hash_table_insert(d->stmt_lookup, stmt, cached);
+    dt_pthread_mutex_unlock(&d->stmt_cache_lock);
+    return stmt;
+  }
+  dt_pthread_mutex_unlock(&d->stmt_cache_lock);
+
+  // the cached statement is currently handed out to another thread, or
+  // the prepare above failed; hand out a one-shot statement which
+  // dt_database_release_statement() will finalize
+  DT_DEBUG_SQLITE3_PREPARE_V2(d->handle, sql, -1, &stmt, NULL);
+  return stmt;
+}
+
+void dt_database_release_statement(const dt_database_t *db, sqlite3_stmt *stmt)
+{
+  if(!stmt) return;
+  dt_database_t *d = (dt_database_t *)db;
+
+  dt_pthread_mutex_lock(&d->stmt_cache_lock);
+  dt_database_cached_stmt_t *cached = g_hash_table_lookup(d->stmt_lookup, stmt);
+  if(cached)
+  {
+    // reset right away so the statement holds no database locks while
+    // it sits in the cache
+    sqlite3_reset(stmt);
+    cached->busy = FALSE;
+    dt_pthread_mutex_unlock(&d->stmt_cache_lock);
+    return;
+  }
+  dt_pthread_mutex_unlock(&d->stmt_cache_lock);
+  sqlite3_finalize(stmt);
+}
+
 const gchar *dt_database_get_path(const dt_database_t *db)
 {
   return db->dbfilename_library;
@@ -4965,6 +5130,10 @@ gboolean dt_database_get_lock_acquired(const dt_database_t *db)
 
 void dt_database_cleanup_busy_statements(const dt_database_t *db)
 {
+  // drop the statement cache first, the sweep below would finalize its
+  // entries behind our back
+  _stmt_cache_flush((dt_database_t *)db);
+
   sqlite3_stmt *stmt = NULL;
   while( (stmt = sqlite3_next_stmt(db->handle, NULL)) != NULL)
   {
@@ -5093,6 +5262,45 @@ gboolean dt_database_maybe_maintenance(const dt_database_t *db)
   return FALSE;
 }
 
+void dt_database_perform_light_maintenance(const dt_database_t *db)
+{
+  if(_is_mem_db(db))
+    return;
+
+  // unlike dt_database_perform_maintenance() this never takes a long
+  // lock on the database, so it is safe to run from a background job
+  // while the application is in use.
+
+  const int main_free_count = _get_pragma_int_val(db->handle, "main.freelist_count");
+  const int main_page_count = _get_pragma_int_val(db->handle, "main.page_count");
+  const int data_free_count = _get_pragma_int_val(db->handle, "data.freelist_count");
+  const int data_page_count = _get_pragma_int_val(db->handle, "data.page_count");
+
+  dt_print(DT_DEBUG_SQL,
+           "[db maintenance] background pass, main: [%d/%d free pages], data: [%d/%d free pages]",
+           main_free_count, main_page_count, data_free_count, data_page_count);
+
+  // give free pages back in small chunks with a pause in between so
+  // the IO load stays negligible. this is a no-op unless the database
+  // uses incremental auto-vacuum.
+  for(int round = 0; round < 16; round++)
+  {
+    const int before = _get_pragma_int_val(db->handle, "main.freelist_count")
+                       + _get_pragma_int_val(db->handle, "data.freelist_count");
+    if(before == 0) break;
+    sqlite3_exec(db->handle, "PRAGMA main.incremental_vacuum(500)", NULL, NULL, NULL);
+    sqlite3_exec(db->handle, "PRAGMA data.incremental_vacuum(500)", NULL, NULL, NULL);
+    const int after = _get_pragma_int_val(db->handle, "main.freelist_count")
+                      + _get_pragma_int_val(db->handle, "data.freelist_count");
+    if(after >= before) break;
+    g_usleep(100000);
+  }
+
+  // refresh stale index statistics where sqlite deems it beneficial,
+  // cheap enough to run unconditionally
+  DT_DEBUG_SQLITE3_EXEC(db->handle, "PRAGMA optimize", NULL, NULL, NULL);
+}
+
 void dt_database_optimize(const dt_database_t *db)
 {
   if(_is_mem_db(db))
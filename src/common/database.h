@@ -33,6 +33,15 @@ struct dt_database_t *dt_database_init(const char *alternative,
 void dt_database_destroy(const struct dt_database_t *);
 /** get handle */
 struct sqlite3 *dt_database_get(const struct dt_database_t *);
+/** get a prepared statement for the given SQL text, reusing a cached
+ * one when possible so hot queries skip the re-prepare. must be given
+ * back with dt_database_release_statement(), never finalized by the
+ * caller. */
+struct sqlite3_stmt *dt_database_get_statement(const struct dt_database_t *db,
+                                               const char *sql);
+/** return a statement obtained from dt_database_get_statement() */
+void dt_database_release_statement(const struct dt_database_t *db,
+                                   struct sqlite3_stmt *stmt);
 /** Returns database path */
 const gchar *dt_database_get_path(const struct dt_database_t *db);
 /** test if database was already locked by another instance */
@@ -45,6 +54,10 @@ void dt_database_optimize(const struct dt_database_t *);
 /** conditionally perfrom db maintenance */
 gboolean dt_database_maybe_maintenance(const struct dt_database_t *db);
 void dt_database_perform_maintenance(const struct dt_database_t *db);
+/** lightweight maintenance (incremental vacuum chunks + PRAGMA
+ * optimize) safe to run from a background job while darktable is in
+ * use */
+void dt_database_perform_light_maintenance(const struct dt_database_t *db);
 /** cleanup busy statements on closing dt, just before performing maintenance */
 void dt_database_cleanup_busy_statements(const struct dt_database_t *db);
 /** simply create db snapshot of both library and data */
@@ -108,24 +108,31 @@ float dt_image_distance_transform(float *const src,
   }
 
   const size_t maxdim = MAX(width, height);
+  // process columns in blocks so the strided gather/scatter of the
+  // vertical phase makes use of whole cache lines
+  const size_t colblock = 16;
   float max_distance = 0.0f;
-  DT_OMP_PRAGMA(parallel reduction(max : max_distance) 
-                dt_omp_firstprivate(out, maxdim, width, height))
+  DT_OMP_PRAGMA(parallel reduction(max : max_distance)
+                dt_omp_firstprivate(out, maxdim, width, height, colblock))
   {
-    float *f = dt_alloc_align_float(maxdim);
+    float *f = dt_alloc_align_float(colblock * maxdim);
     float *z = dt_alloc_align_float(maxdim + 1);
-    float *d = dt_alloc_align_float(maxdim);
+    float *d = dt_alloc_align_float(colblock * maxdim);
     int *v = dt_alloc_align_int(maxdim);
 
     // transform along columns
     DT_OMP_PRAGMA(for schedule (static))
-    for(size_t x = 0; x < width; x++)
+    for(size_t x = 0; x < width; x += colblock)
     {
+      const size_t bsize = MIN(colblock, width - x);
       for(size_t y = 0; y < height; y++)
-        f[y] = out[y*width + x];
-      _image_distance_transform(f, z, d, v, height);
+        for(size_t k = 0; k < bsize; k++)
+          f[k*maxdim + y] = out[y*width + x + k];
+      for(size_t k = 0; k < bsize; k++)
+        _image_distance_transform(f + k*maxdim, z, d + k*maxdim, v, height);
       for(size_t y = 0; y < height; y++)
-        out[y*width + x] = d[y];
+        for(size_t k = 0; k < bsize; k++)
+          out[y*width + x + k] = d[k*maxdim + y];
     }
     // implicit barrier :-)
     // transform along rows
@@ -162,6 +162,7 @@ dt_dlopencl_t *dt_dlopencl_init(const char *name)
     success = success && dt_gmodule_symbol(module, "clEnqueueCopyBufferToImage",
                                            (void (**)(void)) & ocl->symbols->dt_clEnqueueCopyBufferToImage);
     success = success && dt_gmodule_symbol(module, "clFinish", (void (**)(void)) & ocl->symbols->dt_clFinish);
+    success = success && dt_gmodule_symbol(module, "clFlush", (void (**)(void)) & ocl->symbols->dt_clFlush);
     success = success && dt_gmodule_symbol(module, "clEnqueueReadBuffer",
                                            (void (**)(void)) & ocl->symbols->dt_clEnqueueReadBuffer);
     success = success && dt_gmodule_symbol(module, "clReleaseMemObject",
@@ -198,6 +199,8 @@ dt_dlopencl_t *dt_dlopencl_init(const char *name)
                                            (void (**)(void)) & ocl->symbols->dt_clEnqueueCopyBuffer);
     success = success && dt_gmodule_symbol(module, "clEnqueueMapBuffer",
                                            (void (**)(void)) & ocl->symbols->dt_clEnqueueMapBuffer);
+    success = success && dt_gmodule_symbol(module, "clEnqueueMapImage",
+                                           (void (**)(void)) & ocl->symbols->dt_clEnqueueMapImage);
     success = success && dt_gmodule_symbol(module, "clEnqueueUnmapMemObject",
                                            (void (**)(void)) & ocl->symbols->dt_clEnqueueUnmapMemObject);
     success = success && dt_gmodule_symbol(module, "clGetMemObjectInfo",
@@ -57,10 +57,21 @@ static uint32_t _get_long(uint8_t *ptr)
   return GUINT32_FROM_BE(in);
 }
 
-void dt_dng_opcode_process_opcode_list_2(uint8_t *buf, uint32_t buf_size, dt_image_t *img)
+void dt_dng_opcode_stash_opcode_list_2(uint8_t *buf, uint32_t buf_size, dt_image_t *img)
 {
-  g_list_free_full(img->dng_gain_maps, g_free);
-  img->dng_gain_maps = NULL;
+  g_free(img->dng_opcode_list2);
+  img->dng_opcode_list2 = buf;
+  img->dng_opcode_list2_size = buf_size;
+}
+
+GList *dt_dng_opcode_get_gain_maps(const dt_image_t *img)
+{
+  uint8_t *buf = img->dng_opcode_list2;
+  const uint32_t buf_size = img->dng_opcode_list2_size;
+  if(!buf || buf_size < 4)
+    return NULL;
+
+  GList *gain_maps = NULL;
 
   uint32_t count = _get_long(&buf[0]);
   uint32_t offset = 4;
@@ -74,7 +85,7 @@ void dt_dng_opcode_process_opcode_list_2(uint8_t *buf, uint32_t buf_size, dt_ima
     if(offset + 16 + param_size > buf_size)
     {
       dt_print(DT_DEBUG_IMAGEIO, "[dng_opcode] Invalid opcode size in OpcodeList2");
-      return;
+      return gain_maps;
     }
 
     if(opcode_id == OPCODE_ID_GAINMAP)
@@ -99,7 +110,7 @@ void dt_dng_opcode_process_opcode_list_2(uint8_t *buf, uint32_t buf_size, dt_ima
       for(int i = 0; i < gain_count; i++)
         gm->map_gain[i] = _get_float(&param[76 + 4*i]);
 
-      img->dng_gain_maps = g_list_append(img->dng_gain_maps, gm);
+      gain_maps = g_list_append(gain_maps, gm);
     }
     else
     {
@@ -110,6 +121,7 @@ void dt_dng_opcode_process_opcode_list_2(uint8_t *buf, uint32_t buf_size, dt_ima
     offset += 16 + param_size;
     count--;
   }
+  return gain_maps;
 }
 
 void dt_dng_opcode_process_opcode_list_3(uint8_t *buf, uint32_t buf_size, dt_image_t *img)
@@ -43,7 +43,14 @@ typedef struct dt_dng_gain_map_t
   float map_gain[];
 } dt_dng_gain_map_t;
 
-void dt_dng_opcode_process_opcode_list_2(uint8_t *buf, uint32_t size, dt_image_t *img);
+/** store the raw OpcodeList2 blob in the image, taking ownership of buf.
+ * parsing the contained GainMaps is deferred until the pipe asks for them,
+ * so thumbnail-only paths never pay for it. */
+void dt_dng_opcode_stash_opcode_list_2(uint8_t *buf, uint32_t size, dt_image_t *img);
+/** parse the stashed OpcodeList2 blob into a list of dt_dng_gain_map_t.
+ * returns NULL if there is no blob or no GainMaps in it; the caller owns
+ * the result and frees it with g_list_free_full(list, g_free). */
+GList *dt_dng_opcode_get_gain_maps(const dt_image_t *img);
 void dt_dng_opcode_process_opcode_list_3(uint8_t *buf, uint32_t size, dt_image_t *img);
 
 G_END_DECLS
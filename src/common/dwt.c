@@ -202,6 +202,20 @@ static void dwt_decompose_horiz(
   }
 }
 
+// sum a detail scale into an accumulator; the first scale is copied so
+// the accumulator never needs to be cleared up front
+static void dwt_accumulate_layer(float *const acc, const float *const img, gboolean *filled,
+                                 const dwt_params_t *const p)
+{
+  if(*filled)
+    dt_iop_image_add_image(acc, img, p->width, p->height, p->ch);
+  else
+  {
+    dt_iop_image_copy_by_size(acc, img, p->width, p->height, p->ch);
+    *filled = TRUE;
+  }
+}
+
 // split input into 'coarse' and 'details'; put 'details' back into the input buffer
 static void dwt_decompose_layer(
     float *const restrict out,
@@ -240,11 +254,15 @@ static void dwt_wavelet_decompose(float *img,
   dt_iop_roi_t roi = { .x = 0, .y = 0, .height = p->height, .width = p->width };
   size_t padded_size;
   const int do_merge = p->merge_from_scale > 0;
+  // the reconstruction accumulator is only needed when recomposing the
+  // full image; the first scale written to it is copied instead of
+  // added, so no clearing pass is needed either
+  const int do_recompose = p->return_layer == 0;
   if(!dt_iop_alloc_image_buffers(NULL, &roi, &roi,
                                  4 | DT_IMGSZ_INPUT, &buffer[1],
-                                 4 | DT_IMGSZ_INPUT | DT_IMGSZ_CLEARBUF, &layers,
+                                 (do_recompose ? 4 | DT_IMGSZ_INPUT : 0), &layers,
                                  4 | DT_IMGSZ_WIDTH | DT_IMGSZ_PERTHREAD, &temp, &padded_size,
-                                 (do_merge ? 4 | DT_IMGSZ_INPUT | DT_IMGSZ_CLEARBUF : 0), &merged_layers,
+                                 (do_merge ? 4 | DT_IMGSZ_INPUT : 0), &merged_layers,
                                  0, NULL))
   {
     dt_print(DT_DEBUG_ALWAYS,
@@ -255,6 +273,8 @@ static void dwt_wavelet_decompose(float *img,
   // iterate over wavelet scales
   unsigned int hpass = 0;
   int bcontinue = 1;
+  gboolean layers_filled = FALSE;
+  gboolean merged_filled = FALSE;
   for(unsigned int lev = 0; lev < p->scales && bcontinue; lev++)
   {
     unsigned int lpass = (1 - (lev & 1));
@@ -279,14 +299,14 @@ static void dwt_wavelet_decompose(float *img,
       else if(p->return_layer == 0)
       {
         // add this detail scale to the final image
-        dt_iop_image_add_image(layers, buffer[hpass], p->width, p->height, p->ch);
+        dwt_accumulate_layer(layers, buffer[hpass], &layers_filled, p);
       }
     }
     // we are on the merge scales range
     else
     {
       // add this detail scale to the merged ones
-      dt_iop_image_add_image(merged_layers, buffer[hpass], p->width, p->height, p->ch);
+      dwt_accumulate_layer(merged_layers, buffer[hpass], &merged_filled, p);
 
       // allow to process this merged scale
       if(layer_func) layer_func(merged_layers, p, lev + 1);
@@ -319,15 +339,17 @@ static void dwt_wavelet_decompose(float *img,
     // return reconstructed image
     else if(p->return_layer == 0)
     {
-      // some of the detail scales are on the merged layers
-      if(p->merge_from_scale > 0)
+      // some of the detail scales are on the merged layers; if the scale
+      // count got clamped below the merge start nothing was ever
+      // accumulated and the buffer content is undefined, so skip it
+      if(p->merge_from_scale > 0 && merged_filled)
       {
         // add merged layers to final image
-        dt_iop_image_add_image(layers, merged_layers, p->width, p->height, p->ch);
+        dwt_accumulate_layer(layers, merged_layers, &layers_filled, p);
       }
 
       // add residual image to final image
-      dt_iop_image_add_image(layers, buffer[hpass], p->width, p->height, p->ch);
+      dwt_accumulate_layer(layers, buffer[hpass], &layers_filled, p);
 
       // allow to process reconstructed image
       if(layer_func) layer_func(layers, p, p->scales + 2);
@@ -532,7 +554,6 @@ dt_dwt_cl_global_t *dt_dwt_init_cl_global()
   g->kernel_dwt_subtract_layer = dt_opencl_create_kernel(program, "dwt_subtract_layer");
   g->kernel_dwt_hat_transform_col = dt_opencl_create_kernel(program, "dwt_hat_transform_col");
   g->kernel_dwt_hat_transform_row = dt_opencl_create_kernel(program, "dwt_hat_transform_row");
-  g->kernel_dwt_init_buffer = dt_opencl_create_kernel(program, "dwt_init_buffer");
   return g;
 }
 
@@ -545,7 +566,6 @@ void dt_dwt_free_cl_global(dt_dwt_cl_global_t *g)
   dt_opencl_free_kernel(g->kernel_dwt_subtract_layer);
   dt_opencl_free_kernel(g->kernel_dwt_hat_transform_col);
   dt_opencl_free_kernel(g->kernel_dwt_hat_transform_row);
-  dt_opencl_free_kernel(g->kernel_dwt_init_buffer);
 
   free(g);
 }
@@ -618,6 +638,19 @@ static cl_int dwt_add_layer_cl(cl_mem img, cl_mem layers, dwt_params_cl_t *const
     CLARG(img), CLARG(layers), CLARG((width)), CLARG((height)));
 }
 
+// as in the CPU path the first scale written to an accumulator is
+// copied, so the buffer needs no initialization
+static cl_int dwt_accumulate_layer_cl(cl_mem acc, cl_mem img, gboolean *filled,
+                                      dwt_params_cl_t *const p, const int n_scale)
+{
+  if(*filled)
+    return dwt_add_layer_cl(img, acc, p, n_scale);
+
+  *filled = TRUE;
+  return dt_opencl_enqueue_copy_buffer_to_buffer(p->devid, img, acc, 0, 0,
+                                                 (size_t)p->width * p->height * p->ch * sizeof(float));
+}
+
 static cl_int dwt_get_image_layer_cl(cl_mem layer, dwt_params_cl_t *const p)
 {
   cl_int err = CL_SUCCESS;
@@ -657,43 +690,26 @@ static cl_int dwt_wavelet_decompose_cl(cl_mem img, dwt_params_cl_t *const p, _dw
   buffer[1] = dt_opencl_alloc_device_buffer(devid, sizeof(float) * p->ch * p->width * p->height);
   if(buffer[1] == NULL) goto cleanup;
 
-  // buffer to reconstruct the image
-  layers = dt_opencl_alloc_device_buffer(devid, sizeof(float) * p->ch * p->width * p->height);
-  if(layers == NULL) goto cleanup;
-
-  // init layer buffer
+  // buffer to reconstruct the image; only needed when recomposing the
+  // full image, and the first scale written to it is copied so there is
+  // no need to clear it
+  if(p->return_layer == 0)
   {
-    const int kernel = p->global->kernel_dwt_init_buffer;
-
-    const int width = p->width;
-    const int height = p->height;
-
-    err = dt_opencl_enqueue_kernel_2d_args(devid, kernel, p->width, p->height,
-      CLARG(layers), CLARG((width)), CLARG((height)));
-    if(err != CL_SUCCESS) goto cleanup;
+    layers = dt_opencl_alloc_device_buffer(devid, sizeof(float) * p->ch * p->width * p->height);
+    if(layers == NULL) goto cleanup;
   }
 
   if(p->merge_from_scale > 0)
   {
     merged_layers = dt_opencl_alloc_device_buffer(devid, sizeof(float) * p->ch * p->width * p->height);
     if(merged_layers == NULL) goto cleanup;
-
-    // init reconstruct buffer
-    {
-      const int kernel = p->global->kernel_dwt_init_buffer;
-
-      const int width = p->width;
-      const int height = p->height;
-
-      err = dt_opencl_enqueue_kernel_2d_args(devid, kernel, p->width, p->height,
-        CLARG(merged_layers), CLARG((width)), CLARG((height)));
-      if(err != CL_SUCCESS) goto cleanup;
-    }
   }
 
   // iterate over wavelet scales
   lpass = 1;
   hpass = 0;
+  gboolean layers_filled = FALSE;
+  gboolean merged_filled = FALSE;
   for(unsigned int lev = 0; lev < p->scales && bcontinue; lev++)
   {
     lpass = (1 - (lev & 1));
@@ -759,7 +775,7 @@ static cl_int dwt_wavelet_decompose_cl(cl_mem img, dwt_params_cl_t *const p, _dw
       else if(p->return_layer == 0)
       {
         // add this detail scale to the final image
-        err = dwt_add_layer_cl(buffer[hpass], layers, p, lev + 1);
+        err = dwt_accumulate_layer_cl(layers, buffer[hpass], &layers_filled, p, lev + 1);
         if(err != CL_SUCCESS) goto cleanup;
       }
     }
@@ -767,7 +783,7 @@ static cl_int dwt_wavelet_decompose_cl(cl_mem img, dwt_params_cl_t *const p, _dw
     else
     {
       // add this detail scale to the merged ones
-      err = dwt_add_layer_cl(buffer[hpass], merged_layers, p, lev + 1);
+      err = dwt_accumulate_layer_cl(merged_layers, buffer[hpass], &merged_filled, p, lev + 1);
       if(err != CL_SUCCESS) goto cleanup;
 
       // allow to process this merged scale
@@ -811,16 +827,18 @@ static cl_int dwt_wavelet_decompose_cl(cl_mem img, dwt_params_cl_t *const p, _dw
     // return reconstructed image
     else if(p->return_layer == 0)
     {
-      // some of the detail scales are on the merged layers
-      if(p->merge_from_scale > 0)
+      // some of the detail scales are on the merged layers; if the scale
+      // count got clamped below the merge start nothing was ever
+      // accumulated and the buffer content is undefined, so skip it
+      if(p->merge_from_scale > 0 && merged_filled)
       {
         // add merged layers to final image
-        err = dwt_add_layer_cl(merged_layers, layers, p, p->scales + 1);
+        err = dwt_accumulate_layer_cl(layers, merged_layers, &layers_filled, p, p->scales + 1);
         if(err != CL_SUCCESS) goto cleanup;
       }
 
       // add residual image to final image
-      err = dwt_add_layer_cl(buffer[hpass], layers, p, p->scales + 1);
+      err = dwt_accumulate_layer_cl(layers, buffer[hpass], &layers_filled, p, p->scales + 1);
       if(err != CL_SUCCESS) goto cleanup;
 
       // allow to process reconstructed image
@@ -107,6 +107,8 @@ static inline void accumulate(dt_aligned_pixel_t accum,
   }                                                                       				     \
   copy_pixel_nontemporal(pcoarse + 4*i,sum);                                  				     \
   accumulate(pdetail + 4*i, det, threshold, boost);							     \
+  if(accumulate_coarse)                                                                                      \
+    for_four_channels(c,aligned(pdetail:16)) pdetail[4*i+c] += sum[c];                                       \
 
 void eaw_decompose_and_synthesize(float *const restrict out,
                                   const float *const restrict in,
@@ -115,6 +117,7 @@ void eaw_decompose_and_synthesize(float *const restrict out,
                                   const float sharpen,
                                   const dt_aligned_pixel_t threshold,
                                   const dt_aligned_pixel_t boost,
+                                  const gboolean accumulate_coarse,
                                   const ssize_t width,
                                   const ssize_t height)
 {
@@ -29,6 +29,10 @@ typedef void((*eaw_synthesize_t)(float *const out, const float *const in, const
                                  const float *const restrict thrsf, const float *const restrict boostf,
                                  const int32_t width, const int32_t height));
 
+// decompose one wavelet scale of 'in' into the coarse 'out', thresholding
+// and boosting the detail coefficients directly into 'accum'; setting
+// 'accumulate_coarse' (on the final scale) folds the coarse residue into
+// 'accum' as well, saving the caller a separate sweep over the buffer
 void eaw_decompose_and_synthesize(float *const restrict out,
                                   const float *const restrict in,
                                   float *const restrict accum,
@@ -36,6 +40,7 @@ void eaw_decompose_and_synthesize(float *const restrict out,
                                   const float sharpen,
                                   const dt_aligned_pixel_t threshold,
                                   const dt_aligned_pixel_t boost,
+                                  const gboolean accumulate_coarse,
                                   const ssize_t width,
                                   const ssize_t height) ;
 void eaw_synthesize(float *const restrict out,
@@ -946,8 +946,9 @@ static gboolean _check_dng_opcodes(Exiv2::ExifData &exifData,
     if(data)
     {
       pos->copy(data, Exiv2::invalidByteOrder);
-      dt_dng_opcode_process_opcode_list_2(data, pos->size(), img);
-      g_free(data);
+      // the stash takes ownership of data; the GainMaps inside are only
+      // parsed once the pipe asks for them
+      dt_dng_opcode_stash_opcode_list_2(data, pos->size(), img);
       has_opcodes = TRUE;
     }
   }
@@ -2458,14 +2459,27 @@ gboolean dt_exif_read_from_blob(dt_image_t *img,
 gboolean dt_exif_get_thumbnail(const char *path,
                                uint8_t **buffer,
                                size_t *size,
-                               char **mime_type)
+                               char **mime_type,
+                               dt_image_orientation_t *orientation)
 {
+  if(orientation) *orientation = ORIENTATION_NONE;
+
   try
   {
     std::unique_ptr<Exiv2::Image> image(Exiv2::ImageFactory::open(WIDEN(path)));
     assert(image.get() != 0);
     read_metadata_threadsafe(image);
 
+    // the metadata is parsed now anyway, hand out the orientation from
+    // the same pass if the caller wants it
+    if(orientation)
+    {
+      Exiv2::ExifData &exifData = image->exifData();
+      Exiv2::ExifData::const_iterator pos;
+      if(FIND_EXIF_TAG("Exif.Image.Orientation"))
+        *orientation = dt_image_orientation_to_flip_bits(pos->toLong());
+    }
+
     // Get a list of preview images available in the image. The list is sorted
     // by the preview image pixel size, starting with the smallest preview.
     Exiv2::PreviewManager loader(*image);
@@ -115,8 +115,11 @@ gboolean dt_exif_xmp_read(dt_image_t *img, const char *filename, const gboolean
 /** apply default import metadata */
 void dt_exif_apply_default_metadata(dt_image_t *img);
 
-/** fetch largest exif thumbnail jpg bytestream into buffer. Returns TRUE in case of any error */
-gboolean dt_exif_get_thumbnail(const char *path, uint8_t **buffer, size_t *size, char **mime_type);
+/** fetch largest exif thumbnail jpg bytestream into buffer. Returns TRUE in case of any error.
+ * orientation may be NULL, otherwise it receives the exif orientation from the same parse so
+ * callers don't have to open the file with exiv2 a second time just for that. */
+gboolean dt_exif_get_thumbnail(const char *path, uint8_t **buffer, size_t *size, char **mime_type,
+                               dt_image_orientation_t *orientation);
 
 /** thread safe init and cleanup. */
 void dt_exif_init();
@@ -0,0 +1,221 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2025 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/fts.h"
+#include "common/database.h"
+#include "common/debug.h"
+#include "common/utility.h"
+#include "control/control.h"
+#include "control/jobs.h"
+
+#include <sqlite3.h>
+#include <string.h>
+
+static volatile gboolean _fts_ready = FALSE;
+
+gboolean dt_fts_available(void)
+{
+  return sqlite3_compileoption_used("ENABLE_FTS5");
+}
+
+gboolean dt_fts_ready(void)
+{
+  return _fts_ready;
+}
+
+static int32_t _fts_populate_job_run(dt_job_t *job)
+{
+  sqlite3 *db = dt_database_get(darktable.db);
+  const double start = dt_get_wtime();
+
+  // the triggers are already live, so clear anything they may have
+  // inserted in the meantime and rebuild from scratch in one
+  // transaction.  all statements run on the shared library handle, so
+  // nothing can interleave with the bulk inserts.
+  dt_database_start_transaction(darktable.db);
+
+  DT_DEBUG_SQLITE3_EXEC(db, "DELETE FROM memory.tags_fts", NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "INSERT INTO memory.tags_fts (rowid, name, synonyms)"
+                        " SELECT id, name, synonyms FROM data.tags",
+                        NULL, NULL, NULL);
+
+  DT_DEBUG_SQLITE3_EXEC(db, "DELETE FROM memory.metadata_fts", NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "INSERT INTO memory.metadata_fts (rowid, value)"
+                        " SELECT rowid, value FROM main.meta_data",
+                        NULL, NULL, NULL);
+
+  DT_DEBUG_SQLITE3_EXEC(db, "DELETE FROM memory.filename_fts", NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "INSERT INTO memory.filename_fts (rowid, filename)"
+                        " SELECT id, filename FROM main.images",
+                        NULL, NULL, NULL);
+
+  dt_database_release_transaction(darktable.db);
+
+  _fts_ready = TRUE;
+  dt_print(DT_DEBUG_SQL, "[fts] search index built in %.3f secs",
+           dt_get_wtime() - start);
+  return 0;
+}
+
+void dt_fts_init(void)
+{
+  if(!dt_fts_available())
+  {
+    dt_print(DT_DEBUG_SQL, "[fts] sqlite was built without fts5,"
+                           " text search falls back to LIKE scans");
+    return;
+  }
+
+  sqlite3 *db = dt_database_get(darktable.db);
+
+  // the shadow tables live in the memory database so that an older
+  // darktable or an fts5-less sqlite opening the library never sees
+  // them.  rowids are the ids of the mirrored rows.
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE VIRTUAL TABLE IF NOT EXISTS memory.tags_fts"
+                        " USING fts5(name, synonyms, tokenize='unicode61')",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE VIRTUAL TABLE IF NOT EXISTS memory.metadata_fts"
+                        " USING fts5(value, tokenize='unicode61')",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE VIRTUAL TABLE IF NOT EXISTS memory.filename_fts"
+                        " USING fts5(filename, tokenize='unicode61')",
+                        NULL, NULL, NULL);
+
+  // temp triggers keep the shadow tables in sync with the existing
+  // write paths without touching them.  unlike regular triggers they
+  // may reference tables across databases and vanish with the session.
+  // clang-format off
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_tags_insert"
+                        " AFTER INSERT ON data.tags BEGIN"
+                        "  INSERT INTO memory.tags_fts (rowid, name, synonyms)"
+                        "   VALUES (NEW.id, NEW.name, NEW.synonyms);"
+                        " END",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_tags_update"
+                        " AFTER UPDATE OF name, synonyms ON data.tags BEGIN"
+                        "  UPDATE memory.tags_fts"
+                        "   SET name = NEW.name, synonyms = NEW.synonyms"
+                        "   WHERE rowid = NEW.id;"
+                        " END",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_tags_delete"
+                        " AFTER DELETE ON data.tags BEGIN"
+                        "  DELETE FROM memory.tags_fts WHERE rowid = OLD.id;"
+                        " END",
+                        NULL, NULL, NULL);
+
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_metadata_insert"
+                        " AFTER INSERT ON main.meta_data BEGIN"
+                        "  INSERT INTO memory.metadata_fts (rowid, value)"
+                        "   VALUES (NEW.rowid, NEW.value);"
+                        " END",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_metadata_update"
+                        " AFTER UPDATE OF value ON main.meta_data BEGIN"
+                        "  UPDATE memory.metadata_fts SET value = NEW.value"
+                        "   WHERE rowid = NEW.rowid;"
+                        " END",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_metadata_delete"
+                        " AFTER DELETE ON main.meta_data BEGIN"
+                        "  DELETE FROM memory.metadata_fts WHERE rowid = OLD.rowid;"
+                        " END",
+                        NULL, NULL, NULL);
+
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_filename_insert"
+                        " AFTER INSERT ON main.images BEGIN"
+                        "  INSERT INTO memory.filename_fts (rowid, filename)"
+                        "   VALUES (NEW.id, NEW.filename);"
+                        " END",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_filename_update"
+                        " AFTER UPDATE OF filename ON main.images BEGIN"
+                        "  UPDATE memory.filename_fts SET filename = NEW.filename"
+                        "   WHERE rowid = NEW.id;"
+                        " END",
+                        NULL, NULL, NULL);
+  DT_DEBUG_SQLITE3_EXEC(db,
+                        "CREATE TEMP TRIGGER IF NOT EXISTS fts_filename_delete"
+                        " AFTER DELETE ON main.images BEGIN"
+                        "  DELETE FROM memory.filename_fts WHERE rowid = OLD.id;"
+                        " END",
+                        NULL, NULL, NULL);
+  // clang-format on
+
+  dt_job_t *job = dt_control_job_create(&_fts_populate_job_run, "%s",
+                                        N_("building search index"));
+  if(job) dt_control_add_job(DT_JOB_QUEUE_SYSTEM_BG, job);
+}
+
+gchar *dt_fts_match_from_like(const char *pattern)
+{
+  if(!pattern) return NULL;
+  const size_t len = strlen(pattern);
+
+  // only the default "%term%" shape of the search entry can be served:
+  // anchored searches and embedded wildcards carry substring semantics
+  // the token index can't reproduce
+  if(len < 3 || pattern[0] != '%' || pattern[len - 1] != '%') return NULL;
+  gchar *inner = g_strndup(pattern + 1, len - 2);
+  if(strchr(inner, '%') || strchr(inner, '_'))
+  {
+    g_free(inner);
+    return NULL;
+  }
+
+  // one prefix token per word, implicitly ANDed by fts5
+  gchar **words = g_strsplit_set(inner, " \t", -1);
+  GString *match = g_string_new(NULL);
+  for(int i = 0; words[i]; i++)
+  {
+    if(!*words[i]) continue;
+    gchar *escaped = dt_util_str_replace(words[i], "\"", "\"\"");
+    if(match->len) g_string_append_c(match, ' ');
+    g_string_append_printf(match, "\"%s\"*", escaped);
+    g_free(escaped);
+  }
+  g_strfreev(words);
+  g_free(inner);
+
+  if(match->len == 0)
+  {
+    g_string_free(match, TRUE);
+    return NULL;
+  }
+  return g_string_free(match, FALSE);
+}
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
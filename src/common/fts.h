@@ -0,0 +1,54 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2025 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/darktable.h"
+
+G_BEGIN_DECLS
+
+/* session-lifetime fts5 shadow tables over tag names/synonyms, metadata
+ * values and filenames, kept in the memory database and maintained by
+ * temp triggers on the underlying tables.  the text search of the
+ * filtering module queries these instead of running LIKE '%term%' full
+ * scans over the big tables. */
+
+/** TRUE when the linked sqlite has the fts5 extension compiled in */
+gboolean dt_fts_available(void);
+
+/** create the shadow tables and triggers and schedule the background
+ * job that populates them.  no-op when fts5 is unavailable. */
+void dt_fts_init(void);
+
+/** TRUE once the shadow tables are fully populated and may be queried */
+gboolean dt_fts_ready(void);
+
+/** translate a LIKE pattern as produced by the search entry into an
+ * fts5 MATCH expression of prefix tokens, or return NULL when the
+ * pattern uses wildcards the token index cannot serve.  the input is
+ * expected to already be %q-escaped, the result may be embedded into a
+ * single-quoted SQL literal as-is and has to be freed by the caller. */
+gchar *dt_fts_match_from_like(const char *pattern);
+
+G_END_DECLS
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
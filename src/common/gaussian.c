@@ -196,8 +196,242 @@ error:
 }
 
 
+// single channel version of the recursive filter below. the generic
+// code keeps only one SIMD lane busy for flat buffers, so here we carry
+// the recurrence in four lanes at once: four adjacent columns per
+// register in the vertical pass (contiguous loads) and four independent
+// rows per register in the horizontal pass. the lanes never interact,
+// each one runs the very same forward/backward recurrence.
+static void _gaussian_blur_1c(dt_gaussian_t *g, const float *const in, float *const out)
+{
+  const int width = g->width;
+  const int height = g->height;
+
+  float a0, a1, a2, a3, b1, b2, coefp, coefn;
+
+  _compute_gauss_params(g->sigma, g->order, &a0, &a1, &a2, &a3, &b1, &b2, &coefp, &coefn);
+
+  float *const temp = g->buf;
+
+  const float fmax = g->max[0];
+  const float fmin = g->min[0];
+
+// vertical blur, four adjacent columns at a time
+  DT_OMP_FOR()
+  for(int i = 0; i < width; i += 4)
+  {
+    if(i + 4 <= width)
+    {
+      dt_aligned_pixel_t xp = {0.0f};
+      dt_aligned_pixel_t yb = {0.0f};
+      dt_aligned_pixel_t yp = {0.0f};
+
+      // forward filter
+      for_four_channels(k)
+      {
+        xp[k] = CLAMPF(in[i + k], fmin, fmax);
+        yb[k] = xp[k] * coefp;
+        yp[k] = yb[k];
+      }
+
+      dt_aligned_pixel_t xc, yc, xn, xa, yn, ya;
+      for(int j = 0; j < height; j++)
+      {
+        const size_t offset = (size_t)j * width + i;
+
+        for_four_channels(k)
+        {
+          xc[k] = CLAMPF(in[offset + k], fmin, fmax);
+          yc[k] = (a0 * xc[k]) + (a1 * xp[k]) - (b1 * yp[k]) - (b2 * yb[k]);
+
+          // can't use copy_pixel here, offset need not be aligned
+          temp[offset + k] = yc[k];
+
+          xp[k] = xc[k];
+          yb[k] = yp[k];
+          yp[k] = yc[k];
+        }
+      }
+
+      // backward filter
+      for_four_channels(k)
+      {
+        xn[k] = CLAMPF(in[(size_t)(height - 1) * width + i + k], fmin, fmax);
+        xa[k] = xn[k];
+        yn[k] = xn[k] * coefn;
+        ya[k] = yn[k];
+      }
+
+      for(int j = height - 1; j > -1; j--)
+      {
+        const size_t offset = (size_t)j * width + i;
+
+        for_four_channels(k)
+        {
+          xc[k] = CLAMPF(in[offset + k], fmin, fmax);
+
+          yc[k] = (a2 * xn[k]) + (a3 * xa[k]) - (b1 * yn[k]) - (b2 * ya[k]);
+
+          xa[k] = xn[k];
+          xn[k] = xc[k];
+          ya[k] = yn[k];
+          yn[k] = yc[k];
+
+          temp[offset + k] += yc[k];
+        }
+      }
+    }
+    else
+    {
+      // up to three leftover columns at the right edge, one lane each
+      for(int l = i; l < width; l++)
+      {
+        float xp = CLAMPF(in[l], fmin, fmax);
+        float yb = xp * coefp;
+        float yp = yb;
+
+        for(int j = 0; j < height; j++)
+        {
+          const size_t offset = (size_t)j * width + l;
+          const float xc = CLAMPF(in[offset], fmin, fmax);
+          const float yc = (a0 * xc) + (a1 * xp) - (b1 * yp) - (b2 * yb);
+          temp[offset] = yc;
+          xp = xc;
+          yb = yp;
+          yp = yc;
+        }
+
+        float xn = CLAMPF(in[(size_t)(height - 1) * width + l], fmin, fmax);
+        float xa = xn;
+        float yn = xn * coefn;
+        float ya = yn;
+
+        for(int j = height - 1; j > -1; j--)
+        {
+          const size_t offset = (size_t)j * width + l;
+          const float xc = CLAMPF(in[offset], fmin, fmax);
+          const float yc = (a2 * xn) + (a3 * xa) - (b1 * yn) - (b2 * ya);
+          xa = xn;
+          xn = xc;
+          ya = yn;
+          yn = yc;
+          temp[offset] += yc;
+        }
+      }
+    }
+  }
+
+// horizontal blur, four independent rows at a time
+  DT_OMP_FOR()
+  for(int j = 0; j < height; j += 4)
+  {
+    if(j + 4 <= height)
+    {
+      const size_t row[4] = { (size_t)j * width, (size_t)(j + 1) * width,
+                              (size_t)(j + 2) * width, (size_t)(j + 3) * width };
+
+      dt_aligned_pixel_t xp = {0.0f};
+      dt_aligned_pixel_t yb = {0.0f};
+      dt_aligned_pixel_t yp = {0.0f};
+
+      // forward filter
+      for_four_channels(k)
+      {
+        xp[k] = CLAMPF(temp[row[k]], fmin, fmax);
+        yb[k] = xp[k] * coefp;
+        yp[k] = yb[k];
+      }
+
+      dt_aligned_pixel_t xc, yc, xn, xa, yn, ya;
+      for(int i = 0; i < width; i++)
+      {
+        for_four_channels(k)
+        {
+          xc[k] = CLAMPF(temp[row[k] + i], fmin, fmax);
+          yc[k] = (a0 * xc[k]) + (a1 * xp[k]) - (b1 * yp[k]) - (b2 * yb[k]);
+
+          out[row[k] + i] = yc[k];
+
+          xp[k] = xc[k];
+          yb[k] = yp[k];
+          yp[k] = yc[k];
+        }
+      }
+
+      // backward filter
+      for_four_channels(k)
+      {
+        xn[k] = CLAMPF(temp[row[k] + width - 1], fmin, fmax);
+        xa[k] = xn[k];
+        yn[k] = xn[k] * coefn;
+        ya[k] = yn[k];
+      }
+
+      for(int i = width - 1; i > -1; i--)
+      {
+        for_four_channels(k)
+        {
+          xc[k] = CLAMPF(temp[row[k] + i], fmin, fmax);
+
+          yc[k] = (a2 * xn[k]) + (a3 * xa[k]) - (b1 * yn[k]) - (b2 * ya[k]);
+
+          xa[k] = xn[k];
+          xn[k] = xc[k];
+          ya[k] = yn[k];
+          yn[k] = yc[k];
+
+          out[row[k] + i] += yc[k];
+        }
+      }
+    }
+    else
+    {
+      // up to three leftover rows at the bottom
+      for(int l = j; l < height; l++)
+      {
+        const size_t row = (size_t)l * width;
+
+        float xp = CLAMPF(temp[row], fmin, fmax);
+        float yb = xp * coefp;
+        float yp = yb;
+
+        for(int i = 0; i < width; i++)
+        {
+          const float xc = CLAMPF(temp[row + i], fmin, fmax);
+          const float yc = (a0 * xc) + (a1 * xp) - (b1 * yp) - (b2 * yb);
+          out[row + i] = yc;
+          xp = xc;
+          yb = yp;
+          yp = yc;
+        }
+
+        float xn = CLAMPF(temp[row + width - 1], fmin, fmax);
+        float xa = xn;
+        float yn = xn * coefn;
+        float ya = yn;
+
+        for(int i = width - 1; i > -1; i--)
+        {
+          const float xc = CLAMPF(temp[row + i], fmin, fmax);
+          const float yc = (a2 * xn) + (a3 * xa) - (b1 * yn) - (b2 * ya);
+          xa = xn;
+          xn = xc;
+          ya = yn;
+          yn = yc;
+          out[row + i] += yc;
+        }
+      }
+    }
+  }
+}
+
 void dt_gaussian_blur(dt_gaussian_t *g, const float *const in, float *const out)
 {
+  if(g->channels == 1)
+  {
+    _gaussian_blur_1c(g, in, out);
+    return;
+  }
 
   const int width = g->width;
   const int height = g->height;
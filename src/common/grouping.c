@@ -198,11 +198,10 @@ dt_imgid_t dt_grouping_change_representative(const dt_imgid_t image_id)
 GList *dt_grouping_get_group_images(const dt_imgid_t imgid)
 {
   GList *imgs = NULL;
-  const dt_image_t *image = dt_image_cache_get(imgid, 'r');
-  if(image)
+  dt_image_hot_t hot;
+  if(dt_image_cache_get_hot(imgid, &hot))
   {
-    const dt_imgid_t img_group_id = image->group_id;
-    dt_image_cache_read_release(image);
+    const dt_imgid_t img_group_id = hot.group_id;
     if(darktable.gui && darktable.gui->grouping && darktable.gui->expanded_group_id != img_group_id)
     {
       sqlite3_stmt *stmt;
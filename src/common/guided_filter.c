@@ -73,6 +73,23 @@ static inline float *_get_color_pixel(color_image img, size_t i)
   return img.data + i * img.stride;
 }
 
+// mask-iteration workflows (e.g. repeated tone equalizer mask builds while
+// dragging a slider) call the guided filter over and over with different
+// input images but the very same guide.  nine of the thirteen box-filtered
+// moment planes depend only on the guide - the blurred guide means and
+// (co)variances - so we keep the last guide's blurred moment planes in a
+// single-slot cache keyed by a hash of the guide data and the filter
+// geometry.  on a hit only the four input-dependent planes have to be
+// computed and box-filtered.
+typedef struct _gf_moment_cache_t
+{
+  dt_hash_t hash;
+  int width, height;
+  float *moments; // 9 interleaved planes: blurred guide means and variances
+} _gf_moment_cache_t;
+
+static _gf_moment_cache_t _moment_cache = { DT_INVALID_HASH };
+static GMutex _moment_cache_mutex;
 
 // apply guided filter to single-component image img using the 3-components image imgg as a guide
 // the filtering applies a monochrome box filter to a total of 13 image channels:
@@ -80,8 +97,10 @@ static inline float *_get_color_pixel(color_image img, size_t i)
 //    3 color guide image
 //    3 covariance (R, G, B)
 //    6 variance (R-R, R-G, R-B, G-G, G-B, B-B)
-// for computational efficiency, we'll pack them into a four-channel image and a 9-channel image
-// image instead of running 13 separate box filters: guide+input, R/G/B/R-R/R-G/R-B/G-G/G-B/B-B.
+// for computational efficiency, we'll pack them into a four-channel image holding the
+// input-dependent planes (input, covariances) and a 9-channel image holding the
+// guide-dependent planes (guide means, variances) instead of running 13 separate box
+// filters; the guide-dependent planes can be reused from 'moments' when moments_valid.
 // make sure the tiles are always aligned for 16 floats
 static void _guided_filter_tiling(color_image imgg,
                                   gray_image img,
@@ -91,7 +110,9 @@ static void _guided_filter_tiling(color_image imgg,
                                   const float eps,
                                   const float guide_weight,
                                   const float min,
-                                  const float max)
+                                  const float max,
+                                  float *const moments,
+                                  const gboolean moments_valid)
 {
   const int overlap = dt_round_size(3 * w, 16);
   const tile source = { MAX(target.left - overlap, 0),  MIN(target.right + overlap, imgg.width),
@@ -102,29 +123,33 @@ static void _guided_filter_tiling(color_image imgg,
 // since we're packing multiple monochrome planes into a color image, define symbolic constants so that
 // we can keep track of which values we're actually using
 #define INP_MEAN 0
-#define GUIDE_MEAN_R 1
-#define GUIDE_MEAN_G 2
-#define GUIDE_MEAN_B 3
-#define COV_R 0
-#define COV_G 1
-#define COV_B 2
+#define COV_R 1
+#define COV_G 2
+#define COV_B 3
+#define GUIDE_MEAN_R 0
+#define GUIDE_MEAN_G 1
+#define GUIDE_MEAN_B 2
 #define VAR_RR 3
 #define VAR_RG 4
 #define VAR_RB 5
 #define VAR_GG 6
-#define VAR_BB 8
 #define VAR_GB 7
-  color_image mean = _new_color_image(width, height, 4);
-  color_image variance = _new_color_image(width, height, 9);
-  const size_t img_dimen = dt_round_size(mean.width, 16);
+#define VAR_BB 8
+  color_image inp = _new_color_image(width, height, 4);
+  color_image guide_mom = _new_color_image(width, height, 9);
+  const size_t img_dimen = dt_round_size(inp.width, 16);
   size_t img_bak_sz;
   float *img_bak = dt_alloc_perthread_float(9*img_dimen, &img_bak_sz);
-  DT_OMP_FOR(shared(img, imgg, mean, variance, img_bak) dt_omp_sharedconst(source))
+  DT_OMP_FOR(shared(img, imgg, inp, guide_mom, img_bak) dt_omp_sharedconst(source))
   for(int j_imgg = source.lower; j_imgg < source.upper; j_imgg++)
   {
     int j = j_imgg - source.lower;
-    float *const restrict meanpx = mean.data + 4 * j * mean.width;
-    float *const restrict varpx = variance.data + 9 * j * variance.width;
+    float *const restrict inppx = inp.data + 4 * j * inp.width;
+    float *const restrict gmompx = guide_mom.data + 9 * j * guide_mom.width;
+    if(moments_valid)
+      // the guide moments of this source row were blurred on a previous call
+      memcpy(gmompx, moments + 9 * (source.left + (size_t)j_imgg * imgg.width),
+             sizeof(float) * 9 * width);
     for(int i_imgg = source.left; i_imgg < source.right; i_imgg++)
     {
       size_t i = i_imgg - source.left;
@@ -132,60 +157,79 @@ static void _guided_filter_tiling(color_image imgg,
       dt_aligned_pixel_t pixel =
         { pixel_[0] * guide_weight, pixel_[1] * guide_weight, pixel_[2] * guide_weight, pixel_[3] * guide_weight };
       const float input = img.data[i_imgg + (size_t)j_imgg * img.width];
-      meanpx[4*i+INP_MEAN] = input;
-      meanpx[4*i+GUIDE_MEAN_R] = pixel[0];
-      meanpx[4*i+GUIDE_MEAN_G] = pixel[1];
-      meanpx[4*i+GUIDE_MEAN_B] = pixel[2];
-      varpx[9*i+COV_R] = pixel[0] * input;
-      varpx[9*i+COV_G] = pixel[1] * input;
-      varpx[9*i+COV_B] = pixel[2] * input;
-      varpx[9*i+VAR_RR] = pixel[0] * pixel[0];
-      varpx[9*i+VAR_RG] = pixel[0] * pixel[1];
-      varpx[9*i+VAR_RB] = pixel[0] * pixel[2];
-      varpx[9*i+VAR_GG] = pixel[1] * pixel[1];
-      varpx[9*i+VAR_GB] = pixel[1] * pixel[2];
-      varpx[9*i+VAR_BB] = pixel[2] * pixel[2];
+      inppx[4*i+INP_MEAN] = input;
+      inppx[4*i+COV_R] = pixel[0] * input;
+      inppx[4*i+COV_G] = pixel[1] * input;
+      inppx[4*i+COV_B] = pixel[2] * input;
+      if(!moments_valid)
+      {
+        gmompx[9*i+GUIDE_MEAN_R] = pixel[0];
+        gmompx[9*i+GUIDE_MEAN_G] = pixel[1];
+        gmompx[9*i+GUIDE_MEAN_B] = pixel[2];
+        gmompx[9*i+VAR_RR] = pixel[0] * pixel[0];
+        gmompx[9*i+VAR_RG] = pixel[0] * pixel[1];
+        gmompx[9*i+VAR_RB] = pixel[0] * pixel[2];
+        gmompx[9*i+VAR_GG] = pixel[1] * pixel[1];
+        gmompx[9*i+VAR_GB] = pixel[1] * pixel[2];
+        gmompx[9*i+VAR_BB] = pixel[2] * pixel[2];
+      }
     }
     // apply horizontal pass of box mean filter while the cache is still hot
     float *const restrict scratch = dt_get_perthread(img_bak, img_bak_sz);
-    dt_box_mean_horizontal(meanpx, mean.width, 4|BOXFILTER_KAHAN_SUM, w, scratch);
-    dt_box_mean_horizontal(varpx, variance.width, 9|BOXFILTER_KAHAN_SUM, w, scratch);
+    dt_box_mean_horizontal(inppx, inp.width, 4|BOXFILTER_KAHAN_SUM, w, scratch);
+    if(!moments_valid)
+      dt_box_mean_horizontal(gmompx, guide_mom.width, 9|BOXFILTER_KAHAN_SUM, w, scratch);
   }
   dt_free_align(img_bak);
-  dt_box_mean_vertical(mean.data, mean.height, mean.width, 4|BOXFILTER_KAHAN_SUM, w);
-  dt_box_mean_vertical(variance.data, variance.height, variance.width, 9|BOXFILTER_KAHAN_SUM, w);
-  // we will recycle memory of 'mean' for the new coefficient arrays a_? and b to reduce memory foot print
-  color_image a_b = mean;
+  dt_box_mean_vertical(inp.data, inp.height, inp.width, 4|BOXFILTER_KAHAN_SUM, w);
+  if(!moments_valid)
+  {
+    dt_box_mean_vertical(guide_mom.data, guide_mom.height, guide_mom.width, 9|BOXFILTER_KAHAN_SUM, w);
+    if(moments)
+    {
+      // store the freshly blurred guide moments for the next call.  only the
+      // target region is written; within it the tiled box means equal the
+      // whole-image ones (the tile overlap exceeds the filter window), so
+      // the plane assembled over all tiles is globally consistent.
+      DT_OMP_FOR()
+      for(int j_imgg = target.lower; j_imgg < target.upper; j_imgg++)
+        memcpy(moments + 9 * (target.left + (size_t)j_imgg * imgg.width),
+               guide_mom.data + 9 * ((target.left - source.left) + (size_t)(j_imgg - source.lower) * width),
+               sizeof(float) * 9 * (target.right - target.left));
+    }
+  }
+  // we will recycle memory of 'inp' for the new coefficient arrays a_? and b to reduce memory foot print
+  color_image a_b = inp;
   #define A_RED 0
   #define A_GREEN 1
   #define A_BLUE 2
   #define B 3
-  DT_OMP_FOR(shared(mean, variance, a_b))
+  DT_OMP_FOR(shared(inp, guide_mom, a_b))
   for(size_t i = 0; i < size; i++)
   {
-    const float *meanpx = _get_color_pixel(mean, i);
-    const float inp_mean = meanpx[INP_MEAN];
-    const float guide_r = meanpx[GUIDE_MEAN_R];
-    const float guide_g = meanpx[GUIDE_MEAN_G];
-    const float guide_b = meanpx[GUIDE_MEAN_B];
-    float *const varpx = _get_color_pixel(variance, i);
+    const float *inppx = _get_color_pixel(inp, i);
+    const float inp_mean = inppx[INP_MEAN];
+    const float *gmompx = _get_color_pixel(guide_mom, i);
+    const float guide_r = gmompx[GUIDE_MEAN_R];
+    const float guide_g = gmompx[GUIDE_MEAN_G];
+    const float guide_b = gmompx[GUIDE_MEAN_B];
     // solve linear system of equations of size 3x3 via Cramer's rule
     // symmetric coefficient matrix
-    const float Sigma_0_0 = varpx[VAR_RR] - (guide_r * guide_r) + eps;
-    const float Sigma_0_1 = varpx[VAR_RG] - (guide_r * guide_g);
-    const float Sigma_0_2 = varpx[VAR_RB] - (guide_r * guide_b);
-    const float Sigma_1_1 = varpx[VAR_GG] - (guide_g * guide_g) + eps;;
-    const float Sigma_1_2 = varpx[VAR_GB] - (guide_g * guide_b);
-    const float Sigma_2_2 = varpx[VAR_BB] - (guide_b * guide_b) + eps;
+    const float Sigma_0_0 = gmompx[VAR_RR] - (guide_r * guide_r) + eps;
+    const float Sigma_0_1 = gmompx[VAR_RG] - (guide_r * guide_g);
+    const float Sigma_0_2 = gmompx[VAR_RB] - (guide_r * guide_b);
+    const float Sigma_1_1 = gmompx[VAR_GG] - (guide_g * guide_g) + eps;;
+    const float Sigma_1_2 = gmompx[VAR_GB] - (guide_g * guide_b);
+    const float Sigma_2_2 = gmompx[VAR_BB] - (guide_b * guide_b) + eps;
     const float det0 = Sigma_0_0 * (Sigma_1_1 * Sigma_2_2 - Sigma_1_2 * Sigma_1_2)
       - Sigma_0_1 * (Sigma_0_1 * Sigma_2_2 - Sigma_0_2 * Sigma_1_2)
       + Sigma_0_2 * (Sigma_0_1 * Sigma_1_2 - Sigma_0_2 * Sigma_1_1);
     float a_r_, a_g_, a_b_, b_;
     if(fabsf(det0) > 4.f * FLT_EPSILON)
     {
-      const float cov_r = varpx[COV_R] - guide_r * inp_mean;
-      const float cov_g = varpx[COV_G] - guide_g * inp_mean;
-      const float cov_b = varpx[COV_B] - guide_b * inp_mean;
+      const float cov_r = inppx[COV_R] - guide_r * inp_mean;
+      const float cov_g = inppx[COV_G] - guide_g * inp_mean;
+      const float cov_b = inppx[COV_B] - guide_b * inp_mean;
       const float det1 = cov_r * (Sigma_1_1 * Sigma_2_2 - Sigma_1_2 * Sigma_1_2)
         - Sigma_0_1 * (cov_g * Sigma_2_2 - cov_b * Sigma_1_2)
         + Sigma_0_2 * (cov_g * Sigma_1_2 - cov_b * Sigma_1_1);
@@ -206,15 +250,15 @@ static void _guided_filter_tiling(color_image imgg,
       a_r_ = 0.f;
       a_g_ = 0.f;
       a_b_ = 0.f;
-      b_ = _get_color_pixel(mean, i)[INP_MEAN];
+      b_ = inp_mean;
     }
-    // now data of imgg_mean_? is no longer needed, we can safely overwrite aliasing arrays
+    // now data of inp is no longer needed, we can safely overwrite the aliasing array
     a_b.data[4*i+A_RED] = a_r_;
     a_b.data[4*i+A_GREEN] = a_g_;
     a_b.data[4*i+A_BLUE] = a_b_;
     a_b.data[4*i+B] = b_;
   }
-  _free_color_image(&variance);
+  _free_color_image(&guide_mom);
 
   dt_box_mean(a_b.data, a_b.height, a_b.width, a_b.stride|BOXFILTER_KAHAN_SUM, w, 1);
 
@@ -236,7 +280,7 @@ static void _guided_filter_tiling(color_image imgg,
       img_out.data[i_imgg + (size_t)j_imgg * imgg.width] = CLAMP(res, min, max);
     }
   }
-  _free_color_image(&mean);
+  _free_color_image(&inp);
 }
 
 void guided_filter(const float *const guide,
@@ -260,15 +304,60 @@ void guided_filter(const float *const guide,
   const int tile_dim = MAX(dt_round_size(3 * w, 16), GF_TILE_SIZE);
   const float eps = sqrt_eps * sqrt_eps; // this is the regularization parameter of the original papers
 
+  // probe the guide moment cache.  we keep the single slot at interactive
+  // buffer sizes so export-sized runs don't pin hundreds of megabytes, and
+  // a failed trylock (another pipe is in here concurrently) simply runs
+  // the uncached path.
+  const size_t npixels = (size_t)width * height;
+  const gboolean cacheable = 9 * sizeof(float) * npixels <= (64ul << 20);
+  float *moments = NULL;
+  gboolean moments_valid = FALSE;
+  gboolean locked = FALSE;
+  if(cacheable && g_mutex_trylock(&_moment_cache_mutex))
+  {
+    locked = TRUE;
+    // the moments depend on the guide data, its scaling and the window size
+    dt_hash_t hash = dt_hash(DT_INITHASH, guide, sizeof(float) * npixels * ch);
+    hash = dt_hash(hash, &w, sizeof(w));
+    hash = dt_hash(hash, &guide_weight, sizeof(guide_weight));
+    if(_moment_cache.moments
+       && _moment_cache.hash == hash
+       && _moment_cache.width == width
+       && _moment_cache.height == height)
+      moments_valid = TRUE;
+    else
+    {
+      if(!_moment_cache.moments
+         || _moment_cache.width != width
+         || _moment_cache.height != height)
+      {
+        dt_free_align(_moment_cache.moments);
+        _moment_cache.moments = dt_alloc_align_float(9 * npixels);
+      }
+      _moment_cache.hash = _moment_cache.moments ? hash : DT_INVALID_HASH;
+      _moment_cache.width = width;
+      _moment_cache.height = height;
+    }
+    moments = _moment_cache.moments;
+    if(!moments)
+    {
+      g_mutex_unlock(&_moment_cache_mutex);
+      locked = FALSE;
+    }
+  }
+
   for(int j = 0; j < height; j += tile_dim)
   {
     for(int i = 0; i < width; i += tile_dim)
     {
       tile target = { i, MIN(i + tile_dim, width),
                       j, MIN(j + tile_dim, height) };
-      _guided_filter_tiling(img_guide, img_in, img_out, target, w, eps, guide_weight, min, max);
+      _guided_filter_tiling(img_guide, img_in, img_out, target, w, eps, guide_weight, min, max,
+                            moments, moments_valid);
     }
   }
+
+  if(locked) g_mutex_unlock(&_moment_cache_mutex);
 }
 
 #ifdef HAVE_OPENCL
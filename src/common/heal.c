@@ -16,6 +16,7 @@
     along with darktable.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "common/fast_guided_filter.h"
 #include "control/control.h"
 #include "develop/imageop.h"
 #include "develop/openmp_maths.h"
@@ -44,9 +45,17 @@
  * Jean-Yves Couleaud cjyves@free.fr
  */
 
+/* The multi-grid evaluation suggested above is implemented in _heal_solve(): the
+ * difference image is solved recursively on half-resolution grids and the coarse
+ * solution seeds the iteration on the next finer grid.  The low frequencies of the
+ * solution, which would need a number of Gauss-Seidel sweeps growing with the patch
+ * area to propagate from the boundary, converge within a few sweeps on the coarse
+ * grids, so large heal shapes no longer exhaust max_iter before converging.
+ */
+
 
 // Subtract bottom from top and store in result as a float; separate 'red' and 'black' pixels into
-// two contiguous regions
+// two contiguous regions.  bottom_buffer may be NULL, in which case top_buffer is merely split.
 static void _heal_sub(const float *const top_buffer, const float *const bottom_buffer,
                       float *const restrict red_buffer, float *const restrict black_buffer,
                       const size_t width, const size_t height)
@@ -67,8 +76,8 @@ static void _heal_sub(const float *const top_buffer, const float *const bottom_b
       const size_t idx = 4 * (row * width + 2*col);
       for_each_channel(c)
       {
-        buf1[4*col + c] = top_buffer[idx + c] - bottom_buffer[idx + c];
-        buf2[4*col + c] = top_buffer[idx+4 + c] - bottom_buffer[idx+4 + c];
+        buf1[4*col + c] = top_buffer[idx + c] - (bottom_buffer ? bottom_buffer[idx + c] : 0.0f);
+        buf2[4*col + c] = top_buffer[idx+4 + c] - (bottom_buffer ? bottom_buffer[idx+4 + c] : 0.0f);
       }
     }
     if(width & 1)
@@ -79,7 +88,7 @@ static void _heal_sub(const float *const top_buffer, const float *const bottom_b
       const size_t idx = 4 * (row * width + (width-1));
       for_each_channel(c)
       {
-        buf1[4*res_idx + c] = top_buffer[idx + c] - bottom_buffer[idx + c];
+        buf1[4*res_idx + c] = top_buffer[idx + c] - (bottom_buffer ? bottom_buffer[idx + c] : 0.0f);
         buf2[4*res_idx + c] = 0.0f;
       }
     }
@@ -91,7 +100,8 @@ static void _heal_sub(const float *const top_buffer, const float *const bottom_b
   memset(black_buffer + (height+1)*res_stride, 0, res_stride * sizeof(float));
 }
 
-// Add first to second and store in result, re-interleaving the 'red' and 'black' pixels
+// Add first to second and store in result, re-interleaving the 'red' and 'black' pixels.
+// second_buffer may be NULL, in which case the split pixels are merely re-interleaved.
 static void _heal_add(const float *const restrict red_buffer, const float *const black_buffer,
                       const float *const restrict second_buffer, float *const restrict result_buffer,
                       const size_t width, const size_t height)
@@ -113,8 +123,8 @@ static void _heal_add(const float *const restrict red_buffer, const float *const
       const size_t idx = 4 * (row * width + 2*col);
       for_each_channel(c)
       {
-        result_buffer[idx + c] = buf1[4*col + c] + second_buffer[idx + c];
-        result_buffer[idx + 4 + c] = buf2[4*col + c] + second_buffer[idx + 4 + c];
+        result_buffer[idx + c] = buf1[4*col + c] + (second_buffer ? second_buffer[idx + c] : 0.0f);
+        result_buffer[idx + 4 + c] = buf2[4*col + c] + (second_buffer ? second_buffer[idx + 4 + c] : 0.0f);
       }
     }
     if(width & 1)
@@ -123,7 +133,7 @@ static void _heal_add(const float *const restrict red_buffer, const float *const
       const size_t res_idx = (width-1)/2;
       const size_t idx = 4 * (row * width + (width-1));
       for_each_channel(c)
-        result_buffer[idx + c] = buf1[4*res_idx + c] + second_buffer[idx + c];
+        result_buffer[idx + c] = buf1[4*res_idx + c] + (second_buffer ? second_buffer[idx + c] : 0.0f);
     }
   }
 }
@@ -345,6 +355,87 @@ cleanup:
   if(black_runs) dt_free_align(black_runs);
 }
 
+// stop coarsening once either dimension of the next coarser grid would fall below this; a patch this
+// small converges in a handful of Gauss-Seidel sweeps anyway
+#define HEAL_MIN_COARSE 32
+
+// Build the half-resolution version of the difference image and the opacity mask by averaging 2x2
+// blocks of pixels.  The mask takes the *minimum* of the four values so that a coarse pixel is only
+// treated as an unknown when all of its children lie inside the heal mask; everything else keeps its
+// averaged value and acts as the Dirichlet boundary for the coarse solve.
+static void _heal_restrict(const float *const restrict diff, const float *const restrict mask,
+                           float *const restrict coarse_diff, float *const restrict coarse_mask,
+                           const size_t c_width, const size_t c_height,
+                           const size_t width, const size_t height)
+{
+  DT_OMP_FOR()
+  for(size_t row = 0; row < c_height; row++)
+  {
+    const size_t row0 = 2 * row;
+    const size_t row1 = MIN(2 * row + 1, height - 1);
+    for(size_t col = 0; col < c_width; col++)
+    {
+      const size_t col0 = 2 * col;
+      const size_t col1 = MIN(2 * col + 1, width - 1);
+      const size_t i00 = row0 * width + col0;
+      const size_t i01 = row0 * width + col1;
+      const size_t i10 = row1 * width + col0;
+      const size_t i11 = row1 * width + col1;
+      for_each_channel(c)
+        coarse_diff[4 * (row * c_width + col) + c]
+            = 0.25f * (diff[4*i00 + c] + diff[4*i01 + c] + diff[4*i10 + c] + diff[4*i11 + c]);
+      coarse_mask[row * c_width + col] = MIN(MIN(mask[i00], mask[i01]), MIN(mask[i10], mask[i11]));
+    }
+  }
+}
+
+// Solve the Laplace system on an interleaved difference image.  The system is first solved on a
+// half-resolution grid (recursively, so on a whole pyramid of grids) and the coarse solution is
+// interpolated back up to seed the Gauss-Seidel iteration at the current resolution.  The low
+// frequencies of the solution, which plain relaxation propagates from the boundary only one pixel
+// per sweep, are thus already in place and the fine sweeps merely polish the high frequencies.
+static void _heal_solve(float *const restrict diff, const float *const restrict mask,
+                        const size_t width, const size_t height, const int max_iter)
+{
+  if(width >= 2 * HEAL_MIN_COARSE && height >= 2 * HEAL_MIN_COARSE)
+  {
+    const size_t c_width = width / 2;
+    const size_t c_height = height / 2;
+    float *const restrict coarse_diff = dt_alloc_align_float((size_t)4 * c_width * c_height);
+    float *const restrict coarse_mask = dt_alloc_align_float(c_width * c_height);
+    float *const restrict guess = dt_alloc_align_float((size_t)4 * width * height);
+    if(coarse_diff && coarse_mask && guess)
+    {
+      _heal_restrict(diff, mask, coarse_diff, coarse_mask, c_width, c_height, width, height);
+      _heal_solve(coarse_diff, coarse_mask, c_width, c_height, max_iter);
+      interpolate_bilinear(coarse_diff, c_width, c_height, guess, width, height, 4);
+      // seed only the unknowns; pixels outside the mask carry the Dirichlet boundary values
+      DT_OMP_FOR()
+      for(size_t i = 0; i < width * height; i++)
+        if(mask[i] != 0.0f)
+          copy_pixel(diff + 4*i, guess + 4*i);
+    }
+    // if any of the allocations failed we simply relax from the unseeded difference image
+    if(coarse_diff) dt_free_align(coarse_diff);
+    if(coarse_mask) dt_free_align(coarse_mask);
+    if(guess) dt_free_align(guess);
+  }
+
+  const size_t subwidth = 4 * ((width+1)/2);  // round up to be able to handle odd widths
+  float *const restrict red_buffer = dt_alloc_align_float(subwidth * (height + 2));
+  float *const restrict black_buffer = dt_alloc_align_float(subwidth * (height + 2));
+  if(red_buffer && black_buffer)
+  {
+    _heal_sub(diff, NULL, red_buffer, black_buffer, width, height);
+    _heal_laplace_loop(red_buffer, black_buffer, width, height, mask, max_iter);
+    _heal_add(red_buffer, black_buffer, NULL, diff, width, height);
+  }
+  else
+    dt_print(DT_DEBUG_ALWAYS, "_heal_solve: error allocating memory for healing");
+  if(red_buffer) dt_free_align(red_buffer);
+  if(black_buffer) dt_free_align(black_buffer);
+}
+
 
 /* Original Algorithm Design:
  *
@@ -359,26 +450,30 @@ void dt_heal(const float *const src_buffer, float *dest_buffer, const float *con
     dt_print(DT_DEBUG_ALWAYS, "dt_heal: full-color image required");
     return;
   }
-  const size_t subwidth = 4 * ((width+1)/2);  // round up to be able to handle odd widths
-  float *const restrict red_buffer = dt_alloc_align_float(subwidth * (height + 2));
-  float *const restrict black_buffer = dt_alloc_align_float(subwidth * (height + 2));
-  if(red_buffer == NULL || black_buffer == NULL)
+  const size_t npixels = (size_t)width * height;
+  float *const restrict diff = dt_alloc_align_float(4 * npixels);
+  if(diff == NULL)
   {
     dt_print(DT_DEBUG_ALWAYS, "dt_heal: error allocating memory for healing");
-    goto cleanup;
+    return;
   }
 
-  /* subtract pattern from image and store the result split by 'red' and 'black' positions  */
-  _heal_sub(dest_buffer, src_buffer, red_buffer, black_buffer, width, height);
+  /* subtract pattern from image */
+  DT_OMP_FOR()
+  for(size_t i = 0; i < npixels; i++)
+    for_each_channel(c)
+      diff[4*i + c] = dest_buffer[4*i + c] - src_buffer[4*i + c];
 
-  _heal_laplace_loop(red_buffer, black_buffer, width, height, mask_buffer, max_iter);
+  /* solve the Laplace equation on the difference, coarse grids first */
+  _heal_solve(diff, mask_buffer, width, height, max_iter);
 
   /* add solution to original image and store in dest */
-  _heal_add(red_buffer, black_buffer, src_buffer, dest_buffer, width, height);
+  DT_OMP_FOR()
+  for(size_t i = 0; i < npixels; i++)
+    for_each_channel(c)
+      dest_buffer[4*i + c] = src_buffer[4*i + c] + diff[4*i + c];
 
-cleanup:
-  if(red_buffer) dt_free_align(red_buffer);
-  if(black_buffer) dt_free_align(black_buffer);
+  dt_free_align(diff);
 }
 
 #ifdef HAVE_OPENCL
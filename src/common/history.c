@@ -1501,36 +1501,11 @@ GList *dt_history_duplicate(GList *hist)
 
     memcpy(new, old, sizeof(dt_dev_history_item_t));
 
-    int32_t params_size = 0;
-    if(old->module)
-    {
-      params_size = old->module->params_size;
-    }
-    else
-    {
-      dt_iop_module_t *base = dt_iop_get_module(old->op_name);
-      if(base)
-      {
-        params_size = base->params_size;
-      }
-      else
-      {
-        // nothing else to do
-        dt_print(DT_DEBUG_ALWAYS, "[_duplicate_history]"
-                 " can't find base module for %s\n", old->op_name);
-      }
-    }
-
-    if(params_size > 0)
-    {
-      new->params = malloc(params_size);
-      if(new->params)
-        memcpy(new->params, old->params, params_size);
-    }
-
-    new->blend_params = malloc(sizeof(dt_develop_blend_params_t));
-    if(new->blend_params)
-      memcpy(new->blend_params, old->blend_params, sizeof(dt_develop_blend_params_t));
+    // params and blend_params are copy-on-write blobs, so the
+    // duplicate just takes a reference instead of deep copying them.
+    // whoever modifies a shared blob in place unshares it first.
+    new->params = dt_dev_history_blob_ref(old->params);
+    new->blend_params = dt_dev_history_blob_ref(old->blend_params);
 
     if(old->forms)
       new->forms = dt_masks_dup_forms_deep(old->forms, NULL);
@@ -42,6 +42,8 @@
 #include "imageio/imageio_libraw.h"
 #include "win/filepath.h"
 #ifdef USE_LUA
+#include "lua/call.h"
+#include "lua/events.h"
 #include "lua/image.h"
 #endif
 #include <assert.h>
@@ -2053,6 +2055,41 @@ static dt_imgid_t _image_import_internal(const dt_filmid_t film_id,
   dt_tag_new(tagname, &tagid);
   dt_tag_attach(tagid, id, FALSE, FALSE);
 
+  // index the file contents: a 64-bit hash stored with the image makes
+  // duplicates of the same raw discoverable across film rolls and
+  // cards with one indexed lookup instead of re-reading the data. the
+  // exif parse above has just pulled the file into the page cache, so
+  // this is a cheap in-memory pass.
+  GMappedFile *contents = g_mapped_file_new(normalized_filename, FALSE, NULL);
+  if(contents)
+  {
+    const dt_hash_t content_hash = dt_hash(DT_INITHASH,
+                                           g_mapped_file_get_contents(contents),
+                                           g_mapped_file_get_length(contents));
+    g_mapped_file_unref(contents);
+
+    DT_DEBUG_SQLITE3_PREPARE_V2
+      (dt_database_get(darktable.db),
+       "SELECT id FROM main.images WHERE content_hash = ?1 AND id != ?2",
+       -1, &stmt, NULL);
+    DT_DEBUG_SQLITE3_BIND_INT64(stmt, 1, (sqlite3_int64)content_hash);
+    DT_DEBUG_SQLITE3_BIND_INT(stmt, 2, id);
+    if(sqlite3_step(stmt) == SQLITE_ROW)
+      dt_print(DT_DEBUG_ALWAYS,
+               "[image_import] `%s' has the same content as ID=%d",
+               normalized_filename, sqlite3_column_int(stmt, 0));
+    sqlite3_finalize(stmt);
+
+    DT_DEBUG_SQLITE3_PREPARE_V2
+      (dt_database_get(darktable.db),
+       "UPDATE main.images SET content_hash = ?1 WHERE id = ?2",
+       -1, &stmt, NULL);
+    DT_DEBUG_SQLITE3_BIND_INT64(stmt, 1, (sqlite3_int64)content_hash);
+    DT_DEBUG_SQLITE3_BIND_INT(stmt, 2, id);
+    sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+  }
+
   // make sure that there are no stale thumbnails left
   dt_mipmap_cache_remove(id);
 
@@ -2065,17 +2102,26 @@ static dt_imgid_t _image_import_internal(const dt_filmid_t film_id,
   g_free(normalized_filename);
 
 #ifdef USE_LUA
-  //Synchronous calling of lua post-import-image events
   if(lua_locking)
-    dt_lua_lock();
-
-  lua_State *L = darktable.lua_state.state;
-
-  luaA_push(L, dt_lua_image_t, &id);
-  dt_lua_event_trigger(L, "post-import-image", 1);
+  {
+    // called from outside lua (import jobs): queue the event for the lua
+    // thread instead of running the handlers here, so a slow user script
+    // can't add latency to every imported image
+    dt_lua_async_call_alien(dt_lua_event_trigger_wrapper,
+        0, NULL, NULL,
+        LUA_ASYNC_TYPENAME, "const char*", "post-import-image",
+        LUA_ASYNC_TYPENAME, "dt_lua_image_t", GINT_TO_POINTER(id),
+        LUA_ASYNC_DONE);
+  }
+  else
+  {
+    // called from lua itself with the lock already held: keep the
+    // synchronous semantics scripts may rely on
+    lua_State *L = darktable.lua_state.state;
 
-  if(lua_locking)
-    dt_lua_unlock();
+    luaA_push(L, dt_lua_image_t, &id);
+    dt_lua_event_trigger(L, "post-import-image", 1);
+  }
 #endif
 
   if(raise_signals)
@@ -2223,7 +2269,8 @@ void dt_image_init(dt_image_t *img)
   img->wb_coeffs[3] = NAN;
   img->usercrop[0] = img->usercrop[1] = 0;
   img->usercrop[2] = img->usercrop[3] = 1;
-  img->dng_gain_maps = NULL;
+  img->dng_opcode_list2 = NULL;
+  img->dng_opcode_list2_size = 0;
   img->exif_correction_type = CORRECTION_TYPE_NONE;
   memset(&img->exif_correction_data, 0, sizeof(img->exif_correction_data));
   img->cache_entry = 0;
@@ -345,13 +345,19 @@ typedef struct dt_image_t
   /* DefaultUserCrop */
   dt_boundingbox_t usercrop;
 
-  /* GainMaps from DNG OpcodeList2 exif tag */
-  GList *dng_gain_maps;
+  /* raw OpcodeList2 exif tag from a DNG; the contained GainMaps are
+   * only parsed from it when the pipe wants to apply them */
+  uint8_t *dng_opcode_list2;
+  uint32_t dng_opcode_list2_size;
 
   /* convenience pointer back into the image cache, so we can return
    * dt_image_t* there directly. */
   struct dt_cache_entry_t *cache_entry;
 
+  /* hash of the row-backed fields as of the last database sync, used
+   * by the image cache to skip redundant UPDATEs on write release */
+  dt_hash_t db_hash;
+
   dt_image_job_flag_t job_flags;
 
   /* result of attempting to load the image, needed to be able to report why the image can't be displayed */
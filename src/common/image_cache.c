@@ -28,6 +28,80 @@
 #include <sqlite3.h>
 #include <inttypes.h>
 
+/* mirror the hot attributes of an image into the compact side table.
+   the mirror outlives eviction of the full dt_image_t entry, so
+   whole-collection scans of these scalars stay cheap. */
+static void _image_cache_update_hot(dt_image_cache_t *cache,
+                                    const dt_image_t *img)
+{
+  if(!cache->hot || !dt_is_valid_imgid(img->id)) return;
+
+  dt_pthread_mutex_lock(&cache->hot_lock);
+  dt_image_hot_t *hot = g_hash_table_lookup(cache->hot, GINT_TO_POINTER(img->id));
+  if(!hot)
+  {
+    hot = g_malloc(sizeof(dt_image_hot_t));
+    g_hash_table_insert(cache->hot, GINT_TO_POINTER(img->id), hot);
+  }
+  hot->group_id = img->group_id;
+  hot->film_id = img->film_id;
+  hot->flags = img->flags;
+  hot->datetime_taken = img->exif_datetime_taken;
+  dt_pthread_mutex_unlock(&cache->hot_lock);
+}
+
+/* hash of everything dt_image_cache_write_release() pushes to the
+   images table. most write releases inside bulk operations don't
+   actually touch any of these fields (the changed data lives in other
+   tables), so comparing against the hash taken at the last sync lets
+   us skip the UPDATE and its companion lookup-table queries. */
+static dt_hash_t _image_db_state_hash(const dt_image_t *img)
+{
+  dt_hash_t h = DT_INITHASH;
+#define HASH_FIELD(f) h = dt_hash(h, &img->f, sizeof(img->f))
+#define HASH_STRING(f) h = dt_hash(h, img->f, strlen(img->f) + 1)
+  HASH_FIELD(width);
+  HASH_FIELD(height);
+  HASH_STRING(filename);
+  HASH_STRING(exif_maker);
+  HASH_STRING(exif_model);
+  HASH_STRING(exif_lens);
+  HASH_FIELD(exif_exposure);
+  HASH_FIELD(exif_aperture);
+  HASH_FIELD(exif_iso);
+  HASH_FIELD(exif_focal_length);
+  HASH_FIELD(exif_focus_distance);
+  HASH_FIELD(film_id);
+  HASH_FIELD(exif_datetime_taken);
+  HASH_FIELD(flags);
+  HASH_FIELD(exif_crop);
+  HASH_FIELD(orientation);
+  HASH_FIELD(legacy_flip);
+  HASH_FIELD(group_id);
+  HASH_FIELD(geoloc);
+  HASH_FIELD(d65_color_matrix);
+  HASH_FIELD(colorspace);
+  HASH_FIELD(raw_black_level);
+  HASH_FIELD(raw_white_point);
+  HASH_FIELD(aspect_ratio);
+  HASH_FIELD(exif_exposure_bias);
+  HASH_FIELD(import_timestamp);
+  HASH_FIELD(change_timestamp);
+  HASH_FIELD(export_timestamp);
+  HASH_FIELD(print_timestamp);
+  HASH_FIELD(final_width);
+  HASH_FIELD(final_height);
+  HASH_STRING(exif_whitebalance);
+  HASH_STRING(exif_flash);
+  HASH_STRING(exif_exposure_program);
+  HASH_STRING(exif_metering_mode);
+  HASH_FIELD(exif_flash_tagvalue);
+  HASH_FIELD(color_harmony_guide);
+#undef HASH_STRING
+#undef HASH_FIELD
+  return h;
+}
+
 static void _image_cache_allocate(void *data,
                                   dt_cache_entry_t *entry)
 {
@@ -37,10 +111,11 @@ static void _image_cache_allocate(void *data,
   dt_image_init(img);
   entry->data = img;
   // load stuff from db and store in cache:
-  sqlite3_stmt *stmt;
+  // this query runs once per image entering the cache, go through the
+  // prepared-statement cache instead of re-preparing it every time
   // clang-format off
-  DT_DEBUG_SQLITE3_PREPARE_V2(
-      dt_database_get(darktable.db),
+  sqlite3_stmt *stmt = dt_database_get_statement(
+      darktable.db,
       "SELECT mi.id, group_id, film_id, width, height, filename,"
       "       mk.name, md.name, ln.name,"
       "       exposure, aperture, iso, focal_length, datetime_taken, flags,"
@@ -59,8 +134,7 @@ static void _image_cache_allocate(void *data,
       "       LEFT JOIN main.flash AS fl ON fl.id = mi.flash_id"
       "       LEFT JOIN main.exposure_program AS ep ON ep.id = mi.exposure_program_id"
       "       LEFT JOIN main.metering_mode AS mm ON mm.id = mi.metering_mode_id"
-      "  WHERE mi.id = ?1",
-      -1, &stmt, NULL);
+      "  WHERE mi.id = ?1");
   // clang-format on
   DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, entry->key);
 
@@ -187,6 +261,9 @@ static void _image_cache_allocate(void *data,
       img->buf_dsc.datatype = TYPE_UINT16;
       img->buf_dsc.cst = IOP_CS_RAW;
     }
+
+    _image_cache_update_hot(data, img);
+    img->db_hash = _image_db_state_hash(img);
   }
   else
   {
@@ -195,7 +272,7 @@ static void _image_cache_allocate(void *data,
              "[image_cache_allocate] failed to open image %" PRIu32 " from database: %s",
              entry->key, sqlite3_errmsg(dt_database_get(darktable.db)));
   }
-  sqlite3_finalize(stmt);
+  dt_database_release_statement(darktable.db, stmt);
   img->cache_entry = entry; // init backref
   // could downgrade lock write->read on entry->lock if we were using
   // concurrencykit..
@@ -205,7 +282,7 @@ static void _image_cache_deallocate(void *data, dt_cache_entry_t *entry)
 {
   dt_image_t *img = entry->data;
   g_free(img->profile);
-  g_list_free_full(img->dng_gain_maps, g_free);
+  g_free(img->dng_opcode_list2);
   g_free(img);
   entry->data = NULL;
 }
@@ -225,6 +302,9 @@ void dt_image_cache_init()
   dt_cache_set_allocate_callback(&cache->cache, &_image_cache_allocate, cache);
   dt_cache_set_cleanup_callback(&cache->cache, &_image_cache_deallocate, cache);
 
+  cache->hot = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+  dt_pthread_mutex_init(&cache->hot_lock, NULL);
+
   dt_print(DT_DEBUG_CACHE, "[image_cache] has %d entries", num);
 }
 
@@ -238,6 +318,9 @@ void dt_image_cache_cleanup()
            cache->cache.cost_quota / (1024.0 * 1024.0),
            (float)cache->cache.cost / (float)cache->cache.cost_quota);
   dt_cache_cleanup(&cache->cache);
+  g_hash_table_destroy(cache->hot);
+  cache->hot = NULL;
+  dt_pthread_mutex_destroy(&cache->hot_lock);
   free(cache);
   darktable.image_cache = NULL;
 }
@@ -331,10 +414,23 @@ void dt_image_cache_write_release_info(dt_image_t *img,
 
   img->aspect_ratio = dt_usable_aspect(img->aspect_ratio);
 
-  sqlite3_stmt *stmt;
+  /* if the fields backing the images table row are unchanged since the
+     last sync - the common case inside bulk operations, where the
+     modified data lives in other tables - skip the UPDATE and its
+     companion lookup-table queries.  sidecar synching below still runs
+     as the xmp also covers data from those other tables. */
+  const dt_hash_t db_hash = _image_db_state_hash(img);
+  if(db_hash == img->db_hash)
+  {
+    if(mode == DT_IMAGE_CACHE_SAFE)
+      dt_image_synch_xmp(img->id);
+    dt_cache_release(&cache->cache, img->cache_entry);
+    return;
+  }
+
   // clang-format off
-  DT_DEBUG_SQLITE3_PREPARE_V2
-    (dt_database_get(darktable.db),
+  sqlite3_stmt *stmt = dt_database_get_statement
+    (darktable.db,
      "UPDATE main.images"
      " SET width = ?1, height = ?2, filename = ?3,"
      "     maker_id = ?4, model_id = ?5, lens_id = ?6, camera_id = ?35,"
@@ -348,8 +444,7 @@ void dt_image_cache_write_release_info(dt_image_t *img,
      "     print_timestamp = ?31, output_width = ?32, output_height = ?33,"
      "     whitebalance_id = ?36, flash_id = ?37,"
      "     exposure_program_id = ?38, metering_mode_id = ?39, flash_tagvalue = ?41"
-     " WHERE id = ?40",
-     -1, &stmt, NULL);
+     " WHERE id = ?40");
 
   const int32_t maker_id = dt_image_get_camera_maker_id(img->exif_maker);
   const int32_t model_id = dt_image_get_camera_model_id(img->exif_model);
@@ -423,7 +518,11 @@ void dt_image_cache_write_release_info(dt_image_t *img,
              rc,
              sqlite3_errmsg(dt_database_get(darktable.db)),
              img->id);
-  sqlite3_finalize(stmt);
+  dt_database_release_statement(darktable.db, stmt);
+
+  if(rc == SQLITE_DONE) img->db_hash = db_hash;
+
+  _image_cache_update_hot(cache, img);
 
   if(mode == DT_IMAGE_CACHE_SAFE)
     dt_image_synch_xmp(img->id);
@@ -448,7 +547,38 @@ void dt_image_cache_write_release(dt_image_t *img, const dt_image_cache_write_mo
 void dt_image_cache_remove(const dt_imgid_t imgid)
 {
   dt_image_cache_t *cache = darktable.image_cache;
-  if(cache) dt_cache_remove(&cache->cache, imgid);
+  if(!cache) return;
+  dt_cache_remove(&cache->cache, imgid);
+  if(cache->hot)
+  {
+    dt_pthread_mutex_lock(&cache->hot_lock);
+    g_hash_table_remove(cache->hot, GINT_TO_POINTER(imgid));
+    dt_pthread_mutex_unlock(&cache->hot_lock);
+  }
+}
+
+gboolean dt_image_cache_get_hot(const dt_imgid_t imgid, dt_image_hot_t *hot)
+{
+  dt_image_cache_t *cache = darktable.image_cache;
+  if(!cache || !cache->hot || !dt_is_valid_imgid(imgid)) return FALSE;
+
+  dt_pthread_mutex_lock(&cache->hot_lock);
+  const dt_image_hot_t *mirrored =
+    g_hash_table_lookup(cache->hot, GINT_TO_POINTER(imgid));
+  if(mirrored) *hot = *mirrored;
+  dt_pthread_mutex_unlock(&cache->hot_lock);
+  if(mirrored) return TRUE;
+
+  // not mirrored yet, load the full entry once; allocate fills the mirror
+  const dt_image_t *img = dt_image_cache_get(imgid, 'r');
+  if(!img) return FALSE;
+  const gboolean valid = dt_is_valid_imgid(img->id);
+  hot->group_id = img->group_id;
+  hot->film_id = img->film_id;
+  hot->flags = img->flags;
+  hot->datetime_taken = img->exif_datetime_taken;
+  dt_image_cache_read_release(img);
+  return valid;
 }
 
 /* set timestamps */
@@ -23,9 +23,24 @@
 
 G_BEGIN_DECLS
 
+/* compact mirror of the hot image attributes.  the cache keeps these
+   few scalars for every image it has ever loaded, surviving eviction
+   of the fat dt_image_t entry, so grouping, selection and act-on
+   logic can read them without pinning - and possibly re-loading from
+   the database - a full cache entry. */
+typedef struct dt_image_hot_t
+{
+  dt_imgid_t group_id;
+  dt_filmid_t film_id;
+  uint32_t flags; // rating, rejected and state bits
+  GTimeSpan datetime_taken;
+} dt_image_hot_t;
+
 typedef struct dt_image_cache_t
 {
   dt_cache_t cache;
+  GHashTable *hot;            // imgid -> dt_image_hot_t
+  dt_pthread_mutex_t hot_lock;
 }
 dt_image_cache_t;
 
@@ -71,6 +86,11 @@ void dt_image_cache_write_release_info(dt_image_t *img,
 // remove the image from the cache
 void dt_image_cache_remove(const dt_imgid_t imgid);
 
+// fills *hot with the mirrored hot attributes of the image without
+// touching the full cache entry; loads the image on a mirror miss.
+// returns FALSE for images unknown to the database.
+gboolean dt_image_cache_get_hot(const dt_imgid_t imgid, dt_image_hot_t *hot);
+
 // register timestamps in cache
 void dt_image_cache_set_change_timestamp(const dt_imgid_t imgid);
 void dt_image_cache_set_change_timestamp_from_image(const dt_imgid_t imgid, const dt_imgid_t sourceid);
@@ -18,10 +18,14 @@
 
 #include <stdarg.h>
 #include "common/imagebuf.h"
+#include "common/resource_limits.h"
 
 static size_t parallel_imgop_minimum = 500000;
 static size_t parallel_imgop_maxthreads = 4;
 
+// one touch per 4K page is enough to decide its placement
+#define DT_PREFAULT_STRIDE (4096 / sizeof(float))
+
 // Allocate one or more buffers as detailed in the given parameters.
 // If any allocation fails, free all of them, set the module's trouble
 // flag, and return FALSE.
@@ -89,14 +93,39 @@ gboolean dt_iop_alloc_image_buffers(struct dt_iop_module_t *const module,
     if(size & DT_IMGSZ_PERTHREAD)
     {
       *bufptr = dt_alloc_perthread_float(nfloats,paddedsize);
-      if((size & DT_IMGSZ_CLEARBUF) && *bufptr)
-        memset(*bufptr, 0, *paddedsize * dt_get_num_threads() * sizeof(float));
+      if(*bufptr)
+      {
+        // let every thread fault in (and optionally clear) its own
+        // slice, so on NUMA systems the pages of each slice end up on
+        // the node of the thread which will be using it
+        float *const buf = *bufptr;
+        const size_t padded = *paddedsize;
+        const gboolean clear = (size & DT_IMGSZ_CLEARBUF) != 0;
+        const int nthreads = dt_get_num_threads();
+        DT_OMP_FOR(num_threads(nthreads))
+        for(int t = 0; t < nthreads; t++)
+        {
+          if(clear)
+            memset(buf + (size_t)t * padded, 0, padded * sizeof(float));
+          else
+            for(size_t k = 0; k < padded; k += DT_PREFAULT_STRIDE)
+              buf[(size_t)t * padded + k] = 0.0f;
+        }
+      }
     }
     else
     {
       *bufptr = dt_alloc_align_float(nfloats);
-      if((size & DT_IMGSZ_CLEARBUF) && *bufptr)
-        memset(*bufptr, 0, nfloats * sizeof(float));
+      if(*bufptr)
+      {
+        // clearing resp. prefaulting in parallel places the pages
+        // with first touch instead of leaving them all on the node
+        // which ran the allocation
+        if(size & DT_IMGSZ_CLEARBUF)
+          dt_iop_image_fill(*bufptr, 0.0f, nfloats, 1, 1);
+        else
+          dt_iop_image_prefault(*bufptr, nfloats);
+      }
     }
     if(!*bufptr)
     {
@@ -140,6 +169,36 @@ gboolean dt_iop_alloc_image_buffers(struct dt_iop_module_t *const module,
 }
 
 
+// Fault in a freshly allocated image buffer using the same static
+// thread layout DT_OMP_FOR gives to the processing loops.  On NUMA
+// systems the first touch of a page decides which node it lives on, so
+// touching each page from the thread which will later process that
+// part of the image keeps the pixel data node-local instead of piling
+// it up on whichever node happened to run the allocation.  The buffer
+// contents are left undefined, as with malloc.
+void dt_iop_image_prefault(float *const buf, const size_t nfloats)
+{
+#ifdef _OPENMP
+  if(nfloats > parallel_imgop_minimum)
+  {
+    // deliberately not capped at parallel_imgop_maxthreads: this is
+    // about matching the placement to the processing loops, which use
+    // all threads, not about memory bandwidth
+    const int nthreads = dt_get_num_threads();
+    const size_t chunksize = (nfloats + nthreads - 1) / nthreads;
+    DT_OMP_FOR(num_threads(nthreads))
+    for(size_t chunk = 0; chunk < nthreads; chunk++)
+    {
+      const size_t limit = MIN((chunk + 1) * chunksize, nfloats);
+      for(size_t k = chunk * chunksize; k < limit; k += DT_PREFAULT_STRIDE)
+        buf[k] = 0.0f;
+    }
+  }
+#endif // _OPENMP
+  // without OpenMP there is only one thread layout; small buffers fit
+  // on a single node anyway, so there is nothing to gain
+}
+
 // Copy an image buffer, specifying the number of floats it contains.
 // Use of this function is to be preferred over a bare memcpy both
 // because it helps document the purpose of the code and because it
@@ -479,6 +538,122 @@ void dt_iop_image_linear_blend(float *const restrict buf,
     buf[k] = lambda*buf[k] + lambda_1*other[k];
 }
 
+// The buffer pool keeps a few of the large aligned allocations made
+// for decoded images and pipe cachelines around instead of returning
+// them to the OS.  Freshly mmapped allocations of this size are handed
+// back page by page through first-touch faults, which shows up badly
+// under export load; recycling a warm buffer avoids both the faults
+// and the zeroing the kernel does on the new pages.
+//
+// Buffers are grouped in power-of-two size classes.  Each pooled
+// allocation is preceded by one cacheline recording its class, so
+// dt_bufpool_free() needs no global registry and requests outside the
+// pooled range degrade to plain dt_alloc_aligned()/dt_free_align().
+
+#define DT_BUFPOOL_MIN_CLASS 20    // 1 MiB, smaller requests are not pooled
+#define DT_BUFPOOL_MAX_CLASS 31    // 2 GiB
+#define DT_BUFPOOL_CLASSES (DT_BUFPOOL_MAX_CLASS - DT_BUFPOOL_MIN_CLASS + 1)
+#define DT_BUFPOOL_PER_CLASS 4
+
+typedef struct dt_bufpool_class_t
+{
+  void *buf[DT_BUFPOOL_PER_CLASS];
+  int count;
+} dt_bufpool_class_t;
+
+static struct
+{
+  GMutex lock;
+  size_t pooled;  // bytes currently sitting unused in the pool
+  dt_bufpool_class_t class[DT_BUFPOOL_CLASSES];
+} _bufpool = { 0 };
+
+// class index for a request, or -1 if the size is not pooled
+static int _bufpool_class(const size_t size)
+{
+  if(size < ((size_t)1 << DT_BUFPOOL_MIN_CLASS)
+     || size > ((size_t)1 << DT_BUFPOOL_MAX_CLASS))
+    return -1;
+  int c = DT_BUFPOOL_MIN_CLASS;
+  while(((size_t)1 << c) < size) c++;
+  return c - DT_BUFPOOL_MIN_CLASS;
+}
+
+static size_t _bufpool_class_size(const int c)
+{
+  return (size_t)1 << (c + DT_BUFPOOL_MIN_CLASS);
+}
+
+// high-water mark; beyond this the pool gives buffers back to the OS
+static size_t _bufpool_limit()
+{
+  return dt_get_available_mem() / 8;
+}
+
+void *dt_bufpool_alloc(const size_t size)
+{
+  const int c = _bufpool_class(size);
+  void *raw = NULL;
+  if(c >= 0)
+  {
+    g_mutex_lock(&_bufpool.lock);
+    dt_bufpool_class_t *cl = &_bufpool.class[c];
+    if(cl->count > 0)
+    {
+      raw = cl->buf[--cl->count];
+      _bufpool.pooled -= _bufpool_class_size(c);
+    }
+    g_mutex_unlock(&_bufpool.lock);
+  }
+  if(!raw)
+  {
+    const size_t payload = c >= 0 ? _bufpool_class_size(c) : size;
+    raw = dt_alloc_aligned(payload + DT_CACHELINE_BYTES);
+    if(!raw) return NULL;
+    *(int *)raw = c;
+  }
+  return (char *)raw + DT_CACHELINE_BYTES;
+}
+
+void dt_bufpool_free(void *buf)
+{
+  if(!buf) return;
+  void *raw = (char *)buf - DT_CACHELINE_BYTES;
+  const int c = *(int *)raw;
+  if(c >= 0 && !dt_memory_pressure())
+  {
+    g_mutex_lock(&_bufpool.lock);
+    dt_bufpool_class_t *cl = &_bufpool.class[c];
+    if(cl->count < DT_BUFPOOL_PER_CLASS
+       && _bufpool.pooled + _bufpool_class_size(c) <= _bufpool_limit())
+    {
+      cl->buf[cl->count++] = raw;
+      _bufpool.pooled += _bufpool_class_size(c);
+      raw = NULL;
+    }
+    g_mutex_unlock(&_bufpool.lock);
+  }
+  if(raw) dt_free_align(raw);
+}
+
+void dt_bufpool_trim(const gboolean flush)
+{
+  const size_t limit = flush ? 0 : _bufpool_limit();
+  g_mutex_lock(&_bufpool.lock);
+  // drop the largest buffers first, they are both the biggest win and
+  // the cheapest to re-fault relative to their reuse frequency
+  for(int c = DT_BUFPOOL_CLASSES - 1; c >= 0 && _bufpool.pooled > limit; c--)
+  {
+    dt_bufpool_class_t *cl = &_bufpool.class[c];
+    while(cl->count > 0 && _bufpool.pooled > limit)
+    {
+      dt_free_align(cl->buf[--cl->count]);
+      _bufpool.pooled -= _bufpool_class_size(c);
+    }
+  }
+  g_mutex_unlock(&_bufpool.lock);
+}
+
 // perform timings to determine the optimal threshold for switching to
 // parallel operations, as well as the maximal number of threads
 // before saturating the memory bus
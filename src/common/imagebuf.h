@@ -72,6 +72,12 @@ static inline void dt_simd_memcpy(const float *const __restrict__ in,
     out[k] = in[k];
 }
 
+// Fault in a freshly allocated image buffer in parallel, with the same
+// static thread layout the processing loops use, so that on NUMA
+// systems each page is placed on the node of the thread which will
+// later process it.  The buffer contents are left undefined.
+void dt_iop_image_prefault(float *const buf, const size_t nfloats);
+
 // Copy an image buffer, specifying the number of floats it contains.
 // Use of this function is to be preferred over a bare memcpy both
 // because it helps document the purpose of the code and because it
@@ -165,6 +171,22 @@ void dt_iop_image_linear_blend(float *const __restrict__ buf,
                                const size_t height,
                                const size_t ch);
 
+// Allocate an aligned buffer through the buffer pool, which recycles
+// large allocations (>= 1 MiB) across decodes and pipe runs to avoid
+// the first-touch page faults of freshly mmapped memory.  Must be
+// released with dt_bufpool_free(), never with dt_free_align().
+void *dt_bufpool_alloc(const size_t size);
+
+// Release a buffer obtained from dt_bufpool_alloc().  Large buffers
+// are kept for reuse unless the pool is over its high-water mark or
+// the system is short on memory.
+void dt_bufpool_free(void *buf);
+
+// Give pooled buffers back to the OS; with flush set drop everything,
+// otherwise only trim down to the high-water mark.  Called by the
+// memory pressure watchdog.
+void dt_bufpool_trim(const gboolean flush);
+
 // perform timings to determine the optimal threshold for switching to
 // parallel operations, as well as the maximal number of threads
 // before saturating the memory bus
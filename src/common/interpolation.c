@@ -48,6 +48,9 @@ enum border_mode
 // !! Make sure to sync this with the filter array !!
 #define MAX_HALF_FILTER_WIDTH 3
 
+// Stack space needed to hold a complete kernel (taps are generated four at a time)
+#define MAX_KERNEL_REQ ((2 * (MAX_HALF_FILTER_WIDTH) + 3) & (~3))
+
 // Add *verbose* (like one msg per pixel out) debug message to stderr
 #define DEBUG_PRINT_VERBOSE 0
 
@@ -415,6 +418,66 @@ static const dt_interpolation_t dt_interpolator[] = {
   },
 };
 
+/* --------------------------------------------------------------------------
+ * Phase-indexed tap tables for the per-sample warp code path
+ * ------------------------------------------------------------------------*/
+
+/* warp-heavy modules (lens, ashift, liquify, clipping rotation) call
+ * dt_interpolation_compute_pixel4c()/_sample() once per output pixel and
+ * thus evaluate the kernel polynomials (or sines, for lanczos) twice per
+ * pixel.  the kernel only depends on the fractional part of the sampling
+ * position, so we tabulate the normalized taps at DT_WARP_LUT_PHASES
+ * subpixel phases once per interpolator and linearly blend the two
+ * neighbouring table rows at lookup time.  the blend keeps the error far
+ * below float noise while replacing the full kernel evaluation by a few
+ * multiply-adds.  the resampling plans keep evaluating exactly - they
+ * compute each kernel only once per output row/column anyway. */
+
+#define DT_WARP_LUT_PHASES 1024
+
+static float *_warp_lut[DT_INTERPOLATION_LAST] = { NULL };
+static GMutex _warp_lut_mutex;
+
+// taps rounded up to a multiple of four so the blend loop vectorizes
+static inline size_t _warp_lut_stride(const dt_interpolation_t *itor)
+{
+  return (2 * itor->width + 3) & ~(size_t)3;
+}
+
+static void _init_warp_lut(const dt_interpolation_t *itor)
+{
+  if(_warp_lut[itor->id]) return;
+
+  g_mutex_lock(&_warp_lut_mutex);
+  if(!_warp_lut[itor->id])
+  {
+    const size_t stride = _warp_lut_stride(itor);
+    const size_t ntaps = 2 * itor->width;
+    // one extra row so the blend may always read row 'phase + 1'
+    float *lut = dt_alloc_align_float((DT_WARP_LUT_PHASES + 1) * stride);
+    if(lut)
+    {
+      for(size_t p = 0; p <= DT_WARP_LUT_PHASES; p++)
+      {
+        float DT_ALIGNED_ARRAY taps[MAX_KERNEL_REQ];
+        const float frac = (float)p / (float)DT_WARP_LUT_PHASES;
+        // same first tap position as in _compute_upsampling_kernel()
+        itor->maketaps(taps, ntaps, itor->width, frac + (float)(itor->width - 1), -1.0f);
+        // store the taps pre-normalized so lookups need no norm division
+        float norm = 0.f;
+        for(size_t tap = 0; tap < ntaps; tap++)
+          norm += taps[tap];
+        for(size_t tap = 0; tap < ntaps; tap++)
+          lut[p * stride + tap] = taps[tap] / norm;
+        for(size_t tap = ntaps; tap < stride; tap++)
+          lut[p * stride + tap] = 0.f;
+      }
+    }
+    _warp_lut[itor->id] = lut;
+  }
+  g_mutex_unlock(&_warp_lut_mutex);
+}
+
 /* --------------------------------------------------------------------------
  * Kernel utility methods
  * ------------------------------------------------------------------------*/
@@ -443,6 +506,34 @@ static inline float _compute_upsampling_kernel(const dt_interpolation_t *itor,
   return itor->maketaps(kernel, 2*itor->width, itor->width, t, -1.0f);
 }
 
+/* LUT variant of the above: blend the two table rows bracketing the
+ * subpixel phase instead of evaluating the kernel function */
+static inline float _compute_upsampling_kernel_lut(const dt_interpolation_t *itor,
+                                                   const float *const lut,
+                                                   float *kernel,
+                                                   int *first,
+                                                   const float t)
+{
+  const float flr = floorf(t);
+  const int f = (int)flr - itor->width + 1;
+  if(first)
+  {
+    *first = f;
+  }
+
+  const size_t stride = _warp_lut_stride(itor);
+  const float pos = (t - flr) * (float)DT_WARP_LUT_PHASES;
+  const size_t phase = (size_t)pos;
+  const float w1 = pos - (float)phase;
+  const float w0 = 1.0f - w1;
+  const float *const row0 = lut + phase * stride;
+  const float *const row1 = row0 + stride;
+  for(size_t tap = 0; tap < stride; tap++)
+    kernel[tap] = w0 * row0[tap] + w1 * row1[tap];
+
+  return 1.0f; // the tabulated taps are pre-normalized
+}
+
 
 /** Computes a downsampling filtering kernel (vectorized version, four taps
  * per inner loop iteration)
@@ -493,8 +584,6 @@ static inline void _compute_downsampling_kernel(const dt_interpolation_t *itor,
  * Sample interpolation function (see usage in iop/lens.c and iop/clipping.c)
  * ------------------------------------------------------------------------*/
 
-#define MAX_KERNEL_REQ ((2 * (MAX_HALF_FILTER_WIDTH) + 3) & (~3))
-
 float dt_interpolation_compute_sample(const dt_interpolation_t *itor,
                                       const float *in,
                                       const float x,
@@ -510,8 +599,11 @@ float dt_interpolation_compute_sample(const dt_interpolation_t *itor,
   float DT_ALIGNED_ARRAY kernelv[MAX_KERNEL_REQ];
 
   // Compute both horizontal and vertical kernels
-  float normh = _compute_upsampling_kernel(itor, kernelh, NULL, x);
-  float normv = _compute_upsampling_kernel(itor, kernelv, NULL, y);
+  const float *const lut = _warp_lut[itor->id];
+  const float normh = lut ? _compute_upsampling_kernel_lut(itor, lut, kernelh, NULL, x)
+                          : _compute_upsampling_kernel(itor, kernelh, NULL, x);
+  const float normv = lut ? _compute_upsampling_kernel_lut(itor, lut, kernelv, NULL, y)
+                          : _compute_upsampling_kernel(itor, kernelv, NULL, y);
 
   int ix = (int)x;
   int iy = (int)y;
@@ -612,8 +704,11 @@ void dt_interpolation_compute_pixel4c(const dt_interpolation_t *itor,
   float DT_ALIGNED_ARRAY kernelv[MAX_KERNEL_REQ];
 
   // Compute both horizontal and vertical kernels
-  float normh = _compute_upsampling_kernel(itor, kernelh, NULL, x);
-  float normv = _compute_upsampling_kernel(itor, kernelv, NULL, y);
+  const float *const lut = _warp_lut[itor->id];
+  const float normh = lut ? _compute_upsampling_kernel_lut(itor, lut, kernelh, NULL, x)
+                          : _compute_upsampling_kernel(itor, kernelh, NULL, x);
+  const float normv = lut ? _compute_upsampling_kernel_lut(itor, lut, kernelv, NULL, y)
+                          : _compute_upsampling_kernel(itor, kernelv, NULL, y);
 
   // Precompute the inverse of the filter norm for later use
   const float oonorm = (1.f / (normh * normv));
@@ -779,6 +874,9 @@ const dt_interpolation_t *dt_interpolation_new(enum dt_interpolation_type type)
     }
   }
 
+  // make sure the per-sample code paths find their tap table
+  _init_warp_lut(itor);
+
   return itor;
 }
 
@@ -1008,6 +1106,95 @@ static gboolean _prepare_resampling_plan(const dt_interpolation_t *itor,
   return FALSE;
 }
 
+/* Fused application of the resampling plans for a range of output rows:
+ * the horizontal convolution is recomputed for every contributing input
+ * line of every output pixel. Only used as fallback when no scratch
+ * memory for the separable code path is available. */
+static void _resample_fused_rows(float *const out,
+                                 const float *const in,
+                                 const size_t out_stride_floats,
+                                 const size_t in_stride_floats,
+                                 const int width_out,
+                                 const int oy0,
+                                 const int oy1,
+                                 const int *const hlength,
+                                 const float *const hkernel,
+                                 const int *const hindex,
+                                 const int *const vlength,
+                                 const float *const vkernel,
+                                 const int *const vindex,
+                                 const int *const vmeta)
+{
+  // Process each output line
+  for(size_t oy = oy0; oy < (size_t)oy1; oy++)
+  {
+    // Initialize column resampling indexes
+    int vlidx = vmeta[3 * oy + 0]; // V(ertical) L(ength) I(n)d(e)x
+    int vkidx = vmeta[3 * oy + 1]; // V(ertical) K(ernel) I(n)d(e)x
+    int viidx = vmeta[3 * oy + 2]; // V(ertical) I(ndex) I(n)d(e)x
+
+    // Initialize row resampling indexes
+    int hlidx = 0; // H(orizontal) L(ength) I(n)d(e)x
+    int hkidx = 0; // H(orizontal) K(ernel) I(n)d(e)x
+
+    // Number of lines contributing to the output line
+    int vl = vlength[vlidx++]; // V(ertical) L(ength)
+
+    // Process each output column
+    for(size_t ox = 0; ox < (size_t)width_out; ox++)
+    {
+      // This will hold the resulting pixel
+      dt_aligned_pixel_t vs = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+      // Number of horizontal samples contributing to the output
+      int hl = hlength[hlidx++]; // H(orizontal) L(ength)
+
+      for(size_t iy = 0; iy < vl; iy++)
+      {
+        // This is our input line
+        size_t baseidx_vindex = (size_t)vindex[viidx++] * in_stride_floats;
+
+        dt_aligned_pixel_t vhs = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for(size_t ix = 0; ix < hl; ix++)
+        {
+          // Apply the precomputed filter kernel
+          const size_t baseidx = baseidx_vindex + (size_t)hindex[hkidx] * 4;
+          const float htap = hkernel[hkidx++];
+          dt_aligned_pixel_t tmp;
+          copy_pixel(tmp, in + baseidx);
+          for_each_channel(c, aligned(tmp,vhs:16))
+            vhs[c] += tmp[c] * htap;
+        }
+
+        // Accumulate contribution from this line
+        const float vtap = vkernel[vkidx++];
+        for_each_channel(c, aligned(vhs,vs:16)) vs[c] += vhs[c] * vtap;
+
+        // Reset horizontal resampling context
+        hkidx -= hl;
+      }
+
+      // Output pixel is ready
+      const size_t baseidx = (size_t)oy * out_stride_floats + (size_t)ox * 4;
+
+      // Clip negative RGB that may be produced by Lanczos undershooting
+      // Negative RGB are invalid values no matter the RGB space (light is positive)
+      dt_aligned_pixel_t pixel;
+      for_each_channel(c, aligned(vs:16))
+        pixel[c] = MAX(vs[c], 0.f);
+      copy_pixel_nontemporal(out + baseidx, pixel);
+
+      // Reset vertical resampling context
+      viidx -= vl;
+      vkidx -= vl;
+
+      // Progress in horizontal context
+      hkidx += hl;
+    }
+  }
+}
+
 /** Applies resampling (re-scaling) on *full* input and output buffers.
  *  roi_in and roi_out define the part of the buffers that is affected.
  */
@@ -1088,74 +1275,114 @@ void dt_interpolation_resample(const dt_interpolation_t *itor,
 
   dt_get_perf_times(&mid);
 
-  // Process each output line
+  /* Apply the two plans as a separable two-pass resample: each band of
+   * output lines first resamples the contributing input lines
+   * horizontally into a scratch buffer, then combines those lines
+   * vertically. This does the horizontal convolution once per input
+   * line instead of once per contributing line of every output pixel,
+   * which for downscaling cuts the tap work roughly by the number of
+   * vertical taps. Bands are contiguous output row ranges so each
+   * thread reuses its horizontally resampled lines across all output
+   * lines they contribute to. */
+  const int height_out = roi_out->height;
+  const int nbands = MAX(1, MIN(dt_get_num_threads(), height_out));
+  const int rows_per_band = (height_out + nbands - 1) / nbands;
+  const size_t rowfloats = (size_t)4 * roi_out->width;
+
   DT_OMP_FOR()
-  for(size_t oy = 0; oy < (size_t)roi_out->height; oy++)
+  for(int band = 0; band < nbands; band++)
   {
-    // Initialize column resampling indexes
-    int vlidx = vmeta[3 * oy + 0]; // V(ertical) L(ength) I(n)d(e)x
-    int vkidx = vmeta[3 * oy + 1]; // V(ertical) K(ernel) I(n)d(e)x
-    int viidx = vmeta[3 * oy + 2]; // V(ertical) I(ndex) I(n)d(e)x
-
-    // Initialize row resampling indexes
-    int hlidx = 0; // H(orizontal) L(ength) I(n)d(e)x
-    int hkidx = 0; // H(orizontal) K(ernel) I(n)d(e)x
-
-    // Number of lines contributing to the output line
-    int vl = vlength[vlidx++]; // V(ertical) L(ength)
-
-    // Process each output column
-    for(size_t ox = 0; ox < (size_t)roi_out->width; ox++)
+    const int oy0 = band * rows_per_band;
+    const int oy1 = MIN(oy0 + rows_per_band, height_out);
+    if(oy0 >= oy1) continue;
+
+    // range of input lines contributing to this band
+    int rfirst = roi_in->height - 1;
+    int rlast = 0;
+    for(int oy = oy0; oy < oy1; oy++)
     {
-      // This will hold the resulting pixel
-      dt_aligned_pixel_t vs = { 0.0f, 0.0f, 0.0f, 0.0f };
+      const int vl = vlength[vmeta[3 * oy + 0]];
+      const int vi = vmeta[3 * oy + 2];
+      for(int tap = 0; tap < vl; tap++)
+      {
+        const int row = vindex[vi + tap];
+        rfirst = MIN(rfirst, row);
+        rlast = MAX(rlast, row);
+      }
+    }
 
-      // Number of horizontal samples contributing to the output
-      int hl = hlength[hlidx++]; // H(orizontal) L(ength)
+    float *const restrict hresampled =
+      (rlast >= rfirst)
+        ? dt_alloc_align_float(rowfloats * (rlast - rfirst + 1))
+        : NULL;
+    if(!hresampled)
+    {
+      // no scratch memory (or empty band), do the all-in-one loop
+      _resample_fused_rows(out, in, out_stride_floats, in_stride_floats,
+                           roi_out->width, oy0, oy1,
+                           hlength, hkernel, hindex,
+                           vlength, vkernel, vindex, vmeta);
+      continue;
+    }
 
-      for(size_t iy = 0; iy < vl; iy++)
+    // horizontal pass: resample each needed input line once
+    for(int y = rfirst; y <= rlast; y++)
+    {
+      const float *const irow = in + (size_t)y * in_stride_floats;
+      float *const orow = hresampled + (size_t)(y - rfirst) * rowfloats;
+      int hkidx = 0;
+      for(int ox = 0; ox < roi_out->width; ox++)
       {
-        // This is our input line
-        size_t baseidx_vindex = (size_t)vindex[viidx++] * in_stride_floats;
-
+        const int hl = hlength[ox];
         dt_aligned_pixel_t vhs = { 0.0f, 0.0f, 0.0f, 0.0f };
-
-        for(size_t ix = 0; ix < hl; ix++)
+        for(int ix = 0; ix < hl; ix++)
         {
           // Apply the precomputed filter kernel
-          const size_t baseidx = baseidx_vindex + (size_t)hindex[hkidx] * 4;
+          const size_t baseidx = (size_t)hindex[hkidx] * 4;
           const float htap = hkernel[hkidx++];
           dt_aligned_pixel_t tmp;
-          copy_pixel(tmp, in + baseidx);
+          copy_pixel(tmp, irow + baseidx);
           for_each_channel(c, aligned(tmp,vhs:16))
             vhs[c] += tmp[c] * htap;
         }
+        copy_pixel(orow + 4 * ox, vhs);
+      }
+    }
 
-        // Accumulate contribution from this line
-        const float vtap = vkernel[vkidx++];
-        for_each_channel(c, aligned(vhs,vs:16)) vs[c] += vhs[c] * vtap;
+    // vertical pass: accumulate the resampled lines into the output rows
+    for(int oy = oy0; oy < oy1; oy++)
+    {
+      const int vl = vlength[vmeta[3 * oy + 0]];
+      const int vkidx = vmeta[3 * oy + 1];
+      const int viidx = vmeta[3 * oy + 2];
+      float *const orow = out + (size_t)oy * out_stride_floats;
 
-        // Reset horizontal resampling context
-        hkidx -= hl;
+      if(vl <= 0)
+      {
+        memset(orow, 0, rowfloats * sizeof(float));
+        continue;
       }
 
-      // Output pixel is ready
-      const size_t baseidx = (size_t)oy * out_stride_floats + (size_t)ox * 4;
+      for(int iy = 0; iy < vl; iy++)
+      {
+        const float *const srow =
+          hresampled + (size_t)(vindex[viidx + iy] - rfirst) * rowfloats;
+        const float vtap = vkernel[vkidx + iy];
+        if(iy == 0)
+          for(size_t x = 0; x < rowfloats; x++)
+            orow[x] = srow[x] * vtap;
+        else
+          for(size_t x = 0; x < rowfloats; x++)
+            orow[x] += srow[x] * vtap;
+      }
 
       // Clip negative RGB that may be produced by Lanczos undershooting
       // Negative RGB are invalid values no matter the RGB space (light is positive)
-      dt_aligned_pixel_t pixel;
-      for_each_channel(c, aligned(vs:16))
-        pixel[c] = MAX(vs[c], 0.f);
-      copy_pixel_nontemporal(out + baseidx, pixel);
-
-      // Reset vertical resampling context
-      viidx -= vl;
-      vkidx -= vl;
-
-      // Progress in horizontal context
-      hkidx += hl;
+      for(size_t x = 0; x < rowfloats; x++)
+        orow[x] = MAX(orow[x], 0.f);
     }
+
+    dt_free_align(hresampled);
   }
   dt_omploop_sfence();
 
@@ -359,65 +359,6 @@ static inline int _init_unbounded_coeffs(float *const lutr,
 }
 
 
-static inline void _apply_tonecurves(const float *const image_in,
-                                     float *const image_out,
-                                     const int width,
-                                     const int height,
-                                     const float *const restrict lutr,
-                                     const float *const restrict lutg,
-                                     const float *const restrict lutb,
-                                     const float *const restrict unbounded_coeffsr,
-                                     const float *const restrict unbounded_coeffsg,
-                                     const float *const restrict unbounded_coeffsb,
-                                     const int lutsize)
-{
-  const int ch = 4;
-  const float *const lut[3] = { lutr, lutg, lutb };
-  const float *const unbounded_coeffs[3] =
-    { unbounded_coeffsr, unbounded_coeffsg, unbounded_coeffsb };
-  const size_t stride = (size_t)ch * width * height;
-
-  // do we have any lut to apply, or is this a linear profile?
-  if((lut[0][0] >= 0.0f)
-     && (lut[1][0] >= 0.0f)
-     && (lut[2][0] >= 0.0f))
-  {
-    DT_OMP_FOR(collapse(2))
-    for(size_t k = 0; k < stride; k += ch)
-    {
-      for(int c = 0; c < 3; c++) // for_each_channel doesn't
-                                 // vectorize, and some code needs
-                                 // image_out[3] preserved
-      {
-        image_out[k + c] = (image_in[k + c] < 1.0f)
-          ? extrapolate_lut(lut[c], image_in[k + c], lutsize)
-          : eval_exp(unbounded_coeffs[c], image_in[k + c]);
-      }
-    }
-  }
-  else if((lut[0][0] >= 0.0f)
-          || (lut[1][0] >= 0.0f)
-          || (lut[2][0] >= 0.0f))
-  {
-    DT_OMP_FOR(collapse(2))
-    for(size_t k = 0; k < stride; k += ch)
-    {
-      for(int c = 0; c < 3; c++) // for_each_channel doesn't
-                                 // vectorize, and some code needs
-                                 // image_out[3] preserved
-      {
-        if(lut[c][0] >= 0.0f)
-        {
-          image_out[k + c] = (image_in[k + c] < 1.0f)
-            ? extrapolate_lut(lut[c], image_in[k + c], lutsize)
-            : eval_exp(unbounded_coeffs[c], image_in[k + c]);
-        }
-      }
-    }
-  }
-}
-
-
 static inline void _transform_rgb_to_lab_matrix
   (const float *const restrict image_in,
    float *const restrict image_out,
@@ -431,23 +372,32 @@ static inline void _transform_rgb_to_lab_matrix
 
   if(profile_info->nonlinearlut)
   {
-    // TODO : maybe optimize that path like _transform_matrix_rgb
-    _apply_tonecurves(image_in, image_out, width, height,
-                      profile_info->lut_in[0],
-                      profile_info->lut_in[1],
-                      profile_info->lut_in[2],
-                      profile_info->unbounded_coeffs_in[0],
-                      profile_info->unbounded_coeffs_in[1],
-                      profile_info->unbounded_coeffs_in[2],
-                      profile_info->lutsize);
+    const int run_lut_in[3] DT_ALIGNED_PIXEL = { (profile_info->lut_in[0][0] >= 0.0f),
+                                                 (profile_info->lut_in[1][0] >= 0.0f),
+                                                 (profile_info->lut_in[2][0] >= 0.0f) };
 
     DT_OMP_FOR()
     for(size_t y = 0; y < stride; y += ch)
     {
-      float *const restrict in = DT_IS_ALIGNED_PIXEL(image_out + y);
+      const float *const restrict in = DT_IS_ALIGNED_PIXEL(image_in + y);
+      float *const restrict out = DT_IS_ALIGNED_PIXEL(image_out + y);
+
+      // linearize in registers instead of making a separate tonecurve pass over the whole image,
+      // which costs an extra round-trip of the buffer through memory
+      dt_aligned_pixel_t linear;
+      for(size_t c = 0; c < 3; c++)
+      {
+        linear[c] = (run_lut_in[c]
+                     ? ((in[c] < 1.0f)
+                        ? extrapolate_lut(profile_info->lut_in[c], in[c], profile_info->lutsize)
+                        : eval_exp(profile_info->unbounded_coeffs_in[c], in[c]))
+                     : in[c]);
+      }
+      linear[3] = in[3];
+
       dt_aligned_pixel_t xyz; // inited in _ioppr_linear_rgb_matrix_to_xyz()
-      dt_apply_transposed_color_matrix(in, *matrix_ptr, xyz);
-      dt_XYZ_to_Lab(xyz, in);
+      dt_apply_transposed_color_matrix(linear, *matrix_ptr, xyz);
+      dt_XYZ_to_Lab(xyz, out);
     }
   }
   else
@@ -477,31 +427,53 @@ static inline void _transform_lab_to_rgb_matrix
   const size_t stride = (size_t)width * height * ch;
   const dt_colormatrix_t *matrix_ptr = &profile_info->matrix_out_transposed;
 
-  DT_OMP_FOR()
-  for(size_t y = 0; y < stride; y += ch)
+  if(profile_info->nonlinearlut)
   {
-    const float *const restrict in = DT_IS_ALIGNED_PIXEL(image_in + y);
-    float *const restrict out = DT_IS_ALIGNED_PIXEL(image_out + y);
+    const int run_lut_out[3] DT_ALIGNED_PIXEL = { (profile_info->lut_out[0][0] >= 0.0f),
+                                                  (profile_info->lut_out[1][0] >= 0.0f),
+                                                  (profile_info->lut_out[2][0] >= 0.0f) };
 
-    dt_aligned_pixel_t xyz;
-    const float alpha = in[3];
-    // some code does in-place conversions and relies on alpha being preserved
-    dt_Lab_to_XYZ(in, xyz);
-    dt_apply_transposed_color_matrix(xyz, *matrix_ptr, out);
-    out[3] = alpha;
-  }
+    DT_OMP_FOR()
+    for(size_t y = 0; y < stride; y += ch)
+    {
+      const float *const restrict in = DT_IS_ALIGNED_PIXEL(image_in + y);
+      float *const restrict out = DT_IS_ALIGNED_PIXEL(image_out + y);
 
-  if(profile_info->nonlinearlut)
+      dt_aligned_pixel_t xyz;
+      dt_aligned_pixel_t rgb;
+      const float alpha = in[3];
+      // some code does in-place conversions and relies on alpha being preserved
+      dt_Lab_to_XYZ(in, xyz);
+      dt_apply_transposed_color_matrix(xyz, *matrix_ptr, rgb);
+
+      // de-linearize in registers instead of making a separate tonecurve pass over the whole image,
+      // which costs an extra round-trip of the buffer through memory
+      for(size_t c = 0; c < 3; c++)
+      {
+        out[c] = (run_lut_out[c]
+                  ? ((rgb[c] < 1.0f)
+                     ? extrapolate_lut(profile_info->lut_out[c], rgb[c], profile_info->lutsize)
+                     : eval_exp(profile_info->unbounded_coeffs_out[c], rgb[c]))
+                  : rgb[c]);
+      }
+      out[3] = alpha;
+    }
+  }
+  else
   {
-    // TODO : maybe optimize that path like _transform_matrix_rgb
-    _apply_tonecurves(image_out, image_out, width, height,
-                      profile_info->lut_out[0],
-                      profile_info->lut_out[1],
-                      profile_info->lut_out[2],
-                      profile_info->unbounded_coeffs_out[0],
-                      profile_info->unbounded_coeffs_out[1],
-                      profile_info->unbounded_coeffs_out[2],
-                      profile_info->lutsize);
+    DT_OMP_FOR()
+    for(size_t y = 0; y < stride; y += ch)
+    {
+      const float *const restrict in = DT_IS_ALIGNED_PIXEL(image_in + y);
+      float *const restrict out = DT_IS_ALIGNED_PIXEL(image_out + y);
+
+      dt_aligned_pixel_t xyz;
+      const float alpha = in[3];
+      // some code does in-place conversions and relies on alpha being preserved
+      dt_Lab_to_XYZ(in, xyz);
+      dt_apply_transposed_color_matrix(xyz, *matrix_ptr, out);
+      out[3] = alpha;
+    }
   }
 }
 
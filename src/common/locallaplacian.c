@@ -445,21 +445,32 @@ void local_laplacian_internal(
   for(int k=0;k<num_gamma;k++) gamma[k] = (k+.5f)/(float)num_gamma;
   // for(int k=0;k<num_gamma;k++) gamma[k] = k/(num_gamma-1.0f);
 
-  // allocate memory for intermediate laplacian pyramids
+  // allocate memory for intermediate laplacian pyramids.  these stay
+  // internal to this invocation (unlike padded[0]/output[], which may be
+  // handed out via the boundary struct below), so carve all num_gamma
+  // pyramids out of a single arena instead of paying for
+  // num_gamma * num_levels allocations on every slider tick
   float *buf[num_gamma][max_levels] = {{0}};
+  size_t level_offset[max_levels] = {0};
+  size_t pyramid_floats = 0;
+  for(int l=0;l<=last_level;l++)
+  {
+    level_offset[l] = pyramid_floats;
+    // keep each sub-buffer aligned just like a separate dt_alloc_align_float would
+    pyramid_floats += dt_round_size((size_t)dl(w,l)*dl(h,l), DT_CACHELINE_BYTES/sizeof(float));
+  }
+  float *const arena = dt_alloc_align_float(num_gamma * pyramid_floats);
+  if(!arena)
+  {
+    // copy the input buffer to the output so that we at least get a
+    // valid result
+    for(size_t p = 0; p < (size_t)4 * wd * ht; p++)
+      out[p] = input[p];
+    goto cleanup;
+  }
   for(int k=0;k<num_gamma;k++)
     for(int l=0;l<=last_level;l++)
-    {
-      buf[k][l] = dt_alloc_align_float((size_t)dl(w,l)*dl(h,l));
-      if(!buf[k][l])
-      {
-        // copy the input buffer to the output so that we at least get a
-        // valid result
-        for(size_t p = 0; p < (size_t)4 * wd * ht; p++)
-          out[p] = input[p];
-        goto cleanup;
-      }
-    }
+      buf[k][l] = arena + k * pyramid_floats + level_offset[l];
 
   // the paper says remapping only level 3 not 0 does the trick, too
   // (but i really like the additional octave of sharpness we get,
@@ -581,8 +592,8 @@ cleanup:
   {
     if(!b || b->mode != 1 || l)   dt_free_align(padded[l]);
     if(!b || b->mode != 1)        dt_free_align(output[l]);
-    for(int k=0; k<num_gamma;k++) dt_free_align(buf[k][l]);
   }
+  dt_free_align(arena);
 }
 
 
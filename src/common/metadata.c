@@ -616,6 +616,10 @@ static void _metadata_execute(const GList *imgs,
                               const gboolean undo_on,
                               const gint action)
 {
+  // coalesce the per-image writes below into one transaction,
+  // otherwise editing metadata of a large selection pays a commit per
+  // image
+  dt_database_start_transaction(darktable.db);
   for(const GList *images = imgs; images; images = g_list_next(images))
   {
     const dt_imgid_t imgid = GPOINTER_TO_INT(images->data);
@@ -648,6 +652,7 @@ static void _metadata_execute(const GList *imgs,
     else
       _undo_metadata_free(undometadata);
   }
+  dt_database_release_transaction(darktable.db);
 }
 
 void dt_metadata_set(const dt_imgid_t imgid,
@@ -838,6 +843,23 @@ void dt_metadata_set_list_id(const GList *img,
   }
 }
 
+GHashTable *dt_metadata_already_imported_set(void)
+{
+  GHashTable *ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  sqlite3_stmt *stmt;
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                              "SELECT value FROM main.meta_data",
+                              -1, &stmt, NULL);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    const char *value = (const char *)sqlite3_column_text(stmt, 0);
+    if(value)
+      g_hash_table_add(ids, g_strdup(value));
+  }
+  sqlite3_finalize(stmt);
+  return ids;
+}
+
 gboolean dt_metadata_already_imported(const char *filename, const char *datetime)
 {
   if(!filename || !datetime)
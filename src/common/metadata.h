@@ -116,6 +116,11 @@ void dt_metadata_clear(const GList *imgs, const gboolean undo_on); // libs/metad
 /** check if the "Xmp.darktable.image_id" already exists */
 gboolean dt_metadata_already_imported(const char *filename, const char *datetime);
 
+/** bulk variant of the check above: the set of all stored ids, so many
+    candidate files can be tested without one table scan each. The caller
+    has to destroy the hash table after usage. */
+GHashTable *dt_metadata_already_imported_set(void);
+
 G_END_DECLS
 
 // clang-format off
@@ -23,6 +23,8 @@
 #include "common/file_location.h"
 #include "common/grealpath.h"
 #include "common/image_cache.h"
+#include "common/imagebuf.h"
+#include "common/trace.h"
 #include "control/conf.h"
 #include "control/jobs.h"
 #include "develop/imageop_math.h"
@@ -391,6 +393,148 @@ static void _init_8(uint8_t *buf,
                     const dt_imgid_t imgid,
                     const dt_mipmap_size_t size);
 
+// --- compressed in-memory tier -------------------------------------------
+// thumbnails evicted from the uncompressed cache are optionally kept
+// around as jpeg blobs, roughly an order of magnitude smaller, and
+// restored from there on the next request before we ever touch the
+// disk backend or re-run a pipeline.
+
+typedef struct _comp_tier_entry_t
+{
+  uint8_t *blob; // jpeg data
+  uint32_t len;
+  dt_colorspaces_color_profile_type_t color_space;
+  guint64 age; // for least-recently-stored eviction
+} _comp_tier_entry_t;
+
+static guint64 _comp_tier_time = 0;
+
+static void _comp_tier_entry_free(gpointer data)
+{
+  _comp_tier_entry_t *e = data;
+  free(e->blob);
+  free(e);
+}
+
+static void _comp_tier_drop(dt_mipmap_cache_t *cache, const uint32_t key)
+{
+  if(!cache->comp_tier_limit) return;
+  dt_pthread_mutex_lock(&cache->comp_tier_lock);
+  _comp_tier_entry_t *e = g_hash_table_lookup(cache->comp_tier, GINT_TO_POINTER(key));
+  if(e)
+  {
+    cache->comp_tier_used -= e->len + sizeof(*e);
+    g_hash_table_remove(cache->comp_tier, GINT_TO_POINTER(key));
+  }
+  dt_pthread_mutex_unlock(&cache->comp_tier_lock);
+}
+
+// compress the payload of an evicted entry into the tier. called from
+// the cache cleanup callback, so the entry is exclusively ours.
+static void _comp_tier_store(dt_mipmap_cache_t *cache, dt_cache_entry_t *entry)
+{
+  if(!cache->comp_tier_limit) return;
+  dt_mipmap_buffer_dsc_t *dsc = (dt_mipmap_buffer_dsc_t *)entry->data;
+
+  // worst case buffer, trimmed to the actual length after compression
+  const size_t bufsize = (size_t)4 * dsc->width * dsc->height + (1 << 16);
+  uint8_t *tmp = malloc(bufsize);
+  if(!tmp) return;
+
+  const int cache_quality = dt_conf_get_int("database_cache_quality");
+  const int len = dt_imageio_jpeg_compress((uint8_t *)entry->data + sizeof(*dsc), tmp,
+                                           dsc->width, dsc->height,
+                                           MIN(100, MAX(10, cache_quality)));
+  if(len <= 0)
+  {
+    free(tmp);
+    return;
+  }
+
+  _comp_tier_entry_t *e = malloc(sizeof(_comp_tier_entry_t));
+  if(!e)
+  {
+    free(tmp);
+    return;
+  }
+  e->blob = realloc(tmp, len);
+  if(!e->blob) e->blob = tmp;
+  e->len = len;
+  e->color_space = dsc->color_space;
+
+  dt_pthread_mutex_lock(&cache->comp_tier_lock);
+
+  e->age = ++_comp_tier_time;
+
+  _comp_tier_entry_t *old =
+    g_hash_table_lookup(cache->comp_tier, GINT_TO_POINTER(entry->key));
+  if(old) cache->comp_tier_used -= old->len + sizeof(*old);
+  g_hash_table_replace(cache->comp_tier, GINT_TO_POINTER(entry->key), e);
+  cache->comp_tier_used += e->len + sizeof(*e);
+
+  // bound the tier by dropping the least recently stored blobs
+  while(cache->comp_tier_used > cache->comp_tier_limit)
+  {
+    GHashTableIter iter;
+    gpointer k, v;
+    gpointer oldest_key = NULL;
+    _comp_tier_entry_t *oldest = NULL;
+    g_hash_table_iter_init(&iter, cache->comp_tier);
+    while(g_hash_table_iter_next(&iter, &k, &v))
+    {
+      _comp_tier_entry_t *c = v;
+      if(!oldest || c->age < oldest->age)
+      {
+        oldest = c;
+        oldest_key = k;
+      }
+    }
+    if(!oldest) break;
+    cache->comp_tier_used -= oldest->len + sizeof(*oldest);
+    g_hash_table_remove(cache->comp_tier, oldest_key);
+  }
+
+  dt_pthread_mutex_unlock(&cache->comp_tier_lock);
+}
+
+// try to restore a freshly allocated entry from the tier. the blob is
+// consumed on success and on decode failure alike.
+static gboolean _comp_tier_take(dt_mipmap_cache_t *cache,
+                                dt_cache_entry_t *entry,
+                                dt_mipmap_buffer_dsc_t *dsc)
+{
+  if(!cache->comp_tier_limit) return FALSE;
+
+  dt_pthread_mutex_lock(&cache->comp_tier_lock);
+  _comp_tier_entry_t *e = g_hash_table_lookup(cache->comp_tier, GINT_TO_POINTER(entry->key));
+  if(e)
+  {
+    // steal the blob so we can decompress without holding the lock
+    g_hash_table_steal(cache->comp_tier, GINT_TO_POINTER(entry->key));
+    cache->comp_tier_used -= e->len + sizeof(*e);
+  }
+  dt_pthread_mutex_unlock(&cache->comp_tier_lock);
+
+  if(!e) return FALSE;
+
+  gboolean restored = FALSE;
+  dt_imageio_jpeg_t jpg;
+  if(!dt_imageio_jpeg_decompress_header(e->blob, e->len, &jpg)
+     && sizeof(*dsc) + (size_t)4 * jpg.width * jpg.height <= entry->data_size
+     && !dt_imageio_jpeg_decompress(&jpg, (uint8_t *)entry->data + sizeof(*dsc)))
+  {
+    dsc->width = jpg.width;
+    dsc->height = jpg.height;
+    dsc->iscale = 1.0f;
+    dsc->color_space = e->color_space;
+    restored = TRUE;
+  }
+  _comp_tier_entry_free(e);
+  return restored;
+}
+
+// --------------------------------------------------------------------------
+
 // callback for the imageio core to allocate memory.
 // only needed for _F and _FULL buffers, as they change size
 // with the input image. will allocate img->width*img->height*img->bpp bytes.
@@ -411,11 +555,11 @@ void *dt_mipmap_cache_alloc(dt_mipmap_buffer_t *buf, const dt_image_t *img)
   // so only check size and re-alloc if necessary:
   if(!buf->buf || _is_static_image((void *)dsc) || (entry->data_size < buffer_size))
   {
-    if(!_is_static_image((void *)dsc)) dt_free_align(entry->data);
+    if(!_is_static_image((void *)dsc)) dt_bufpool_free(entry->data);
 
     entry->data_size = 0;
 
-    entry->data = dt_alloc_aligned(buffer_size);
+    entry->data = dt_bufpool_alloc(buffer_size);
 
     if(!entry->data)
     {
@@ -484,7 +628,7 @@ static void _mipmap_cache_allocate_dynamic(void *data, dt_cache_entry_t *entry)
       entry->data_size = sizeof(*dsc) + sizeof(float) * 4 * MIN_IMG_PIXELS;
     }
 
-    entry->data = dt_alloc_aligned(entry->data_size);
+    entry->data = dt_bufpool_alloc(entry->data_size);
 
     // dt_print(DT_DEBUG_ALWAYS, "[mipmap cache] alloc dynamic for key %u %p", key, *buf);
     if(!(entry->data))
@@ -518,25 +662,31 @@ static void _mipmap_cache_allocate_dynamic(void *data, dt_cache_entry_t *entry)
   int loaded_from_disk = 0;
   if(mip < DT_MIPMAP_F)
   {
-    if(cache->cachedir[0] && ((dt_conf_get_bool("cache_disk_backend") && mip < DT_MIPMAP_8)
+    // the compressed memory tier is cheaper than the disk backend, so
+    // it is consulted first
+    if(_comp_tier_take(cache, entry, dsc))
+    {
+      dt_print(DT_DEBUG_CACHE,
+               "[mipmap_cache] grab mip %d for ID=%d from compressed memory tier", mip,
+               _get_imgid(entry->key));
+      loaded_from_disk = 1;
+    }
+    else if(cache->cachedir[0] && ((dt_conf_get_bool("cache_disk_backend") && mip < DT_MIPMAP_8)
                               || (dt_conf_get_bool("cache_disk_backend_full") && mip == DT_MIPMAP_8)))
     {
-      // try and load from disk, if successful set flag
+      // try and load from disk, if successful set flag.
+      // we map the file instead of reading it into a temporary blob, so
+      // the decoder consumes the kernel page cache directly and a warm
+      // scroll never copies the compressed data around.
       char filename[PATH_MAX] = {0};
       snprintf(filename, sizeof(filename), "%s.d/%d/%" PRIu32 ".jpg", cache->cachedir, (int)mip,
                _get_imgid(entry->key));
-      FILE *f = g_fopen(filename, "rb");
-      if(f)
+      GMappedFile *map = g_mapped_file_new(filename, FALSE, NULL);
+      if(map)
       {
-        uint8_t *blob = 0;
-        fseek(f, 0, SEEK_END);
-        const long len = ftell(f);
-        if(len <= 0) goto read_error; // coverity madness
-        blob = (uint8_t *)dt_alloc_aligned(len);
-        if(!blob) goto read_error;
-        fseek(f, 0, SEEK_SET);
-        const int rd = fread(blob, sizeof(uint8_t), len, f);
-        if(rd != len) goto read_error;
+        const uint8_t *blob = (const uint8_t *)g_mapped_file_get_contents(map);
+        const gsize len = g_mapped_file_get_length(map);
+        if(!blob || len == 0) goto read_error;
         dt_colorspaces_color_profile_type_t color_space;
         dt_imageio_jpeg_t jpg;
         if(dt_imageio_jpeg_decompress_header(blob, len, &jpg)
@@ -562,8 +712,7 @@ static void _mipmap_cache_allocate_dynamic(void *data, dt_cache_entry_t *entry)
 read_error:
           g_unlink(filename);
         }
-        dt_free_align(blob);
-        fclose(f);
+        g_mapped_file_unref(map);
       }
     }
   }
@@ -599,6 +748,77 @@ static void _mipmap_cache_unlink_ondisk_thumbnail(void *data,
   }
 }
 
+// serialize a thumbnail to the disk backend.  called on eviction and,
+// for freshly generated mips, right away so other instances sharing
+// the cache directory can pick the thumbnail up immediately
+static void _mipmap_cache_write_ondisk_thumbnail(dt_mipmap_cache_t *cache, dt_cache_entry_t *entry)
+{
+  const dt_mipmap_size_t mip = _get_size(entry->key);
+  if(mip >= DT_MIPMAP_F) return;
+  dt_mipmap_buffer_dsc_t *dsc = (dt_mipmap_buffer_dsc_t *)entry->data;
+  // don't write skulls:
+  if(dsc->width <= 8 || dsc->height <= 8) return;
+  if(dsc->flags & DT_MIPMAP_BUFFER_DSC_FLAG_INVALIDATE) return;
+  if(cache->cachedir[0] && ((dt_conf_get_bool("cache_disk_backend") && mip < DT_MIPMAP_8)
+                            || (dt_conf_get_bool("cache_disk_backend_full") && mip == DT_MIPMAP_8)))
+  {
+    // serialize to disk
+    char filename[PATH_MAX] = {0};
+    snprintf(filename, sizeof(filename), "%s.d/%d", cache->cachedir, mip);
+    const int mkd = g_mkdir_with_parents(filename, 0750);
+    if(!mkd)
+    {
+      snprintf(filename, sizeof(filename), "%s.d/%d/%" PRIu32 ".jpg", cache->cachedir, (int)mip,
+               _get_imgid(entry->key));
+      // Don't write existing files as both performance and quality (lossy jpg) suffer
+      FILE *f = NULL;
+      if(!g_file_test(filename, G_FILE_TEST_EXISTS) && (f = g_fopen(filename, "wb")))
+      {
+        // first check the disk isn't full
+        struct statvfs vfsbuf;
+        if(!statvfs(filename, &vfsbuf))
+        {
+          const int64_t free_mb = ((vfsbuf.f_frsize * vfsbuf.f_bavail) >> 20);
+          if(free_mb < 100)
+          {
+            dt_print(DT_DEBUG_ALWAYS,
+                     "[mipmap_cache] aborting image write as only %" PRId64 " MB free to write %s",
+                     free_mb, filename);
+            goto write_error;
+          }
+        }
+        else
+        {
+          dt_print(DT_DEBUG_ALWAYS,
+                   "[mipmap_cache] aborting image write since couldn't determine free space available to write %s",
+                   filename);
+          goto write_error;
+        }
+
+        const int cache_quality = dt_conf_get_int("database_cache_quality");
+        const uint8_t *exif = NULL;
+        int exif_len = 0;
+        if(dsc->color_space == DT_COLORSPACE_SRGB)
+        {
+          exif = dt_mipmap_cache_exif_data_srgb;
+          exif_len = dt_mipmap_cache_exif_data_srgb_length;
+        }
+        else if(dsc->color_space == DT_COLORSPACE_ADOBERGB)
+        {
+          exif = dt_mipmap_cache_exif_data_adobergb;
+          exif_len = dt_mipmap_cache_exif_data_adobergb_length;
+        }
+        if(dt_imageio_jpeg_write(filename, (uint8_t *)entry->data + sizeof(*dsc), dsc->width, dsc->height, MIN(100, MAX(10, cache_quality)), exif, exif_len))
+        {
+write_error:
+          g_unlink(filename);
+        }
+      }
+      if(f) fclose(f);
+    }
+  }
+}
+
 static void _mipmap_cache_deallocate_dynamic(void *data, dt_cache_entry_t *entry)
 {
   dt_mipmap_cache_t *cache = (dt_mipmap_cache_t *)data;
@@ -611,69 +831,17 @@ static void _mipmap_cache_deallocate_dynamic(void *data, dt_cache_entry_t *entry
     {
       if(dsc->flags & DT_MIPMAP_BUFFER_DSC_FLAG_INVALIDATE)
       {
+        _comp_tier_drop(cache, entry->key);
         _mipmap_cache_unlink_ondisk_thumbnail(data, _get_imgid(entry->key), mip);
       }
-      else if(cache->cachedir[0] && ((dt_conf_get_bool("cache_disk_backend") && mip < DT_MIPMAP_8)
-                                     || (dt_conf_get_bool("cache_disk_backend_full") && mip == DT_MIPMAP_8)))
+      else
       {
-        // serialize to disk
-        char filename[PATH_MAX] = {0};
-        snprintf(filename, sizeof(filename), "%s.d/%d", cache->cachedir, mip);
-        const int mkd = g_mkdir_with_parents(filename, 0750);
-        if(!mkd)
-        {
-          snprintf(filename, sizeof(filename), "%s.d/%d/%" PRIu32 ".jpg", cache->cachedir, (int)mip,
-                   _get_imgid(entry->key));
-          // Don't write existing files as both performance and quality (lossy jpg) suffer
-          FILE *f = NULL;
-          if(!g_file_test(filename, G_FILE_TEST_EXISTS) && (f = g_fopen(filename, "wb")))
-          {
-            // first check the disk isn't full
-            struct statvfs vfsbuf;
-            if(!statvfs(filename, &vfsbuf))
-            {
-              const int64_t free_mb = ((vfsbuf.f_frsize * vfsbuf.f_bavail) >> 20);
-              if(free_mb < 100)
-              {
-                dt_print(DT_DEBUG_ALWAYS,
-                         "[mipmap_cache] aborting image write as only %" PRId64 " MB free to write %s",
-                         free_mb, filename);
-                goto write_error;
-              }
-            }
-            else
-            {
-              dt_print(DT_DEBUG_ALWAYS,
-                       "[mipmap_cache] aborting image write since couldn't determine free space available to write %s",
-                       filename);
-              goto write_error;
-            }
-
-            const int cache_quality = dt_conf_get_int("database_cache_quality");
-            const uint8_t *exif = NULL;
-            int exif_len = 0;
-            if(dsc->color_space == DT_COLORSPACE_SRGB)
-            {
-              exif = dt_mipmap_cache_exif_data_srgb;
-              exif_len = dt_mipmap_cache_exif_data_srgb_length;
-            }
-            else if(dsc->color_space == DT_COLORSPACE_ADOBERGB)
-            {
-              exif = dt_mipmap_cache_exif_data_adobergb;
-              exif_len = dt_mipmap_cache_exif_data_adobergb_length;
-            }
-            if(dt_imageio_jpeg_write(filename, (uint8_t *)entry->data + sizeof(*dsc), dsc->width, dsc->height, MIN(100, MAX(10, cache_quality)), exif, exif_len))
-            {
-write_error:
-              g_unlink(filename);
-            }
-          }
-          if(f) fclose(f);
-        }
+        _comp_tier_store(cache, entry);
+        _mipmap_cache_write_ondisk_thumbnail(cache, entry);
       }
     }
   }
-  dt_free_align(entry->data);
+  if(!_is_static_image(entry->data)) dt_bufpool_free(entry->data);
 }
 
 static uint32_t _nearest_power_of_two(const uint32_t value)
@@ -744,6 +912,16 @@ void dt_mipmap_cache_init()
   cache->mip_full.stats_fetches = 0;
   cache->mip_full.stats_standin = 0;
 
+  // the compressed tier keeps evicted thumbnails around as jpeg blobs
+  // at a fraction of their uncompressed size, budgeted on top of the
+  // thumbnail cache
+  cache->comp_tier_limit =
+    dt_conf_get_bool("cache_compressed_memory") ? max_mem / 4 : 0;
+  cache->comp_tier = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                           NULL, _comp_tier_entry_free);
+  cache->comp_tier_used = 0;
+  dt_pthread_mutex_init(&cache->comp_tier_lock, NULL);
+
   dt_cache_init(&cache->mip_thumbs.cache, 0, max_mem);
   dt_cache_set_allocate_callback(&cache->mip_thumbs.cache, _mipmap_cache_allocate_dynamic, cache);
   dt_cache_set_cleanup_callback(&cache->mip_thumbs.cache, _mipmap_cache_deallocate_dynamic, cache);
@@ -776,6 +954,9 @@ void dt_mipmap_cache_cleanup()
   dt_cache_cleanup(&cache->mip_thumbs.cache);
   dt_cache_cleanup(&cache->mip_full.cache);
   dt_cache_cleanup(&cache->mip_f.cache);
+  // after the caches are gone nothing stores into the tier anymore
+  g_hash_table_destroy(cache->comp_tier);
+  dt_pthread_mutex_destroy(&cache->comp_tier_lock);
   darktable.mipmap_cache = NULL;
   free(cache);
 }
@@ -788,6 +969,11 @@ void dt_mipmap_cache_print()
            cache->mip_thumbs.cache.cost / (1024.0 * 1024.0),
            cache->mip_thumbs.cache.cost_quota / (1024.0 * 1024.0),
            100.0f * (float)cache->mip_thumbs.cache.cost / (float)cache->mip_thumbs.cache.cost_quota);
+  if(cache->comp_tier_limit)
+    dt_print(DT_DEBUG_ALWAYS,"[mipmap_cache] compressed tier fill %.2f/%.2f MB (%u blobs)",
+             cache->comp_tier_used / (1024.0 * 1024.0),
+             cache->comp_tier_limit / (1024.0 * 1024.0),
+             g_hash_table_size(cache->comp_tier));
   dt_print(DT_DEBUG_ALWAYS,"[mipmap_cache] float fill %"PRIu32"/%"PRIu32" slots (%.2f%%)",
            (uint32_t)cache->mip_f.cache.cost, (uint32_t)cache->mip_f.cache.cost_quota,
            100.0f * (float)cache->mip_f.cache.cost / (float)cache->mip_f.cache.cost_quota);
@@ -931,9 +1117,11 @@ void dt_mipmap_cache_get_with_caller(dt_mipmap_buffer_t *buf,
     buf->cache_entry = entry;
 
     gboolean mipmap_generated = FALSE;
+    const double trace_start = dt_trace_begin();
     if(dsc->flags & DT_MIPMAP_BUFFER_DSC_FLAG_GENERATE)
     {
       mipmap_generated = TRUE;
+      dt_alloc_tag_push("mipmap");
 
       __sync_fetch_and_add(&(_get_cache(cache, mip)->stats_fetches), 1);
       // dt_print(DT_DEBUG_ALWAYS, "[mipmap cache get] now initializing buffer for img %u mip %d!", imgid, mip);
@@ -1010,6 +1198,15 @@ void dt_mipmap_cache_get_with_caller(dt_mipmap_buffer_t *buf,
       }
       dsc->color_space = buf->color_space;
       dsc->flags &= ~DT_MIPMAP_BUFFER_DSC_FLAG_GENERATE;
+
+      // write through to the disk backend right away instead of only at
+      // eviction time, so another instance sharing the cache directory
+      // (say darktable-cli generate-cache next to the gui) sees the
+      // fresh thumbnail immediately
+      _mipmap_cache_write_ondisk_thumbnail(cache, entry);
+
+      dt_alloc_tag_pop();
+      dt_trace_end("cache", trace_start, "mipmap miss mip=%d ID=%d", mip, imgid);
     }
 
     // image cache is leaving the write lock in place in case the image has been newly allocated.
@@ -1240,6 +1437,7 @@ void dt_mipmap_cache_remove_at_size(const dt_imgid_t imgid,
   else
   {
     // ugly, but avoids alloc'ing thumb if it is not there.
+    _comp_tier_drop(cache, key);
     _mipmap_cache_unlink_ondisk_thumbnail((&_get_cache(cache, mip)->cache)->cleanup_data, imgid, mip);
   }
 }
@@ -1431,6 +1629,73 @@ static int _write_image(dt_imageio_module_data_t *data,
   return 0;
 }
 
+// serve a small mip from a resident larger one with a fixed-ratio box filter.
+// the 8-bit mips are gamma encoded, so the averaging is done in linear light
+// through small lookup tables; the plain row-wise loops auto-vectorize and the
+// whole pass is essentially memory-bound. returns FALSE when the ratio is not
+// a near-exact 2x or 4x, in which case the caller falls back to the generic
+// resampler.
+static gboolean _downscale_box_8(const uint8_t *const restrict in,
+                                 const int32_t iw,
+                                 const int32_t ih,
+                                 uint8_t *const restrict out,
+                                 const int32_t ow,
+                                 const int32_t oh,
+                                 uint32_t *width,
+                                 uint32_t *height)
+{
+  const float scale = fmaxf(1.0f, fmaxf(iw / (float)ow, ih / (float)oh));
+  // pick the smallest box that still fits the target, but only when it is
+  // close to the ideal scale so we don't shrink more than the generic path
+  int f = 0;
+  if(scale > 1.5f && scale <= 2.0f)
+    f = 2;
+  else if(scale > 3.0f && scale <= 4.0f)
+    f = 4;
+  if(f == 0 || iw < f || ih < f) return FALSE;
+
+  const uint32_t wd = *width = iw / f;
+  const uint32_t ht = *height = ih / f;
+
+  // sRGB <-> linear lookup tables; building them is negligible against the
+  // pixel work below
+  float to_linear[0x100];
+  for(int i = 0; i < 0x100; i++)
+  {
+    const float v = i / 255.0f;
+    to_linear[i] = (v <= 0.04045f) ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+  }
+  uint8_t to_srgb[0x1000];
+  for(int i = 0; i < 0x1000; i++)
+  {
+    const float v = i / (float)0xfff;
+    const float s = (v <= 0.0031308f) ? v * 12.92f : 1.055f * powf(v, 1.0f / 2.4f) - 0.055f;
+    to_srgb[i] = (uint8_t)roundf(CLAMP(s, 0.0f, 1.0f) * 255.0f);
+  }
+
+  const float norm = (float)0xfff / (f * f);
+  DT_OMP_FOR()
+  for(uint32_t j = 0; j < ht; j++)
+  {
+    uint8_t *const out2 = out + (size_t)4 * wd * j;
+    const uint8_t *const in2 = in + (size_t)4 * iw * j * f;
+    for(uint32_t i = 0; i < wd; i++)
+    {
+      float sum[3] = { 0.0f, 0.0f, 0.0f };
+      for(int jj = 0; jj < f; jj++)
+        for(int ii = 0; ii < f; ii++)
+        {
+          const uint8_t *const px = in2 + (size_t)4 * (jj * iw + i * f + ii);
+          for(int k = 0; k < 3; k++) sum[k] += to_linear[px[k]];
+        }
+      for(int k = 0; k < 3; k++)
+        out2[4 * i + k] = to_srgb[MIN((int)(sum[k] * norm + 0.5f), 0xfff)];
+      out2[4 * i + 3] = 0;
+    }
+  }
+  return TRUE;
+}
+
 static void _init_8(uint8_t *buf,
                     uint32_t *width,
                     uint32_t *height,
@@ -1484,6 +1749,9 @@ static void _init_8(uint8_t *buf,
       dt_imageio_jpeg_t jpg;
       if(!dt_imageio_jpeg_read_header(filename, &jpg))
       {
+        // decode at a reduced scale right away instead of decoding all
+        // pixels and throwing most of them away below
+        dt_imageio_jpeg_scale_to_fit(&jpg, wd, ht);
         uint8_t *tmp = dt_alloc_align_uint8((size_t)jpg.width * jpg.height * 4);
         *color_space = dt_imageio_jpeg_read_color_space(&jpg);
         if(!dt_imageio_jpeg_read(&jpg, tmp))
@@ -1501,7 +1769,8 @@ static void _init_8(uint8_t *buf,
     {
       uint8_t *tmp = 0;
       int32_t thumb_width, thumb_height;
-      res = dt_imageio_large_thumbnail(filename, &tmp, &thumb_width, &thumb_height, color_space);
+      res = dt_imageio_large_thumbnail(filename, &tmp, &thumb_width, &thumb_height,
+                                       color_space, wd, ht);
       if(!res)
       {
         // if the thumbnail is not large enough, we compute one
@@ -1543,8 +1812,11 @@ static void _init_8(uint8_t *buf,
                "[mipmap_cache] generate mip %d for ID=%d from level %d",
                size, imgid, k);
       *color_space = tmp.color_space;
-      // downsample
-      dt_iop_flip_and_zoom_8(tmp.buf, tmp.width, tmp.height, buf, wd, ht, ORIENTATION_NONE, width, height);
+      // downsample: fixed-ratio box filter when the resident mip is a
+      // near-exact 2x/4x of ours, generic resampler otherwise
+      if(!_downscale_box_8(tmp.buf, tmp.width, tmp.height, buf, wd, ht, width, height))
+        dt_iop_flip_and_zoom_8(tmp.buf, tmp.width, tmp.height, buf, wd, ht,
+                               ORIENTATION_NONE, width, height);
 
       dt_mipmap_cache_release(&tmp);
       res = FALSE;
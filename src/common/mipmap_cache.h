@@ -102,6 +102,14 @@ typedef struct dt_mipmap_cache_t
   dt_mipmap_cache_one_t mip_f;
   dt_mipmap_cache_one_t mip_full;
   char cachedir[PATH_MAX]; // cached sha1sum filename for faster access
+
+  // optional compressed in-memory tier between the uncompressed
+  // entries and the disk backend, holding evicted thumbnails as jpeg
+  // blobs. see the _comp_tier_* helpers in mipmap_cache.c
+  GHashTable *comp_tier;
+  size_t comp_tier_used;
+  size_t comp_tier_limit; // bytes, 0 when the tier is disabled
+  dt_pthread_mutex_t comp_tier_lock;
 } dt_mipmap_cache_t;
 
 // dynamic memory allocation interface for imageio backend: a write locked
@@ -24,6 +24,18 @@
 #include "common/file_location.h"
 #include "common/module.h"
 
+static void _preload_module(gpointer data, gpointer user_data)
+{
+  // open with the same flags as the real load in module_api.h so the
+  // second open only bumps the refcount on the cached handle. the
+  // handle is deliberately never closed: modules stay loaded for the
+  // lifetime of the process anyway, and closing it here would unmap
+  // the library again before the serial pass gets to it.
+  gchar *libname = g_module_build_path((const char *)user_data, (const char *)data);
+  g_module_open(libname, G_MODULE_BIND_LAZY | G_MODULE_BIND_LOCAL);
+  g_free(libname);
+}
+
 GList *dt_module_load_modules(const char *subdir,
                               const size_t module_size,
                               int (*load_module_so)(void *module,
@@ -41,6 +53,14 @@ GList *dt_module_load_modules(const char *subdir,
   if(!dir) return NULL;
   const int name_offset = strlen(SHARED_MODULE_PREFIX),
             name_end = strlen(SHARED_MODULE_PREFIX) + strlen(SHARED_MODULE_SUFFIX);
+
+  // collect the plugin names first so the libraries can be mapped and
+  // relocated on all cores. dlopen dominates the cost of loading the
+  // ~90 iop modules, and it caches its handles, so after this the
+  // per-module open in load_module_so is a cheap lookup. the load and
+  // init callbacks themselves are not thread safe (opencl kernel
+  // registration, preset upgrades, gui actions) and stay serial below.
+  GList *plugin_names = NULL;
   while((dir_name = g_dir_read_name(dir)))
   {
     // get lib*.so
@@ -48,12 +68,28 @@ GList *dt_module_load_modules(const char *subdir,
       continue;
     if(!g_str_has_suffix(dir_name, SHARED_MODULE_SUFFIX))
       continue;
-    char *plugin_name = g_strndup(dir_name + name_offset, strlen(dir_name) - name_end);
+    plugin_names = g_list_prepend(plugin_names,
+                                  g_strndup(dir_name + name_offset,
+                                            strlen(dir_name) - name_end));
+  }
+  g_dir_close(dir);
+  plugin_names = g_list_reverse(plugin_names);
+
+  GThreadPool *pool = g_thread_pool_new(_preload_module, plugindir, -1, FALSE, NULL);
+  if(pool)
+  {
+    for(GList *iter = plugin_names; iter; iter = g_list_next(iter))
+      g_thread_pool_push(pool, iter->data, NULL);
+    g_thread_pool_free(pool, FALSE, TRUE); // wait for all preloads to finish
+  }
+
+  for(GList *iter = plugin_names; iter; iter = g_list_next(iter))
+  {
+    const char *plugin_name = iter->data;
     void *module = calloc(1, module_size);
     gchar *libname = g_module_build_path(plugindir, plugin_name);
     const int res = load_module_so(module, libname, plugin_name);
     g_free(libname);
-    g_free(plugin_name);
     if(res)
     {
       free(module);
@@ -64,7 +100,7 @@ GList *dt_module_load_modules(const char *subdir,
     if(init_module)
       init_module(module);
   }
-  g_dir_close(dir);
+  g_list_free_full(plugin_names, g_free);
 
   if(sort_modules)
     plugin_list = g_list_sort(plugin_list, sort_modules);
@@ -0,0 +1,176 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2026 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/module_stats.h"
+#include "control/conf.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// log2-spaced wall time buckets; bucket 0 holds everything below
+// 2^-5 ms so the range spans ~0.03 ms to ~4.5 min
+#define DT_MODULE_STATS_BUCKETS 24
+#define DT_MODULE_STATS_MIN_LOG2 (-5)
+#define DT_MODULE_STATS_VERSION 1
+
+typedef struct dt_module_stats_t
+{
+  uint64_t count;       // recorded executions
+  uint64_t gpu;         // of which processed via OpenCL
+  uint64_t tiled;       // of which processed with tiling
+  double total_wall;    // seconds
+  uint64_t hist[DT_MODULE_STATS_BUCKETS];
+} dt_module_stats_t;
+
+static GHashTable *_stats = NULL;
+static GMutex _stats_mutex;
+
+static int _bucket(const double wall)
+{
+  const double ms = wall * 1000.0;
+  if(ms <= 0.0) return 0;
+  const int b = (int)floor(log2(ms)) - DT_MODULE_STATS_MIN_LOG2;
+  return CLAMP(b, 0, DT_MODULE_STATS_BUCKETS - 1);
+}
+
+// upper bound of a bucket in milliseconds
+static double _bucket_ms(const int b)
+{
+  return exp2((double)(b + 1 + DT_MODULE_STATS_MIN_LOG2));
+}
+
+// parse the history of earlier sessions, ignoring unknown versions
+static void _parse(dt_module_stats_t *s, const char *str)
+{
+  if(!str || *str == '\0') return;
+
+  int version = 0;
+  int off = 0;
+  if(sscanf(str, "%d;%" PRIu64 ";%" PRIu64 ";%" PRIu64 ";%lf;%n",
+            &version, &s->count, &s->gpu, &s->tiled, &s->total_wall, &off) != 5
+     || version != DT_MODULE_STATS_VERSION)
+  {
+    memset(s, 0, sizeof(*s));
+    return;
+  }
+
+  const char *p = str + off;
+  for(int b = 0; b < DT_MODULE_STATS_BUCKETS && p; b++)
+  {
+    s->hist[b] = g_ascii_strtoull(p, NULL, 10);
+    p = strchr(p, ',');
+    if(p) p++;
+  }
+}
+
+static gchar *_serialize(const dt_module_stats_t *s)
+{
+  GString *str = g_string_new(NULL);
+  g_string_append_printf(str, "%d;%" PRIu64 ";%" PRIu64 ";%" PRIu64 ";%f;",
+                         DT_MODULE_STATS_VERSION, s->count, s->gpu, s->tiled, s->total_wall);
+  for(int b = 0; b < DT_MODULE_STATS_BUCKETS; b++)
+    g_string_append_printf(str, "%s%" PRIu64, b ? "," : "", s->hist[b]);
+  return g_string_free(str, FALSE);
+}
+
+// estimated percentile in milliseconds, the upper bound of the bucket
+// holding the requested fraction of samples
+static double _percentile(const dt_module_stats_t *s, const double frac)
+{
+  const uint64_t wanted = (uint64_t)(frac * (double)s->count);
+  uint64_t seen = 0;
+  for(int b = 0; b < DT_MODULE_STATS_BUCKETS; b++)
+  {
+    seen += s->hist[b];
+    if(seen > wanted) return _bucket_ms(b);
+  }
+  return _bucket_ms(DT_MODULE_STATS_BUCKETS - 1);
+}
+
+void dt_module_stats_record(const char *op,
+                           const double wall,
+                           const gboolean gpu,
+                           const gboolean tiled)
+{
+  g_mutex_lock(&_stats_mutex);
+
+  if(!_stats)
+    _stats = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+  dt_module_stats_t *s = g_hash_table_lookup(_stats, op);
+  if(!s)
+  {
+    s = g_malloc0(sizeof(dt_module_stats_t));
+    // merge in what earlier sessions recorded for this module
+    gchar *key = g_strdup_printf("module_stats/%s", op);
+    if(dt_conf_key_exists(key))
+      _parse(s, dt_conf_get_string_const(key));
+    g_free(key);
+    g_hash_table_insert(_stats, g_strdup(op), s);
+  }
+
+  s->count++;
+  if(gpu) s->gpu++;
+  if(tiled) s->tiled++;
+  s->total_wall += wall;
+  s->hist[_bucket(wall)]++;
+
+  g_mutex_unlock(&_stats_mutex);
+}
+
+void dt_module_stats_cleanup(void)
+{
+  g_mutex_lock(&_stats_mutex);
+
+  if(_stats)
+  {
+    GHashTableIter iter;
+    gpointer op, value;
+    g_hash_table_iter_init(&iter, _stats);
+    while(g_hash_table_iter_next(&iter, &op, &value))
+    {
+      const dt_module_stats_t *s = value;
+      gchar *key = g_strdup_printf("module_stats/%s", (const char *)op);
+      gchar *serialized = _serialize(s);
+      dt_conf_set_string(key, serialized);
+      g_free(serialized);
+      g_free(key);
+
+      dt_print(DT_DEBUG_PERF,
+               "[module_stats] %-20s n=%-8" PRIu64 " mean=%8.2fms"
+               " p50<%8.2fms p90<%8.2fms p99<%8.2fms gpu=%3.0f%% tiled=%3.0f%%",
+               (const char *)op, s->count,
+               1000.0 * s->total_wall / (double)MAX(s->count, 1),
+               _percentile(s, 0.50), _percentile(s, 0.90), _percentile(s, 0.99),
+               100.0 * (double)s->gpu / (double)MAX(s->count, 1),
+               100.0 * (double)s->tiled / (double)MAX(s->count, 1));
+    }
+
+    g_hash_table_destroy(_stats);
+    _stats = NULL;
+  }
+
+  g_mutex_unlock(&_stats_mutex);
+}
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
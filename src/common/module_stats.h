@@ -0,0 +1,50 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2026 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/darktable.h"
+
+G_BEGIN_DECLS
+
+/* per-module performance counters persisted across sessions.
+
+   every pixelpipe module execution reports its wall time and path
+   choices here.  the samples are accumulated into log2-spaced
+   histograms per module, merged with the history of earlier sessions
+   kept in the 'module_stats/<op>' conf keys, so a regression of a
+   single module after an upgrade shows up in the recorded percentiles
+   without having to reproduce it under -d perf.  a summary with
+   estimated p50/p90/p99 is printed at shutdown when -d perf is set. */
+
+// record one module execution
+void dt_module_stats_record(const char *op,
+                            const double wall,
+                            const gboolean gpu,
+                            const gboolean tiled);
+
+// merge the counters back into the conf and optionally print the summary
+void dt_module_stats_cleanup(void);
+
+G_END_DECLS
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
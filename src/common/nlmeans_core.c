@@ -355,7 +355,10 @@ void nlmeans_denoise(
   float *const restrict scratch_buf = dt_alloc_perthread_float(scratch_size, &padded_scratch_size);
   const int chk_height = compute_slice_height(roi_out->height);
   const int chk_width = compute_slice_width(roi_out->width);
-  DT_OMP_FOR(collapse(2))
+  // the cost of a chunk varies considerably with image content, as the patch loop clips shifted patches
+  // against the image borders and skips entire rows where the shifted patch falls outside the image; use
+  // dynamic scheduling so that threads which draw cheap chunks steal remaining work instead of idling
+  DT_OMP_PRAGMA(parallel for default(firstprivate) schedule(dynamic) collapse(2))
   for(int chunk_top = 0 ; chunk_top < roi_out->height; chunk_top += chk_height)
   {
     for(int chunk_left = 0; chunk_left < roi_out->width; chunk_left += chk_width)
@@ -27,35 +27,53 @@ const dt_noiseprofile_t dt_noiseprofile_generic = {N_("generic poissonian"), "",
 
 static gboolean _noiseprofile_verify(JsonParser *parser);
 
-JsonParser *dt_noiseprofile_init(const char *alternative)
-{
-  GError *error = NULL;
-  char filename[PATH_MAX] = { 0 };
+// remembered in dt_noiseprofile_init, parsed on first use
+static char _noiseprofile_file[PATH_MAX] = { 0 };
+static gboolean _noiseprofile_loaded = FALSE;
+static GMutex _noiseprofile_lock;
 
+void dt_noiseprofile_init(const char *alternative)
+{
   if(alternative == NULL)
   {
     // TODO: shall we look for profiles in the user config dir?
     char datadir[PATH_MAX] = { 0 };
     dt_loc_get_datadir(datadir, sizeof(datadir));
-    snprintf(filename, sizeof(filename), "%s/%s", datadir, "noiseprofiles.json");
+    snprintf(_noiseprofile_file, sizeof(_noiseprofile_file), "%s/%s", datadir, "noiseprofiles.json");
   }
   else
-    g_strlcpy(filename, alternative, sizeof(filename));
+    g_strlcpy(_noiseprofile_file, alternative, sizeof(_noiseprofile_file));
+}
+
+// parse and verify the noiseprofile file the first time someone asks for
+// profiles. most sessions never touch the denoise modules, so deferring
+// the json work keeps it off the startup path entirely.
+static JsonParser *_noiseprofile_get_parser(void)
+{
+  g_mutex_lock(&_noiseprofile_lock);
+  if(_noiseprofile_loaded)
+  {
+    g_mutex_unlock(&_noiseprofile_lock);
+    return darktable.noiseprofile_parser;
+  }
+  _noiseprofile_loaded = TRUE;
+
+  GError *error = NULL;
+  const char *filename = _noiseprofile_file;
 
   if(!g_file_test(filename, G_FILE_TEST_EXISTS))
   {
     dt_print(DT_DEBUG_CONTROL, "[noiseprofile] can't load noiseprofiles from `%s'", filename);
-    return NULL;
+    goto end;
   }
 
-  // TODO: shall we cache the content? for now this looks fast enough(TM)
   JsonParser *parser = json_parser_new();
   if(!json_parser_load_from_file(parser, filename, &error))
   {
     dt_print(DT_DEBUG_ALWAYS, "[noiseprofile] error: parsing json from `%s' failed\n%s", filename, error->message);
     g_error_free(error);
     g_object_unref(parser);
-    return NULL;
+    goto end;
   }
 
   // run over the file once to verify that it is sane
@@ -64,10 +82,14 @@ JsonParser *dt_noiseprofile_init(const char *alternative)
     dt_control_log(_("noiseprofile file `%s' is not valid"), filename);
     dt_print(DT_DEBUG_ALWAYS, "[noiseprofile] error: `%s' is not a valid noiseprofile file. run with -d control for details", filename);
     g_object_unref(parser);
-    return NULL;
+    goto end;
   }
 
-  return parser;
+  darktable.noiseprofile_parser = parser;
+
+end:
+  g_mutex_unlock(&_noiseprofile_lock);
+  return darktable.noiseprofile_parser;
 }
 
 int is_member(gchar** names, char* name)
@@ -226,7 +248,7 @@ end:
 
 GList *dt_noiseprofile_get_matching(const dt_image_t *cimg)
 {
-  JsonParser *parser = darktable.noiseprofile_parser;
+  JsonParser *parser = _noiseprofile_get_parser();
   JsonReader *reader = NULL;
   GList *result = NULL;
 
@@ -35,8 +35,8 @@ dt_noiseprofile_t;
 
 extern const dt_noiseprofile_t dt_noiseprofile_generic;
 
-/** read the noiseprofile file once on startup (kind of)*/
-JsonParser *dt_noiseprofile_init(const char *alternative);
+/** remember where the noiseprofile file lives; it is parsed lazily on first use */
+void dt_noiseprofile_init(const char *alternative);
 
 /*
  * returns the noiseprofiles matching the image's exif data.
@@ -68,6 +68,8 @@ static gboolean _opencl_build_program(const int dev,
                                       char *md5sum,
                                       const gboolean loaded_cached);
 
+static void _opencl_staging_free(const int devid);
+
 static char *_ascii_str_canonical(const char *in, char *out, int maxlen);
 
 static char *_strsep(char **stringp, const char *delim);
@@ -446,6 +448,64 @@ gboolean dt_opencl_read_device_config(const int devid)
   return !existing_device || !safety_ok;
 }
 
+// one entry per program from programs.conf, parsed up front so the
+// compile phase can be spread over several threads
+typedef struct dt_opencl_program_build_t
+{
+  int prog;
+  gchar *programname;
+  gchar *filename;
+  gchar *binname;
+} dt_opencl_program_build_t;
+
+typedef struct dt_opencl_build_pool_t
+{
+  int dev;
+  dt_opencl_program_build_t *entries;
+  int count;
+  int next;          // next unclaimed entry
+  gboolean failed;
+  const char *cachedir;
+  char **includemd5;
+  dt_pthread_mutex_t lock;
+} dt_opencl_build_pool_t;
+
+static void *_opencl_build_worker(void *data)
+{
+  dt_opencl_build_pool_t *pool = data;
+
+  while(TRUE)
+  {
+    dt_pthread_mutex_lock(&pool->lock);
+    if(pool->next >= pool->count || pool->failed)
+    {
+      dt_pthread_mutex_unlock(&pool->lock);
+      break;
+    }
+    dt_opencl_program_build_t *entry = &pool->entries[pool->next++];
+    dt_pthread_mutex_unlock(&pool->lock);
+
+    dt_print(DT_DEBUG_OPENCL | DT_DEBUG_VERBOSE,
+             "[dt_opencl_device_init] testing program `%s' ..", entry->programname);
+    gboolean loaded_cached;
+    char md5sum[33];
+    if(_opencl_load_program(pool->dev, entry->prog, entry->programname,
+                            entry->filename, entry->binname, pool->cachedir,
+                            md5sum, pool->includemd5, &loaded_cached)
+       && _opencl_build_program(pool->dev, entry->prog, entry->binname,
+                                pool->cachedir, md5sum, loaded_cached))
+    {
+      dt_print(DT_DEBUG_OPENCL,
+               "[dt_opencl_device_init] failed to compile program `%s'!",
+               entry->programname);
+      dt_pthread_mutex_lock(&pool->lock);
+      pool->failed = TRUE;
+      dt_pthread_mutex_unlock(&pool->lock);
+    }
+  }
+  return NULL;
+}
+
 // returns 0 if all ok or an error if we failed to init this device
 static gboolean _opencl_device_init(dt_opencl_t *cl,
                                     const int dev,
@@ -457,10 +517,15 @@ static gboolean _opencl_device_init(dt_opencl_t *cl,
 
   memset(cl->dev[dev].program, 0x0, sizeof(cl_program) * DT_OPENCL_MAX_PROGRAMS);
   memset(cl->dev[dev].program_used, 0x0, sizeof(int) * DT_OPENCL_MAX_PROGRAMS);
+  memset(cl->dev[dev].staging, 0x0, sizeof(cl->dev[dev].staging));
   memset(cl->dev[dev].kernel, 0x0, sizeof(cl_kernel) * DT_OPENCL_MAX_KERNELS);
   memset(cl->dev[dev].kernel_used, 0x0, sizeof(int) * DT_OPENCL_MAX_KERNELS);
+  memset(cl->dev[dev].kernel_wgsize, 0x0, sizeof(cl->dev[dev].kernel_wgsize));
+  memset(cl->dev[dev].kernel_preferred_multiple, 0x0,
+         sizeof(cl->dev[dev].kernel_preferred_multiple));
   cl->dev[dev].eventlist = NULL;
   cl->dev[dev].eventtags = NULL;
+  cl->dev[dev].tracefile = NULL;
   cl->dev[dev].numevents = 0;
   cl->dev[dev].eventsconsolidated = 0;
   cl->dev[dev].maxevents = 0;
@@ -883,6 +948,7 @@ static gboolean _opencl_device_init(dt_opencl_t *cl,
   }
 
   dt_pthread_mutex_init(&cl->dev[dev].lock, NULL);
+  dt_pthread_mutex_init(&cl->dev[dev].staging_lock, NULL);
 
   cl->dev[dev].context = (cl->dlocl->symbols->dt_clCreateContext)
     (0, 1, &devid, NULL, NULL, &err);
@@ -896,7 +962,7 @@ static gboolean _opencl_device_init(dt_opencl_t *cl,
   // create a command queue for first device the context reported
   cl->dev[dev].cmd_queue = (cl->dlocl->symbols->dt_clCreateCommandQueue)(
       cl->dev[dev].context, devid,
-      (darktable.unmuted & DT_DEBUG_PERF)
+      ((darktable.unmuted & DT_DEBUG_PERF) || dt_conf_get_bool("opencl_event_trace"))
       ? CL_QUEUE_PROFILING_ENABLE
       : 0,
       &err);
@@ -1006,12 +1072,20 @@ static gboolean _opencl_device_init(dt_opencl_t *cl,
   }
 
   // now load all darktable cl kernels.
-  // TODO: compile as a job?
+  // with a cold binary cache (e.g. after a driver update) compiling is
+  // by far the dominant part of OpenCL startup, and clBuildProgram is
+  // reentrant per context, so parse programs.conf first and then spread
+  // the compiles over a small worker pool; the actual kernels are
+  // created lazily from the built programs on first use
   double tstart = dt_get_debug_wtime();
   FILE *f = g_fopen(filename, "rb");
   if(f)
   {
-    while(!feof(f))
+    dt_opencl_program_build_t entries[DT_OPENCL_MAX_PROGRAMS];
+    int count = 0;
+    gboolean seen[DT_OPENCL_MAX_PROGRAMS] = { FALSE };
+
+    while(!feof(f) && count < DT_OPENCL_MAX_PROGRAMS)
     {
       int prog = -1;
       gchar *confline_pattern =
@@ -1054,34 +1128,79 @@ static gboolean _opencl_device_init(dt_opencl_t *cl,
         dt_print(DT_DEBUG_OPENCL,
                  "[dt_opencl_device_init] malformed entry in programs.conf `%s';"
                  " ignoring it!", confentry);
+        g_strfreev(tokens);
         continue;
       }
 
-      snprintf(filename, PATH_MAX * sizeof(char),
-               "%s" G_DIR_SEPARATOR_S "%s", kerneldir, programname);
-      snprintf(binname, PATH_MAX * sizeof(char),
-               "%s" G_DIR_SEPARATOR_S "%s.bin", cachedir, programname);
-      dt_print(DT_DEBUG_OPENCL | DT_DEBUG_VERBOSE,
-               "[dt_opencl_device_init] testing program `%s' ..", programname);
-      gboolean loaded_cached;
-      char md5sum[33];
-      if(_opencl_load_program(dev, prog, programname, filename, binname, cachedir,
-                              md5sum, includemd5, &loaded_cached)
-         && _opencl_build_program(dev, prog, binname, cachedir, md5sum, loaded_cached))
+      if(prog < DT_OPENCL_MAX_PROGRAMS && seen[prog])
       {
         dt_print(DT_DEBUG_OPENCL,
-                 "[dt_opencl_device_init] failed to compile program `%s'!",
-                 programname);
-        fclose(f);
+                 "[dt_opencl_device_init] program number `%d' used twice"
+                 " in programs.conf; ignoring `%s'!", prog, programname);
         g_strfreev(tokens);
-        res = TRUE;
-        goto end;
+        continue;
       }
+      if(prog < DT_OPENCL_MAX_PROGRAMS) seen[prog] = TRUE;
+
+      entries[count].prog = prog;
+      entries[count].programname = g_strdup(programname);
+      entries[count].filename = g_strdup_printf
+        ("%s" G_DIR_SEPARATOR_S "%s", kerneldir, programname);
+      entries[count].binname = g_strdup_printf
+        ("%s" G_DIR_SEPARATOR_S "%s.bin", cachedir, programname);
+      count++;
 
       g_strfreev(tokens);
     }
-
     fclose(f);
+
+    // work-around to fix a bug in some AMD OpenCL compilers, which
+    // would fail parsing certain numerical constants if locale is
+    // different from "C".  the locale is process-wide, so we save it,
+    // set "C" around the whole build phase and restore it afterwards
+    char *locale = strdup(setlocale(LC_ALL, NULL));
+    if(dt_conf_key_exists("opencl_force_c_locale"))
+      setlocale(LC_ALL, "C");
+
+    dt_opencl_build_pool_t pool = { .dev = dev,
+                                    .entries = entries,
+                                    .count = count,
+                                    .next = 0,
+                                    .failed = FALSE,
+                                    .cachedir = cachedir,
+                                    .includemd5 = includemd5 };
+    dt_pthread_mutex_init(&pool.lock, NULL);
+
+    const int num_workers = MIN(count, MIN(8, (int)dt_get_num_procs()));
+    pthread_t threads[8];
+    const int num_threads = num_workers - 1;
+    for(int i = 0; i < num_threads; i++)
+      dt_pthread_create(&threads[i], _opencl_build_worker, &pool);
+    _opencl_build_worker(&pool);
+    for(int i = 0; i < num_threads; i++)
+      pthread_join(threads[i], NULL);
+
+    dt_pthread_mutex_destroy(&pool.lock);
+
+    if(locale)
+    {
+      setlocale(LC_ALL, locale);
+      free(locale);
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+      g_free(entries[i].programname);
+      g_free(entries[i].filename);
+      g_free(entries[i].binname);
+    }
+
+    if(pool.failed)
+    {
+      res = TRUE;
+      goto end;
+    }
+
     dt_print_nts(DT_DEBUG_OPENCL,
                  "   KERNEL LOADING TIME:       %2.4lf sec\n", dt_get_lap_time(&tstart));
   }
@@ -1535,6 +1654,7 @@ finally:
           (cl->dlocl->symbols->dt_clReleaseProgram)(cl->dev[i].program[k]);
       }
 
+      _opencl_staging_free(i);
       (cl->dlocl->symbols->dt_clReleaseCommandQueue)(cl->dev[i].cmd_queue);
       (cl->dlocl->symbols->dt_clReleaseContext)(cl->dev[i].context);
 
@@ -1584,6 +1704,7 @@ void dt_opencl_cleanup(dt_opencl_t *cl)
       for(int k = 0; k < DT_OPENCL_MAX_PROGRAMS; k++)
         if(cl->dev[i].program_used[k])
           (cl->dlocl->symbols->dt_clReleaseProgram)(cl->dev[i].program[k]);
+      _opencl_staging_free(i);
       (cl->dlocl->symbols->dt_clReleaseCommandQueue)(cl->dev[i].cmd_queue);
       (cl->dlocl->symbols->dt_clReleaseContext)(cl->dev[i].context);
 
@@ -1631,6 +1752,8 @@ void dt_opencl_cleanup(dt_opencl_t *cl)
 
         free(cl->dev[i].eventlist);
         free(cl->dev[i].eventtags);
+
+        if(cl->dev[i].tracefile) fclose(cl->dev[i].tracefile);
       }
 
       free((void *)(cl->dev[i].fullname));
@@ -1708,8 +1831,16 @@ gboolean dt_opencl_finish_sync_pipe(const int devid,
 
   if(!asyncmode || exporting)
     return dt_opencl_finish(devid);
-  else
-    return TRUE;
+
+  // in async mode we don't wait for the module's kernels, but we do
+  // hand the accumulated work to the device: some drivers defer
+  // submission until the next blocking call, which would keep the GPU
+  // idle while the host is still building the downstream modules.
+  // dependencies between modules are safe either way since all work
+  // goes through the device's single in-order queue; the final buffer
+  // read is the only remaining synchronization point.
+  (cl->dlocl->symbols->dt_clFlush)(cl->dev[devid].cmd_queue);
+  return TRUE;
 }
 
 static int _take_from_list(int *list,
@@ -2387,25 +2518,16 @@ static gboolean _opencl_build_program(const int dev,
 {
   if(prog < 0 || prog > DT_OPENCL_MAX_PROGRAMS) return TRUE;
 
-  // work-around to fix a bug in some AMD OpenCL compilers, which
-  // would fail parsing certain numerical constants if locale is
-  // different from "C".  we save the current locale, set locale to
-  // "C", and restore the previous setting after OpenCL is initialized
-  char *locale = strdup(setlocale(LC_ALL, NULL));
-  if(dt_conf_key_exists("opencl_force_c_locale"))
-    setlocale(LC_ALL, "C");
+  // note: the locale work-around for buggy AMD OpenCL compilers is
+  // applied by the caller around the whole build phase; the locale is
+  // process-wide, so switching it here would race with the other
+  // build workers
 
   dt_opencl_t *cl = darktable.opencl;
   cl_program program = cl->dev[dev].program[prog];
   cl_int err = (cl->dlocl->symbols->dt_clBuildProgram)
     (program, 1, &(cl->dev[dev].devid), cl->dev[dev].options, NULL, NULL);
 
-  if(locale)
-  {
-    setlocale(LC_ALL, locale);
-    free(locale);
-  }
-
   if(err != CL_SUCCESS)
     dt_print(DT_DEBUG_OPENCL,
              "[opencl_build_program] could not build program: %s", cl_errstr(err));
@@ -2509,13 +2631,12 @@ static gboolean _opencl_build_program(const int dev,
     {
       if(cl->dev[dev].devid == devices[i])
       {
-        char dup[PATH_MAX] = { 0 };
-        g_strlcpy(dup, binname, sizeof(dup));
-        char *bname = basename(dup);
-
         // save opencl compiled binary as md5sum-named file
         char filename[PATH_MAX] = { 0 };
 #if defined(_WIN32)
+        char dup[PATH_MAX] = { 0 };
+        g_strlcpy(dup, binname, sizeof(dup));
+        char *bname = basename(dup);
         snprintf(filename, sizeof(filename), "%s" G_DIR_SEPARATOR_S "%s.%s",
                  cachedir, bname, md5sum);
 #else
@@ -2530,11 +2651,9 @@ static gboolean _opencl_build_program(const int dev,
 
 #if !defined(_WIN32)
         // create link (e.g. basic.cl.bin -> f1430102c53867c162bb60af6c163328)
-        char cwd[PATH_MAX] = { 0 };
-        if(!getcwd(cwd, sizeof(cwd))) goto ret;
-        if(chdir(cachedir) != 0) goto ret;
-        if(symlink(md5sum, bname) != 0) goto ret;
-        if(chdir(cwd) != 0) goto ret;
+        // without going through chdir(), which would change the
+        // process-wide working directory under the other build workers
+        if(symlink(md5sum, binname) != 0) goto ret;
 #endif //!defined(_WIN32)
       }
     }
@@ -2669,11 +2788,44 @@ int dt_opencl_get_kernel_work_group_size(const int dev,
   if(!_check_kernel(dev, kernel)) return -1;
 
   dt_opencl_t *cl = darktable.opencl;
-  return (cl->dlocl->symbols->dt_clGetKernelWorkGroupInfo)(cl->dev[dev].kernel[kernel],
+  if(cl->dev[dev].kernel_wgsize[kernel])
+  {
+    *kernelworkgroupsize = cl->dev[dev].kernel_wgsize[kernel];
+    return CL_SUCCESS;
+  }
+
+  const cl_int err = (cl->dlocl->symbols->dt_clGetKernelWorkGroupInfo)(cl->dev[dev].kernel[kernel],
                                                            cl->dev[dev].devid,
                                                            CL_KERNEL_WORK_GROUP_SIZE,
                                                            sizeof(size_t),
                                                            kernelworkgroupsize, NULL);
+  if(err == CL_SUCCESS)
+    cl->dev[dev].kernel_wgsize[kernel] = *kernelworkgroupsize;
+  return err;
+}
+
+/** return preferred workgroup size multiple for a specific kernel */
+int dt_opencl_get_kernel_preferred_multiple(const int dev,
+                                            const int kernel,
+                                            size_t *multiple)
+{
+  if(!_check_kernel(dev, kernel)) return -1;
+
+  dt_opencl_t *cl = darktable.opencl;
+  if(cl->dev[dev].kernel_preferred_multiple[kernel])
+  {
+    *multiple = cl->dev[dev].kernel_preferred_multiple[kernel];
+    return CL_SUCCESS;
+  }
+
+  const cl_int err = (cl->dlocl->symbols->dt_clGetKernelWorkGroupInfo)(cl->dev[dev].kernel[kernel],
+                                                           cl->dev[dev].devid,
+                                                           CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                                                           sizeof(size_t),
+                                                           multiple, NULL);
+  if(err == CL_SUCCESS)
+    cl->dev[dev].kernel_preferred_multiple[kernel] = *multiple;
+  return err;
 }
 
 cl_int _opencl_set_kernel_arg(const int dev,
@@ -2828,6 +2980,188 @@ int dt_opencl_enqueue_kernel_1d_args_internal(const int dev,
   return dt_opencl_enqueue_kernel_ndim_with_local(dev, kernel, sizes, NULL, 1);
 }
 
+// get a free pinned staging buffer of at least `size' bytes from the
+// device pool, or NULL if pinned transfers are disabled for the
+// device, the size is beyond the headroom budget or all slots are in
+// flight; the caller must hand the pointer back via
+// _opencl_release_staging()
+static void *_opencl_get_staging(const int devid,
+                                 const size_t size)
+{
+  dt_opencl_device_t *cldev = &darktable.opencl->dev[devid];
+
+  if(!dt_opencl_use_pinned_memory(devid) || cldev->pinned_error)
+    return NULL;
+
+  // on unified memory devices there is no PCIe transfer to hide,
+  // staging would only add a memcpy; such devices take the zero-copy
+  // mapping path instead
+  if(cldev->unified_memory)
+    return NULL;
+
+  // the pool budget follows the configured device headroom so pinned
+  // staging never locks more host memory than the user already set
+  // aside for the device
+  const size_t limit = (size_t)cldev->headroom * 1024lu * 1024lu
+                       / DT_OPENCL_STAGING_BUFFERS;
+  if(size == 0 || size > limit)
+    return NULL;
+
+  void *ptr = NULL;
+  dt_pthread_mutex_lock(&cldev->staging_lock);
+
+  // prefer a free slot that is already large enough, otherwise recycle
+  // the smallest free one
+  dt_opencl_staging_t *slot = NULL;
+  for(int n = 0; n < DT_OPENCL_STAGING_BUFFERS; n++)
+  {
+    dt_opencl_staging_t *s = &cldev->staging[n];
+    if(s->busy) continue;
+    if(s->size >= size)
+    {
+      slot = s;
+      break;
+    }
+    if(!slot || s->size < slot->size) slot = s;
+  }
+
+  if(slot && slot->size < size)
+  {
+    if(slot->buf)
+    {
+      dt_opencl_unmap_mem_object(devid, slot->buf, slot->ptr);
+      dt_opencl_release_mem_object(slot->buf);
+      slot->buf = NULL;
+      slot->ptr = NULL;
+      slot->size = 0;
+    }
+    cl_mem buf = dt_opencl_alloc_device_buffer_with_flags
+      (devid, size, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR);
+    if(buf)
+    {
+      void *mapped = dt_opencl_map_buffer(devid, buf, CL_TRUE,
+                                          CL_MAP_READ | CL_MAP_WRITE, 0, size);
+      if(mapped)
+      {
+        slot->buf = buf;
+        slot->ptr = mapped;
+        slot->size = size;
+      }
+      else
+        dt_opencl_release_mem_object(buf);
+    }
+    if(!slot->buf)
+    {
+      // as in tiling: report the problem and don't insist on pinned
+      // transfers for this device any further
+      dt_print(DT_DEBUG_OPENCL,
+               "[_opencl_get_staging] could not alloc/map pinned staging buffer"
+               " of %zu bytes on device '%s' id=%d",
+               size, cldev->fullname, devid);
+      cldev->pinned_error = TRUE;
+      slot = NULL;
+    }
+  }
+
+  if(slot)
+  {
+    slot->busy = TRUE;
+    ptr = slot->ptr;
+  }
+  dt_pthread_mutex_unlock(&cldev->staging_lock);
+  return ptr;
+}
+
+static void _opencl_release_staging(const int devid,
+                                    const void *ptr)
+{
+  dt_opencl_device_t *cldev = &darktable.opencl->dev[devid];
+  dt_pthread_mutex_lock(&cldev->staging_lock);
+  for(int n = 0; n < DT_OPENCL_STAGING_BUFFERS; n++)
+    if(cldev->staging[n].ptr == ptr)
+    {
+      cldev->staging[n].busy = FALSE;
+      break;
+    }
+  dt_pthread_mutex_unlock(&cldev->staging_lock);
+}
+
+static void _opencl_staging_free(const int devid)
+{
+  dt_opencl_device_t *cldev = &darktable.opencl->dev[devid];
+  for(int n = 0; n < DT_OPENCL_STAGING_BUFFERS; n++)
+  {
+    dt_opencl_staging_t *s = &cldev->staging[n];
+    if(s->buf)
+    {
+      dt_opencl_unmap_mem_object(devid, s->buf, s->ptr);
+      dt_opencl_release_mem_object(s->buf);
+    }
+    s->buf = NULL;
+    s->ptr = NULL;
+    s->size = 0;
+    s->busy = FALSE;
+  }
+  dt_pthread_mutex_destroy(&cldev->staging_lock);
+}
+
+// move pixels between host memory and a device image via
+// clEnqueueMapImage. on devices sharing physical memory with the host
+// the map is zero-copy, so this leaves a single memcpy where the
+// read/write image path makes the driver stage the transfer through an
+// internal bounce buffer
+static cl_int _opencl_copy_mapped_image(const int devid,
+                                        void *host,
+                                        void *device,
+                                        const size_t *origin,
+                                        const size_t *region,
+                                        const size_t rowpitch,
+                                        const gboolean to_device)
+{
+  dt_opencl_t *cl = darktable.opencl;
+  cl_int err = CL_SUCCESS;
+  size_t mappitch = 0;
+  size_t slicepitch = 0;
+
+  cl_event *eventp = _opencl_events_get_slot
+    (devid, to_device ? "[Map Image (from host to device)]"
+                      : "[Map Image (from device to host)]");
+  void *mapped = (cl->dlocl->symbols->dt_clEnqueueMapImage)
+    (cl->dev[devid].cmd_queue, device, CL_TRUE,
+     to_device ? CL_MAP_WRITE : CL_MAP_READ,
+     origin, region, &mappitch, &slicepitch, 0, NULL, eventp, &err);
+
+  if(err != CL_SUCCESS || mapped == NULL)
+  {
+    dt_print(DT_DEBUG_OPENCL,
+             "[opencl copy mapped image] could not map image on device '%s' id=%d: %s",
+             cl->dev[devid].fullname, devid, cl_errstr(err));
+    _check_clmem_err(devid, err);
+    return (err != CL_SUCCESS) ? err : DT_OPENCL_DEFAULT_ERROR;
+  }
+
+  if(mappitch == rowpitch)
+  {
+    // pitches agree -> all rows in one go
+    if(to_device)
+      memcpy(mapped, host, rowpitch * region[1]);
+    else
+      memcpy(host, mapped, rowpitch * region[1]);
+  }
+  else
+  {
+    for(size_t j = 0; j < region[1]; j++)
+    {
+      if(to_device)
+        memcpy((char *)mapped + j * mappitch, (char *)host + j * rowpitch, rowpitch);
+      else
+        memcpy((char *)host + j * rowpitch, (char *)mapped + j * mappitch, rowpitch);
+    }
+  }
+
+  return dt_opencl_unmap_mem_object(devid, device, mapped);
+}
+
 int dt_opencl_copy_device_to_host(const int devid,
                                   void *host,
                                   void *device,
@@ -2850,6 +3184,28 @@ int dt_opencl_read_host_from_device_rowpitch(const int devid,
     return DT_OPENCL_NODEVICE;
   const size_t origin[] = { 0, 0, 0 };
   const size_t region[] = { width, height, 1 };
+
+  // integrated GPUs share physical memory with the host, a zero-copy
+  // mapping avoids the driver-internal staging of a read
+  if(darktable.opencl->dev[devid].unified_memory)
+    return _opencl_copy_mapped_image(devid, host, device, origin, region,
+                                     rowpitch, FALSE);
+
+  // if enabled for the device, stage the transfer through a pinned
+  // buffer: DMA from pinned memory runs at roughly twice the PCIe
+  // throughput of pageable memory, easily paying for the extra
+  // host-side memcpy
+  const size_t size = (size_t)rowpitch * height;
+  void *staging = _opencl_get_staging(devid, size);
+  if(staging)
+  {
+    const cl_int err = dt_opencl_read_host_from_device_raw
+      (devid, staging, device, origin, region, rowpitch, CL_TRUE);
+    if(err == CL_SUCCESS) memcpy(host, staging, size);
+    _opencl_release_staging(devid, staging);
+    return err;
+  }
+
   // blocking.
   return dt_opencl_read_host_from_device_raw(devid, host, device, origin,
                                              region, rowpitch, CL_TRUE);
@@ -2935,6 +3291,24 @@ int dt_opencl_write_host_to_device_rowpitch(const int devid,
 
   const size_t origin[] = { 0, 0, 0 };
   const size_t region[] = { width, height, 1 };
+
+  // see dt_opencl_read_host_from_device_rowpitch() for the rationale
+  // behind the zero-copy mapping and the pinned staging buffer
+  if(darktable.opencl->dev[devid].unified_memory)
+    return _opencl_copy_mapped_image(devid, host, device, origin, region,
+                                     rowpitch, TRUE);
+
+  const size_t size = (size_t)rowpitch * height;
+  void *staging = _opencl_get_staging(devid, size);
+  if(staging)
+  {
+    memcpy(staging, host, size);
+    const cl_int err = dt_opencl_write_host_to_device_raw
+      (devid, staging, device, origin, region, rowpitch, CL_TRUE);
+    _opencl_release_staging(devid, staging);
+    return err;
+  }
+
   // blocking.
   return dt_opencl_write_host_to_device_raw(devid, host, device, origin,
                                             region, rowpitch, CL_TRUE);
@@ -3306,8 +3680,13 @@ void *dt_opencl_alloc_device(const int devid,
   const cl_image_desc desc = (cl_image_desc)
         {CL_MEM_OBJECT_IMAGE2D, width, height, 0, 0, 0, 0, 0, 0, NULL};
 
+  // on unified memory devices ask the driver for storage the host can
+  // access directly so that mapping the image is zero-copy
+  const cl_mem_flags flags = CL_MEM_READ_WRITE
+    | (cl->dev[devid].unified_memory ? CL_MEM_ALLOC_HOST_PTR : 0);
+
   cl_mem dev = (cl->dlocl->symbols->dt_clCreateImage)
-    (cl->dev[devid].context, CL_MEM_READ_WRITE, &fmt, &desc, NULL, &err);
+    (cl->dev[devid].context, flags, &fmt, &desc, NULL, &err);
 
   if(err != CL_SUCCESS)
     dt_print(DT_DEBUG_OPENCL,
@@ -3320,6 +3699,51 @@ void *dt_opencl_alloc_device(const int devid,
   return dev;
 }
 
+void *dt_opencl_alloc_device_half(const int devid,
+                                  const int width,
+                                  const int height,
+                                  const int bpp)
+{
+  if(!_cldev_running(devid))
+    return NULL;
+
+  dt_opencl_t *cl = darktable.opencl;
+  if(cl->dev[devid].max_image_width < width || cl->dev[devid].max_image_height < height)
+    return NULL;
+
+  // only for 4 float images: RGBA/HALF_FLOAT is in the minimum set of
+  // image formats every implementation must support, single channel
+  // half write support is not guaranteed
+  if(bpp != 4 * sizeof(float))
+    return dt_opencl_alloc_device(devid, width, height, bpp);
+
+  cl_int err = CL_SUCCESS;
+  const cl_image_format fmt = (cl_image_format){ CL_RGBA, CL_HALF_FLOAT };
+
+  const cl_image_desc desc = (cl_image_desc)
+        {CL_MEM_OBJECT_IMAGE2D, width, height, 0, 0, 0, 0, 0, 0, NULL};
+
+  const cl_mem_flags flags = CL_MEM_READ_WRITE
+    | (cl->dev[devid].unified_memory ? CL_MEM_ALLOC_HOST_PTR : 0);
+
+  cl_mem dev = (cl->dlocl->symbols->dt_clCreateImage)
+    (cl->dev[devid].context, flags, &fmt, &desc, NULL, &err);
+
+  if(err != CL_SUCCESS)
+  {
+    dt_print(DT_DEBUG_OPENCL,
+             "[opencl alloc_device_half] could not alloc half img buffer on device '%s' id=%d: %s",
+             cl->dev[devid].fullname, devid, cl_errstr(err));
+    _check_clmem_err(devid, err);
+    // fall back to full float storage
+    return dt_opencl_alloc_device(devid, width, height, bpp);
+  }
+
+  dt_opencl_memory_statistics(devid, dev, OPENCL_MEMORY_ADD);
+
+  return dev;
+}
+
 
 void *dt_opencl_alloc_device_use_host_pointer(const int devid,
                                               const int width,
@@ -4044,6 +4468,58 @@ static void _opencl_events_profiling(const int devid,
   free(tags);
 }
 
+/** append all consolidated events as complete events in chrome trace
+    format to the per-device timeline file. the file is an unterminated
+    JSON array, which trace viewers accept, so we can stream into it
+    without rewriting it on every flush. */
+static void _opencl_events_trace(const int devid)
+{
+  dt_opencl_t *cl = darktable.opencl;
+  if(!cl->inited || devid < 0) return;
+  if(!cl->dev[devid].use_events) return;
+
+  dt_opencl_eventtag_t *eventtags = cl->dev[devid].eventtags;
+  const int eventsconsolidated = cl->dev[devid].eventsconsolidated;
+
+  if(eventtags == NULL || eventsconsolidated == 0) return; // nothing to do
+
+  if(cl->dev[devid].tracefile == NULL)
+  {
+    char cachedir[PATH_MAX] = { 0 };
+    char filename[PATH_MAX] = { 0 };
+    dt_loc_get_user_cache_dir(cachedir, sizeof(cachedir));
+    snprintf(filename, sizeof(filename), "%s/cltrace-%d.json", cachedir, devid);
+    cl->dev[devid].tracefile = g_fopen(filename, "wb");
+    if(cl->dev[devid].tracefile == NULL)
+    {
+      dt_print(DT_DEBUG_OPENCL,
+               "[opencl_events_trace] could not open timeline file `%s'", filename);
+      return;
+    }
+    dt_print(DT_DEBUG_OPENCL,
+             "[opencl_events_trace] writing timeline for device %d ('%s') to `%s'",
+             devid, cl->dev[devid].fullname, filename);
+    fputs("[\n", cl->dev[devid].tracefile);
+  }
+
+  for(int k = 0; k < eventsconsolidated; k++)
+  {
+    // events without profiling info have been counted as lost already
+    if(eventtags[k].timeend <= eventtags[k].timestart) continue;
+
+    fprintf(cl->dev[devid].tracefile,
+            "{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f,"
+            " \"pid\": %d, \"tid\": 0},\n",
+            eventtags[k].tag[0] == '\0' ? "<?>" : eventtags[k].tag,
+            eventtags[k].timestart * 1e-3, // device clock is in nanoseconds
+            (eventtags[k].timeend - eventtags[k].timestart) * 1e-3,
+            devid);
+  }
+
+  // keep the timeline readable even if we terminate abnormally
+  fflush(cl->dev[devid].tracefile);
+}
+
 /** Wait for events in eventlist to terminate, check for return status
     and profiling info of events.  If "reset" is TRUE report summary
     info (would be CL_COMPLETE or last error code) and print profiling
@@ -4069,6 +4545,11 @@ cl_int dt_opencl_events_flush(const int devid,
   if(*eventlist == NULL || *numevents == 0)
     return CL_SUCCESS; // nothing to do, no news is good news
 
+  // runtime-togglable timeline recording; only of use if the command
+  // queue was created with profiling enabled
+  const gboolean tracing = dt_conf_get_bool("opencl_event_trace");
+  const gboolean profiling = (darktable.unmuted & DT_DEBUG_PERF) || tracing;
+
   // Wait for command queue to terminate (side effect: might adjust *numevents)
   _opencl_events_wait_for(devid);
 
@@ -4100,9 +4581,9 @@ cl_int dt_opencl_events_flush(const int devid,
     else
       (*totalsuccess)++;
 
-    if(darktable.unmuted & DT_DEBUG_PERF)
+    if(profiling)
     {
-      // get profiling info of event (only if darktable was called with '-d perf')
+      // get profiling info of event (only with '-d perf' or timeline recording)
       cl_ulong start;
       cl_ulong end;
       cl_int errs = (cl->dlocl->symbols->dt_clGetEventProfilingInfo)(
@@ -4113,10 +4594,14 @@ cl_int dt_opencl_events_flush(const int devid,
       if(errs == CL_SUCCESS && erre == CL_SUCCESS)
       {
         (*eventtags)[k].timelapsed = end - start;
+        (*eventtags)[k].timestart = start;
+        (*eventtags)[k].timeend = end;
       }
       else
       {
         (*eventtags)[k].timelapsed = 0;
+        (*eventtags)[k].timestart = 0;
+        (*eventtags)[k].timeend = 0;
         (*lostevents)++;
       }
     }
@@ -4136,6 +4621,9 @@ cl_int dt_opencl_events_flush(const int devid,
     // output profiling info if wanted
     if(darktable.unmuted & DT_DEBUG_PERF) _opencl_events_profiling(devid, 1);
 
+    // append this batch of events to the timeline file if wanted
+    if(tracing) _opencl_events_trace(devid);
+
     // reset eventlist structures to empty state
     dt_opencl_events_reset(devid);
   }
@@ -4202,6 +4690,25 @@ int dt_opencl_local_buffer_opt(const int devid,
       else
         *blocksizey >>= 1;
     }
+
+    // reshape the block toward the driver's preferred work group size
+    // multiple: a block narrower than the multiple leaves SIMD lanes
+    // idle and defeats memory coalescing, so widen x at the expense of
+    // y as long as all resource limits still hold
+    size_t multiple = 0;
+    if(dt_opencl_get_kernel_preferred_multiple(devid, kernel, &multiple) == CL_SUCCESS)
+    {
+      while((size_t)(*blocksizex) < multiple
+            && *blocksizey > 1
+            && maxsizes[0] >= (size_t)(*blocksizex) * 2
+            && localmemsize >= ((factors->xfactor * (*blocksizex) * 2 + factors->xoffset) *
+                                (factors->yfactor * (*blocksizey) / 2 + factors->yoffset))
+                               * factors->cellsize + factors->overhead)
+      {
+        *blocksizex <<= 1;
+        *blocksizey >>= 1;
+      }
+    }
   }
   else
   {
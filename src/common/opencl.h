@@ -31,6 +31,7 @@
 #define DT_OPENCL_VENDOR_INTEL 0x8086u
 #define DT_OPENCL_CBUFFSIZE 1024
 #define DT_OPENCL_DEFAULT_HEADROOM 600
+#define DT_OPENCL_STAGING_BUFFERS 2
 
 // some pseudo error codes in dt opencl usage
 #define DT_OPENCL_DEFAULT_ERROR -999
@@ -95,9 +96,20 @@ typedef struct dt_opencl_eventtag_t
 {
   cl_int retval;
   cl_ulong timelapsed;
+  cl_ulong timestart;
+  cl_ulong timeend;
   char tag[DT_OPENCL_EVENTNAMELENGTH];
 } dt_opencl_eventtag_t;
 
+// one slot of the per-device pinned staging buffer pool; the buffer
+// stays mapped to host memory for its whole lifetime
+typedef struct dt_opencl_staging_t
+{
+  cl_mem buf;
+  void *ptr;
+  size_t size;
+  gboolean busy;
+} dt_opencl_staging_t;
 
 /**
  * to support multi-gpu and mixed systems with cpu support,
@@ -120,6 +132,10 @@ typedef struct dt_opencl_device_t
   cl_kernel kernel[DT_OPENCL_MAX_KERNELS];
   gboolean program_used[DT_OPENCL_MAX_PROGRAMS];
   gboolean kernel_used[DT_OPENCL_MAX_KERNELS];
+  // per-kernel work group properties, probed from the driver once on
+  // first use and consulted by the work group helpers thereafter
+  size_t kernel_wgsize[DT_OPENCL_MAX_KERNELS];
+  size_t kernel_preferred_multiple[DT_OPENCL_MAX_KERNELS];
   cl_event *eventlist;
   dt_opencl_eventtag_t *eventtags;
   int numevents;
@@ -166,6 +182,12 @@ typedef struct dt_opencl_device_t
   // the device-specific conf pinned transfer is enabled
   gboolean pinned_memory;
 
+  // small pool of pinned host staging buffers used by the blocking
+  // image transfer helpers if pinned_memory is enabled for the device,
+  // see _opencl_get_staging()
+  dt_opencl_staging_t staging[DT_OPENCL_STAGING_BUFFERS];
+  dt_pthread_mutex_t staging_lock;
+
   // keep track of devices using unified memory so we can adopt
   // runtime code
   gboolean unified_memory;
@@ -191,6 +213,11 @@ typedef struct dt_opencl_device_t
   // opencl_events enabled for the device, set internally via event_handles
   gboolean use_events;
 
+  // chrome trace timeline of terminated events, written per device into
+  // the user cache dir while 'opencl_event_trace' is enabled. opened
+  // lazily on first use
+  FILE *tracefile;
+
   // async pixelpipe mode for device if set to TRUE OpenCL pixelpipe
   // will not be synchronized on a per-module basis. this can improve
   // pixelpipe latency.  however, potential OpenCL errors would be
@@ -350,6 +377,11 @@ int dt_opencl_get_kernel_work_group_size(const int dev,
                                          const int kernel,
                                          size_t *kernelworkgroupsize);
 
+/** return preferred workgroup size multiple for a specific kernel */
+int dt_opencl_get_kernel_preferred_multiple(const int dev,
+                                            const int kernel,
+                                            size_t *multiple);
+
 /** wrap opencl arguments */
 /** the magic number is used for parameter checking; don't use it in your code! */
 #define CLWRAP(size, ptr) (const size_t)0xF111E8, (const size_t)size, (const void *)ptr
@@ -517,6 +549,13 @@ void *dt_opencl_alloc_device(const int devid,
                              const int height,
                              const int bpp);
 
+/** as dt_opencl_alloc_device() but with half float storage for 4 float
+    images; kernels keep computing in float, the sampler converts */
+void *dt_opencl_alloc_device_half(const int devid,
+                                  const int width,
+                                  const int height,
+                                  const int bpp);
+
 void *dt_opencl_alloc_device_use_host_pointer(const int devid,
                                               const int width,
                                               const int height,
@@ -723,6 +762,12 @@ static inline int dt_opencl_get_kernel_work_group_size(const int dev,
 {
   return -1;
 }
+static inline int dt_opencl_get_kernel_preferred_multiple(const int dev,
+                                                          const int kernel,
+                                                          size_t *multiple)
+{
+  return -1;
+}
 static inline int dt_opencl_enqueue_kernel_2d(const int dev,
                                               const int kernel,
                                               const size_t *sizes)
@@ -268,43 +268,41 @@ static size_t _pdf_stream_encoder_ASCIIHex(dt_pdf_t *pdf, const unsigned char *d
   return len * 2;
 }
 
-// using zlib we get quite small files, but it's slow
-static size_t _pdf_stream_encoder_Flate(dt_pdf_t *pdf, const unsigned char *data, size_t len)
+// using zlib we get quite small files, but it's slow. the input is consumed band
+// by band with a fixed size output buffer, so we never need a second copy of the
+// complete image like the one-shot compress() would.
+static gboolean _pdf_stream_encoder_Flate(dt_pdf_t *pdf, z_stream *zs, const unsigned char *data,
+                                          size_t len, const int flush, size_t *written)
 {
-  int result;
-  uLongf destLen = compressBound(len);
-  unsigned char *buffer = malloc(destLen);
-  if(!buffer)
-    return 0;
-  
-  result = compress(buffer, &destLen, data, len);
+  unsigned char out[1 << 15];
 
-  if(result != Z_OK)
+  zs->next_in = (Bytef *)data;
+  zs->avail_in = len;
+  do
   {
-    free(buffer);
-    return 0;
-  }
-
-  fwrite(buffer, 1, destLen, pdf->fd);
-
-  free(buffer);
-  return destLen;
+    zs->next_out = out;
+    zs->avail_out = sizeof(out);
+    if(deflate(zs, flush) == Z_STREAM_ERROR)
+      return FALSE;
+    const size_t have = sizeof(out) - zs->avail_out;
+    if(have > 0 && fwrite(out, 1, have, pdf->fd) != have)
+      return FALSE;
+    *written += have;
+  } while(zs->avail_out == 0);
+
+  return TRUE;
 }
 
-static size_t _pdf_write_stream(dt_pdf_t *pdf, dt_pdf_stream_encoder_t encoder, const unsigned char *data, size_t len)
+// the stream state between dt_pdf_add_image_begin and dt_pdf_add_image_end
+typedef struct _pdf_band_state_t
 {
-  size_t stream_size = 0;
-  switch(encoder)
-  {
-    case DT_PDF_STREAM_ENCODER_ASCII_HEX:
-      stream_size = _pdf_stream_encoder_ASCIIHex(pdf, data, len);
-      break;
-    case DT_PDF_STREAM_ENCODER_FLATE:
-      stream_size = _pdf_stream_encoder_Flate(pdf, data, len);
-      break;
-  }
-  return stream_size;
-}
+  dt_pdf_image_t *image;
+  int             length_id;
+  size_t          bytes_written; // the object header written before the stream
+  size_t          stream_size;
+  z_stream        zs;
+  gboolean        flate;
+} _pdf_band_state_t;
 
 int dt_pdf_add_icc(dt_pdf_t *pdf, const char *filename)
 {
@@ -366,28 +364,72 @@ int dt_pdf_add_icc_from_data(dt_pdf_t *pdf, const unsigned char *data, size_t si
 // if image == NULL only the outline can be shown later
 dt_pdf_image_t *dt_pdf_add_image(dt_pdf_t *pdf, const unsigned char *image, int width, int height, int bpp, int icc_id, float border)
 {
-  size_t stream_size = 0;
-  size_t bytes_written = 0;
+  // just draw outlines if the image is missing
+  if(image == NULL)
+  {
+    dt_pdf_image_t *pdf_image = calloc(1, sizeof(dt_pdf_image_t));
+    if(!pdf_image) return NULL;
+
+    pdf_image->width = width;
+    pdf_image->height = height;
+    pdf_image->outline_mode = TRUE;
+    // no need to do fancy math here:
+    pdf_image->bb_x = border;
+    pdf_image->bb_y = border;
+    pdf_image->bb_width = pdf->page_width - (2 * border);
+    pdf_image->bb_height = pdf->page_height - (2 * border);
+
+    return pdf_image;
+  }
+
+  dt_pdf_image_t *pdf_image = dt_pdf_add_image_begin(pdf, width, height, bpp, icc_id, border);
+  if(!pdf_image) return NULL;
+
+  const gboolean bands_ok =
+    dt_pdf_add_image_bands(pdf, image, (size_t)3 * (bpp / 8) * width * height);
+  if(!dt_pdf_add_image_end(pdf) || !bands_ok)
+  {
+    free(pdf_image);
+    return NULL;
+  }
 
+  return pdf_image;
+}
+
+dt_pdf_image_t *dt_pdf_add_image_begin(dt_pdf_t *pdf, int width, int height, int bpp, int icc_id, float border)
+{
   dt_pdf_image_t *pdf_image = calloc(1, sizeof(dt_pdf_image_t));
   if(!pdf_image) return NULL;
 
+  _pdf_band_state_t *state = calloc(1, sizeof(_pdf_band_state_t));
+  if(!state)
+  {
+    free(pdf_image);
+    return NULL;
+  }
+
   pdf_image->width = width;
   pdf_image->height = height;
-  pdf_image->outline_mode = (image == NULL);
   // no need to do fancy math here:
   pdf_image->bb_x = border;
   pdf_image->bb_y = border;
   pdf_image->bb_width = pdf->page_width - (2 * border);
   pdf_image->bb_height = pdf->page_height - (2 * border);
 
-  // just draw outlines if the image is missing
-  if(pdf_image->outline_mode) return pdf_image;
-
   pdf_image->object_id = pdf->next_id++;
   pdf_image->name_id = pdf->next_image++;
 
-  int length_id = pdf->next_id++;
+  state->image = pdf_image;
+  state->length_id = pdf->next_id++;
+  state->flate = (pdf->default_encoder == DT_PDF_STREAM_ENCODER_FLATE);
+  if(state->flate && deflateInit(&state->zs, Z_DEFAULT_COMPRESSION) != Z_OK)
+  {
+    free(state);
+    free(pdf_image);
+    return NULL;
+  }
+
+  size_t bytes_written = 0;
 
   // the image
   //start
@@ -414,17 +456,50 @@ dt_pdf_image_t *dt_pdf_add_image(dt_pdf_t *pdf, const unsigned char *image, int
     "/Length %d 0 R\n"
     ">>\n"
     "stream\n",
-    bpp, length_id
+    bpp, state->length_id
   );
 
-  // the stream
-  stream_size = _pdf_write_stream(pdf, pdf->default_encoder, image, (size_t)3 * (bpp / 8) * width * height);
-  if(stream_size == 0)
+  state->bytes_written = bytes_written;
+  pdf->band_state = state;
+
+  return pdf_image;
+}
+
+gboolean dt_pdf_add_image_bands(dt_pdf_t *pdf, const unsigned char *data, size_t len)
+{
+  _pdf_band_state_t *state = pdf->band_state;
+  if(!state) return FALSE;
+
+  if(state->flate)
+    return _pdf_stream_encoder_Flate(pdf, &state->zs, data, len, Z_NO_FLUSH,
+                                     &state->stream_size);
+
+  state->stream_size += _pdf_stream_encoder_ASCIIHex(pdf, data, len);
+  return TRUE;
+}
+
+gboolean dt_pdf_add_image_end(dt_pdf_t *pdf)
+{
+  _pdf_band_state_t *state = pdf->band_state;
+  if(!state) return FALSE;
+  pdf->band_state = NULL;
+
+  gboolean success = TRUE;
+  if(state->flate)
   {
-    free(pdf_image);
-    return NULL;
+    // flush the remaining compressed data
+    success = _pdf_stream_encoder_Flate(pdf, &state->zs, NULL, 0, Z_FINISH,
+                                        &state->stream_size);
+    deflateEnd(&state->zs);
   }
-  bytes_written += stream_size;
+
+  if(!success || state->stream_size == 0)
+  {
+    free(state);
+    return FALSE;
+  }
+
+  size_t bytes_written = state->bytes_written + state->stream_size;
 
   //end
   bytes_written += fprintf(pdf->fd,
@@ -434,16 +509,17 @@ dt_pdf_image_t *dt_pdf_add_image(dt_pdf_t *pdf, const unsigned char *image, int
   );
 
   // length of the last stream
-  _pdf_set_offset(pdf, length_id, pdf->bytes_written + bytes_written);
+  _pdf_set_offset(pdf, state->length_id, pdf->bytes_written + bytes_written);
   bytes_written += fprintf(pdf->fd, "%d 0 obj\n"
                                     "%zu\n"
                                     "endobj\n",
-                           length_id, stream_size);
+                           state->length_id, state->stream_size);
 
   pdf->bytes_written += bytes_written;
-  pdf_image->size = bytes_written;
+  state->image->size = bytes_written;
 
-  return pdf_image;
+  free(state);
+  return TRUE;
 }
 
 dt_pdf_page_t *dt_pdf_add_page(dt_pdf_t *pdf, dt_pdf_image_t **images, int n_images)
@@ -57,6 +57,10 @@ typedef struct dt_pdf_t
 
   size_t                  *offsets;
   int                      n_offsets;
+
+  // state of an in-flight banded image stream, only set between
+  // dt_pdf_add_image_begin and dt_pdf_add_image_end
+  void                    *band_state;
 } dt_pdf_t;
 
 typedef struct dt_pdf_image_t
@@ -117,6 +121,11 @@ dt_pdf_t *dt_pdf_start(const char *filename, float width, float height, float dp
 int dt_pdf_add_icc(dt_pdf_t *pdf, const char *filename);
 int dt_pdf_add_icc_from_data(dt_pdf_t *pdf, const unsigned char *data, size_t size);
 dt_pdf_image_t *dt_pdf_add_image(dt_pdf_t *pdf, const unsigned char *image, int width, int height, int bpp, int icc_id, float border);
+// banded image writing: begin the image object, feed the pixel data in top-to-bottom bands,
+// then close the stream. this keeps memory bounded when writing large pages.
+dt_pdf_image_t *dt_pdf_add_image_begin(dt_pdf_t *pdf, int width, int height, int bpp, int icc_id, float border);
+gboolean dt_pdf_add_image_bands(dt_pdf_t *pdf, const unsigned char *data, size_t len);
+gboolean dt_pdf_add_image_end(dt_pdf_t *pdf);
 dt_pdf_page_t *dt_pdf_add_page(dt_pdf_t *pdf, dt_pdf_image_t **images, int n_images);
 void dt_pdf_finish(dt_pdf_t *pdf, dt_pdf_page_t **pages, int n_pages);
 
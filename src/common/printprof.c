@@ -65,36 +65,42 @@ int dt_apply_printer_profile(void **in, uint32_t width, uint32_t height, int bpp
     return 1;
   }
 
-  void *out = malloc((size_t)3 * width * height);
-  if(!out)
+  // transform the image in bands of rows: each band is converted in
+  // parallel into a small scratch buffer and compacted back in place, so
+  // a print-resolution image never needs a second full-size allocation
+  const uint32_t band_rows = MAX(1, (1u << 22) / (3 * width)); // ~4MB bands
+  uint8_t *band = malloc((size_t)3 * width * band_rows);
+  if(!band)
   {
-    dt_print(DT_DEBUG_ALWAYS, "unable to allocate buffer for printer-proofed image");
+    dt_print(DT_DEBUG_ALWAYS, "unable to allocate band buffer for printer-proofed image");
+    cmsDeleteTransform(hTransform);
     return 1;
   }
 
-  if(bpp == 8)
-  {
-    const uint8_t *ptr_in = (uint8_t *)*in;
-    uint8_t *ptr_out = (uint8_t *)out;
+  const size_t in_stride = (size_t)3 * width * (bpp == 8 ? 1 : 2);
+  const size_t out_stride = (size_t)3 * width;
+  uint8_t *const ptr = (uint8_t *)*in;
 
-    DT_OMP_FOR(shared(hTransform))
-    for(int k=0; k<height; k++)
-      cmsDoTransform(hTransform, (const void *)&ptr_in[k*width*3], (void *)&ptr_out[k*width*3], width);
-  }
-  else
+  for(uint32_t row = 0; row < height; row += band_rows)
   {
-    const uint16_t *ptr_in = (uint16_t *)*in;
-    uint8_t *ptr_out = (uint8_t *)out;
+    const uint32_t rows = MIN(band_rows, height - row);
 
     DT_OMP_FOR(shared(hTransform))
-    for(int k=0; k<height; k++)
-      cmsDoTransform(hTransform, (const void *)&ptr_in[k*width*3], (void *)&ptr_out[k*width*3], width);
+    for(int k = 0; k < rows; k++)
+      cmsDoTransform(hTransform, (const void *)(ptr + (row + k) * in_stride),
+                     (void *)(band + k * out_stride), width);
+
+    // the packed 8-bit output is never larger than the input rows just
+    // read, so writing the band forward in place is safe
+    memcpy(ptr + row * out_stride, band, (size_t)rows * out_stride);
   }
 
+  free(band);
   cmsDeleteTransform(hTransform);
 
-  free(*in);
-  *in = out;
+  // shrink the allocation to the packed result
+  void *out = realloc(*in, (size_t)3 * width * height);
+  if(out) *in = out;
 
   return 0;
 }
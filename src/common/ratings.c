@@ -43,18 +43,20 @@ typedef struct dt_undo_ratings_t
 int dt_ratings_get(const dt_imgid_t imgid)
 {
   int stars = 0;
-  dt_image_t *image = dt_image_cache_get(imgid, 'r');
-  if(image)
+  dt_image_hot_t hot;
+  if(dt_image_cache_get_hot(imgid, &hot))
   {
-    if(image->flags & DT_IMAGE_REJECTED)
+    if(hot.flags & DT_IMAGE_REJECTED)
       stars = DT_VIEW_REJECT;
     else
-      stars = DT_VIEW_RATINGS_MASK & image->flags;
-    dt_image_cache_read_release(image);
+      stars = DT_VIEW_RATINGS_MASK & hot.flags;
   }
   return stars;
 }
 
+// the xmp sidecars are deliberately not written here: the callers
+// synch them in one go per list so a large selection doesn't pay one
+// sidecar write per image
 static void _ratings_apply_to_image(const dt_imgid_t imgid, const int rating)
 {
   int new_rating = rating;
@@ -73,7 +75,7 @@ static void _ratings_apply_to_image(const dt_imgid_t imgid, const int rating)
         | (DT_VIEW_RATINGS_MASK & new_rating);
     }
     // synch through:
-    dt_image_cache_write_release_info(image, DT_IMAGE_CACHE_SAFE, "_ratings_apply_to_image");
+    dt_image_cache_write_release_info(image, DT_IMAGE_CACHE_RELAXED, "_ratings_apply_to_image");
   }
 }
 
@@ -87,6 +89,7 @@ static void _pop_undo(gpointer user_data, dt_undo_type_t type, dt_undo_data_t da
       _ratings_apply_to_image(ratings->imgid, (action == DT_ACTION_UNDO) ? ratings->before : ratings->after);
       *imgs = g_list_prepend(*imgs, GINT_TO_POINTER(ratings->imgid));
     }
+    dt_image_synch_xmps(*imgs);
     dt_collection_hint_message(darktable.collection);
   }
 }
@@ -155,7 +158,7 @@ static void _ratings_apply(const GList *imgs,
       undoratings->imgid = image_id;
       undoratings->before = old_rating;
       undoratings->after = rating;
-      *undo = g_list_append(*undo, undoratings);
+      *undo = g_list_prepend(*undo, undoratings);
     }
 
     int new_rating = rating;
@@ -187,7 +190,12 @@ void dt_ratings_apply_on_list(const GList *img,
     GList *undo = NULL;
     if(undo_on) dt_undo_start_group(darktable.undo, DT_UNDO_RATINGS);
 
+    // one transaction for the whole list so we commit once instead of
+    // once per image
+    dt_database_start_transaction(darktable.db);
     _ratings_apply(img, rating, &undo, undo_on);
+    dt_database_release_transaction(darktable.db);
+    dt_image_synch_xmps(img);
 
     if(undo_on)
     {
@@ -217,7 +225,10 @@ void dt_ratings_apply_on_image(const dt_imgid_t imgid,
     if(undo_on) dt_undo_start_group(darktable.undo, DT_UNDO_RATINGS);
     if(group_on) dt_grouping_add_grouped_images(&imgs);
 
+    dt_database_start_transaction(darktable.db);
     _ratings_apply(imgs, new_rating, &undo, undo_on);
+    dt_database_release_transaction(darktable.db);
+    dt_image_synch_xmps(imgs);
 
     if(undo_on)
     {
@@ -21,10 +21,16 @@
 #endif
 
 #include "common/resource_limits.h"
+#include "common/darktable.h"
+#include "common/image_cache.h"
+#include "common/imagebuf.h"
+#include "common/mipmap_cache.h"
 #include <assert.h>       // for assert
 #include <errno.h>        // for errno
+#include <glib/gstdio.h>  // for g_fopen
 #include <stdint.h>       // for uintmax_t
 #include <stdio.h>        // for fprintf, stderr
+#include <stdlib.h>       // for atol
 #include <string.h>       // for strerror
 #include <inttypes.h>
 
@@ -77,6 +83,167 @@ void dt_set_rlimits()
   dt_set_rlimits_stack();
 }
 
+static struct
+{
+  pthread_t thread;
+  gboolean started;
+  int running;
+  int pressure;
+} _watchdog = { 0 };
+
+static size_t _get_available_system_memory()
+{
+#if defined(__linux__)
+  FILE *f = g_fopen("/proc/meminfo", "rb");
+  if(!f) return 0;
+  size_t mem = 0;
+  char *line = NULL;
+  size_t len = 0;
+  while(!mem && getline(&line, &len, f) != -1)
+  {
+    char *colon = strchr(line, ':');
+    if(!colon) continue;
+    if(!strncmp(line, "MemAvailable:", 13)) mem = atol(colon + 1);
+  }
+  fclose(f);
+  if(len > 0) free(line);
+  return mem * 1024lu;
+#elif defined _WIN32
+  MEMORYSTATUSEX memInfo;
+  memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+  GlobalMemoryStatusEx(&memInfo);
+  return memInfo.ullAvailPhys;
+#else
+  // no cheap pressure signal available, the watchdog stays quiet
+  return 0;
+#endif
+}
+
+static size_t _pressure_limit()
+{
+  return MAX((size_t)1024 * DT_MEGA, darktable.dtresources.total_memory / 16);
+}
+
+static void _watchdog_trim()
+{
+  // unused buffers sitting in the pool cost nothing to refill, drop
+  // them before touching any cache
+  dt_bufpool_trim(TRUE);
+
+  const struct
+  {
+    const char *name;
+    dt_cache_t *cache;
+  } caches[4] =
+  {
+    // ordered by the cost to refill an evicted entry: image structs
+    // come from the database, thumbnails from the thumbnail disk
+    // backend, while the f/full buffers require a full decode
+    { "image", &darktable.image_cache->cache },
+    { "thumbs", &darktable.mipmap_cache->mip_thumbs.cache },
+    { "mip f", &darktable.mipmap_cache->mip_f.cache },
+    { "mip full", &darktable.mipmap_cache->mip_full.cache },
+  };
+
+  const size_t limit = _pressure_limit();
+  for(int k = 0; k < 4; k++)
+  {
+    if(_get_available_system_memory() >= limit)
+      return;
+
+    dt_cache_gc(caches[k].cache, 0.5f);
+    dt_print(DT_DEBUG_MEMORY,
+             "[pressure watchdog] trimmed %s cache, now using %luMB",
+             caches[k].name, caches[k].cache->cost / DT_MEGA);
+  }
+}
+
+static void *_watchdog_loop(void *ptr)
+{
+  dt_pthread_setname("pressure");
+  while(g_atomic_int_get(&_watchdog.running))
+  {
+    g_usleep(2 * G_USEC_PER_SEC);
+
+    const size_t available = _get_available_system_memory();
+    if(available == 0) continue;
+
+    const gboolean low = available < _pressure_limit();
+    g_atomic_int_set(&_watchdog.pressure, low);
+    if(low)
+    {
+      dt_print(DT_DEBUG_MEMORY,
+               "[pressure watchdog] system low on memory, %luMB available",
+               available / DT_MEGA);
+      _watchdog_trim();
+    }
+  }
+  return NULL;
+}
+
+void dt_pressure_watchdog_start()
+{
+  if(_watchdog.started) return;
+  g_atomic_int_set(&_watchdog.running, TRUE);
+  _watchdog.started =
+    pthread_create(&_watchdog.thread, NULL, _watchdog_loop, NULL) == 0;
+}
+
+void dt_pressure_watchdog_shutdown()
+{
+  if(!_watchdog.started) return;
+  g_atomic_int_set(&_watchdog.running, FALSE);
+  pthread_join(_watchdog.thread, NULL);
+  _watchdog.started = FALSE;
+}
+
+gboolean dt_memory_pressure()
+{
+  return g_atomic_int_get(&_watchdog.pressure);
+}
+
+static gint _governor_focus = DT_GOVERNOR_FOCUS_THUMBS;
+// quota of the thumbnail cache as configured at startup, captured on
+// the first focus change before we start scaling it
+static size_t _governor_thumbs_quota = 0;
+
+void dt_governor_set_focus(const dt_governor_focus_t focus)
+{
+  if(g_atomic_int_get(&_governor_focus) == (gint)focus) return;
+  g_atomic_int_set(&_governor_focus, focus);
+
+  if(!darktable.mipmap_cache) return;
+  dt_cache_t *thumbs = &darktable.mipmap_cache->mip_thumbs.cache;
+  if(_governor_thumbs_quota == 0)
+    _governor_thumbs_quota = thumbs->cost_quota;
+
+  if(focus == DT_GOVERNOR_FOCUS_PIPE)
+  {
+    // hand half of the thumbnail budget to the pixelpipe caches and
+    // trim the thumbnails down to their reduced share right away
+    thumbs->cost_quota = _governor_thumbs_quota / 2;
+    dt_cache_gc(thumbs, 0.5f);
+  }
+  else
+  {
+    // restore the full quota; the pipe caches notice their reduced
+    // limit on their next run via dt_governor_pipe_memlimit()
+    thumbs->cost_quota = _governor_thumbs_quota;
+  }
+  dt_print(DT_DEBUG_MEMORY,
+           "[governor] focus %s, thumbnail quota %luMB",
+           focus == DT_GOVERNOR_FOCUS_PIPE ? "pipe" : "thumbs",
+           thumbs->cost_quota / DT_MEGA);
+}
+
+size_t dt_governor_pipe_memlimit(const size_t configured)
+{
+  // in darkroom the pipe caches may use the budget taken from the
+  // thumbnail cache on top of their configured limit
+  if(g_atomic_int_get(&_governor_focus) == DT_GOVERNOR_FOCUS_PIPE)
+    return configured + _governor_thumbs_quota / 2;
+  return configured;
+}
 
 // clang-format off
 // modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
@@ -18,8 +18,44 @@
 
 #pragma once
 
+#include <glib.h>
+
 void dt_set_rlimits();
 
+/* The memory pressure watchdog trims the global caches from a low
+   priority background thread whenever the system itself runs short on
+   free memory, so a heavy consumer like a background export can't push
+   us into swap while the other caches sit on their full quota. Caches
+   are trimmed in the order of the cost to refill an evicted entry and
+   we stop as soon as enough has been freed. */
+void dt_pressure_watchdog_start();
+void dt_pressure_watchdog_shutdown();
+
+/* TRUE while the watchdog last saw the system short on memory. The
+   pixelpipe caches test this on their next run as they can't safely be
+   trimmed from another thread. */
+gboolean dt_memory_pressure();
+
+/* The memory governor shifts budget between the caches depending on
+   what the user is working on instead of leaving each subsystem its
+   static fraction for the whole session: in lighttable the thumbnail
+   cache gets its full quota, in darkroom half of it is handed to the
+   pixelpipe caches, which want large cachelines there while hardly any
+   new thumbnails are requested. */
+typedef enum dt_governor_focus_t
+{
+  DT_GOVERNOR_FOCUS_THUMBS, // lighttable & friends, thumbnails first
+  DT_GOVERNOR_FOCUS_PIPE    // darkroom, pipe cachelines first
+} dt_governor_focus_t;
+
+/* called by the views on enter; reassigns the cache quotas and trims
+   the losing cache down to its reduced share */
+void dt_governor_set_focus(const dt_governor_focus_t focus);
+
+/* effective pixelpipe cache limit for a configured base limit under
+   the current focus */
+size_t dt_governor_pipe_memlimit(const size_t configured);
+
 // clang-format off
 // modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
 // vim: shiftwidth=2 expandtab tabstop=2 cindent
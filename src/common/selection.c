@@ -32,6 +32,11 @@ typedef struct dt_selection_t
   /* this stores the last single clicked image id indicating
      the start of a selection range */
   dt_imgid_t last_single_id;
+
+  /* in-memory mirror of main.selected_images for O(1) membership
+     tests; rebuilt lazily on the first lookup after a change */
+  GHashTable *ids;
+  gboolean ids_dirty;
 } dt_selection_t;
 
 const dt_collection_t *dt_selection_get_collection(dt_selection_t *selection)
@@ -61,11 +66,10 @@ static void _selection_select(dt_selection_t *selection,
 {
   if(dt_is_valid_imgid(imgid))
   {
-    const dt_image_t *image = dt_image_cache_get(imgid, 'r');
-    if(image)
+    dt_image_hot_t hot;
+    if(dt_image_cache_get_hot(imgid, &hot))
     {
-      const dt_imgid_t img_group_id = image->group_id;
-      dt_image_cache_read_release(image);
+      const dt_imgid_t img_group_id = hot.group_id;
 
       gchar *query = NULL;
       if(!darktable.gui
@@ -108,6 +112,9 @@ void _selection_update_collection(gpointer instance,
 {
   dt_selection_t *selection = (dt_selection_t *)user_data;
 
+  /* a collection change may prune the selection behind our back */
+  selection->ids_dirty = TRUE;
+
   /* free previous collection copy if any */
   if(selection->collection) dt_collection_free(selection->collection);
 
@@ -121,10 +128,43 @@ void _selection_update_collection(gpointer instance,
   dt_collection_update(selection->collection);
 }
 
+static void _selection_invalidate_ids(gpointer instance, gpointer user_data)
+{
+  dt_selection_t *selection = (dt_selection_t *)user_data;
+  selection->ids_dirty = TRUE;
+}
+
+gboolean dt_selection_is_selected(dt_selection_t *selection, const dt_imgid_t imgid)
+{
+  if(!dt_is_valid_imgid(imgid)) return FALSE;
+
+  if(selection->ids_dirty)
+  {
+    g_hash_table_remove_all(selection->ids);
+
+    sqlite3_stmt *stmt;
+    DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                                "SELECT imgid FROM main.selected_images",
+                                -1, &stmt, NULL);
+    while(sqlite3_step(stmt) == SQLITE_ROW)
+      g_hash_table_add(selection->ids,
+                       GINT_TO_POINTER(sqlite3_column_int(stmt, 0)));
+    sqlite3_finalize(stmt);
+
+    selection->ids_dirty = FALSE;
+  }
+
+  return g_hash_table_contains(selection->ids, GINT_TO_POINTER(imgid));
+}
+
 const dt_selection_t *dt_selection_new()
 {
   dt_selection_t *s = g_malloc0(sizeof(dt_selection_t));
 
+  /* the membership mirror is filled on first use */
+  s->ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+  s->ids_dirty = TRUE;
+
   /* initialize the collection copy */
   _selection_update_collection(NULL, DT_COLLECTION_CHANGE_RELOAD,
                                DT_COLLECTION_PROP_UNDEF, NULL, -1, (gpointer)s);
@@ -150,11 +190,16 @@ const dt_selection_t *dt_selection_new()
   //  raising the signal
   DT_CONTROL_SIGNAL_CONNECT(DT_SIGNAL_COLLECTION_CHANGED, _selection_update_collection, s);
 
+  /* connected before any gui consumer, so the mirror is invalidated
+     before the thumbnails repaint on the same signal */
+  DT_CONTROL_SIGNAL_CONNECT(DT_SIGNAL_SELECTION_CHANGED, _selection_invalidate_ids, s);
+
   return s;
 }
 
 void dt_selection_free(dt_selection_t *selection)
 {
+  g_hash_table_destroy(selection->ids);
   g_free(selection);
 }
 
@@ -214,11 +259,10 @@ void dt_selection_deselect(dt_selection_t *selection,
 
   if(dt_is_valid_imgid(imgid))
   {
-    const dt_image_t *image = dt_image_cache_get(imgid, 'r');
-    if(image)
+    dt_image_hot_t hot;
+    if(dt_image_cache_get_hot(imgid, &hot))
     {
-      const dt_imgid_t img_group_id = image->group_id;
-      dt_image_cache_read_release(image);
+      const dt_imgid_t img_group_id = hot.group_id;
 
       gchar *query = NULL;
       if(!darktable.gui
@@ -258,22 +302,9 @@ void dt_selection_select_single(dt_selection_t *selection, const dt_imgid_t imgi
 
 void dt_selection_toggle(dt_selection_t *selection, const dt_imgid_t imgid)
 {
-  sqlite3_stmt *stmt;
-  gboolean exists = FALSE;
-
   if(!dt_is_valid_imgid(imgid)) return;
 
-  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
-                              "SELECT imgid"
-                              " FROM main.selected_images"
-                              " WHERE imgid=?1", -1, &stmt, NULL);
-  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, imgid);
-
-  if(sqlite3_step(stmt) == SQLITE_ROW) exists = TRUE;
-
-  sqlite3_finalize(stmt);
-
-  if(exists)
+  if(dt_selection_is_selected(selection, imgid))
   {
     dt_selection_deselect(selection, imgid);
   }
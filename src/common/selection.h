@@ -38,6 +38,8 @@ void dt_selection_deselect(struct dt_selection_t *selection, dt_imgid_t imgid);
 void dt_selection_select_single(struct dt_selection_t *selection, dt_imgid_t imgid);
 /** toggles selection of image in the current selection */
 void dt_selection_toggle(struct dt_selection_t *selection, dt_imgid_t imgid);
+/** O(1) test whether imgid is currently selected */
+gboolean dt_selection_is_selected(struct dt_selection_t *selection, dt_imgid_t imgid);
 /** selects images range last_single_id to imgid */
 void dt_selection_select_range(struct dt_selection_t *selection, dt_imgid_t imgid);
 /** selects all images from current collection */
@@ -799,200 +799,339 @@ void dt_styles_apply_style_item(dt_develop_t *dev,
   }
 }
 
-void _styles_apply_to_image_ext(const char *name,
-                                const gboolean duplicate,
-                                const gboolean overwrite,
-                                const dt_imgid_t imgid,
-                                const gboolean undo)
+/* load the items of a style as needed for applying it to an image.
+   the returned list can be reused for a whole batch of images as long
+   as multi_priority and iop_order are reset between images, see
+   dt_styles_apply_next() */
+static GList *_styles_load_style_items(const int style_id)
 {
   sqlite3_stmt *stmt;
 
-  const int style_id = dt_styles_get_id_by_name(name);
+  // clang-format off
+  DT_DEBUG_SQLITE3_PREPARE_V2
+    (dt_database_get(darktable.db),
+     "SELECT num, module, operation, op_params, enabled,"
+     "       blendop_params, blendop_version, multi_priority,"
+     "       multi_name, multi_name_hand_edited"
+     " FROM data.style_items WHERE styleid=?1 "
+     " ORDER BY operation, multi_priority",
+     -1, &stmt, NULL);
+  // clang-format on
+  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, style_id);
 
-  if(style_id != 0)
+  GList *si_list = NULL;
+  while(sqlite3_step(stmt) == SQLITE_ROW)
   {
-    dt_imgid_t newimgid = NO_IMGID;
-
-    /* check if we should make a duplicate before applying style */
-    if(duplicate)
-    {
-      newimgid = dt_image_duplicate(imgid);
-      if(dt_is_valid_imgid(newimgid))
-      {
-        if(overwrite)
-          dt_history_delete_on_image_ext(newimgid, FALSE, TRUE);
-        else
-          dt_history_copy_and_paste_on_image(imgid, newimgid, FALSE, NULL, TRUE, TRUE, TRUE);
-      }
-    }
-    else
-      newimgid = imgid;
-
-    // now deal with the history
-    GList *modules_used = NULL;
-
-    dt_develop_t _dev_dest = { 0 };
+    dt_style_item_t *style_item = malloc(sizeof(dt_style_item_t));
+
+    style_item->num = sqlite3_column_int(stmt, 0);
+    style_item->selimg_num = 0;
+    style_item->enabled = sqlite3_column_int(stmt, 4);
+    style_item->multi_priority = sqlite3_column_int(stmt, 7);
+    style_item->name = NULL;
+    style_item->operation = g_strdup((char *)sqlite3_column_text(stmt, 2));
+    style_item->multi_name_hand_edited = sqlite3_column_int(stmt, 9);
+    // see dt_iop_get_instance_name() for why multi_name is handled this way
+    style_item->multi_name =
+      g_strdup((style_item->multi_priority > 0 || style_item->multi_name_hand_edited)
+               ? (char *)sqlite3_column_text(stmt, 8)
+               : "");
+    style_item->module_version = sqlite3_column_int(stmt, 1);
+    style_item->blendop_version = sqlite3_column_int(stmt, 6);
+    style_item->params_size = sqlite3_column_bytes(stmt, 3);
+    style_item->params = (void *)malloc(style_item->params_size);
+    memcpy(style_item->params, (void *)sqlite3_column_blob(stmt, 3),
+           style_item->params_size);
+    style_item->blendop_params_size = sqlite3_column_bytes(stmt, 5);
+    style_item->blendop_params = (void *)malloc(style_item->blendop_params_size);
+    memcpy(style_item->blendop_params, (void *)sqlite3_column_blob(stmt, 5),
+           style_item->blendop_params_size);
+    style_item->iop_order = 0;
+
+    si_list = g_list_prepend(si_list, style_item);
+  }
+  sqlite3_finalize(stmt);
+  // list was built in reverse order, so un-reverse it
+  return g_list_reverse(si_list);
+}
 
-    dt_develop_t *dev_dest = &_dev_dest;
+/* resolve the tags attached to every image a style gets applied to */
+static void _styles_resolve_tags(const char *name,
+                                 guint *tagid,
+                                 guint *changed_tagid)
+{
+  gchar ntag[512] = { 0 };
+  gchar *local_name = dt_util_localize_segmented_name(name, FALSE);
+  g_snprintf(ntag, sizeof(ntag), "darktable|style|%s", local_name);
+  g_free(local_name);
 
-    dt_dev_init(dev_dest, FALSE);
+  if(!dt_tag_new(ntag, tagid)) *tagid = 0;
+  if(!dt_tag_new("darktable|changed", changed_tagid)) *changed_tagid = 0;
+}
 
-    dev_dest->iop = dt_iop_load_modules_ext(dev_dest, TRUE);
-    dev_dest->image_storage.id = imgid;
+/* apply an already loaded style item list to one image.  with
+   deferred_synch the sidecar write and the mipmap-updated signal are
+   left to the caller so a batch can do them once for all images. */
+static dt_imgid_t _styles_apply_prepared(const char *name,
+                                         GList *si_list,
+                                         const gboolean duplicate,
+                                         const gboolean overwrite,
+                                         const dt_imgid_t imgid,
+                                         const gboolean undo,
+                                         const guint tagid,
+                                         const guint changed_tagid,
+                                         const gboolean deferred_synch)
+{
+  dt_imgid_t newimgid = NO_IMGID;
 
-    // now let's deal with the iop-order (possibly merging style & target lists)
-    GList *iop_list = dt_styles_module_order_list(name);
-    if(iop_list)
+  /* check if we should make a duplicate before applying style */
+  if(duplicate)
+  {
+    newimgid = dt_image_duplicate(imgid);
+    if(dt_is_valid_imgid(newimgid))
     {
-      // the style has an iop-order, we need to merge the multi-instance from target image
-      // get target image iop-order list:
-      GList *img_iop_order_list = dt_ioppr_get_iop_order_list(newimgid, FALSE);
-      // get multi-instance modules if any:
-      GList *mi = dt_ioppr_extract_multi_instances_list(img_iop_order_list);
-      // if some where found merge them with the style list
-      if(mi) iop_list = dt_ioppr_merge_multi_instance_iop_order_list(iop_list, mi);
-      // finally we have the final list for the image
-      dt_ioppr_write_iop_order_list(iop_list, newimgid);
-      g_list_free_full(iop_list, g_free);
-      g_list_free_full(img_iop_order_list, g_free);
-      g_list_free_full(mi, g_free);
+      if(overwrite)
+        dt_history_delete_on_image_ext(newimgid, FALSE, TRUE);
+      else
+        dt_history_copy_and_paste_on_image(imgid, newimgid, FALSE, NULL, TRUE, TRUE, TRUE);
     }
+  }
+  else
+    newimgid = imgid;
 
-    dt_dev_read_history_ext(dev_dest, newimgid, TRUE);
+  // now deal with the history
+  GList *modules_used = NULL;
 
-    dt_ioppr_check_iop_order(dev_dest, newimgid, "dt_styles_apply_to_image ");
+  dt_develop_t _dev_dest = { 0 };
 
-    dt_dev_pop_history_items_ext(dev_dest, dev_dest->history_end);
+  dt_develop_t *dev_dest = &_dev_dest;
 
-    dt_ioppr_check_iop_order(dev_dest, newimgid, "dt_styles_apply_to_image 1");
+  dt_dev_init(dev_dest, FALSE);
 
-    dt_print(DT_DEBUG_IOPORDER | DT_DEBUG_PIPE,
-             "[styles_apply_to_image_ext] Apply `%s' on ID=%i, history size %i",
-             name, newimgid, dev_dest->history_end);
+  dev_dest->iop = dt_iop_load_modules_ext(dev_dest, TRUE);
+  dev_dest->image_storage.id = imgid;
 
-    // go through all entries in style
-    // clang-format off
-    DT_DEBUG_SQLITE3_PREPARE_V2
-      (dt_database_get(darktable.db),
-       "SELECT num, module, operation, op_params, enabled,"
-       "       blendop_params, blendop_version, multi_priority,"
-       "       multi_name, multi_name_hand_edited"
-       " FROM data.style_items WHERE styleid=?1 "
-       " ORDER BY operation, multi_priority",
-       -1, &stmt, NULL);
-    // clang-format on
-    DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, style_id);
+  // now let's deal with the iop-order (possibly merging style & target lists)
+  GList *iop_list = dt_styles_module_order_list(name);
+  if(iop_list)
+  {
+    // the style has an iop-order, we need to merge the multi-instance from target image
+    // get target image iop-order list:
+    GList *img_iop_order_list = dt_ioppr_get_iop_order_list(newimgid, FALSE);
+    // get multi-instance modules if any:
+    GList *mi = dt_ioppr_extract_multi_instances_list(img_iop_order_list);
+    // if some where found merge them with the style list
+    if(mi) iop_list = dt_ioppr_merge_multi_instance_iop_order_list(iop_list, mi);
+    // finally we have the final list for the image
+    dt_ioppr_write_iop_order_list(iop_list, newimgid);
+    g_list_free_full(iop_list, g_free);
+    g_list_free_full(img_iop_order_list, g_free);
+    g_list_free_full(mi, g_free);
+  }
 
-    GList *si_list = NULL;
-    while(sqlite3_step(stmt) == SQLITE_ROW)
-    {
-      dt_style_item_t *style_item = malloc(sizeof(dt_style_item_t));
-
-      style_item->num = sqlite3_column_int(stmt, 0);
-      style_item->selimg_num = 0;
-      style_item->enabled = sqlite3_column_int(stmt, 4);
-      style_item->multi_priority = sqlite3_column_int(stmt, 7);
-      style_item->name = NULL;
-      style_item->operation = g_strdup((char *)sqlite3_column_text(stmt, 2));
-      style_item->multi_name_hand_edited = sqlite3_column_int(stmt, 9);
-      // see dt_iop_get_instance_name() for why multi_name is handled this way
-      style_item->multi_name =
-        g_strdup((style_item->multi_priority > 0 || style_item->multi_name_hand_edited)
-                 ? (char *)sqlite3_column_text(stmt, 8)
-                 : "");
-      style_item->module_version = sqlite3_column_int(stmt, 1);
-      style_item->blendop_version = sqlite3_column_int(stmt, 6);
-      style_item->params_size = sqlite3_column_bytes(stmt, 3);
-      style_item->params = (void *)malloc(style_item->params_size);
-      memcpy(style_item->params, (void *)sqlite3_column_blob(stmt, 3),
-             style_item->params_size);
-      style_item->blendop_params_size = sqlite3_column_bytes(stmt, 5);
-      style_item->blendop_params = (void *)malloc(style_item->blendop_params_size);
-      memcpy(style_item->blendop_params, (void *)sqlite3_column_blob(stmt, 5),
-             style_item->blendop_params_size);
-      style_item->iop_order = 0;
-
-      si_list = g_list_prepend(si_list, style_item);
-    }
-    sqlite3_finalize(stmt);
-    si_list = g_list_reverse(si_list); // list was built in reverse order, so un-reverse it
+  dt_dev_read_history_ext(dev_dest, newimgid, TRUE);
 
-    dt_ioppr_update_for_style_items(dev_dest, si_list, FALSE);
+  dt_ioppr_check_iop_order(dev_dest, newimgid, "dt_styles_apply_to_image ");
 
-    for(GList *l = si_list; l; l = g_list_next(l))
-    {
-      dt_style_item_t *style_item = l->data;
-      dt_styles_apply_style_item(dev_dest, style_item, &modules_used, FALSE);
-    }
+  dt_dev_pop_history_items_ext(dev_dest, dev_dest->history_end);
 
-    g_list_free_full(si_list, dt_style_item_free);
+  dt_ioppr_check_iop_order(dev_dest, newimgid, "dt_styles_apply_to_image 1");
 
-    dt_ioppr_check_iop_order(dev_dest, newimgid, "dt_styles_apply_to_image 2");
+  dt_print(DT_DEBUG_IOPORDER | DT_DEBUG_PIPE,
+           "[styles_apply] Apply `%s' on ID=%i, history size %i",
+           name, newimgid, dev_dest->history_end);
 
-    dt_undo_lt_history_t *hist = NULL;
-    if(undo)
-    {
-      hist = dt_history_snapshot_item_init();
-      hist->imgid = newimgid;
-      dt_history_snapshot_undo_create
-        (hist->imgid, &hist->before, &hist->before_history_end);
-    }
+  dt_ioppr_update_for_style_items(dev_dest, si_list, FALSE);
 
-    // write history and forms to db
-    dt_dev_write_history_ext(dev_dest, newimgid);
+  for(GList *l = si_list; l; l = g_list_next(l))
+  {
+    dt_style_item_t *style_item = l->data;
+    dt_styles_apply_style_item(dev_dest, style_item, &modules_used, FALSE);
+  }
 
-    if(undo)
-    {
-      dt_history_snapshot_undo_create(hist->imgid, &hist->after, &hist->after_history_end);
-      dt_undo_start_group(darktable.undo, DT_UNDO_LT_HISTORY);
-      dt_undo_record(darktable.undo, NULL, DT_UNDO_LT_HISTORY, (dt_undo_data_t)hist,
-                     dt_history_snapshot_undo_pop,
-                     dt_history_snapshot_undo_lt_history_data_free);
-      dt_undo_end_group(darktable.undo);
-    }
+  dt_ioppr_check_iop_order(dev_dest, newimgid, "dt_styles_apply_to_image 2");
 
-    dt_dev_cleanup(dev_dest);
+  dt_undo_lt_history_t *hist = NULL;
+  if(undo)
+  {
+    hist = dt_history_snapshot_item_init();
+    hist->imgid = newimgid;
+    dt_history_snapshot_undo_create
+      (hist->imgid, &hist->before, &hist->before_history_end);
+  }
 
-    g_list_free(modules_used);
+  // write history and forms to db
+  dt_dev_write_history_ext(dev_dest, newimgid);
 
-    /* add tag */
-    guint tagid = 0;
-    gchar ntag[512] = { 0 };
-    gchar *local_name = dt_util_localize_segmented_name(name, FALSE);
-    g_snprintf(ntag, sizeof(ntag), "darktable|style|%s", local_name);
-    g_free(local_name);
+  if(undo)
+  {
+    dt_history_snapshot_undo_create(hist->imgid, &hist->after, &hist->after_history_end);
+    dt_undo_start_group(darktable.undo, DT_UNDO_LT_HISTORY);
+    dt_undo_record(darktable.undo, NULL, DT_UNDO_LT_HISTORY, (dt_undo_data_t)hist,
+                   dt_history_snapshot_undo_pop,
+                   dt_history_snapshot_undo_lt_history_data_free);
+    dt_undo_end_group(darktable.undo);
+  }
 
-    if(dt_tag_new(ntag, &tagid)) dt_tag_attach(tagid, newimgid, FALSE, FALSE);
-    if(dt_tag_new("darktable|changed", &tagid))
-    {
-      dt_tag_attach(tagid, newimgid, FALSE, FALSE);
-      dt_image_cache_set_change_timestamp(imgid);
-    }
+  dt_dev_cleanup(dev_dest);
 
-    /* if current image in develop reload history */
-    if(dt_dev_is_current_image(darktable.develop, newimgid))
-    {
-      dt_dev_reload_history_items(darktable.develop);
-      dt_dev_modulegroups_set(darktable.develop,
-                              dt_dev_modulegroups_get(darktable.develop));
-    }
+  g_list_free(modules_used);
 
-    /* remove old obsolete thumbnails */
-    dt_mipmap_cache_remove(newimgid);
-    dt_image_update_final_size(newimgid);
+  /* add tags */
+  if(tagid) dt_tag_attach(tagid, newimgid, FALSE, FALSE);
+  if(changed_tagid)
+  {
+    dt_tag_attach(changed_tagid, newimgid, FALSE, FALSE);
+    dt_image_cache_set_change_timestamp(imgid);
+  }
 
-    /* update the aspect ratio. recompute only if really needed for performance reasons */
-    if(darktable.collection->params.sorts[DT_COLLECTION_SORT_ASPECT_RATIO])
-      dt_image_set_aspect_ratio(newimgid, TRUE);
-    else
-      dt_image_reset_aspect_ratio(newimgid, TRUE);
+  /* if current image in develop reload history */
+  if(dt_dev_is_current_image(darktable.develop, newimgid))
+  {
+    dt_dev_reload_history_items(darktable.develop);
+    dt_dev_modulegroups_set(darktable.develop,
+                            dt_dev_modulegroups_get(darktable.develop));
+  }
 
+  /* remove old obsolete thumbnails */
+  dt_mipmap_cache_remove(newimgid);
+  dt_image_update_final_size(newimgid);
+
+  /* update the aspect ratio. recompute only if really needed for performance reasons */
+  if(darktable.collection->params.sorts[DT_COLLECTION_SORT_ASPECT_RATIO])
+    dt_image_set_aspect_ratio(newimgid, TRUE);
+  else
+    dt_image_reset_aspect_ratio(newimgid, TRUE);
+
+  if(!deferred_synch)
+  {
     /* update xmp file */
     dt_image_synch_xmp(newimgid);
 
     /* redraw center view to update visible mipmaps */
     DT_CONTROL_SIGNAL_RAISE(DT_SIGNAL_DEVELOP_MIPMAP_UPDATED, newimgid);
   }
+
+  return newimgid;
+}
+
+void _styles_apply_to_image_ext(const char *name,
+                                const gboolean duplicate,
+                                const gboolean overwrite,
+                                const dt_imgid_t imgid,
+                                const gboolean undo)
+{
+  const int style_id = dt_styles_get_id_by_name(name);
+  if(style_id == 0) return;
+
+  GList *si_list = _styles_load_style_items(style_id);
+
+  guint tagid = 0, changed_tagid = 0;
+  _styles_resolve_tags(name, &tagid, &changed_tagid);
+
+  _styles_apply_prepared(name, si_list, duplicate, overwrite, imgid, undo,
+                         tagid, changed_tagid, FALSE);
+
+  g_list_free_full(si_list, dt_style_item_free);
+}
+
+typedef struct dt_styles_apply_t
+{
+  gchar *name;
+  GList *si_list;
+  int *multi_priority; // stored values, restored for every image
+  guint tagid;
+  guint changed_tagid;
+  gboolean duplicate;
+  gboolean overwrite;
+  GList *updated;      // ids of the images the style was applied to
+} dt_styles_apply_t;
+
+dt_styles_apply_t *dt_styles_apply_begin(const char *name,
+                                         const gboolean duplicate,
+                                         const gboolean overwrite)
+{
+  const int style_id = dt_styles_get_id_by_name(name);
+  if(style_id == 0) return NULL;
+
+  dt_styles_apply_t *apply = g_malloc0(sizeof(dt_styles_apply_t));
+  apply->name = g_strdup(name);
+  apply->si_list = _styles_load_style_items(style_id);
+  apply->duplicate = duplicate;
+  apply->overwrite = overwrite;
+  _styles_resolve_tags(name, &apply->tagid, &apply->changed_tagid);
+
+  /* applying a style remaps the items' multi-priority for the target
+     image, remember the stored values so every image of the batch
+     starts from the style as saved */
+  apply->multi_priority = g_malloc_n(g_list_length(apply->si_list), sizeof(int));
+  guint i = 0;
+  for(GList *l = apply->si_list; l; l = g_list_next(l))
+    apply->multi_priority[i++] = ((dt_style_item_t *)l->data)->multi_priority;
+
+  /* the whole batch shares one transaction, otherwise every per-image
+     history write pays for its own commit */
+  dt_database_start_transaction(darktable.db);
+
+  return apply;
+}
+
+dt_imgid_t dt_styles_apply_next(dt_styles_apply_t *apply,
+                                const dt_imgid_t imgid)
+{
+  guint i = 0;
+  for(GList *l = apply->si_list; l; l = g_list_next(l))
+  {
+    dt_style_item_t *style_item = l->data;
+    style_item->multi_priority = apply->multi_priority[i++];
+    style_item->iop_order = 0;
+  }
+
+  const dt_imgid_t newimgid =
+    _styles_apply_prepared(apply->name, apply->si_list, apply->duplicate,
+                           apply->overwrite, imgid, TRUE,
+                           apply->tagid, apply->changed_tagid, TRUE);
+  if(dt_is_valid_imgid(newimgid))
+    apply->updated = g_list_prepend(apply->updated, GINT_TO_POINTER(newimgid));
+
+  return newimgid;
+}
+
+void dt_styles_apply_end(dt_styles_apply_t *apply)
+{
+  if(!apply) return;
+
+  dt_database_release_transaction(darktable.db);
+
+  /* one sidecar pass and one summarizing signal for the whole batch */
+  apply->updated = g_list_reverse(apply->updated);
+  dt_image_synch_xmps(apply->updated);
+  if(apply->updated)
+    DT_CONTROL_SIGNAL_RAISE(DT_SIGNAL_DEVELOP_MIPMAP_UPDATED, -1);
+
+  g_list_free(apply->updated);
+  g_list_free_full(apply->si_list, dt_style_item_free);
+  g_free(apply->multi_priority);
+  g_free(apply->name);
+  g_free(apply);
+}
+
+void dt_styles_apply_to_list(const char *name,
+                             const GList *list,
+                             const gboolean duplicate,
+                             const gboolean overwrite)
+{
+  dt_styles_apply_t *apply = dt_styles_apply_begin(name, duplicate, overwrite);
+  if(!apply) return;
+
+  for(const GList *l = list; l; l = g_list_next(l))
+  {
+    const dt_imgid_t imgid = GPOINTER_TO_INT(l->data);
+    if(dt_is_valid_imgid(imgid))
+      dt_styles_apply_next(apply, imgid);
+  }
+
+  dt_styles_apply_end(apply);
 }
 
 void dt_styles_apply_to_image(const char *name,
@@ -102,6 +102,25 @@ void dt_styles_apply_to_image(const char *name,
                               const gboolean overwrite,
                               const dt_imgid_t imgid);
 
+/** bulk application of one style to many images.  begin loads the
+    style items and tags once and opens a transaction shared by the
+    whole batch, next applies the style to one image, end commits and
+    does a single sidecar pass and mipmap-updated signal for all
+    touched images.  begin returns NULL for an unknown style name. */
+typedef struct dt_styles_apply_t dt_styles_apply_t;
+dt_styles_apply_t *dt_styles_apply_begin(const char *name,
+                                         const gboolean duplicate,
+                                         const gboolean overwrite);
+dt_imgid_t dt_styles_apply_next(dt_styles_apply_t *apply,
+                                const dt_imgid_t imgid);
+void dt_styles_apply_end(dt_styles_apply_t *apply);
+
+/** convenience wrapper around the above for a list of image ids */
+void dt_styles_apply_to_list(const char *name,
+                             const GList *list,
+                             const gboolean duplicate,
+                             const gboolean overwrite);
+
 /** applies the style to the currently edited image in the darkroom.
     does nothing if not called with a proper dev struct initialized */
 void dt_styles_apply_to_dev(const char *name, const dt_imgid_t imgid);
@@ -427,6 +427,9 @@ static gboolean _tag_execute(const GList *tags,
                              const gint action)
 {
   gboolean res = FALSE;
+  // coalesce the per-image writes below into one transaction,
+  // otherwise tagging a large selection pays a commit per image
+  dt_database_start_transaction(darktable.db);
   for(const GList *images = imgs; images; images = g_list_next(images))
   {
     const dt_imgid_t image_id = GPOINTER_TO_INT(images->data);
@@ -465,6 +468,7 @@ static gboolean _tag_execute(const GList *tags,
     else
       _undo_tags_free(undotags);
   }
+  dt_database_release_transaction(darktable.db);
   return res;
 }
 
@@ -611,6 +615,26 @@ gboolean dt_tag_detach_images(const guint tagid,
   return FALSE;
 }
 
+gboolean dt_tag_detach_tags(const GList *tags,
+                            const GList *img,
+                            const gboolean undo_on)
+{
+  if(g_list_is_empty(tags) || g_list_is_empty(img)) return FALSE;
+
+  GList *undo = NULL;
+  if(undo_on) dt_undo_start_group(darktable.undo, DT_UNDO_TAGS);
+
+  const gboolean res = _tag_execute(tags, img, &undo, undo_on, DT_TA_DETACH);
+
+  if(undo_on)
+  {
+    dt_undo_record(darktable.undo, NULL, DT_UNDO_TAGS, undo,
+                   _pop_undo, _tags_undo_data_free);
+    dt_undo_end_group(darktable.undo);
+  }
+  return res;
+}
+
 gboolean dt_tag_detach(const guint tagid,
                        const dt_imgid_t imgid,
                        const gboolean undo_on,
@@ -136,6 +136,12 @@ gboolean dt_tag_attach_string_list(const gchar *tags,
 gboolean dt_tag_detach_images(const guint tagid,
                               const GList *img,
                               const gboolean undo_on);
+/** detach a list of tags from a list of images in one go. \param[in]
+ * tags a list of ids of tags. \param[in] img the list of image id to
+ * detach the tags from */
+gboolean dt_tag_detach_tags(const GList *tags,
+                            const GList *img,
+                            const gboolean undo_on);
 /** detach tag from images. \param[in] tagid of tag to
  * detach. \param[in] imgid the image id to detach tag from, if < 0
  * images to act on are used. */
@@ -0,0 +1,211 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2025 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/thumbinfo.h"
+#include "common/collection.h"
+#include "common/database.h"
+#include "common/debug.h"
+#include "common/image.h"
+#include "control/signal.h"
+
+// when a change signal lists more images than this we drop the whole
+// index and rebuild it in one query instead of issuing a lookup per id
+#define DT_THUMBINFO_REFRESH_LIMIT 1000
+
+static struct
+{
+  dt_pthread_mutex_t lock;
+  GHashTable *rows;   // imgid -> dt_thumbinfo_t *
+  gboolean valid;     // FALSE until the next lookup rebuilds the index
+} _index = { 0 };
+
+// every column the overlays need, in one pass.  the subselects are all
+// resolved through indexes so this stays cheap even for large
+// libraries.  the altered expression has to stay in sync with
+// dt_history_hash_get_status().
+// clang-format off
+#define DT_THUMBINFO_QUERY                                               \
+  "SELECT mi.id, mi.flags, mi.group_id, mi.filename,"                    \
+  "       (SELECT SUM(1 << color)"                                       \
+  "          FROM main.color_labels WHERE imgid = mi.id),"               \
+  "       (SELECT (basic_hash IS NULL OR current_hash != basic_hash)"    \
+  "           AND (auto_hash IS NULL OR current_hash != auto_hash)"      \
+  "          FROM main.history_hash WHERE imgid = mi.id),"               \
+  "       EXISTS (SELECT 1 FROM main.images AS grp"                      \
+  "                WHERE grp.group_id = mi.group_id AND grp.id != mi.id)"\
+  "  FROM main.images AS mi"
+// clang-format on
+
+static void _thumbinfo_row_from_stmt(sqlite3_stmt *stmt)
+{
+  const dt_imgid_t imgid = sqlite3_column_int(stmt, 0);
+  dt_thumbinfo_t *row = g_hash_table_lookup(_index.rows, GINT_TO_POINTER(imgid));
+  if(!row)
+  {
+    row = g_malloc0(sizeof(dt_thumbinfo_t));
+    g_hash_table_insert(_index.rows, GINT_TO_POINTER(imgid), row);
+  }
+  row->flags = sqlite3_column_int(stmt, 1);
+  row->groupid = sqlite3_column_int(stmt, 2);
+  row->colorlabels = sqlite3_column_int(stmt, 4);
+  row->altered = sqlite3_column_int(stmt, 5) != 0;
+  row->grouped = sqlite3_column_int(stmt, 6) != 0;
+
+  // go through the regular flag helpers instead of duplicating their
+  // logic; they only look at the flags and the filename extension
+  dt_image_t img = { 0 };
+  img.flags = row->flags;
+  const char *filename = (const char *)sqlite3_column_text(stmt, 3);
+  if(filename) g_strlcpy(img.filename, filename, sizeof(img.filename));
+  row->bw = dt_image_monochrome_flags(&img);
+  row->bw_flow = dt_image_use_monochrome_workflow(&img);
+  row->hdr = dt_image_is_hdr(&img);
+}
+
+// rebuild the whole index in one query. called with the lock held.
+static void _thumbinfo_refresh_all(void)
+{
+  g_hash_table_remove_all(_index.rows);
+
+  sqlite3_stmt *stmt = NULL;
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                              DT_THUMBINFO_QUERY, -1, &stmt, NULL);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+    _thumbinfo_row_from_stmt(stmt);
+  sqlite3_finalize(stmt);
+
+  _index.valid = TRUE;
+  dt_print(DT_DEBUG_CACHE, "[thumbinfo] index rebuilt for %u images",
+           g_hash_table_size(_index.rows));
+}
+
+// refresh the record of a single image. called with the lock held.
+static void _thumbinfo_refresh_one(const dt_imgid_t imgid)
+{
+  sqlite3_stmt *stmt =
+    dt_database_get_statement(darktable.db, DT_THUMBINFO_QUERY " WHERE mi.id = ?1");
+  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, imgid);
+  if(sqlite3_step(stmt) == SQLITE_ROW)
+    _thumbinfo_row_from_stmt(stmt);
+  else
+    g_hash_table_remove(_index.rows, GINT_TO_POINTER(imgid));
+  dt_database_release_statement(darktable.db, stmt);
+}
+
+static void _thumbinfo_refresh_list(const GList *imgs)
+{
+  dt_pthread_mutex_lock(&_index.lock);
+  if(_index.valid)
+  {
+    if(g_list_length((GList *)imgs) > DT_THUMBINFO_REFRESH_LIMIT)
+      _index.valid = FALSE;
+    else
+      for(const GList *l = imgs; l; l = g_list_next(l))
+        _thumbinfo_refresh_one(GPOINTER_TO_INT(l->data));
+  }
+  dt_pthread_mutex_unlock(&_index.lock);
+}
+
+static void _thumbinfo_image_info_changed_callback(gpointer instance,
+                                                   gpointer imgs,
+                                                   gpointer user_data)
+{
+  _thumbinfo_refresh_list((GList *)imgs);
+}
+
+static void _thumbinfo_collection_changed_callback(gpointer instance,
+                                                   dt_collection_change_t query_change,
+                                                   dt_collection_properties_t changed_property,
+                                                   gpointer imgs,
+                                                   const int next,
+                                                   gpointer user_data)
+{
+  if(imgs)
+    _thumbinfo_refresh_list((GList *)imgs);
+  else
+  {
+    // global change without an image list, start over on next lookup
+    dt_pthread_mutex_lock(&_index.lock);
+    _index.valid = FALSE;
+    dt_pthread_mutex_unlock(&_index.lock);
+  }
+}
+
+static void _thumbinfo_mipmap_updated_callback(gpointer instance,
+                                               const dt_imgid_t imgid,
+                                               gpointer user_data)
+{
+  // a flushed mipmap means the history may have changed, refresh the
+  // altered flag of that image
+  if(!dt_is_valid_imgid(imgid)) return;
+  dt_pthread_mutex_lock(&_index.lock);
+  if(_index.valid) _thumbinfo_refresh_one(imgid);
+  dt_pthread_mutex_unlock(&_index.lock);
+}
+
+void dt_thumbinfo_init(void)
+{
+  dt_pthread_mutex_init(&_index.lock, NULL);
+  _index.rows = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+  _index.valid = FALSE;
+
+  DT_CONTROL_SIGNAL_CONNECT(DT_SIGNAL_IMAGE_INFO_CHANGED,
+                            _thumbinfo_image_info_changed_callback, NULL);
+  DT_CONTROL_SIGNAL_CONNECT(DT_SIGNAL_COLLECTION_CHANGED,
+                            _thumbinfo_collection_changed_callback, NULL);
+  DT_CONTROL_SIGNAL_CONNECT(DT_SIGNAL_DEVELOP_MIPMAP_UPDATED,
+                            _thumbinfo_mipmap_updated_callback, NULL);
+}
+
+void dt_thumbinfo_cleanup(void)
+{
+  if(!_index.rows) return;
+  DT_CONTROL_SIGNAL_DISCONNECT(_thumbinfo_image_info_changed_callback, NULL);
+  DT_CONTROL_SIGNAL_DISCONNECT(_thumbinfo_collection_changed_callback, NULL);
+  DT_CONTROL_SIGNAL_DISCONNECT(_thumbinfo_mipmap_updated_callback, NULL);
+  g_hash_table_destroy(_index.rows);
+  _index.rows = NULL;
+  dt_pthread_mutex_destroy(&_index.lock);
+}
+
+gboolean dt_thumbinfo_get(const dt_imgid_t imgid, dt_thumbinfo_t *info)
+{
+  if(!_index.rows || !dt_is_valid_imgid(imgid)) return FALSE;
+
+  dt_pthread_mutex_lock(&_index.lock);
+  if(!_index.valid) _thumbinfo_refresh_all();
+
+  dt_thumbinfo_t *row = g_hash_table_lookup(_index.rows, GINT_TO_POINTER(imgid));
+  if(!row)
+  {
+    // unknown id, typically a freshly imported image. refresh it on
+    // the spot so the miss heals itself.
+    _thumbinfo_refresh_one(imgid);
+    row = g_hash_table_lookup(_index.rows, GINT_TO_POINTER(imgid));
+  }
+  if(row) *info = *row;
+  dt_pthread_mutex_unlock(&_index.lock);
+
+  return row != NULL;
+}
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
@@ -0,0 +1,56 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2025 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/darktable.h"
+
+G_BEGIN_DECLS
+
+/* compact per-image record of everything the thumbnail overlays need
+ * to paint a cell.  kept in a library-wide in-memory index so that
+ * scrolling the thumbtable never has to touch sqlite or take the image
+ * cache mutex for every visible cell. */
+typedef struct dt_thumbinfo_t
+{
+  uint32_t flags;     // images.flags: rating, rejected and local-copy bits
+  dt_imgid_t groupid;
+  int colorlabels;    // bit n set when color label n (0=red .. 4=purple) is attached
+  int bw;             // dt_image_monochrome_flags() of the image
+  gboolean bw_flow;   // dt_image_use_monochrome_workflow()
+  gboolean hdr;       // dt_image_is_hdr()
+  gboolean altered;   // dt_image_altered()
+  gboolean grouped;   // another image shares the group
+} dt_thumbinfo_t;
+
+/** set up the index and listen to the signals that invalidate it */
+void dt_thumbinfo_init(void);
+/** drop the index and disconnect from signals */
+void dt_thumbinfo_cleanup(void);
+/** look up the record for an image, filling *info on success.  a miss
+ * is refreshed from the database on the spot, so FALSE is only
+ * returned for images unknown to the library. */
+gboolean dt_thumbinfo_get(const dt_imgid_t imgid, dt_thumbinfo_t *info);
+
+G_END_DECLS
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
@@ -0,0 +1,153 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2026 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/trace.h"
+#include "common/file_location.h"
+
+#include <glib/gstdio.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// number of events kept; older events are overwritten so a long session
+// still yields the recent history.  64k events of 128 bytes are 8 MB,
+// only allocated when tracing was requested.
+#define DT_TRACE_EVENTS (1 << 16)
+#define DT_TRACE_NAME_LEN 96
+
+typedef struct dt_trace_event_t
+{
+  double start;       // seconds since dt_trace_init()
+  double dur;         // seconds
+  uint32_t tid;
+  const char *category; // static string, not copied
+  char name[DT_TRACE_NAME_LEN];
+} dt_trace_event_t;
+
+static dt_trace_event_t *_events = NULL;
+static gint _next = 0; // total number of recorded events, ring index modulo
+static double _clock_base = 0.0;
+
+void dt_trace_init(void)
+{
+  if(!(darktable.unmuted & DT_DEBUG_TRACE)) return;
+
+  _events = calloc(DT_TRACE_EVENTS, sizeof(dt_trace_event_t));
+  if(!_events)
+  {
+    dt_print(DT_DEBUG_ALWAYS, "[trace] can't allocate event buffer, tracing disabled");
+    return;
+  }
+  _next = 0;
+  _clock_base = dt_get_wtime();
+}
+
+double dt_trace_begin(void)
+{
+  return _events ? dt_get_wtime() : 0.0;
+}
+
+void dt_trace_end(const char *category,
+                  const double start,
+                  const char *msg,
+                  ...)
+{
+  if(!_events || start == 0.0) return;
+
+  const double end = dt_get_wtime();
+  /* claiming the slot is atomic; a dump racing with the rewrite of an old
+     slot may see a torn event, which is acceptable for a diagnostic tool */
+  const guint slot = (guint)g_atomic_int_add(&_next, 1) % DT_TRACE_EVENTS;
+  dt_trace_event_t *ev = &_events[slot];
+  ev->start = start - _clock_base;
+  ev->dur = end - start;
+  ev->tid = (uint32_t)(uintptr_t)g_thread_self();
+  ev->category = category;
+
+  va_list ap;
+  va_start(ap, msg);
+  vsnprintf(ev->name, sizeof(ev->name), msg, ap);
+  va_end(ap);
+}
+
+// write a string as JSON, escaping the characters that may occur in
+// event names built from file names or job descriptions
+static void _write_json_string(FILE *f, const char *str)
+{
+  for(const char *p = str; *p; p++)
+  {
+    const unsigned char c = *p;
+    if(c == '"' || c == '\\')
+      fprintf(f, "\\%c", c);
+    else if(c < 0x20)
+      fprintf(f, "\\u%04x", c);
+    else
+      fputc(c, f);
+  }
+}
+
+gboolean dt_trace_dump(const char *filename)
+{
+  if(!_events) return FALSE;
+
+  FILE *f = g_fopen(filename, "wb");
+  if(!f)
+  {
+    dt_print(DT_DEBUG_ALWAYS, "[trace] can't write `%s'", filename);
+    return FALSE;
+  }
+
+  const guint total = (guint)g_atomic_int_get(&_next);
+  const guint count = MIN(total, DT_TRACE_EVENTS);
+  const guint first = total - count;
+
+  fprintf(f, "{\"traceEvents\":[\n");
+  for(guint i = 0; i < count; i++)
+  {
+    const dt_trace_event_t *ev = &_events[(first + i) % DT_TRACE_EVENTS];
+    fprintf(f, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.1f,\"dur\":%.1f,\"cat\":\"%s\",\"name\":\"",
+            i ? ",\n" : "", ev->tid, ev->start * 1e6, ev->dur * 1e6, ev->category);
+    _write_json_string(f, ev->name);
+    fprintf(f, "\"}");
+  }
+  fprintf(f, "\n]}\n");
+  fclose(f);
+
+  dt_print(DT_DEBUG_ALWAYS, "[trace] %u events written to `%s'", count, filename);
+  return TRUE;
+}
+
+void dt_trace_cleanup(void)
+{
+  if(!_events) return;
+
+  char cachedir[PATH_MAX] = { 0 };
+  dt_loc_get_user_cache_dir(cachedir, sizeof(cachedir));
+  gchar *filename = g_strdup_printf("%s/darktable-trace-%d.json", cachedir, (int)getpid());
+  dt_trace_dump(filename);
+  g_free(filename);
+
+  free(_events);
+  _events = NULL;
+}
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
@@ -0,0 +1,65 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2026 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/darktable.h"
+
+G_BEGIN_DECLS
+
+/* lightweight runtime tracing, enabled with '-d trace'.
+
+   while the -d perf prints give flat per-call timings, the tracer keeps
+   the most recent begin/end events with their thread in a ring buffer
+   and writes them as chrome://tracing JSON on shutdown (or on demand via
+   dt_trace_dump()), so slowdowns can be inspected on a timeline instead
+   of by log archaeology.  instrumenting a section costs one
+   dt_get_wtime() plus a buffer slot and is a no-op when tracing is off:
+
+     const double trace_start = dt_trace_begin();
+     ... work ...
+     dt_trace_end("category", trace_start, "name of %s", what);
+*/
+
+// allocates the event buffer if '-d trace' was given
+void dt_trace_init(void);
+
+// writes the collected events to the default location and frees the buffer
+void dt_trace_cleanup(void);
+
+// returns the begin timestamp of a traced section, 0.0 while tracing is off
+double dt_trace_begin(void);
+
+// records a complete event for the section begun at 'start'; no-op when
+// tracing is off or 'start' is 0.0
+void dt_trace_end(const char *category,
+                  const double start,
+                  const char *msg,
+                  ...)
+  __attribute__((format(printf, 3, 4)));
+
+// writes the accumulated events as chrome://tracing JSON, returns success
+gboolean dt_trace_dump(const char *filename);
+
+G_END_DECLS
+
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
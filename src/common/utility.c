@@ -16,6 +16,10 @@
     along with darktable.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#ifdef __linux__
+#define _GNU_SOURCE // for copy_file_range()
+#endif
+
 #include <locale.h>
 
 #include "common/darktable.h"
@@ -40,6 +44,13 @@
   #include <FileAPI.h>
 #endif
 
+#ifdef __linux__
+  #include <fcntl.h>
+  #include <sys/ioctl.h>
+  #include <unistd.h>
+  #include <linux/fs.h>
+#endif
+
 #include <math.h>
 #include <glib/gi18n.h>
 
@@ -965,9 +976,64 @@ char *dt_read_file(const char *const filename,
   return NULL;
 }
 
+#ifdef __linux__
+// fast copy path: first try to reflink the file, which is an instant
+// copy-on-write clone on filesystems supporting it (btrfs, xfs, ...),
+// then fall back to an in-kernel copy_file_range() loop which at least
+// avoids bouncing the file contents through a userspace buffer. returns
+// FALSE when neither applies (cross device copy on an old kernel,
+// special files, ...) so the caller can do a plain buffered copy.
+static gboolean _copy_file_fast(const char *sourcefile,
+                                const char *destination)
+{
+  gboolean done = FALSE;
+
+  const int fd_in = open(sourcefile, O_RDONLY);
+  if(fd_in < 0) return FALSE;
+
+  struct stat st;
+  if(fstat(fd_in, &st) == 0 && S_ISREG(st.st_mode))
+  {
+    const int fd_out = open(destination, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if(fd_out >= 0)
+    {
+#ifdef FICLONE
+      if(ioctl(fd_out, FICLONE, fd_in) == 0)
+        done = TRUE;
+      else
+#endif
+      {
+        off_t remaining = st.st_size;
+        done = TRUE;
+        while(remaining > 0)
+        {
+          const ssize_t copied = copy_file_range(fd_in, NULL, fd_out, NULL, remaining, 0);
+          if(copied <= 0)
+          {
+            done = FALSE;
+            break;
+          }
+          remaining -= copied;
+        }
+      }
+      if(close(fd_out) != 0) done = FALSE;
+      // don't leave a partial destination behind, the fallback will recreate it
+      if(!done) unlink(destination);
+    }
+  }
+
+  close(fd_in);
+  return done;
+}
+#endif
+
 void dt_copy_file(const char *const sourcefile,
                   const char *destination)
 {
+#ifdef __linux__
+  if(_copy_file_fast(sourcefile, destination)) return;
+#endif
+
   char *content = NULL;
   FILE *fin = g_fopen(sourcefile, "rb");
   FILE *fout = g_fopen(destination, "wb");
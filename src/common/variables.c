@@ -73,6 +73,12 @@ typedef struct dt_variables_data_t
   char *pictures_folder;
   const char *file_ext;
 
+  // legacy-alias rewrite of the last source pattern, cached so that
+  // expanding the same pattern for every image of an export session
+  // doesn't redo the replacements each time
+  char *alias_source;
+  char *alias_result;
+
   gboolean have_exif_dt;
   gboolean show_msec;
   int exif_iso;
@@ -112,15 +118,6 @@ static void _init_expansion(dt_variables_params_t *params, gboolean iterate)
 {
   if(iterate) params->data->sequence++;
 
-  params->data->homedir = dt_loc_get_home_dir(NULL);
-
-  if(g_get_user_special_dir(G_USER_DIRECTORY_PICTURES) == NULL)
-    params->data->pictures_folder =
-      g_build_path(G_DIR_SEPARATOR_S, params->data->homedir, "Pictures", (char *)NULL);
-  else
-    params->data->pictures_folder =
-      g_strdup(g_get_user_special_dir(G_USER_DIRECTORY_PICTURES));
-
   if(params->filename)
   {
     params->data->file_ext = (g_strrstr(params->filename, ".") + 1);
@@ -255,10 +252,6 @@ static void _cleanup_expansion(dt_variables_params_t *params)
     g_free(params->data->camera_alias);
     params->data->camera_alias = NULL;
   }
-  g_free(params->data->homedir);
-  params->data->homedir = NULL;
-  g_free(params->data->pictures_folder);
-  params->data->pictures_folder = NULL;
 }
 
 static inline gboolean _has_prefix(char **str, const char *prefix)
@@ -1387,10 +1380,19 @@ char *dt_variables_expand(dt_variables_params_t *params,
 {
   _init_expansion(params, iterate);
 
-  gchar *aliased_source = _legacy_aliases(source);
-  gchar *nsource = aliased_source;
+  // the legacy-alias rewrite only depends on the pattern, so cache its
+  // result for the common case of the same pattern expanded once per
+  // image of an export session
+  if(g_strcmp0(source, params->data->alias_source))
+  {
+    g_free(params->data->alias_source);
+    g_free(params->data->alias_result);
+    params->data->alias_source = g_strdup(source);
+    params->data->alias_result = _legacy_aliases(source);
+  }
+
+  gchar *nsource = params->data->alias_result;
   char *result = _expand_source(params, &nsource, '\0');
-  g_free(aliased_source);
 
   _cleanup_expansion(params);
   return result;
@@ -1402,6 +1404,17 @@ void dt_variables_params_init(dt_variables_params_t **params)
   (*params)->data = g_malloc0(sizeof(dt_variables_data_t));
   (*params)->data->time = g_date_time_new_now_local();
   (*params)->data->exif_time = NULL;
+
+  // constant for the lifetime of the params, no need to redo the lookups
+  // for every expanded image
+  (*params)->data->homedir = dt_loc_get_home_dir(NULL);
+  if(g_get_user_special_dir(G_USER_DIRECTORY_PICTURES) == NULL)
+    (*params)->data->pictures_folder =
+      g_build_path(G_DIR_SEPARATOR_S, (*params)->data->homedir, "Pictures", (char *)NULL);
+  else
+    (*params)->data->pictures_folder =
+      g_strdup(g_get_user_special_dir(G_USER_DIRECTORY_PICTURES));
+
   (*params)->sequence = -1;
   (*params)->img = NULL;
 }
@@ -1417,6 +1430,10 @@ void dt_variables_params_destroy(dt_variables_params_t *params)
   g_free(params->data->exif_lens);
   g_free(params->data->camera_maker);
   g_free(params->data->camera_alias);
+  g_free(params->data->homedir);
+  g_free(params->data->pictures_folder);
+  g_free(params->data->alias_source);
+  g_free(params->data->alias_result);
   g_free(params->data);
   g_free(params);
 }
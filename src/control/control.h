@@ -182,7 +182,9 @@ typedef struct dt_control_t
   dt_atomic_int quitting;
   dt_atomic_int pending_jobs;
   gboolean cups_started;
-  gboolean export_scheduled;
+  // number of export jobs currently scheduled. normally capped at one,
+  // but otherwise idle workers may steal additional export jobs.
+  int export_jobs_running;
   dt_pthread_mutex_t queue_mutex, cond_mutex;
   pthread_cond_t cond;
   int32_t num_threads;
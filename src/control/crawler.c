@@ -110,11 +110,63 @@ static void _set_modification_time(char *filename,
 #define FAST_UPDATE 0.2
 #define SLOW_UPDATE 1.0
 
-GList *dt_control_crawler_run(void)
+// how many images to process between short naps when crawling in the background
+#define CRAWL_CHUNK 100
+
+// get the modification time of a film roll's folder, or 0 if it can't be determined
+static time_t _folder_mtime(const char *folder)
+{
+  GFile *gfile = g_file_new_for_path(folder);
+  GFileInfo *info = g_file_query_info(gfile,
+                                      G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                                      G_FILE_QUERY_INFO_NONE,
+                                      NULL,
+                                      NULL);
+  time_t mtime = 0;
+  if(info)
+  {
+    mtime = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+    g_object_unref(info);
+  }
+  g_object_unref(gfile);
+  return mtime;
+}
+
+// list a film roll's folder in one enumeration, mapping file name to
+// modification time. the enumerator fetches both attributes in bulk
+// (READDIRPLUS on nfs), so the per-image checks in the crawl loop below
+// become pure hash lookups instead of one filesystem roundtrip each.
+static GHashTable *_list_directory(const char *folder)
+{
+  GHashTable *files = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  GFile *gfolder = g_file_new_for_path(folder);
+  GFileEnumerator *enumerator =
+    g_file_enumerate_children(gfolder,
+                              G_FILE_ATTRIBUTE_STANDARD_NAME ","
+                              G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                              G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  if(enumerator)
+  {
+    GFileInfo *info;
+    while((info = g_file_enumerator_next_file(enumerator, NULL, NULL)) != NULL)
+    {
+      const guint64 mtime = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+      g_hash_table_insert(files, g_strdup(g_file_info_get_name(info)),
+                          GSIZE_TO_POINTER((gsize)mtime));
+      g_object_unref(info);
+    }
+    g_object_unref(enumerator);
+  }
+  g_object_unref(gfolder);
+  return files;
+}
+
+GList *dt_control_crawler_run(dt_job_t *job)
 {
   sqlite3_stmt *stmt, *inner_stmt;
   GList *result = NULL;
   const gboolean look_for_xmp = dt_image_get_xmp_mode() != DT_WRITE_XMP_NEVER;
+  const time_t crawl_start = time(NULL);
 
   int total_images = 1;
   // clang-format off
@@ -127,10 +179,38 @@ GList *dt_control_crawler_run(void)
     sqlite3_finalize(stmt);
   }
 
+  // a film roll whose folder timestamp hasn't moved since the last
+  // completed crawl can't have gained or lost any sidecars or
+  // associated files (writers that replace a sidecar do so via a
+  // temp-file rename which also touches the directory), so all of its
+  // images can be skipped without touching the disk.  one stat per
+  // film instead of one per image is what makes a warm start on a big
+  // library fast.
+  GHashTable *skip_films = g_hash_table_new(g_direct_hash, g_direct_equal);
+  int total_films = 0;
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                              "SELECT id, folder, last_crawl FROM main.film_rolls",
+                              -1, &stmt, NULL);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    const dt_filmid_t filmid = sqlite3_column_int(stmt, 0);
+    const char *folder = (const char *)sqlite3_column_text(stmt, 1);
+    const time_t last_crawl = sqlite3_column_int64(stmt, 2);
+    const time_t mtime = _folder_mtime(folder);
+    ++total_films;
+    if(mtime > 0 && mtime + MAX_TIME_SKEW < last_crawl)
+      g_hash_table_add(skip_films, GINT_TO_POINTER(filmid));
+  }
+  sqlite3_finalize(stmt);
+  if(g_hash_table_size(skip_films) > 0)
+    dt_print(DT_DEBUG_CONTROL, "[crawler] skipping %d of %d unchanged film rolls",
+             g_hash_table_size(skip_films), total_films);
+
   // clang-format off
   sqlite3_prepare_v2(dt_database_get(darktable.db),
                      "SELECT i.id, write_timestamp, version,"
-                     "       folder || '" G_DIR_SEPARATOR_S "' || filename, flags"
+                     "       folder || '" G_DIR_SEPARATOR_S "' || filename, flags,"
+                     "       i.film_id, filename, folder"
                      " FROM main.images i, main.film_rolls f"
                      " ON i.film_id = f.id"
                      " ORDER BY f.id, filename",
@@ -144,6 +224,9 @@ GList *dt_control_crawler_run(void)
   dt_database_start_transaction(darktable.db);
 
   int image_count = 0;
+  // the listing of the folder of the film roll we are currently walking
+  GHashTable *dir_files = NULL;
+  dt_filmid_t listed_film = NO_FILMID;
   const double start_time = dt_get_wtime();
   // set the "previous update" time to 10ms after a notional previous
   // update to ensure visibility of the first update (which might not
@@ -157,6 +240,7 @@ GList *dt_control_crawler_run(void)
     const int version = sqlite3_column_int(stmt, 2);
     const gchar *image_path = (char *)sqlite3_column_text(stmt, 3);
     int flags = sqlite3_column_int(stmt, 4);
+    const dt_filmid_t film_id = sqlite3_column_int(stmt, 5);
     ++image_count;
 
     // update the progress message - five times per second for first four seconds, then once per second
@@ -164,14 +248,36 @@ GList *dt_control_crawler_run(void)
     if(curr_time >= last_time + ((curr_time - start_time > 4.0) ? SLOW_UPDATE : FAST_UPDATE))
     {
       const double fraction = image_count / (double)total_images;
-      darktable_splash_screen_set_progress_percent(_("checking for updated sidecar files (%d%%)"),
-                                                   fraction,
-                                                   curr_time - start_time);
+      if(job)
+        dt_control_job_set_progress(job, fraction);
+      else
+        darktable_splash_screen_set_progress_percent(_("checking for updated sidecar files (%d%%)"),
+                                                     fraction,
+                                                     curr_time - start_time);
       last_time = curr_time;
     }
 
+    // images in unchanged film rolls don't need any filesystem checks
+    if(g_hash_table_contains(skip_films, GINT_TO_POINTER(film_id)))
+      continue;
+
+    // when running in the background take a short nap every so often
+    // to keep the disk available for interactive work
+    if(job && image_count % CRAWL_CHUNK == 0)
+      g_usleep(10000);
+
+    // walking a new film roll: fetch its folder listing in one go
+    if(film_id != listed_film)
+    {
+      if(dir_files) g_hash_table_destroy(dir_files);
+      dir_files = _list_directory((const char *)sqlite3_column_text(stmt, 7));
+      listed_film = film_id;
+    }
+
+    const gchar *filename = (const char *)sqlite3_column_text(stmt, 6);
+
     // if the image is missing we ignore it.
-    if(!g_file_test(image_path, G_FILE_TEST_EXISTS))
+    if(!g_hash_table_contains(dir_files, filename))
     {
       dt_print(DT_DEBUG_CONTROL, "[crawler] `%s' (id: %d) is missing", image_path, id);
       continue;
@@ -192,32 +298,21 @@ GList *dt_control_crawler_run(void)
       xmp_path[len++] = 'p';
       xmp_path[len] = '\0';
 
-      // on Windows the encoding might not be UTF8
-      gchar *xmp_path_locale = dt_util_normalize_path(xmp_path);
-      int stat_res = -1;
-#ifdef _WIN32
-      // UTF8 paths fail in this context, but converting to UTF16 works
-      struct _stati64 statbuf;
-      if(xmp_path_locale) // in Windows dt_util_normalize_path returns
-                          // NULL if file does not exist
-      {
-        wchar_t *wfilename = g_utf8_to_utf16(xmp_path_locale, -1, NULL, NULL, NULL);
-        stat_res = _wstati64(wfilename, &statbuf);
-        g_free(wfilename);
-      }
- #else
-      struct stat statbuf;
-      stat_res = stat(xmp_path_locale, &statbuf);
-#endif
-      g_free(xmp_path_locale);
-      if(stat_res) continue; // TODO: shall we report these?
+      // the modification time comes from the folder listing, so no
+      // extra stat and no locale dance around the path is needed here
+      const char *sep = strrchr(xmp_path, G_DIR_SEPARATOR);
+      const char *xmp_name = sep ? sep + 1 : xmp_path;
+      gpointer mtime_value = NULL;
+      if(!g_hash_table_lookup_extended(dir_files, xmp_name, NULL, &mtime_value))
+        continue; // TODO: shall we report these?
+      const time_t xmp_mtime = (time_t)GPOINTER_TO_SIZE(mtime_value);
 
       // step 1: check if the xmp is newer than our db entry
-      if(timestamp + MAX_TIME_SKEW < statbuf.st_mtime)
+      if(timestamp + MAX_TIME_SKEW < xmp_mtime)
       {
         dt_control_crawler_result_t *item = malloc(sizeof(dt_control_crawler_result_t));
         item->id = id;
-        item->timestamp_xmp = statbuf.st_mtime;
+        item->timestamp_xmp = xmp_mtime;
         item->timestamp_db = timestamp;
         item->image_path = g_strdup(image_path);
         item->xmp_path = g_strdup(xmp_path);
@@ -231,40 +326,40 @@ GList *dt_control_crawler_run(void)
     }
 
     // step 2: check if the image has associated files (.txt, .wav)
-    size_t len = strlen(image_path);
-    const char *c = image_path + len;
-    while((c > image_path) && (*c != '.')) c--;
-    len = c - image_path + 1;
+    size_t len = strlen(filename);
+    const char *c = filename + len;
+    while((c > filename) && (*c != '.')) c--;
+    len = c - filename + 1;
 
     char *extra_path = calloc(len + 3 + 1, sizeof(char));
     if(extra_path)
     {
-      g_strlcpy(extra_path, image_path, len + 1);
+      g_strlcpy(extra_path, filename, len + 1);
 
       extra_path[len] = 't';
       extra_path[len + 1] = 'x';
       extra_path[len + 2] = 't';
-      gboolean has_txt = g_file_test(extra_path, G_FILE_TEST_EXISTS);
+      gboolean has_txt = g_hash_table_contains(dir_files, extra_path);
 
       if(!has_txt)
       {
         extra_path[len] = 'T';
         extra_path[len + 1] = 'X';
         extra_path[len + 2] = 'T';
-        has_txt = g_file_test(extra_path, G_FILE_TEST_EXISTS);
+        has_txt = g_hash_table_contains(dir_files, extra_path);
       }
 
       extra_path[len] = 'w';
       extra_path[len + 1] = 'a';
       extra_path[len + 2] = 'v';
-      gboolean has_wav = g_file_test(extra_path, G_FILE_TEST_EXISTS);
+      gboolean has_wav = g_hash_table_contains(dir_files, extra_path);
 
       if(!has_wav)
       {
         extra_path[len] = 'W';
         extra_path[len + 1] = 'A';
         extra_path[len + 2] = 'V';
-        has_wav = g_file_test(extra_path, G_FILE_TEST_EXISTS);
+        has_wav = g_hash_table_contains(dir_files, extra_path);
       }
 
       // TODO: decide if we want to remove the flag for images that lost
@@ -291,14 +386,62 @@ GList *dt_control_crawler_run(void)
     }
   }
 
+  // the crawl ran to completion, so every film roll is now up to date
+  // as of its start.  skipped films were unchanged at that point too,
+  // so advancing their timestamp as well is safe.
+  sqlite3_stmt *crawl_stmt;
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                              "UPDATE main.film_rolls SET last_crawl = ?1",
+                              -1, &crawl_stmt, NULL);
+  DT_DEBUG_SQLITE3_BIND_INT64(crawl_stmt, 1, crawl_start);
+  sqlite3_step(crawl_stmt);
+  sqlite3_finalize(crawl_stmt);
+
   dt_database_release_transaction(darktable.db);
 
   sqlite3_finalize(stmt);
   sqlite3_finalize(inner_stmt);
+  if(dir_files) g_hash_table_destroy(dir_files);
+  g_hash_table_destroy(skip_films);
 
   return g_list_reverse(result); // list was built in reverse order, so un-reverse it
 }
 
+// show the list of updated sidecars on the main thread once the
+// background crawl has finished
+static gboolean _crawler_show_results(gpointer user_data)
+{
+  dt_control_crawler_show_image_list((GList *)user_data);
+  return G_SOURCE_REMOVE;
+}
+
+static int32_t _crawler_job_run(dt_job_t *job)
+{
+  GList *changed_xmp_files = dt_control_crawler_run(job);
+  if(changed_xmp_files)
+    g_main_context_invoke(NULL, _crawler_show_results, changed_xmp_files);
+  return 0;
+}
+
+static gboolean _crawler_start_callback(gpointer user_data)
+{
+  dt_job_t *job = dt_control_job_create(&_crawler_job_run, "%s",
+                                        N_("checking for updated sidecar files"));
+  if(job)
+  {
+    dt_control_job_add_progress(job, _("checking for updated sidecar files"), FALSE);
+    dt_control_add_job(DT_JOB_QUEUE_SYSTEM_BG, job);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+void dt_control_start_crawler(void)
+{
+  // give the main window a chance to be painted and the initial
+  // collection to load before we start hitting the disk
+  g_timeout_add_seconds(3, _crawler_start_callback, NULL);
+}
+
 
 /********************* the gui stuff *********************/
 
@@ -20,18 +20,23 @@
 
 #include <glib.h>
 
-/** this isn't a background job on purpose. it has to be really fast so it shouldn't
- *  require locking from image cache or anything like that.
- *  should we find out that we want to have a background job that crawls over all images
- *  we can maybe refactor this, but for now it's good the way it is.
- */
+#include "control/jobs.h"
 
 // this function iterates over ALL images from the database and checks whether
 // - the XMP file on disk is newer than the timestamp from db
 // - there is a .txt or .wav file associated with the image and mark so in the db
 //   or if such a file no longer exists
-// it returns the list of images with a (supposedly) updated xmp file to let the user decide
-GList *dt_control_crawler_run();
+// film rolls whose folder timestamp hasn't moved since their last completed
+// crawl are skipped without touching the disk.
+// it returns the list of images with a (supposedly) updated xmp file to let the user decide.
+// pass the job when running in the background to get progress reporting and
+// rate limiting, or NULL when running synchronously during startup
+GList *dt_control_crawler_run(dt_job_t *job);
+
+// schedule the crawl as a rate-limited background job shortly after the main
+// window has been painted; any updated sidecars found are reported via the
+// usual popup
+void dt_control_start_crawler(void);
 
 // show a popup with the images, let the user decide what to do and free the list afterwards
 void dt_control_crawler_show_image_list(GList *images);
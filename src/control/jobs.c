@@ -16,11 +16,15 @@
     along with darktable.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "common/trace.h"
 #include "control/jobs.h"
 #include "control/control.h"
 
 #define DT_CONTROL_FG_PRIORITY 4
 #define DT_CONTROL_MAX_JOBS 30
+// upper bound on export jobs running at once when workers would otherwise
+// be idle. each export is internally parallel, so keep this small.
+#define DT_CONTROL_MAX_CONCURRENT_EXPORTS 2
 
 /* the queue can have scheduled jobs but all
     the workers are sleeping, so this kicks the workers
@@ -54,8 +58,21 @@ typedef struct _dt_job_t
   char description[DT_CONTROL_DESCRIPTION_LEN];
   dt_view_type_flags_t view_creator;
   gboolean is_synchronous;
+  double time_queued; // wtime when added to a queue, for trace latencies
+
+  /* task-graph support. the edge lists are guarded by the file-global
+     graph mutex, unresolved is additionally read atomically by the
+     scheduler without taking it. */
+  GList *depends_on;    // jobs we wait for
+  GList *dependents;    // jobs waiting for us
+  int unresolved;       // number of dependencies not yet completed
+  void *result_data;    // optional result handed to our dependents
+  GList *input_results; // results collected from completed dependencies
 } _dt_job_t;
 
+/* guards the dependency edges and result hand-over between jobs */
+static GMutex _graph_mutex;
+
 /** check if two jobs are to be considered equal. a simple memcmp won't work since the mutexes probably won't
    match
     we don't want to compare result, priority or state since these will change during the course of
@@ -129,6 +146,78 @@ void *dt_control_job_get_params(const _dt_job_t *job)
   return job->params;
 }
 
+void dt_control_job_add_dependency(_dt_job_t *job, _dt_job_t *dependency)
+{
+  if(!job || !dependency)
+    return;
+  // edges have to be declared before either job is queued
+  if(dt_control_job_get_state(job) != DT_JOB_STATE_INITIALIZED
+     || dt_control_job_get_state(dependency) >= DT_JOB_STATE_FINISHED)
+    return;
+
+  g_mutex_lock(&_graph_mutex);
+  job->depends_on = g_list_prepend(job->depends_on, dependency);
+  dependency->dependents = g_list_prepend(dependency->dependents, job);
+  g_atomic_int_inc(&job->unresolved);
+  g_mutex_unlock(&_graph_mutex);
+}
+
+void dt_control_job_set_result(_dt_job_t *job, void *result)
+{
+  if(!job) return;
+  job->result_data = result;
+}
+
+GList *dt_control_job_get_input_results(const _dt_job_t *job)
+{
+  if(!job) return NULL;
+  return job->input_results;
+}
+
+/* called on disposal: hand our result to the jobs waiting for us,
+   release them for scheduling and drop all edges touching this job */
+static void _control_job_resolve_graph(_dt_job_t *job)
+{
+  if(!job->dependents && !job->depends_on && !job->input_results)
+    return;
+
+  g_mutex_lock(&_graph_mutex);
+  const gboolean released = job->dependents != NULL;
+  for(GList *l = job->dependents; l; l = g_list_next(l))
+  {
+    _dt_job_t *dependent = l->data;
+    dependent->depends_on = g_list_remove(dependent->depends_on, job);
+    if(job->result_data)
+      dependent->input_results = g_list_append(dependent->input_results, job->result_data);
+    g_atomic_int_add(&dependent->unresolved, -1);
+  }
+  g_list_free(job->dependents);
+  job->dependents = NULL;
+
+  // unlink from dependencies we never waited out (e.g. we got discarded)
+  for(GList *l = job->depends_on; l; l = g_list_next(l))
+  {
+    _dt_job_t *dependency = l->data;
+    dependency->dependents = g_list_remove(dependency->dependents, job);
+  }
+  g_list_free(job->depends_on);
+  job->depends_on = NULL;
+
+  // the result pointers themselves are owned by the job flow
+  g_list_free(job->input_results);
+  job->input_results = NULL;
+  g_mutex_unlock(&_graph_mutex);
+
+  // wake the workers so freshly released dependents get scheduled
+  if(released && dt_control_running())
+  {
+    dt_control_t *control = darktable.control;
+    dt_pthread_mutex_lock(&control->cond_mutex);
+    pthread_cond_broadcast(&control->cond);
+    dt_pthread_mutex_unlock(&control->cond_mutex);
+  }
+}
+
 dt_job_t *dt_control_job_create(dt_job_execute_callback execute,
                                 const char *msg, ...)
 {
@@ -167,6 +256,7 @@ void dt_control_job_dispose(_dt_job_t *job)
     dt_control_progress_destroy(job->progress);
   job->progress = NULL;
   _control_job_set_state(job, DT_JOB_STATE_DISPOSED);
+  _control_job_resolve_graph(job);
   if(job->params_destroy)
     job->params_destroy(job->params);
   dt_pthread_mutex_destroy(&job->state_mutex);
@@ -213,6 +303,33 @@ void dt_control_job_cancel(_dt_job_t *job)
   _control_job_set_state(job, DT_JOB_STATE_CANCELLED);
 }
 
+gboolean dt_control_job_yield(_dt_job_t *job)
+{
+  if(!job) return TRUE;
+  if(dt_control_job_get_state(job) == DT_JOB_STATE_CANCELLED) return TRUE;
+  if(job->is_synchronous) return FALSE;
+
+  if(job->queue != DT_JOB_QUEUE_USER_BG
+     && job->queue != DT_JOB_QUEUE_USER_EXPORT
+     && job->queue != DT_JOB_QUEUE_SYSTEM_BG)
+    return FALSE;
+
+  /* while interactive jobs are waiting to be scheduled, back off so they
+     get the cores. the pause is bounded so bulk work keeps making
+     progress even under sustained gui activity. */
+  dt_control_t *control = darktable.control;
+  for(int i = 0; i < 20; i++)
+  {
+    dt_pthread_mutex_lock(&control->queue_mutex);
+    const gboolean fg_waiting = control->queues[DT_JOB_QUEUE_USER_FG] != NULL
+                                || control->queues[DT_JOB_QUEUE_SYSTEM_FG] != NULL;
+    dt_pthread_mutex_unlock(&control->queue_mutex);
+    if(!fg_waiting) break;
+    g_usleep(10000);
+  }
+  return dt_control_job_get_state(job) == DT_JOB_STATE_CANCELLED;
+}
+
 static gboolean _control_run_job_res(dt_control_t *control, int32_t res)
 {
   if(((unsigned int)res) >= DT_CTL_WORKER_RESERVED)
@@ -263,19 +380,36 @@ static _dt_job_t *_control_schedule_job(dt_control_t *control)
 
   dt_pthread_mutex_lock(&control->queue_mutex);
 
+  /* export jobs are scheduled one at a time since each export is internally
+     parallel. but when the other queues are drained the remaining workers
+     would just sleep, so let them steal additional export jobs instead,
+     up to a small cap. */
+  gboolean only_exports_queued = TRUE;
+  for(int i = 0; i < DT_JOB_QUEUE_MAX; i++)
+    if(i != DT_JOB_QUEUE_USER_EXPORT && control->queues[i] != NULL)
+      only_exports_queued = FALSE;
+  const int export_cap = only_exports_queued ? DT_CONTROL_MAX_CONCURRENT_EXPORTS : 1;
+
   // find the job
   _dt_job_t *job = NULL;
+  GList *winner_link = NULL;
   int winner_queue = DT_JOB_QUEUE_MAX;
   int max_priority = -1;
   for(int i = 0; i < DT_JOB_QUEUE_MAX; i++)
   {
     if(control->queues[i] == NULL) continue;
-    if(control->export_scheduled && i == DT_JOB_QUEUE_USER_EXPORT) continue;
-    _dt_job_t *_job = (_dt_job_t *)control->queues[i]->data;
+    if(control->export_jobs_running >= export_cap && i == DT_JOB_QUEUE_USER_EXPORT) continue;
+    // skip over jobs still waiting for their dependencies to complete
+    GList *link = control->queues[i];
+    while(link && g_atomic_int_get(&((_dt_job_t *)link->data)->unresolved) > 0)
+      link = g_list_next(link);
+    if(!link) continue;
+    _dt_job_t *_job = (_dt_job_t *)link->data;
     if(_job->priority > max_priority)
     {
       max_priority = _job->priority;
       job = _job;
+      winner_link = link;
       winner_queue = i;
     }
   }
@@ -292,9 +426,9 @@ static _dt_job_t *_control_schedule_job(dt_control_t *control)
 
   // remove the to be scheduled job from its queue
   GList **queue = &control->queues[winner_queue];
-  *queue = g_list_delete_link(*queue, *queue);
+  *queue = g_list_delete_link(*queue, winner_link);
   control->queue_length[winner_queue]--;
-  if(winner_queue == DT_JOB_QUEUE_USER_EXPORT) control->export_scheduled = TRUE;
+  if(winner_queue == DT_JOB_QUEUE_USER_EXPORT) control->export_jobs_running++;
 
   // and place it in scheduled job array (for job deduping)
   control->job[_control_get_threadid()] = job;
@@ -317,9 +451,16 @@ static void _control_job_execute(_dt_job_t *job)
 
   _control_job_set_state(job, DT_JOB_STATE_RUNNING);
 
+  const double trace_start = dt_trace_begin();
+  // report the queue latency as an event ending where the execution begins
+  if(trace_start != 0.0 && job->time_queued > 0.0)
+    dt_trace_end("job-wait", job->time_queued, "queued `%s'", job->description);
+
   /* execute job */
   job->result = job->execute(job);
 
+  dt_trace_end("job", trace_start, "%s", job->description);
+
   _control_job_set_state(job, DT_JOB_STATE_FINISHED);
   _control_job_print(job, "run_job-", "", DT_CTL_WORKER_RESERVED + _control_get_threadid());
 }
@@ -340,7 +481,7 @@ static gboolean _control_run_job(dt_control_t *control)
   // remove the job from scheduled job array (for job deduping)
   dt_pthread_mutex_lock(&control->queue_mutex);
   control->job[_control_get_threadid()] = NULL;
-  if(job->queue == DT_JOB_QUEUE_USER_EXPORT) control->export_scheduled = FALSE;
+  if(job->queue == DT_JOB_QUEUE_USER_EXPORT) control->export_jobs_running--;
   dt_pthread_mutex_unlock(&control->queue_mutex);
 
   // and free it
@@ -371,6 +512,7 @@ gboolean dt_control_add_job_res(_dt_job_t *job, const int32_t res)
 
   _control_job_print(job, "add_job_res", "", res);
 
+  job->time_queued = dt_get_wtime();
   _control_job_set_state(job, DT_JOB_STATE_QUEUED);
   control->job_res[res] = job;
   control->new_res[res] = 1;
@@ -406,6 +548,7 @@ gboolean dt_control_add_job(dt_job_queue_t queue_id, _dt_job_t *job)
   }
 
   job->queue = queue_id;
+  job->time_queued = dt_get_wtime();
 
   _dt_job_t *job_for_disposal = NULL;
 
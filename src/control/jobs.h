@@ -64,6 +64,11 @@ dt_job_t *dt_control_job_create(dt_job_execute_callback execute, const char *msg
 void dt_control_job_dispose(dt_job_t *job);
 /** cancel a job, running or in queue. */
 void dt_control_job_cancel(dt_job_t *job);
+/** cooperative preemption checkpoint for long-running background jobs.
+  * returns TRUE when the job has been cancelled and the caller should
+  * abort; otherwise briefly backs off while foreground jobs are waiting
+  * so interactive requests overtake bulk work within a bounded latency. */
+gboolean dt_control_job_yield(dt_job_t *job);
 dt_job_state_t dt_control_job_get_state(dt_job_t *job);
 /** set job params and a callback to destroy those params */
 void dt_control_job_set_params(dt_job_t *job, void *params, dt_job_destroy_callback callback);
@@ -74,6 +79,18 @@ void dt_control_job_set_params_with_size(dt_job_t *job, void *params, size_t par
 /** get job params. WARNING: you must not free them. dt_control_job_dispose() will take care of that */
 void *dt_control_job_get_params(const dt_job_t *job);
 
+/** declare that job must not be scheduled before dependency has completed.
+  * edges have to be added before either job is queued; cycles are not
+  * detected. a cancelled or discarded dependency still releases the job. */
+void dt_control_job_add_dependency(dt_job_t *job, dt_job_t *dependency);
+/** set the result handed to dependent jobs when this one completes. the
+  * pointer is passed as-is, ownership stays with the job flow. */
+void dt_control_job_set_result(dt_job_t *job, void *result);
+/** get the results collected from completed dependencies, in completion
+  * order. only valid from within the job's execute callback; the list is
+  * freed on disposal, the result pointers are not. */
+GList *dt_control_job_get_input_results(const dt_job_t *job);
+
 void dt_control_job_add_progress(dt_job_t *job, const char *message, const gboolean cancellable);
 void dt_control_job_set_progress_message(dt_job_t *job, const char *message, ...);
 void dt_control_job_set_progress(dt_job_t *job, const double value);
@@ -34,9 +34,12 @@
 #include "common/grouping.h"
 #include "common/import_session.h"
 #include "common/utility.h"
+#include "common/database.h"
 #include "common/datetime.h"
 #include "common/overlay.h"
+#include "common/opencl.h"
 #include "control/conf.h"
+#include "control/jobs/image_jobs.h"
 #include "develop/imageop_math.h"
 #include "imageio/imageio_common.h"
 #include "imageio/imageio_dng.h"
@@ -351,7 +354,7 @@ static int32_t _control_write_sidecar_files_job_run(dt_job_t *job)
      &stmt, NULL);
   size_t count = 0;
   double prev_time = 0;
-  for(GList *t = params->index ; t && !_job_cancelled(job) ; t = g_list_next(t))
+  for(GList *t = params->index ; t && !dt_control_job_yield(job) ; t = g_list_next(t))
   {
     const dt_imgid_t imgid = GPOINTER_TO_INT(t->data);
     const dt_image_t *img = dt_image_cache_get(imgid, 'r');
@@ -706,6 +709,7 @@ static int32_t _control_merge_hdr_job_run(dt_job_t *job)
   dt_control_queue_redraw_center();
 
 end:
+  dt_imageio_export_cleanup();
   free(d.pixels);
   free(d.weight);
 
@@ -1607,7 +1611,7 @@ static int32_t _control_paste_history_job_run(dt_job_t *job)
   dt_undo_start_group(darktable.undo, DT_UNDO_LT_HISTORY);
   double prev_time = 0;
   GList *to_synch = NULL;
-  for( ; t && !_job_cancelled(job); t = g_list_next(t))
+  for( ; t && !dt_control_job_yield(job); t = g_list_next(t))
   {
     const dt_imgid_t imgid = GPOINTER_TO_INT(t->data);
     if(!dt_is_valid_imgid(imgid)) continue;
@@ -1757,8 +1761,19 @@ static int32_t _control_apply_styles_job_run(dt_job_t *job)
 
   const gboolean is_overwrite = style_data->overwrite;
 
+  // prepare each style once for the whole batch; this also batches the
+  // sidecar writes and the mipmap-updated signal
+  GList *prepared = NULL;
+  for(GList *style = styles; style; style = g_list_next(style))
+  {
+    dt_styles_apply_t *apply =
+      dt_styles_apply_begin((const char *)style->data, duplicate, is_overwrite);
+    if(apply) prepared = g_list_prepend(prepared, apply);
+  }
+  prepared = g_list_reverse(prepared);
+
   double prev_time = 0;
-  for(GList *t = imgs ; t && !_job_cancelled(job); t = g_list_next(t))
+  for(GList *t = imgs ; t && !dt_control_job_yield(job); t = g_list_next(t))
   {
     const dt_imgid_t imgid = GPOINTER_TO_INT(t->data);
     if(!dt_is_valid_imgid(imgid)) continue;
@@ -1775,9 +1790,9 @@ static int32_t _control_apply_styles_job_run(dt_job_t *job)
     if(is_overwrite && !duplicate)
       dt_history_delete_on_image_ext(imgid, FALSE, TRUE);
 
-    for(GList *style = styles; style; style = g_list_next(style))
+    for(GList *p = prepared; p; p = g_list_next(p))
     {
-      dt_styles_apply_to_image((const char*)style->data, duplicate, is_overwrite, imgid);
+      dt_styles_apply_next((dt_styles_apply_t *)p->data, imgid);
     }
 
     if(is_overwrite && g_list_is_singleton(styles))
@@ -1790,6 +1805,9 @@ static int32_t _control_apply_styles_job_run(dt_job_t *job)
     fraction += 1.0 / total;
     _update_progress(job, fraction, &prev_time);
   }
+  // release in reverse order of begin, the transactions nest as savepoints
+  prepared = g_list_reverse(prepared);
+  g_list_free_full(prepared, (GDestroyNotify)dt_styles_apply_end);
   dt_undo_end_group(darktable.undo);
   DT_CONTROL_SIGNAL_RAISE(DT_SIGNAL_TAG_CHANGED);
 
@@ -1802,6 +1820,138 @@ static int32_t _control_apply_styles_job_run(dt_job_t *job)
   return 0;
 }
 
+typedef struct _export_worker_t
+{
+  dt_job_t *job;
+  dt_imageio_module_format_t *mformat;
+  dt_imageio_module_storage_t *mstorage;
+  dt_imageio_module_data_t *sdata;
+  dt_imageio_module_data_t *fdata; // master copy, used by the first worker
+  dt_control_export_t *settings;
+  dt_export_metadata_t *metadata;
+  GList *remaining;  // next unclaimed image
+  guint total;
+  guint num;         // images handed out so far
+  double fraction;
+  double prev_time;
+  guint tagid, etagid;
+  gboolean is_scaling;
+  double scale_factor;
+  gboolean tag_change;
+  dt_pthread_mutex_t lock;
+} _export_worker_t;
+
+static void _export_worker_run(_export_worker_t *w,
+                               dt_imageio_module_data_t *fdata)
+{
+  dt_imageio_module_format_t *mformat = w->mformat;
+  dt_imageio_module_storage_t *mstorage = w->mstorage;
+
+  while(TRUE)
+  {
+    // cooperative preemption point, taken before the worker lock so a
+    // waiting interactive job never stalls the other export workers
+    if(dt_control_job_yield(w->job)) break;
+
+    dt_pthread_mutex_lock(&w->lock);
+    if(!w->remaining || _job_cancelled(w->job))
+    {
+      dt_pthread_mutex_unlock(&w->lock);
+      break;
+    }
+    const dt_imgid_t imgid = GPOINTER_TO_INT(w->remaining->data);
+    w->remaining = g_list_next(w->remaining);
+    const guint num = ++w->num;
+
+    // overlap the stages: while this image runs through the pixelpipe
+    // (and possibly the GPU) a background job already decodes the next
+    // one into the full mipmap tier, so the following store() starts
+    // processing right away instead of waiting for the raw decoder.
+    // the mipmap cache bounds how much decoded data sits in flight.
+    if(w->remaining)
+    {
+      const dt_imgid_t next = GPOINTER_TO_INT(w->remaining->data);
+      dt_image_prefetch(&next, 1);
+    }
+
+    // progress message
+    // update the message. initialize_store() might have changed the number of images
+    dt_control_job_set_progress_message(w->job, _("exporting %d / %d to %s"),
+                                        num, w->total, mstorage->name(mstorage));
+    dt_pthread_mutex_unlock(&w->lock);
+
+    // check if image still exists:
+    const dt_image_t *image = dt_image_cache_get(imgid, 'r');
+    if(image)
+    {
+      char imgfilename[PATH_MAX] = { 0 };
+      gboolean from_cache = TRUE;
+      dt_image_full_path(image->id, imgfilename, sizeof(imgfilename), &from_cache);
+      if(!g_file_test(imgfilename, G_FILE_TEST_IS_REGULAR))
+      {
+        dt_control_log(_("image `%s' is currently unavailable"), image->filename);
+        dt_print(DT_DEBUG_ALWAYS, "image `%s' is currently unavailable", imgfilename);
+        // dt_image_remove(imgid);
+        dt_image_cache_read_release(image);
+      }
+      else
+      {
+        dt_image_cache_read_release(image);
+        if(mstorage->store(mstorage, w->sdata, imgid, mformat, fdata,
+                           num, w->total,
+                           w->settings->high_quality, w->settings->upscale,
+                           w->is_scaling, w->scale_factor,
+                           w->settings->export_masks, w->settings->icc_type,
+                           w->settings->icc_filename, w->settings->icc_intent,
+                           w->metadata) != 0)
+          dt_control_job_cancel(w->job);
+        else
+        {
+          gboolean tag_change = FALSE;
+          // remove 'changed' tag from image
+          if(dt_tag_detach(w->tagid, imgid, FALSE, FALSE)) tag_change = TRUE;
+
+          // make sure the 'exported' tag is set on the image
+          if(dt_tag_attach(w->etagid, imgid, FALSE, FALSE)) tag_change = TRUE;
+
+          /* register export timestamp in cache */
+          dt_image_cache_set_export_timestamp(imgid);
+
+          if(tag_change)
+          {
+            dt_pthread_mutex_lock(&w->lock);
+            w->tag_change = TRUE;
+            dt_pthread_mutex_unlock(&w->lock);
+          }
+        }
+      }
+    }
+
+    dt_pthread_mutex_lock(&w->lock);
+    w->fraction += 1.0 / w->total;
+    _update_progress(w->job, w->fraction, &w->prev_time);
+    dt_pthread_mutex_unlock(&w->lock);
+  }
+
+  // release a possibly cached export pipe kept for stack reuse
+  dt_imageio_export_cleanup();
+}
+
+static void *_export_worker_thread(void *data)
+{
+  _export_worker_t *w = data;
+
+  // each worker needs its own format data (one jpeg struct per thread
+  // etc); copy the configured params from the master copy
+  dt_imageio_module_data_t *fdata = w->mformat->get_params(w->mformat);
+  memcpy(fdata, w->fdata, w->mformat->params_size(w->mformat));
+
+  _export_worker_run(w, fdata);
+
+  w->mformat->free_params(w->mformat, fdata);
+  return NULL;
+}
+
 static int32_t _control_export_job_run(dt_job_t *job)
 {
   dt_stop_backthumbs_crawler(FALSE);
@@ -1901,61 +2051,59 @@ static int32_t _control_export_job_run(dt_job_t *job)
     metadata.list = g_list_remove(metadata.list, metadata.list->data);
   }
 
-  GList *t = params->index;
-  double prev_time = 0;
+  _export_worker_t worker = {
+    .job = job,
+    .mformat = mformat,
+    .mstorage = mstorage,
+    .sdata = sdata,
+    .fdata = fdata,
+    .settings = settings,
+    .metadata = &metadata,
+    .remaining = params->index,
+    .total = total,
+    .num = 0,
+    .fraction = fraction,
+    .prev_time = 0,
+    .tagid = tagid,
+    .etagid = etagid,
+    .is_scaling = is_scaling,
+    .scale_factor = scale_factor,
+    .tag_change = FALSE,
+  };
+  dt_pthread_mutex_init(&worker.lock, NULL);
+
+  // with several OpenCL devices a serial loop leaves all but one of
+  // them idle, so spread the images over a small worker pool: each
+  // concurrent pipe locks its own device via dt_opencl_lock_device()
+  // using the benchmarked export priority order, and workers pull from
+  // the shared list so faster devices automatically process more
+  // images.  storage modules are written to be called in parallel
+  // (they synchronize on darktable.plugin_threadsafe).  one extra
+  // worker keeps the CPU path busy too, unless a mandatory export
+  // device is configured.
+  int num_workers = 1;
+#ifdef HAVE_OPENCL
+  if(darktable.opencl->inited && darktable.opencl->num_devs > 1)
+  {
+    num_workers = darktable.opencl->num_devs
+                  + (darktable.opencl->mandatory[2] ? 0 : 1);
+    num_workers = MIN(MIN(num_workers, (int)total), 4);
+  }
+#endif
 
-  while(t && !_job_cancelled(job))
-  {
-    const dt_imgid_t imgid = GPOINTER_TO_INT(t->data);
-    t = g_list_next(t);
-    const guint num = total - g_list_length(t);
+  pthread_t threads[3];
+  const int num_threads = num_workers - 1;
+  for(int i = 0; i < num_threads; i++)
+    dt_pthread_create(&threads[i], _export_worker_thread, &worker);
 
-    // progress message
-    // update the message. initialize_store() might have changed the number of images
-    dt_control_job_set_progress_message(job, _("exporting %d / %d to %s"),
-                                             num, total, mstorage->name(mstorage));
+  // this thread works on the master fdata
+  _export_worker_run(&worker, fdata);
 
-    // check if image still exists:
-    const dt_image_t *image = dt_image_cache_get(imgid, 'r');
-    if(image)
-    {
-      char imgfilename[PATH_MAX] = { 0 };
-      gboolean from_cache = TRUE;
-      dt_image_full_path(image->id, imgfilename, sizeof(imgfilename), &from_cache);
-      if(!g_file_test(imgfilename, G_FILE_TEST_IS_REGULAR))
-      {
-        dt_control_log(_("image `%s' is currently unavailable"), image->filename);
-        dt_print(DT_DEBUG_ALWAYS, "image `%s' is currently unavailable", imgfilename);
-        // dt_image_remove(imgid);
-        dt_image_cache_read_release(image);
-      }
-      else
-      {
-        dt_image_cache_read_release(image);
-        if(mstorage->store(mstorage, sdata, imgid, mformat, fdata,
-                           num, total, settings->high_quality, settings->upscale,
-                           is_scaling, scale_factor,
-                           settings->export_masks, settings->icc_type,
-                           settings->icc_filename, settings->icc_intent,
-                           &metadata) != 0)
-          dt_control_job_cancel(job);
-        else
-        {
-          // remove 'changed' tag from image
-          if(dt_tag_detach(tagid, imgid, FALSE, FALSE)) tag_change = TRUE;
-
-          // make sure the 'exported' tag is set on the image
-          if(dt_tag_attach(etagid, imgid, FALSE, FALSE)) tag_change = TRUE;
-
-          /* register export timestamp in cache */
-          dt_image_cache_set_export_timestamp(imgid);
-        }
-      }
-    }
+  for(int i = 0; i < num_threads; i++)
+    pthread_join(threads[i], NULL);
 
-    fraction += 1.0 / total;
-    _update_progress(job, fraction, &prev_time);
-  }
+  tag_change = worker.tag_change;
+  dt_pthread_mutex_destroy(&worker.lock);
   g_list_free_full(metadata.list, g_free);
 
   if(mstorage->finalize_store) mstorage->finalize_store(mstorage, sdata);
@@ -2757,6 +2905,29 @@ void dt_control_datetime(const GTimeSpan offset,
                      _control_datetime_job_create(offset, datetime, imgs));
 }
 
+static int32_t _control_db_maintenance_job_run(dt_job_t *job)
+{
+  dt_database_perform_light_maintenance(darktable.db);
+  return 0;
+}
+
+static gboolean _db_maintenance_timeout(gpointer user_data)
+{
+  if(dt_conf_get_bool("database/background_maintenance"))
+    dt_control_add_job(DT_JOB_QUEUE_SYSTEM_BG,
+                       dt_control_job_create(&_control_db_maintenance_job_run,
+                                             "background database maintenance"));
+  return G_SOURCE_CONTINUE;
+}
+
+void dt_control_start_database_maintenance()
+{
+  // long-lived sessions accumulate free pages and stale index
+  // statistics; run a lightweight maintenance pass every two hours so
+  // nobody has to remember to vacuum manually
+  g_timeout_add_seconds(2 * 60 * 60, _db_maintenance_timeout, NULL);
+}
+
 void dt_control_write_sidecar_files()
 {
   dt_control_add_job(DT_JOB_QUEUE_USER_FG,
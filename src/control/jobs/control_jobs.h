@@ -33,6 +33,8 @@ void dt_control_gpx_apply(const gchar *filename, const int32_t filmid, const gch
 void dt_control_datetime(const GTimeSpan offset, const char *datetime, GList *imgs);
 
 void dt_control_write_sidecar_files(void);
+/** schedule the periodic lightweight database maintenance job */
+void dt_control_start_database_maintenance(void);
 void dt_control_delete_images(void);
 void dt_control_delete_duplicate(const dt_imgid_t imgid);
 void dt_control_duplicate_images(const gboolean virgin);
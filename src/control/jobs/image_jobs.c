@@ -62,6 +62,58 @@ dt_job_t *dt_image_load_job_create(dt_imgid_t id, dt_mipmap_size_t mip)
   return job;
 }
 
+typedef struct dt_image_prefetch_t
+{
+  uint32_t generation;
+  int count;
+  dt_imgid_t imgid[DT_IMAGE_PREFETCH_MAX];
+} dt_image_prefetch_t;
+
+// bumped with every prefetch request so jobs from before a jump can
+// tell they became stale and stop decoding
+static int _prefetch_generation = 0;
+
+static int32_t _image_prefetch_job_run(dt_job_t *job)
+{
+  dt_image_prefetch_t *params = dt_control_job_get_params(job);
+
+  for(int k = 0; k < params->count; k++)
+  {
+    // the user moved elsewhere, don't waste decodes on images from the
+    // old position
+    if((uint32_t)g_atomic_int_get(&_prefetch_generation) != params->generation)
+      return 0;
+
+    dt_mipmap_buffer_t buf;
+    dt_mipmap_cache_get(&buf, params->imgid[k], DT_MIPMAP_FULL,
+                        DT_MIPMAP_BLOCKING, 'r');
+    dt_mipmap_cache_release(&buf);
+  }
+  return 0;
+}
+
+void dt_image_prefetch(const dt_imgid_t *imgids, const int count)
+{
+  const uint32_t generation = g_atomic_int_add(&_prefetch_generation, 1) + 1;
+  if(count < 1) return;
+
+  dt_job_t *job = dt_control_job_create(&_image_prefetch_job_run,
+                                        "prefetch %d image(s)", count);
+  if(!job) return;
+  dt_image_prefetch_t *params = calloc(1, sizeof(dt_image_prefetch_t));
+  if(!params)
+  {
+    dt_control_job_dispose(job);
+    return;
+  }
+  params->generation = generation;
+  params->count = MIN(count, DT_IMAGE_PREFETCH_MAX);
+  for(int k = 0; k < params->count; k++)
+    params->imgid[k] = imgids[k];
+  dt_control_job_set_params(job, params, free);
+  dt_control_add_job(DT_JOB_QUEUE_SYSTEM_FG, job);
+}
+
 typedef struct dt_image_import_t
 {
   dt_filmid_t film_id;
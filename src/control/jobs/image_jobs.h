@@ -25,6 +25,13 @@
 
 dt_job_t *dt_image_load_job_create(dt_imgid_t imgid, dt_mipmap_size_t mip);
 
+#define DT_IMAGE_PREFETCH_MAX 8
+
+/** speculatively decode up to DT_IMAGE_PREFETCH_MAX images into the
+    DT_MIPMAP_FULL tier on a background thread. every call supersedes
+    the previous one, a still running job stops before its next decode. */
+void dt_image_prefetch(const dt_imgid_t *imgids, const int count);
+
 dt_job_t *dt_image_import_job_create(dt_filmid_t filmid, const char *filename);
 
 // clang-format off
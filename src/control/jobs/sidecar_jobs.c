@@ -17,6 +17,7 @@
 */
 
 #include "control/jobs/sidecar_jobs.h"
+#include "control/conf.h"
 
 static GSList *pending_images = NULL;
 static gboolean background_running = FALSE;
@@ -48,7 +49,8 @@ static void _unlock_pending_queue()
 static int32_t _control_write_sidecars_job_run(dt_job_t *job)
 {
   GSList *imgs = NULL;
-  GHashTable *enqueued = g_hash_table_new(g_direct_hash, g_direct_equal);
+  // imgid -> wall time of the most recent enqueue of that image
+  GHashTable *enqueued = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
 
   double prev_fetch = 0;
   // keep going until explicitly cancelled or darktable shuts down AND all writes have finished
@@ -72,35 +74,64 @@ static int32_t _control_write_sidecars_job_run(dt_job_t *job)
 #endif
       if(new_imgs)
       {
-        // add the new images to the queue being processed if they are not already on the queue
+        // add the new images to the queue being processed. images
+        // already on the queue just get their timestamp refreshed, so
+        // rapid successive edits of the same image coalesce into one
+        // write once the edits stop
         GSList *to_add = NULL;
         for(GSList *imglist = new_imgs; imglist; imglist = g_slist_next(imglist))
         {
-          if(!g_hash_table_contains(enqueued,GINT_TO_POINTER(imglist->data)))
+          double *ts = g_hash_table_lookup(enqueued, imglist->data);
+          if(ts)
+            *ts = curr_fetch;
+          else
           {
+            ts = g_new(double, 1);
+            *ts = curr_fetch;
             to_add = g_slist_prepend(to_add, imglist->data);
-            g_hash_table_insert(enqueued, GINT_TO_POINTER(imglist->data), GINT_TO_POINTER(imglist->data));
+            g_hash_table_insert(enqueued, imglist->data, ts);
           }
         }
         imgs = g_slist_concat(imgs, to_add);
         g_slist_free(new_imgs);
       }
     }
-    // synchronize the first few images on the queue
-    for(int i = 0; imgs && i < 3; i++)
+    // synchronize a few of the queued images whose last edit is
+    // outside the durability window.  while shutting down or when
+    // cancelled everything is flushed immediately.
+    const gboolean draining = !dt_control_running()
+                              || dt_control_job_get_state(job) == DT_JOB_STATE_CANCELLED;
+    const double window =
+      draining ? 0.0 : MAX(0, dt_conf_get_int("write_sidecar_delay"));
+    const double now = dt_get_wtime();
+    int written = 0;
+    GSList *l = imgs;
+    while(l && written < 3)
     {
-      dt_imgid_t imgid = GPOINTER_TO_INT(imgs->data);
-      dt_image_write_sidecar_file(imgid);
-      // remove the head of the image queue
-      g_hash_table_remove(enqueued, GINT_TO_POINTER(imgid));
-      imgs = g_slist_delete_link(imgs, imgs);
+      GSList *next = g_slist_next(l);
+      const dt_imgid_t imgid = GPOINTER_TO_INT(l->data);
+      const double *ts = g_hash_table_lookup(enqueued, GINT_TO_POINTER(imgid));
+      if(!ts || now - *ts >= window)
+      {
+        dt_image_write_sidecar_file(imgid);
+        g_hash_table_remove(enqueued, GINT_TO_POINTER(imgid));
+        imgs = g_slist_delete_link(imgs, l);
+        written++;
+      }
+      l = next;
     }
-    if(imgs) // do we have more images already queued?
+    if(written && imgs) // do we have more images ready to be written?
     {
       // give others a chance to run by sleeping 10ms; avoids apparent
       // hangs when trying to switch views
       g_usleep(10000);
     }
+    else if(imgs)
+    {
+      // everything on the queue is still inside the durability
+      // window, check again soon
+      g_usleep(100000);
+    }
     else
     {
       // we currently have nothing to do, so wait 1 second before checking for more work
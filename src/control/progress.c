@@ -41,9 +41,16 @@
 #endif
 
 
+// fixed-point representation of the progress value so parallel workers
+// can publish updates with a single atomic store
+#define DT_PROGRESS_FIXED_SCALE (1 << 20)
+// minimal interval between two pushes of the value to the gui
+#define DT_PROGRESS_GUI_INTERVAL_MS 100
+
 typedef struct _dt_progress_t
 {
-  double progress;
+  gint progress; // fixed-point, DT_PROGRESS_FIXED_SCALE, accessed atomically
+  gint last_gui_push_ms; // monotonic ms of the last push to the gui
   gchar *message;
   gboolean has_progress_bar;
   dt_pthread_mutex_t mutex;
@@ -421,16 +428,32 @@ void dt_control_progress_set_progress(dt_progress_t *progress, double value)
   dt_control_t *control = darktable.control;
   if(!control || !progress) return;
 
-  dt_pthread_mutex_lock(&progress->mutex);
-  progress->progress = CLAMP(value, 0.0, 1.0);
-  dt_pthread_mutex_unlock(&progress->mutex);
+  // the hot path taken by parallel workers is a single atomic store;
+  // the gui and the global progress bar only get the value pushed at a
+  // bounded rate, so workers never serialize on the progress mutexes
+  const double clamped = CLAMP(value, 0.0, 1.0);
+  g_atomic_int_set(&progress->progress, (gint)(clamped * DT_PROGRESS_FIXED_SCALE));
+
+  // wrap-safe in two's complement, so plain gint ms are good enough
+  const gint now_ms = (gint)(g_get_monotonic_time() / 1000);
+  const gint last_ms = g_atomic_int_get(&progress->last_gui_push_ms);
+  if(clamped < 1.0)
+  {
+    if(now_ms - last_ms < DT_PROGRESS_GUI_INTERVAL_MS)
+      return;
+    // of several racing workers only one gets to push this round
+    if(!g_atomic_int_compare_and_exchange(&progress->last_gui_push_ms, last_ms, now_ms))
+      return;
+  }
+  else
+    g_atomic_int_set(&progress->last_gui_push_ms, now_ms);
 
   // tell the gui
   dt_pthread_mutex_lock(&control->progress_system.mutex);
   if(control->progress_system.proxy.module != NULL)
-    control->progress_system.proxy.updated(control->progress_system.proxy.module, progress->gui_data, value);
+    control->progress_system.proxy.updated(control->progress_system.proxy.module, progress->gui_data, clamped);
 
-  if(progress->has_progress_bar) _global_progress_set(control, progress, value);
+  if(progress->has_progress_bar) _global_progress_set(control, progress, clamped);
 
   dt_pthread_mutex_unlock(&control->progress_system.mutex);
 }
@@ -438,10 +461,7 @@ void dt_control_progress_set_progress(dt_progress_t *progress, double value)
 double dt_control_progress_get_progress(dt_progress_t *progress)
 {
   if(!progress) return -1.0;
-  dt_pthread_mutex_lock(&progress->mutex);
-  const double res = progress->progress;
-  dt_pthread_mutex_unlock(&progress->mutex);
-  return res;
+  return (double)g_atomic_int_get(&progress->progress) / DT_PROGRESS_FIXED_SCALE;
 }
 
 const gchar *dt_control_progress_get_message(dt_progress_t *progress)
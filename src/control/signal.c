@@ -45,6 +45,11 @@ typedef struct dt_signal_description
   GType *param_types;
   GCallback destructor;
   gboolean synchronous;
+  /* parameter-less signals raised in storms (redraws, mouse-over, ...)
+     may be coalesced: while one emission is still queued on the main
+     loop, further raises are dropped as they would deliver the exact
+     same notification again. latest-wins by construction. */
+  gboolean coalescing;
 } dt_signal_description;
 
 
@@ -97,14 +102,14 @@ static void _image_geotag_destroy_callback(gpointer instance, gpointer imgs, con
 static dt_signal_description _signal_description[DT_SIGNAL_COUNT] = {
   /* Global signals */
   [DT_SIGNAL_MOUSE_OVER_IMAGE_CHANGE] = { "dt-global-mouse-over-image-change",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
   [DT_SIGNAL_ACTIVE_IMAGES_CHANGE] = { "dt-global-active-images-change",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
 
   [DT_SIGNAL_CONTROL_REDRAW_ALL] = { "dt-control-redraw-all",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
   [DT_SIGNAL_CONTROL_REDRAW_CENTER] = { "dt-control-redraw-center",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
 
   [DT_SIGNAL_VIEWMANAGER_VIEW_CHANGED] = { "dt-viewmanager-view-changed",
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_generic, 2, pointer_2arg, NULL, FALSE },
@@ -116,9 +121,9 @@ static dt_signal_description _signal_description[DT_SIGNAL_COUNT] = {
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_generic, 4, collection_args,
     G_CALLBACK(_collection_changed_destroy_callback), FALSE },
   [DT_SIGNAL_SELECTION_CHANGED] = { "dt-selection-changed",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
   [DT_SIGNAL_TAG_CHANGED] = { "dt-tag-changed",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
   [DT_SIGNAL_GEOTAG_CHANGED] = { "dt-geotag-changed",
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_generic, 2, geotag_arg,
     G_CALLBACK(_image_geotag_destroy_callback), FALSE },
@@ -132,7 +137,7 @@ static dt_signal_description _signal_description[DT_SIGNAL_COUNT] = {
   [DT_SIGNAL_IMAGES_ORDER_CHANGE] = { "dt-images-order-change",
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_generic, 1, pointer_arg, NULL, FALSE },
   [DT_SIGNAL_FILMROLLS_CHANGED] = { "dt-filmrolls-changed",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
   [DT_SIGNAL_FILMROLLS_IMPORTED] = { "dt-filmrolls-imported",
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__UINT, 1, uint_arg, NULL, FALSE },
   [DT_SIGNAL_FILMROLLS_REMOVED] = { "dt-filmrolls-removed",
@@ -189,7 +194,7 @@ static dt_signal_description _signal_description[DT_SIGNAL_COUNT] = {
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
 
   [DT_SIGNAL_CONTROL_NAVIGATION_REDRAW] = { "dt-control-navigation-redraw",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
 
   [DT_SIGNAL_CONTROL_LOG_REDRAW] = { "dt-control-log-redraw",
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
@@ -201,7 +206,7 @@ static dt_signal_description _signal_description[DT_SIGNAL_COUNT] = {
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_generic, 2, pointer_2arg, NULL, FALSE },
 
   [DT_SIGNAL_METADATA_UPDATE] = { "dt-metadata-update",
-    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE },
+    NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_VOID__VOID, 0, NULL, NULL, FALSE, TRUE },
 
   [DT_SIGNAL_TROUBLE_MESSAGE] = { "dt-trouble-message",
     NULL, NULL, G_TYPE_NONE, g_cclosure_marshal_generic, 3, pointer_trouble, NULL, FALSE },
@@ -253,11 +258,20 @@ typedef struct _signal_param_t
   GValue *instance_and_params;
   guint signal_id;
   guint n_params;
+  dt_signal_t signal;
 } _signal_param_t;
 
+// per-signal flag telling whether an emission is already queued on the
+// main loop; raises of coalescing signals are dropped while it is set
+static gint _signal_pending[DT_SIGNAL_COUNT];
+
 static gboolean _signal_raise(gpointer user_data)
 {
   _signal_param_t *params = (_signal_param_t *)user_data;
+  // clear the flag before emitting so raises from within the handlers
+  // queue a fresh emission instead of getting swallowed
+  if(_signal_description[params->signal].coalescing)
+    g_atomic_int_set(&_signal_pending[params->signal], 0);
   g_signal_emitv(params->instance_and_params, params->signal_id, 0, NULL);
   for(int i = 0; i <= params->n_params; i++) g_value_unset(&params->instance_and_params[i]);
   free(params->instance_and_params);
@@ -313,13 +327,24 @@ void dt_control_signal_raise(const dt_control_signal_t *ctlsig, dt_signal_t sign
 
   dt_signal_description *signal_description = &_signal_description[signal];
 
+  // coalesce storms of identical notifications: as long as one emission
+  // is still queued, delivering another would only repeat the same work
+  if(signal_description->coalescing
+     && !g_atomic_int_compare_and_exchange(&_signal_pending[signal], 0, 1))
+    return;
+
   _signal_param_t *params = malloc(sizeof(_signal_param_t));
-  if(!params) return;
+  if(!params)
+  {
+    g_atomic_int_set(&_signal_pending[signal], 0);
+    return;
+  }
 
   GValue *instance_and_params = calloc(1 + signal_description->n_params, sizeof(GValue));
   if(!instance_and_params)
   {
     free(params);
+    g_atomic_int_set(&_signal_pending[signal], 0);
     return;
   }
   _print_trace(signal, DT_DEBUG_SIGNAL_ACT_RAISE, "raise");
@@ -363,6 +388,7 @@ void dt_control_signal_raise(const dt_control_signal_t *ctlsig, dt_signal_t sign
   params->instance_and_params = instance_and_params;
   params->signal_id = g_signal_lookup(_signal_description[signal].name, _signal_type);
   params->n_params = signal_description->n_params;
+  params->signal = signal;
 
   if(!signal_description->synchronous)
   {
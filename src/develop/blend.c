@@ -379,7 +379,8 @@ static float _get_feathering_eps(const dt_dev_pixelpipe_iop_t *piece)
   return (cst == IOP_CS_RGB && fmode) ? 0.5f : 1.0f;
 }
 
-static void _develop_blend_process_feather(const float *const guide,
+static void _develop_blend_process_feather(dt_dev_pixelpipe_iop_t *piece,
+                                           const float *const guide,
                                            float *const mask,
                                            const size_t width,
                                            const size_t height,
@@ -391,12 +392,12 @@ static void _develop_blend_process_feather(const float *const guide,
 {
   const int w = _get_required_w(feathering_radius, scale);
 
-  float *const restrict mask_bak = dt_alloc_align_float(width * height);
+  float *const restrict mask_bak = dt_dev_pixelpipe_scratch_float(piece->pipe, width * height);
   if(mask_bak)
   {
     dt_iop_image_copy_by_size(mask_bak, mask, width, height, 1);
     guided_filter(guide, mask_bak, mask, width, height, ch, w, sqrt_eps, guide_weight, 0.f, 1.f);
-    dt_free_align(mask_bak);
+    dt_dev_pixelpipe_scratch_free(piece->pipe, mask_bak);
   }
 }
 
@@ -527,6 +528,27 @@ void dt_develop_blend_process(dt_iop_module_t *self,
   // get the clipped opacity value  0 - 1
   const float opacity = CLIP(d->opacity / 100.0f);
 
+  /* fast path: a uniform normal blend at full opacity leaves the module
+     output unchanged, so we can skip the mask allocation and the blend
+     kernel including its colorspace roundtrip.  this is only safe as
+     long as nobody wants to see or reuse the (all-ones) mask and no
+     earlier module passes a display mask through the alpha channel. */
+  if(uniform
+     && opacity == 1.0f
+     && d->blend_mode == DEVELOP_BLEND_NORMAL2
+     && request_mask_display == DT_DEV_PIXELPIPE_DISPLAY_NONE
+     && request_raster_display == DT_DEV_PIXELPIPE_DISPLAY_NONE
+     && piece->pipe->mask_display == DT_DEV_PIXELPIPE_DISPLAY_NONE
+     && !dt_iop_piece_is_raster_mask_used(piece, BLEND_RASTER_ID))
+  {
+    dt_print_pipe(DT_DEBUG_PIPE,
+       "blend pass-through",
+       piece->pipe, self, DT_DEVICE_CPU, roi_in, roi_out, "%s",
+       dt_iop_colorspace_to_name(cst));
+    dt_iop_piece_clear_raster(piece, NULL);
+    return;
+  }
+
   // allocate space for blend mask used by roi_out
   float *const restrict _mask = dt_alloc_align_float(obuffsize);
   if(!_mask)
@@ -668,28 +690,28 @@ void dt_develop_blend_process(dt_iop_module_t *self,
       if(operation == DEVELOP_MASK_POST_FEATHER_IN)
       {
         if(rois_equal)
-          _develop_blend_process_feather((float *restrict)ivoid, mask,
+          _develop_blend_process_feather(piece, (float *restrict)ivoid, mask,
                                          owidth, oheight, ch, guide_weight,
                                          d->feathering_radius,
                                          roi_out->scale / piece->iscale,
                                          sqrt_eps);
         else
         {
-          float *const restrict guide = dt_alloc_align_float(obuffsize * ch);
+          float *const restrict guide = dt_dev_pixelpipe_scratch_float(piece->pipe, obuffsize * ch);
           if(guide)
           {
             dt_iop_copy_image_roi(guide, (float *restrict)ivoid, ch, roi_in, roi_out);
-            _develop_blend_process_feather(guide, mask, owidth, oheight, ch, guide_weight,
+            _develop_blend_process_feather(piece, guide, mask, owidth, oheight, ch, guide_weight,
                                            d->feathering_radius,
                                            roi_out->scale / piece->iscale,
                                            sqrt_eps);
-            dt_free_align(guide);
+            dt_dev_pixelpipe_scratch_free(piece->pipe, guide);
           }
         }
       }
       else if(operation == DEVELOP_MASK_POST_FEATHER_OUT)
       {
-        _develop_blend_process_feather((const float *const restrict)ovoid, mask,
+        _develop_blend_process_feather(piece, (const float *const restrict)ovoid, mask,
                                        owidth, oheight, ch,
                                        guide_weight,
                                        d->feathering_radius,
@@ -935,6 +957,24 @@ gboolean dt_develop_blend_process_cl(dt_iop_module_t *self,
   // get the clipped opacity value  0 - 1
   const float opacity = CLIP(d->opacity / 100.0f);
 
+  // same fast path as in dt_develop_blend_process(); on the device this
+  // additionally saves the dev_tmp copy of the output image
+  if(uniform
+     && opacity == 1.0f
+     && d->blend_mode == DEVELOP_BLEND_NORMAL2
+     && request_mask_display == DT_DEV_PIXELPIPE_DISPLAY_NONE
+     && request_raster_display == DT_DEV_PIXELPIPE_DISPLAY_NONE
+     && mask_display == DT_DEV_PIXELPIPE_DISPLAY_NONE
+     && !dt_iop_piece_is_raster_mask_used(piece, BLEND_RASTER_ID))
+  {
+    dt_print_pipe(DT_DEBUG_PIPE,
+       "blend pass-through",
+       piece->pipe, self, piece->pipe->devid, roi_in, roi_out, "%s",
+       dt_iop_colorspace_to_name(cst));
+    dt_iop_piece_clear_raster(piece, NULL);
+    return TRUE;
+  }
+
   // allocate space for blend mask
   float *_mask = dt_alloc_align_float(obuffsize);
   if(!_mask)
@@ -517,7 +517,9 @@ gboolean dt_develop_blend_process_cl(dt_iop_module_t *self,
                                      const dt_iop_roi_t *roi_out);
 #endif
 
-#define _BLEND_FUNC_PROTO(align, uni) DT_OMP_DECLARE_SIMD(aligned align uniform uni) static void
+// the per-row blend workers get multiversioned so the vectorized loops
+// dispatch to the best instruction set of the host at runtime
+#define _BLEND_FUNC_PROTO(align, uni) DT_OMP_DECLARE_SIMD(aligned align uniform uni) __DT_CLONE_TARGETS__ static void
 
 G_END_DECLS
 
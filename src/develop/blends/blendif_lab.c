@@ -150,6 +150,7 @@ static inline void _blendif_lch(const float *const restrict pixels,
 }
 
 DT_OMP_DECLARE_SIMD(aligned(pixels: 16) uniform(stride, blendif, parameters))
+__DT_CLONE_TARGETS__
 static void _blendif_combine_channels(const float *const restrict pixels,
                                       float *const restrict mask,
                                       const size_t stride,
@@ -1276,6 +1277,7 @@ static inline void _display_channel_value(dt_aligned_pixel_t out, const float va
 }
 
 DT_OMP_DECLARE_SIMD(aligned(a, b:16) uniform(channel, stride))
+__DT_CLONE_TARGETS__
 static void _display_channel(const float *const restrict a,
                              float *const restrict b,
                              const float *const restrict mask,
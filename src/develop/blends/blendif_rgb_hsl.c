@@ -174,6 +174,7 @@ static inline void _blendif_hsl(const float *const restrict pixels,
 }
 
 DT_OMP_DECLARE_SIMD(aligned(pixels: 16) uniform(stride, blendif, parameters, profile))
+__DT_CLONE_TARGETS__
 static void _blendif_combine_channels(const float *const restrict pixels,
                                       float *const restrict mask,
                                       const size_t stride,
@@ -1096,6 +1097,7 @@ static inline float _rgb_luminance(const float *const restrict rgb,
 }
 
 DT_OMP_DECLARE_SIMD(aligned(a, b:16) uniform(channel, profile, stride))
+__DT_CLONE_TARGETS__
 static void _display_channel(const float *const restrict a,
                              float *const restrict b,
                              const float *const restrict mask,
@@ -195,6 +195,7 @@ static inline void _blendif_jzczhz_lab(const float *const restrict pixels,
 }
 
 DT_OMP_DECLARE_SIMD(aligned(pixels: 16) uniform(stride, blendif, parameters, profile))
+__DT_CLONE_TARGETS__
 static void _blendif_combine_channels(const float *const restrict pixels,
                                       float *const restrict mask,
                                       const size_t stride,
@@ -805,6 +806,7 @@ static inline void _rgb_to_JzCzhz(const dt_aligned_pixel_t rgb,
 
 
 DT_OMP_DECLARE_SIMD(aligned(a, b:16) uniform(channel, profile, stride))
+__DT_CLONE_TARGETS__
 static void _display_channel(const float *const restrict a,
                              float *const restrict b,
                              const float *const restrict mask,
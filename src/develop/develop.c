@@ -905,15 +905,18 @@ static void _dev_add_history_item_ext(dt_develop_t *dev,
     hist->focus_hash = dev->focus_hash;
     hist->enabled = module->enabled;
     hist->module = module;
-    hist->params = malloc(module->params_size);
+    hist->params = dt_dev_history_blob_new(module->params_size);
     hist->iop_order = module->iop_order;
     hist->multi_priority = module->multi_priority;
     hist->multi_name_hand_edited = module->multi_name_hand_edited;
     g_strlcpy(hist->multi_name, module->multi_name, sizeof(hist->multi_name));
     /* allocate and set hist blend_params */
-    hist->blend_params = malloc(sizeof(dt_develop_blend_params_t));
+    hist->blend_params = dt_dev_history_blob_new(sizeof(dt_develop_blend_params_t));
     memcpy(hist->params, module->params, module->params_size);
     memcpy(hist->blend_params, module->blend_params, sizeof(dt_develop_blend_params_t));
+    hist->params = dt_dev_history_blob_intern(hist->params, module->params_size);
+    hist->blend_params =
+      dt_dev_history_blob_intern(hist->blend_params, sizeof(dt_develop_blend_params_t));
     if(include_masks)
       hist->forms = dt_masks_dup_forms_deep(dev->forms, NULL);
     else
@@ -930,12 +933,18 @@ static void _dev_add_history_item_ext(dt_develop_t *dev,
   }
   else
   {
-    // same operation, change params
+    // same operation, change params.  an undo snapshot may still
+    // reference the blobs, so unshare them before writing
     hist = (dt_dev_history_item_t *)history->data;
+    hist->params = dt_dev_history_blob_write(hist->params, module->params_size);
     memcpy(hist->params, module->params, module->params_size);
 
     if(module->flags() & IOP_FLAGS_SUPPORTS_BLENDING)
+    {
+      hist->blend_params =
+        dt_dev_history_blob_write(hist->blend_params, sizeof(dt_develop_blend_params_t));
       memcpy(hist->blend_params, module->blend_params, sizeof(dt_develop_blend_params_t));
+    }
 
     hist->iop_order = module->iop_order;
     hist->multi_priority = module->multi_priority;
@@ -1131,6 +1140,8 @@ void dt_dev_add_masks_history_item(dt_develop_t *dev,
   {
     dt_masks_point_group_t *fpt = g_list_nth_data(form->points, gui->group_edited);
     if(fpt) target = GINT_TO_POINTER(fpt->formid);
+    // localized mask edit, let the full pipe recompute only the affected region
+    dt_masks_set_dirty_region(dev);
   }
 
   dt_pthread_mutex_lock(&dev->history_mutex);
@@ -1164,11 +1175,130 @@ void dt_dev_add_masks_history_item(dt_develop_t *dev,
   }
 }
 
+/* history item params and blend_params blobs carry a refcount header so
+   that undo snapshots can share unchanged entries instead of deep
+   copying every module's params.  the header lives in front of the
+   pointer handed out, so readers are unaffected.
+
+   on top of that, finalized blobs can be interned: a content-hashed
+   table maps identical payloads to a single shared blob, so the many
+   near-duplicate entries of a long history stack (above all the default
+   blend params repeated by every module) collapse into one allocation
+   each when the stack is loaded. */
+typedef struct dt_dev_history_blob_header_t
+{
+  int refcount;
+  uint32_t size;     // payload size, only valid while interned
+  dt_hash_t hash;    // content hash, only valid while interned
+  gboolean interned;
+} dt_dev_history_blob_header_t;
+
+#define HISTORY_BLOB_HEADER(b) (((dt_dev_history_blob_header_t *)(b)) - 1)
+
+static GMutex _blob_intern_mutex;
+static GHashTable *_blob_intern_table = NULL;
+
+static guint _blob_intern_hash(gconstpointer key)
+{
+  return (guint)((const dt_dev_history_blob_header_t *)key)->hash;
+}
+
+static gboolean _blob_intern_equal(gconstpointer a, gconstpointer b)
+{
+  const dt_dev_history_blob_header_t *ha = a;
+  const dt_dev_history_blob_header_t *hb = b;
+  return ha->hash == hb->hash
+         && ha->size == hb->size
+         && memcmp(ha + 1, hb + 1, ha->size) == 0;
+}
+
+void *dt_dev_history_blob_new(const size_t size)
+{
+  dt_dev_history_blob_header_t *header = malloc(sizeof(*header) + size);
+  if(!header) return NULL;
+  header->refcount = 1;
+  header->interned = FALSE;
+  return header + 1;
+}
+
+void *dt_dev_history_blob_ref(void *blob)
+{
+  if(blob) g_atomic_int_inc(&HISTORY_BLOB_HEADER(blob)->refcount);
+  return blob;
+}
+
+void dt_dev_history_blob_unref(void *blob)
+{
+  if(!blob) return;
+  dt_dev_history_blob_header_t *header = HISTORY_BLOB_HEADER(blob);
+  if(header->interned)
+  {
+    /* the last decrement of an interned blob must happen under the
+       intern lock, otherwise a concurrent intern of the same content
+       could resurrect the blob while we free it */
+    g_mutex_lock(&_blob_intern_mutex);
+    if(g_atomic_int_dec_and_test(&header->refcount))
+    {
+      g_hash_table_remove(_blob_intern_table, header);
+      free(header);
+    }
+    g_mutex_unlock(&_blob_intern_mutex);
+  }
+  else if(g_atomic_int_dec_and_test(&header->refcount))
+    free(header);
+}
+
+void *dt_dev_history_blob_intern(void *blob, const size_t size)
+{
+  if(!blob) return NULL;
+  dt_dev_history_blob_header_t *header = HISTORY_BLOB_HEADER(blob);
+  if(header->interned) return blob;
+
+  header->size = size;
+  header->hash = dt_hash(DT_INITHASH, blob, size);
+
+  g_mutex_lock(&_blob_intern_mutex);
+  if(!_blob_intern_table)
+    _blob_intern_table = g_hash_table_new(_blob_intern_hash, _blob_intern_equal);
+
+  dt_dev_history_blob_header_t *shared =
+    g_hash_table_lookup(_blob_intern_table, header);
+  if(shared)
+  {
+    g_atomic_int_inc(&shared->refcount);
+    g_mutex_unlock(&_blob_intern_mutex);
+    dt_dev_history_blob_unref(blob);
+    return shared + 1;
+  }
+  header->interned = TRUE;
+  g_hash_table_add(_blob_intern_table, header);
+  g_mutex_unlock(&_blob_intern_mutex);
+  return blob;
+}
+
+void *dt_dev_history_blob_write(void *blob, const size_t size)
+{
+  if(!blob
+     || (!HISTORY_BLOB_HEADER(blob)->interned
+         && g_atomic_int_get(&HISTORY_BLOB_HEADER(blob)->refcount) == 1))
+    return blob;
+  /* still referenced by a snapshot - or interned, in which case the
+     content is the lookup key and must never change in place - so give
+     the caller a private copy */
+  void *copy = dt_dev_history_blob_new(size);
+  if(copy)
+  {
+    memcpy(copy, blob, size);
+    dt_dev_history_blob_unref(blob);
+  }
+  return copy;
+}
+
 void dt_dev_free_history_item(gpointer data)
 {
   dt_dev_history_item_t *item = (dt_dev_history_item_t *)data;
-  free(item->params);
-  free(item->blend_params);
+  dt_dev_history_blob_unref(item->params);
+  dt_dev_history_blob_unref(item->blend_params);
   g_list_free_full(item->forms, (void (*)(void *))dt_masks_free_form);
   free(item);
 }
@@ -2211,8 +2341,8 @@ void dt_dev_read_history_ext(dt_develop_t *dev,
     g_strlcpy(hist->op_name, hist->module->op, sizeof(hist->op_name));
     if(multi_name) // multi_name can be NULL on DB
       g_strlcpy(hist->multi_name, multi_name, sizeof(hist->multi_name));
-    hist->params = malloc(hist->module->params_size);
-    hist->blend_params = malloc(sizeof(dt_develop_blend_params_t));
+    hist->params = dt_dev_history_blob_new(hist->module->params_size);
+    hist->blend_params = dt_dev_history_blob_new(sizeof(dt_develop_blend_params_t));
 
     // update module iop_order only on active history entries
     if(history_end_current > dev->history_end)
@@ -2303,6 +2433,12 @@ void dt_dev_read_history_ext(dt_develop_t *dev,
     if(hist->module->default_enabled && hist->module->hide_enable_button)
       hist->enabled = TRUE;
 
+    /* the blobs are final now, dedup against identical entries earlier
+       in this stack or in other loaded images */
+    hist->params = dt_dev_history_blob_intern(hist->params, hist->module->params_size);
+    hist->blend_params =
+      dt_dev_history_blob_intern(hist->blend_params, sizeof(dt_develop_blend_params_t));
+
     dev->history = g_list_append(dev->history, hist);
     dev->history_end++;
   }
@@ -408,6 +408,18 @@ void dt_dev_read_history_ext(dt_develop_t *dev,
                              const gboolean no_image);
 void dt_dev_read_history(dt_develop_t *dev);
 void dt_dev_free_history_item(gpointer data);
+/** history item params and blend_params are refcounted copy-on-write
+ * blobs: allocate them with dt_dev_history_blob_new (never malloc),
+ * share with _ref, release with _unref and call _write before any
+ * in-place modification so a snapshot holding the blob keeps its own
+ * version.  once a blob's content is final, _intern may replace it by
+ * an existing blob with identical content so duplicates across the
+ * history stack share one allocation; use the returned pointer. */
+void *dt_dev_history_blob_new(const size_t size);
+void *dt_dev_history_blob_ref(void *blob);
+void dt_dev_history_blob_unref(void *blob);
+void *dt_dev_history_blob_write(void *blob, const size_t size);
+void *dt_dev_history_blob_intern(void *blob, const size_t size);
 void dt_dev_invalidate_history_module(GList *list,
                                       struct dt_iop_module_t *module);
 
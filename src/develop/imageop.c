@@ -1743,10 +1743,17 @@ void _iop_set_darktable_iop_table()
 
 void dt_iop_load_modules_so(void)
 {
+  // the per-module preset init below issues a burst of small writes
+  // (built-in preset inserts, legacy preset upgrades); batch them into
+  // one transaction instead of paying a commit for each module
+  dt_database_start_transaction(darktable.db);
+
   darktable.iop = dt_module_load_modules
     ("/plugins", sizeof(dt_iop_module_so_t),
      dt_iop_load_module_so, _init_module_so, NULL);
 
+  dt_database_release_transaction(darktable.db);
+
   DT_CONTROL_SIGNAL_CONNECT(DT_SIGNAL_PREFERENCES_CHANGE,
                             _iop_preferences_changed, darktable.iop);
 
@@ -3525,12 +3532,17 @@ void dt_iop_update_multi_priority(dt_iop_module_t *module, const int new_priorit
 
     sink_module->blend_params->raster_mask_instance = new_priority;
 
-    // also fix history entries
+    // also fix history entries; the blobs may be shared with a snapshot
+    // or interned, so unshare them before writing
     for(GList *hiter = module->dev->history; hiter; hiter = g_list_next(hiter))
     {
       dt_dev_history_item_t *hist = hiter->data;
       if(hist->module == sink_module)
+      {
+        hist->blend_params =
+          dt_dev_history_blob_write(hist->blend_params, sizeof(dt_develop_blend_params_t));
         hist->blend_params->raster_mask_instance = new_priority;
+      }
     }
   }
 
@@ -104,7 +104,8 @@ typedef enum dt_iop_flags_t
   IOP_FLAGS_CROP_EXPOSER = 1 << 16,      // offers crop exposing
   IOP_FLAGS_EXPAND_ROI_IN = 1 << 17,     // we might have to take special care about roi expansion
   IOP_FLAGS_WRITE_DETAILS = 1 << 18,     // provides the scharr mask used by details
-  IOP_FLAGS_WRITE_RASTER = 1 << 19       // modules not supporting blending might still advertise a raster mask
+  IOP_FLAGS_WRITE_RASTER = 1 << 19,      // modules not supporting blending might still advertise a raster mask
+  IOP_FLAGS_POINTWISE = 1 << 20          // process() is a pure per-pixel map, it may safely run in place on its input buffer
 } dt_iop_flags_t;
 
 /** status of a module*/
@@ -587,6 +587,9 @@ gboolean dt_masks_events_mouse_leave(struct dt_iop_module_t *module);
 gboolean dt_masks_events_mouse_enter(struct dt_iop_module_t *module);
 
 /** functions used to manipulate gui data */
+/** pass the bounding box of the currently edited form as a dirty-region
+    hint to the full pipe, so a localized edit only recomputes that part */
+void dt_masks_set_dirty_region(dt_develop_t *dev);
 void dt_masks_gui_form_create(dt_masks_form_t *form,
                               dt_masks_form_gui_t *gui,
                               const int index,
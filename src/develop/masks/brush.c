@@ -2961,15 +2961,13 @@ static int _brush_get_mask(const dt_iop_module_t *const module,
     return 0;
   }
 
-  // now we fill the falloff
-  int p0[2], p1[2];
-
+  // now we fill the falloff; the dabs are independent of each other so
+  // they can be composited in parallel just as in the roi variant below
+  DT_OMP_FOR()
   for(int i = _nb_ctrl_point(nb_corner); i < border_count; i++)
   {
-    p0[0] = points[i * 2];
-    p0[1] = points[i * 2 + 1];
-    p1[0] = border[i * 2];
-    p1[1] = border[i * 2 + 1];
+    int p0[2] = { points[i * 2], points[i * 2 + 1] };
+    int p1[2] = { border[i * 2], border[i * 2 + 1] };
 
     _brush_falloff(*buffer, p0, p1, *posx, *posy, *width,
                    payload[i * 2], payload[i * 2 + 1]);
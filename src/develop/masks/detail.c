@@ -190,6 +190,28 @@ float *dt_masks_calc_detail_mask(dt_dev_pixelpipe_iop_t *piece,
     return NULL;
 
   const size_t msize = (size_t) details->roi.width * details->roi.height;
+
+  /* several modules may ask for the very same blended detail mask while
+     the scharr data only changes when demosaic or rawprepare rerun, so we
+     keep the last few results with the pipe.  export and thumbnail pipes
+     visit every module just once, no point in caching there. */
+  const gboolean caching = (pipe->type & DT_DEV_PIXELPIPE_SCREEN) != 0;
+  if(caching)
+  {
+    for(int k = 0; k < DT_DEV_DETAIL_BLEND_CACHE; k++)
+    {
+      dt_dev_detail_blend_t *entry = &pipe->detail_blend[k];
+      if(entry->data
+         && entry->detail == detail
+         && feqf(entry->threshold, threshold, 1e-9f))
+      {
+        float *mask = dt_alloc_align_float(msize);
+        if(mask) dt_iop_image_copy(mask, entry->data, msize);
+        return mask;
+      }
+    }
+  }
+
   float *tmp = dt_alloc_align_float(msize);
   float *mask = dt_alloc_align_float(msize);
   if(!tmp || !mask)
@@ -201,7 +223,20 @@ float *dt_masks_calc_detail_mask(dt_dev_pixelpipe_iop_t *piece,
 
   dt_masks_calc_detail_blend(details->data, tmp, msize, threshold, detail);
   dt_gaussian_fast_blur(tmp, mask, details->roi.width, details->roi.height, 2.0f, 0.0f, 1.0f, 1);
-  dt_free_align(tmp);
+
+  if(caching)
+  {
+    // reuse tmp to hold the cached copy, replacing entries round-robin
+    dt_dev_detail_blend_t *entry = &pipe->detail_blend[pipe->detail_blend_next];
+    pipe->detail_blend_next = (pipe->detail_blend_next + 1) % DT_DEV_DETAIL_BLEND_CACHE;
+    if(entry->data) dt_free_align(entry->data);
+    dt_iop_image_copy(tmp, mask, msize);
+    entry->data = tmp;
+    entry->threshold = threshold;
+    entry->detail = detail;
+  }
+  else
+    dt_free_align(tmp);
   return mask;
 }
 
@@ -17,6 +17,7 @@
 */
 
 #include "common/debug.h"
+#include "common/imagebuf.h"
 #include "control/conf.h"
 #include "control/control.h"
 #include "develop/blend.h"
@@ -741,8 +742,50 @@ int dt_masks_group_render_roi(dt_iop_module_t *module,
   if(!form) return 0;
 
   double start = dt_get_debug_wtime();
+  const size_t npixels = (size_t)roi->width * roi->height;
+
+  /* key the rasterization by the content of the mask group, the
+     requested roi and a probe of the input corners through the same
+     distortion chain the shapes are transformed with, so a geometry
+     change upstream invalidates the cache even when the roi stays
+     put.  a hit saves re-rasterizing and re-combining the whole group
+     every time a downstream change reruns this piece. */
+  dt_hash_t hash = dt_masks_group_hash(DT_INITHASH, form);
+  hash = dt_hash(hash, roi, sizeof(dt_iop_roi_t));
+  float probe[8] = { 0.0f, 0.0f,
+                     piece->pipe->iwidth, 0.0f,
+                     0.0f, piece->pipe->iheight,
+                     piece->pipe->iwidth, piece->pipe->iheight };
+  dt_dev_distort_transform_plus(module->dev, piece->pipe, module->iop_order,
+                                DT_DEV_TRANSFORM_DIR_BACK_EXCL, probe, 4);
+  hash = dt_hash(hash, probe, sizeof(probe));
+
+  if(piece->dmask_data
+     && piece->dmask_hash == hash
+     && piece->dmask_npixels == npixels)
+  {
+    dt_iop_image_copy(buffer, piece->dmask_data, npixels);
+    dt_print(DT_DEBUG_MASKS | DT_DEBUG_PERF,
+             "[masks] rendered all masks from piece cache in %0.04f sec",
+             dt_get_lap_time(&start));
+    return 1;
+  }
+
   const int ok = dt_masks_get_mask_roi(module, piece, form, roi, buffer);
 
+  // keep a copy for the next run of this piece; a failed render drops
+  // whatever was cached before
+  dt_free_align(piece->dmask_data);
+  piece->dmask_data = ok ? dt_alloc_align_float(npixels) : NULL;
+  piece->dmask_hash = DT_INVALID_HASH;
+  piece->dmask_npixels = 0;
+  if(piece->dmask_data)
+  {
+    dt_iop_image_copy(piece->dmask_data, buffer, npixels);
+    piece->dmask_hash = hash;
+    piece->dmask_npixels = npixels;
+  }
+
   dt_print(DT_DEBUG_MASKS | DT_DEBUG_PERF,
            "[masks] render all masks took %0.04f sec",
            dt_get_lap_time(&start));
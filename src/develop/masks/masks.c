@@ -208,6 +208,48 @@ void dt_masks_gui_form_create(dt_masks_form_t *form,
   }
 }
 
+void dt_masks_set_dirty_region(dt_develop_t *dev)
+{
+  const dt_masks_form_gui_t *gui = dev->form_gui;
+  const dt_dev_pixelpipe_t *preview = dev->preview_pipe;
+  if(!gui || !preview
+     || preview->processed_width < 1
+     || preview->processed_height < 1)
+    return;
+
+  /* bounding box over all gui points of the edited form; points are in
+     preview pipe output coordinates so we normalize with its processed
+     dimensions. successive drag events union their boxes inside the pipe
+     so the old position of the form is covered too. */
+  float x1 = FLT_MAX, y1 = FLT_MAX, x2 = -FLT_MAX, y2 = -FLT_MAX;
+  int found = 0;
+  for(const GList *l = gui->points; l; l = g_list_next(l))
+  {
+    const dt_masks_form_gui_points_t *gpt = l->data;
+    const float *coords[3] = { gpt->points, gpt->border, gpt->source };
+    const int counts[3] = { gpt->points_count, gpt->border_count, gpt->source_count };
+    for(int b = 0; b < 3; b++)
+    {
+      if(!coords[b]) continue;
+      for(int i = 0; i < counts[b]; i++)
+      {
+        x1 = fminf(x1, coords[b][2 * i]);
+        y1 = fminf(y1, coords[b][2 * i + 1]);
+        x2 = fmaxf(x2, coords[b][2 * i]);
+        y2 = fmaxf(y2, coords[b][2 * i + 1]);
+        found++;
+      }
+    }
+  }
+  if(!found) return;
+
+  const float box[4] = { x1 / preview->processed_width,
+                         y1 / preview->processed_height,
+                         x2 / preview->processed_width,
+                         y2 / preview->processed_height };
+  dt_dev_pixelpipe_set_dirty_region(dev->full.pipe, box);
+}
+
 void dt_masks_form_gui_points_free(const gpointer data)
 {
   if(!data) return;
@@ -1266,6 +1266,179 @@ static int _path_find_self_intersection(dt_masks_dynbuf_t *inter,
 
 /** get all points of the path and the border */
 /** this take care of gaps and self-intersection and iop distortions */
+// during an interactive node drag only the segments around the dragged
+// node change, yet we re-tessellate and above all re-distort the full
+// outline on every mouse move.  the tessellation itself is cheap float
+// work, but pushing the tens of thousands of outline points of a large
+// path through all distortion modules is not.  so we keep a snapshot of
+// the last outline of the form being edited: segments whose freshly
+// tessellated points are bitwise identical to the snapshot reuse the
+// distorted coordinates computed last time, and only the edited
+// segments are sent through dt_dev_distort_transform_plus().  the
+// snapshot is keyed on the pipe's backbuf hash so that any change to
+// the distortion stack drops it.
+typedef struct _path_xform_cache_t
+{
+  dt_mask_id_t formid;
+  dt_dev_pixelpipe_t *pipe;
+  dt_hash_t pipe_hash;
+  int transf_direction;
+  int nb;
+  int *pts_off, *brd_off;         // nb+1 segment start offsets (in floats)
+  float *raw_points, *raw_border; // untransformed, after intersection repair
+  float *xf_points, *xf_border;   // distorted, before the header fixups
+} _path_xform_cache_t;
+
+static _path_xform_cache_t _xform_cache = { NO_MASKID };
+static GMutex _xform_cache_mutex;
+
+static void _xform_cache_clear(void)
+{
+  free(_xform_cache.pts_off);
+  free(_xform_cache.brd_off);
+  dt_free_align(_xform_cache.raw_points);
+  dt_free_align(_xform_cache.raw_border);
+  dt_free_align(_xform_cache.xf_points);
+  dt_free_align(_xform_cache.xf_border);
+  memset(&_xform_cache, 0, sizeof(_xform_cache));
+  _xform_cache.formid = NO_MASKID;
+}
+
+// transform one outline array, reusing the cached distorted
+// coordinates of every range whose untransformed points are unchanged.
+// range 0 is the 6*nb header block, range k+1 is the kth segment.
+static gboolean _xform_array_incremental(dt_develop_t *dev,
+                                         dt_dev_pixelpipe_t *pipe,
+                                         const double iop_order,
+                                         const int transf_direction,
+                                         const int nb,
+                                         float *arr,
+                                         const float *raw,
+                                         const int *off,
+                                         const float *craw,
+                                         const float *cxf,
+                                         const int *coff)
+{
+  for(int r = 0; r <= nb; r++)
+  {
+    const int start = (r == 0) ? 0 : off[r - 1];
+    const int cstart = (r == 0) ? 0 : coff[r - 1];
+    const int cnt = off[r] - start;
+
+    if(cnt == coff[r] - cstart
+       && !memcmp(raw + start, craw + cstart, sizeof(float) * cnt))
+      memcpy(arr + start, cxf + cstart, sizeof(float) * cnt);
+    else if(cnt > 0
+            && !dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
+                                              arr + start, cnt / 2))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static gboolean _path_transform_with_cache(dt_develop_t *dev,
+                                           dt_dev_pixelpipe_t *pipe,
+                                           const double iop_order,
+                                           const int transf_direction,
+                                           dt_masks_form_t *form,
+                                           const int nb,
+                                           float *path_points,
+                                           const int points_count,
+                                           const int *pts_off,
+                                           float *path_border,
+                                           const int border_count,
+                                           const int *brd_off)
+{
+  // snapshots of the untransformed outline; they double as the
+  // comparison reference for the next call
+  const size_t pts_floats = (size_t)2 * points_count;
+  const size_t brd_floats = (size_t)2 * border_count;
+  float *raw_points = dt_alloc_align_float(pts_floats);
+  float *raw_border = dt_alloc_align_float(brd_floats);
+
+  if(!raw_points || !raw_border)
+  {
+    dt_free_align(raw_points);
+    dt_free_align(raw_border);
+    return dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
+                                         path_points, points_count)
+           && dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
+                                            path_border, border_count);
+  }
+
+  memcpy(raw_points, path_points, sizeof(float) * pts_floats);
+  memcpy(raw_border, path_border, sizeof(float) * brd_floats);
+
+  g_mutex_lock(&_xform_cache_mutex);
+
+  gboolean success;
+  if(_xform_cache.formid == form->formid
+     && _xform_cache.pipe == pipe
+     && _xform_cache.pipe_hash == pipe->backbuf_hash
+     && _xform_cache.transf_direction == transf_direction
+     && _xform_cache.nb == nb)
+  {
+    success = _xform_array_incremental(dev, pipe, iop_order, transf_direction, nb,
+                                       path_points, raw_points, pts_off,
+                                       _xform_cache.raw_points,
+                                       _xform_cache.xf_points, _xform_cache.pts_off)
+              && _xform_array_incremental(dev, pipe, iop_order, transf_direction, nb,
+                                          path_border, raw_border, brd_off,
+                                          _xform_cache.raw_border,
+                                          _xform_cache.xf_border, _xform_cache.brd_off);
+  }
+  else
+  {
+    // nothing to compare against, transform wholesale as before
+    success = dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
+                                            path_points, points_count)
+              && dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
+                                               path_border, border_count);
+  }
+
+  _xform_cache_clear();
+  if(success)
+  {
+    float *xf_points = dt_alloc_align_float(pts_floats);
+    float *xf_border = dt_alloc_align_float(brd_floats);
+    int *poff = malloc(sizeof(int) * (nb + 1));
+    int *boff = malloc(sizeof(int) * (nb + 1));
+    if(xf_points && xf_border && poff && boff)
+    {
+      memcpy(xf_points, path_points, sizeof(float) * pts_floats);
+      memcpy(xf_border, path_border, sizeof(float) * brd_floats);
+      memcpy(poff, pts_off, sizeof(int) * (nb + 1));
+      memcpy(boff, brd_off, sizeof(int) * (nb + 1));
+      _xform_cache.formid = form->formid;
+      _xform_cache.pipe = pipe;
+      _xform_cache.pipe_hash = pipe->backbuf_hash;
+      _xform_cache.transf_direction = transf_direction;
+      _xform_cache.nb = nb;
+      _xform_cache.pts_off = poff;
+      _xform_cache.brd_off = boff;
+      _xform_cache.raw_points = raw_points;
+      _xform_cache.raw_border = raw_border;
+      _xform_cache.xf_points = xf_points;
+      _xform_cache.xf_border = xf_border;
+      // ownership of the raw snapshots went to the cache
+      raw_points = raw_border = NULL;
+    }
+    else
+    {
+      dt_free_align(xf_points);
+      dt_free_align(xf_border);
+      free(poff);
+      free(boff);
+    }
+  }
+
+  g_mutex_unlock(&_xform_cache_mutex);
+
+  dt_free_align(raw_points);
+  dt_free_align(raw_border);
+  return success;
+}
+
 static int _path_get_pts_border(dt_develop_t *dev,
                                 dt_masks_form_t *form,
                                 const double iop_order,
@@ -1349,6 +1522,13 @@ static int _path_get_pts_border(dt_develop_t *dev,
   int cw = _path_is_clockwise(form);
   if(cw == 0) cw = -1;
 
+  // per-segment start offsets into the points and border buffers; they
+  // let us reuse the distorted coordinates of untouched segments
+  // across successive calls while a node is being dragged
+  int *pts_off = malloc(sizeof(int) * (nb + 1));
+  int *brd_off = malloc(sizeof(int) * (nb + 1));
+  const gboolean use_cache = border && !source && pts_off && brd_off;
+
   dt_print(DT_DEBUG_MASKS | DT_DEBUG_PERF,
            "[masks %s] path_points init took %0.04f sec", form->name,
            dt_get_lap_time(&start2));
@@ -1358,6 +1538,8 @@ static int _path_get_pts_border(dt_develop_t *dev,
   for(int k = 0; k < nb; k++)
   {
     const int pb = dborder ? dt_masks_dynbuf_position(dborder) : 0;
+    if(pts_off) pts_off[k] = dt_masks_dynbuf_position(dpoints);
+    if(brd_off) brd_off[k] = pb;
     border_init[k * 6 + 2] = -pb;
     // next, wrapping around if on last element
     const GList *pt2 = g_list_next_wraparound(form_points, form->points);
@@ -1462,6 +1644,9 @@ static int _path_get_pts_border(dt_develop_t *dev,
     }
   }
 
+  if(pts_off) pts_off[nb] = dt_masks_dynbuf_position(dpoints);
+  if(brd_off) brd_off[nb] = dborder ? dt_masks_dynbuf_position(dborder) : 0;
+
   *points_count = dt_masks_dynbuf_position(dpoints) / 2;
   *points = dt_masks_dynbuf_harvest(dpoints);
   dt_masks_dynbuf_free(dpoints);
@@ -1532,12 +1717,19 @@ static int _path_get_pts_border(dt_develop_t *dev,
     dt_masks_intbuf_free(gap_fill_segs);
 
     dt_free_align(border_init);
+    free(pts_off);
+    free(brd_off);
     return 1;
   }
-  else if(dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
-                                        *points, *points_count))
+  else if(use_cache
+          ? _path_transform_with_cache(dev, pipe, iop_order, transf_direction,
+                                       form, nb, *points, *points_count, pts_off,
+                                       *border, *border_count, brd_off)
+          : dt_dev_distort_transform_plus(dev, pipe, iop_order, transf_direction,
+                                          *points, *points_count))
   {
-    if(!border
+    // with the cache the border has been transformed along with the points
+    if(use_cache || !border
        || dt_dev_distort_transform_plus(dev, pipe, iop_order,
                                         transf_direction, *border, *border_count))
     {
@@ -1586,6 +1778,8 @@ static int _path_get_pts_border(dt_develop_t *dev,
       dt_masks_dynbuf_free(intersections);
       dt_masks_intbuf_free(gap_fill_segs);
       dt_free_align(border_init);
+      free(pts_off);
+      free(brd_off);
       return 1;
     }
   }
@@ -1595,6 +1789,8 @@ fail:
   dt_masks_dynbuf_free(intersections);
   dt_masks_intbuf_free(gap_fill_segs);
   dt_free_align(border_init);
+  free(pts_off);
+  free(brd_off);
   dt_free_align(*points);
   *points = NULL;
   *points_count = 0;
@@ -16,18 +16,357 @@
     along with darktable.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "common/file_location.h"
+#include "common/imagebuf.h"
+#include "common/resource_limits.h"
+#include "control/conf.h"
 #include "develop/pixelpipe_cache.h"
 #include "develop/format.h"
 #include "develop/pixelpipe.h"
 #include "libs/lib.h"
 #include "libs/colorpicker.h"
+#include <glib/gstdio.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static inline int _to_mb(size_t m)
 {
   return (int)((m + 0x80000lu) / 0x400lu / 0x400lu);
 }
 
+/* The disk tier persists important cachelines - the output of the last
+   expensive module in the stack - keyed by the very same hash used for the
+   in-memory cachelines.  As the hash includes image id, pipe type, all
+   committed module params and the roi, a stale file can never produce a
+   false hit, it just stays unused.
+*/
+
+#define DT_PIPECACHE_DISK_MAGIC 0x44545043u // 'DTPC'
+#define DT_PIPECACHE_DISK_VERSION 1
+
+typedef struct dt_pipecache_disk_header_t
+{
+  uint32_t magic;
+  uint32_t version;
+  dt_hash_t hash;
+  uint64_t size;
+  dt_iop_buffer_dsc_t dsc;
+} dt_pipecache_disk_header_t;
+
+// keep the disk tier bounded; oldest files go first when over the limit
+#define DT_PIPECACHE_DISK_LIMIT (2048lu * 1024lu * 1024lu)
+
+static gboolean _disk_cache_enabled(const dt_dev_pixelpipe_t *pipe)
+{
+  return (pipe->type & DT_DEV_PIXELPIPE_FULL)
+         && dt_conf_get_bool("cache_disk_backend_pixelpipe");
+}
+
+typedef struct dt_pipecache_disk_file_t
+{
+  char *path;
+  time_t mtime;
+  size_t size;
+} dt_pipecache_disk_file_t;
+
+static gint _disk_file_cmp(gconstpointer a, gconstpointer b)
+{
+  const dt_pipecache_disk_file_t *fa = a;
+  const dt_pipecache_disk_file_t *fb = b;
+  return (fa->mtime > fb->mtime) - (fa->mtime < fb->mtime);
+}
+
+// trim pixelpipe.d down to the size limit, dropping the files not
+// touched for the longest time first
+static void _disk_cache_prune(void)
+{
+  char cachedir[PATH_MAX] = { 0 };
+  dt_loc_get_user_cache_dir(cachedir, sizeof(cachedir));
+  char *dirname = g_strdup_printf("%s/pixelpipe.d", cachedir);
+  GDir *dir = g_dir_open(dirname, 0, NULL);
+  if(!dir)
+  {
+    g_free(dirname);
+    return;
+  }
+
+  GList *files = NULL;
+  size_t total = 0;
+  const gchar *name;
+  while((name = g_dir_read_name(dir)))
+  {
+    char *path = g_build_filename(dirname, name, NULL);
+    GStatBuf buf;
+    if(!g_stat(path, &buf) && S_ISREG(buf.st_mode))
+    {
+      dt_pipecache_disk_file_t *file = malloc(sizeof(dt_pipecache_disk_file_t));
+      file->path = path;
+      file->mtime = buf.st_mtime;
+      file->size = buf.st_size;
+      total += file->size;
+      files = g_list_prepend(files, file);
+    }
+    else
+      g_free(path);
+  }
+  g_dir_close(dir);
+
+  files = g_list_sort(files, _disk_file_cmp);
+  size_t removed = 0;
+  for(GList *l = files; l && total > DT_PIPECACHE_DISK_LIMIT; l = g_list_next(l))
+  {
+    dt_pipecache_disk_file_t *file = l->data;
+    if(!g_unlink(file->path))
+    {
+      total -= file->size;
+      removed += file->size;
+    }
+  }
+  if(removed)
+    dt_print(DT_DEBUG_PIPE, "[pixelpipe disk cache] pruned %zuMB, %zuMB left",
+             removed / 1024lu / 1024lu, total / 1024lu / 1024lu);
+
+  for(GList *l = files; l; l = g_list_next(l))
+  {
+    dt_pipecache_disk_file_t *file = l->data;
+    g_free(file->path);
+    free(file);
+  }
+  g_list_free(files);
+  g_free(dirname);
+}
+
+static void _disk_cache_filename(char *filename,
+                                 const size_t len,
+                                 const dt_hash_t hash)
+{
+  char cachedir[PATH_MAX] = { 0 };
+  dt_loc_get_user_cache_dir(cachedir, sizeof(cachedir));
+  snprintf(filename, len, "%s/pixelpipe.d/%016" PRIx64 ".buf", cachedir, hash);
+}
+
+static void _disk_cache_store(const dt_dev_pixelpipe_t *pipe, const int k)
+{
+  const dt_dev_pixelpipe_cache_t *cache = &pipe->cache;
+  if(!_disk_cache_enabled(pipe) || pipe->nocache || pipe->mask_display)
+    return;
+
+  // keep the directory bounded; once per session is enough as the tier
+  // grows by at most a few buffers per edited image
+  static gboolean pruned = FALSE;
+  if(!pruned)
+  {
+    pruned = TRUE;
+    _disk_cache_prune();
+  }
+
+  char filename[PATH_MAX] = { 0 };
+  _disk_cache_filename(filename, sizeof(filename), cache->hash[k]);
+  if(g_file_test(filename, G_FILE_TEST_EXISTS)) return;
+
+  char *dirname = g_path_get_dirname(filename);
+  const int mkd = g_mkdir_with_parents(dirname, 0750);
+  g_free(dirname);
+  if(mkd) return;
+
+  // write to a temp file first so a crash never leaves a truncated
+  // buffer behind that would match the hash
+  char tmpname[PATH_MAX] = { 0 };
+  snprintf(tmpname, sizeof(tmpname), "%s~", filename);
+  FILE *f = g_fopen(tmpname, "wb");
+  if(!f) return;
+
+  dt_pipecache_disk_header_t header = { .magic = DT_PIPECACHE_DISK_MAGIC,
+                                        .version = DT_PIPECACHE_DISK_VERSION,
+                                        .hash = cache->hash[k],
+                                        .size = cache->size[k],
+                                        .dsc = cache->dsc[k] };
+  const gboolean ok = fwrite(&header, sizeof(header), 1, f) == 1
+                      && fwrite(cache->data[k], cache->size[k], 1, f) == 1;
+  fclose(f);
+  if(ok && !g_rename(tmpname, filename))
+    dt_print_pipe(DT_DEBUG_PIPE | DT_DEBUG_VERBOSE, "disk cache store",
+      pipe, NULL, DT_DEVICE_NONE, NULL, NULL, "line%3i hash=%" PRIx64,
+      k, cache->hash[k]);
+  else
+    g_unlink(tmpname);
+}
+
+static int _get_cacheline(dt_dev_pixelpipe_t *pipe);
+static void _mark_invalid_cacheline(const dt_dev_pixelpipe_cache_t *cache, const int k);
+
+static gboolean _disk_cache_fetch(dt_dev_pixelpipe_t *pipe,
+                                  const dt_hash_t hash,
+                                  const size_t size)
+{
+  dt_dev_pixelpipe_cache_t *cache = &pipe->cache;
+  if(!_disk_cache_enabled(pipe) || cache->entries == DT_PIPECACHE_MIN)
+    return FALSE;
+
+  char filename[PATH_MAX] = { 0 };
+  _disk_cache_filename(filename, sizeof(filename), hash);
+  FILE *f = g_fopen(filename, "rb");
+  if(!f) return FALSE;
+
+  dt_pipecache_disk_header_t header;
+  gboolean ok = fread(&header, sizeof(header), 1, f) == 1
+                && header.magic == DT_PIPECACHE_DISK_MAGIC
+                && header.version == DT_PIPECACHE_DISK_VERSION
+                && header.hash == hash
+                && header.size == size;
+  if(ok)
+  {
+    // install the buffer into a regular cacheline so the following
+    // _get_by_hash() serves it exactly like an in-memory hit
+    const int k = _get_cacheline(pipe);
+    if(cache->size[k] != size)
+    {
+      dt_bufpool_free(cache->data[k]);
+      cache->allmem -= cache->size[k];
+      cache->data[k] = (void *)dt_bufpool_alloc(size);
+      cache->size[k] = cache->data[k] ? size : 0;
+      cache->allmem += cache->size[k];
+    }
+    ok = cache->data[k] && fread(cache->data[k], size, 1, f) == 1;
+    if(ok)
+    {
+      cache->dsc[k] = header.dsc;
+      cache->hash[k] = hash;
+      cache->used[k] = -cache->entries;
+      dt_print_pipe(DT_DEBUG_PIPE, "disk cache fetch",
+        pipe, NULL, DT_DEVICE_NONE, NULL, NULL, "line%3i hash=%" PRIx64,
+        k, hash);
+    }
+    else
+      _mark_invalid_cacheline(cache, k);
+  }
+  fclose(f);
+  // a file that fails validation will never match, get rid of it
+  if(!ok) g_unlink(filename);
+  return ok;
+}
+
+/* With the second darkroom window open the main and second-window pipes
+   run the identical module stack and - wherever their roi and scale agree -
+   produce identical intermediates, yet each pipe only ever looks into its
+   own cachelines.  The peer tier exchanges the "important" lines between
+   the two pipes: publishing copies the buffer into a small shared pool
+   under a lock, a cache miss in the other pipe probes the pool and installs
+   the copy into one of its own cachelines exactly like the disk tier does.
+   As FULL and PREVIEW2 hash their pipe type to a common value (see
+   _dev_pixelpipe_cache_basichash) the cacheline hash validates across the
+   two pipes only if all module params, the profiles and the roi match.
+*/
+
+#define DT_PIPECACHE_PEER_SLOTS 4
+
+typedef struct dt_pipecache_peer_slot_t
+{
+  dt_hash_t hash;
+  size_t size;
+  dt_iop_buffer_dsc_t dsc;
+  void *data;
+  uint64_t age;
+} dt_pipecache_peer_slot_t;
+
+static dt_pipecache_peer_slot_t _peer_pool[DT_PIPECACHE_PEER_SLOTS] = {{ 0 }};
+static uint64_t _peer_time = 0;
+static GMutex _peer_pool_mutex;
+
+static gboolean _peer_cache_enabled(const dt_dev_pixelpipe_t *pipe)
+{
+  return (pipe->type & (DT_DEV_PIXELPIPE_FULL | DT_DEV_PIXELPIPE_PREVIEW2))
+         && darktable.develop
+         && darktable.develop->preview2.widget;
+}
+
+static void _peer_cache_store(const dt_dev_pixelpipe_t *pipe, const int k)
+{
+  const dt_dev_pixelpipe_cache_t *cache = &pipe->cache;
+  if(!_peer_cache_enabled(pipe) || pipe->nocache || pipe->mask_display)
+    return;
+
+  g_mutex_lock(&_peer_pool_mutex);
+  // re-use a slot already holding this hash, otherwise take the oldest
+  dt_pipecache_peer_slot_t *slot = &_peer_pool[0];
+  for(int s = 0; s < DT_PIPECACHE_PEER_SLOTS; s++)
+  {
+    if(_peer_pool[s].hash == cache->hash[k])
+    {
+      slot = &_peer_pool[s];
+      break;
+    }
+    if(_peer_pool[s].age < slot->age) slot = &_peer_pool[s];
+  }
+
+  if(slot->size != cache->size[k])
+  {
+    dt_bufpool_free(slot->data);
+    slot->data = (void *)dt_bufpool_alloc(cache->size[k]);
+    slot->size = slot->data ? cache->size[k] : 0;
+  }
+  if(slot->data)
+  {
+    memcpy(slot->data, cache->data[k], cache->size[k]);
+    slot->hash = cache->hash[k];
+    slot->dsc = cache->dsc[k];
+    slot->age = ++_peer_time;
+    dt_print_pipe(DT_DEBUG_PIPE | DT_DEBUG_VERBOSE, "peer cache store",
+      pipe, NULL, DT_DEVICE_NONE, NULL, NULL, "line%3i hash=%" PRIx64,
+      k, cache->hash[k]);
+  }
+  else
+    slot->hash = DT_INVALID_HASH;
+  g_mutex_unlock(&_peer_pool_mutex);
+}
+
+static gboolean _peer_cache_fetch(dt_dev_pixelpipe_t *pipe,
+                                  const dt_hash_t hash,
+                                  const size_t size)
+{
+  dt_dev_pixelpipe_cache_t *cache = &pipe->cache;
+  if(!_peer_cache_enabled(pipe) || cache->entries == DT_PIPECACHE_MIN)
+    return FALSE;
+
+  gboolean found = FALSE;
+  g_mutex_lock(&_peer_pool_mutex);
+  for(int s = 0; s < DT_PIPECACHE_PEER_SLOTS && !found; s++)
+  {
+    dt_pipecache_peer_slot_t *slot = &_peer_pool[s];
+    if(slot->data && slot->hash == hash && slot->size == size)
+    {
+      // install the copy into a regular cacheline so the following
+      // _get_by_hash() serves it exactly like an in-memory hit
+      const int k = _get_cacheline(pipe);
+      if(cache->size[k] != size)
+      {
+        dt_bufpool_free(cache->data[k]);
+        cache->allmem -= cache->size[k];
+        cache->data[k] = (void *)dt_bufpool_alloc(size);
+        cache->size[k] = cache->data[k] ? size : 0;
+        cache->allmem += cache->size[k];
+      }
+      if(cache->data[k])
+      {
+        memcpy(cache->data[k], slot->data, size);
+        cache->dsc[k] = slot->dsc;
+        cache->hash[k] = hash;
+        cache->used[k] = -cache->entries;
+        slot->age = ++_peer_time;
+        found = TRUE;
+        dt_print_pipe(DT_DEBUG_PIPE, "peer cache fetch",
+          pipe, NULL, DT_DEVICE_NONE, NULL, NULL, "line%3i hash=%" PRIx64,
+          k, hash);
+      }
+      else
+        _mark_invalid_cacheline(cache, k);
+    }
+  }
+  g_mutex_unlock(&_peer_pool_mutex);
+  return found;
+}
+
 gboolean dt_dev_pixelpipe_cache_init(dt_dev_pixelpipe_t *pipe,
                                      const int entries,
                                      const size_t size,
@@ -58,7 +397,7 @@ gboolean dt_dev_pixelpipe_cache_init(dt_dev_pixelpipe_t *pipe,
   for(int k = 0; k < entries; k++)
   {
     cache->size[k] = size;
-    cache->data[k] = (void *)dt_alloc_aligned(size);
+    cache->data[k] = (void *)dt_bufpool_alloc(size);
     if(!cache->data[k])
       goto alloc_memory_fail;
 
@@ -72,7 +411,7 @@ gboolean dt_dev_pixelpipe_cache_init(dt_dev_pixelpipe_t *pipe,
   // but will only fail to generate thumbnails for example.
   for(int k = 0; k < cache->entries; k++)
   {
-    dt_free_align(cache->data[k]);
+    dt_bufpool_free(cache->data[k]);
     cache->size[k] = 0;
     cache->data[k] = NULL;
   }
@@ -93,11 +432,39 @@ void dt_dev_pixelpipe_cache_cleanup(dt_dev_pixelpipe_t *pipe)
 
   for(int k = 0; k < cache->entries; k++)
   {
-    dt_free_align(cache->data[k]);
+    dt_bufpool_free(cache->data[k]);
     cache->data[k] = NULL;
   }
   free(cache->data);
   cache->data = NULL;
+
+  // closing one of the two sharing pipes drops the exchanged copies,
+  // the surviving pipe still holds its own cachelines
+  if(pipe->type & (DT_DEV_PIXELPIPE_FULL | DT_DEV_PIXELPIPE_PREVIEW2))
+  {
+    g_mutex_lock(&_peer_pool_mutex);
+    for(int s = 0; s < DT_PIPECACHE_PEER_SLOTS; s++)
+    {
+      dt_bufpool_free(_peer_pool[s].data);
+      _peer_pool[s].data = NULL;
+      _peer_pool[s].size = 0;
+      _peer_pool[s].hash = DT_INVALID_HASH;
+    }
+    g_mutex_unlock(&_peer_pool_mutex);
+  }
+}
+
+static dt_hash_t _hash_profile_info(dt_hash_t hash,
+                                    const dt_iop_order_iccprofile_info_t *info)
+{
+  /* hash the identifying content of the profile, never the session-local
+     pointer, so cachelines persisted by the disk tier stay valid across
+     restarts; type+filename+intent fully determine the derived matrices
+     and luts */
+  if(!info) return hash;
+  hash = dt_hash(hash, &info->type, sizeof(info->type));
+  hash = dt_hash(hash, info->filename, strlen(info->filename));
+  return dt_hash(hash, &info->intent, sizeof(info->intent));
 }
 
 static dt_hash_t _dev_pixelpipe_cache_basichash(dt_dev_pixelpipe_t *pipe,
@@ -118,13 +485,19 @@ static dt_hash_t _dev_pixelpipe_cache_basichash(dt_dev_pixelpipe_t *pipe,
        6) Please note that pipe->type, want_details and request_color_pick are only used if a roi is provided
           for better support of dt_dev_pixelpipe_piece_hash()
   */
+  /* the main and second-window pipes run the identical stack, hashing
+     their type bits to a common value makes identically parametrized
+     cachelines validate across the two pipes (see the peer tier) */
+  uint32_t pipetype = (uint32_t)pipe->type;
+  if(pipetype & (DT_DEV_PIXELPIPE_FULL | DT_DEV_PIXELPIPE_PREVIEW2))
+    pipetype |= DT_DEV_PIXELPIPE_FULL | DT_DEV_PIXELPIPE_PREVIEW2;
   const uint32_t hashing_pipemode[3] = {(uint32_t)pipe->image.id,
-                                        (uint32_t)pipe->type,
+                                        pipetype,
                                         (uint32_t)pipe->want_detail_mask };
   dt_hash_t hash = dt_hash(DT_INITHASH, &hashing_pipemode, sizeof(uint32_t) * (roi ? 3 : 1));
-  hash = dt_hash(hash, &pipe->input_profile_info, sizeof(pipe->input_profile_info));
-  hash = dt_hash(hash, &pipe->work_profile_info, sizeof(pipe->work_profile_info));
-  hash = dt_hash(hash, &pipe->output_profile_info, sizeof(pipe->output_profile_info));
+  hash = _hash_profile_info(hash, pipe->input_profile_info);
+  hash = _hash_profile_info(hash, pipe->work_profile_info);
+  hash = _hash_profile_info(hash, pipe->output_profile_info);
 
   // go through all modules up to position and compute a hash using the operation and params.
   GList *pieces = pipe->nodes;
@@ -194,6 +567,19 @@ gboolean dt_dev_pixelpipe_cache_available(dt_dev_pixelpipe_t *pipe,
       return TRUE;
     }
   }
+  // miss in memory, probe the peer pipe's published lines first - a copy
+  // beats both the disk tier and recomputing the stack
+  if(_peer_cache_fetch(pipe, hash, size))
+  {
+    cache->hits++;
+    return TRUE;
+  }
+  // then the disk tier, if found serve it from a freshly filled cacheline
+  if(_disk_cache_fetch(pipe, hash, size))
+  {
+    cache->hits++;
+    return TRUE;
+  }
   return FALSE;
 }
 
@@ -329,9 +715,9 @@ gboolean dt_dev_pixelpipe_cache_get(dt_dev_pixelpipe_t *pipe,
   if(((cache->entries == DT_PIPECACHE_MIN) && (cache->size[cline] < size))
      || ((cache->entries > DT_PIPECACHE_MIN) && (cache->size[cline] != size)))
   {
-    dt_free_align(cache->data[cline]);
+    dt_bufpool_free(cache->data[cline]);
     cache->allmem -= cache->size[cline];
-    cache->data[cline] = (void *)dt_alloc_aligned(size);
+    cache->data[cline] = (void *)dt_bufpool_alloc(size);
     if(cache->data[cline])
     {
       cache->size[cline] = size;
@@ -413,7 +799,14 @@ void dt_dev_pixelpipe_important_cacheline(const dt_dev_pixelpipe_t *pipe,
     if((cache->data[k] == data)
         && (size == cache->size[k])
         && (cache->hash[k] != DT_INVALID_HASH))
+    {
       cache->used[k] = -cache->entries;
+      // important cachelines are the output of the expensive part of the
+      // stack, persist them so a warm reopen resumes from here and
+      // publish them for the other darkroom pipe
+      _disk_cache_store(pipe, k);
+      _peer_cache_store(pipe, k);
+    }
   }
 }
 
@@ -431,7 +824,7 @@ static size_t _free_cacheline(dt_dev_pixelpipe_cache_t *cache, const int k)
 {
   const size_t removed = cache->size[k];
 
-  dt_free_align(cache->data[k]);
+  dt_bufpool_free(cache->data[k]);
   cache->allmem -= removed;
   cache->size[k] = 0;
   cache->data[k] = NULL;
@@ -467,7 +860,21 @@ void dt_dev_pixelpipe_cache_checkmem(dt_dev_pixelpipe_t *pipe)
       freed_invalid += _free_cacheline(cache, k);
   }
 
-  while(cache->memlimit && (cache->memlimit < cache->allmem))
+  // while the watchdog reports the system short on memory we don't wait
+  // for the limit but drop everything not marked as important
+  if(dt_memory_pressure())
+  {
+    for(int k = DT_PIPECACHE_MIN; k < cache->entries; k++)
+    {
+      if(cache->data[k] && (cache->used[k] >= 0))
+        freed += _free_cacheline(cache, k);
+    }
+  }
+
+  // the governor grants the pipe caches extra budget while the user
+  // works in darkroom
+  const size_t memlimit = dt_governor_pipe_memlimit(cache->memlimit);
+  while(memlimit && (memlimit < cache->allmem))
   {
     const int k = _get_oldest_cacheline(cache, DT_CACHETEST_USED);
     if(k == 0) break;
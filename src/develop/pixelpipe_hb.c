@@ -21,6 +21,8 @@
 #include "common/histogram.h"
 #include "common/opencl.h"
 #include "common/iop_order.h"
+#include "common/module_stats.h"
+#include "common/trace.h"
 #include "common/imagebuf.h"
 #include "control/control.h"
 #include "control/signal.h"
@@ -251,6 +253,8 @@ gboolean dt_dev_pixelpipe_init_cached(dt_dev_pixelpipe_t *pipe,
   pipe->output_imgid = NO_IMGID;
 
   memset(&pipe->scharr, 0, sizeof(dt_dev_detail_mask_t));
+  memset(&pipe->detail_blend, 0, sizeof(pipe->detail_blend));
+  pipe->detail_blend_next = 0;
   pipe->want_detail_mask = FALSE;
 
   pipe->processing = FALSE;
@@ -277,6 +281,15 @@ gboolean dt_dev_pixelpipe_init_cached(dt_dev_pixelpipe_t *pipe,
   pipe->runs = 0;
   pipe->bcache_data = NULL;
   pipe->bcache_hash = DT_INVALID_HASH;
+  pipe->clcache_mem = NULL;
+  pipe->clcache_hash = DT_INVALID_HASH;
+  pipe->clcache_devid = DT_DEVICE_NONE;
+  pipe->dirty_region_valid = FALSE;
+  pipe->scratch_arena = NULL;
+  pipe->scratch_arena_size = 0;
+  pipe->scratch_used = 0;
+  pipe->scratch_peak = 0;
+  dt_pthread_mutex_init(&pipe->scratch_mutex, NULL);
   return dt_dev_pixelpipe_cache_init(pipe, entries, size, memlimit);
 }
 
@@ -286,6 +299,75 @@ size_t dt_get_available_pipe_mem(const dt_dev_pixelpipe_t *pipe)
   return MAX(DT_MEGA, allmem / (pipe->type & DT_DEV_PIXELPIPE_THUMBNAIL ? 3 : 1));
 }
 
+void *dt_dev_pixelpipe_scratch_alloc(dt_dev_pixelpipe_t *pipe, const size_t size)
+{
+  // one cacheline of bookkeeping precedes every arena allocation so a
+  // free in LIFO order can roll the bump pointer back immediately;
+  // this keeps tiled processing, which cycles its scratch buffers once
+  // per tile, from growing the arena to tiles times the working set.
+  // the payload is rounded up to full cachelines so consecutive
+  // allocations never share a line and stay aligned for vectorized code
+  const size_t needed = DT_CACHELINE_BYTES
+    + ((size + DT_CACHELINE_BYTES - 1) & ~((size_t)DT_CACHELINE_BYTES - 1));
+  dt_pthread_mutex_lock(&pipe->scratch_mutex);
+  // track the high-water mark so the arena fits the whole run's
+  // working set from the next run on
+  pipe->scratch_peak = MAX(pipe->scratch_peak, pipe->scratch_used + needed);
+  if(pipe->scratch_arena
+     && pipe->scratch_used + needed <= pipe->scratch_arena_size)
+  {
+    size_t *header = (size_t *)(pipe->scratch_arena + pipe->scratch_used);
+    header[0] = pipe->scratch_used;          // start of this allocation
+    header[1] = pipe->scratch_used + needed; // end of this allocation
+    pipe->scratch_used += needed;
+    dt_pthread_mutex_unlock(&pipe->scratch_mutex);
+    return (char *)header + DT_CACHELINE_BYTES;
+  }
+  dt_pthread_mutex_unlock(&pipe->scratch_mutex);
+  // arena not grown yet or exhausted, fall back to a plain allocation
+  return dt_alloc_aligned(size);
+}
+
+void dt_dev_pixelpipe_scratch_free(dt_dev_pixelpipe_t *pipe, void *buf)
+{
+  if(!buf) return;
+  char *p = buf;
+  if(p >= pipe->scratch_arena
+     && p < pipe->scratch_arena + pipe->scratch_arena_size)
+  {
+    // roll the bump pointer back if this was the most recent
+    // allocation; anything freed out of order simply stays used until
+    // the end-of-run reset
+    const size_t *header = (const size_t *)(p - DT_CACHELINE_BYTES);
+    dt_pthread_mutex_lock(&pipe->scratch_mutex);
+    if(pipe->scratch_used == header[1])
+      pipe->scratch_used = header[0];
+    dt_pthread_mutex_unlock(&pipe->scratch_mutex);
+    return;
+  }
+  dt_free_align(buf);
+}
+
+// reset the scratch arena after a pipe run, growing it to the
+// high-water mark of the runs seen so far
+static void _scratch_reset(dt_dev_pixelpipe_t *pipe)
+{
+  dt_pthread_mutex_lock(&pipe->scratch_mutex);
+  pipe->scratch_used = 0;
+  if(pipe->scratch_peak > pipe->scratch_arena_size)
+  {
+    dt_free_align(pipe->scratch_arena);
+    pipe->scratch_arena = dt_alloc_aligned(pipe->scratch_peak);
+    pipe->scratch_arena_size = pipe->scratch_arena ? pipe->scratch_peak : 0;
+    // fault the pages in now so allocations during the next run are
+    // pure pointer bumps
+    if(pipe->scratch_arena)
+      dt_iop_image_prefault((float *)pipe->scratch_arena,
+                            pipe->scratch_arena_size / sizeof(float));
+  }
+  dt_pthread_mutex_unlock(&pipe->scratch_mutex);
+}
+
 static void get_output_format(dt_iop_module_t *module,
                               dt_dev_pixelpipe_t *pipe,
                               dt_dev_pixelpipe_iop_t *piece,
@@ -338,6 +420,11 @@ void dt_dev_pixelpipe_cleanup(dt_dev_pixelpipe_t *pipe)
   // so now it's safe to clean up cache:
   dt_dev_pixelpipe_cache_cleanup(pipe);
   dt_free_align(pipe->bcache_data);
+#ifdef HAVE_OPENCL
+  dt_opencl_release_mem_object(pipe->clcache_mem);
+  pipe->clcache_mem = NULL;
+  pipe->clcache_hash = DT_INVALID_HASH;
+#endif
 
   pipe->icc_type = DT_COLORSPACE_NONE;
   g_free(pipe->icc_filename);
@@ -358,6 +445,10 @@ void dt_dev_pixelpipe_cleanup(dt_dev_pixelpipe_t *pipe)
     g_list_free_full(pipe->forms, (void (*)(void *))dt_masks_free_form);
     pipe->forms = NULL;
   }
+  dt_free_align(pipe->scratch_arena);
+  pipe->scratch_arena = NULL;
+  pipe->scratch_arena_size = 0;
+  dt_pthread_mutex_destroy(&pipe->scratch_mutex);
   dt_pthread_mutex_destroy(&pipe->busy_mutex);
   dt_pthread_mutex_destroy(&pipe->mutex);
 }
@@ -382,6 +473,8 @@ void dt_dev_pixelpipe_cleanup_nodes(dt_dev_pixelpipe_t *pipe)
     piece->blendop_data = NULL;
     dt_free_align(piece->histogram);
     piece->histogram = NULL;
+    dt_free_align(piece->dmask_data);
+    piece->dmask_data = NULL;
     g_hash_table_destroy(piece->raster_masks);
     piece->raster_masks = NULL;
     free(piece);
@@ -1054,6 +1147,13 @@ static void _pixelpipe_pick_samples(dt_develop_t *dev,
     samples = &primary;
   }
 
+  // with several samples to serve it pays off to summarize the buffer
+  // once and read each box from the per-cell aggregates instead of
+  // rescanning its pixels per sample
+  dt_color_picker_cells_t *cells = NULL;
+  if(dsc->channels == 4u && samples && samples->next)
+    cells = dt_color_picker_cells_build(input, roi_in);
+
   while(samples)
   {
     int box[4];
@@ -1070,9 +1170,13 @@ static void _pixelpipe_pick_samples(dt_develop_t *dev,
                       : "",
                     box[0], box[1], box[2], box[3]);
 
-      dt_color_picker_helper(dsc, input, roi_in, box, sample->denoise,
-                             sample->display,
-                             IOP_CS_RGB, IOP_CS_RGB, display_profile);
+      // denoised samples blur the pixels first, they can't use the aggregates
+      if(cells && !sample->denoise)
+        dt_color_picker_cells_helper(cells, input, roi_in, box, sample->display);
+      else
+        dt_color_picker_helper(dsc, input, roi_in, box, sample->denoise,
+                               sample->display,
+                               IOP_CS_RGB, IOP_CS_RGB, display_profile);
 
       // NOTE: conversions assume that dt_aligned_pixel_t[x] has no
       // padding, e.g. is equivalent to float[x*4], and that on failure
@@ -1088,6 +1192,7 @@ static void _pixelpipe_pick_samples(dt_develop_t *dev,
     }
     samples = g_slist_next(samples);
   }
+  dt_color_picker_cells_free(cells);
 }
 
 // returns TRUE if blend process need the module default colorspace
@@ -1133,6 +1238,26 @@ static inline gboolean _piece_may_tile(const dt_dev_pixelpipe_iop_t *piece)
              && piece->module->flags() & IOP_FLAGS_WRITE_DETAILS);
 }
 
+// hash identifying the histogram a piece would collect from its
+// current input: the upstream pipe state plus the collection parameters
+static dt_hash_t _histogram_hash(dt_dev_pixelpipe_iop_t *piece,
+                                 const dt_iop_roi_t *roi_in)
+{
+  // as with the pixelpipe cache, buffer contents are not predictable
+  // from the history stack in these modes
+  if(piece->pipe->mask_display || piece->pipe->nocache)
+    return DT_INVALID_HASH;
+
+  dt_hash_t hash = dt_dev_pixelpipe_piece_hash(piece, roi_in, FALSE);
+  hash = dt_hash(hash, &piece->histogram_params.bins_count,
+                 sizeof(piece->histogram_params.bins_count));
+  hash = dt_hash(hash, &piece->module->histogram_cst,
+                 sizeof(piece->module->histogram_cst));
+  hash = dt_hash(hash, &piece->module->histogram_middle_grey,
+                 sizeof(piece->module->histogram_middle_grey));
+  return hash;
+}
+
 static void _collect_histogram_on_CPU(dt_dev_pixelpipe_t *pipe,
                                       dt_develop_t *dev,
                                       float *input,
@@ -1145,9 +1270,14 @@ static void _collect_histogram_on_CPU(dt_dev_pixelpipe_t *pipe,
   if((dev->gui_attached || !(piece->request_histogram & DT_REQUEST_ONLY_IN_GUI))
      && (piece->request_histogram & DT_REQUEST_ON))
   {
-    _histogram_collect(piece, input, roi_in, &piece->histogram, piece->histogram_max);
-    *pixelpipe_flow |= (PIXELPIPE_FLOW_HISTOGRAM_ON_CPU);
-    *pixelpipe_flow &= ~(PIXELPIPE_FLOW_HISTOGRAM_NONE | PIXELPIPE_FLOW_HISTOGRAM_ON_GPU);
+    const dt_hash_t hash = _histogram_hash(piece, roi_in);
+    if(!piece->histogram || hash == DT_INVALID_HASH || hash != piece->histogram_hash)
+    {
+      _histogram_collect(piece, input, roi_in, &piece->histogram, piece->histogram_max);
+      piece->histogram_hash = piece->histogram ? hash : DT_INVALID_HASH;
+      *pixelpipe_flow |= (PIXELPIPE_FLOW_HISTOGRAM_ON_CPU);
+      *pixelpipe_flow &= ~(PIXELPIPE_FLOW_HISTOGRAM_NONE | PIXELPIPE_FLOW_HISTOGRAM_ON_GPU);
+    }
 
     if(piece->histogram
        && (module->request_histogram & DT_REQUEST_ON)
@@ -1525,6 +1655,52 @@ static inline gboolean _opencl_pipe_isok(dt_dev_pixelpipe_t *pipe)
 }
 #endif
 
+/* Consecutive pointwise modules - pure per-pixel maps with an identity
+   roi - don't need an output buffer of their own on the simple
+   alternating-buffer pipes (export, thumbnail). Running them in place on
+   the input buffer fuses the chain: each module streams one buffer
+   instead of two so a run of such modules touches a single full-size
+   buffer overall. We must never do so
+    - on the base buffer pipe->input, that one has to survive the run,
+    - if blending is active, the blend step reads the unprocessed input,
+    - if the data format changes between input and output,
+    - if the OpenCL path might take over, it copies between distinct
+      host and device buffers,
+    - while dumping or benchmarking, both rely on distinct buffers.
+*/
+static gboolean _piece_fuse_pointwise(const dt_dev_pixelpipe_iop_t *piece,
+                                      const dt_iop_module_t *module,
+                                      const void *input,
+                                      const void *cl_mem_input,
+                                      const dt_iop_roi_t *roi_in,
+                                      const dt_iop_roi_t *roi_out,
+                                      const size_t in_bpp,
+                                      const size_t out_bpp)
+{
+  dt_dev_pixelpipe_t *pipe = piece->pipe;
+  if(!(module->flags() & IOP_FLAGS_POINTWISE))
+    return FALSE;
+  // the interactive pipes pick and visualize from distinct buffers even
+  // when running with only the two swap cachelines
+  if(pipe->cache.entries != DT_PIPECACHE_MIN
+     || (pipe->type & DT_DEV_PIXELPIPE_SCREEN))
+    return FALSE;
+  if(input == NULL || input == pipe->input || cl_mem_input != NULL)
+    return FALSE;
+  if(in_bpp != out_bpp
+     || memcmp(roi_in, roi_out, sizeof(dt_iop_roi_t)))
+    return FALSE;
+  if(_transform_for_blend(module, piece))
+    return FALSE;
+  if(darktable.dump_pfm_pipe || darktable.bench_module)
+    return FALSE;
+#ifdef HAVE_OPENCL
+  if(_opencl_pipe_isok(pipe))
+    return FALSE;
+#endif
+  return TRUE;
+}
+
 static inline gboolean _skip_piece_on_tags(const dt_dev_pixelpipe_iop_t *piece)
 {
   if(!piece->enabled || piece->module->iop_order == INT_MAX)
@@ -1803,15 +1979,31 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
   if(dt_pipe_shutdown(pipe))
     return TRUE;
 
-  const gboolean important = module
-      && (pipe->mask_display == DT_DEV_PIXELPIPE_DISPLAY_NONE)
-      && (((pipe->type & DT_DEV_PIXELPIPE_PREVIEW)
-           && dt_iop_module_is(module->so, "colorout"))
-       || ((pipe->type & DT_DEV_PIXELPIPE_FULL)
-           && dt_iop_module_is(module->so, "gamma")));
+  const gboolean fused = _piece_fuse_pointwise(piece, module, input, cl_mem_input,
+                                               &roi_in, roi_out, in_bpp, out_bpp);
+  if(fused)
+  {
+    // fuse with the preceding module: process in place on its output,
+    // the alternation of the two swap buffers stays intact as we don't
+    // advance the cache call counter here
+    *output = input;
+    dt_print_pipe(DT_DEBUG_PIPE | DT_DEBUG_VERBOSE,
+                  "fuse pointwise",
+                  pipe, module, DT_DEVICE_NONE, &roi_in, roi_out,
+                  "in place at %p", input);
+  }
+  else
+  {
+    const gboolean important = module
+        && (pipe->mask_display == DT_DEV_PIXELPIPE_DISPLAY_NONE)
+        && (((pipe->type & DT_DEV_PIXELPIPE_PREVIEW)
+             && dt_iop_module_is(module->so, "colorout"))
+         || ((pipe->type & DT_DEV_PIXELPIPE_FULL)
+             && dt_iop_module_is(module->so, "gamma")));
 
-  dt_dev_pixelpipe_cache_get(pipe, hash, bufsize,
-                             output, out_format, module, important);
+    dt_dev_pixelpipe_cache_get(pipe, hash, bufsize,
+                               output, out_format, module, important);
+  }
 
   if(dt_pipe_shutdown(pipe))
     return TRUE;
@@ -1820,6 +2012,8 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
 
   dt_times_t start;
   dt_get_perf_times(&start);
+  const double trace_start = dt_trace_begin();
+  const double stats_start = dt_get_wtime();
 
   dt_pixelpipe_flow_t pixelpipe_flow =
     (PIXELPIPE_FLOW_NONE | PIXELPIPE_FLOW_HISTOGRAM_NONE);
@@ -2008,8 +2202,29 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
 
           if(success_opencl)
           {
-            if(dt_opencl_write_host_to_device(pipe->devid, input, cl_mem_input,
-                                              roi_in.width, roi_in.height, in_bpp) != CL_SUCCESS)
+            // maybe the wanted input is still resident in VRAM from an
+            // earlier run, then a device-to-device copy replaces the
+            // PCIe upload
+            gboolean from_clcache = FALSE;
+            if(pipe->clcache_mem
+               && pipe->clcache_devid == pipe->devid
+               && pipe->clcache_hash == dt_dev_pixelpipe_cache_hash(&roi_in, pipe, pos - 1)
+               && pipe->clcache_width == roi_in.width
+               && pipe->clcache_height == roi_in.height
+               && pipe->clcache_bpp == in_bpp)
+            {
+              size_t origin[] = { 0, 0, 0 };
+              size_t region[] = { roi_in.width, roi_in.height, 1 };
+              from_clcache = dt_opencl_enqueue_copy_image(pipe->devid, pipe->clcache_mem,
+                                  cl_mem_input, origin, origin, region) == CL_SUCCESS;
+              if(from_clcache)
+                dt_print_pipe(DT_DEBUG_OPENCL | DT_DEBUG_VERBOSE,
+                              "input from VRAM cache",
+                              pipe, module, pipe->devid, &roi_in, NULL);
+            }
+            if(!from_clcache
+               && dt_opencl_write_host_to_device(pipe->devid, input, cl_mem_input,
+                                                 roi_in.width, roi_in.height, in_bpp) != CL_SUCCESS)
             {
               dt_print_pipe(DT_DEBUG_OPENCL,
                             "process",
@@ -2067,16 +2282,21 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
                || !(piece->request_histogram & DT_REQUEST_ONLY_IN_GUI))
            && (piece->request_histogram & DT_REQUEST_ON))
         {
-          // we abuse the empty output buffer on host for intermediate storage of data in
-          // histogram_collect_cl()
-          const size_t outbufsize = bpp * roi_out->width * roi_out->height;
-
-          _histogram_collect_cl(pipe->devid, piece, cl_mem_input,
-                                &roi_in, &piece->histogram,
-                                piece->histogram_max, *output, outbufsize);
-          pixelpipe_flow |= (PIXELPIPE_FLOW_HISTOGRAM_ON_GPU);
-          pixelpipe_flow &= ~(PIXELPIPE_FLOW_HISTOGRAM_NONE
-                              | PIXELPIPE_FLOW_HISTOGRAM_ON_CPU);
+          const dt_hash_t hhash = _histogram_hash(piece, &roi_in);
+          if(!piece->histogram || hhash == DT_INVALID_HASH || hhash != piece->histogram_hash)
+          {
+            // we abuse the empty output buffer on host for intermediate storage of data in
+            // histogram_collect_cl()
+            const size_t outbufsize = bpp * roi_out->width * roi_out->height;
+
+            _histogram_collect_cl(pipe->devid, piece, cl_mem_input,
+                                  &roi_in, &piece->histogram,
+                                  piece->histogram_max, *output, outbufsize);
+            piece->histogram_hash = piece->histogram ? hhash : DT_INVALID_HASH;
+            pixelpipe_flow |= (PIXELPIPE_FLOW_HISTOGRAM_ON_GPU);
+            pixelpipe_flow &= ~(PIXELPIPE_FLOW_HISTOGRAM_NONE
+                                | PIXELPIPE_FLOW_HISTOGRAM_ON_CPU);
+          }
 
           if(piece->histogram
              && (module->request_histogram & DT_REQUEST_ON)
@@ -2626,6 +2846,21 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
           }
         }
 
+        /* retain the focused module's input in VRAM instead of releasing
+           it, so the next slider tweak skips the upload entirely. only
+           one such buffer is kept per pipe. */
+        if(important_cl && cl_mem_input != NULL && module == dt_dev_gui_module())
+        {
+          dt_opencl_release_mem_object(pipe->clcache_mem);
+          pipe->clcache_mem = cl_mem_input;
+          pipe->clcache_hash = dt_dev_pixelpipe_cache_hash(&roi_in, pipe, pos - 1);
+          pipe->clcache_devid = pipe->devid;
+          pipe->clcache_width = roi_in.width;
+          pipe->clcache_height = roi_in.height;
+          pipe->clcache_bpp = in_bpp;
+          cl_mem_input = NULL;
+        }
+
         /* we can now release cl_mem_input */
         dt_opencl_release_mem_object(cl_mem_input);
         cl_mem_input = NULL;
@@ -2747,6 +2982,13 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
                   : pixelpipe_flow & PIXELPIPE_FLOW_HISTOGRAM_ON_CPU ? "CPU" : ""));
   }
 
+  if(darktable.unmuted & DT_DEBUG_PERF)
+  {
+    dt_times_t end;
+    dt_get_times(&end);
+    piece->process_wall += end.clock - start.clock;
+  }
+
   dt_show_times_f
     (&start,
      "[dev_pixelpipe]", "[%s] processed `%s%s' on %s%s%s, blended on %s",
@@ -2763,6 +3005,18 @@ static gboolean _dev_pixelpipe_process_rec(dt_dev_pixelpipe_t *pipe,
           ? "GPU"
           : pixelpipe_flow & PIXELPIPE_FLOW_BLENDED_ON_CPU ? "CPU" : "");
 
+  dt_module_stats_record(module->op, dt_get_wtime() - stats_start,
+                         (pixelpipe_flow & PIXELPIPE_FLOW_PROCESSED_ON_GPU) != 0,
+                         (pixelpipe_flow & PIXELPIPE_FLOW_PROCESSED_WITH_TILING) != 0);
+
+  dt_trace_end("pipe", trace_start, "[%s] %s%s on %s%s",
+               dt_dev_pixelpipe_type_to_str(pipe->type),
+               module->op, dt_iop_get_instance_id(module),
+               pixelpipe_flow & PIXELPIPE_FLOW_PROCESSED_ON_GPU
+                    ? "GPU"
+                    : pixelpipe_flow & PIXELPIPE_FLOW_PROCESSED_ON_CPU ? "CPU" : "",
+               pixelpipe_flow & PIXELPIPE_FLOW_PROCESSED_WITH_TILING ? " with tiling" : "");
+
   // in case we get this buffer from the cache in the future, cache some stuff:
   **out_format = piece->dsc_out = pipe->dsc;
 
@@ -3009,6 +3263,59 @@ static gboolean _dev_pixelpipe_process_rec_and_backcopy(dt_dev_pixelpipe_t *pipe
   return ret;
 }
 
+void dt_dev_pixelpipe_set_dirty_region(dt_dev_pixelpipe_t *pipe,
+                                       const float box[4])
+{
+  if(!pipe) return;
+  if(pipe->dirty_region_valid)
+  {
+    pipe->dirty_region[0] = MIN(pipe->dirty_region[0], box[0]);
+    pipe->dirty_region[1] = MIN(pipe->dirty_region[1], box[1]);
+    pipe->dirty_region[2] = MAX(pipe->dirty_region[2], box[2]);
+    pipe->dirty_region[3] = MAX(pipe->dirty_region[3], box[3]);
+  }
+  else
+  {
+    for(int k = 0; k < 4; k++) pipe->dirty_region[k] = box[k];
+    pipe->dirty_region_valid = TRUE;
+  }
+}
+
+/* shrink the window roi to the dirty region, expanded by the overlap all
+   enabled modules request for this region so every module sees the pixels
+   it samples. returns the unchanged window roi if the result would not be
+   smaller. */
+static dt_iop_roi_t _dirty_region_roi(dt_dev_pixelpipe_t *pipe,
+                                      const dt_iop_roi_t *full)
+{
+  int pad = 16;
+  for(GList *nodes = pipe->nodes; nodes; nodes = g_list_next(nodes))
+  {
+    dt_dev_pixelpipe_iop_t *piece = nodes->data;
+    if(!piece->enabled) continue;
+    dt_develop_tiling_t tiling = { 0 };
+    piece->module->tiling_callback(piece->module, piece, full, full, &tiling);
+    pad += tiling.overlap;
+  }
+
+  const float fw = pipe->processed_width * full->scale;
+  const float fh = pipe->processed_height * full->scale;
+  const int x1 = MAX(full->x, (int)floorf(pipe->dirty_region[0] * fw) - pad);
+  const int y1 = MAX(full->y, (int)floorf(pipe->dirty_region[1] * fh) - pad);
+  const int x2 = MIN(full->x + full->width, (int)ceilf(pipe->dirty_region[2] * fw) + pad);
+  const int y2 = MIN(full->y + full->height, (int)ceilf(pipe->dirty_region[3] * fh) + pad);
+
+  dt_iop_roi_t roi = *full;
+  if(x2 > x1 && y2 > y1 && (size_t)(x2 - x1) * (y2 - y1) < (size_t)full->width * full->height)
+  {
+    roi.x = x1;
+    roi.y = y1;
+    roi.width = x2 - x1;
+    roi.height = y2 - y1;
+  }
+  return roi;
+}
+
 gboolean dt_dev_pixelpipe_process(dt_dev_pixelpipe_t *pipe,
                                   dt_develop_t *dev,
                                   const int x,
@@ -3038,6 +3345,33 @@ gboolean dt_dev_pixelpipe_process(dt_dev_pixelpipe_t *pipe,
   pipe->final_width = width;
   pipe->final_height = height;
 
+  /* localized edits: if a dirty-region hint is pending and the window is
+     unchanged since the last run we reprocess only that region and later
+     composite it into the retained backbuffer */
+  const dt_iop_roi_t full_roi = roi;
+  gboolean incremental = FALSE;
+  if(pipe->dirty_region_valid)
+  {
+    if(dt_conf_get_bool("darkroom/ui/incremental_roi")
+       && (pipe->type & DT_DEV_PIXELPIPE_FULL)
+       && (pipe->type & DT_DEV_PIXELPIPE_SCREEN)
+       && pipe->backbuf
+       && pipe->backbuf_width == width
+       && pipe->backbuf_height == height
+       && pipe->backbuf_x == x
+       && pipe->backbuf_y == y
+       && pipe->backbuf_scale == scale
+       && pipe->output_imgid == pipe->image.id)
+    {
+      roi = _dirty_region_roi(pipe, &full_roi);
+      incremental = roi.width != full_roi.width || roi.height != full_roi.height;
+      if(incremental)
+        dt_print_pipe(DT_DEBUG_PIPE, "incremental region",
+                      pipe, NULL, DT_DEVICE_NONE, &full_roi, &roi);
+    }
+    pipe->dirty_region_valid = FALSE;
+  }
+
   float zx = (x + 0.5f * width) / scale, zy = (y + 0.5f * height) / scale;
   dt_dev_zoom_pos_t pts = { zx, zy, zx + 1000.f, zy, zx, zy + 1000.f };
   dt_dev_distort_backtransform_plus(dev, pipe, 0.0f, DT_DEV_TRANSFORM_DIR_ALL_GEOMETRY, pts, 3);
@@ -3091,10 +3425,16 @@ restart:
   dt_print_mem_usage("before pixelpipe process");
 
   // run pixelpipe recursively and get error status
+  dt_alloc_tag_push("pipe");
   const gboolean err = _dev_pixelpipe_process_rec_and_backcopy(pipe, dev, &buf,
                                                                &cl_mem_out, &out_format,
                                                                &roi,
                                                                modules, pieces, pos);
+  dt_alloc_tag_pop();
+  // all transient scratch buffers are dead now, reclaim the arena in
+  // one go (this also covers the opencl-error restart below)
+  _scratch_reset(pipe);
+
   // get status summary of opencl queue by checking the eventlist
   const gboolean oclerr = (pipe->devid > DT_DEVICE_CPU)
                           ? (dt_opencl_events_flush(pipe->devid, TRUE) != CL_SUCCESS)
@@ -3171,30 +3511,46 @@ restart:
 
   // terminate
   dt_pthread_mutex_lock(&pipe->backbuf_mutex);
-  pipe->backbuf_hash = dt_dev_pixelpipe_cache_hash(&roi, pipe, pos);
+  pipe->backbuf_hash = dt_dev_pixelpipe_cache_hash(&full_roi, pipe, pos);
 
   //FIXME lock/release cache line instead of copying
   if(pipe->type & DT_DEV_PIXELPIPE_SCREEN)
   {
-    if(pipe->backbuf == NULL
-       || pipe->backbuf_width * pipe->backbuf_height != width * height)
+    if(incremental && pipe->backbuf)
     {
-      g_free(pipe->backbuf);
-      pipe->backbuf = g_malloc0(sizeof(uint8_t) * 4 * width * height);
+      // composite the reprocessed sub-region into the retained backbuffer
+      const size_t ox = roi.x - full_roi.x;
+      const size_t oy = roi.y - full_roi.y;
+      for(size_t j = 0; j < (size_t)roi.height; j++)
+        memcpy(pipe->backbuf + 4 * ((oy + j) * (size_t)width + ox),
+               (uint8_t *)buf + 4 * j * (size_t)roi.width,
+               sizeof(uint8_t) * 4 * roi.width);
+      pipe->output_imgid = pipe->image.id;
     }
-
-    if(pipe->backbuf)
+    else
     {
-      memcpy(pipe->backbuf, buf, sizeof(uint8_t) * 4 * width * height);
-      pipe->backbuf_scale = scale;
-      for(int i = 0; i < 6; i++) pipe->backbuf_zoom_pos[i] = pts[i] * pipe->iscale;
-      pipe->output_imgid = pipe->image.id;
+      if(pipe->backbuf == NULL
+         || pipe->backbuf_width * pipe->backbuf_height != width * height)
+      {
+        g_free(pipe->backbuf);
+        pipe->backbuf = g_malloc0(sizeof(uint8_t) * 4 * width * height);
+      }
+
+      if(pipe->backbuf)
+      {
+        memcpy(pipe->backbuf, buf, sizeof(uint8_t) * 4 * width * height);
+        pipe->backbuf_scale = scale;
+        for(int i = 0; i < 6; i++) pipe->backbuf_zoom_pos[i] = pts[i] * pipe->iscale;
+        pipe->output_imgid = pipe->image.id;
+      }
     }
   }
   else
     pipe->backbuf = buf;
   pipe->backbuf_width = width;
   pipe->backbuf_height = height;
+  pipe->backbuf_x = x;
+  pipe->backbuf_y = y;
   dt_pthread_mutex_unlock(&pipe->backbuf_mutex);
 
   if(!claimed)
@@ -3457,6 +3813,12 @@ void dt_dev_clear_scharr_mask(dt_dev_pixelpipe_t *pipe)
 {
   if(pipe->scharr.data) dt_free_align(pipe->scharr.data);
   memset(&pipe->scharr, 0, sizeof(dt_dev_detail_mask_t));
+  for(int k = 0; k < DT_DEV_DETAIL_BLEND_CACHE; k++)
+  {
+    if(pipe->detail_blend[k].data) dt_free_align(pipe->detail_blend[k].data);
+  }
+  memset(&pipe->detail_blend, 0, sizeof(pipe->detail_blend));
+  pipe->detail_blend_next = 0;
 }
 
 gboolean dt_dev_write_scharr_mask(dt_dev_pixelpipe_iop_t *piece,
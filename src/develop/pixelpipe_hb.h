@@ -44,6 +44,8 @@ typedef struct dt_dev_pixelpipe_iop_t
   uint32_t *histogram; // pointer to histogram data; histogram_bins_count bins with 4 channels each
   dt_dev_histogram_stats_t histogram_stats; // stats of captured histogram
   uint32_t histogram_max[4];                // maximum levels in histogram, one per channel
+  dt_hash_t histogram_hash; // input & params the histogram was collected for, so an
+                            // unchanged buffer is not binned again on the next run
 
   float iscale;                   // input actually just downscaled buffer? iscale*iwidth = actual width
   int iwidth, iheight;            // width and height of input buffer
@@ -61,7 +63,18 @@ typedef struct dt_dev_pixelpipe_iop_t
   dt_iop_buffer_dsc_t dsc_in;
   dt_iop_buffer_dsc_t dsc_out;
 
+  // accumulated wall clock seconds spent processing this piece, only
+  // maintained while DT_DEBUG_PERF is active (see darktable-benchmark)
+  double process_wall;
+
   GHashTable *raster_masks;
+
+  // single-entry cache of the last drawn-mask rasterization for this
+  // piece, keyed by mask content, roi and a probe through the
+  // distortion chain; see dt_masks_group_render_roi()
+  float *dmask_data;
+  size_t dmask_npixels;
+  dt_hash_t dmask_hash;
 } dt_dev_pixelpipe_iop_t;
 
 typedef enum dt_dev_pixelpipe_change_t
@@ -97,6 +110,16 @@ typedef struct dt_dev_detail_mask_t
   float *data;
 } dt_dev_detail_mask_t;
 
+// number of cached per-threshold detail blend masks kept per pipe
+#define DT_DEV_DETAIL_BLEND_CACHE 4
+
+typedef struct dt_dev_detail_blend_t
+{
+  float threshold;
+  gboolean detail;
+  float *data;
+} dt_dev_detail_blend_t;
+
 /**
  * this encapsulates the pixelpipe.
  * a develop module will need several of these:
@@ -142,6 +165,7 @@ typedef struct dt_dev_pixelpipe_t
   uint8_t *backbuf;
   size_t backbuf_size;
   int backbuf_width, backbuf_height;
+  int backbuf_x, backbuf_y;
   float backbuf_scale;
   dt_dev_zoom_pos_t backbuf_zoom_pos;
   dt_hash_t backbuf_hash;
@@ -152,6 +176,11 @@ typedef struct dt_dev_pixelpipe_t
   // as we have to scale the mask later we keep size at that stage
   gboolean want_detail_mask;
   struct dt_dev_detail_mask_t scharr;
+  // blended & blurred detail masks derived from scharr data, cached per
+  // (threshold, detail) so several consuming blend stages share the work.
+  // invalidated together with the scharr mask
+  struct dt_dev_detail_blend_t detail_blend[DT_DEV_DETAIL_BLEND_CACHE];
+  int detail_blend_next;
 
   // avoid cached data for processed module
   gboolean nocache;
@@ -203,6 +232,25 @@ typedef struct dt_dev_pixelpipe_t
   // module blending cache
   float *bcache_data;
   dt_hash_t bcache_hash;
+  // device-resident copy of one upstream intermediate (the input of the
+  // focused module), so a slider tweak on a late module reuses it from
+  // VRAM instead of re-uploading over PCIe
+  void *clcache_mem;
+  dt_hash_t clcache_hash;
+  int clcache_devid;
+  int clcache_width, clcache_height;
+  size_t clcache_bpp;
+  // dirty-region hint for incremental recompute of localized edits,
+  // normalized to the processed output dimensions [x1,y1,x2,y2]
+  float dirty_region[4];
+  gboolean dirty_region_valid;
+  // per-run bump allocator for transient scratch buffers, reset after
+  // every run; see dt_dev_pixelpipe_scratch_alloc()
+  char *scratch_arena;
+  size_t scratch_arena_size;
+  size_t scratch_used;
+  size_t scratch_peak;
+  dt_pthread_mutex_t scratch_mutex;
 } dt_dev_pixelpipe_t;
 
 struct dt_develop_t;
@@ -245,6 +293,27 @@ gboolean dt_dev_pixelpipe_init_cached(dt_dev_pixelpipe_t *pipe,
                                       const size_t memlimit);
 // returns available memory for the pipe
 size_t dt_get_available_pipe_mem(const dt_dev_pixelpipe_t *pipe);
+
+// Allocate transient scratch memory which is valid until the end of
+// the current pipe run.  Once the arena has grown to the pipe's
+// working set (after the first run) this is a pointer bump into
+// already faulted pages instead of a mmap/fault/unmap cycle per
+// buffer.  The returned pointer is cacheline aligned.  Buffers must be
+// released with dt_dev_pixelpipe_scratch_free() and may not be kept
+// across pipe runs.
+void *dt_dev_pixelpipe_scratch_alloc(dt_dev_pixelpipe_t *pipe, const size_t size);
+
+static inline float *dt_dev_pixelpipe_scratch_float(dt_dev_pixelpipe_t *pipe,
+                                                    const size_t nfloats)
+{
+  return (float *)dt_dev_pixelpipe_scratch_alloc(pipe, nfloats * sizeof(float));
+}
+
+// Release a scratch buffer.  Arena-backed buffers freed in LIFO order
+// give their space back right away, anything else is reclaimed when
+// the run ends; buffers handed out while the arena was exhausted are
+// freed individually.
+void dt_dev_pixelpipe_scratch_free(dt_dev_pixelpipe_t *pipe, void *buf);
 // constructs a new input buffer from given RGB float array.
 void dt_dev_pixelpipe_set_input(dt_dev_pixelpipe_t *pipe,
                                 struct dt_develop_t *dev,
@@ -286,6 +355,11 @@ void dt_dev_pixelpipe_rebuild(struct dt_develop_t *dev);
 
 // switch on details mask processing
 void dt_dev_pixelpipe_usedetails(dt_dev_pixelpipe_iop_t *piece);
+/* hint the next run that only the given region changed; box is normalized to
+   the processed output dimensions and gets unioned with a pending hint.
+   the pipe may then reprocess only that region (expanded by the overlap the
+   modules request) and composite it into the retained backbuffer. */
+void dt_dev_pixelpipe_set_dirty_region(dt_dev_pixelpipe_t *pipe, const float box[4]);
 // process region of interest of pixels. returns TRUE if pipe was altered during processing.
 gboolean dt_dev_pixelpipe_process(dt_dev_pixelpipe_t *pipe,
                              struct dt_develop_t *dev,
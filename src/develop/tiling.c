@@ -23,6 +23,7 @@
 #include "develop/pixelpipe.h"
 
 #include <assert.h>
+#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -86,6 +87,74 @@ static inline int _maximum_number_tiles()
   return (darktable.dtresources.level == 3) ? 0x40000000 : 10000;
 }
 
+/* given a memory budget of max_pixels per tile, choose tile dimensions that
+   cover a full_width x full_height image with minimal total processed area,
+   i.e. with the least halo recomputed in the overlap regions. the old
+   proportional shrink could leave grids whose overlap borders dominate the
+   processed area; instead we walk the possible column counts, derive the
+   cheapest matching row count for each and keep the best grid. tile
+   dimensions are capped by limit_width/limit_height (e.g. maximum device
+   image sizes) and aligned to walign/halign; every tile loses
+   2*overlap + inacc pixels of stride to the halo. */
+static void _fit_tiles_to_budget(const int full_width, const int full_height,
+                                 const int limit_width, const int limit_height,
+                                 const float max_pixels,
+                                 const int overlap, const int inacc,
+                                 const unsigned int walign, const unsigned int halign,
+                                 int *width, int *height)
+{
+  const int waste = 2 * overlap + inacc;
+  float best_cost = FLT_MAX;
+
+  for(int tiles_x = 1; tiles_x <= full_width; tiles_x++)
+  {
+    int tile_w = tiles_x == 1
+        ? full_width
+        : _align_up((full_width + tiles_x - 1) / tiles_x + waste, walign);
+    tile_w = MIN(tile_w, limit_width);
+
+    const int stride_w = tile_w - waste;
+    if(stride_w < 1) break;
+
+    /* the width may have been capped, recount the columns actually needed */
+    const int cols = tile_w < full_width ? (full_width + stride_w - 1) / stride_w : 1;
+
+    /* the tallest tile the budget allows at this width */
+    int tile_h = MIN((int)(max_pixels / tile_w), limit_height);
+    int rows = 1;
+    if(tile_h < full_height)
+    {
+      tile_h = _align_down(tile_h, halign);
+      const int stride_h = tile_h - waste;
+      if(stride_h < 1) continue;
+      rows = (full_height + stride_h - 1) / stride_h;
+      /* balance the rows so the last one is no sliver; this can only
+         shrink the tile, the budget still holds */
+      tile_h = MIN(tile_h, _align_up((full_height + rows - 1) / rows + waste, halign));
+    }
+    else
+      tile_h = full_height;
+
+    if((float)cols * rows > _maximum_number_tiles()) continue;
+
+    const float cost = (float)cols * rows * tile_w * tile_h;
+    if(cost < best_cost)
+    {
+      best_cost = cost;
+      *width = tile_w;
+      *height = tile_h;
+    }
+  }
+
+  if(best_cost == FLT_MAX)
+  {
+    /* degenerate budget, fall back to a proportional shrink */
+    const float scale = max_pixels / ((float)*width * *height);
+    *width = MAX(_align_down((int)floorf(*width * sqrtf(scale)), walign), 1);
+    *height = MAX(_align_down((int)floorf(*height * sqrtf(scale)), halign), 1);
+  }
+}
+
 static inline void _print_roi(const dt_iop_roi_t *roi, const char *label)
 {
   dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,"     {%5d %5d ->%5d %5d (%5dx%5d)  %.6f } %s",
@@ -627,25 +696,28 @@ static void _default_process_tiling_ptp(dt_iop_module_t *self,
   int width = roi_in->width;
   int height = roi_in->height;
 
-  /* shrink tile size in case it would exceed singlebuffer size */
+  /* Alignment rules: we need to make sure that alignment requirements of module are fulfilled.
+     Modules will report alignment requirements via xalign and yalign within tiling_callback().
+     Typical use case is demosaic where Bayer pattern requires alignment to a multiple of 2 in x and y
+     direction.
+     We guarantee alignment by selecting image width/height and overlap accordingly. For a tile width/height
+     that is identical to image width/height no special alignment is needed. */
+
+  const unsigned int xyalign = _lcm(tiling.xalign, tiling.yalign);
+
+  assert(xyalign != 0);
+
+  /* make sure that overlap follows alignment rules by making it wider when needed */
+  const int overlap = tiling.overlap % xyalign != 0 ? (tiling.overlap / xyalign + 1) * xyalign
+                                                    : tiling.overlap;
+
+  /* shrink tile size in case it would exceed singlebuffer size, choosing
+     the grid with the least recomputed overlap halo */
   if((float)width * height * max_bpp * maxbuf > singlebuffer)
   {
-    const float scale = singlebuffer / ((float)width * height * max_bpp * maxbuf);
-
-    /* TODO: can we make this more efficient to minimize total overlap between tiles? */
-    if(width < height && scale >= 0.333f)
-    {
-      height = floorf(height * scale);
-    }
-    else if(height <= width && scale >= 0.333f)
-    {
-      width = floorf(width * scale);
-    }
-    else
-    {
-      width = floorf(width * sqrtf(scale));
-      height = floorf(height * sqrtf(scale));
-    }
+    _fit_tiles_to_budget(roi_in->width, roi_in->height, roi_in->width, roi_in->height,
+                         singlebuffer / (max_bpp * maxbuf), overlap, 0, xyalign, xyalign,
+                         &width, &height);
     dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
              "[default_process_tiling_ptp] buffer exceeds singlebuffer, corrected to %dx%d",
              width, height);
@@ -660,25 +732,10 @@ static void _default_process_tiling_ptp(dt_iop_module_t *self,
              width, height);
   }
 
-  /* Alignment rules: we need to make sure that alignment requirements of module are fulfilled.
-     Modules will report alignment requirements via xalign and yalign within tiling_callback().
-     Typical use case is demosaic where Bayer pattern requires alignment to a multiple of 2 in x and y
-     direction.
-     We guarantee alignment by selecting image width/height and overlap accordingly. For a tile width/height
-     that is identical to image width/height no special alignment is needed. */
-
-  const unsigned int xyalign = _lcm(tiling.xalign, tiling.yalign);
-
-  assert(xyalign != 0);
-
   /* properly align tile width and height by making them smaller if needed */
   if(width < roi_in->width) width = (width / xyalign) * xyalign;
   if(height < roi_in->height) height = (height / xyalign) * xyalign;
 
-  /* also make sure that overlap follows alignment rules by making it wider when needed */
-  const int overlap = tiling.overlap % xyalign != 0 ? (tiling.overlap / xyalign + 1) * xyalign
-                                                    : tiling.overlap;
-
   /* calculate effective tile size */
   const int tile_wd = width - 2 * overlap > 0 ? width - 2 * overlap : 1;
   const int tile_ht = height - 2 * overlap > 0 ? height - 2 * overlap : 1;
@@ -701,8 +758,26 @@ static void _default_process_tiling_ptp(dt_iop_module_t *self,
            "[default_process_tiling_ptp] [%s] (%dx%d) tiles with max dimensions %dx%d and overlap %d",
            dt_dev_pixelpipe_type_to_str(piece->pipe->type), tiles_x, tiles_y, width, height, overlap);
 
-  /* reserve input and output buffers for tiles */
-  input = dt_alloc_aligned((size_t)width * height * in_bpp);
+  /* dispatch independent tiles to multiple threads if the module opted in
+     and the additional per-thread tile buffers fit into the memory budget.
+     each worker gets its own slot in the input/output buffers below. */
+  int nthreads = 1;
+  if(tiling.parallel)
+  {
+    nthreads = MIN(dt_get_num_threads(), tiles_x * tiles_y);
+    while(nthreads > 1
+          && (float)nthreads * width * height * max_bpp * factor > available)
+      nthreads--;
+    dt_print(DT_DEBUG_TILING,
+             "[default_process_tiling_ptp] [%s] process tiles of module '%s%s' with %d threads",
+             dt_dev_pixelpipe_type_to_str(piece->pipe->type),
+             self->op, dt_iop_get_instance_id(self), nthreads);
+  }
+  const size_t istride = dt_round_size((size_t)width * height * in_bpp, DT_CACHELINE_BYTES);
+  const size_t ostride = dt_round_size((size_t)width * height * out_bpp, DT_CACHELINE_BYTES);
+
+  /* reserve input and output buffers for tiles, one slot per worker thread */
+  input = dt_alloc_aligned(nthreads * istride);
   if(input == NULL)
   {
     dt_print(DT_DEBUG_TILING,
@@ -710,7 +785,7 @@ static void _default_process_tiling_ptp(dt_iop_module_t *self,
              dt_dev_pixelpipe_type_to_str(piece->pipe->type), self->op, dt_iop_get_instance_id(self));
     goto error;
   }
-  output = dt_alloc_aligned((size_t)width * height * out_bpp);
+  output = dt_alloc_aligned(nthreads * ostride);
   if(output == NULL)
   {
     dt_print(DT_DEBUG_TILING,
@@ -729,49 +804,58 @@ static void _default_process_tiling_ptp(dt_iop_module_t *self,
                         "%dx%d tiles, size=%dx%d",
                         tiles_x, tiles_y, tile_wd, tile_ht);
 
-  /* iterate over tiles */
-  for(size_t tx = 0; tx < tiles_x; tx++)
+  piece->pipe->tiling = TRUE;
+
+  /* iterate over tiles; with nthreads > 1 independent tiles are dispatched
+     concurrently, each worker using its own slot of the tile buffers */
+  DT_OMP_PRAGMA(parallel for schedule(dynamic) num_threads(nthreads) if(nthreads > 1))
+  for(size_t tile = 0; tile < (size_t)tiles_x * tiles_y; tile++)
   {
+    const size_t tx = tile % tiles_x;
+    const size_t ty = tile / tiles_x;
     const size_t wd = tx * tile_wd + width > roi_in->width ? roi_in->width - tx * tile_wd : width;
-    for(size_t ty = 0; ty < tiles_y; ty++)
-    {
-      piece->pipe->tiling = TRUE;
+    const size_t ht = ty * tile_ht + height > roi_in->height ? roi_in->height - ty * tile_ht : height;
 
-      const size_t ht = ty * tile_ht + height > roi_in->height ? roi_in->height - ty * tile_ht : height;
+    /* no need to process end-tiles that are smaller than the total overlap area */
+    if((wd <= 2 * overlap && tx > 0) || (ht <= 2 * overlap && ty > 0)) continue;
 
-      /* no need to process end-tiles that are smaller than the total overlap area */
-      if((wd <= 2 * overlap && tx > 0) || (ht <= 2 * overlap && ty > 0)) continue;
+    void *tile_input = (char *)input + (nthreads > 1 ? dt_get_thread_num() * istride : 0);
+    void *tile_output = (char *)output + (nthreads > 1 ? dt_get_thread_num() * ostride : 0);
 
-      /* origin and region of effective part of tile, which we want to store later */
-      size_t origin[] = { 0, 0, 0 };
-      size_t region[] = { wd, ht, 1 };
+    /* origin and region of effective part of tile, which we want to store later */
+    size_t origin[] = { 0, 0, 0 };
+    size_t region[] = { wd, ht, 1 };
 
-      /* roi_in and roi_out for process_cl on subbuffer */
-      dt_iop_roi_t iroi = { roi_in->x + tx * tile_wd, roi_in->y + ty * tile_ht, wd, ht, roi_in->scale };
-      dt_iop_roi_t oroi = { roi_out->x + tx * tile_wd, roi_out->y + ty * tile_ht, wd, ht, roi_out->scale };
+    /* roi_in and roi_out for process_cl on subbuffer */
+    dt_iop_roi_t iroi = { roi_in->x + tx * tile_wd, roi_in->y + ty * tile_ht, wd, ht, roi_in->scale };
+    dt_iop_roi_t oroi = { roi_out->x + tx * tile_wd, roi_out->y + ty * tile_ht, wd, ht, roi_out->scale };
 
-      /* offsets of tile into ivoid and ovoid */
-      const size_t ioffs = (ty * tile_ht) * ipitch + (tx * tile_wd) * in_bpp;
-      size_t ooffs = (ty * tile_ht) * opitch + (tx * tile_wd) * out_bpp;
+    /* offsets of tile into ivoid and ovoid */
+    const size_t ioffs = (ty * tile_ht) * ipitch + (tx * tile_wd) * in_bpp;
+    size_t ooffs = (ty * tile_ht) * opitch + (tx * tile_wd) * out_bpp;
 
-      dt_print(DT_DEBUG_TILING,
-               "[default_process_tiling_ptp] [%s] tile (%zu,%zu) with %zux%zu at origin [%zu,%zu]",
-               dt_dev_pixelpipe_type_to_str(piece->pipe->type), tx, ty, wd, ht, tx * tile_wd, ty * tile_ht);
+    dt_print(DT_DEBUG_TILING,
+             "[default_process_tiling_ptp] [%s] tile (%zu,%zu) with %zux%zu at origin [%zu,%zu]",
+             dt_dev_pixelpipe_type_to_str(piece->pipe->type), tx, ty, wd, ht, tx * tile_wd, ty * tile_ht);
 
 /* prepare input tile buffer */
-      DT_OMP_FOR()
-      for(size_t j = 0; j < ht; j++)
-        memcpy((char *)input + j * wd * in_bpp, (char *)ivoid + ioffs + j * ipitch, (size_t)wd * in_bpp);
+    DT_OMP_FOR(if(nthreads == 1))
+    for(size_t j = 0; j < ht; j++)
+      memcpy((char *)tile_input + j * wd * in_bpp, (char *)ivoid + ioffs + j * ipitch, (size_t)wd * in_bpp);
 
-      /* take original processed_maximum as starting point */
+    /* take original processed_maximum as starting point; modules opting in
+       to parallel tiles promised not to touch it at all */
+    if(nthreads == 1)
       for(int k = 0; k < 4; k++) piece->pipe->dsc.processed_maximum[k] = processed_maximum_saved[k];
 
-      /* call process() of module */
-      self->process(self, piece, input, output, &iroi, &oroi);
+    /* call process() of module */
+    self->process(self, piece, tile_input, tile_output, &iroi, &oroi);
 
-      /* aggregate resulting processed_maximum */
-      /* TODO: check if there really can be differences between tiles and take
-               appropriate action (calculate minimum, maximum, average, ...?) */
+    /* aggregate resulting processed_maximum */
+    /* TODO: check if there really can be differences between tiles and take
+             appropriate action (calculate minimum, maximum, average, ...?) */
+    if(nthreads == 1)
+    {
       for(int k = 0; k < 4; k++)
       {
         if(tx + ty > 0 && fabs(processed_maximum_new[k] - piece->pipe->dsc.processed_maximum[k]) > 1.0e-6f)
@@ -781,32 +865,34 @@ static void _default_process_tiling_ptp(dt_iop_module_t *self,
                    self->op, dt_iop_get_instance_id(self));
         processed_maximum_new[k] = piece->pipe->dsc.processed_maximum[k];
       }
+    }
 
-      /* correct origin and region of tile for overlap.
-         make sure that we only copy back the "good" part. */
-      if(tx > 0)
-      {
-        origin[0] += overlap;
-        region[0] -= overlap;
-        ooffs += (size_t)overlap * out_bpp;
-      }
-      if(ty > 0)
-      {
-        origin[1] += overlap;
-        region[1] -= overlap;
-        ooffs += (size_t)overlap * opitch;
-      }
-
-/* copy "good" part of tile to output buffer */
-      DT_OMP_FOR(shared(origin, region))
-      for(size_t j = 0; j < region[1]; j++)
-        memcpy((char *)ovoid + ooffs + j * opitch,
-               (char *)output + ((j + origin[1]) * wd + origin[0]) * out_bpp, (size_t)region[0] * out_bpp);
+    /* correct origin and region of tile for overlap.
+       make sure that we only copy back the "good" part. */
+    if(tx > 0)
+    {
+      origin[0] += overlap;
+      region[0] -= overlap;
+      ooffs += (size_t)overlap * out_bpp;
     }
+    if(ty > 0)
+    {
+      origin[1] += overlap;
+      region[1] -= overlap;
+      ooffs += (size_t)overlap * opitch;
+    }
+
+/* copy "good" part of tile to output buffer; tiles never overlap here */
+    DT_OMP_FOR(shared(origin, region) if(nthreads == 1))
+    for(size_t j = 0; j < region[1]; j++)
+      memcpy((char *)ovoid + ooffs + j * opitch,
+             (char *)tile_output + ((j + origin[1]) * wd + origin[0]) * out_bpp, (size_t)region[0] * out_bpp);
   }
 
-  /* copy back final processed_maximum */
-  for(int k = 0; k < 4; k++) piece->pipe->dsc.processed_maximum[k] = processed_maximum_new[k];
+  /* copy back final processed_maximum; parallel tiles leave it untouched */
+  for(int k = 0; k < 4; k++)
+    piece->pipe->dsc.processed_maximum[k] =
+      nthreads == 1 ? processed_maximum_new[k] : processed_maximum_saved[k];
 
   dt_free_align(input);
   dt_free_align(output);
@@ -907,25 +993,18 @@ static void _default_process_tiling_roi(dt_iop_module_t *self,
 
   assert(xyalign != 0);
 
-  /* shrink tile size in case it would exceed singlebuffer size */
+  /* make sure that overlap follows alignment rules by making it wider when needed.
+     overlap_in needs to be aligned, overlap_out is only here to calculate output buffer size */
+  const int overlap_in = _align_up(tiling.overlap, xyalign);
+  const int overlap_out = ceilf((float)overlap_in / fullscale);
+
+  /* shrink tile size in case it would exceed singlebuffer size, choosing
+     the grid with the least recomputed overlap halo */
   if((float)width * height * max_bpp * maxbuf > singlebuffer)
   {
-    const float scale = singlebuffer / ((float)width * height * max_bpp * maxbuf);
-
-    /* TODO: can we make this more efficient to minimize total overlap between tiles? */
-    if(width < height && scale >= 0.333f)
-    {
-      height = _align_down((int)floorf(height * scale), xyalign);
-    }
-    else if(height <= width && scale >= 0.333f)
-    {
-      width = _align_down((int)floorf(width * scale), xyalign);
-    }
-    else
-    {
-      width = _align_down((int)floorf(width * sqrtf(scale)), xyalign);
-      height = _align_down((int)floorf(height * sqrtf(scale)), xyalign);
-    }
+    _fit_tiles_to_budget(width, height, width, height,
+                         singlebuffer / (max_bpp * maxbuf), overlap_in, inacc, xyalign, xyalign,
+                         &width, &height);
     dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
              "[default_process_tiling_roi] [%s] buffer exceeds singlebuffer, corrected to %dx%d",
              dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
@@ -940,11 +1019,6 @@ static void _default_process_tiling_roi(dt_iop_module_t *self,
              dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
   }
 
-  /* make sure that overlap follows alignment rules by making it wider when needed.
-     overlap_in needs to be aligned, overlap_out is only here to calculate output buffer size */
-  const int overlap_in = _align_up(tiling.overlap, xyalign);
-  const int overlap_out = ceilf((float)overlap_in / fullscale);
-
   int tiles_x = 1, tiles_y = 1;
 
   /* calculate number of tiles taking the larger buffer (input or output) as a guiding one.
@@ -1217,24 +1291,16 @@ float dt_tiling_estimate_cpumem(dt_develop_tiling_t *tiling,
   int height = MAX(roi_in->height, roi_out->height);
 
   const unsigned int xyalign = _lcm(tiling->xalign, tiling->yalign);
+  const int overlap_in = _align_up(tiling->overlap, xyalign);
+  const int overlap_out = ceilf((float)overlap_in / fullscale);
+
   if((float)width * height * max_bpp * maxbuf > singlebuffer)
-  {
-    const float scale = singlebuffer / ((float)width * height * max_bpp * maxbuf);
-    if(width < height && scale >= 0.333f)
-       height = _align_down((int)floorf(height * scale), xyalign);
-    else if(height <= width && scale >= 0.333f)
-      width = _align_down((int)floorf(width * scale), xyalign);
-    else
-    {
-      width = _align_down((int)floorf(width * sqrtf(scale)), xyalign);
-      height = _align_down((int)floorf(height * sqrtf(scale)), xyalign);
-    }
-  }
+    _fit_tiles_to_budget(width, height, width, height,
+                         singlebuffer / (max_bpp * maxbuf), overlap_in, 0, xyalign, xyalign,
+                         &width, &height);
 
   if(3 * tiling->overlap > width || 3 * tiling->overlap > height)
     width = height = _align_down((int)floorf(sqrtf((float)width * height)), xyalign);
-  const int overlap_in = _align_up(tiling->overlap, xyalign);
-  const int overlap_out = ceilf((float)overlap_in / fullscale);
 
   int tiles_x = 1, tiles_y = 1;
 
@@ -1276,27 +1342,20 @@ float dt_tiling_estimate_clmem(dt_develop_tiling_t *tiling,
   unsigned int xyalign = _lcm(tiling->xalign, tiling->yalign);
   xyalign = _lcm(xyalign, CL_ALIGNMENT);
 
-  if((float)width * height * max_bpp * maxbuf > singlebuffer)
-  {
-    const float scale = singlebuffer / ((float)width * height * max_bpp * maxbuf);
+  const int overlap_in = _align_up(tiling->overlap, xyalign);
+  const int overlap_out = ceilf((float)overlap_in / fullscale);
 
-    if(width < height && scale >= 0.333f)
-       height = _align_down((int)floorf(height * scale), xyalign);
-     else if(height <= width && scale >= 0.333f)
-       width = _align_down((int)floorf(width * scale), xyalign);
-     else
-    {
-      width = _align_down((int)floorf(width * sqrtf(scale)), xyalign);
-      height = _align_down((int)floorf(height * sqrtf(scale)), xyalign);
-    }
-  }
+  if((float)width * height * max_bpp * maxbuf > singlebuffer)
+    _fit_tiles_to_budget(MAX(roi_in->width, roi_out->width),
+                         MAX(roi_in->height, roi_out->height),
+                         darktable.opencl->dev[devid].max_image_width,
+                         darktable.opencl->dev[devid].max_image_height,
+                         singlebuffer / (max_bpp * maxbuf), overlap_in, 0, xyalign, xyalign,
+                         &width, &height);
 
   if(3 * tiling->overlap > width || 3 * tiling->overlap > height)
     width = height = _align_down((int)floorf(sqrtf((float)width * height)), xyalign);
 
-  const int overlap_in = _align_up(tiling->overlap, xyalign);
-  const int overlap_out = ceilf((float)overlap_in / fullscale);
-
   int tiles_x = 1, tiles_y = 1;
 
   if(roi_in->width > roi_out->width)
@@ -1360,38 +1419,6 @@ static int _default_process_tiling_cl_ptp(dt_iop_module_t *self,
   int width = MIN(roi_in->width, darktable.opencl->dev[devid].max_image_width);
   int height = MIN(roi_in->height, darktable.opencl->dev[devid].max_image_height);
 
-  /* shrink tile size in case it would exceed singlebuffer size */
-  if((float)width * height * max_bpp * maxbuf > singlebuffer)
-  {
-    const float scale = singlebuffer / ((float)width * height * max_bpp * maxbuf);
-
-    if(width < height && scale >= 0.333f)
-    {
-      height = floorf(height * scale);
-    }
-    else if(height <= width && scale >= 0.333f)
-    {
-      width = floorf(width * scale);
-    }
-    else
-    {
-      width = floorf(width * sqrtf(scale));
-      height = floorf(height * sqrtf(scale));
-    }
-    dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
-             "[default_process_tiling_cl_ptp] [%s] buffer exceeds singlebuffer, corrected to %dx%d",
-             dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
-  }
-
-  /* make sure we have a reasonably effective tile dimension. if not try square tiles */
-  if(3 * tiling.overlap > width || 3 * tiling.overlap > height)
-  {
-    width = height = floorf(sqrtf((float)width * height));
-    dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
-             "[default_process_tiling_cl_ptp] [%s] use squares because of overlap, corrected to %dx%d",
-             dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
-  }
-
   /* Alignment rules: we need to make sure that alignment requirements of module are fulfilled.
      Modules will report alignment requirements via xalign and yalign within tiling_callback().
      Typical use case is demosaic where Bayer pattern requires alignment to a multiple of 2 in x and y
@@ -1409,14 +1436,37 @@ static int _default_process_tiling_cl_ptp(dt_iop_module_t *self,
 
   assert(xyalign != 0 && walign != 0 && halign != 0);
 
-  /* properly align tile width and height by making them smaller if needed */
-  if(width < roi_in->width) width = (width / walign) * walign;
-  if(height < roi_in->height) height = (height / halign) * halign;
-
   /* also make sure that overlap follows alignment rules by making it wider when needed */
   const int overlap = tiling.overlap % xyalign != 0 ? (tiling.overlap / xyalign + 1) * xyalign
                                                     : tiling.overlap;
 
+  /* shrink tile size in case it would exceed singlebuffer size, choosing
+     the grid with the least recomputed overlap halo */
+  if((float)width * height * max_bpp * maxbuf > singlebuffer)
+  {
+    _fit_tiles_to_budget(roi_in->width, roi_in->height,
+                         darktable.opencl->dev[devid].max_image_width,
+                         darktable.opencl->dev[devid].max_image_height,
+                         singlebuffer / (max_bpp * maxbuf), overlap, 0, walign, halign,
+                         &width, &height);
+    dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
+             "[default_process_tiling_cl_ptp] [%s] buffer exceeds singlebuffer, corrected to %dx%d",
+             dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
+  }
+
+  /* make sure we have a reasonably effective tile dimension. if not try square tiles */
+  if(3 * tiling.overlap > width || 3 * tiling.overlap > height)
+  {
+    width = height = floorf(sqrtf((float)width * height));
+    dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
+             "[default_process_tiling_cl_ptp] [%s] use squares because of overlap, corrected to %dx%d",
+             dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
+  }
+
+  /* properly align tile width and height by making them smaller if needed */
+  if(width < roi_in->width) width = (width / walign) * walign;
+  if(height < roi_in->height) height = (height / halign) * halign;
+
 
   /* calculate effective tile size */
   const int tile_wd = width - 2 * overlap > 0 ? width - 2 * overlap : 1;
@@ -1684,6 +1734,156 @@ error:
 
 /* more elaborate tiling algorithm for roi_in != roi_out: slower than the ptp variant,
    more tiles and larger overlap */
+/* per-tile geometry of the roi tiling strategy. calculated via
+   _tile_roi_geometry() one tile ahead of the device so that the
+   host-side input scatter can overlap with kernel execution */
+typedef struct _tile_geometry_t
+{
+  dt_iop_roi_t iroi_full;
+  dt_iop_roi_t oroi_full;
+  size_t ioffs, ooffs;
+  size_t iorigin[3], iregion[3];
+  size_t oforigin[3], ofregion[3];
+  size_t oorigin[3], oregion[3];
+} _tile_geometry_t;
+
+static gboolean _tile_roi_geometry(dt_iop_module_t *self,
+                                   dt_dev_pixelpipe_iop_t *piece,
+                                   const dt_iop_roi_t *const roi_in,
+                                   const dt_iop_roi_t *const roi_out,
+                                   const size_t tx,
+                                   const size_t ty,
+                                   const size_t tile_wd,
+                                   const size_t tile_ht,
+                                   const int overlap_in,
+                                   const int delta,
+                                   const unsigned int xyalign,
+                                   const int ipitch,
+                                   const int opitch,
+                                   const int in_bpp,
+                                   const int out_bpp,
+                                   _tile_geometry_t *g)
+{
+  /* the output dimensions of the good part of this specific tile */
+  const size_t wd = (tx + 1) * tile_wd > roi_out->width ? (size_t)roi_out->width - tx * tile_wd : tile_wd;
+  const size_t ht = (ty + 1) * tile_ht > roi_out->height ? (size_t)roi_out->height - ty * tile_ht : tile_ht;
+
+  /* roi_in and roi_out of good part: oroi_good easy to calculate based on number and dimension of tile.
+     iroi_good is calculated by modify_roi_in() of respective module */
+  dt_iop_roi_t iroi_good = { roi_in->x  + tx * tile_wd, roi_in->y  + ty * tile_ht, wd, ht, roi_in->scale };
+  dt_iop_roi_t oroi_good = { roi_out->x + tx * tile_wd, roi_out->y + ty * tile_ht, wd, ht, roi_out->scale };
+
+  self->modify_roi_in(self, piece, &oroi_good, &iroi_good);
+
+  /* clamp iroi_good to not exceed roi_in */
+  iroi_good.x = MAX(iroi_good.x, roi_in->x);
+  iroi_good.y = MAX(iroi_good.y, roi_in->y);
+  iroi_good.width = MIN(iroi_good.width, roi_in->width + roi_in->x - iroi_good.x);
+  iroi_good.height = MIN(iroi_good.height, roi_in->height + roi_in->y - iroi_good.y);
+
+  _print_roi(&iroi_good, "tile iroi_good");
+  _print_roi(&oroi_good, "tile oroi_good");
+
+  /* now we need to calculate full region of this tile: increase input roi to take care of overlap
+     requirements
+     and alignment and add additional delta to correct for possible rounding errors in modify_roi_in()
+     -> generates first estimate of iroi_full */
+  const int x_in = iroi_good.x;
+  const int y_in = iroi_good.y;
+  const int width_in = iroi_good.width;
+  const int height_in = iroi_good.height;
+  const int new_x_in = MAX(_align_close(x_in - overlap_in - delta, xyalign), roi_in->x);
+  const int new_y_in = MAX(_align_close(y_in - overlap_in - delta, xyalign), roi_in->y);
+  const int new_width_in = MIN(_align_up(width_in + overlap_in + delta + (x_in - new_x_in), xyalign),
+                                roi_in->width + roi_in->x - new_x_in);
+  const int new_height_in = MIN(_align_up(height_in + overlap_in + delta + (y_in - new_y_in), xyalign),
+                                 roi_in->height + roi_in->y - new_y_in);
+
+  /* iroi_full based on calculated numbers and dimensions. oroi_full just set as a starting point for the
+   * following iterative search */
+  dt_iop_roi_t iroi_full = { new_x_in, new_y_in, new_width_in, new_height_in, iroi_good.scale };
+  dt_iop_roi_t oroi_full = oroi_good; // a good starting point for optimization
+
+  _print_roi(&iroi_full, "tile iroi_full before optimization");
+  _print_roi(&oroi_full, "tile oroi_full before optimization");
+
+  /* try to find a matching oroi_full */
+  if(!_fit_output_to_input_roi(self, piece, &iroi_full, &oroi_full, delta, 10))
+  {
+    dt_print(DT_DEBUG_OPENCL | DT_DEBUG_TILING,
+             "[default_process_tiling_cl_roi] [%s] can not handle requested roi's tiling "
+             "for module '%s%s' not possible",
+             dt_dev_pixelpipe_type_to_str(piece->pipe->type), self->op, dt_iop_get_instance_id(self));
+    return FALSE;
+  }
+
+
+  /* make sure that oroi_full at least covers the range of oroi_good.
+     this step is needed due to the possibility of rounding errors */
+  oroi_full.x = MIN(oroi_full.x, oroi_good.x);
+  oroi_full.y = MIN(oroi_full.y, oroi_good.y);
+  oroi_full.width = MAX(oroi_full.width, oroi_good.x + oroi_good.width - oroi_full.x);
+  oroi_full.height = MAX(oroi_full.height, oroi_good.y + oroi_good.height - oroi_full.y);
+
+  /* clamp oroi_full to not exceed roi_out */
+  oroi_full.x = MAX(oroi_full.x, roi_out->x);
+  oroi_full.y = MAX(oroi_full.y, roi_out->y);
+  oroi_full.width = MIN(oroi_full.width, roi_out->width + roi_out->x - oroi_full.x);
+  oroi_full.height = MIN(oroi_full.height, roi_out->height + roi_out->y - oroi_full.y);
+
+
+  /* calculate final iroi_full */
+  self->modify_roi_in(self, piece, &oroi_full, &iroi_full);
+
+  /* clamp iroi_full to not exceed roi_in */
+  iroi_full.x = MAX(iroi_full.x, roi_in->x);
+  iroi_full.y = MAX(iroi_full.y, roi_in->y);
+  iroi_full.width = MIN(iroi_full.width, roi_in->width + roi_in->x - iroi_full.x);
+  iroi_full.height = MIN(iroi_full.height, roi_in->height + roi_in->y - iroi_full.y);
+
+  _print_roi(&iroi_full, "tile iroi_full");
+  _print_roi(&oroi_full, "tile oroi_full");
+
+  /* offsets of tile into ivoid and ovoid */
+  const int in_dx = iroi_full.x - roi_in->x;
+  const int in_dy = iroi_full.y - roi_in->y;
+  const int out_dx = oroi_good.x - roi_out->x;
+  const int out_dy = oroi_good.y - roi_out->y;
+
+  g->iroi_full = iroi_full;
+  g->oroi_full = oroi_full;
+  g->ioffs = (size_t)(in_dy  * ipitch) + (size_t)(in_dx * in_bpp);
+  g->ooffs = (size_t)(out_dy * opitch) + (size_t)(out_dx * out_bpp);
+
+  /* origin and region of full input tile */
+  g->iorigin[0] = g->iorigin[1] = g->iorigin[2] = 0;
+  g->iregion[0] = iroi_full.width;
+  g->iregion[1] = iroi_full.height;
+  g->iregion[2] = 1;
+
+  /* origin and region of full output tile */
+  g->oforigin[0] = g->oforigin[1] = g->oforigin[2] = 0;
+  g->ofregion[0] = oroi_full.width;
+  g->ofregion[1] = oroi_full.height;
+  g->ofregion[2] = 1;
+
+  /* origin and region of good part of output tile */
+  g->oorigin[0] = oroi_good.x - oroi_full.x;
+  g->oorigin[1] = oroi_good.y - oroi_full.y;
+  g->oorigin[2] = 0;
+  g->oregion[0] = oroi_good.width;
+  g->oregion[1] = oroi_good.height;
+  g->oregion[2] = 1;
+
+  dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
+           "[default_process_tiling_cl_roi]    dest [%lu,%lu] at [%lu,%lu], "
+           "offsets [%i,%i] -> [%i,%i], delta=%i\n",
+           g->oregion[0], g->oregion[1], g->oorigin[0], g->oorigin[1], in_dx, in_dy,
+           out_dx, out_dy, delta);
+
+  return TRUE;
+}
+
 static int _default_process_tiling_cl_roi(dt_iop_module_t *self,
                                           dt_dev_pixelpipe_iop_t *piece,
                                           const void *const ivoid,
@@ -1752,24 +1952,21 @@ static int _default_process_tiling_cl_roi(dt_iop_module_t *self,
 
   assert(xyalign != 0);
 
-  /* shrink tile size in case it would exceed singlebuffer size */
+  /* make sure that overlap follows alignment rules by making it wider when needed.
+     overlap_in needs to be aligned, overlap_out is only here to calculate output buffer size */
+  const int overlap_in = _align_up(tiling.overlap, xyalign);
+  const int overlap_out = ceilf((float)overlap_in / fullscale);
+
+  /* shrink tile size in case it would exceed singlebuffer size, choosing
+     the grid with the least recomputed overlap halo */
   if((float)width * height * max_bpp * maxbuf > singlebuffer)
   {
-    const float scale = singlebuffer / ((float)width * height * max_bpp * maxbuf);
-
-    if(width < height && scale >= 0.333f)
-    {
-      height = _align_down((int)floorf(height * scale), xyalign);
-    }
-    else if(height <= width && scale >= 0.333f)
-    {
-      width = _align_down((int)floorf(width * scale), xyalign);
-    }
-    else
-    {
-      width = _align_down((int)floorf(width * sqrtf(scale)), xyalign);
-      height = _align_down((int)floorf(height * sqrtf(scale)), xyalign);
-    }
+    _fit_tiles_to_budget(MAX(roi_in->width, roi_out->width),
+                         MAX(roi_in->height, roi_out->height),
+                         darktable.opencl->dev[devid].max_image_width,
+                         darktable.opencl->dev[devid].max_image_height,
+                         singlebuffer / (max_bpp * maxbuf), overlap_in, inacc, xyalign, xyalign,
+                         &width, &height);
     dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
              "[default_process_tiling_cl_roi] [%s] buffer exceeds singlebuffer, corrected to %dx%d",
              dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
@@ -1784,11 +1981,6 @@ static int _default_process_tiling_cl_roi(dt_iop_module_t *self,
              dt_dev_pixelpipe_type_to_str(piece->pipe->type), width, height);
   }
 
-  /* make sure that overlap follows alignment rules by making it wider when needed.
-     overlap_in needs to be aligned, overlap_out is only here to calculate output buffer size */
-  const int overlap_in = _align_up(tiling.overlap, xyalign);
-  const int overlap_out = ceilf((float)overlap_in / fullscale);
-
   int tiles_x = 1, tiles_y = 1;
 
   /* calculate number of tiles taking the larger buffer (input or output) as a guiding one.
@@ -1895,213 +2087,167 @@ static int _default_process_tiling_cl_roi(dt_iop_module_t *self,
   }
 
 
-  /* iterate over tiles */
-  for(size_t tx = 0; tx < tiles_x; tx++)
-  {
-    for(size_t ty = 0; ty < tiles_y; ty++)
-    {
-      piece->pipe->tiling = TRUE;
-
-      /* the output dimensions of the good part of this specific tile */
-      const size_t wd = (tx + 1) * tile_wd > roi_out->width ? (size_t)roi_out->width - tx * tile_wd : tile_wd;
-      const size_t ht = (ty + 1) * tile_ht > roi_out->height ? (size_t)roi_out->height - ty * tile_ht : tile_ht;
+  const size_t num_tiles = (size_t)tiles_x * tiles_y;
 
-      /* roi_in and roi_out of good part: oroi_good easy to calculate based on number and dimension of tile.
-         iroi_good is calculated by modify_roi_in() of respective module */
-      dt_iop_roi_t iroi_good = { roi_in->x  + tx * tile_wd, roi_in->y  + ty * tile_ht, wd, ht, roi_in->scale };
-      dt_iop_roi_t oroi_good = { roi_out->x + tx * tile_wd, roi_out->y + ty * tile_ht, wd, ht, roi_out->scale };
+  /* tile geometries are computed one tile ahead: while the device is
+     still crunching a tile the host already prepares the input of the
+     next one, so with pinned memory the scatter copy overlaps with
+     kernel execution instead of leaving the CPU idle */
+  _tile_geometry_t tgeo[2];
+  int cur = 0;
 
-      self->modify_roi_in(self, piece, &oroi_good, &iroi_good);
+  if(!_tile_roi_geometry(self, piece, roi_in, roi_out, 0, 0, tile_wd, tile_ht,
+                         overlap_in, delta, xyalign, ipitch, opitch,
+                         in_bpp, out_bpp, &tgeo[cur]))
+  {
+    err = DT_OPENCL_PROCESS_CL;
+    goto error;
+  }
 
-      /* clamp iroi_good to not exceed roi_in */
-      iroi_good.x = MAX(iroi_good.x, roi_in->x);
-      iroi_good.y = MAX(iroi_good.y, roi_in->y);
-      iroi_good.width = MIN(iroi_good.width, roi_in->width + roi_in->x - iroi_good.x);
-      iroi_good.height = MIN(iroi_good.height, roi_in->height + roi_in->y - iroi_good.y);
+  if(use_pinned_memory)
+  {
+    /* prepare pinned input tile buffer: copy part of input image */
+    dt_iop_roi_t firoi_full = tgeo[cur].iroi_full;
+    const size_t fioffs = tgeo[cur].ioffs;
+    DT_OMP_FOR(shared(firoi_full))
+    for(size_t j = 0; j < firoi_full.height; j++)
+      memcpy((char *)input_buffer + j * firoi_full.width * in_bpp, (char *)ivoid + fioffs + j * ipitch,
+             (size_t)firoi_full.width * in_bpp);
+  }
 
-      _print_roi(&iroi_good, "tile iroi_good");
-      _print_roi(&oroi_good, "tile oroi_good");
+  /* iterate over tiles */
+  for(size_t tile = 0; tile < num_tiles; tile++)
+  {
+    piece->pipe->tiling = TRUE;
 
-      /* now we need to calculate full region of this tile: increase input roi to take care of overlap
-         requirements
-         and alignment and add additional delta to correct for possible rounding errors in modify_roi_in()
-         -> generates first estimate of iroi_full */
-      const int x_in = iroi_good.x;
-      const int y_in = iroi_good.y;
-      const int width_in = iroi_good.width;
-      const int height_in = iroi_good.height;
-      const int new_x_in = MAX(_align_close(x_in - overlap_in - delta, xyalign), roi_in->x);
-      const int new_y_in = MAX(_align_close(y_in - overlap_in - delta, xyalign), roi_in->y);
-      const int new_width_in = MIN(_align_up(width_in + overlap_in + delta + (x_in - new_x_in), xyalign),
-                                    roi_in->width + roi_in->x - new_x_in);
-      const int new_height_in = MIN(_align_up(height_in + overlap_in + delta + (y_in - new_y_in), xyalign),
-                                     roi_in->height + roi_in->y - new_y_in);
+    const size_t tx = tile / tiles_y;
+    const size_t ty = tile % tiles_y;
 
-      /* iroi_full based on calculated numbers and dimensions. oroi_full just set as a starting point for the
-       * following iterative search */
-      dt_iop_roi_t iroi_full = { new_x_in, new_y_in, new_width_in, new_height_in, iroi_good.scale };
-      dt_iop_roi_t oroi_full = oroi_good; // a good starting point for optimization
+    dt_iop_roi_t iroi_full = tgeo[cur].iroi_full;
+    dt_iop_roi_t oroi_full = tgeo[cur].oroi_full;
+    const size_t ioffs = tgeo[cur].ioffs;
+    const size_t ooffs = tgeo[cur].ooffs;
 
-      _print_roi(&iroi_full, "tile iroi_full before optimization");
-      _print_roi(&oroi_full, "tile oroi_full before optimization");
+    dt_print(DT_DEBUG_TILING,
+             "[default_process_tiling_cl_roi] [%s] process tile (%zu,%zu) size %dx%d at origin [%d,%d]",
+             dt_dev_pixelpipe_type_to_str(piece->pipe->type), tx, ty,
+             iroi_full.width, iroi_full.height, iroi_full.x, iroi_full.y);
+
+    /* get opencl input and output buffers */
+    input = dt_opencl_alloc_device(devid, iroi_full.width, iroi_full.height, in_bpp);
+    output = dt_opencl_alloc_device(devid, oroi_full.width, oroi_full.height, out_bpp);
+    if(output == NULL || input == NULL)
+    {
+      err = CL_MEM_OBJECT_ALLOCATION_FAILURE;
+      goto error;
+    }
 
-      /* try to find a matching oroi_full */
-      if(!_fit_output_to_input_roi(self, piece, &iroi_full, &oroi_full, delta, 10))
+    if(use_pinned_memory)
+    {
+      /* blocking memory transfer: pinned host input buffer -> opencl/device tile.
+         the buffer was filled while the device was busy with the previous tile */
+      err = dt_opencl_write_host_to_device_raw(devid, (char *)input_buffer, input, tgeo[cur].iorigin,
+                                               tgeo[cur].iregion, (size_t)iroi_full.width * in_bpp, CL_TRUE);
+      if(err != CL_SUCCESS)
       {
-        dt_print(DT_DEBUG_OPENCL | DT_DEBUG_TILING,
-                 "[default_process_tiling_cl_roi] [%s] can not handle requested roi's tiling "
-                 "for module '%s%s' not possible",
-                 dt_dev_pixelpipe_type_to_str(piece->pipe->type), self->op, dt_iop_get_instance_id(self));
-        err = DT_OPENCL_PROCESS_CL;
+        use_pinned_memory = FALSE;
         goto error;
       }
+    }
+    else
+    {
+      /* blocking direct memory transfer: host input image -> opencl/device tile */
+      err = dt_opencl_write_host_to_device_raw(devid, (char *)ivoid + ioffs, input, tgeo[cur].iorigin,
+                                               tgeo[cur].iregion, ipitch, CL_TRUE);
+      if(err != CL_SUCCESS) goto error;
+    }
 
+    /* take original processed_maximum as starting point */
+    for(int k = 0; k < 4; k++) piece->pipe->dsc.processed_maximum[k] = processed_maximum_saved[k];
 
-      /* make sure that oroi_full at least covers the range of oroi_good.
-         this step is needed due to the possibility of rounding errors */
-      oroi_full.x = MIN(oroi_full.x, oroi_good.x);
-      oroi_full.y = MIN(oroi_full.y, oroi_good.y);
-      oroi_full.width = MAX(oroi_full.width, oroi_good.x + oroi_good.width - oroi_full.x);
-      oroi_full.height = MAX(oroi_full.height, oroi_good.y + oroi_good.height - oroi_full.y);
-
-      /* clamp oroi_full to not exceed roi_out */
-      oroi_full.x = MAX(oroi_full.x, roi_out->x);
-      oroi_full.y = MAX(oroi_full.y, roi_out->y);
-      oroi_full.width = MIN(oroi_full.width, roi_out->width + roi_out->x - oroi_full.x);
-      oroi_full.height = MIN(oroi_full.height, roi_out->height + roi_out->y - oroi_full.y);
-
-
-      /* calculate final iroi_full */
-      self->modify_roi_in(self, piece, &oroi_full, &iroi_full);
-
-      /* clamp iroi_full to not exceed roi_in */
-      iroi_full.x = MAX(iroi_full.x, roi_in->x);
-      iroi_full.y = MAX(iroi_full.y, roi_in->y);
-      iroi_full.width = MIN(iroi_full.width, roi_in->width + roi_in->x - iroi_full.x);
-      iroi_full.height = MIN(iroi_full.height, roi_in->height + roi_in->y - iroi_full.y);
-
-      _print_roi(&iroi_full, "tile iroi_full");
-      _print_roi(&oroi_full, "tile oroi_full");
-
-      /* offsets of tile into ivoid and ovoid */
-      const int in_dx = iroi_full.x - roi_in->x;
-      const int in_dy = iroi_full.y - roi_in->y;
-      const int out_dx = oroi_good.x - roi_out->x;
-      const int out_dy = oroi_good.y - roi_out->y;
-      const size_t ioffs = (size_t)(in_dy  * ipitch) + (size_t)(in_dx * in_bpp);
-      const size_t ooffs = (size_t)(out_dy * opitch) + (size_t)(out_dx * out_bpp);
-
-      /* origin and region of full input tile */
-      size_t iorigin[] = { 0, 0, 0 };
-      size_t iregion[] = { iroi_full.width, iroi_full.height, 1 };
-
-      /* origin and region of full output tile */
-      size_t oforigin[] = { 0, 0, 0 };
-      size_t ofregion[] = { oroi_full.width, oroi_full.height, 1 };
+    /* call process_cl of module */
+    err = self->process_cl(self, piece, input, output, &iroi_full, &oroi_full);
+    if(err != CL_SUCCESS)
+      goto error;
 
-      /* origin and region of good part of output tile */
-      size_t oorigin[] = { oroi_good.x - oroi_full.x, oroi_good.y - oroi_full.y, 0 };
-      size_t oregion[] = { oroi_good.width, oroi_good.height, 1 };
+    /* aggregate resulting processed_maximum */
+    /* TODO: check if there really can be differences between tiles and take
+             appropriate action (calculate minimum, maximum, average, ...?) */
+    for(int k = 0; k < 4; k++)
+    {
+      if(tile > 0 && fabs(processed_maximum_new[k] - piece->pipe->dsc.processed_maximum[k]) > 1.0e-6f)
+        dt_print(DT_DEBUG_TILING,
+                 "[default_process_tiling_cl_roi] [%s] processed_maximum[%d] "
+                 "differs between tiles in module '%s%s'",
+                 dt_dev_pixelpipe_type_to_str(piece->pipe->type), k, self->op, dt_iop_get_instance_id(self));
+      processed_maximum_new[k] = piece->pipe->dsc.processed_maximum[k];
+    }
 
-      dt_print(DT_DEBUG_TILING,
-               "[default_process_tiling_cl_roi] [%s] process tile (%zu,%zu) size %dx%d at origin [%d,%d]",
-               dt_dev_pixelpipe_type_to_str(piece->pipe->type), tx, ty,
-               iroi_full.width, iroi_full.height, iroi_full.x, iroi_full.y);
-      dt_print(DT_DEBUG_TILING | DT_DEBUG_VERBOSE,
-               "[default_process_tiling_cl_roi]    dest [%lu,%lu] at [%lu,%lu], "
-               "offsets [%i,%i] -> [%i,%i], delta=%i\n",
-               oregion[0], oregion[1], oorigin[0], oorigin[1], in_dx, in_dy,
-               out_dx, out_dy, delta);
-
-      /* get opencl input and output buffers */
-      input = dt_opencl_alloc_device(devid, iroi_full.width, iroi_full.height, in_bpp);
-      output = dt_opencl_alloc_device(devid, oroi_full.width, oroi_full.height, out_bpp);
-      if(output == NULL || input == NULL)
+    /* while the device runs the kernels of this tile, work out the
+       geometry of the next one and scatter its input on the host; the
+       pinned input buffer is free again since the blocking write above
+       has already consumed it */
+    if(tile + 1 < num_tiles)
+    {
+      const size_t ntx = (tile + 1) / tiles_y;
+      const size_t nty = (tile + 1) % tiles_y;
+      if(!_tile_roi_geometry(self, piece, roi_in, roi_out, ntx, nty, tile_wd, tile_ht,
+                             overlap_in, delta, xyalign, ipitch, opitch,
+                             in_bpp, out_bpp, &tgeo[cur ^ 1]))
       {
-        err = CL_MEM_OBJECT_ALLOCATION_FAILURE;
+        err = DT_OPENCL_PROCESS_CL;
         goto error;
       }
 
       if(use_pinned_memory)
       {
-/* prepare pinned input tile buffer: copy part of input image */
-        DT_OMP_FOR(shared(iroi_full))
-        for(size_t j = 0; j < iroi_full.height; j++)
-          memcpy((char *)input_buffer + j * iroi_full.width * in_bpp, (char *)ivoid + ioffs + j * ipitch,
-                 (size_t)iroi_full.width * in_bpp);
-
-        /* blocking memory transfer: pinned host input buffer -> opencl/device tile */
-        err = dt_opencl_write_host_to_device_raw(devid, (char *)input_buffer, input, iorigin, iregion,
-                                                 (size_t)iroi_full.width * in_bpp, CL_TRUE);
-        if(err != CL_SUCCESS)
-        {
-          use_pinned_memory = FALSE;
-          goto error;
-        }
-      }
-      else
-      {
-        /* blocking direct memory transfer: host input image -> opencl/device tile */
-        err = dt_opencl_write_host_to_device_raw(devid, (char *)ivoid + ioffs, input, iorigin, iregion,
-                                                 ipitch, CL_TRUE);
-        if(err != CL_SUCCESS) goto error;
+        /* prepare pinned input tile buffer: copy part of input image */
+        dt_iop_roi_t niroi_full = tgeo[cur ^ 1].iroi_full;
+        const size_t nioffs = tgeo[cur ^ 1].ioffs;
+        DT_OMP_FOR(shared(niroi_full))
+        for(size_t j = 0; j < niroi_full.height; j++)
+          memcpy((char *)input_buffer + j * niroi_full.width * in_bpp, (char *)ivoid + nioffs + j * ipitch,
+                 (size_t)niroi_full.width * in_bpp);
       }
+    }
 
-      /* take original processed_maximum as starting point */
-      for(int k = 0; k < 4; k++) piece->pipe->dsc.processed_maximum[k] = processed_maximum_saved[k];
-
-      /* call process_cl of module */
-      err = self->process_cl(self, piece, input, output, &iroi_full, &oroi_full);
+    if(use_pinned_memory)
+    {
+      /* blocking memory transfer: complete opencl/device tile -> pinned host output buffer */
+      err = dt_opencl_read_host_from_device_raw(devid, (char *)output_buffer, output, tgeo[cur].oforigin,
+                                                tgeo[cur].ofregion, (size_t)oroi_full.width * out_bpp, CL_TRUE);
       if(err != CL_SUCCESS)
-        goto error;
-
-      /* aggregate resulting processed_maximum */
-      /* TODO: check if there really can be differences between tiles and take
-               appropriate action (calculate minimum, maximum, average, ...?) */
-      for(int k = 0; k < 4; k++)
       {
-        if(tx + ty > 0 && fabs(processed_maximum_new[k] - piece->pipe->dsc.processed_maximum[k]) > 1.0e-6f)
-          dt_print(DT_DEBUG_TILING,
-                   "[default_process_tiling_cl_roi] [%s] processed_maximum[%d] "
-                   "differs between tiles in module '%s%s'",
-                   dt_dev_pixelpipe_type_to_str(piece->pipe->type), k, self->op, dt_iop_get_instance_id(self));
-        processed_maximum_new[k] = piece->pipe->dsc.processed_maximum[k];
+        use_pinned_memory = FALSE;
+        goto error;
       }
+      /* copy "good" part of tile from pinned output buffer to output image */
+      size_t oorigin[] = { tgeo[cur].oorigin[0], tgeo[cur].oorigin[1], tgeo[cur].oorigin[2] };
+      size_t oregion[] = { tgeo[cur].oregion[0], tgeo[cur].oregion[1], tgeo[cur].oregion[2] };
+      DT_OMP_FOR(shared(oroi_full, oorigin, oregion))
+      for(size_t j = 0; j < oregion[1]; j++)
+        memcpy((char *)ovoid + ooffs + j * opitch,
+               (char *)output_buffer + ((j + oorigin[1]) * oroi_full.width + oorigin[0]) * out_bpp,
+               (size_t)oregion[0] * out_bpp);
+    }
+    else
+    {
+      /* blocking direct memory transfer: good part of opencl/device tile -> host output image */
+      err = dt_opencl_read_host_from_device_raw(devid, (char *)ovoid + ooffs, output, tgeo[cur].oorigin,
+                                                tgeo[cur].oregion, opitch, CL_TRUE);
+      if(err != CL_SUCCESS) goto error;
+    }
 
-      if(use_pinned_memory)
-      {
-        /* blocking memory transfer: complete opencl/device tile -> pinned host output buffer */
-        err = dt_opencl_read_host_from_device_raw(devid, (char *)output_buffer, output, oforigin, ofregion,
-                                                  (size_t)oroi_full.width * out_bpp, CL_TRUE);
-        if(err != CL_SUCCESS)
-        {
-          use_pinned_memory = FALSE;
-          goto error;
-        }
-/* copy "good" part of tile from pinned output buffer to output image */
-        DT_OMP_FOR(shared(oroi_full, oorigin, oregion))
-        for(size_t j = 0; j < oregion[1]; j++)
-          memcpy((char *)ovoid + ooffs + j * opitch,
-                 (char *)output_buffer + ((j + oorigin[1]) * oroi_full.width + oorigin[0]) * out_bpp,
-                 (size_t)oregion[0] * out_bpp);
-      }
-      else
-      {
-        /* blocking direct memory transfer: good part of opencl/device tile -> host output image */
-        err = dt_opencl_read_host_from_device_raw(devid, (char *)ovoid + ooffs, output, oorigin, oregion,
-                                                  opitch, CL_TRUE);
-        if(err != CL_SUCCESS) goto error;
-      }
+    /* release input and output buffers */
+    dt_opencl_release_mem_object(input);
+    input = NULL;
+    dt_opencl_release_mem_object(output);
+    output = NULL;
 
-      /* release input and output buffers */
-      dt_opencl_release_mem_object(input);
-      input = NULL;
-      dt_opencl_release_mem_object(output);
-      output = NULL;
+    /* block until opencl queue has finished to free all used event handlers */
+    dt_opencl_finish_sync_pipe(devid, piece->pipe->type);
 
-      /* block until opencl queue has finished to free all used event handlers */
-      dt_opencl_finish_sync_pipe(devid, piece->pipe->type);
-    }
+    cur ^= 1;
   }
   /* copy back final processed_maximum */
   for(int k = 0; k < 4; k++) piece->pipe->dsc.processed_maximum[k] = processed_maximum_new[k];
@@ -41,6 +41,11 @@ typedef struct dt_develop_tiling_t
       Bayer pattern. */
   unsigned xalign;
   unsigned yalign;
+  /** set to TRUE if process() may safely be called concurrently on
+      disjoint tiles. the module must keep all temporary state local to a
+      single process() call and must neither read nor update
+      pipe->dsc.processed_maximum. */
+  gboolean parallel;
 } dt_develop_tiling_t;
 
 int default_process_tiling_cl(struct dt_iop_module_t *self, struct dt_dev_pixelpipe_iop_t *piece,
@@ -24,6 +24,7 @@
 #include "common/debug.h"
 #include "common/selection.h"
 #include "control/control.h"
+#include "control/jobs.h"
 #include "gui/gtk.h"
 #include "views/view.h"
 
@@ -1142,26 +1143,18 @@ void dt_culling_init(dt_culling_t *table,
   table->offset_imgid = first_id;
 }
 
-static void _thumbs_prefetch(dt_culling_t *table)
+// get the imgids of the neighbours of rowid in the navigation order
+// (collection or selection), walking forward or backward. returns the
+// number of ids actually found, closest first
+static int _thumbs_get_neighbours(dt_culling_t *table,
+                                  const int rowid,
+                                  const gboolean forward,
+                                  const int limit,
+                                  dt_imgid_t *ids)
 {
-  if(!table->list) return;
-
-  // get the mip level by using the max image size actually shown
-  int maxw = 0;
-  int maxh = 0;
-  for(GList *l = table->list; l; l = g_list_next(l))
-  {
-    dt_thumbnail_t *th = l->data;
-    maxw = MAX(maxw, th->width);
-    maxh = MAX(maxh, th->height);
-  }
-  dt_mipmap_size_t mip =
-    dt_mipmap_cache_get_matching_size(maxw, maxh);
-
-  // prefetch next image
   gchar *query;
   sqlite3_stmt *stmt;
-  dt_thumbnail_t *last = g_list_last(table->list)->data;
+  int count = 0;
   if(table->navigate_inside_selection)
   {
     // clang-format off
@@ -1169,10 +1162,10 @@ static void _thumbs_prefetch(dt_culling_t *table)
       ("SELECT m.imgid"
        " FROM memory.collected_images AS m, main.selected_images AS s"
        " WHERE m.imgid = s.imgid"
-       "   AND m.rowid > %d"
-       " ORDER BY m.rowid "
-       " LIMIT 1",
-       last->rowid);
+       "   AND m.rowid %s %d"
+       " ORDER BY m.rowid %s"
+       " LIMIT %d",
+       forward ? ">" : "<", rowid, forward ? "" : "DESC", limit);
     // clang-format on
   }
   else
@@ -1180,58 +1173,77 @@ static void _thumbs_prefetch(dt_culling_t *table)
     // clang-format off
     query = g_strdup_printf
       ("SELECT m.imgid"
-       " FROM memory.collected_images AS m "
-       " WHERE m.rowid > %d"
-       " ORDER BY m.rowid "
-       " LIMIT 1",
-       last->rowid);
+       " FROM memory.collected_images AS m"
+       " WHERE m.rowid %s %d"
+       " ORDER BY m.rowid %s"
+       " LIMIT %d",
+       forward ? ">" : "<", rowid, forward ? "" : "DESC", limit);
     // clang-format on
   }
   DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db), query, -1, &stmt, NULL);
-  if(sqlite3_step(stmt) == SQLITE_ROW)
+  while(sqlite3_step(stmt) == SQLITE_ROW && count < limit)
   {
     const dt_imgid_t id = sqlite3_column_int(stmt, 0);
-    if(dt_is_valid_imgid(id))
-      dt_mipmap_cache_get(NULL, id, mip, DT_MIPMAP_PREFETCH, 'r');
+    if(dt_is_valid_imgid(id)) ids[count++] = id;
   }
   sqlite3_finalize(stmt);
   g_free(query);
+  return count;
+}
 
-  // prefetch previous image
-  dt_thumbnail_t *prev = (table->list)->data;
-  if(table->navigate_inside_selection)
-  {
-    // clang-format off
-    query = g_strdup_printf
-      ("SELECT m.imgid"
-       " FROM memory.collected_images AS m, main.selected_images AS s"
-       " WHERE m.imgid = s.imgid"
-       "   AND m.rowid < %d"
-       " ORDER BY m.rowid DESC "
-       " LIMIT 1",
-       prev->rowid);
-    // clang-format on
-  }
-  else
+static void _thumbs_prefetch(dt_culling_t *table)
+{
+  if(!table->list) return;
+
+  // get the mip level by using the max image size actually shown
+  int maxw = 0;
+  int maxh = 0;
+  for(GList *l = table->list; l; l = g_list_next(l))
   {
-    // clang-format off
-    query = g_strdup_printf
-      ("SELECT m.imgid"
-       " FROM memory.collected_images AS m"
-       " WHERE m.rowid < %d"
-       " ORDER BY m.rowid DESC "
-       " LIMIT 1",
-       prev->rowid);
-    // clang-format on
+    dt_thumbnail_t *th = l->data;
+    maxw = MAX(maxw, th->width);
+    maxh = MAX(maxh, th->height);
   }
-  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db), query, -1, &stmt, NULL);
-  if(sqlite3_step(stmt) == SQLITE_ROW)
-  {
-    const dt_imgid_t id = sqlite3_column_int(stmt, 0);
-    if(dt_is_valid_imgid(id))
-      dt_mipmap_cache_get(NULL, id, mip, DT_MIPMAP_PREFETCH, 'r');
+  dt_mipmap_size_t mip =
+    dt_mipmap_cache_get_matching_size(maxw, maxh);
+
+  // how deep we look around the current position. the immediate
+  // next/previous image is always fetched
+  const int deep = CLAMP(dt_conf_get_int("plugins/lighttable/prefetch_count"),
+                         0, DT_IMAGE_PREFETCH_MAX);
+
+  dt_thumbnail_t *last = g_list_last(table->list)->data;
+  dt_thumbnail_t *first = (table->list)->data;
+  dt_imgid_t next_ids[DT_IMAGE_PREFETCH_MAX];
+  dt_imgid_t prev_ids[DT_IMAGE_PREFETCH_MAX];
+  const int nb_next =
+    _thumbs_get_neighbours(table, last->rowid, TRUE, MAX(deep, 1), next_ids);
+  const int nb_prev =
+    _thumbs_get_neighbours(table, first->rowid, FALSE, MAX(deep, 1), prev_ids);
+
+  // warm the mip actually displayed for all of them, so advancing in
+  // either direction is a pure cache hit
+  for(int k = 0; k < nb_next; k++)
+    dt_mipmap_cache_get(NULL, next_ids[k], mip, DT_MIPMAP_PREFETCH, 'r');
+  for(int k = 0; k < nb_prev; k++)
+    dt_mipmap_cache_get(NULL, prev_ids[k], mip, DT_MIPMAP_PREFETCH, 'r');
+
+  // additionally decode the closest raws into the full buffer tier on a
+  // background thread so advancing through the collection doesn't stall
+  // on the decode. a new request (i.e. a jump elsewhere) cancels the
+  // previous one inside dt_image_prefetch()
+  if(deep > 0)
+  {
+    // interleave both directions, closest image first
+    dt_imgid_t ids[DT_IMAGE_PREFETCH_MAX];
+    int count = 0;
+    for(int k = 0; k < MAX(nb_next, nb_prev) && count < deep; k++)
+    {
+      if(k < nb_next && count < deep) ids[count++] = next_ids[k];
+      if(k < nb_prev && count < deep) ids[count++] = prev_ids[k];
+    }
+    dt_image_prefetch(ids, count);
   }
-  sqlite3_finalize(stmt);
 }
 
 static gboolean _thumbs_recreate_list_at(dt_culling_t *table,
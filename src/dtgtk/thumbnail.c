@@ -30,6 +30,7 @@
 #include "common/image_cache.h"
 #include "common/ratings.h"
 #include "common/selection.h"
+#include "common/thumbinfo.h"
 #include "common/variables.h"
 #include "control/control.h"
 #include "dtgtk/button.h"
@@ -236,6 +237,49 @@ static void _image_get_infos(dt_thumbnail_t *thumb)
   // cached on widget creation
 
   const int old_rating = thumb->rating;
+
+  // the columnar index has everything we need without touching sqlite
+  // or the image cache mutex, which matters a lot while scrolling
+  dt_thumbinfo_t info;
+  if(dt_thumbinfo_get(thumb->imgid, &info))
+  {
+    thumb->rating = info.flags & DT_IMAGE_REJECTED
+      ? DT_VIEW_REJECT
+      : (info.flags & DT_VIEW_RATINGS_MASK);
+    if(old_rating != thumb->rating)
+      _thumb_update_rating_class(thumb);
+
+    // if we don't show overlays, no need to go further
+    if(thumb->over == DT_THUMBNAIL_OVERLAYS_NONE)
+      return;
+
+    thumb->has_localcopy = (info.flags & DT_IMAGE_LOCAL_COPY) != 0;
+    thumb->is_bw = info.bw;
+    thumb->is_bw_flow = info.bw_flow;
+    thumb->is_hdr = info.hdr;
+    thumb->groupid = info.groupid;
+
+    thumb->colorlabels = 0;
+    const int label_flags[] = { CPF_LABEL_RED, CPF_LABEL_YELLOW, CPF_LABEL_GREEN,
+                                CPF_LABEL_BLUE, CPF_LABEL_PURPLE };
+    for(int col = 0; col < 5; col++)
+      if(info.colorlabels & (1 << col))
+        thumb->colorlabels |= label_flags[col];
+    if(thumb->w_color)
+    {
+      GtkDarktableThumbnailBtn *btn = (GtkDarktableThumbnailBtn *)thumb->w_color;
+      btn->icon_flags = thumb->colorlabels;
+    }
+
+    thumb->is_altered = info.altered;
+    thumb->is_grouped = info.grouped;
+
+    // grouping tooltip
+    _image_update_group_tooltip(thumb);
+    return;
+  }
+
+  // fallback for images the index doesn't know about
   const dt_image_t *img = dt_image_cache_get(thumb->imgid, 'r');
   if(img)
   {
@@ -736,7 +780,15 @@ static gboolean _event_image_draw(GtkWidget *widget,
     else
     {
       cairo_surface_t *img_surf = NULL;
-      if(thumb->zoomable)
+      if(thumb->placeholder)
+      {
+        // fast scroll : paint whatever mip the cache already holds for this
+        // image and don't queue expensive generation for a position that may
+        // be scrolled past. the surface stays dirty so the full render
+        // happens once scrolling settles
+        res = dt_view_image_get_surface_cached(thumb->imgid, image_w, image_h, &img_surf);
+      }
+      else if(thumb->zoomable)
       {
         if(thumb->zoom > 1.0f)
         {
@@ -805,8 +857,10 @@ static gboolean _event_image_draw(GtkWidget *widget,
         _thumb_resize_overlays(thumb);
     }
 
-    // if we don't have the right size of the image now, we reload it again
-    if(res != DT_VIEW_SURFACE_OK)
+    // if we don't have the right size of the image now, we reload it
+    // again. in placeholder mode the redraw comes from the thumbtable
+    // once scrolling settles, so no need to retry in the meantime
+    if(res != DT_VIEW_SURFACE_OK && !thumb->placeholder)
     {
       thumb->busy = TRUE;
       if(!thumb->expose_again_timeout_id)
@@ -814,7 +868,7 @@ static gboolean _event_image_draw(GtkWidget *widget,
     }
 
     // if needed we compute and draw here the big rectangle to show focused areas
-    if(res == DT_VIEW_SURFACE_OK && thumb->display_focus)
+    if(res == DT_VIEW_SURFACE_OK && thumb->display_focus && !thumb->placeholder)
     {
       uint8_t *full_res_thumb = NULL;
       int32_t full_res_thumb_wd, full_res_thumb_ht;
@@ -824,7 +878,7 @@ static gboolean _event_image_draw(GtkWidget *widget,
       dt_image_full_path(thumb->imgid, path, sizeof(path), &from_cache);
       if(!dt_imageio_large_thumbnail(path, &full_res_thumb,
                                      &full_res_thumb_wd, &full_res_thumb_ht,
-                                     &color_space))
+                                     &color_space, 0, 0))
       {
         // we look for focus areas
         dt_focus_cluster_t full_res_focus[49];
@@ -847,7 +901,8 @@ static gboolean _event_image_draw(GtkWidget *widget,
 
 
     // here we are sure to have the right imagesurface
-    if(res == DT_VIEW_SURFACE_OK)
+    // (a placeholder stays dirty so it gets replaced by the real render)
+    if(res == DT_VIEW_SURFACE_OK && !thumb->placeholder)
     {
       thumb->img_surf_dirty = FALSE;
       thumb->busy = FALSE;
@@ -1151,16 +1206,8 @@ void dt_thumbnail_update_selection(dt_thumbnail_t *thumb)
   if(!thumb) return;
   if(!gtk_widget_is_visible(thumb->w_main)) return;
 
-  gboolean selected = FALSE;
-  /* clear and reset statements */
-  DT_DEBUG_SQLITE3_CLEAR_BINDINGS(darktable.view_manager->statements.is_selected);
-  DT_DEBUG_SQLITE3_RESET(darktable.view_manager->statements.is_selected);
-  /* bind imgid to prepared statements */
-  DT_DEBUG_SQLITE3_BIND_INT(darktable.view_manager->statements.is_selected,
-                            1, thumb->imgid);
   /* lets check if imgid is selected */
-  if(sqlite3_step(darktable.view_manager->statements.is_selected) == SQLITE_ROW)
-    selected = TRUE;
+  const gboolean selected = dt_selection_is_selected(darktable.selection, thumb->imgid);
 
   // if there's a change, update the thumb
   dt_thumbnail_set_selection(thumb, selected);
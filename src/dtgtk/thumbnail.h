@@ -154,6 +154,11 @@ typedef struct
   gboolean display_focus; // do we display rectangles to show focused part of the image
 
   gboolean busy; // should we show the busy message ?
+
+  // when set, the expose only paints a mip already in the cache and doesn't
+  // queue generation; set by the thumbtable while it scrolls fast and
+  // cleared (with a redraw) once motion settles
+  gboolean placeholder;
 } dt_thumbnail_t;
 
 dt_thumbnail_t *dt_thumbnail_new(const int width,
@@ -37,6 +37,67 @@ static void dtgtk_thumbnail_btn_init(GtkDarktableThumbnailBtn *button)
 {
 }
 
+// process-wide cache of rendered icon surfaces. the vector paint functions
+// are comparatively expensive and the very same icon at the very same
+// size/state is drawn on every cell of the thumbtable, so with the cache an
+// ordinary expose is a single blit. the key includes everything the
+// rendering depends on, so a state or styling change simply lands on
+// another entry
+static GHashTable *_icon_cache = NULL;
+
+static cairo_surface_t *_thumbnail_btn_get_icon_surface(GtkDarktableThumbnailBtn *btn,
+                                                        const int flags,
+                                                        const GtkStateFlags state,
+                                                        const GdkRGBA *fg_color,
+                                                        const GdkRGBA *bg_color,
+                                                        const GtkAllocation *allocation,
+                                                        GtkStyleContext *context)
+{
+  if(!_icon_cache)
+    _icon_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                        (GDestroyNotify)cairo_surface_destroy);
+
+  gchar *key = g_strdup_printf
+    ("%p-%x-%x-%dx%d-%.1f-%02x%02x%02x%02x-%02x%02x%02x%02x",
+     btn->icon, flags, state, allocation->width, allocation->height,
+     darktable.gui->ppd,
+     (int)(CLAMP(fg_color->red, 0.0, 1.0) * 255), (int)(CLAMP(fg_color->green, 0.0, 1.0) * 255),
+     (int)(CLAMP(fg_color->blue, 0.0, 1.0) * 255), (int)(CLAMP(fg_color->alpha, 0.0, 1.0) * 255),
+     (int)(CLAMP(bg_color->red, 0.0, 1.0) * 255), (int)(CLAMP(bg_color->green, 0.0, 1.0) * 255),
+     (int)(CLAMP(bg_color->blue, 0.0, 1.0) * 255), (int)(CLAMP(bg_color->alpha, 0.0, 1.0) * 255));
+
+  cairo_surface_t *surf = g_hash_table_lookup(_icon_cache, key);
+  if(surf)
+  {
+    g_free(key);
+    return surf;
+  }
+
+  surf = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                    allocation->width * darktable.gui->ppd,
+                                    allocation->height * darktable.gui->ppd);
+  cairo_surface_set_device_scale(surf, darktable.gui->ppd, darktable.gui->ppd);
+  cairo_t *cr = cairo_create(surf);
+  gdk_cairo_set_source_rgba(cr, (GdkRGBA *)fg_color);
+
+  GtkBorder padding;
+  gtk_style_context_get_padding(context, state, &padding);
+  // padding is a percent of the full size
+  const float icon_x = padding.left * allocation->width / 100.0f;
+  const float icon_y = padding.top * allocation->height / 100.0f;
+  const float icon_w = allocation->width - (padding.left + padding.right) * allocation->width / 100.0f;
+  const float icon_h = allocation->height - (padding.top + padding.bottom) * allocation->height / 100.0f;
+  btn->icon(cr, icon_x, icon_y, icon_w, icon_h, flags, (GdkRGBA *)bg_color);
+  cairo_destroy(cr);
+
+  // a resize or theme change can leave stale entries behind; the set of
+  // live keys is tiny so simply start over when the cache grows too big
+  if(g_hash_table_size(_icon_cache) > 250) g_hash_table_remove_all(_icon_cache);
+
+  g_hash_table_insert(_icon_cache, key, surf);
+  return surf;
+}
+
 static gboolean _thumbnail_btn_draw(GtkWidget *widget, cairo_t *cr)
 {
   g_return_val_if_fail(DTGTK_IS_THUMBNAIL_BTN(widget), FALSE);
@@ -78,16 +139,27 @@ static gboolean _thumbnail_btn_draw(GtkWidget *widget, cairo_t *cr)
     else
       flags &= ~CPF_ACTIVE;
 
-    GtkBorder padding;
-    gtk_style_context_get_padding(context, state, &padding);
-    // padding is a percent of the full size
-    const float icon_x = padding.left * allocation.width / 100.0f;
-    const float icon_y = padding.top * allocation.height / 100.0f;
-    const float icon_w = allocation.width - (padding.left + padding.right) * allocation.width / 100.0f;
-    const float icon_h = allocation.height - (padding.top + padding.bottom) * allocation.height / 100.0f;
-    DTGTK_THUMBNAIL_BTN(widget)->icon(
-        cr, icon_x, icon_y, icon_w, icon_h, flags,
-        DTGTK_THUMBNAIL_BTN(widget)->icon_data ? DTGTK_THUMBNAIL_BTN(widget)->icon_data : bg_color);
+    if(!DTGTK_THUMBNAIL_BTN(widget)->icon_data)
+    {
+      // no external paint data: the rendering only depends on what goes
+      // into the cache key, so blit the cached surface
+      cairo_surface_t *surf = _thumbnail_btn_get_icon_surface(
+          DTGTK_THUMBNAIL_BTN(widget), flags, state, fg_color, bg_color, &allocation, context);
+      cairo_set_source_surface(cr, surf, 0, 0);
+      cairo_paint(cr);
+    }
+    else
+    {
+      GtkBorder padding;
+      gtk_style_context_get_padding(context, state, &padding);
+      // padding is a percent of the full size
+      const float icon_x = padding.left * allocation.width / 100.0f;
+      const float icon_y = padding.top * allocation.height / 100.0f;
+      const float icon_w = allocation.width - (padding.left + padding.right) * allocation.width / 100.0f;
+      const float icon_h = allocation.height - (padding.top + padding.bottom) * allocation.height / 100.0f;
+      DTGTK_THUMBNAIL_BTN(widget)->icon(cr, icon_x, icon_y, icon_w, icon_h, flags,
+                                        DTGTK_THUMBNAIL_BTN(widget)->icon_data);
+    }
   }
   // and eventually the image border
   cairo_restore(cr);
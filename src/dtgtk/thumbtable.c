@@ -46,6 +46,60 @@ static void _list_remove_thumb(gpointer user_data) {
   dt_thumbnail_destroy(thumb);
 }
 
+// park a thumbnail in the spare pool instead of destroying it. Creating the full
+// widget tree of a cell is by far the most expensive part of scrolling, so we keep
+// at most one screenful of hidden spare cells ready for reuse; the visible cell
+// count only changes on resize or zoom, so that is enough to absorb any scrolling.
+static void _pool_park_thumb(dt_thumbtable_t *table, dt_thumbnail_t *thumb) {
+  if ((int)g_list_length(table->pool) >=
+      table->rows * table->thumbs_per_row) {
+    _list_remove_thumb(thumb);
+    return;
+  }
+  // drop the image surface now so the memory isn't held by invisible cells
+  dt_thumbnail_surface_destroy(thumb);
+  thumb->img_surf_preview = FALSE;
+  gtk_widget_hide(thumb->w_main);
+  table->pool = g_list_prepend(table->pool, thumb);
+}
+
+// fetch a spare thumbnail from the pool and re-purpose it for the given image.
+// returns NULL if the pool is empty and a fresh widget has to be created
+static dt_thumbnail_t *_pool_take_thumb(dt_thumbtable_t *table,
+                                        const dt_imgid_t imgid, const int rowid,
+                                        const dt_thumbnail_selection_t sel) {
+  if (!table->pool)
+    return NULL;
+  dt_thumbnail_t *thumb = table->pool->data;
+  table->pool = g_list_delete_link(table->pool, table->pool);
+  thumb->imgid = imgid;
+  thumb->rowid = rowid;
+  // the thumb may have been parked while in fast-scroll placeholder mode;
+  // left set, the flag would suppress surface refreshes forever
+  thumb->placeholder = FALSE;
+  // the table may have switched between filemanager and filmstrip since parking
+  if (table->mode == DT_THUMBTABLE_MODE_FILMSTRIP) {
+    thumb->single_click = TRUE;
+    thumb->sel_mode = DT_THUMBNAIL_SEL_MODE_MOD_ONLY;
+  } else {
+    thumb->single_click = FALSE;
+    thumb->sel_mode = DT_THUMBNAIL_SEL_MODE_NORMAL;
+  }
+  dt_thumbnail_reload_infos(thumb);
+  dt_thumbnail_resize(thumb, table->thumb_size, table->thumb_size, FALSE,
+                      IMG_TO_FIT);
+  dt_thumbnail_set_selection(thumb, sel);
+  gtk_widget_show(thumb->w_main);
+  return thumb;
+}
+
+// destroy all parked thumbnails; needed when a global change (overlays mode,
+// preferences) would leave the spare widgets stale
+static void _pool_flush(dt_thumbtable_t *table) {
+  g_list_free_full(table->pool, _list_remove_thumb);
+  table->pool = NULL;
+}
+
 // get the class name associated with the overlays mode
 static gchar *_thumbs_get_overlays_class(dt_thumbnail_overlay_t over) {
   switch (over) {
@@ -123,6 +177,8 @@ void dt_thumbtable_set_overlays_mode(dt_thumbtable_t *table,
 
   int timeout = 2;
   if (over != table->overlays) {
+    // the parked spare widgets would keep the old overlay structure, drop them
+    _pool_flush(table);
     // if the overlay change
     txt = g_strdup_printf("plugins/lighttable/overlays/%d/%d", table->mode,
                           table->prefs_size);
@@ -447,9 +503,7 @@ static int _thumbs_remove_unneeded(dt_thumbtable_t *table, GList **th_invalid) {
   int changed = 0;
   for (const GList *l = *th_invalid; l; l = g_list_next(l)) {
     dt_thumbnail_t *th = l->data;
-    gtk_container_remove(GTK_CONTAINER(gtk_widget_get_parent(th->w_main)),
-                         th->w_main);
-    dt_thumbnail_destroy(th);
+    _pool_park_thumb(table, th);
     changed++;
   }
   g_list_free(*th_invalid);
@@ -462,8 +516,20 @@ static void _thumb_move_or_create(dt_thumbtable_t *table, GList **th_invalid,
                                   const gboolean top,
                                   const dt_thumbnail_selection_t sel) {
   if (!th_invalid || *th_invalid == NULL) {
+    // try to re-purpose a parked spare widget before creating one from scratch
+    dt_thumbnail_t *thumb = _pool_take_thumb(table, imgid, rowid, sel);
+    if (thumb) {
+      thumb->x = posx;
+      thumb->y = posy;
+      gtk_layout_move(GTK_LAYOUT(table->widget), thumb->w_main, posx, posy);
+      if (top)
+        table->list = g_list_prepend(table->list, thumb);
+      else
+        table->list = g_list_append(table->list, thumb);
+      return;
+    }
     // no widgets available. We need to create one
-    dt_thumbnail_t *thumb = dt_thumbnail_new(
+    thumb = dt_thumbnail_new(
         table->thumb_size, table->thumb_size, IMG_TO_FIT, imgid, rowid,
         table->overlays, DT_THUMBNAIL_CONTAINER_LIGHTTABLE,
         table->show_tooltips, sel);
@@ -941,6 +1007,114 @@ void dt_thumbtable_zoom_changed(dt_thumbtable_t *table, const int oldzoom,
   }
 }
 
+// prefetch the thumbnails about to enter the view, reading further ahead the
+// faster the user scrolls. the requests land on the bounded system job stack
+// where newer entries supersede older ones, so prefetches from a stale scroll
+// position simply age out of the queue
+static void _thumbs_prefetch_ahead(dt_thumbtable_t *table) {
+  if (!table->list || table->mode != DT_THUMBTABLE_MODE_FILEMANAGER)
+    return;
+
+  const float velocity = table->scroll_velocity; // rows per second
+  if (velocity == 0.0f)
+    return;
+
+  // read ahead what should become visible within the next half second.
+  // at least one row, but don't flood the queue on a wild flick
+  const int nb_rows = CLAMP((int)(fabsf(velocity) * 0.5f + 1.0f), 1, 8);
+  const int nb = nb_rows * table->thumbs_per_row;
+
+  const dt_mipmap_size_t mip =
+      dt_mipmap_cache_get_matching_size(table->thumb_size, table->thumb_size);
+
+  gchar *query;
+  if (velocity > 0.0f) {
+    // scrolling down : fetch the images after the last loaded thumb
+    dt_thumbnail_t *last = g_list_last(table->list)->data;
+    query = g_strdup_printf("SELECT imgid FROM memory.collected_images"
+                            " WHERE rowid>%d ORDER BY rowid LIMIT %d",
+                            last->rowid, nb);
+  } else {
+    // scrolling up : fetch the images before the first loaded thumb
+    dt_thumbnail_t *first = table->list->data;
+    query = g_strdup_printf("SELECT imgid FROM memory.collected_images"
+                            " WHERE rowid<%d ORDER BY rowid DESC LIMIT %d",
+                            first->rowid, nb);
+  }
+  sqlite3_stmt *stmt;
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db), query, -1, &stmt,
+                              NULL);
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    const dt_imgid_t id = sqlite3_column_int(stmt, 0);
+    if (dt_is_valid_imgid(id))
+      dt_mipmap_cache_get(NULL, id, mip, DT_MIPMAP_PREFETCH, 'r');
+  }
+  g_free(query);
+  sqlite3_finalize(stmt);
+}
+
+// derive a smoothed scroll speed from successive scroll steps, in thumb
+// rows per second, signed (positive = scrolling down)
+static void _scroll_velocity_update(dt_thumbtable_t *table,
+                                    const float rows_scrolled) {
+  const double now = dt_get_wtime();
+  const double elapsed = now - table->last_scroll_time;
+  table->last_scroll_time = now;
+  if (elapsed > 0.5) {
+    // scrolling has just (re)started : assume this pace continues
+    table->scroll_velocity = rows_scrolled * 2.0f;
+  } else {
+    table->scroll_velocity = 0.6f * table->scroll_velocity +
+                             0.4f * (float)(rows_scrolled / elapsed);
+  }
+}
+
+// leave fast-scroll mode : thumbs that only painted a placeholder get their
+// full render now that the view has settled
+static gboolean _thumbs_scroll_settled(gpointer user_data) {
+  dt_thumbtable_t *table = user_data;
+  table->scroll_settle_id = 0;
+  table->fast_scroll = FALSE;
+  table->scroll_velocity = 0.0f;
+  for (GList *l = table->list; l; l = g_list_next(l)) {
+    dt_thumbnail_t *th = l->data;
+    if (th->placeholder) {
+      th->placeholder = FALSE;
+      if (th->w_image)
+        gtk_widget_queue_draw(th->w_image);
+    }
+  }
+  return FALSE;
+}
+
+// enter or re-arm fast-scroll mode when the view moves faster than full
+// renders could keep up with. thumbs without a valid surface then paint
+// cheap placeholders (whatever mip is already cached, no generation, no
+// busy spinner) until motion settles
+static void _thumbs_update_fast_scroll(dt_thumbtable_t *table) {
+  if (table->mode != DT_THUMBTABLE_MODE_FILEMANAGER)
+    return;
+
+  // rows per second above which generated mips would mostly be scrolled
+  // past before they can be shown
+  if (fabsf(table->scroll_velocity) > 3.0f) {
+    table->fast_scroll = TRUE;
+    for (GList *l = table->list; l; l = g_list_next(l)) {
+      dt_thumbnail_t *th = l->data;
+      if (!th->img_surf || th->img_surf_dirty)
+        th->placeholder = TRUE;
+    }
+  }
+
+  // (re)arm the settle timer as long as scrolling continues
+  if (table->fast_scroll) {
+    if (table->scroll_settle_id)
+      g_source_remove(table->scroll_settle_id);
+    table->scroll_settle_id =
+        g_timeout_add(200, _thumbs_scroll_settled, table);
+  }
+}
+
 static gboolean _event_scroll_compressed(gpointer user_data) {
   if (!user_data)
     return FALSE;
@@ -963,11 +1137,15 @@ static gboolean _event_scroll_compressed(gpointer user_data) {
     // half shown if scrollbar used)
     int move = table->thumb_size * delta;
 
+    // how many thumb rows this step scrolls, to feed the prefetch predictor
+    float rows_scrolled = delta;
+
     // for fractional scrolling, scroll by a number of pixels proportionate to
     // the delta (which is a float value for most touch pads and some mice)
     if (dt_conf_get_bool("thumbtable_fractional_scrolling")) {
       // scale scroll increment for an appropriate scroll speed
       delta *= 50;
+      rows_scrolled = delta / table->thumb_size;
       _move(table, 0, -delta, TRUE);
     }
     // for clicky scrolling, scroll one row of thumbnails per scroll delta
@@ -985,6 +1163,13 @@ static gboolean _event_scroll_compressed(gpointer user_data) {
       _move(table, 0, -move, TRUE);
     }
 
+    // derive a smoothed scroll speed from successive compressed events,
+    // switch to placeholder rendering if it gets too high and prefetch
+    // the thumbs we are heading towards
+    _scroll_velocity_update(table, rows_scrolled);
+    _thumbs_update_fast_scroll(table);
+    _thumbs_prefetch_ahead(table);
+
     // ensure the hovered image is the right one
     dt_thumbnail_t *th = _thumb_get_under_mouse(table);
     if (th)
@@ -1569,6 +1754,8 @@ static void _dt_pref_change_callback(gpointer instance,
 
   _thumbs_ask_for_discard(table);
 
+  // preferences may affect the widget structure of the cells, don't reuse spares
+  _pool_flush(table);
   dt_thumbtable_full_redraw(table, TRUE);
 
   for (const GList *l = table->list; l; l = g_list_next(l)) {
@@ -1730,6 +1917,17 @@ static void _dt_collection_changed_callback(
   dt_collection_history_save();
 
   if (query_change == DT_COLLECTION_CHANGE_RELOAD) {
+    // when the reload left the result set identical (same images, same
+    // order), the rowids and offsets are unchanged too and there is
+    // nothing structural to do: the thumbnails repaint their overlays
+    // through the image-info signals already
+    const dt_collection_diff_t *diff = dt_collection_get_diff();
+    if (diff->valid && !diff->moved && !diff->added && !diff->removed) {
+      dt_view_lighttable_culling_preview_refresh(darktable.view_manager);
+      dt_control_queue_redraw_center();
+      return;
+    }
+
     dt_imgid_t old_hover = dt_control_get_mouse_over_id();
     /** Here's how it works
      *
@@ -2227,8 +2425,13 @@ void dt_thumbtable_scrollbar_changed(dt_thumbtable_t *table, const float x,
     const float first_line =
         ((table->offset - 1) / table->thumbs_per_row) * table->thumb_size -
         table->thumbs_area.y;
+    const float move = first_line - y * table->thumb_size;
 
-    _move(table, 0, first_line - y * table->thumb_size, TRUE);
+    // dragging the scrollbar can jump many rows at once ; track the speed
+    // so the thumbs paint cheap placeholders while the motion is fast
+    _scroll_velocity_update(table, -move / table->thumb_size);
+    _move(table, 0, move, TRUE);
+    _thumbs_update_fast_scroll(table);
   }
 }
 
@@ -2319,8 +2522,7 @@ void dt_thumbtable_full_redraw(dt_thumbtable_t *table, const gboolean force) {
 
     // let's create a hashtable of table->list in order to speddup search in
     // next loop
-    GHashTable *htable = g_hash_table_new_full(g_int_hash, g_int_equal, NULL,
-                                               _list_remove_thumb);
+    GHashTable *htable = g_hash_table_new(g_int_hash, g_int_equal);
     for (const GList *l = table->list; l; l = g_list_next(l)) {
       dt_thumbnail_t *th = l->data;
       g_hash_table_insert(htable, &th->imgid, (gpointer)th);
@@ -2365,6 +2567,12 @@ void dt_thumbtable_full_redraw(dt_thumbtable_t *table, const gboolean force) {
 
         // if there's a change in selection, update the thumb
         dt_thumbnail_set_selection(thumb, selected);
+      } else if ((thumb = _pool_take_thumb(table, nid, nrow, selected))) {
+        // we re-purpose a parked spare widget
+        thumb->x = posx;
+        thumb->y = posy;
+        gtk_layout_move(GTK_LAYOUT(table->widget), thumb->w_main, posx, posy);
+        table->list = g_list_prepend(table->list, thumb);
       } else {
         // we create a completely new thumb
         thumb = dt_thumbnail_new(table->thumb_size, table->thumb_size,
@@ -2389,7 +2597,12 @@ void dt_thumbtable_full_redraw(dt_thumbtable_t *table, const gboolean force) {
         table->offset_imgid = nid;
     }
 
-    // clean up all remaining thumbnails
+    // park all remaining thumbnails for later reuse
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, htable);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+      _pool_park_thumb(table, (dt_thumbnail_t *)value);
     g_hash_table_destroy(htable);
     // list was built in reverse order, so un-reverse it
     table->list = g_list_reverse(table->list);
@@ -60,6 +60,10 @@ typedef struct dt_thumbtable_t
   // for zoommable, this is all the images in the row drawn at screen. We don't load laterals images on fly.
   GList *list;
 
+  // pool of spare thumbnails (dt_thumbnail_t) parked hidden inside the main widget.
+  // scrolling re-purposes these instead of destroying and recreating the full widget tree of a cell
+  GList *pool;
+
   // rowid of the main shown image inside 'memory.collected_images'
   // for filmstrip this is the image in the center.
   // for zoomable, this is the top-left image (which can be out of screen)
@@ -104,8 +108,18 @@ typedef struct dt_thumbtable_t
 
   // scroll timeout values
   guint scroll_timeout_id;
+
+  // scroll prefetch: smoothed scroll speed derived from the compressed scroll
+  // events, used to prefetch the thumbnails about to enter the view
+  double last_scroll_time;
+  float scroll_velocity; // in rows per second, signed (positive = scrolling down)
   float scroll_value;
 
+  // while the scroll velocity is high, thumbs entering the view only paint
+  // cheap placeholders; full rendering is committed once motion settles
+  gboolean fast_scroll;
+  guint scroll_settle_id; // id of the g_source settle timeout
+
   // darkroom selection from filmstrip (support for single & double click)
   guint sel_single_cb;
   dt_imgid_t to_selid;
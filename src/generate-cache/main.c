@@ -44,7 +44,60 @@
 #include "win/main_wrapper.h"
 #endif
 
-static int generate_thumbnail_cache(const dt_mipmap_size_t min_mip, const dt_mipmap_size_t max_mip, const dt_imgid_t min_imgid, const int32_t max_imgid)
+// the work queue shared by all worker threads. Workers claim the next image index atomically,
+// so no further synchronization is needed: the mipmap cache, the pixelpipe and the database
+// accesses are all safe for concurrent use from several threads (the main application exercises
+// them the same way from its job threads).
+typedef struct dt_generate_cache_job_t
+{
+  const dt_imgid_t *imgids;
+  char **filenames;
+  size_t image_count;
+  dt_mipmap_size_t min_mip;
+  dt_mipmap_size_t max_mip;
+  int next; // next image index to claim, accessed atomically
+  int done; // number of finished images, accessed atomically
+} dt_generate_cache_job_t;
+
+static gpointer _generate_worker(gpointer data)
+{
+  dt_generate_cache_job_t *job = data;
+
+  while(TRUE)
+  {
+    const int i = g_atomic_int_add(&job->next, 1);
+    if((size_t)i >= job->image_count) break;
+
+    const dt_imgid_t imgid = job->imgids[i];
+
+    for(int k = job->max_mip; k >= job->min_mip && k >= 0; k--)
+    {
+      char filename[PATH_MAX] = { 0 };
+      snprintf(filename, sizeof(filename), "%s.d/%d/%d.jpg", darktable.mipmap_cache->cachedir, k, imgid);
+
+      // if a valid thumbnail file is already on disc - do nothing
+      if(dt_util_test_image_file(filename)) continue;
+
+      // else, generate thumbnail and store in mipmap cache.
+      dt_mipmap_buffer_t buf;
+      dt_mipmap_cache_get(&buf, imgid, k, DT_MIPMAP_BLOCKING, 'r');
+      dt_mipmap_cache_release(&buf);
+    }
+
+    // and immediately write thumbs to disc and remove from mipmap cache.
+    dt_mipmap_cache_evict(imgid);
+    // thumbnail in sync with image
+    dt_history_hash_set_mipmap(imgid);
+
+    const int done = g_atomic_int_add(&job->done, 1) + 1;
+    fprintf(stderr, "image %d/%zu (%.02f%%) (id:%d, file=%s)\n", done, job->image_count,
+            100.0 * done / (float)job->image_count, imgid, job->filenames[i]);
+  }
+
+  return NULL;
+}
+
+static int generate_thumbnail_cache(const dt_mipmap_size_t min_mip, const dt_mipmap_size_t max_mip, const dt_imgid_t min_imgid, const int32_t max_imgid, const int num_workers)
 {
   fprintf(stderr, _("creating cache directories\n"));
   for(dt_mipmap_size_t k = min_mip; k <= max_mip; k++)
@@ -60,23 +113,24 @@ static int generate_thumbnail_cache(const dt_mipmap_size_t min_mip, const dt_mip
     }
   }
 
-  // some progress counter
+  // collect all images to process; sqlite statements must not be shared between threads,
+  // so the workers pull from this snapshot instead of the database
   sqlite3_stmt *stmt;
-  size_t image_count = 0, counter = 0;
+  GArray *imgids = g_array_new(FALSE, FALSE, sizeof(dt_imgid_t));
+  GPtrArray *filenames = g_ptr_array_new_with_free_func(g_free);
   DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
-                              "SELECT COUNT(*) FROM main.images WHERE id >= ?1 AND id <= ?2", -1, &stmt, 0);
+                              "SELECT id, filename FROM main.images WHERE id >= ?1 AND id <= ?2", -1, &stmt, 0);
   DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, min_imgid);
   DT_DEBUG_SQLITE3_BIND_INT(stmt, 2, max_imgid);
-  if(sqlite3_step(stmt) == SQLITE_ROW)
-  {
-    image_count = sqlite3_column_int(stmt, 0);
-    sqlite3_finalize(stmt);
-  }
-  else
+  while(sqlite3_step(stmt) == SQLITE_ROW)
   {
-    return 1;
+    const dt_imgid_t imgid = sqlite3_column_int(stmt, 0);
+    g_array_append_val(imgids, imgid);
+    g_ptr_array_add(filenames, g_strdup((const char *)sqlite3_column_text(stmt, 1)));
   }
+  sqlite3_finalize(stmt);
 
+  const size_t image_count = imgids->len;
   if(!image_count)
   {
     fprintf(stderr, _("warning: no images are matching the requested image id range\n"));
@@ -86,40 +140,26 @@ static int generate_thumbnail_cache(const dt_mipmap_size_t min_mip, const dt_mip
     }
   }
 
-  // go through all images:
-  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
-                              "SELECT id, filename FROM main.images WHERE id >= ?1 AND id <= ?2", -1, &stmt, 0);
-  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, min_imgid);
-  DT_DEBUG_SQLITE3_BIND_INT(stmt, 2, max_imgid);
-  while(sqlite3_step(stmt) == SQLITE_ROW)
-  {
-    const dt_imgid_t imgid = sqlite3_column_int(stmt, 0);
-    const char *imgfilename = (const char*)sqlite3_column_text(stmt, 1);
-
-    counter++;
-    fprintf(stderr, "image %zu/%zu (%.02f%%) (id:%d, file=%s)\n", counter, image_count, 100.0 * counter / (float)image_count, imgid, imgfilename);
-
-    for(int k = max_mip; k >= min_mip && k >= 0; k--)
-    {
-      char filename[PATH_MAX] = { 0 };
-      snprintf(filename, sizeof(filename), "%s.d/%d/%d.jpg", darktable.mipmap_cache->cachedir, k, imgid);
-
-      // if a valid thumbnail file is already on disc - do nothing
-      if(dt_util_test_image_file(filename)) continue;
-
-      // else, generate thumbnail and store in mipmap cache.
-      dt_mipmap_buffer_t buf;
-      dt_mipmap_cache_get(&buf, imgid, k, DT_MIPMAP_BLOCKING, 'r');
-      dt_mipmap_cache_release(&buf);
-    }
-
-    // and immediately write thumbs to disc and remove from mipmap cache.
-    dt_mipmap_cache_evict(imgid);
-    // thumbnail in sync with image
-    dt_history_hash_set_mipmap(imgid);
-  }
-
-  sqlite3_finalize(stmt);
+  dt_generate_cache_job_t job = { .imgids = (const dt_imgid_t *)imgids->data,
+                                  .filenames = (char **)filenames->pdata,
+                                  .image_count = image_count,
+                                  .min_mip = min_mip,
+                                  .max_mip = max_mip,
+                                  .next = 0,
+                                  .done = 0 };
+
+  const int nthreads = MAX(1, (int)MIN((size_t)num_workers, image_count));
+  fprintf(stderr, _("using %d worker threads\n"), nthreads);
+
+  GThread **workers = calloc(nthreads, sizeof(GThread *));
+  for(int t = 0; t < nthreads; t++)
+    workers[t] = g_thread_new("generate-cache", _generate_worker, &job);
+  for(int t = 0; t < nthreads; t++)
+    g_thread_join(workers[t]);
+  free(workers);
+
+  g_array_free(imgids, TRUE);
+  g_ptr_array_free(filenames, TRUE);
   fprintf(stderr, "done\n");
 
   return 0;
@@ -131,13 +171,18 @@ static void usage(const char *progname)
           "usage: %s [-h, --help; --version]\n"
           "  [--min-mip <0-8> (default = 0)] [-m, --max-mip <0-8> (default = 2)]\n"
           "  [--min-imgid <N>] [--max-imgid <N>]\n"
+          "  [-j, --workers <N> (default = automatic)]\n"
           "  [--core <darktable options>]\n"
           "\n"
           "When multiple mipmap sizes are requested, the biggest one is computed\n"
           "while the rest are quickly downsampled.\n"
           "\n"
           "The --min-imgid and --max-imgid specify the range of internal image ID\n"
-          "numbers to work on.\n",
+          "numbers to work on.\n"
+          "\n"
+          "Several images are processed in parallel; use --workers to override the\n"
+          "number of worker threads. Thumbnails already on disc are skipped, so an\n"
+          "interrupted run can simply be restarted and resumes where it stopped.\n",
           progname);
 }
 
@@ -163,6 +208,7 @@ int main(int argc, char *arg[])
   dt_mipmap_size_t max_mip = DT_MIPMAP_2;
   dt_imgid_t min_imgid = NO_IMGID;
   int32_t max_imgid = INT32_MAX;
+  int num_workers = -1;
 
   int k;
   for(k = 1; k < argc; k++)
@@ -198,6 +244,11 @@ int main(int argc, char *arg[])
       k++;
       max_imgid = (int32_t)MIN(MAX(atoi(arg[k]), 0), INT32_MAX);
     }
+    else if((!strcmp(arg[k], "-j") || !strcmp(arg[k], "--workers")) && argc > k + 1)
+    {
+      k++;
+      num_workers = MAX(atoi(arg[k]), 1);
+    }
     else if(!strcmp(arg[k], "--core"))
     {
       // everything from here on should be passed to the core
@@ -249,9 +300,13 @@ int main(int argc, char *arg[])
     exit(EXIT_FAILURE);
   }
 
+  // pick a worker count matching the available resources unless overridden on the command line
+  if(num_workers < 1)
+    num_workers = dt_worker_threads();
+
   fprintf(stderr, _("creating complete lighttable thumbnail cache\n"));
 
-  if(generate_thumbnail_cache(min_mip, max_mip, min_imgid, max_imgid))
+  if(generate_thumbnail_cache(min_mip, max_mip, min_imgid, max_imgid, num_workers))
   {
     free(m_arg);
     exit(EXIT_FAILURE);
@@ -385,6 +385,18 @@ static inline void dt_draw_curve_set_point(dt_draw_curve_t *c,
   c->c.m_anchors[num].y = y;
 }
 
+/** hash of everything that determines the sampled curve values: spline
+    type, box coordinates and the anchors in use. callers keeping a LUT
+    derived from the curve can compare this against the hash of the last
+    sampling and skip the costly resampling when nothing changed. */
+static inline dt_hash_t dt_draw_curve_hash(const dt_draw_curve_t *c)
+{
+  dt_hash_t hash = dt_hash(DT_INITHASH, &c->c.m_spline_type, sizeof(c->c.m_spline_type));
+  hash = dt_hash(hash, &c->c.m_min_x, 4 * sizeof(float));
+  hash = dt_hash(hash, &c->c.m_numAnchors, sizeof(c->c.m_numAnchors));
+  return dt_hash(hash, c->c.m_anchors, c->c.m_numAnchors * sizeof(CurveAnchorPoint));
+}
+
 static inline void dt_draw_curve_smaple_values(dt_draw_curve_t *c,
                                                const float min,
                                                const float max,
@@ -63,6 +63,11 @@ enum dt_imageio_exr_compression_t
   NUM_COMPRESSION_METHODS // number of different compression methods
 };                        // copy of Imf::Compression
 
+// scanline batch for the chunked half conversion when writing. a
+// multiple of every compression method's scanline block size, so each
+// batch compresses as full blocks on the thread pool
+#define CHUNK_ROWS 512
+
 enum dt_imageio_exr_pixeltype_t
 {
   EXR_PT_UINT = 0,  // unsigned int (32 bit)
@@ -244,37 +249,16 @@ icc_end:
   else
   {
     const size_t width = exr->global.width;
-    const size_t height = exr->global.height;
     stride = 3 * sizeof(unsigned short);
-    out_image = dt_alloc_aligned(stride * width * height);
+    /* the conversion to half runs chunked and interleaved with the
+       compression below, so a small scanline window suffices instead
+       of a second full size image buffer */
+    out_image = dt_alloc_aligned(stride * width * CHUNK_ROWS);
     if(out_image == NULL)
     {
       dt_print(DT_DEBUG_ALWAYS, "[exr export] error allocating image conversion buffer");
       return 1;
     }
-
-    DT_OMP_FOR(collapse(2))
-    for(size_t y = 0; y < height; y++)
-    {
-      for(size_t x = 0; x < width; x++)
-      {
-        const float *in_pixel = (const float *)in_tmp + 4 * ((y * width) + x);
-        unsigned short *out_pixel = (unsigned short *)out_image + 3 * ((y * width) + x);
-
-        out_pixel[0] = half(in_pixel[0]).bits();
-        out_pixel[1] = half(in_pixel[1]).bits();
-        out_pixel[2] = half(in_pixel[2]).bits();
-      }
-    }
-
-    data.insert("R", Imf::Slice(pixel_type, (char *)out_image, stride,
-                                stride * exr->global.width));
-
-    data.insert("G", Imf::Slice(pixel_type, (char *)((unsigned short *)out_image + 1), stride,
-                                stride * exr->global.width));
-
-    data.insert("B", Imf::Slice(pixel_type, (char *)((unsigned short *)out_image + 2), stride,
-                                stride * exr->global.width));
   }
 
   // add masks as additional channels
@@ -354,8 +338,52 @@ icc_end:
   // write out to file
   Imf::OutputFile file(filename, header);
 
-  file.setFrameBuffer(data);
-  file.writePixels(exr->global.height);
+  if(pixel_type == Imf::PixelType::FLOAT)
+  {
+    // the slices point straight into the pipe buffer, let the library
+    // compress all its scanline blocks on the thread pool in one go
+    file.setFrameBuffer(data);
+    file.writePixels(exr->global.height);
+  }
+  else
+  {
+    /* stream the image out in scanline chunks: convert a batch to half
+       on all cores, then hand it over for the thread pool to compress.
+       the mask slices set up above cover the full height and stay valid
+       for every batch, only the RGB window moves. */
+    const size_t width = exr->global.width;
+    const size_t height = exr->global.height;
+    for(size_t chunk_y = 0; chunk_y < height; chunk_y += CHUNK_ROWS)
+    {
+      const size_t rows = MIN(CHUNK_ROWS, height - chunk_y);
+
+      DT_OMP_FOR(collapse(2))
+      for(size_t y = 0; y < rows; y++)
+      {
+        for(size_t x = 0; x < width; x++)
+        {
+          const float *in_pixel = (const float *)in_tmp + 4 * (((chunk_y + y) * width) + x);
+          unsigned short *out_pixel = (unsigned short *)out_image + 3 * ((y * width) + x);
+
+          out_pixel[0] = half(in_pixel[0]).bits();
+          out_pixel[1] = half(in_pixel[1]).bits();
+          out_pixel[2] = half(in_pixel[2]).bits();
+        }
+      }
+
+      // slice base pointers are absolute, shift them back so the
+      // window lands on the rows just converted
+      stride = 3 * sizeof(unsigned short);
+      char *base = (char *)out_image - chunk_y * stride * width;
+
+      data.insert("R", Imf::Slice(pixel_type, base, stride, stride * width));
+      data.insert("G", Imf::Slice(pixel_type, base + sizeof(unsigned short), stride, stride * width));
+      data.insert("B", Imf::Slice(pixel_type, base + 2 * sizeof(unsigned short), stride, stride * width));
+
+      file.setFrameBuffer(data);
+      file.writePixels(rows);
+    }
+  }
 
   // clean up
   dt_free_align(out_image);
@@ -150,7 +150,11 @@ int write_image(struct dt_imageio_module_data_t *data,
 
   JxlEncoder *encoder = JxlEncoderCreate(NULL);
 
-  const uint32_t num_threads = JxlResizableParallelRunnerSuggestThreads(width, height);
+  // 0 (the default) lets libjxl suggest a thread count for the image size
+  const int conf_threads = dt_conf_get_int("plugins/imageio/format/jxl/threads");
+  const uint32_t num_threads =
+      conf_threads > 0 ? (uint32_t)conf_threads
+                       : JxlResizableParallelRunnerSuggestThreads(width, height);
   void *runner = JxlResizableParallelRunnerCreate(NULL);
   if(!runner) JXL_FAIL("could not create resizable parallel runner");
   JxlResizableParallelRunnerSetThreads(runner, num_threads);
@@ -365,48 +369,30 @@ int write_image(struct dt_imageio_module_data_t *data,
   // No more image frames nor metadata boxes to add
   JxlEncoderCloseInput(encoder);
 
-  // Write the image codestream to a buffer, starting with a chunk of 64 KiB.
-  // TODO: Can we better estimate what the optimal size of chunks is for this image?
-  size_t chunk_size = 1 << 16;
-  size_t out_len = chunk_size;
-  out_buf = g_try_malloc(out_len);
-  if(!out_buf) JXL_FAIL("could not allocate codestream buffer of size %zu", out_len);
-  uint8_t *out_cur = out_buf;
-  size_t out_avail = out_len;
+  // Stream the codestream to disk in fixed size chunks as the encoder
+  // produces it; collecting it in one buffer first can mean gigabytes
+  // of transient allocation for large images
+  out_file = g_fopen(filename, "wb");
+  if(!out_file)
+    JXL_FAIL("could not open output file `%s'", filename);
+
+  const size_t chunk_size = 1 << 20;
+  out_buf = g_try_malloc(chunk_size);
+  if(!out_buf) JXL_FAIL("could not allocate codestream buffer of size %zu", chunk_size);
 
   JxlEncoderStatus out_status = JXL_ENC_NEED_MORE_OUTPUT;
   while(out_status == JXL_ENC_NEED_MORE_OUTPUT)
   {
+    uint8_t *out_cur = out_buf;
+    size_t out_avail = chunk_size;
     out_status = JxlEncoderProcessOutput(encoder, &out_cur, &out_avail);
 
-    if(out_status == JXL_ENC_NEED_MORE_OUTPUT)
-    {
-      const size_t offset = out_cur - out_buf;
-      if(chunk_size < 1 << 20)
-        chunk_size *= 2;
-
-      out_len += chunk_size;
-      out_buf = g_realloc(out_buf, out_len);
-      if(!out_buf)
-      {
-        JXL_FAIL("could not reallocate codestream buffer to size %zu", out_len);
-        goto end;
-      }
-      out_cur = out_buf + offset;
-      out_avail = out_len - offset;
-    }
+    const size_t out_written = out_cur - out_buf;
+    if(out_written
+       && fwrite(out_buf, sizeof(uint8_t), out_written, out_file) != out_written)
+      JXL_FAIL("could not write bytes to `%s'", filename);
   }
   LIBJXL_ASSERT(out_status);
-  // Update actual length of codestream written
-  out_len = out_cur - out_buf;
-
-  // Write codestream contents to file
-  out_file = g_fopen(filename, "wb");
-  if(!out_file)
-    JXL_FAIL("could not open output file `%s'", filename);
-
-  if(fwrite(out_buf, sizeof(uint8_t), out_len, out_file) != out_len)
-    JXL_FAIL("could not write bytes to `%s'", filename);
 
   // Finally, successful write: set to success code
   ret = 0;
@@ -307,54 +307,60 @@ int write_image(dt_imageio_module_data_t *data, const char *filename, const void
     }
   }
 
-  void *image_data = NULL;
+  dt_pdf_image_t *image = NULL;
 
-  // TODO
-  // decide if we want to push that conversion step into the pdf lib and maybe do it on the fly while writing.
-  // that would get rid of one buffer in the case of ASCII_HEX
   if(d->params.mode == MODE_NORMAL)
   {
-    if(d->params.bpp == 8)
+    // pack the pixels in bands of a few rows and stream them into the
+    // pdf, so memory stays bounded instead of holding a second copy of
+    // the complete page
+    const size_t row_bytes = (size_t)3 * (d->params.bpp / 8) * data->width;
+    const int band_height = CLAMP((int)((1 << 22) / row_bytes), 1, data->height);
+    void *band = dt_alloc_aligned(row_bytes * band_height);
+    if(!band)
+      return 1;
+
+    image = dt_pdf_add_image_begin(d->pdf, d->params.global.width,
+                                   d->params.global.height, d->params.bpp, icc_id,
+                                   d->page_border);
+    gboolean success = (image != NULL);
+
+    for(int y = 0; success && y < data->height; y += band_height)
     {
-      image_data = dt_alloc_aligned((size_t)3 * data->width * data->height);
-      if(image_data)
+      const int rows = MIN(band_height, data->height - y);
+      if(d->params.bpp == 8)
       {
-        const uint8_t *in_ptr = (const uint8_t *)in;
-        uint8_t *out_ptr = (uint8_t *)image_data;
-        for(int y = 0; y < data->height; y++)
-        {
-          for(int x = 0; x < data->width; x++, in_ptr += 4, out_ptr += 3)
-            memcpy(out_ptr, in_ptr, 3);
-        }
+        const uint8_t *in_ptr = (const uint8_t *)in + (size_t)4 * y * data->width;
+        uint8_t *out_ptr = (uint8_t *)band;
+        for(size_t px = 0; px < (size_t)rows * data->width; px++, in_ptr += 4, out_ptr += 3)
+          memcpy(out_ptr, in_ptr, 3);
       }
-    }
-    else
-    {
-      image_data = dt_alloc_align_type(uint16_t, 3 * data->width * data->height);
-      if(image_data)
+      else
       {
-        const uint16_t *in_ptr = (const uint16_t *)in;
-        uint16_t *out_ptr = (uint16_t *)image_data;
-        for(int y = 0; y < data->height; y++)
+        const uint16_t *in_ptr = (const uint16_t *)in + (size_t)4 * y * data->width;
+        uint16_t *out_ptr = (uint16_t *)band;
+        for(size_t px = 0; px < (size_t)rows * data->width; px++, in_ptr += 4, out_ptr += 3)
         {
-          for(int x = 0; x < data->width; x++, in_ptr += 4, out_ptr += 3)
-          {
-            for(int c = 0; c < 3; c++)
-              out_ptr[c] = (0xff00 & (in_ptr[c] << 8)) | (in_ptr[c] >> 8);
-          }
+          for(int c = 0; c < 3; c++)
+            out_ptr[c] = (0xff00 & (in_ptr[c] << 8)) | (in_ptr[c] >> 8);
         }
       }
+      success = dt_pdf_add_image_bands(d->pdf, band, row_bytes * rows);
     }
-  }
 
-  if(!image_data)
-    return 1;
+    dt_free_align(band);
 
-  dt_pdf_image_t *image = dt_pdf_add_image(d->pdf, image_data, d->params.global.width,
-                                           d->params.global.height, d->params.bpp, icc_id,
-                                           d->page_border);
+    if(image && !dt_pdf_add_image_end(d->pdf))
+      success = FALSE;
+    if(!success)
+    {
+      free(image);
+      image = NULL;
+    }
+  }
 
-  dt_free_align(image_data);
+  if(!image)
+    return 1;
 
   d->images = g_list_append(d->images, image);
 
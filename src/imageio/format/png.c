@@ -134,6 +134,217 @@ cleanup:
 }
 #endif
 
+/* Paeth predictor as defined by the PNG specification */
+static inline int _paeth(const int a, const int b, const int c)
+{
+  const int pr = a + b - c;
+  const int pa = abs(pr - a);
+  const int pb = abs(pr - b);
+  const int pc = abs(pr - c);
+  if(pa <= pb && pa <= pc) return a;
+  if(pb <= pc) return b;
+  return c;
+}
+
+static uint64_t _filter_cost(const uint8_t *buf, const size_t rowbytes)
+{
+  uint64_t sum = 0;
+  for(size_t x = 0; x < rowbytes; x++)
+    sum += (buf[x] < 128) ? buf[x] : 256 - buf[x];
+  return sum;
+}
+
+/* Filter one packed scanline into out (including the leading filter
+   type byte), picking the filter with the minimum sum of absolute
+   differences - the same heuristic libpng uses. prev is NULL for the
+   first row. */
+static void _filter_row(const uint8_t *const cur,
+                        const uint8_t *const prev,
+                        uint8_t *const out,
+                        uint8_t *const scratch,
+                        const size_t rowbytes,
+                        const size_t bypp)
+{
+  // start out with filter type None, replace with any cheaper candidate
+  out[0] = 0;
+  memcpy(out + 1, cur, rowbytes);
+  uint64_t best = _filter_cost(cur, rowbytes);
+
+  for(int type = 1; type <= 4; type++)
+  {
+    // on the first row Up degenerates to None and Paeth to Sub
+    if(!prev && (type == 2 || type == 4)) continue;
+
+    for(size_t x = 0; x < rowbytes; x++)
+    {
+      const int a = x >= bypp ? cur[x - bypp] : 0;
+      const int b = prev ? prev[x] : 0;
+      const int c = (prev && x >= bypp) ? prev[x - bypp] : 0;
+      int pred = 0;
+      switch(type)
+      {
+        case 1: pred = a; break;
+        case 2: pred = b; break;
+        case 3: pred = (a + b) / 2; break;
+        case 4: pred = _paeth(a, b, c); break;
+      }
+      scratch[x] = (uint8_t)(cur[x] - pred);
+    }
+
+    const uint64_t cost = _filter_cost(scratch, rowbytes);
+    if(cost < best)
+    {
+      best = cost;
+      out[0] = (uint8_t)type;
+      memcpy(out + 1, scratch, rowbytes);
+    }
+  }
+}
+
+/* Filter and compress the scanlines on all cores and hand the result
+   to libpng as a series of IDAT chunks. The filtered stream is cut
+   into fixed size pieces, each deflated independently as a raw stream
+   ending on a full flush - a byte aligned block boundary without the
+   final bit set - so the concatenation forms one valid zlib stream
+   (the scheme pigz uses). Each piece primes its dictionary with the
+   preceding 32KiB of filtered data to keep the compression ratio close
+   to the serial result.
+   Returns non-zero if the caller should fall back to png_write_image;
+   nothing has been written to the file in that case. */
+static int _write_image_parallel(png_structp png_ptr,
+                                 dt_imageio_png_t *p,
+                                 const void *ivoid)
+{
+  const size_t width = p->global.width;
+  const size_t height = p->global.height;
+  const size_t bypp = (p->bpp > 8 ? 2 : 1) * 3;
+  const size_t rowbytes = width * bypp;
+  const size_t fsize = (rowbytes + 1) * height;
+
+  size_t scratchrow = 0;
+  uint8_t *packed = dt_alloc_align_type(uint8_t, rowbytes * height);
+  uint8_t *filtered = dt_alloc_align_type(uint8_t, fsize);
+  uint8_t *scratch = dt_alloc_perthread(rowbytes, sizeof(uint8_t), &scratchrow);
+
+  if(!packed || !filtered || !scratch)
+  {
+    dt_free_align(packed);
+    dt_free_align(filtered);
+    dt_free_align(scratch);
+    return 1;
+  }
+
+  /* pack XRGB/RGBX/ARGB/RGBA into RGB, 16 bit to most significant
+     byte first as required by the PNG format */
+  if(p->bpp > 8)
+  {
+    const uint16_t *const in = ivoid;
+    DT_OMP_FOR()
+    for(size_t k = 0; k < width * height; k++)
+      for(size_t ch = 0; ch < 3; ch++)
+      {
+        packed[6 * k + 2 * ch] = in[4 * k + ch] >> 8;
+        packed[6 * k + 2 * ch + 1] = in[4 * k + ch] & 0xff;
+      }
+  }
+  else
+  {
+    const uint8_t *const in = ivoid;
+    DT_OMP_FOR()
+    for(size_t k = 0; k < width * height; k++)
+      for(size_t ch = 0; ch < 3; ch++)
+        packed[3 * k + ch] = in[4 * k + ch];
+  }
+
+  DT_OMP_FOR()
+  for(size_t row = 0; row < height; row++)
+    _filter_row(packed + row * rowbytes,
+                row ? packed + (row - 1) * rowbytes : NULL,
+                filtered + row * (rowbytes + 1),
+                dt_get_perthread(scratch, scratchrow),
+                rowbytes, bypp);
+
+  dt_free_align(scratch);
+  dt_free_align(packed);
+
+  const size_t piece = 1 << 20;
+  const size_t npieces = (fsize + piece - 1) / piece;
+  uint8_t **comp = calloc(npieces, sizeof(uint8_t *));
+  size_t *csize = calloc(npieces, sizeof(size_t));
+  uLong *padler = calloc(npieces, sizeof(uLong));
+  int err = (!comp || !csize || !padler);
+
+  if(!err)
+  {
+    DT_OMP_FOR(reduction(|: err))
+    for(size_t i = 0; i < npieces; i++)
+    {
+      const size_t start = i * piece;
+      const size_t len = MIN(piece, fsize - start);
+
+      z_stream strm = { 0 };
+      if(deflateInit2(&strm, p->compression, Z_DEFLATED, -15, 8,
+                      Z_DEFAULT_STRATEGY) != Z_OK)
+      {
+        err = 1;
+        continue;
+      }
+      if(start)
+      {
+        const size_t dict = MIN((size_t)32768, start);
+        deflateSetDictionary(&strm, filtered + start - dict, dict);
+      }
+      const size_t bound = deflateBound(&strm, len) + 16;
+      comp[i] = malloc(bound);
+      if(!comp[i])
+      {
+        deflateEnd(&strm);
+        err = 1;
+        continue;
+      }
+      strm.next_in = (Bytef *)(filtered + start);
+      strm.avail_in = len;
+      strm.next_out = comp[i];
+      strm.avail_out = bound;
+      const int mode = (i == npieces - 1) ? Z_FINISH : Z_FULL_FLUSH;
+      const int res = deflate(&strm, mode);
+      if(mode == Z_FINISH ? (res != Z_STREAM_END) : (res != Z_OK))
+        err = 1;
+      csize[i] = bound - strm.avail_out;
+      padler[i] = adler32(adler32(0L, Z_NULL, 0), filtered + start, len);
+      deflateEnd(&strm);
+    }
+  }
+
+  if(!err)
+  {
+    const png_byte idat[5] = "IDAT";
+    // zlib stream header: 32KiB window, deflate method, valid check bits
+    const uint8_t zhead[2] = { 0x78, 0x01 };
+    png_write_chunk(png_ptr, idat, zhead, 2);
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for(size_t i = 0; i < npieces; i++)
+    {
+      png_write_chunk(png_ptr, idat, comp[i], csize[i]);
+      adler = adler32_combine(adler, padler[i],
+                              MIN(piece, fsize - i * piece));
+    }
+    // the checksum of the whole filtered stream closes the zlib stream
+    const uint8_t tail[4] = { (adler >> 24) & 0xff, (adler >> 16) & 0xff,
+                              (adler >> 8) & 0xff, adler & 0xff };
+    png_write_chunk(png_ptr, idat, tail, 4);
+  }
+
+  if(comp)
+    for(size_t i = 0; i < npieces; i++) free(comp[i]);
+  free(comp);
+  free(csize);
+  free(padler);
+  dt_free_align(filtered);
+  return err;
+}
+
 int write_image(dt_imageio_module_data_t *p_tmp,
                 const char *filename,
                 const void *ivoid,
@@ -308,7 +519,20 @@ int write_image(dt_imageio_module_data_t *p_tmp,
   }
 #endif
 
+  if(_write_image_parallel(png_ptr, p, ivoid) == 0)
+  {
+    // the pixel data went out as raw IDAT chunks behind libpng's back,
+    // so close the image the same way instead of png_write_end()
+    const png_byte iend[5] = "IEND";
+    png_write_chunk(png_ptr, iend, NULL, 0);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    fclose(f);
+    return 0;
+  }
+
   /*
+   * Serial libpng fallback in case the parallel writer could not get
+   * its buffers.
    * Get rid of filler (OR ALPHA) bytes, pack XRGB/RGBX/ARGB/RGBA into
    * RGB (4 channels -> 3 channels). The second parameter is not used.
    */
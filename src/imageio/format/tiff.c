@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <tiffio.h>
+#include <zlib.h>
 #ifdef HAVE_IMATH
 #include "Imath/half.h"
 #endif
@@ -64,6 +65,162 @@ typedef struct dt_imageio_tiff_gui_t
 } dt_imageio_tiff_gui_t;
 
 
+// drop the 4th channel and convert to the output sample type, exactly
+// like the scanline path in write_image() does
+static void _pack_row(const dt_imageio_tiff_t *d, const void *in_void,
+                      const int y, const int layers, void *out_row)
+{
+  if(d->bpp == 32)
+  {
+    const float *in = (const float *)in_void + (size_t)4 * y * d->global.width;
+    float *out = (float *)out_row;
+    for(int x = 0; x < d->global.width; x++, in += 4, out += layers)
+      memcpy(out, in, sizeof(float) * layers);
+  }
+#ifdef HAVE_IMATH
+  else if(d->bpp == 16 && d->pixelformat)
+  {
+    const float *in = (const float *)in_void + (size_t)4 * y * d->global.width;
+    uint16_t *out = (uint16_t *)out_row;
+    for(int x = 0; x < d->global.width; x++, in += 4, out += layers)
+      for(int l = 0; l < layers; ++l) out[l] = imath_float_to_half(in[l]);
+  }
+#endif
+  else if(d->bpp == 16)
+  {
+    const uint16_t *in = (const uint16_t *)in_void + (size_t)4 * y * d->global.width;
+    uint16_t *out = (uint16_t *)out_row;
+    for(int x = 0; x < d->global.width; x++, in += 4, out += layers)
+      memcpy(out, in, sizeof(uint16_t) * layers);
+  }
+  else // 8bpp
+  {
+    const uint8_t *in = (const uint8_t *)in_void + (size_t)4 * y * d->global.width;
+    uint8_t *out = (uint8_t *)out_row;
+    for(int x = 0; x < d->global.width; x++, in += 4, out += layers)
+      memcpy(out, in, sizeof(uint8_t) * layers);
+  }
+}
+
+// horizontal differencing as described in the TIFF specification,
+// applied per row like libtiff's predictor stage does before encoding
+static void _hor_diff(uint8_t *row, const size_t rowsize,
+                      const int layers, const int bpp)
+{
+  const size_t stride = layers;
+  if(bpp == 16)
+  {
+    uint16_t *wp = (uint16_t *)row;
+    const size_t wc = rowsize / sizeof(uint16_t);
+    for(size_t k = wc - 1; k >= stride; k--)
+      wp[k] = (uint16_t)(wp[k] - wp[k - stride]);
+#if G_BYTE_ORDER == G_BIG_ENDIAN
+    // we write a little endian file and bypass libtiff's swabbing
+    for(size_t k = 0; k < wc; k++) wp[k] = GUINT16_SWAP_LE_BE(wp[k]);
+#endif
+  }
+  else
+  {
+    for(size_t k = rowsize - 1; k >= stride; k--)
+      row[k] = (uint8_t)(row[k] - row[k - stride]);
+  }
+}
+
+// the floating point predictor: split the row into byte planes, most
+// significant plane first, then difference the resulting byte stream
+static void _fp_diff(uint8_t *row, uint8_t *scratch, const size_t rowsize,
+                     const int layers, const int bytes_per_sample)
+{
+  const size_t wc = rowsize / bytes_per_sample;
+  memcpy(scratch, row, rowsize);
+  for(size_t count = 0; count < wc; count++)
+    for(int b = 0; b < bytes_per_sample; b++)
+#if G_BYTE_ORDER == G_BIG_ENDIAN
+      row[b * wc + count] = scratch[bytes_per_sample * count + b];
+#else
+      row[(size_t)(bytes_per_sample - b - 1) * wc + count]
+          = scratch[(size_t)bytes_per_sample * count + b];
+#endif
+  const size_t stride = layers;
+  for(size_t k = rowsize - 1; k >= stride; k--)
+    row[k] = (uint8_t)(row[k] - row[k - stride]);
+}
+
+// deflate independent strips on the OpenMP pool and hand the finished
+// codestreams to libtiff in order, instead of feeding every scanline
+// through its single compression stream
+static int _write_compressed_strips(TIFF *tif, const dt_imageio_tiff_t *d,
+                                    const void *in_void, const int layers,
+                                    const size_t rowsize,
+                                    const uint32_t rowsperstrip,
+                                    const uint16_t predictor)
+{
+  const uint32_t nstrips = (d->global.height + rowsperstrip - 1) / rowsperstrip;
+  uint8_t **zbuf = calloc(nstrips, sizeof(uint8_t *));
+  size_t *zlen = calloc(nstrips, sizeof(size_t));
+  gboolean error = (!zbuf || !zlen);
+
+  if(!error)
+  {
+    DT_OMP_FOR(shared(error))
+    for(uint32_t strip = 0; strip < nstrips; strip++)
+    {
+      if(error) continue;
+      const uint32_t firstrow = strip * rowsperstrip;
+      const uint32_t rows = MIN(rowsperstrip, (uint32_t)d->global.height - firstrow);
+      const size_t stripsize = rowsize * rows;
+      const uLong bound = compressBound(stripsize);
+      uint8_t *raw = malloc(stripsize);
+      uint8_t *packed = malloc(bound);
+      uint8_t *scratch = (predictor == PREDICTOR_FLOATINGPOINT)
+                           ? malloc(rowsize)
+                           : NULL;
+      if(!raw || !packed || (predictor == PREDICTOR_FLOATINGPOINT && !scratch))
+      {
+        error = TRUE;
+        free(packed);
+      }
+      else
+      {
+        for(uint32_t r = 0; r < rows; r++)
+        {
+          uint8_t *row = raw + (size_t)r * rowsize;
+          _pack_row(d, in_void, firstrow + r, layers, row);
+          if(predictor == PREDICTOR_HORIZONTAL)
+            _hor_diff(row, rowsize, layers, d->bpp);
+          else if(predictor == PREDICTOR_FLOATINGPOINT)
+            _fp_diff(row, scratch, rowsize, layers, d->bpp / 8);
+        }
+        uLongf len = bound;
+        if(compress2(packed, &len, raw, stripsize, d->compresslevel) != Z_OK)
+        {
+          error = TRUE;
+          free(packed);
+        }
+        else
+        {
+          zbuf[strip] = packed;
+          zlen[strip] = len;
+        }
+      }
+      free(raw);
+      free(scratch);
+    }
+  }
+
+  int rc = error ? 1 : 0;
+  for(uint32_t strip = 0; zbuf && strip < nstrips; strip++)
+  {
+    if(rc == 0
+       && TIFFWriteRawStrip(tif, strip, zbuf[strip], zlen[strip]) == -1)
+      rc = 1;
+    free(zbuf[strip]);
+  }
+  free(zbuf);
+  free(zlen);
+  return rc;
+}
+
 int write_image(dt_imageio_module_data_t *d_tmp, const char *filename, const void *in_void,
                 dt_colorspaces_color_profile_type_t over_type, const char *over_filename,
                 void *exif, int exif_len, dt_imgid_t imgid, int num, int total, dt_dev_pixelpipe_t *pipe,
@@ -240,7 +397,8 @@ int write_image(dt_imageio_module_data_t *d_tmp, const char *filename, const voi
 
   TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
   TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-  TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, 0));
+  const uint32_t rowsperstrip = TIFFDefaultStripSize(tif, 0);
+  TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsperstrip);
 
   const int resolution = dt_conf_get_int("metadata/resolution");
   TIFFSetField(tif, TIFFTAG_XRESOLUTION, (float)resolution);
@@ -254,7 +412,20 @@ int write_image(dt_imageio_module_data_t *d_tmp, const char *filename, const voi
     goto exit;
   }
 
-  if(d->bpp == 32)
+  if(d->compress)
+  {
+    // deflate is by far the most expensive part of a compressed export,
+    // compress the strips in parallel and write the results in order
+    uint16_t predictor = PREDICTOR_NONE;
+    TIFFGetField(tif, TIFFTAG_PREDICTOR, &predictor);
+    if(_write_compressed_strips(tif, d, in_void, layers, rowsize,
+                                rowsperstrip, predictor))
+    {
+      rc = 1;
+      goto exit;
+    }
+  }
+  else if(d->bpp == 32)
   {
     for(int y = 0; y < d->global.height; y++)
     {
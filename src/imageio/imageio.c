@@ -24,6 +24,7 @@
 #include "common/image_cache.h"
 #include "common/mipmap_cache.h"
 #include "common/styles.h"
+#include "common/trace.h"
 #include "control/conf.h"
 #include "control/control.h"
 #include "develop/blend.h"
@@ -83,6 +84,7 @@
 #endif
 
 #include <assert.h>
+#include <fcntl.h>
 #include <glib/gstdio.h>
 #include <inttypes.h>
 #include <math.h>
@@ -90,6 +92,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <unistd.h>
 
 #ifdef USE_LUA
 #include "lua/image.h"
@@ -656,7 +659,9 @@ gboolean dt_imageio_large_thumbnail(const char *filename,
                                     uint8_t **buffer,
                                     int32_t *width,
                                     int32_t *height,
-                                    dt_colorspaces_color_profile_type_t *color_space)
+                                    dt_colorspaces_color_profile_type_t *color_space,
+                                    const int max_width,
+                                    const int max_height)
 {
   int res = TRUE;
 
@@ -665,8 +670,21 @@ gboolean dt_imageio_large_thumbnail(const char *filename,
   size_t bufsize;
 
   // get the biggest thumb from exif
-  if(dt_exif_get_thumbnail(filename, &buf, &bufsize, &mime_type))
+  if(dt_exif_get_thumbnail(filename, &buf, &bufsize, &mime_type, NULL))
+  {
+#ifdef HAVE_LIBHEIF
+    // HEIF/AVIF files usually carry a dedicated thumbnail image item
+    // that exiv2 does not expose; decoding that is far cheaper than
+    // pushing the full-size image through the pixelpipe
+    if(!dt_imageio_heif_read_thumbnail(filename, buffer, width, height))
+    {
+      // like the embedded previews below we have to assume sRGB
+      *color_space = DT_COLORSPACE_SRGB;
+      return FALSE;
+    }
+#endif
     goto error;
+  }
 
   if(strcmp(mime_type, "image/jpeg") == 0)
   {
@@ -675,6 +693,10 @@ gboolean dt_imageio_large_thumbnail(const char *filename,
     if(dt_imageio_jpeg_decompress_header(buf, bufsize, &jpg))
       goto error;
 
+    // when the caller only needs a small mip, let libjpeg decode
+    // directly at a fraction of the coded size
+    dt_imageio_jpeg_scale_to_fit(&jpg, max_width, max_height);
+
     *buffer = dt_alloc_align_uint8(4 * jpg.width * jpg.height);
     if(!*buffer) goto error;
 
@@ -829,7 +851,7 @@ gboolean dt_imageio_has_mono_preview(const char *filename)
   gboolean mono = FALSE;
 
   if(dt_imageio_large_thumbnail(filename, &tmp, &thumb_width,
-                                &thumb_height, &color_space))
+                                &thumb_height, &color_space, 0, 0))
     goto cleanup;
   if((thumb_width < 32) || (thumb_height < 32) || (tmp == NULL))
     goto cleanup;
@@ -1014,12 +1036,16 @@ gboolean dt_imageio_export(const dt_imgid_t imgid,
                                export_masks)) != 0;
   else
   {
-    return dt_imageio_export_with_flags(imgid, filename, format, format_params,
-                                        FALSE, FALSE, high_quality, upscale,
-                                        is_scaling, scale_factor, FALSE, NULL, copy_metadata,
-                                        export_masks, icc_type, icc_filename,
-                                        icc_intent, storage, storage_params,
-                                        num, total, metadata, -1);
+    const double trace_start = dt_trace_begin();
+    const gboolean res =
+      dt_imageio_export_with_flags(imgid, filename, format, format_params,
+                                   FALSE, FALSE, high_quality, upscale,
+                                   is_scaling, scale_factor, FALSE, NULL, copy_metadata,
+                                   export_masks, icc_type, icc_filename,
+                                   icc_intent, storage, storage_params,
+                                   num, total, metadata, -1);
+    dt_trace_end("io", trace_start, "export ID=%d to `%s'", imgid, filename);
+    return res;
   }
 }
 
@@ -1040,6 +1066,187 @@ static double _get_pipescale(dt_dev_pixelpipe_t *pipe,
   return fmin(scalex, scaley);
 }
 
+// per-thread cache of the last fully configured export pipe so batch
+// exports over images sharing one processing stack - timelapse and
+// burst sequences - skip module loading, history replay and pipe node
+// setup for all but the first image.
+typedef struct dt_imageio_export_cache_t
+{
+  dt_hash_t signature;
+  dt_develop_t *dev;
+  dt_dev_pixelpipe_t *pipe;
+} dt_imageio_export_cache_t;
+
+static __thread dt_imageio_export_cache_t _export_cache = { 0 };
+
+static void _export_cache_drop(void)
+{
+  if(_export_cache.pipe)
+  {
+    dt_dev_pixelpipe_cleanup(_export_cache.pipe);
+    g_free(_export_cache.pipe);
+  }
+  if(_export_cache.dev)
+  {
+    dt_dev_cleanup(_export_cache.dev);
+    g_free(_export_cache.dev);
+  }
+  memset(&_export_cache, 0, sizeof(_export_cache));
+}
+
+void dt_imageio_export_cleanup(void)
+{
+  _export_cache_drop();
+}
+
+// A signature of everything determining the configured export pipe for
+// an image.  Note that we can't reuse the history hash from
+// common/history.c here: it deliberately skips disabled entries and
+// drawn masks, both of which change the replayed stack.  Per-frame data
+// like filename, timestamps, geolocation or database ids stay out so
+// consecutive frames of a sequence hash alike.
+static dt_hash_t _export_setup_signature(const dt_imgid_t imgid,
+                                         const int history_end,
+                                         dt_imageio_module_format_t *format,
+                                         dt_imageio_module_data_t *format_params,
+                                         const dt_mipmap_buffer_t *buf,
+                                         const char *filter,
+                                         const gboolean export_masks,
+                                         const dt_colorspaces_color_profile_type_t icc_type,
+                                         const gchar *icc_filename,
+                                         const dt_iop_color_intent_t icc_intent)
+{
+  dt_hash_t hash = DT_INITHASH;
+  sqlite3_stmt *stmt;
+
+  // the complete history stack, disabled entries included
+  // clang-format off
+  DT_DEBUG_SQLITE3_PREPARE_V2
+    (dt_database_get(darktable.db),
+     "SELECT num, module, operation, op_params, enabled,"
+     "       blendop_params, blendop_version, multi_priority, multi_name"
+     " FROM main.history"
+     " WHERE imgid = ?1"
+     " ORDER BY num",
+     -1, &stmt, NULL);
+  // clang-format on
+  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, imgid);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    for(int col = 0; col < 9; col++)
+    {
+      const int len = sqlite3_column_bytes(stmt, col);
+      hash = dt_hash(hash, &len, sizeof(len));
+      const void *data = sqlite3_column_blob(stmt, col);
+      if(data) hash = dt_hash(hash, data, len);
+    }
+  }
+  sqlite3_finalize(stmt);
+
+  // drawn masks feed the blend params but live in their own table
+  // clang-format off
+  DT_DEBUG_SQLITE3_PREPARE_V2
+    (dt_database_get(darktable.db),
+     "SELECT num, formid, form, name, version, points, points_count, source"
+     " FROM main.masks_history"
+     " WHERE imgid = ?1"
+     " ORDER BY num, formid",
+     -1, &stmt, NULL);
+  // clang-format on
+  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, imgid);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    for(int col = 0; col < 8; col++)
+    {
+      const int len = sqlite3_column_bytes(stmt, col);
+      hash = dt_hash(hash, &len, sizeof(len));
+      const void *data = sqlite3_column_blob(stmt, col);
+      if(data) hash = dt_hash(hash, data, len);
+    }
+  }
+  sqlite3_finalize(stmt);
+
+  // module order
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                              "SELECT version, iop_list"
+                              " FROM main.module_order"
+                              " WHERE imgid = ?1",
+                              -1, &stmt, NULL);
+  DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, imgid);
+  if(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    for(int col = 0; col < 2; col++)
+    {
+      const int len = sqlite3_column_bytes(stmt, col);
+      hash = dt_hash(hash, &len, sizeof(len));
+      const void *data = sqlite3_column_blob(stmt, col);
+      if(data) hash = dt_hash(hash, data, len);
+    }
+  }
+  sqlite3_finalize(stmt);
+
+  // the part of the stack that is actually replayed
+  int end = history_end;
+  if(end == -1)
+  {
+    DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db),
+                                "SELECT history_end FROM main.images WHERE id = ?1",
+                                -1, &stmt, NULL);
+    DT_DEBUG_SQLITE3_BIND_INT(stmt, 1, imgid);
+    if(sqlite3_step(stmt) == SQLITE_ROW)
+      end = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+  }
+  hash = dt_hash(hash, &end, sizeof(end));
+
+  // processing-relevant image characteristics
+  const dt_image_t *img = dt_image_cache_get(imgid, 'r');
+  if(!img) return 0;
+  hash = dt_hash(hash, &img->exif_inited,
+                 offsetof(dt_image_t, exif_datetime_taken) - offsetof(dt_image_t, exif_inited));
+  hash = dt_hash(hash, &img->exif_correction_type,
+                 offsetof(dt_image_t, filename) - offsetof(dt_image_t, exif_correction_type));
+  hash = dt_hash(hash, &img->width,
+                 offsetof(dt_image_t, num) - offsetof(dt_image_t, width));
+  const int32_t flags = img->flags
+    & (DT_IMAGE_LDR | DT_IMAGE_RAW | DT_IMAGE_HDR
+       | DT_IMAGE_AUTO_PRESETS_APPLIED | DT_IMAGE_NO_LEGACY_PRESETS
+       | DT_IMAGE_4BAYER | DT_IMAGE_MONOCHROME | DT_IMAGE_S_RAW
+       | DT_IMAGE_MONOCHROME_PREVIEW | DT_IMAGE_MONOCHROME_BAYER
+       | DT_IMAGE_MONOCHROME_WORKFLOW);
+  hash = dt_hash(hash, &flags, sizeof(flags));
+  hash = dt_hash(hash, &img->buf_dsc,
+                 offsetof(dt_image_t, profile) - offsetof(dt_image_t, buf_dsc));
+  if(img->profile)
+    hash = dt_hash(hash, img->profile, img->profile_size);
+  hash = dt_hash(hash, &img->colorspace,
+                 offsetof(dt_image_t, geoloc) - offsetof(dt_image_t, colorspace));
+  hash = dt_hash(hash, &img->raw_black_level,
+                 offsetof(dt_image_t, dng_opcode_list2) - offsetof(dt_image_t, raw_black_level));
+  if(img->dng_opcode_list2)
+    hash = dt_hash(hash, img->dng_opcode_list2, img->dng_opcode_list2_size);
+  dt_image_cache_read_release(img);
+
+  // export options baked into the pipe at synch time
+  const int levels = format->levels(format_params);
+  hash = dt_hash(hash, &levels, sizeof(levels));
+  hash = dt_hash(hash, &export_masks, sizeof(export_masks));
+  hash = dt_hash(hash, &icc_type, sizeof(icc_type));
+  hash = dt_hash(hash, &icc_intent, sizeof(icc_intent));
+  if(icc_filename)
+    hash = dt_hash(hash, icc_filename, strlen(icc_filename));
+  if(filter)
+    hash = dt_hash(hash, filter, strlen(filter));
+  hash = dt_hash(hash, format_params->style, sizeof(format_params->style));
+  hash = dt_hash(hash, &format_params->style_append, sizeof(format_params->style_append));
+  hash = dt_hash(hash, &buf->width, sizeof(buf->width));
+  hash = dt_hash(hash, &buf->height, sizeof(buf->height));
+  hash = dt_hash(hash, &buf->iscale, sizeof(buf->iscale));
+
+  // zero doubles as "no signature"
+  return hash ? hash : (dt_hash_t)1;
+}
+
 // internal function: to avoid exif blob reading + 8-bit byteorder
 // flag + high-quality override
 gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
@@ -1066,138 +1273,187 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
                                       dt_export_metadata_t *metadata,
                                       const int history_end)
 {
-  dt_develop_t dev;
-  dt_dev_init(&dev, FALSE);
-  dt_dev_load_image(&dev, imgid);
-  if(history_end != -1)
-    dt_dev_pop_history_items_ext(&dev, history_end);
-
   if(!thumbnail_export)
     dt_set_backthumb_time(600.0); // make sure we don't interfere
 
   dt_mipmap_buffer_t buf;
   dt_mipmap_cache_get(&buf, imgid, DT_MIPMAP_FULL, DT_MIPMAP_BLOCKING, 'r');
 
-  const dt_image_t *img = &dev.image_storage;
-
   if(!buf.buf || !buf.width || !buf.height)
   {
-    if(img->load_status == DT_IMAGEIO_FILE_NOT_FOUND)
-      dt_control_log(_("image `%s' is not available!"), img->filename);
-    else if(img->load_status == DT_IMAGEIO_LOAD_FAILED
-            || img->load_status == DT_IMAGEIO_IOERROR
-            || img->load_status == DT_IMAGEIO_CACHE_FULL)
+    const dt_image_t *img = dt_image_cache_get(imgid, 'r');
+    if(img)
     {
-      dt_print(DT_DEBUG_ALWAYS,
-               "[dt_imageio_export_with_flags] mipmap allocation for `%s' failed (status %d)",
-               filename,img->load_status);
-      dt_control_log(_("unable to load image `%s'!"), img->filename);
+      if(img->load_status == DT_IMAGEIO_FILE_NOT_FOUND)
+        dt_control_log(_("image `%s' is not available!"), img->filename);
+      else if(img->load_status == DT_IMAGEIO_LOAD_FAILED
+              || img->load_status == DT_IMAGEIO_IOERROR
+              || img->load_status == DT_IMAGEIO_CACHE_FULL)
+      {
+        dt_print(DT_DEBUG_ALWAYS,
+                 "[dt_imageio_export_with_flags] mipmap allocation for `%s' failed (status %d)",
+                 filename,img->load_status);
+        dt_control_log(_("unable to load image `%s'!"), img->filename);
+      }
+      else
+        dt_control_log(_("image '%s' not supported"), img->filename);
+      dt_image_cache_read_release(img);
     }
-    else
-      dt_control_log(_("image '%s' not supported"), img->filename);
-    goto error_early;
+    dt_mipmap_cache_release(&buf);
+    if(!thumbnail_export)
+      dt_set_backthumb_time(5.0);
+    return TRUE;
   }
 
-  const int wd = img->width;
-  const int ht = img->height;
+  // for batch exports we try to keep the configured pipe of the
+  // previous image on this thread around, a zero signature disables
+  // the cache
+  const dt_hash_t signature = (!thumbnail_export && total > 1)
+    ? _export_setup_signature(imgid, history_end, format, format_params,
+                              &buf, filter, export_masks,
+                              icc_type, icc_filename, icc_intent)
+    : 0;
 
   dt_times_t start;
   dt_get_perf_times(&start);
-  dt_dev_pixelpipe_t pipe;
-  gboolean res = thumbnail_export
-    ? dt_dev_pixelpipe_init_thumbnail(&pipe, wd, ht)
-    : dt_dev_pixelpipe_init_export(&pipe, wd, ht,
-                                   format->levels(format_params), export_masks);
-  if(!res)
-  {
-    dt_control_log(
-      _("failed to allocate memory for %s, please lower the threads used"
-        " for export or buy more memory."),
-      thumbnail_export ? C_("noun", "thumbnail export") : C_("noun", "export"));
-    goto error;
-  }
 
-  const int final_history_end = history_end == -1 ? dev.history_end : history_end;
+  dt_develop_t *dev = NULL;
+  dt_dev_pixelpipe_t *pipe = NULL;
+  gboolean res = TRUE;
+
   const gboolean use_style = !thumbnail_export && format_params->style[0] != '\0';
   const gboolean appending = format_params->style_append != FALSE;
-  //  If a style is to be applied during export, add the iop params into the history
-  if(use_style)
+
+  if(signature && signature == _export_cache.signature)
   {
-    GList *style_items = dt_styles_get_item_list(format_params->style, FALSE, -1, TRUE);
-    if(!style_items)
+    // take ownership so the error path can't free a pipe we would
+    // hand out again
+    dev = _export_cache.dev;
+    pipe = _export_cache.pipe;
+    memset(&_export_cache, 0, sizeof(_export_cache));
+
+    // refresh the image metadata read at process time, the
+    // processing-relevant parts are identical by signature
+    const dt_image_t *image = dt_image_cache_get(imgid, 'r');
+    if(image)
     {
-      dt_print(DT_DEBUG_ALWAYS,
-               "[imageio] cannot find the style '%s' to apply during export",
-               format_params->style);
-      if(darktable.gui)
-        dt_control_log(_("cannot find the style '%s' to apply during export"),
-                       format_params->style);
-      else
-        dt_print(DT_DEBUG_ALWAYS,
-                 "[imageio] please check that you have imported this style into darktable"
-                 " and specified it in the command line without the .dtstyle extension\n");
+      dev->image_storage = *image;
+      dt_image_cache_read_release(image);
+    }
+    dt_dev_pixelpipe_set_input(pipe, dev, (float *)buf.buf,
+                               buf.width, buf.height, buf.iscale);
+    dt_dev_pixelpipe_cache_flush(pipe);
+    dt_print(DT_DEBUG_IMAGEIO,
+             "[dt_imageio_export_with_flags] reusing export pixelpipe for imgid %d",
+             imgid);
+  }
+  else
+  {
+    _export_cache_drop();
+
+    dev = g_malloc0(sizeof(dt_develop_t));
+    dt_dev_init(dev, FALSE);
+    dt_dev_load_image(dev, imgid);
+    if(history_end != -1)
+      dt_dev_pop_history_items_ext(dev, history_end);
+
+    const int wd = dev->image_storage.width;
+    const int ht = dev->image_storage.height;
+
+    pipe = g_malloc0(sizeof(dt_dev_pixelpipe_t));
+    res = thumbnail_export
+      ? dt_dev_pixelpipe_init_thumbnail(pipe, wd, ht)
+      : dt_dev_pixelpipe_init_export(pipe, wd, ht,
+                                     format->levels(format_params), export_masks);
+    if(!res)
+    {
+      dt_control_log(
+        _("failed to allocate memory for %s, please lower the threads used"
+          " for export or buy more memory."),
+        thumbnail_export ? C_("noun", "thumbnail export") : C_("noun", "export"));
       goto error;
     }
 
-    GList *modules_used = NULL;
+    const int final_history_end = history_end == -1 ? dev->history_end : history_end;
+    //  If a style is to be applied during export, add the iop params into the history
+    if(use_style)
+    {
+      GList *style_items = dt_styles_get_item_list(format_params->style, FALSE, -1, TRUE);
+      if(!style_items)
+      {
+        dt_print(DT_DEBUG_ALWAYS,
+                 "[imageio] cannot find the style '%s' to apply during export",
+                 format_params->style);
+        if(darktable.gui)
+          dt_control_log(_("cannot find the style '%s' to apply during export"),
+                         format_params->style);
+        else
+          dt_print(DT_DEBUG_ALWAYS,
+                   "[imageio] please check that you have imported this style into darktable"
+                   " and specified it in the command line without the .dtstyle extension\n");
+        goto error;
+      }
 
-    if(!appending) dt_dev_pop_history_items_ext(&dev, 0);
+      GList *modules_used = NULL;
 
-    dt_ioppr_update_for_style_items(&dev, style_items, appending);
+      if(!appending) dt_dev_pop_history_items_ext(dev, 0);
 
-    for(GList *st_items = style_items; st_items; st_items = g_list_next(st_items))
-    {
-      dt_style_item_t *st_item = st_items->data;
-      gboolean ok = TRUE;
-      gboolean autoinit = FALSE;
+      dt_ioppr_update_for_style_items(dev, style_items, appending);
 
-      /* check for auto-init module */
-      if(st_item->params_size == 0)
+      for(GList *st_items = style_items; st_items; st_items = g_list_next(st_items))
       {
-        // get iop for this operation as we need the corresponding
-        // default parameters
-        const dt_iop_module_t *module =
-          dt_iop_get_module_from_list(dev.iop, st_item->operation);
-        if(module)
+        dt_style_item_t *st_item = st_items->data;
+        gboolean ok = TRUE;
+        gboolean autoinit = FALSE;
+
+        /* check for auto-init module */
+        if(st_item->params_size == 0)
         {
-          st_item->params_size = module->params_size;
-          st_item->params = (dt_iop_params_t *)malloc(st_item->params_size);
-          memcpy(st_item->params, module->default_params, module->params_size);
-          autoinit = TRUE;
+          // get iop for this operation as we need the corresponding
+          // default parameters
+          const dt_iop_module_t *module =
+            dt_iop_get_module_from_list(dev->iop, st_item->operation);
+          if(module)
+          {
+            st_item->params_size = module->params_size;
+            st_item->params = (dt_iop_params_t *)malloc(st_item->params_size);
+            memcpy(st_item->params, module->default_params, module->params_size);
+            autoinit = TRUE;
+          }
+          else
+          {
+            dt_print(DT_DEBUG_ALWAYS,
+                    "[dt_imageio_export_with_flags] cannot find module %s for style",
+                    st_item->operation);
+            ok = FALSE;
+          }
         }
-        else
+
+        if(ok)
         {
-          dt_print(DT_DEBUG_ALWAYS,
-                  "[dt_imageio_export_with_flags] cannot find module %s for style",
-                  st_item->operation);
-          ok = FALSE;
+          dt_styles_apply_style_item(dev, st_item, &modules_used, !autoinit && appending);
         }
       }
 
-      if(ok)
-      {
-        dt_styles_apply_style_item(&dev, st_item, &modules_used, !autoinit && appending);
-      }
+      g_list_free(modules_used);
+      g_list_free_full(style_items, dt_style_item_free);
     }
+    else if(history_end != -1)
+      dt_dev_pop_history_items_ext(dev, final_history_end);
 
-    g_list_free(modules_used);
-    g_list_free_full(style_items, dt_style_item_free);
-  }
-  else if(history_end != -1)
-    dt_dev_pop_history_items_ext(&dev, final_history_end);
-
-  dt_ioppr_resync_modules_order(&dev);
+    dt_ioppr_resync_modules_order(dev);
 
-  dt_dev_pixelpipe_set_icc(&pipe, icc_type, icc_filename, icc_intent);
-  dt_dev_pixelpipe_set_input(&pipe, &dev, (float *)buf.buf,
-                             buf.width, buf.height, buf.iscale);
-  dt_dev_pixelpipe_create_nodes(&pipe, &dev);
-  dt_dev_pixelpipe_synch_all(&pipe, &dev);
+    dt_dev_pixelpipe_set_icc(pipe, icc_type, icc_filename, icc_intent);
+    dt_dev_pixelpipe_set_input(pipe, dev, (float *)buf.buf,
+                               buf.width, buf.height, buf.iscale);
+    dt_dev_pixelpipe_create_nodes(pipe, dev);
+    dt_dev_pixelpipe_synch_all(pipe, dev);
+  }
 
   if(darktable.unmuted & DT_DEBUG_IMAGEIO)
   {
     char mbuf[2048] = { 0 };
-    for(GList *nodes = pipe.nodes; nodes; nodes = g_list_next(nodes))
+    for(GList *nodes = pipe->nodes; nodes; nodes = g_list_next(nodes))
     {
       dt_dev_pixelpipe_iop_t *piece = nodes->data;
       if(piece->enabled)
@@ -1221,14 +1477,14 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
   if(filter)
   {
     if(!strncmp(filter, "pre:", 4))
-      dt_dev_pixelpipe_disable_after(&pipe, filter + 4);
+      dt_dev_pixelpipe_disable_after(pipe, filter + 4);
     if(!strncmp(filter, "post:", 5))
-      dt_dev_pixelpipe_disable_before(&pipe, filter + 5);
+      dt_dev_pixelpipe_disable_before(pipe, filter + 5);
   }
 
-  dt_dev_pixelpipe_get_dimensions(&pipe, &dev, pipe.iwidth, pipe.iheight,
-                                  &pipe.processed_width,
-                                  &pipe.processed_height);
+  dt_dev_pixelpipe_get_dimensions(pipe, dev, pipe->iwidth, pipe->iheight,
+                                  &pipe->processed_width,
+                                  &pipe->processed_height);
 
   dt_show_times(&start, "[export] creating pixelpipe");
 
@@ -1238,7 +1494,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
   else if(icc_type == DT_COLORSPACE_NONE)
   {
     dt_iop_module_t *colorout = NULL;
-    for(GList *modules = dev.iop; modules; modules = g_list_next(modules))
+    for(GList *modules = dev->iop; modules; modules = g_list_next(modules))
     {
       colorout = (dt_iop_module_t *)modules->data;
       if(colorout->get_p && strcmp(colorout->op, "colorout") == 0)
@@ -1261,27 +1517,27 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
 
   if(!thumbnail_export && width == 0 && height == 0)
   {
-    width = pipe.processed_width;
-    height = pipe.processed_height;
+    width = pipe->processed_width;
+    height = pipe->processed_height;
   }
 
   // note: not perfect but a reasonable good guess looking at overall pixelpipe requirements
   // and specific stuff in finalscale.
   const double max_possible_scale = fmin(100.0, fmax(1.0, // keep maximum allowed scale as we had in 4.6
-      (double)dt_get_available_pipe_mem(&pipe) / (double)(1 + 64 * sizeof(float) * pipe.processed_width * pipe.processed_height)));
+      (double)dt_get_available_pipe_mem(pipe) / (double)(1 + 64 * sizeof(float) * pipe->processed_width * pipe->processed_height)));
 
   const gboolean doscale = upscale && ((width > 0 || height > 0) || is_scaling);
   const double max_scale = doscale ? max_possible_scale : 1.00;
 
-  double scale = _get_pipescale(&pipe, width, height, max_scale);
+  double scale = _get_pipescale(pipe, width, height, max_scale);
   float origin[2] = { 0.0f, 0.0f };
 
-  if(dt_dev_distort_backtransform_plus(&dev, &pipe, 0.0,
+  if(dt_dev_distort_backtransform_plus(dev, pipe, 0.0,
                                        DT_DEV_TRANSFORM_DIR_ALL, origin, 1))
   {
-    if(width == 0) width = pipe.processed_width;
-    if(height == 0) height = pipe.processed_height;
-    scale = _get_pipescale(&pipe, width, height, max_scale);
+    if(width == 0) width = pipe->processed_width;
+    if(height == 0) height = pipe->processed_height;
+    scale = _get_pipescale(pipe, width, height, max_scale);
 
     if(is_scaling)
     {
@@ -1292,15 +1548,15 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
     }
   }
 
-  const int processed_width = floor(scale * pipe.processed_width);
-  const int processed_height = floor(scale * pipe.processed_height);
+  const int processed_width = floor(scale * pipe->processed_width);
+  const int processed_height = floor(scale * pipe->processed_height);
   const gboolean size_warning = processed_width < 1 || processed_height < 1;
   dt_print(DT_DEBUG_IMAGEIO,
            "[dt_imageio_export] %s%s imgid %d, %ix%i --> %ix%i (scale=%.4f, maxscale=%.4f)."
            " upscale=%s, hq=%s%s",
            size_warning ? "**missing size** " : "",
            thumbnail_export ? "thumbnail" : "export", imgid,
-           pipe.processed_width, pipe.processed_height,
+           pipe->processed_width, pipe->processed_height,
            processed_width, processed_height, scale, max_scale,
            upscale ? "yes" : "no",
            high_quality_processing || scale > 1.0f ? "yes" : "no",
@@ -1316,7 +1572,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
      * if high quality processing was requested, downsampling will be done
      * at the very end of the pipe (just before border and watermark)
      */
-    dt_dev_pixelpipe_process_no_gamma(&pipe, &dev, 0, 0,
+    dt_dev_pixelpipe_process_no_gamma(pipe, dev, 0, 0,
                                       processed_width, processed_height, scale);
   }
   else
@@ -1328,7 +1584,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
     // find the finalscale module
     dt_dev_pixelpipe_iop_t *finalscale = NULL;
     {
-      for(const GList *nodes = g_list_last(pipe.nodes);
+      for(const GList *nodes = g_list_last(pipe->nodes);
           nodes;
           nodes = g_list_previous(nodes))
       {
@@ -1346,10 +1602,10 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
     // do the processing (8-bit with special treatment, to make sure
     // we can use openmp further down):
     if(bpp == 8)
-      dt_dev_pixelpipe_process(&pipe, &dev, 0, 0,
+      dt_dev_pixelpipe_process(pipe, dev, 0, 0,
                                processed_width, processed_height, scale, DT_DEVICE_NONE);
     else
-      dt_dev_pixelpipe_process_no_gamma(&pipe, &dev, 0, 0,
+      dt_dev_pixelpipe_process_no_gamma(pipe, dev, 0, 0,
                                         processed_width, processed_height, scale);
 
     if(finalscale) finalscale->enabled = TRUE;
@@ -1359,7 +1615,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
                   ? "[dev_process_thumbnail] pixel pipeline processing"
                   : "[dev_process_export] pixel pipeline processing");
 
-  uint8_t *outbuf = pipe.backbuf;
+  uint8_t *outbuf = pipe->backbuf;
   if(outbuf == NULL)
   {
     dt_print(DT_DEBUG_IMAGEIO,
@@ -1407,7 +1663,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
       }
       else
       { // !display_byteorder, need to swap:
-        uint8_t *const buf8 = pipe.backbuf;
+        uint8_t *const buf8 = pipe->backbuf;
         DT_OMP_FOR()
         // just flip byte order
         for(size_t k = 0; k < (size_t)processed_width * processed_height; k++)
@@ -1478,7 +1734,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
 
     res = (format->write_image(format_params, filename, outbuf, icc_type,
                               icc_filename, exif_profile, length, imgid,
-                              num, total, &pipe, export_masks)) != 0;
+                              num, total, pipe, export_masks)) != 0;
 
     free(exif_profile);
   }
@@ -1486,7 +1742,7 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
   {
     res = (format->write_image(format_params, filename, outbuf, icc_type,
                               icc_filename, NULL, 0, imgid, num, total,
-                              &pipe, export_masks)) != 0;
+                              pipe, export_masks)) != 0;
   }
 
   if(res)
@@ -1496,12 +1752,24 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
   if(copy_metadata
      && (format->flags(format_params) & FORMAT_FLAGS_SUPPORT_XMP))
   {
-    dt_exif_xmp_attach_export(imgid, filename, metadata, &dev, &pipe);
+    dt_exif_xmp_attach_export(imgid, filename, metadata, dev, pipe);
     // no need to cancel the export if this fail
   }
 
-  dt_dev_pixelpipe_cleanup(&pipe);
-  dt_dev_cleanup(&dev);
+  if(signature)
+  {
+    // keep the configured pipe for a possible next image with the same stack
+    _export_cache.signature = signature;
+    _export_cache.dev = dev;
+    _export_cache.pipe = pipe;
+  }
+  else
+  {
+    dt_dev_pixelpipe_cleanup(pipe);
+    g_free(pipe);
+    dt_dev_cleanup(dev);
+    g_free(dev);
+  }
   dt_mipmap_cache_release(&buf);
 
   if(!thumbnail_export && strcmp(format->mime(format_params), "memory")
@@ -1538,9 +1806,16 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid,
   return FALSE; // success
 
 error:
-  dt_dev_pixelpipe_cleanup(&pipe);
-error_early:
-  dt_dev_cleanup(&dev);
+  if(pipe)
+  {
+    dt_dev_pixelpipe_cleanup(pipe);
+    g_free(pipe);
+  }
+  if(dev)
+  {
+    dt_dev_cleanup(dev);
+    g_free(dev);
+  }
   dt_mipmap_cache_release(&buf);
 
   if(!thumbnail_export)
@@ -1596,6 +1871,22 @@ void dt_imageio_set_hdr_tag(dt_image_t *img)
 //   combined reading
 // =================================================
 
+// ask the kernel to start reading the whole file while we are still
+// busy probing magic numbers and parsing metadata, so the loader later
+// finds the data in the page cache. the large sequential reads this
+// triggers are much faster than the loaders' own small-read patterns,
+// especially on network filesystems.
+static void _readahead_hint(const char *filename)
+{
+#ifdef POSIX_FADV_WILLNEED
+  const int fd = g_open(filename, O_RDONLY, 0);
+  if(fd < 0) return;
+  (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  (void)posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+#endif
+}
+
 dt_imageio_retval_t dt_imageio_open(dt_image_t *img,
                                     const char *filename,
                                     dt_mipmap_buffer_t *buf)
@@ -1605,12 +1896,19 @@ dt_imageio_retval_t dt_imageio_open(dt_image_t *img,
   if(!g_file_test(filename, G_FILE_TEST_IS_REGULAR))
     return DT_IMAGEIO_FILE_NOT_FOUND;
 
+  // we are going to read the file (almost) front to back, get the
+  // readahead going before the first loader touches it
+  if(buf) _readahead_hint(filename);
+
   const int32_t was_hdr = (img->flags & DT_IMAGE_HDR);
   const int32_t was_bw = dt_image_monochrome_flags(img);
 
   dt_imageio_retval_t ret = DT_IMAGEIO_LOAD_FAILED;
   img->loader = LOADER_UNKNOWN;
 
+  const double trace_start = dt_trace_begin();
+  dt_alloc_tag_push("imageio");
+
   // check for known magic numbers and call the appropriate loader if we recognize a magic number
   ret = _open_by_magic_number(img, filename, buf);
 
@@ -1649,6 +1947,9 @@ dt_imageio_retval_t dt_imageio_open(dt_image_t *img,
   img->p_width = img->width - img->crop_x - img->crop_right;
   img->p_height = img->height - img->crop_y - img->crop_bottom;
 
+  dt_alloc_tag_pop();
+  dt_trace_end("io", trace_start, "open `%s'", filename);
+
   return ret;
 }
 
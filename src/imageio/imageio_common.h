@@ -127,6 +127,11 @@ gboolean dt_imageio_export_with_flags(const dt_imgid_t imgid, const char *filena
                                  dt_export_metadata_t *metadata,
                                  const int history_end);
 
+// release the per-thread export pipe kept by dt_imageio_export_with_flags
+// for reuse between images sharing one processing stack; call when a
+// batch export worker is done on its thread
+void dt_imageio_export_cleanup(void);
+
 // general, efficient buffer flipping function using memcopies
 void dt_imageio_flip_buffers(char *out,
                              const char *in,
@@ -151,11 +156,15 @@ void dt_imageio_flip_buffers_ui8_to_float(float *out,
                                           const dt_image_orientation_t orientation);
 
 // allocate buffer and return 0 on success along with largest jpg thumbnail from raw.
+// if max_width/max_height are positive the thumbnail may come back decoded at a
+// reduced scale still covering that size, pass 0 to get it at full size.
 gboolean dt_imageio_large_thumbnail(const char *filename,
                                uint8_t **buffer,
                                int32_t *width,
                                int32_t *height,
-                               dt_colorspaces_color_profile_type_t *color_space);
+                               dt_colorspaces_color_profile_type_t *color_space,
+                               const int max_width,
+                               const int max_height);
 
 // lookup maker and model, dispatch lookup to rawspeed or libraw
 gboolean dt_imageio_lookup_makermodel(const char *maker,
@@ -284,6 +284,97 @@ out:
 }
 
 
+gboolean dt_imageio_heif_read_thumbnail(const char *filename,
+                                        uint8_t **buffer,
+                                        int32_t *width,
+                                        int32_t *height)
+{
+  gboolean res = TRUE;
+  struct heif_error err;
+  struct heif_image_handle* handle = NULL;
+  struct heif_image_handle* thumb_handle = NULL;
+  struct heif_image* thumb_img = NULL;
+
+  struct heif_context* ctx = heif_context_alloc();
+  if(!ctx)
+  {
+    dt_print(DT_DEBUG_ALWAYS,
+             "Unable to allocate HEIF context");
+    return TRUE;
+  }
+
+  err = heif_context_read_from_file(ctx, filename, NULL);
+  if(err.code != heif_error_Ok)
+    goto out;
+
+  err = heif_context_get_primary_image_handle(ctx, &handle);
+  if(err.code != heif_error_Ok)
+    goto out;
+
+  heif_item_id thumb_id;
+  if(heif_image_handle_get_list_of_thumbnail_IDs(handle, &thumb_id, 1) != 1)
+    goto out;
+
+  err = heif_image_handle_get_thumbnail(handle, thumb_id, &thumb_handle);
+  if(err.code != heif_error_Ok)
+    goto out;
+
+  struct heif_decoding_options *decode_options = heif_decoding_options_alloc();
+  if(!decode_options)
+    goto out;
+  // the caller applies the image orientation itself, just like after a
+  // full decode through dt_imageio_open_heif()
+  decode_options->ignore_transformations = TRUE;
+  err = heif_decode_image(thumb_handle,
+                          &thumb_img,
+                          heif_colorspace_RGB,
+                          heif_chroma_interleaved_RGBA,
+                          decode_options);
+  heif_decoding_options_free(decode_options);
+  if(err.code != heif_error_Ok)
+  {
+    dt_print(DT_DEBUG_IMAGEIO,
+             "Failed to decode thumbnail item of HEIF file [%s]",
+             filename);
+    goto out;
+  }
+
+  int rowbytes = 0;
+  const uint8_t* data = heif_image_get_plane_readonly(thumb_img,
+                                                      heif_channel_interleaved,
+                                                      &rowbytes);
+  if(!data)
+    goto out;
+
+  const size_t wd = heif_image_get_width(thumb_img, heif_channel_interleaved);
+  const size_t ht = heif_image_get_height(thumb_img, heif_channel_interleaved);
+
+  *buffer = dt_alloc_align_uint8(4 * wd * ht);
+  if(!*buffer)
+    goto out;
+
+  for(size_t y = 0; y < ht; y++)
+    memcpy(*buffer + 4 * wd * y, data + (size_t)rowbytes * y, 4 * wd);
+
+  *width = wd;
+  *height = ht;
+
+  dt_print(DT_DEBUG_IMAGEIO,
+           "Decoded %zux%zu thumbnail item of HEIF file [%s]",
+           wd, ht, filename);
+  res = FALSE;
+
+out:
+  // cleanup handles
+  heif_image_release(thumb_img);
+  heif_image_handle_release(thumb_handle);
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+
+  return res;
+}
+
+
 int dt_imageio_heif_read_profile(const char *filename,
                                 uint8_t **out,
                                 dt_colorspaces_cicp_t *cicp)
@@ -28,6 +28,13 @@ dt_imageio_retval_t dt_imageio_open_heif(dt_image_t *img,
 int dt_imageio_heif_read_profile(const char *filename,
                                  uint8_t **out,
                                  dt_colorspaces_cicp_t *cicp);
+/* decode the embedded thumbnail image item of a HEIF/AVIF file into an
+ * 8-bit RGBA buffer allocated with dt_alloc_align_uint8(). returns TRUE
+ * on error or if the file carries no thumbnail item. */
+gboolean dt_imageio_heif_read_thumbnail(const char *filename,
+                                        uint8_t **buffer,
+                                        int32_t *width,
+                                        int32_t *height);
 
 // clang-format off
 // modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
@@ -182,9 +182,12 @@ dt_imageio_retval_t dt_imageio_open_jpegxl(dt_image_t *img,
       // either the one obtained above or the value read from Exif data)
       JxlDecoderSetKeepOrientation(decoder, JXL_TRUE);
 
-      uint32_t num_threads =
-        JxlResizableParallelRunnerSuggestThreads(basicinfo.xsize,
-                                                 basicinfo.ysize);
+      // take libjxl's suggestion for the image size, but never spawn
+      // more workers than darktable's resource configuration allows
+      const uint32_t num_threads =
+        MIN(JxlResizableParallelRunnerSuggestThreads(basicinfo.xsize,
+                                                     basicinfo.ysize),
+            (uint32_t)dt_get_num_threads());
       JxlResizableParallelRunnerSetThreads(runner, num_threads);
 
       continue;    // go to next loop iteration to process rest of the input
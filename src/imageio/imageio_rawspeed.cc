@@ -30,6 +30,7 @@
 #define TYPE_USHORT16 RawImageType::UINT16
 
 #include <memory>
+#include <utility>
 
 #define __STDC_LIMIT_MACROS
 
@@ -187,7 +188,17 @@ dt_imageio_retval_t dt_imageio_open_rawspeed(dt_image_t *img,
     dt_rawspeed_load_meta();
 
     dt_pthread_mutex_lock(&darktable.readFile_mutex);
-    auto [storage, storageBuf] = f.readFile();
+    // map the file so the decoder consumes the page cache directly
+    // instead of a private heap copy. mapping can fail for zero sized
+    // files or exotic filesystems, then we read the file as before.
+    std::unique_ptr<GMappedFile, decltype(&g_mapped_file_unref)>
+        mapped(g_mapped_file_new(filen, FALSE, NULL), &g_mapped_file_unref);
+    auto [storage, storageBuf] = mapped
+        ? std::make_pair(decltype(f.readFile().first){},
+                         Buffer(reinterpret_cast<const uint8_t *>(
+                                    g_mapped_file_get_contents(mapped.get())),
+                                g_mapped_file_get_length(mapped.get())))
+        : f.readFile();
     dt_pthread_mutex_unlock(&darktable.readFile_mutex);
 
     RawParser t(storageBuf);
@@ -252,6 +263,7 @@ dt_imageio_retval_t dt_imageio_open_rawspeed(dt_image_t *img,
     /* free auto pointers on spot */
     d.reset();
     storage.reset();
+    mapped.reset();
 
     // Grab the WB
     if(r->metadata.wbCoeffs) {
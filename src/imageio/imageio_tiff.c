@@ -85,68 +85,133 @@ static inline float _half_to_float(uint16_t h)
 }
 #endif
 
-static inline int _read_chunky_8(tiff_t *t, uint16_t photometric)
+static inline void _convert_row_8(const tiff_t *t,
+                                  const uint8_t *in,
+                                  float *out,
+                                  const uint16_t photometric)
 {
   const gboolean need_invert = (photometric == PHOTOMETRIC_MINISWHITE);
 
-  for(uint32_t row = 0; row < t->height; row++)
+  for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
   {
-    uint8_t *in = ((uint8_t *)t->buf);
-    float *out = ((float *)t->mipbuf) + (size_t)4 * row * t->width;
+    /* set rgb to first sample from scanline */
+    out[0] = need_invert
+             ? 1.0f - ((float)in[0]) * (1.0f / 255.0f)
+             :        ((float)in[0]) * (1.0f / 255.0f);
 
-    /* read scanline */
-    if(TIFFReadScanline(t->tiff, in, row, 0) == -1) return -1;
+    if(t->spp < 3)  // mono, maybe plus alpha channel
+    {
+      out[1] = out[2] = out[0];
+    }
+    else
+    {
+      out[1] = ((float)in[1]) * (1.0f / 255.0f);
+      out[2] = ((float)in[2]) * (1.0f / 255.0f);
+    }
 
-    for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
+    out[3] = 0;
+  }
+}
+
+static inline void _convert_row_16(const tiff_t *t,
+                                   const uint16_t *in,
+                                   float *out)
+{
+  for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
+  {
+    out[0] = ((float)in[0]) * (1.0f / 65535.0f);
+
+    if(t->spp < 3)  // mono, maybe plus alpha channel
     {
-      /* set rgb to first sample from scanline */
-      out[0] = need_invert
-               ? 1.0f - ((float)in[0]) * (1.0f / 255.0f)
-               :        ((float)in[0]) * (1.0f / 255.0f);
+      out[1] = out[2] = out[0];
+    }
+    else
+    {
+      out[1] = ((float)in[1]) * (1.0f / 65535.0f);
+      out[2] = ((float)in[2]) * (1.0f / 65535.0f);
+    }
 
-      if(t->spp < 3)  // mono, maybe plus alpha channel
-      {
-        out[1] = out[2] = out[0];
-      }
-      else
-      {
-        out[1] = ((float)in[1]) * (1.0f / 255.0f);
-        out[2] = ((float)in[2]) * (1.0f / 255.0f);
-      }
+    out[3] = 0;
+  }
+}
 
-      out[3] = 0;
+static inline void _convert_row_h(const tiff_t *t,
+                                  const uint16_t *in,
+                                  float *out)
+{
+  for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
+  {
+#ifdef HAVE_IMATH
+    out[0] = imath_half_to_float(in[0]);
+#else
+    out[0] = _half_to_float(in[0]);
+#endif
+
+    if(t->spp < 3)  // mono, maybe plus alpha channel
+    {
+      out[1] = out[2] = out[0];
+    }
+    else
+    {
+#ifdef HAVE_IMATH
+      out[1] = imath_half_to_float(in[1]);
+      out[2] = imath_half_to_float(in[2]);
+#else
+      out[1] = _half_to_float(in[1]);
+      out[2] = _half_to_float(in[2]);
+#endif
     }
+
+    out[3] = 0;
   }
+}
 
-  return 1;
+static inline void _convert_row_f(const tiff_t *t,
+                                  const float *in,
+                                  float *out)
+{
+  for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
+  {
+    out[0] = in[0];
+
+    if(t->spp < 3)  // mono, maybe plus alpha channel
+    {
+      out[1] = out[2] = out[0];
+    }
+    else
+    {
+      out[1] = in[1];
+      out[2] = in[2];
+    }
+
+    out[3] = 0;
+  }
 }
 
-static inline int _read_chunky_16(tiff_t *t)
+static inline int _read_chunky_8(tiff_t *t, uint16_t photometric)
 {
   for(uint32_t row = 0; row < t->height; row++)
   {
-    uint16_t *in = ((uint16_t *)t->buf);
-    float *out = ((float *)t->mipbuf) + (size_t)4 * row * t->width;
-
     /* read scanline */
-    if(TIFFReadScanline(t->tiff, in, row, 0) == -1) return -1;
+    if(TIFFReadScanline(t->tiff, t->buf, row, 0) == -1) return -1;
 
-    for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
-    {
-      out[0] = ((float)in[0]) * (1.0f / 65535.0f);
+    _convert_row_8(t, (const uint8_t *)t->buf,
+                   ((float *)t->mipbuf) + (size_t)4 * row * t->width,
+                   photometric);
+  }
 
-      if(t->spp < 3)  // mono, maybe plus alpha channel
-      {
-        out[1] = out[2] = out[0];
-      }
-      else
-      {
-        out[1] = ((float)in[1]) * (1.0f / 65535.0f);
-        out[2] = ((float)in[2]) * (1.0f / 65535.0f);
-      }
+  return 1;
+}
 
-      out[3] = 0;
-    }
+static inline int _read_chunky_16(tiff_t *t)
+{
+  for(uint32_t row = 0; row < t->height; row++)
+  {
+    /* read scanline */
+    if(TIFFReadScanline(t->tiff, t->buf, row, 0) == -1) return -1;
+
+    _convert_row_16(t, (const uint16_t *)t->buf,
+                    ((float *)t->mipbuf) + (size_t)4 * row * t->width);
   }
 
   return 1;
@@ -156,37 +221,11 @@ static inline int _read_chunky_h(tiff_t *t)
 {
   for(uint32_t row = 0; row < t->height; row++)
   {
-    uint16_t *in = ((uint16_t *)t->buf);
-    float *out = ((float *)t->mipbuf) + (size_t)4 * row * t->width;
-
     /* read scanline */
-    if(TIFFReadScanline(t->tiff, in, row, 0) == -1) return -1;
-
-    for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
-    {
-#ifdef HAVE_IMATH
-      out[0] = imath_half_to_float(in[0]);
-#else
-      out[0] = _half_to_float(in[0]);
-#endif
-
-      if(t->spp < 3)  // mono, maybe plus alpha channel
-      {
-        out[1] = out[2] = out[0];
-      }
-      else
-      {
-#ifdef HAVE_IMATH
-        out[1] = imath_half_to_float(in[1]);
-        out[2] = imath_half_to_float(in[2]);
-#else
-        out[1] = _half_to_float(in[1]);
-        out[2] = _half_to_float(in[2]);
-#endif
-      }
+    if(TIFFReadScanline(t->tiff, t->buf, row, 0) == -1) return -1;
 
-      out[3] = 0;
-    }
+    _convert_row_h(t, (const uint16_t *)t->buf,
+                   ((float *)t->mipbuf) + (size_t)4 * row * t->width);
   }
 
   return 1;
@@ -196,31 +235,93 @@ static inline int _read_chunky_f(tiff_t *t)
 {
   for(uint32_t row = 0; row < t->height; row++)
   {
-    float *in = ((float *)t->buf);
-    float *out = ((float *)t->mipbuf) + (size_t)4 * row * t->width;
-
     /* read scanline */
-    if(TIFFReadScanline(t->tiff, in, row, 0) == -1) return -1;
+    if(TIFFReadScanline(t->tiff, t->buf, row, 0) == -1) return -1;
 
-    for(uint32_t i = 0; i < t->width; i++, in += t->spp, out += 4)
+    _convert_row_f(t, (const float *)t->buf,
+                   ((float *)t->mipbuf) + (size_t)4 * row * t->width);
+  }
+
+  return 1;
+}
+
+// Decode the strips of a multi-strip RGB/mono file in parallel. Every
+// thread processes its share of the strips through a private TIFF handle
+// opened on the same file - separate libtiff handles are fully independent
+// of each other, so each thread gets its own codec state. The strips cover
+// disjoint row ranges of the destination buffer. Returns 1 when the image
+// has been decoded, 0 when the caller should fall back to the sequential
+// scanline reader.
+static int _read_strips_parallel(tiff_t *t,
+                                 const char *filename,
+                                 const uint16_t photometric)
+{
+  uint32_t rowsperstrip = 0;
+  TIFFGetFieldDefaulted(t->tiff, TIFFTAG_ROWSPERSTRIP, &rowsperstrip);
+  const uint32_t nstrips = TIFFNumberOfStrips(t->tiff);
+
+  // single-strip files have nothing to parallelize over
+  if(rowsperstrip == 0 || rowsperstrip >= t->height || nstrips < 2)
+    return 0;
+
+  const int nchunks = MIN(dt_get_num_threads(), (int)nstrips);
+  const uint32_t strips_per_chunk = (nstrips + nchunks - 1) / nchunks;
+
+  int err = 0;
+
+  DT_OMP_FOR(reduction(|: err))
+  for(int chunk = 0; chunk < nchunks; chunk++)
+  {
+#ifdef _WIN32
+    wchar_t *wfilename = g_utf8_to_utf16(filename, -1, NULL, NULL, NULL);
+    TIFF *tiff = TIFFOpenW(wfilename, "rb");
+    g_free(wfilename);
+#else
+    TIFF *tiff = TIFFOpen(filename, "rb");
+#endif
+    tdata_t buf = tiff ? _TIFFmalloc(TIFFStripSize(tiff)) : NULL;
+    if(!buf)
     {
-      out[0] = in[0];
+      if(tiff) TIFFClose(tiff);
+      err |= 1;
+      continue;
+    }
 
-      if(t->spp < 3)  // mono, maybe plus alpha channel
+    const uint32_t first = chunk * strips_per_chunk;
+    const uint32_t last = MIN(first + strips_per_chunk, nstrips);
+
+    for(uint32_t strip = first; strip < last && !err; strip++)
+    {
+      if(TIFFReadEncodedStrip(tiff, strip, buf, (tmsize_t)-1) == -1)
       {
-        out[1] = out[2] = out[0];
+        err |= 1;
+        break;
       }
-      else
+
+      const uint32_t firstrow = strip * rowsperstrip;
+      const uint32_t lastrow = MIN(firstrow + rowsperstrip, t->height);
+
+      for(uint32_t row = firstrow; row < lastrow; row++)
       {
-        out[1] = in[1];
-        out[2] = in[2];
+        const uint8_t *in = (const uint8_t *)buf + (size_t)(row - firstrow) * t->scanlinesize;
+        float *out = ((float *)t->mipbuf) + (size_t)4 * row * t->width;
+
+        if(t->bpp == 8)
+          _convert_row_8(t, in, out, photometric);
+        else if(t->bpp == 16 && t->sampleformat == SAMPLEFORMAT_UINT)
+          _convert_row_16(t, (const uint16_t *)in, out);
+        else if(t->bpp == 16)
+          _convert_row_h(t, (const uint16_t *)in, out);
+        else
+          _convert_row_f(t, (const float *)in, out);
       }
-
-      out[3] = 0;
     }
+
+    _TIFFfree(buf);
+    TIFFClose(tiff);
   }
 
-  return 1;
+  return err ? 0 : 1;
 }
 
 static inline int _read_chunky_8_Lab(tiff_t *t, uint16_t photometric)
@@ -534,19 +635,23 @@ dt_imageio_retval_t dt_imageio_open_tiff(dt_image_t *img,
   }
   else if(t.bpp == 8 && t.sampleformat == SAMPLEFORMAT_UINT)
   {
-    ok = _read_chunky_8(&t, photometric);
+    if(!_read_strips_parallel(&t, filename, photometric))
+      ok = _read_chunky_8(&t, photometric);
   }
   else if(t.bpp == 16 && t.sampleformat == SAMPLEFORMAT_UINT)
   {
-    ok = _read_chunky_16(&t);
+    if(!_read_strips_parallel(&t, filename, photometric))
+      ok = _read_chunky_16(&t);
   }
   else if(t.bpp == 16 && t.sampleformat == SAMPLEFORMAT_IEEEFP)
   {
-    ok = _read_chunky_h(&t);
+    if(!_read_strips_parallel(&t, filename, photometric))
+      ok = _read_chunky_h(&t);
   }
   else if(t.bpp == 32 && t.sampleformat == SAMPLEFORMAT_IEEEFP)
   {
-    ok = _read_chunky_f(&t);
+    if(!_read_strips_parallel(&t, filename, photometric))
+      ok = _read_chunky_f(&t);
   }
   else
   {
@@ -37,15 +37,124 @@
 #ifdef GDK_WINDOWING_QUARTZ
 #include "osx/osx.h"
 #endif
+#include <gio/gio.h>
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 DT_MODULE(4)
 
 extern darktable_t darktable;
 
+// optional write-behind queue: encode threads drop the finished image
+// on local scratch and continue, a single mover thread pushes the
+// files to the (possibly slow) destination.  the queue depth bounds
+// how much encoded data may pile up on scratch.
+typedef struct dt_disk_writeback_job_t
+{
+  char *tmpname;   // encoded image on local scratch
+  char *filename;  // final destination
+} dt_disk_writeback_job_t;
+
+typedef struct dt_disk_writeback_t
+{
+  dt_pthread_mutex_t lock;
+  pthread_cond_t cond;
+  GQueue jobs;
+  GThread *thread;
+  int max_depth;
+  int failed;
+  gboolean shutdown;
+} dt_disk_writeback_t;
+
+// shared by all export workers of the running job; created under
+// darktable.plugin_threadsafe, torn down in finalize_store
+static dt_disk_writeback_t *_writeback = NULL;
+
+static void *_writeback_worker(void *data)
+{
+  dt_disk_writeback_t *wb = data;
+
+  dt_pthread_mutex_lock(&wb->lock);
+  while(TRUE)
+  {
+    dt_disk_writeback_job_t *job = g_queue_pop_head(&wb->jobs);
+    if(!job)
+    {
+      if(wb->shutdown) break;
+      dt_pthread_cond_wait(&wb->cond, &wb->lock);
+      continue;
+    }
+    dt_pthread_mutex_unlock(&wb->lock);
+
+    GFile *src = g_file_new_for_path(job->tmpname);
+    GFile *dst = g_file_new_for_path(job->filename);
+    GError *error = NULL;
+    // within one filesystem this is a rename, to the destination
+    // filesystem g_file_move falls back to copy + delete
+    const gboolean moved =
+      g_file_move(src, dst, G_FILE_COPY_OVERWRITE, NULL, NULL, NULL, &error);
+    if(!moved)
+    {
+      dt_print(DT_DEBUG_ALWAYS,
+               "[imageio_storage_disk] could not move `%s' to `%s': %s",
+               job->tmpname, job->filename,
+               error ? error->message : "unknown error");
+      dt_control_log(_("could not export to file `%s'!"), job->filename);
+      g_clear_error(&error);
+      g_unlink(job->tmpname);
+    }
+    g_object_unref(src);
+    g_object_unref(dst);
+    g_free(job->tmpname);
+    g_free(job->filename);
+    g_free(job);
+
+    dt_pthread_mutex_lock(&wb->lock);
+    if(!moved) wb->failed++;
+    // wake producers possibly blocked on the queue bound
+    pthread_cond_broadcast(&wb->cond);
+  }
+  dt_pthread_mutex_unlock(&wb->lock);
+  return NULL;
+}
+
+// called under darktable.plugin_threadsafe
+static dt_disk_writeback_t *_writeback_get(void)
+{
+  if(!_writeback)
+  {
+    dt_disk_writeback_t *wb = g_malloc0(sizeof(dt_disk_writeback_t));
+    dt_pthread_mutex_init(&wb->lock, NULL);
+    pthread_cond_init(&wb->cond, NULL);
+    g_queue_init(&wb->jobs);
+    const int depth =
+      dt_conf_get_int("plugins/imageio/storage/disk/async_queue_depth");
+    wb->max_depth = CLAMP(depth, 1, 64);
+    wb->thread = g_thread_new("disk-writeback", _writeback_worker, wb);
+    _writeback = wb;
+  }
+  return _writeback;
+}
+
+static void _writeback_push(dt_disk_writeback_t *wb,
+                            char *tmpname,
+                            char *filename)
+{
+  dt_disk_writeback_job_t *job = g_malloc(sizeof(dt_disk_writeback_job_t));
+  job->tmpname = tmpname;
+  job->filename = filename;
+
+  dt_pthread_mutex_lock(&wb->lock);
+  while(g_queue_get_length(&wb->jobs) >= wb->max_depth)
+    dt_pthread_cond_wait(&wb->cond, &wb->lock);
+  g_queue_push_tail(&wb->jobs, job);
+  pthread_cond_broadcast(&wb->cond);
+  dt_pthread_mutex_unlock(&wb->lock);
+}
+
 // options for conflict handling
 typedef enum dt_disk_onconflict_actions_t
 {
@@ -342,6 +451,13 @@ int store(dt_imageio_module_storage_t *self,
   dt_variables_set_max_width_height(d->vp, fdata->max_width, fdata->max_height);
   dt_variables_set_upscale(d->vp, upscale);
 
+  // optionally decouple encoding from destination latency: write to
+  // local scratch and let a background thread move the file over
+  const gboolean async = total > 1
+    && dt_conf_get_bool("plugins/imageio/storage/disk/async_writes");
+  dt_disk_writeback_t *wb = NULL;
+  char tmppath[PATH_MAX] = { 0 };
+
   gboolean fail = FALSE;
   // we're potentially called in parallel. have sequence number synchronized:
   dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
@@ -472,12 +588,34 @@ try_again:
         }
       }
     }
+
+    if(!fail && async)
+    {
+      wb = _writeback_get();
+
+      // reserve the destination name so the conflict handling of the
+      // other workers sees it before the mover thread delivers it
+      const int fd = g_creat(filename, 0644);
+      if(fd >= 0) close(fd);
+
+      // encode to local scratch, keeping the extension for the writer
+      snprintf(tmppath, sizeof(tmppath), "%s" G_DIR_SEPARATOR_S
+               "darktable-export-XXXXXX.%s", g_get_tmp_dir(), ext);
+      const int tmpfd = g_mkstemps(tmppath, strlen(ext) + 1);
+      if(tmpfd < 0)
+        tmppath[0] = '\0'; // no scratch available, write directly
+      else
+        close(tmpfd);
+    }
   } // end of critical block
   dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
   if(fail) return 1;
 
+  const gboolean to_scratch = tmppath[0] != '\0';
+
   /* export image to file */
-  if(dt_imageio_export(imgid, filename, format, fdata, high_quality,
+  if(dt_imageio_export(imgid, to_scratch ? tmppath : filename, format, fdata,
+                       high_quality,
                        upscale, is_scaling, scale_factor,
                        TRUE, export_masks, icc_type,
                        icc_filename, icc_intent, self, sdata,
@@ -487,15 +625,46 @@ try_again:
              "[imageio_storage_disk] could not export to file: `%s'!",
              filename);
     dt_control_log(_("could not export to file `%s'!"), filename);
+    if(to_scratch) g_unlink(tmppath);
     return 1;
   }
 
+  if(to_scratch)
+    _writeback_push(wb, g_strdup(tmppath), g_strdup(filename));
+
   dt_print(DT_DEBUG_ALWAYS, "[export_job] exported to `%s'", filename);
   dt_control_log(ngettext("%d/%d exported to `%s'", "%d/%d exported to `%s'", num),
                  num, total, filename);
   return 0;
 }
 
+void finalize_store(dt_imageio_module_storage_t *self,
+                    dt_imageio_module_data_t *params)
+{
+  dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
+  dt_disk_writeback_t *wb = _writeback;
+  _writeback = NULL;
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+  if(!wb) return;
+
+  // drain the queue, the worker exits once it runs empty
+  dt_pthread_mutex_lock(&wb->lock);
+  wb->shutdown = TRUE;
+  pthread_cond_broadcast(&wb->cond);
+  dt_pthread_mutex_unlock(&wb->lock);
+  g_thread_join(wb->thread);
+
+  if(wb->failed)
+    dt_control_log(ngettext("%d image could not be written to the destination",
+                            "%d images could not be written to the destination",
+                            wb->failed),
+                   wb->failed);
+
+  pthread_cond_destroy(&wb->cond);
+  dt_pthread_mutex_destroy(&wb->lock);
+  g_free(wb);
+}
+
 size_t params_size(dt_imageio_module_storage_t *self)
 {
   return sizeof(dt_imageio_disk_t) - sizeof(void *);
@@ -271,6 +271,12 @@ int store(dt_imageio_module_storage_t *self,
 
   char tmp_dir[PATH_MAX] = { 0 };
 
+  // we're potentially called in parallel by several export workers.
+  // the variables context and the filename pattern are shared, so keep
+  // everything touching d under the plugin lock and only run the
+  // expensive exports outside of it.
+  dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
+
   // set variable values to expand them afterwards in darktable variables
   dt_variables_set_max_width_height(d->vp, fdata->max_width, fdata->max_height);
   dt_variables_set_upscale(d->vp, upscale);
@@ -315,6 +321,7 @@ int store(dt_imageio_module_storage_t *self,
   if(*c == '/' || *c == G_DIR_SEPARATOR) *c = '\0';
   if(g_mkdir_with_parents(dirname, 0755))
   {
+    dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
     dt_print(DT_DEBUG_ALWAYS,
              "[imageio_storage_gallery] could not create directory: `%s'!", dirname);
     dt_control_log(_("could not create directory `%s'!"), dirname);
@@ -324,6 +331,8 @@ int store(dt_imageio_module_storage_t *self,
   // store away dir.
   g_strlcpy(d->cached_dirname, dirname, sizeof(d->cached_dirname));
 
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+
   c = filename + strlen(filename);
   for(; c > filename && *c != '.' && *c != '/' && *c != G_DIR_SEPARATOR; c--)
     ;
@@ -423,7 +432,12 @@ int store(dt_imageio_module_storage_t *self,
   g_free(esc_relthumbfilename);
 
   pair->pos = num;
+  // the index is only assembled from this list in finalize_store(),
+  // once all workers are done; insertion by sequence number keeps the
+  // page order deterministic no matter which worker finishes first
+  dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
   d->l = g_list_insert_sorted(d->l, pair, (GCompareFunc)sort_pos);
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
 
   /* also export thumbnail: */
   // write with reduced resolution:
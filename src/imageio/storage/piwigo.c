@@ -279,6 +279,63 @@ static void _piwigo_ctx_destroy(_piwigo_api_context_t **ctx)
   }
 }
 
+static void _piwigo_api_authenticate(_piwigo_api_context_t *ctx);
+
+// pool of per-worker upload sessions: the photo transfer itself runs
+// outside the plugin mutex, so parallel export workers overlap their
+// uploads instead of serializing on the single session context.  each
+// cloned context opens a session of its own as the master cookie jar
+// is only written when its curl context is finalized.
+static GList *_upload_ctx_pool = NULL;
+
+static _piwigo_api_context_t *_piwigo_upload_ctx_acquire(dt_storage_piwigo_params_t *p)
+{
+  _piwigo_api_context_t *ctx = NULL;
+
+  dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
+  if(_upload_ctx_pool)
+  {
+    ctx = _upload_ctx_pool->data;
+    _upload_ctx_pool = g_list_delete_link(_upload_ctx_pool, _upload_ctx_pool);
+  }
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+
+  if(ctx) return ctx;
+
+  ctx = _piwigo_ctx_init();
+  ctx->server = g_strdup(p->api->server);
+  ctx->username = g_strdup(p->api->username);
+  ctx->password = g_strdup(p->api->password);
+  _piwigo_api_authenticate(ctx);
+  if(ctx->response && !ctx->error_occured)
+    ctx->authenticated = TRUE;
+  else
+    _piwigo_ctx_destroy(&ctx); // caller falls back to the shared session
+  return ctx;
+}
+
+static void _piwigo_upload_ctx_release(_piwigo_api_context_t *ctx)
+{
+  dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
+  _upload_ctx_pool = g_list_prepend(_upload_ctx_pool, ctx);
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+}
+
+static void _piwigo_upload_ctx_drain(void)
+{
+  dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
+  GList *pool = _upload_ctx_pool;
+  _upload_ctx_pool = NULL;
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+
+  for(GList *l = pool; l; l = g_list_next(l))
+  {
+    _piwigo_api_context_t *ctx = l->data;
+    _piwigo_ctx_destroy(&ctx);
+  }
+  g_list_free(pool);
+}
+
 static void _piwigo_free_account(void *data)
 {
   _piwigo_account_t *account = (_piwigo_account_t *)data;
@@ -947,10 +1004,12 @@ static gboolean _piwigo_api_set_info(dt_storage_piwigo_params_t *p,
 }
 
 static gboolean _piwigo_api_upload_photo(dt_storage_piwigo_params_t *p,
+                                         _piwigo_api_context_t *ctx,
                                          gchar *fname,
                                          gchar *author,
                                          gchar *caption,
                                          gchar *description,
+                                         const gchar *tags,
                                          const int pwg_image_id)
 {
   GList *args = NULL;
@@ -978,17 +1037,17 @@ static gboolean _piwigo_api_upload_photo(dt_storage_piwigo_params_t *p,
   if(description && strlen(description)>0)
     args = _piwigo_query_add_arguments(args, "comment", description);
 
-  if(p->tags && strlen(p->tags)>0)
-    args = _piwigo_query_add_arguments(args, "tags", p->tags);
+  if(tags && strlen(tags)>0)
+    args = _piwigo_query_add_arguments(args, "tags", tags);
 
   if(pwg_image_id >= 0)
     args = _piwigo_query_add_arguments(args, "image_id", pwg_image_id_string);
 
-  _piwigo_api_post(p->api, args, fname, FALSE);
+  _piwigo_api_post(ctx, args, fname, FALSE);
 
   g_list_free(args);
 
-  return !p->api->error_occured;
+  return !ctx->error_occured;
 }
 
 // Login button pressed...
@@ -1259,6 +1318,9 @@ static gboolean _finalize_store(gpointer user_data)
 void finalize_store(struct dt_imageio_module_storage_t *self,
                     dt_imageio_module_data_t *data)
 {
+  // close the sessions the workers opened for parallel uploads
+  _piwigo_upload_ctx_drain();
+
   g_main_context_invoke(NULL, _finalize_store, self->gui_data);
 }
 
@@ -1298,6 +1360,7 @@ int store(dt_imageio_module_storage_t *self,
   char *caption = NULL;
   char *description = NULL;
   char *author = NULL;
+  char *tags = NULL;
 
   dt_image_t *img = dt_image_cache_get(imgid, 'r');
 
@@ -1367,27 +1430,38 @@ int store(dt_imageio_module_storage_t *self,
     result = 1;
     goto cleanup;
   }
+  if(metadata->flags & DT_META_TAG)
+  {
+    GList *tags_list = dt_tag_get_list_export(imgid, metadata->flags);
+    tags = dt_util_glist_to_str(",", tags_list);
+    g_list_free_full(tags_list, g_free);
+  }
+
+  // the small api requests - album creation, conflict lookup, metadata
+  // update - stay serialized on the shared session; the decision
+  // whether to upload is taken here
+  gboolean do_upload = FALSE;
+  int pwg_image_id = -1;
+
   dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
   {
     gboolean status = TRUE;
 
-    if(metadata->flags & DT_META_TAG)
-    {
-      GList *tags_list = dt_tag_get_list_export(imgid, metadata->flags);
-      p->tags = dt_util_glist_to_str(",", tags_list);
-      g_list_free_full(tags_list, g_free);
-    }
-
     if(p->new_album)
     {
       status = _piwigo_api_create_new_album(p);
-      if(!status) dt_control_log(_("cannot create a new Piwigo album!"));
+      if(!status)
+        dt_control_log(_("cannot create a new Piwigo album!"));
+      else
+      {
+        // we do not want to create more albums when multiple upload
+        p->new_album = FALSE;
+        _piwigo_refresh_albums(ui, p->album);
+      }
     }
 
     if(status)
     {
-      int pwg_image_id = -1;
-
       if(p->preset_data.conflict_action != DT_PIWIGO_CONFLICT_NOTHING)
       {
         pwg_image_id = _piwigo_api_get_image_id(p, img, format, fdata, 0);
@@ -1410,30 +1484,41 @@ int store(dt_imageio_module_storage_t *self,
       }
       else
       {
-        status = _piwigo_api_upload_photo(p, fname, author, caption,
-                                          description, pwg_image_id);
-        if(!status)
-        {
-          dt_print(DT_DEBUG_ALWAYS,
-                   "[imageio_storage_piwigo] could not upload to Piwigo!");
-          dt_control_log(_("could not upload to Piwigo!"));
-          result = 1;
-        }
-        else if(p->new_album)
-        {
-          // we do not want to create more albums when multiple upload
-          p->new_album = FALSE;
-          _piwigo_refresh_albums(ui, p->album);
-        }
+        do_upload = TRUE;
       }
     }
-    if(p->tags)
+  }
+  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+
+  if(do_upload)
+  {
+    // the transfer itself runs outside the critical section on a
+    // pooled session, so parallel export workers overlap their
+    // uploads instead of ping-ponging on request latency
+    gboolean status;
+    _piwigo_api_context_t *ctx = _piwigo_upload_ctx_acquire(p);
+    if(ctx)
     {
-      g_free(p->tags);
-      p->tags = NULL;
+      status = _piwigo_api_upload_photo(p, ctx, fname, author, caption,
+                                        description, tags, pwg_image_id);
+      _piwigo_upload_ctx_release(ctx);
+    }
+    else
+    {
+      // could not open a session of our own, fall back to the shared one
+      dt_pthread_mutex_lock(&darktable.plugin_threadsafe);
+      status = _piwigo_api_upload_photo(p, p->api, fname, author, caption,
+                                        description, tags, pwg_image_id);
+      dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
+    }
+    if(!status)
+    {
+      dt_print(DT_DEBUG_ALWAYS,
+               "[imageio_storage_piwigo] could not upload to Piwigo!");
+      dt_control_log(_("could not upload to Piwigo!"));
+      result = 1;
     }
   }
-  dt_pthread_mutex_unlock(&darktable.plugin_threadsafe);
 
 cleanup:
 
@@ -1442,6 +1527,7 @@ cleanup:
   g_free(caption);
   g_free(description);
   g_free(author);
+  g_free(tags);
 
   if(skipped)
   {
@@ -642,10 +642,9 @@ static image_double gaussian_sampler(const image_double in, const double scale,
                                       const double sigma_scale )
 {
   image_double aux,out;
-  ntuple_list kernel;
-  unsigned int N,M,h,n,x,y,i;
-  int xc,yc,j,double_x_size,double_y_size;
-  double sigma,xx,yy,sum,prec;
+  unsigned int N,M,h,n;
+  int double_x_size,double_y_size;
+  double sigma,prec;
 
   /* check parameters */
   if( in == NULL || in->data == NULL || in->xsize == 0 || in->ysize == 0 )
@@ -676,82 +675,94 @@ static image_double gaussian_sampler(const image_double in, const double scale,
   prec = 3.0;
   h = (unsigned int) ceil( sigma * sqrt( 2.0 * prec * log(10.0) ) );
   n = 1+2*h; /* kernel size */
-  kernel = new_ntuple_list(n);
 
   /* auxiliary double image size variables */
   double_x_size = (int) (2 * in->xsize);
   double_y_size = (int) (2 * in->ysize);
 
-  /* First subsampling: x axis */
-  for(x=0;x<aux->xsize;x++)
-    {
-      /*
-         x   is the coordinate in the new image.
-         xx  is the corresponding x-value in the original size image.
-         xc  is the integer value, the pixel coordinate of xx.
-       */
-      xx = (double) x / scale;
-      /* coordinate (0.0,0.0) is in the center of pixel (0,0),
-         so the pixel with xc=0 get the values of xx from -0.5 to 0.5 */
-      xc = (int) floor( xx + 0.5 );
-      gaussian_kernel( kernel, sigma, (double) h + xx - (double) xc );
-      /* the kernel must be computed for each x because the fine
-         offset xx-xc is different in each case */
-
-      for(y=0;y<aux->ysize;y++)
-        {
-          sum = 0.0;
-          for(i=0;i<kernel->dim;i++)
-            {
-              j = xc - h + i;
-
-              /* symmetry boundary condition */
-              while( j < 0 ) j += double_x_size;
-              while( j >= double_x_size ) j -= double_x_size;
-              if( j >= (int) in->xsize ) j = double_x_size-1-j;
-
-              sum += in->data[ j + y * in->xsize ] * kernel->values[i];
-            }
-          aux->data[ x + y * aux->xsize ] = sum;
-        }
-    }
+  /* First subsampling: x axis.
+     Output columns are independent; each thread needs its own kernel
+     buffer since the kernel is recomputed for every fine offset. */
+  DT_OMP_PRAGMA(parallel)
+  {
+    const ntuple_list th_kernel = new_ntuple_list(n);
+    DT_OMP_PRAGMA(for schedule(static))
+    for(int xi=0; xi<(int)aux->xsize; xi++)
+      {
+        /*
+           xi  is the coordinate in the new image.
+           xx  is the corresponding x-value in the original size image.
+           xc  is the integer value, the pixel coordinate of xx.
+         */
+        const double xx = (double) xi / scale;
+        /* coordinate (0.0,0.0) is in the center of pixel (0,0),
+           so the pixel with xc=0 get the values of xx from -0.5 to 0.5 */
+        const int xc = (int) floor( xx + 0.5 );
+        gaussian_kernel( th_kernel, sigma, (double) h + xx - (double) xc );
+        /* the kernel must be computed for each x because the fine
+           offset xx-xc is different in each case */
+
+        for(unsigned int yi=0; yi<aux->ysize; yi++)
+          {
+            double sum = 0.0;
+            for(unsigned int ii=0; ii<th_kernel->dim; ii++)
+              {
+                int j1 = xc - (int)h + (int)ii;
+
+                /* symmetry boundary condition */
+                while( j1 < 0 ) j1 += double_x_size;
+                while( j1 >= double_x_size ) j1 -= double_x_size;
+                if( j1 >= (int) in->xsize ) j1 = double_x_size-1-j1;
+
+                sum += in->data[ j1 + yi * in->xsize ] * th_kernel->values[ii];
+              }
+            aux->data[ xi + yi * aux->xsize ] = sum;
+          }
+      }
+    free_ntuple_list(th_kernel);
+  }
 
   /* Second subsampling: y axis */
-  for(y=0;y<out->ysize;y++)
-    {
-      /*
-         y   is the coordinate in the new image.
-         yy  is the corresponding x-value in the original size image.
-         yc  is the integer value, the pixel coordinate of xx.
-       */
-      yy = (double) y / scale;
-      /* coordinate (0.0,0.0) is in the center of pixel (0,0),
-         so the pixel with yc=0 get the values of yy from -0.5 to 0.5 */
-      yc = (int) floor( yy + 0.5 );
-      gaussian_kernel( kernel, sigma, (double) h + yy - (double) yc );
-      /* the kernel must be computed for each y because the fine
-         offset yy-yc is different in each case */
-
-      for(x=0;x<out->xsize;x++)
-        {
-          sum = 0.0;
-          for(i=0;i<kernel->dim;i++)
-            {
-              j = yc - h + i;
-
-              /* symmetry boundary condition */
-              while( j < 0 ) j += double_y_size;
-              while( j >= double_y_size ) j -= double_y_size;
-              if( j >= (int) in->ysize ) j = double_y_size-1-j;
-
-              sum += aux->data[ x + j * aux->xsize ] * kernel->values[i];
-            }
-          out->data[ x + y * out->xsize ] = sum;
-        }
-    }
+  DT_OMP_PRAGMA(parallel)
+  {
+    const ntuple_list th_kernel = new_ntuple_list(n);
+    DT_OMP_PRAGMA(for schedule(static))
+    for(int yi=0; yi<(int)out->ysize; yi++)
+      {
+        /*
+           yi  is the coordinate in the new image.
+           yy  is the corresponding x-value in the original size image.
+           yc  is the integer value, the pixel coordinate of xx.
+         */
+        const double yy = (double) yi / scale;
+        /* coordinate (0.0,0.0) is in the center of pixel (0,0),
+           so the pixel with yc=0 get the values of yy from -0.5 to 0.5 */
+        const int yc = (int) floor( yy + 0.5 );
+        gaussian_kernel( th_kernel, sigma, (double) h + yy - (double) yc );
+        /* the kernel must be computed for each y because the fine
+           offset yy-yc is different in each case */
+
+        for(unsigned int xi=0; xi<out->xsize; xi++)
+          {
+            double sum = 0.0;
+            for(unsigned int ii=0; ii<th_kernel->dim; ii++)
+              {
+                int j1 = yc - (int)h + (int)ii;
+
+                /* symmetry boundary condition */
+                while( j1 < 0 ) j1 += double_y_size;
+                while( j1 >= double_y_size ) j1 -= double_y_size;
+                if( j1 >= (int) in->ysize ) j1 = double_y_size-1-j1;
+
+                sum += aux->data[ xi + j1 * aux->xsize ] * th_kernel->values[ii];
+              }
+            out->data[ xi + yi * out->xsize ] = sum;
+          }
+      }
+    free_ntuple_list(th_kernel);
+  }
 
   /* free memory */
-  free_ntuple_list(kernel);
   free_image_double(aux);
 
   return out;
@@ -784,8 +795,8 @@ static image_double ll_angle(const image_double in, const double threshold,
                               image_double * modgrad, const unsigned int n_bins )
 {
   image_double g;
-  unsigned int n,p,x,y,adr,i;
-  double com1,com2,gx,gy,norm,norm2;
+  unsigned int n,p,x,y,i;
+  double norm;
   /* the rest of the variables are used for pseudo-ordering
      the gradient magnitude values */
   int list_count = 0;
@@ -835,11 +846,13 @@ static image_double ll_angle(const image_double in, const double threshold,
   for(x=0;x<p;x++) g->data[(n-1)*p+x] = NOTDEF;
   for(y=0;y<n;y++) g->data[p*y+p-1]   = NOTDEF;
 
-  /* compute gradient on the remaining pixels */
-  for(x=0;x<p-1;x++)
-    for(y=0;y<n-1;y++)
+  /* compute gradient on the remaining pixels; each pixel only reads its
+     2x2 window and writes its own entry, so rows are independent */
+  DT_OMP_FOR(reduction(max : max_grad))
+  for(unsigned int yi=0; yi<n-1; yi++)
+    for(unsigned int xi=0; xi<p-1; xi++)
       {
-        adr = y*p+x;
+        const unsigned int adr = yi*p+xi;
 
         /*
            Norm 2 computation using 2x2 pixel window:
@@ -852,13 +865,13 @@ static image_double ll_angle(const image_double in, const double threshold,
              gy = C+D - (A+B)   vertical difference
            com1 and com2 are just to avoid 2 additions.
          */
-        com1 = in->data[adr+p+1] - in->data[adr];
-        com2 = in->data[adr+1]   - in->data[adr+p];
+        const double com1 = in->data[adr+p+1] - in->data[adr];
+        const double com2 = in->data[adr+1]   - in->data[adr+p];
 
-        gx = com1+com2; /* gradient x component */
-        gy = com1-com2; /* gradient y component */
-        norm2 = gx*gx+gy*gy;
-        norm = sqrt( norm2 / 4.0 ); /* gradient norm */
+        const double gx = com1+com2; /* gradient x component */
+        const double gy = com1-com2; /* gradient y component */
+        const double norm2 = gx*gx+gy*gy;
+        const double norm = sqrt( norm2 / 4.0 ); /* gradient norm */
 
         (*modgrad)->data[adr] = norm; /* store gradient norm */
 
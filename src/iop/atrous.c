@@ -37,8 +37,6 @@
 #include <memory.h>
 #include <stdlib.h>
 
-//#define USE_NEW_CL  //uncomment to use the new, more memory-efficient OpenCL code (not yet finished)
-
 #define INSET DT_PIXEL_APPLY_DPI(5)
 
 DT_MODULE_INTROSPECTION(2, dt_iop_atrous_params_t)
@@ -284,7 +282,7 @@ static void process_wavelets(dt_iop_module_t *self,
   dt_aligned_pixel_t boost[MAX_NUM_SCALES];
   float sharp[MAX_NUM_SCALES];
   const int max_scale = get_scales(thrs, boost, sharp, d, roi_in, piece);
-  const int max_mult = 1u << (max_scale - 1);
+  const int max_mult = 1u << MAX(max_scale - 1, 0);
 
   const int width = roi_out->width;
   const int height = roi_out->height;
@@ -299,7 +297,7 @@ static void process_wavelets(dt_iop_module_t *self,
 
   // corner case of extremely small image. this is not really likely
   // to happen but would lead to out of bounds memory access
-  if(width < 2 * max_mult || height < 2 * max_mult)
+  if(max_scale == 0 || width < 2 * max_mult || height < 2 * max_mult)
   {
     dt_iop_image_copy_by_size(o, i, width, height, 4);
     return;
@@ -323,11 +321,13 @@ static void process_wavelets(dt_iop_module_t *self,
 
   // now do the wavelet decomposition, immediately synthesizing the
   // detail scale into the final output so that we don't need to store
-  // it past the current scale's iteration
+  // it past the current scale's iteration.  the last scale also folds
+  // the coarse residue into the output, saving a final sweep over the
+  // buffer - which matters most when tiling has us memory-bound
   for(int scale = 0; scale < max_scale; scale++)
   {
     eaw_decompose_and_synthesize(buf2, buf1, out, scale, sharp[scale], thrs[scale],
-                                 boost[scale], width, height);
+                                 boost[scale], scale == max_scale - 1, width, height);
     if(scale == 0) buf1 = (float *)tmp2; // now switch to second
                                          // scratch for buffer
                                          // ping-pong between buf1 and
@@ -337,11 +337,6 @@ static void process_wavelets(dt_iop_module_t *self,
     buf1 = buf3;
   }
 
-  // add in the final residue
-  DT_OMP_FOR_SIMD(aligned(buf1, out : 64) num_threads(MIN(dt_get_num_threads(),16)))
-  for(size_t k = 0; k < (size_t)4 * width * height; k++)
-    out[k] += buf1[k];
-
   dt_free_align(tmp);
   dt_free_align(tmp2);
   return;
@@ -359,7 +354,6 @@ void process(dt_iop_module_t *self,
 
 #ifdef HAVE_OPENCL
 
-#ifdef USE_NEW_CL
 /* this version is adapted to the new global tiling mechanism. it no
  * longer does tiling by itself. */
 int process_cl(dt_iop_module_t *self,
@@ -392,6 +386,7 @@ int process_cl(dt_iop_module_t *self,
   cl_mem dev_tmp = NULL;
   cl_mem dev_tmp2 = NULL;
   cl_mem dev_detail = NULL;
+  cl_mem dev_accum = NULL;
 
   float m[] = { 0.0625f, 0.25f, 0.375f, 0.25f, 0.0625f }; // 1/16, 4/16, 6/16, 4/16, 1/16
   float mm[5][5];
@@ -411,35 +406,50 @@ int process_cl(dt_iop_module_t *self,
     (devid, roi_out->width, roi_out->height, sizeof(float) * 4);
   if(dev_tmp2 == NULL) goto error;
 
-  /* allocate a buffer for storing the detail information. */
+  /* allocate a single buffer for storing the detail information; it is
+   * consumed right after each decomposition, so all scales can share it */
   dev_detail = dt_opencl_alloc_device
     (devid, roi_out->width, roi_out->height, sizeof(float) * 4);
   if(dev_detail == NULL) goto error;
 
+  /* allocate the second half of the accumulator ping-pong (the first
+   * half is dev_out) */
+  dev_accum = dt_opencl_alloc_device
+    (devid, roi_out->width, roi_out->height, sizeof(float) * 4);
+  if(dev_accum == NULL) goto error;
+
   const int width = roi_out->width;
   const int height = roi_out->height;
   size_t sizes[] = { ROUNDUPDWD(width, devid), ROUNDUPDHT(height, devid), 1 };
 
-  // clear dev_out to zeros, as we will be incrementally accumulating results there
-  dt_opencl_set_kernel_args(devid, gd->kernel_zero, 0, CLARG(dev_out));
+  // the coarse scales ping-pong between dev_tmp and dev_tmp2.  We
+  // start with dev_in as the input half for the first scale, as dev_in
+  // needs to stay unchanged for blendops
+  cl_mem dev_cur = dev_in;
+  cl_mem dev_coarse = dev_tmp;
+
+  // the thresholded details are summed up in a second ping-pong
+  // between dev_accum and dev_out; pick the starting half by parity so
+  // the sum ends up in dev_accum and the final combination below never
+  // reads and writes the same image
+  cl_mem dev_acc = (max_scale & 1) ? dev_out : dev_accum;
+
+  // clear the starting accumulator, as we will be incrementally accumulating results there
+  dt_opencl_set_kernel_args(devid, gd->kernel_zero, 0, CLARG(dev_acc),
+                            CLARG(width), CLARG(height));
   err = dt_opencl_enqueue_kernel_2d(devid, gd->kernel_zero, sizes);
   if(err != CL_SUCCESS) goto error;
 
-  // the buffers for the buffer ping-pong.  We start with dev_in as
-  // the input half for the first scale, then switch to using dev_tmp
-  // and dev_tmp2 as the two scratch buffers
-  void* dev_buf1 = &dev_in;
-  void* dev_buf2 = &dev_tmp;
-
-  /* decompose image into detail scales and coarse (the latter is left
-   * in dev_tmp or dev_out) */
+  /* decompose the image one scale at a time, pushing the thresholded
+   * and boosted details onto the accumulator right away so that a
+   * single full-size detail buffer serves all scales */
   for(int s = 0; s < max_scale; s++)
   {
     const int scale = s;
 
     // run the decomposition
     dt_opencl_set_kernel_args(devid, gd->kernel_decompose, 0,
-                              CLARG(dev_buf2), CLARG(dev_buf1), CLARG(dev_detail),
+                              CLARG(dev_cur), CLARG(dev_coarse), CLARG(dev_detail),
                               CLARG(width), CLARG(height),
                               CLARG(scale), CLARG(sharp[s]), CLARG(dev_filter));
 
@@ -449,9 +459,11 @@ int process_cl(dt_iop_module_t *self,
     // indirectly give gpu some air to breathe (and to do display related stuff)
     dt_opencl_micro_nap(devid);
 
-    // now immediately run the synthesis for the current scale, accumulating the details into dev_out
+    // now immediately run the synthesis for the current scale, adding the
+    // details to the other half of the accumulator ping-pong
+    cl_mem dev_acc_next = (dev_acc == dev_accum) ? dev_out : dev_accum;
     dt_opencl_set_kernel_args(devid, gd->kernel_synthesize, 0,
-                              CLARG(dev_out), CLARG(dev_out), CLARG(dev_detail),
+                              CLARG(dev_acc_next), CLARG(dev_acc), CLARG(dev_detail),
                               CLARG(width), CLARG(height),
                               CLARG(thrs[scale][0]), CLARG(thrs[scale][1]),
                               CLARG(thrs[scale][2]), CLARG(thrs[scale][3]),
@@ -464,162 +476,32 @@ int process_cl(dt_iop_module_t *self,
     // indirectly give gpu some air to breathe (and to do display related stuff)
     dt_opencl_micro_nap(devid);
 
-    // swap scratch buffers
-    if(scale == 0) dev_buf1 = dev_tmp2;
-    void* tmp = dev_buf2;
-    dev_buf2 = dev_buf1;
-    dev_buf1 = tmp;
-  }
-
-  // add the residue (the coarse scale from the final decomposition)
-  // to the accumulated details
-  dt_opencl_set_kernel_args
-    (devid, gd->kernel_addbuffers, 0, CLARG(dev_out), CLARG(dev_buf1));
+    dev_acc = dev_acc_next;
 
-  err = dt_opencl_enqueue_kernel_2d(devid, gd->kernel_addbuffers, sizes);
-
-error:
-  dt_opencl_release_mem_object(dev_filter);
-  dt_opencl_release_mem_object(dev_tmp);
-  dt_opencl_release_mem_object(dev_tmp2);
-  dt_opencl_release_mem_object(dev_detail);
-  return err;
-}
-
-#else // ======== old, memory-hungry implementation ========================================================
-
-/* this version is adapted to the new global tiling mechanism. it no longer does tiling by itself. */
-int process_cl(dt_iop_module_t *self,
-               dt_dev_pixelpipe_iop_t *piece,
-               cl_mem dev_in, cl_mem dev_out,
-               const dt_iop_roi_t *const roi_in,
-               const dt_iop_roi_t *const roi_out)
-{
-  dt_iop_atrous_data_t *d = piece->data;
-  dt_aligned_pixel_t thrs[MAX_NUM_SCALES];
-  dt_aligned_pixel_t boost[MAX_NUM_SCALES];
-  float sharp[MAX_NUM_SCALES];
-  const int max_scale = get_scales(thrs, boost, sharp, d, roi_in, piece);
-
-  if(self->dev->gui_attached && (piece->pipe->type & DT_DEV_PIXELPIPE_FULL))
-  {
-    dt_iop_atrous_gui_data_t *g = self->gui_data;
-    g->num_samples = get_samples(g->sample, d, roi_in, piece);
-    // dt_control_queue_redraw_widget(GTK_WIDGET(g->area));
-    // tries to acquire gdk lock and this prone to deadlock:
-    // dt_control_queue_draw(GTK_WIDGET(g->area));
+    // swap the coarse buffers
+    dev_cur = dev_coarse;
+    dev_coarse = (dev_coarse == dev_tmp) ? dev_tmp2 : dev_tmp;
   }
 
-  dt_iop_atrous_global_data_t *gd = self->global_data;
-
-  const int devid = piece->pipe->devid;
-  cl_int err = DT_OPENCL_DEFAULT_ERROR;
-  cl_mem dev_filter = NULL;
-  cl_mem dev_tmp = NULL;
-  cl_mem *dev_detail = calloc(max_scale, sizeof(cl_mem));
-
-  float m[] = { 0.0625f, 0.25f, 0.375f, 0.25f, 0.0625f }; // 1/16, 4/16, 6/16, 4/16, 1/16
-  float mm[5][5];
-  for(int j = 0; j < 5; j++)
-    for(int i = 0; i < 5; i++)
-      mm[j][i] = m[i] * m[j];
-
-  dev_filter = dt_opencl_copy_host_to_device_constant(devid, sizeof(float) * 25, mm);
-  if(dev_filter == NULL) goto error;
+  // add the residue (the coarse scale from the final decomposition) to
+  // the accumulated details; dev_acc is dev_accum here, never dev_out
+  dt_opencl_set_kernel_args(devid, gd->kernel_addbuffers, 0,
+                            CLARG(dev_out), CLARG(dev_cur), CLARG(dev_acc),
+                            CLARG(width), CLARG(height));
 
-  /* allocate space for a temporary buffer. we don't want to use
-     dev_in in the buffer ping-pong below, as we need to keep it for
-     blendops */
-  dev_tmp = dt_opencl_alloc_device
-    (devid, roi_out->width, roi_out->height, sizeof(float) * 4);
-  if(dev_tmp == NULL) goto error;
-
-  /* allocate space to store detail information. Requires a number of
-   * additional buffers, each with full image size */
-  for(int k = 0; k < max_scale; k++)
-  {
-    dev_detail[k] = dt_opencl_alloc_device
-      (devid, roi_out->width, roi_out->height, sizeof(float) * 4);
-    if(dev_detail[k] == NULL) goto error;
-  }
-
-  const int width = roi_out->width;
-  const int height = roi_out->height;
-  size_t sizes[] = { ROUNDUPDWD(width, devid), ROUNDUPDHT(height, devid), 1 };
-  size_t origin[] = { 0, 0, 0 };
-  size_t region[] = { width, height, 1 };
-
-  // copy original input from dev_in -> dev_out as starting point
-  err = dt_opencl_enqueue_copy_image(devid, dev_in, dev_out, origin, origin, region);
+  err = dt_opencl_enqueue_kernel_2d(devid, gd->kernel_addbuffers, sizes);
   if(err != CL_SUCCESS) goto error;
 
-  /* decompose image into detail scales and coarse (the latter is left
-   * in dev_tmp or dev_out) */
-  for(int s = 0; s < max_scale; s++)
-  {
-    const int scale = s;
-
-    if(s & 1)
-    {
-      dt_opencl_set_kernel_args(devid, gd->kernel_decompose, 0,
-                                CLARG(dev_tmp), CLARG(dev_out));
-    }
-    else
-    {
-      dt_opencl_set_kernel_args(devid, gd->kernel_decompose, 0,
-                                CLARG(dev_out), CLARG(dev_tmp));
-    }
-    dt_opencl_set_kernel_args(devid, gd->kernel_decompose, 2,
-                              CLARG(dev_detail[s]), CLARG(width), CLARG(height),
-                              CLARG(scale), CLARG(sharp[s]), CLARG(dev_filter));
-
-    err = dt_opencl_enqueue_kernel_2d(devid, gd->kernel_decompose, sizes);
-    if(err != CL_SUCCESS) goto error;
-
-    // indirectly give gpu some air to breathe (and to do display related stuff)
-    dt_opencl_micro_nap(devid);
-  }
-
-  /* now synthesize again */
-  for(int scale = max_scale - 1; scale >= 0; scale--)
-  {
-    if(scale & 1)
-    {
-      dt_opencl_set_kernel_args(devid, gd->kernel_synthesize, 0,
-                                CLARG(dev_tmp), CLARG(dev_out));
-    }
-    else
-    {
-      dt_opencl_set_kernel_args(devid, gd->kernel_synthesize, 0,
-                                CLARG(dev_out), CLARG(dev_tmp));
-    }
-
-    dt_opencl_set_kernel_args(devid, gd->kernel_synthesize, 2,
-                              CLARG(dev_detail[scale]), CLARG(width),
-                              CLARG(height), CLARG(thrs[scale][0]),
-                              CLARG(thrs[scale][1]), CLARG(thrs[scale][2]),
-                              CLARG(thrs[scale][3]), CLARG(boost[scale][0]),
-                              CLARG(boost[scale][1]), CLARG(boost[scale][2]),
-                              CLARG(boost[scale][3]));
-
-    err = dt_opencl_enqueue_kernel_2d(devid, gd->kernel_synthesize, sizes);
-    if(err != CL_SUCCESS) goto error;
-
-    // indirectly give gpu some air to breathe (and to do display related stuff)
-    dt_opencl_micro_nap(devid);
-  }
-
   dt_opencl_finish_sync_pipe(devid, piece->pipe->type);
 
 error:
   dt_opencl_release_mem_object(dev_filter);
   dt_opencl_release_mem_object(dev_tmp);
-  for(int k = 0; k < max_scale; k++)
-    dt_opencl_release_mem_object(dev_detail[k]);
-  free(dev_detail);
+  dt_opencl_release_mem_object(dev_tmp2);
+  dt_opencl_release_mem_object(dev_detail);
+  dt_opencl_release_mem_object(dev_accum);
   return err;
 }
-#endif // USE_NEW_CL
 
 #endif // HAVE_OPENCL
 
@@ -636,8 +518,8 @@ void tiling_callback(dt_iop_module_t *self,
   const int max_scale = get_scales(thrs, boost, sharp, d, roi_in, piece);
   const int max_filter_radius = 2 * (1 << max_scale); // 2 * 2^max_scale
 
-  tiling->factor = 4.0f;                // in + out + 2*tmp
-  tiling->factor_cl = 3.0f + max_scale; // in + out + tmp + scale buffers
+  tiling->factor = 4.0f;    // in + out + 2*tmp
+  tiling->factor_cl = 6.0f; // in + out + 2*tmp + detail + accum
   tiling->maxbuf = 1.0f;
   tiling->maxbuf_cl = 1.0f;
   tiling->overhead = 0;
@@ -668,10 +550,8 @@ void init_global(dt_iop_module_so_t *self)
   self->data = gd;
   gd->kernel_decompose = dt_opencl_create_kernel(program, "eaw_decompose");
   gd->kernel_synthesize = dt_opencl_create_kernel(program, "eaw_synthesize");
-#ifdef USE_NEW_CL
   gd->kernel_zero = dt_opencl_create_kernel(program, "eaw_zero");
   gd->kernel_addbuffers = dt_opencl_create_kernel(program, "eaw_addbuffers");
-#endif
 }
 
 void cleanup_global(dt_iop_module_so_t *self)
@@ -679,10 +559,8 @@ void cleanup_global(dt_iop_module_so_t *self)
   dt_iop_atrous_global_data_t *gd = self->data;
   dt_opencl_free_kernel(gd->kernel_decompose);
   dt_opencl_free_kernel(gd->kernel_synthesize);
-#ifdef USE_NEW_CL
   dt_opencl_free_kernel(gd->kernel_zero);
   dt_opencl_free_kernel(gd->kernel_addbuffers);
-#endif
   free(self->data);
   self->data = NULL;
 }
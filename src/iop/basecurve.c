@@ -329,6 +329,7 @@ typedef struct dt_iop_basecurve_data_t
   dt_draw_curve_t *curve; // curve for pixelpipe piece and pixel processing
   int basecurve_type;
   int basecurve_nodes;
+  dt_hash_t curve_hash;   // hash of the curve the table was built from
   float table[0x10000];      // precomputed look-up table for tone curve
   float unbounded_coeffs[3]; // approximation for extrapolation
   int exposure_fusion;
@@ -1113,7 +1114,7 @@ static inline void gauss_blur(
     const size_t ht)
 {
   const float w[5] = { 1.f / 16.f, 4.f / 16.f, 6.f / 16.f, 4.f / 16.f, 1.f / 16.f };
-  float *tmp = dt_alloc_align_float((size_t)4 * wd * ht);
+  float *tmp = (float *)dt_bufpool_alloc(sizeof(float) * 4 * wd * ht);
   dt_iop_image_fill(tmp, 0.0f, wd, ht, 4);
   DT_OMP_FOR()
   for(int j=0;j<ht;j++)
@@ -1151,7 +1152,7 @@ static inline void gauss_blur(
         for_four_channels(c)
           output[4*(j*wd+i)+c] += tmp[4*(MIN(j+jj, ht-(j+jj-ht+1))*wd+i)+c] * w[jj+2];
   }
-  dt_free_align(tmp);
+  dt_bufpool_free(tmp);
 }
 
 static inline void gauss_expand(
@@ -1187,7 +1188,7 @@ static inline void gauss_reduce(
   // blur, store only coarse res
   const size_t cw = (wd-1)/2+1, ch = (ht-1)/2+1;
 
-  float *blurred = dt_alloc_align_float((size_t)4 * wd * ht);
+  float *blurred = (float *)dt_bufpool_alloc(sizeof(float) * 4 * wd * ht);
   if(blurred)
   {
     gauss_blur(input, blurred, wd, ht);
@@ -1197,18 +1198,20 @@ static inline void gauss_reduce(
     blurred = (float*)input;
     dt_print(DT_DEBUG_ALWAYS,"[basecurve] gauss_reduce out of memory, skipping blurring");
   }
+  DT_OMP_FOR()
   for(size_t j=0;j<ch;j++)
     for(size_t i=0;i<cw;i++)
       for_four_channels(c)
         coarse[4*(j*cw+i)+c] = blurred[4*(2*j*wd+2*i)+c];
   if(blurred != input)
-    dt_free_align(blurred);
+    dt_bufpool_free(blurred);
 
   if(detail)
   {
     // compute laplacian/details: expand coarse buffer into detail
     // buffer subtract expanded buffer from input in place
     gauss_expand(coarse, detail, wd, ht);
+    DT_OMP_FOR()
     for(size_t k=0;k<wd*ht*4;k++)
       detail[k] = input[k] - detail[k];
   }
@@ -1238,8 +1241,10 @@ void process_fusion(dt_iop_module_t *self,
   for(int k = 0; k < num_levels; k++)
   {
     // coarsest step is some % of image width.
-    col[k]  = dt_alloc_align_float((size_t)4 * w * h);
-    comb[k] = dt_alloc_align_float((size_t)4 * w * h);
+    // pyramid levels are large and rebuilt on every interaction, so take
+    // them from the buffer pool instead of faulting in fresh pages
+    col[k]  = (float *)dt_bufpool_alloc(sizeof(float) * 4 * w * h);
+    comb[k] = (float *)dt_bufpool_alloc(sizeof(float) * 4 * w * h);
     if(!col[k] || !comb[k])
     {
       dt_iop_copy_image_roi(ovoid, ivoid, piece->colors, roi_in, roi_out);
@@ -1379,8 +1384,8 @@ void process_fusion(dt_iop_module_t *self,
 cleanup:
   for(int k = 0; k < num_levels; k++)
   {
-    dt_free_align(col[k]);
-    dt_free_align(comb[k]);
+    dt_bufpool_free(col[k]);
+    dt_bufpool_free(comb[k]);
   }
   free(col);
   free(comb);
@@ -1462,6 +1467,13 @@ void commit_params(dt_iop_module_t *self,
     for(int k = 0; k < p->basecurve_nodes[ch]; k++)
       dt_draw_curve_set_point(d->curve, k, p->basecurve[ch][k].x, p->basecurve[ch][k].y);
   }
+
+  // skip the costly resampling if the nodes did not change since the
+  // table was built - most commits touch other parameters of the module
+  const dt_hash_t hash = dt_draw_curve_hash(d->curve);
+  if(hash == d->curve_hash) return;
+  d->curve_hash = hash;
+
   dt_draw_curve_calc_values(d->curve, 0.0f, 1.0f, 0x10000, NULL, d->table);
 
   // now the extrapolation stuff:
@@ -24,6 +24,7 @@
 #include "iop/iop_api.h"
 
 // #include <fftw3.h> // one day, include FFT convolution
+#include "common/imagebuf.h"
 #include "common/math.h"
 #include <gtk/gtk.h>
 #include <stdlib.h>
@@ -552,10 +553,43 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece,
   // Init the blur kernel
   const int radius = MAX(roundf(p->radius / scale), 2);
   const size_t kernel_width = 2 * radius + 1;
+  const size_t kernel_size = kernel_width * kernel_width;
+
+  float *const restrict kernel = dt_alloc_align_float(kernel_size);
+
+  // Lens and motion kernels are sparse: all the taps outside the
+  // aperture shape or the motion path are exactly zero, so the direct
+  // convolution wastes most of its time multiplying by zero.  Compact
+  // the kernel into a list of non-zero taps first; for a thin motion
+  // path this reduces the work by orders of magnitude.
+  int *const restrict tap_pos = dt_alloc_aligned(kernel_size * 2 * sizeof(int));
+  int *const restrict tap_shift = dt_alloc_aligned(kernel_size * sizeof(int));
+  float *const restrict tap_weight = dt_alloc_align_float(kernel_size);
+
+  if(!kernel || !tap_pos || !tap_shift || !tap_weight)
+  {
+    dt_print(DT_DEBUG_ALWAYS,"[blurs] out of memory, skipping");
+    dt_iop_copy_image_roi(ovoid, ivoid, piece->colors, roi_in, roi_out);
+    goto cleanup;
+  }
 
-  float *const restrict kernel = dt_alloc_align_float(kernel_width * kernel_width);
   _build_pixel_kernel(kernel, kernel_width, kernel_width, p);
 
+  size_t ntaps = 0;
+  for(int l = -radius; l <= radius; l++)
+    for(int m = -radius; m <= radius; m++)
+    {
+      const float k = kernel[(size_t)(l + radius) * kernel_width + (m + radius)];
+      if(k != 0.f)
+      {
+        tap_pos[2 * ntaps] = l;
+        tap_pos[2 * ntaps + 1] = m;
+        tap_shift[ntaps] = (l * roi_out->width + m) * 4;
+        tap_weight[ntaps] = k;
+        ntaps++;
+      }
+    }
+
   DT_OMP_FOR(collapse(2))
   for(int i = 0; i < roi_out->height; i++)
     for(int j = 0; j < roi_out->width; j++)
@@ -566,39 +600,27 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece,
       if(i >= radius && j >= radius && i < roi_out->height - radius && j < roi_out->width - radius)
       {
         // We are in the safe area, no need to check for out-of-bounds
-        for(int l = -radius; l <= radius; l++)
-          for(int m = -radius; m <= radius; m++)
-          {
-            const int ii = i + l;
-            const int jj = j + m;
-            const size_t idx_shift = ((ii * roi_out->width) + jj) * 4;
-
-            const int ik = l + radius;
-            const int jk = m + radius;
-            const size_t idx_kernel = (ik * kernel_width) + jk;
-            const float k = kernel[idx_kernel];
-
-            for_four_channels(c, aligned(in : 64)) acc[c] += k * in[idx_shift + c];
-          }
+        for(size_t t = 0; t < ntaps; t++)
+        {
+          const float k = tap_weight[t];
+          const ptrdiff_t idx_shift = (ptrdiff_t)index + tap_shift[t];
+
+          for_four_channels(c, aligned(in : 64)) acc[c] += k * in[idx_shift + c];
+        }
       }
       else
       {
         // We are close to borders, we need to clamp indices to bounds
         // assume constant boundary conditions
-        for(int l = -radius; l <= radius; l++)
-          for(int m = -radius; m <= radius; m++)
-          {
-            const int ii = CLAMP((int)i + l, (int)0, (int)roi_out->height - 1);
-            const int jj = CLAMP((int)j + m, (int)0, (int)roi_out->width - 1);
-            const size_t idx_shift = ((ii * roi_out->width) + jj) * 4;
-
-            const int ik = l + radius;
-            const int jk = m + radius;
-            const size_t idx_kernel = (ik * kernel_width) + jk;
-            const float k = kernel[idx_kernel];
-
-            for_four_channels(c, aligned(in : 64)) acc[c] += k * in[idx_shift + c];
-          }
+        for(size_t t = 0; t < ntaps; t++)
+        {
+          const int ii = CLAMP((int)i + tap_pos[2 * t], (int)0, (int)roi_out->height - 1);
+          const int jj = CLAMP((int)j + tap_pos[2 * t + 1], (int)0, (int)roi_out->width - 1);
+          const size_t idx_shift = ((ii * roi_out->width) + jj) * 4;
+          const float k = tap_weight[t];
+
+          for_four_channels(c, aligned(in : 64)) acc[c] += k * in[idx_shift + c];
+        }
       }
 
       for_each_channel(c, aligned(out : 64) aligned(acc : 16)) out[index + c] = acc[c];
@@ -606,7 +628,12 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece,
       // copy alpha
       out[index + 3] = in[index + 3];
     }
+
+cleanup:
   dt_free_align(kernel);
+  dt_free_align(tap_pos);
+  dt_free_align(tap_shift);
+  dt_free_align(tap_weight);
 }
 
 
@@ -361,6 +361,10 @@ void process(dt_iop_module_t *self,
   float blocksqave[2][2] = { { 0, 0 }, { 0, 0 } };
   float blockdenom[2][2] = { { 0, 0 }, { 0, 0 } };
   float blockvar[2][2];
+  // polynomial fit matrices, accumulated over the block grid
+  double polymat[2][2][256];
+  double shiftmat[2][2][16];
+  int numblox[2];
   // order of 2d polynomial fit (polyord), and numpar=polyord^2
   int polyord = 4;
   int numpar = 16;
@@ -731,75 +735,112 @@ void process(dt_iop_module_t *self,
           }
           // end of filling border pixels of blockshift array
           // initialize fit arrays
-          double polymat[2][2][256];
-          double shiftmat[2][2][16];
-
           for(int i = 0; i < 256; i++)
             polymat[0][0][i] = polymat[0][1][i] = polymat[1][0][i] = polymat[1][1][i] = 0;
 
           for(int i = 0; i < 16; i++)
             shiftmat[0][0][i] = shiftmat[0][1][i] = shiftmat[1][0][i] = shiftmat[1][1][i] = 0;
 
-          int numblox[2] = { 0, 0 };
+          numblox[0] = numblox[1] = 0;
+        }
+      }
 
-          for(int vblock = 1; vblock < vert_tiles - 1; vblock++)
+      // accumulate the fit matrices over the block grid; every thread
+      // collects into local arrays which are merged under a critical
+      // section just like the diagnostic pass above
+      if(processpasstwo)
+      {
+        double polymatthr[2][2][256];
+        double shiftmatthr[2][2][16];
+        int numbloxthr[2] = { 0, 0 };
+
+        for(int i = 0; i < 256; i++)
+          polymatthr[0][0][i] = polymatthr[0][1][i] = polymatthr[1][0][i] = polymatthr[1][1][i] = 0;
+
+        for(int i = 0; i < 16; i++)
+          shiftmatthr[0][0][i] = shiftmatthr[0][1][i] = shiftmatthr[1][0][i] = shiftmatthr[1][1][i] = 0;
+
+        DT_OMP_PRAGMA(for collapse(2) schedule(static) nowait)
+        for(int vblock = 1; vblock < vert_tiles - 1; vblock++)
+        {
+          for(int hblock = 1; hblock < horiz_tiles - 1; hblock++)
           {
-            for(int hblock = 1; hblock < horiz_tiles - 1; hblock++)
+            // block 3x3 median of blockshifts for robustness
+            for(int c = 0; c < 2; c++)
             {
-              // block 3x3 median of blockshifts for robustness
-              for(int c = 0; c < 2; c++)
+              float bstemp[2];
+              for(int dir = 0; dir < 2; dir++)
               {
-                float bstemp[2];
-                for(int dir = 0; dir < 2; dir++)
-                {
-                  const float p[9]  __attribute__((aligned(16))) =
-                        { blockshifts[(vblock - 1) * horiz_tiles + hblock - 1][c][dir],
-                          blockshifts[(vblock - 1) * horiz_tiles + hblock    ][c][dir],
-                          blockshifts[(vblock - 1) * horiz_tiles + hblock + 1][c][dir],
-                          blockshifts[(vblock)     * horiz_tiles + hblock - 1][c][dir],
-                          blockshifts[(vblock)     * horiz_tiles + hblock    ][c][dir],
-                          blockshifts[(vblock)     * horiz_tiles + hblock + 1][c][dir],
-                          blockshifts[(vblock + 1) * horiz_tiles + hblock - 1][c][dir],
-                          blockshifts[(vblock + 1) * horiz_tiles + hblock    ][c][dir],
-                          blockshifts[(vblock + 1) * horiz_tiles + hblock + 1][c][dir] };
-                  bstemp[dir] = median9f(p);
-                }
-                  // now prepare coefficient matrix; use only data points within caautostrength/2 std devs of zero
-                if(sqrf(bstemp[0]) > caautostrength * blockvar[0][c] || sqrf(bstemp[1]) > caautostrength * blockvar[1][c])
-                  continue;
+                const float p[9]  __attribute__((aligned(16))) =
+                      { blockshifts[(vblock - 1) * horiz_tiles + hblock - 1][c][dir],
+                        blockshifts[(vblock - 1) * horiz_tiles + hblock    ][c][dir],
+                        blockshifts[(vblock - 1) * horiz_tiles + hblock + 1][c][dir],
+                        blockshifts[(vblock)     * horiz_tiles + hblock - 1][c][dir],
+                        blockshifts[(vblock)     * horiz_tiles + hblock    ][c][dir],
+                        blockshifts[(vblock)     * horiz_tiles + hblock + 1][c][dir],
+                        blockshifts[(vblock + 1) * horiz_tiles + hblock - 1][c][dir],
+                        blockshifts[(vblock + 1) * horiz_tiles + hblock    ][c][dir],
+                        blockshifts[(vblock + 1) * horiz_tiles + hblock + 1][c][dir] };
+                bstemp[dir] = median9f(p);
+              }
+                // now prepare coefficient matrix; use only data points within caautostrength/2 std devs of zero
+              if(sqrf(bstemp[0]) > caautostrength * blockvar[0][c] || sqrf(bstemp[1]) > caautostrength * blockvar[1][c])
+                continue;
 
-                numblox[c]++;
-                double powVblockInit = 1.0;
-                for(int i = 0; i < polyord; i++)
+              numbloxthr[c]++;
+              double powVblockInit = 1.0;
+              for(int i = 0; i < polyord; i++)
+              {
+                double powHblockInit = 1.0;
+                for(int j = 0; j < polyord; j++)
                 {
-                  double powHblockInit = 1.0;
-                  for(int j = 0; j < polyord; j++)
+                  double powVblock = powVblockInit;
+                  for(int m = 0; m < polyord; m++)
                   {
-                    double powVblock = powVblockInit;
-                    for(int m = 0; m < polyord; m++)
+                    double powHblock = powHblockInit;
+                    for(int n = 0; n < polyord; n++)
                     {
-                      double powHblock = powHblockInit;
-                      for(int n = 0; n < polyord; n++)
-                      {
-                        double inc = powVblock * powHblock * blockwt[vblock * horiz_tiles + hblock];
-                        size_t idx = numpar * (polyord * i + j) + (polyord * m + n);
-                        polymat[c][0][idx] += inc;
-                        polymat[c][1][idx] += inc;
-                        powHblock *= hblock;
-                      }
-                      powVblock *= vblock;
+                      double inc = powVblock * powHblock * blockwt[vblock * horiz_tiles + hblock];
+                      size_t idx = numpar * (polyord * i + j) + (polyord * m + n);
+                      polymatthr[c][0][idx] += inc;
+                      polymatthr[c][1][idx] += inc;
+                      powHblock *= hblock;
                     }
-                    double blkinc = powVblockInit * powHblockInit * blockwt[vblock * horiz_tiles + hblock];
-                    shiftmat[c][0][(polyord * i + j)] += blkinc * bstemp[0];
-                    shiftmat[c][1][(polyord * i + j)] += blkinc * bstemp[1];
-                    powHblockInit *= hblock;
+                    powVblock *= vblock;
                   }
-                  powVblockInit *= vblock;
-                }   // monomials
-              }     // c
-            }       // blocks
+                  double blkinc = powVblockInit * powHblockInit * blockwt[vblock * horiz_tiles + hblock];
+                  shiftmatthr[c][0][(polyord * i + j)] += blkinc * bstemp[0];
+                  shiftmatthr[c][1][(polyord * i + j)] += blkinc * bstemp[1];
+                  powHblockInit *= hblock;
+                }
+                powVblockInit *= vblock;
+              }   // monomials
+            }     // c
+          }       // blocks
+        }
+
+        DT_OMP_PRAGMA(critical(cafitpass))
+        {
+          for(int c = 0; c < 2; c++)
+          {
+            numblox[c] += numbloxthr[c];
+            for(int dir = 0; dir < 2; dir++)
+            {
+              for(int i = 0; i < 256; i++)
+                polymat[c][dir][i] += polymatthr[c][dir][i];
+              for(int i = 0; i < 16; i++)
+                shiftmat[c][dir][i] += shiftmatthr[c][dir][i];
+            }
           }
+        }
+      }
+
+      DT_OMP_PRAGMA(barrier)
 
+      DT_OMP_PRAGMA(single)
+      {
+        if(processpasstwo)
+        {
           numblox[1] = MIN(numblox[0], numblox[1]);
           // if too few data points, restrict the order of the fit to linear
           if(numblox[1] < 32)
@@ -1440,7 +1440,9 @@ static const extraction_result_t _extract_patches(const float *const restrict in
   if(g->delta_E_in == NULL)
     g->delta_E_in = dt_alloc_align_float(g->checker->patches);
 
-  /* Get the average color over each patch */
+  /* Get the average color over each patch - patches don't overlap so they
+     can be sampled in parallel */
+  DT_OMP_FOR()
   for(size_t k = 0; k < g->checker->patches; k++)
   {
     // center of the patch in the ideal reference
@@ -1473,8 +1475,9 @@ static const extraction_result_t _extract_patches(const float *const restrict in
     y_min = CLAMP((size_t)floorf(y_min), 0, height - 1);
     y_max = CLAMP((size_t)ceilf(y_max), 0, height - 1);
 
-    // Get the average color on the patch
-    patches[k * 4] = patches[k * 4 + 1] = patches[k * 4 + 2] = patches[k * 4 + 3] = 0.f;
+    // Get the average color on the patch, accumulating in a local
+    // aligned pixel so the sum vectorizes and patches don't false-share
+    dt_aligned_pixel_t mean = { 0.f, 0.f, 0.f, 0.f };
     size_t num_elem = 0;
 
     // Loop through the rectangular bounding box
@@ -1490,9 +1493,9 @@ static const extraction_result_t _extract_patches(const float *const restrict in
         if(current_point.x < radius_x && current_point.x > -radius_x &&
            current_point.y < radius_y && current_point.y > -radius_y)
         {
-          for_three_channels(c)
+          for_each_channel(c)
           {
-            patches[k * 4 + c] += in[(j * width + i) * 4 + c];
+            mean[c] += in[(j * width + i) * 4 + c];
 
             // Debug : inpaint a black square in the preview to ensure the coordanites of
             // overlay drawings and actual pixel processing match
@@ -1502,13 +1505,14 @@ static const extraction_result_t _extract_patches(const float *const restrict in
         }
       }
 
-    for_three_channels(c)
-      patches[k * 4 + c] /= (float)num_elem;
+    for_each_channel(c)
+      mean[c] /= (float)num_elem;
 
     // Convert to XYZ
     dt_aligned_pixel_t XYZ = { 0 };
-    dot_product(patches + k * 4, RGB_to_XYZ, XYZ);
-    for(size_t c = 0; c < 3; c++) patches[k * 4 + c] = XYZ[c];
+    dot_product(mean, RGB_to_XYZ, XYZ);
+    for_three_channels(c) patches[k * 4 + c] = XYZ[c];
+    patches[k * 4 + 3] = 0.f;
   }
 
   // find reference white patch
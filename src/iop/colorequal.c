@@ -193,6 +193,9 @@ typedef struct dt_iop_colorequal_global_data_t
   int ce_bilinear1;
   int ce_bilinear2;
   int ce_bilinear4;
+
+  // tables for the UCS power curves used by the CPU path
+  dt_UCS_22_pow_luts_t *pow_luts;
 } dt_iop_colorequal_global_data_t;
 
 
@@ -306,6 +309,9 @@ void init_global(dt_iop_module_so_t *self)
   gd->ce_bilinear1 = dt_opencl_create_kernel(program, "bilinear1");
   gd->ce_bilinear2 = dt_opencl_create_kernel(program, "bilinear2");
   gd->ce_bilinear4 = dt_opencl_create_kernel(program, "bilinear4");
+
+  gd->pow_luts = dt_alloc_aligned(sizeof(dt_UCS_22_pow_luts_t));
+  dt_UCS_22_build_pow_luts(gd->pow_luts);
 }
 
 void cleanup_global(dt_iop_module_so_t *self)
@@ -328,6 +334,7 @@ void cleanup_global(dt_iop_module_so_t *self)
   dt_opencl_free_kernel(gd->ce_bilinear2);
   dt_opencl_free_kernel(gd->ce_bilinear4);
 
+  dt_free_align(gd->pow_luts);
   free(self->data);
   self->data = NULL;
 }
@@ -1004,6 +1011,8 @@ void process(dt_iop_module_t *self,
   }
   const dt_iop_colorequal_data_t *d = piece->data;
   const dt_iop_colorequal_gui_data_t *g = self->gui_data;
+  const dt_iop_colorequal_global_data_t *const gd = self->global_data;
+  const dt_UCS_22_pow_luts_t *const pow_luts = gd->pow_luts;
   const gboolean fullpipe = piece->pipe->type & DT_DEV_PIXELPIPE_FULL;
   const int mask_mode = g && fullpipe ? g->mask_mode : 0;
   const gboolean run_fast = piece->pipe->type & DT_DEV_PIXELPIPE_FAST;
@@ -1047,7 +1056,7 @@ void process(dt_iop_module_t *self,
     saturation[k] = (dmax > NORM_MIN && delta > NORM_MIN) ? delta / dmax : 0.0f;
 
     xyY_to_dt_UCS_UV(xyY, uv);
-    Lscharr[k] = Y_to_dt_UCS_L_star(xyY[2]);
+    Lscharr[k] = Y_to_dt_UCS_L_star_LUT(xyY[2], pow_luts);
   }
 
   _mean_gaussian(saturation, width, height, 1, sat_sigma);
@@ -1072,8 +1081,8 @@ void process(dt_iop_module_t *self,
 
       // Finish the conversion to dt UCS JCH then HSB
       dt_aligned_pixel_t JCH = { 0.0f, 0.0f, 0.0f, 0.0f };
-      dt_UCS_LUV_to_JCH(Lscharr[k], white, uv, JCH);
-      dt_UCS_JCH_to_HSB(JCH, pix_out);
+      dt_UCS_LUV_to_JCH_LUT(Lscharr[k], white, uv, JCH, pow_luts);
+      dt_UCS_JCH_to_HSB_LUT(JCH, pix_out, pow_luts);
 
       // As tmp[k] is not used any longer as L(uminance) we re-use it for the saturation gradient
       if(d->use_filter)
@@ -1131,11 +1140,11 @@ void process(dt_iop_module_t *self,
       pix_out[2] = MAX(0.0f, pix_out[2] * (1.0f + BRIGHT_EFFECT * b_corrections[k]));
 
       // Sanitize gamut
-      gamut_map_HSB(pix_out, d->gamut_LUT, white);
+      gamut_map_HSB_LUT(pix_out, d->gamut_LUT, white, pow_luts);
 
       // Convert back to XYZ D65
       dt_aligned_pixel_t XYZ_D65 = { 0.f };
-      dt_UCS_HSB_to_XYZ(pix_out, white, XYZ_D65);
+      dt_UCS_HSB_to_XYZ_LUT(pix_out, white, XYZ_D65, pow_luts);
 
       // And back to pipe RGB through XYZ D50
       dot_product(XYZ_D65, output_matrix, pix_out);
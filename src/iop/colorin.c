@@ -96,11 +96,13 @@ typedef struct dt_iop_colorin_global_data_t
 typedef struct dt_iop_colorin_data_t
 {
   gboolean clear_input;
+  gboolean input_cached; // input came from the shared parsed-profile cache
   cmsHPROFILE input;
   cmsHPROFILE nrgb;
   cmsHTRANSFORM *xform_cam_Lab;
   cmsHTRANSFORM *xform_cam_nrgb;
   cmsHTRANSFORM *xform_nrgb_Lab;
+  gboolean xform_cached; // transforms come from the shared transform cache
   float lut[3][LUT_SAMPLES];
   dt_colormatrix_t cmatrix;
   dt_colormatrix_t nmatrix;
@@ -1262,11 +1264,14 @@ void commit_params(dt_iop_module_t *self,
     dt_colorspaces_get_profile(DT_COLORSPACE_LAB, "", DT_PROFILE_DIRECTION_ANY)->profile;
 
   // only clean up when it's a type that we created here
-  if(d->input && d->clear_input)
+  if(d->input && d->input_cached)
+    dt_colorspaces_release_cached_rgb_profile(d->input);
+  else if(d->input && d->clear_input)
     dt_colorspaces_cleanup_profile(d->input);
 
   d->input = NULL;
   d->clear_input = FALSE;
+  d->input_cached = FALSE;
   d->nrgb = NULL;
 
   d->blue_mapping = p->blue_mapping;
@@ -1296,17 +1301,20 @@ void commit_params(dt_iop_module_t *self,
 
   if(d->xform_cam_Lab)
   {
-    cmsDeleteTransform(d->xform_cam_Lab);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform_cam_Lab);
+    else cmsDeleteTransform(d->xform_cam_Lab);
     d->xform_cam_Lab = NULL;
   }
   if(d->xform_cam_nrgb)
   {
-    cmsDeleteTransform(d->xform_cam_nrgb);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform_cam_nrgb);
+    else cmsDeleteTransform(d->xform_cam_nrgb);
     d->xform_cam_nrgb = NULL;
   }
   if(d->xform_nrgb_Lab)
   {
-    cmsDeleteTransform(d->xform_nrgb_Lab);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform_nrgb_Lab);
+    else cmsDeleteTransform(d->xform_nrgb_Lab);
     d->xform_nrgb_Lab = NULL;
   }
 
@@ -1354,8 +1362,12 @@ void commit_params(dt_iop_module_t *self,
       type = DT_COLORSPACE_EMBEDDED_MATRIX;
     else
     {
-      d->input = dt_colorspaces_get_rgb_profile_from_mem(cimg->profile, cimg->profile_size);
+      // the parsed profile is shared across the pipes of this image
+      // (and any other image shipping the same blob)
+      d->input = dt_colorspaces_get_cached_rgb_profile_from_mem(cimg->profile,
+                                                                cimg->profile_size);
       d->clear_input = TRUE;
+      d->input_cached = TRUE;
     }
     dt_image_cache_read_release(cimg);
   }
@@ -1425,6 +1437,11 @@ void commit_params(dt_iop_module_t *self,
     return;
   }
 
+  // transforms between library profiles are shared across pipes via the
+  // transform cache; profiles created per image (embedded ICC, camera
+  // matrices) have unstable handles and get private transforms
+  d->xform_cached = !d->clear_input;
+
   cmsColorSpaceSignature input_color_space = cmsGetColorSpace(d->input);
   cmsUInt32Number input_format;
   switch(input_color_space)
@@ -1460,12 +1477,24 @@ void commit_params(dt_iop_module_t *self,
     {
       piece->process_cl_ready = FALSE;
       dt_mark_colormatrix_invalid(&d->cmatrix[0][0]);
-      d->xform_cam_Lab = cmsCreateTransform(d->input, input_format, Lab,
-                                            TYPE_LabA_FLT, p->intent, 0);
-      d->xform_cam_nrgb = cmsCreateTransform(d->input, input_format, d->nrgb,
-                                             TYPE_RGBA_FLT, p->intent, 0);
-      d->xform_nrgb_Lab = cmsCreateTransform(d->nrgb, TYPE_RGBA_FLT, Lab,
-                                             TYPE_LabA_FLT, p->intent, 0);
+      if(d->xform_cached)
+      {
+        d->xform_cam_Lab = dt_colorspaces_get_transform(d->input, input_format, Lab,
+                                                        TYPE_LabA_FLT, p->intent);
+        d->xform_cam_nrgb = dt_colorspaces_get_transform(d->input, input_format, d->nrgb,
+                                                         TYPE_RGBA_FLT, p->intent);
+        d->xform_nrgb_Lab = dt_colorspaces_get_transform(d->nrgb, TYPE_RGBA_FLT, Lab,
+                                                         TYPE_LabA_FLT, p->intent);
+      }
+      else
+      {
+        d->xform_cam_Lab = cmsCreateTransform(d->input, input_format, Lab,
+                                              TYPE_LabA_FLT, p->intent, 0);
+        d->xform_cam_nrgb = cmsCreateTransform(d->input, input_format, d->nrgb,
+                                               TYPE_RGBA_FLT, p->intent, 0);
+        d->xform_nrgb_Lab = cmsCreateTransform(d->nrgb, TYPE_RGBA_FLT, Lab,
+                                               TYPE_LabA_FLT, p->intent, 0);
+      }
     }
     else
     {
@@ -1486,8 +1515,12 @@ void commit_params(dt_iop_module_t *self,
     {
       piece->process_cl_ready = FALSE;
       dt_mark_colormatrix_invalid(&d->cmatrix[0][0]);
-      d->xform_cam_Lab = cmsCreateTransform(d->input, input_format, Lab,
-                                            TYPE_LabA_FLT, p->intent, 0);
+      if(d->xform_cached)
+        d->xform_cam_Lab = dt_colorspaces_get_transform(d->input, input_format, Lab,
+                                                        TYPE_LabA_FLT, p->intent);
+      else
+        d->xform_cam_Lab = cmsCreateTransform(d->input, input_format, Lab,
+                                              TYPE_LabA_FLT, p->intent, 0);
     }
   }
 
@@ -1497,12 +1530,14 @@ void commit_params(dt_iop_module_t *self,
   {
     if(d->xform_cam_nrgb)
     {
-      cmsDeleteTransform(d->xform_cam_nrgb);
+      if(d->xform_cached) dt_colorspaces_release_transform(d->xform_cam_nrgb);
+      else cmsDeleteTransform(d->xform_cam_nrgb);
       d->xform_cam_nrgb = NULL;
     }
     if(d->xform_nrgb_Lab)
     {
-      cmsDeleteTransform(d->xform_nrgb_Lab);
+      if(d->xform_cached) dt_colorspaces_release_transform(d->xform_nrgb_Lab);
+      else cmsDeleteTransform(d->xform_nrgb_Lab);
       d->xform_nrgb_Lab = NULL;
     }
     d->nrgb = NULL;
@@ -1518,19 +1553,24 @@ void commit_params(dt_iop_module_t *self,
       dt_print(DT_DEBUG_ALWAYS, "[colorin] unsupported input profile has been"
                " replaced by linear Rec709 RGB!\n");
     dt_control_log(_("unsupported input profile has been replaced by linear Rec709 RGB!"));
-    if(d->input && d->clear_input) dt_colorspaces_cleanup_profile(d->input);
+    if(d->input && d->input_cached)
+      dt_colorspaces_release_cached_rgb_profile(d->input);
+    else if(d->input && d->clear_input)
+      dt_colorspaces_cleanup_profile(d->input);
     d->nrgb = NULL;
     d->input = dt_colorspaces_get_profile(DT_COLORSPACE_LIN_REC709, "",
                                           DT_PROFILE_DIRECTION_IN)->profile;
     d->clear_input = FALSE;
+    d->input_cached = FALSE;
+    d->xform_cached = TRUE;
     if(dt_colorspaces_get_matrix_from_input_profile(d->input, d->cmatrix,
                                                     d->lut[0], d->lut[1], d->lut[2],
                                                     LUT_SAMPLES))
     {
       piece->process_cl_ready = FALSE;
       dt_mark_colormatrix_invalid(&d->cmatrix[0][0]);
-      d->xform_cam_Lab = cmsCreateTransform(d->input, TYPE_RGBA_FLT, Lab,
-                                            TYPE_LabA_FLT, p->intent, 0);
+      d->xform_cam_Lab = dt_colorspaces_get_transform(d->input, TYPE_RGBA_FLT, Lab,
+                                                      TYPE_LabA_FLT, p->intent);
     }
   }
 
@@ -1576,6 +1616,7 @@ void init_pipe(dt_iop_module_t *self,
   d->xform_cam_Lab = NULL;
   d->xform_cam_nrgb = NULL;
   d->xform_nrgb_Lab = NULL;
+  d->xform_cached = FALSE;
 }
 
 void cleanup_pipe(dt_iop_module_t *self,
@@ -1583,20 +1624,26 @@ void cleanup_pipe(dt_iop_module_t *self,
                   dt_dev_pixelpipe_iop_t *piece)
 {
   dt_iop_colorin_data_t *d = piece->data;
-  if(d->input && d->clear_input) dt_colorspaces_cleanup_profile(d->input);
+  if(d->input && d->input_cached)
+    dt_colorspaces_release_cached_rgb_profile(d->input);
+  else if(d->input && d->clear_input)
+    dt_colorspaces_cleanup_profile(d->input);
   if(d->xform_cam_Lab)
   {
-    cmsDeleteTransform(d->xform_cam_Lab);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform_cam_Lab);
+    else cmsDeleteTransform(d->xform_cam_Lab);
     d->xform_cam_Lab = NULL;
   }
   if(d->xform_cam_nrgb)
   {
-    cmsDeleteTransform(d->xform_cam_nrgb);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform_cam_nrgb);
+    else cmsDeleteTransform(d->xform_cam_nrgb);
     d->xform_cam_nrgb = NULL;
   }
   if(d->xform_nrgb_Lab)
   {
-    cmsDeleteTransform(d->xform_nrgb_Lab);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform_nrgb_Lab);
+    else cmsDeleteTransform(d->xform_nrgb_Lab);
     d->xform_nrgb_Lab = NULL;
   }
 
@@ -52,6 +52,7 @@ typedef struct dt_iop_colorout_data_t
   float lut[3][LUT_SAMPLES];
   dt_colormatrix_t cmatrix;
   cmsHTRANSFORM *xform;
+  gboolean xform_cached; // xform comes from the shared transform cache
   float unbounded_coeffs[3][3]; // for extrapolation of shaper curves
 } dt_iop_colorout_data_t;
 
@@ -571,7 +572,8 @@ void commit_params(dt_iop_module_t *self, dt_iop_params_t *p1, dt_dev_pixelpipe_
 
   if(d->xform)
   {
-    cmsDeleteTransform(d->xform);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform);
+    else cmsDeleteTransform(d->xform);
     d->xform = NULL;
   }
   dt_mark_colormatrix_invalid(&d->cmatrix[0][0]);
@@ -705,8 +707,16 @@ void commit_params(dt_iop_module_t *self, dt_iop_params_t *p1, dt_dev_pixelpipe_
   {
     dt_mark_colormatrix_invalid(&d->cmatrix[0][0]);
     piece->process_cl_ready = FALSE;
-    d->xform = cmsCreateProofingTransform(Lab, TYPE_LabA_FLT, output, output_format, softproof,
-                                          out_intent, INTENT_RELATIVE_COLORIMETRIC, transformFlags);
+    // without softproofing the transform only involves profiles owned by
+    // darktable.color_profiles, so it can be shared across pipes; the
+    // softproof profile is a throwaway copy and needs a private transform
+    d->xform_cached = (softproof == NULL);
+    if(d->xform_cached)
+      d->xform = dt_colorspaces_get_transform(Lab, TYPE_LabA_FLT,
+                                              output, output_format, out_intent);
+    else
+      d->xform = cmsCreateProofingTransform(Lab, TYPE_LabA_FLT, output, output_format, softproof,
+                                            out_intent, INTENT_RELATIVE_COLORIMETRIC, transformFlags);
   }
 
   // user selected a non-supported output profile, check that:
@@ -725,8 +735,13 @@ void commit_params(dt_iop_module_t *self, dt_iop_params_t *p1, dt_dev_pixelpipe_
       dt_mark_colormatrix_invalid(&d->cmatrix[0][0]);
       piece->process_cl_ready = FALSE;
 
-      d->xform = cmsCreateProofingTransform(Lab, TYPE_LabA_FLT, output, output_format, softproof,
-                                            out_intent, INTENT_RELATIVE_COLORIMETRIC, transformFlags);
+      d->xform_cached = (softproof == NULL);
+      if(d->xform_cached)
+        d->xform = dt_colorspaces_get_transform(Lab, TYPE_LabA_FLT,
+                                                output, output_format, out_intent);
+      else
+        d->xform = cmsCreateProofingTransform(Lab, TYPE_LabA_FLT, output, output_format, softproof,
+                                              out_intent, INTENT_RELATIVE_COLORIMETRIC, transformFlags);
     }
   }
 
@@ -771,7 +786,8 @@ void cleanup_pipe(dt_iop_module_t *self, dt_dev_pixelpipe_t *pipe, dt_dev_pixelp
   dt_iop_colorout_data_t *d = piece->data;
   if(d->xform)
   {
-    cmsDeleteTransform(d->xform);
+    if(d->xform_cached) dt_colorspaces_release_transform(d->xform);
+    else cmsDeleteTransform(d->xform);
     d->xform = NULL;
   }
 
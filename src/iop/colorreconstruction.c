@@ -382,60 +382,130 @@ static void dt_iop_colorreconstruct_bilateral_splat(
 {
   if(!b) return;
 
+  /* every thread splats its horizontal slice of the image into a
+     private compact sub-grid which gets merged below, the same scheme
+     common/bilateral.c uses - four atomic adds per pixel serialize
+     badly once several cores hit the same grid cells. when the
+     per-thread buffers can't be allocated we fall back to atomics. */
+  const int nthreads = MIN(dt_get_num_threads(), b->height);
+  const int sliceheight = (b->height + nthreads - 1) / nthreads;
+  // grid rows one slice can splat to; the +2 covers the rounding at
+  // both ends of the slice
+  const int slicerows = (int)ceilf(sliceheight / b->sigma_s) + 2;
+  size_t slicesize;
+  dt_iop_colorreconstruct_Lab_t *slices =
+    dt_alloc_perthread(b->size_x * b->size_z * slicerows,
+                       sizeof(dt_iop_colorreconstruct_Lab_t), &slicesize);
+  if(slices)
+    memset(slices, 0, slicesize * nthreads * sizeof(dt_iop_colorreconstruct_Lab_t));
+
   // splat into downsampled grid
   DT_OMP_FOR()
-  for(int j = 0; j < b->height; j++)
+  for(int slice = 0; slice < nthreads; slice++)
   {
-    size_t index = (size_t)4 * j * b->width;
-    for(int i = 0; i < b->width; i++, index += 4)
+    const int firstrow = slice * sliceheight;
+    const int lastrow = MIN(firstrow + sliceheight, b->height);
+    // first grid row this slice can splat to
+    const int rowoffset = (int)roundf(firstrow / b->sigma_s);
+    dt_iop_colorreconstruct_Lab_t *const sbuf =
+      slices ? dt_get_bythread(slices, slicesize, slice) : NULL;
+
+    for(int j = firstrow; j < lastrow; j++)
     {
-      float x, y, z, weight, m;
-      const float Lin = in[index];
-      const float ain = in[index + 1];
-      const float bin = in[index + 2];
-      // we deliberately ignore pixels above threshold
-      if(Lin > threshold) continue;
-
-      switch(precedence)
+      size_t index = (size_t)4 * j * b->width;
+      for(int i = 0; i < b->width; i++, index += 4)
       {
-        case COLORRECONSTRUCT_PRECEDENCE_CHROMA:
-          weight = sqrtf(ain * ain + bin * bin);
-          break;
-
-        case COLORRECONSTRUCT_PRECEDENCE_HUE:
-          m = atan2f(bin, ain) - params[0];
-          // readjust m into [-pi, +pi] interval
-          m = m > M_PI ? m - 2*M_PI : (m < -M_PI ? m + 2*M_PI : m);
-          weight = expf(-m*m/params[1]);
-          break;
-
-        case COLORRECONSTRUCT_PRECEDENCE_NONE:
-        default:
-          weight = 1.0f;
-          break;
+        float x, y, z, weight, m;
+        const float Lin = in[index];
+        const float ain = in[index + 1];
+        const float bin = in[index + 2];
+        // we deliberately ignore pixels above threshold
+        if(Lin > threshold) continue;
+
+        switch(precedence)
+        {
+          case COLORRECONSTRUCT_PRECEDENCE_CHROMA:
+            weight = sqrtf(ain * ain + bin * bin);
+            break;
+
+          case COLORRECONSTRUCT_PRECEDENCE_HUE:
+            m = atan2f(bin, ain) - params[0];
+            // readjust m into [-pi, +pi] interval
+            m = m > M_PI ? m - 2*M_PI : (m < -M_PI ? m + 2*M_PI : m);
+            weight = expf(-m*m/params[1]);
+            break;
+
+          case COLORRECONSTRUCT_PRECEDENCE_NONE:
+          default:
+            weight = 1.0f;
+            break;
+        }
+
+        image_to_grid(b, i, j, Lin, &x, &y, &z);
+
+        // closest integer splatting:
+        const int xi = CLAMPS((int)round(x), 0, b->size_x - 1);
+        const int yi = CLAMPS((int)round(y), 0, b->size_y - 1);
+        const int zi = CLAMPS((int)round(z), 0, b->size_z - 1);
+
+        if(sbuf)
+        {
+          const size_t slice_index = xi + b->size_x * ((size_t)(yi - rowoffset) + (size_t)slicerows * zi);
+          sbuf[slice_index].L += Lin * weight;
+          sbuf[slice_index].a += ain * weight;
+          sbuf[slice_index].b += bin * weight;
+          sbuf[slice_index].weight += weight;
+        }
+        else
+        {
+          const size_t grid_index = xi + b->size_x * (yi + b->size_y * zi);
+
+          DT_OMP_PRAGMA(atomic)
+          b->buf[grid_index].L += Lin * weight;
+
+          DT_OMP_PRAGMA(atomic)
+          b->buf[grid_index].a += ain * weight;
+
+          DT_OMP_PRAGMA(atomic)
+          b->buf[grid_index].b += bin * weight;
+
+          DT_OMP_PRAGMA(atomic)
+          b->buf[grid_index].weight += weight;
+        }
       }
+    }
+  }
 
-      image_to_grid(b, i, j, Lin, &x, &y, &z);
-
-      // closest integer splatting:
-      const int xi = CLAMPS((int)round(x), 0, b->size_x - 1);
-      const int yi = CLAMPS((int)round(y), 0, b->size_y - 1);
-      const int zi = CLAMPS((int)round(z), 0, b->size_z - 1);
-      const size_t grid_index = xi + b->size_x * (yi + b->size_y * zi);
-
-      DT_OMP_PRAGMA(atomic)
-      b->buf[grid_index].L += Lin * weight;
-
-      DT_OMP_PRAGMA(atomic)
-      b->buf[grid_index].a += ain * weight;
+  if(!slices) return;
 
-      DT_OMP_PRAGMA(atomic)
-      b->buf[grid_index].b += bin * weight;
+  // merge the per-thread sub-grids into the final grid
+  for(int slice = 0; slice < nthreads; slice++)
+  {
+    const int rowoffset = (int)roundf((float)(slice * sliceheight) / b->sigma_s);
+    const dt_iop_colorreconstruct_Lab_t *const sbuf =
+      dt_get_bythread(slices, slicesize, slice);
 
-      DT_OMP_PRAGMA(atomic)
-      b->buf[grid_index].weight += weight;
+    DT_OMP_FOR()
+    for(int zi = 0; zi < b->size_z; zi++)
+    {
+      for(int r = 0; r < slicerows; r++)
+      {
+        const int yi = rowoffset + r;
+        if(yi >= b->size_y) break;
+        const dt_iop_colorreconstruct_Lab_t *const src = sbuf + b->size_x * ((size_t)r + (size_t)slicerows * zi);
+        dt_iop_colorreconstruct_Lab_t *const dest = b->buf + b->size_x * ((size_t)yi + b->size_y * (size_t)zi);
+        for(int xi = 0; xi < b->size_x; xi++)
+        {
+          dest[xi].L += src[xi].L;
+          dest[xi].a += src[xi].a;
+          dest[xi].b += src[xi].b;
+          dest[xi].weight += src[xi].weight;
+        }
+      }
     }
   }
+
+  dt_free_align(slices);
 }
 
 
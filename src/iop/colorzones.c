@@ -120,6 +120,9 @@ typedef struct dt_iop_colorzones_data_t
   int curve_type[DT_IOP_COLORZONES_MAX_CHANNELS];  // curve style (e.g. CUBIC_SPLINE)
   dt_iop_colorzones_channel_t channel;
   float lut[3][DT_IOP_COLORZONES_LUT_RES];
+  // the three tables interleaved, so the pixel loops fetch all curves
+  // with a single lookup
+  float lut4[DT_IOP_COLORZONES_LUT_RES][4];
   int mode;
 } dt_iop_colorzones_data_t;
 
@@ -417,6 +420,19 @@ static float lookup(const float *lut, const float i)
   return lut[bin1] * f + lut[bin0] * (1.f - f);
 }
 
+// as lookup(), but reading all three curves at once from the
+// interleaved table
+static inline void lookup4(const float (*const lut)[4],
+                           const float i,
+                           dt_aligned_pixel_t res)
+{
+  const int bin0 = MIN(0xffff, MAX(0, (int)(DT_IOP_COLORZONES_LUT_RES * i)));
+  const int bin1 = MIN(0xffff, MAX(0, (int)(DT_IOP_COLORZONES_LUT_RES * i) + 1));
+  const float f = DT_IOP_COLORZONES_LUT_RES * i - bin0;
+  for_each_channel(c)
+    res[c] = lut[bin1][c] * f + lut[bin0][c] * (1.f - f);
+}
+
 static inline float strength(const float value,
                              const float strength)
 {
@@ -512,9 +528,12 @@ void process_v1(dt_iop_module_t *self,
     }
     select = CLAMP(select, 0.f, 1.f);
 
-    LCh[0] *= powf(2.0f, 4.0f * (lookup(d->lut[0], select) - .5f));
-    LCh[1] *= 2.f * lookup(d->lut[1], select);
-    LCh[2] += lookup(d->lut[2], select) - .5f;
+    dt_aligned_pixel_t curves;
+    lookup4(d->lut4, select, curves);
+
+    LCh[0] *= powf(2.0f, 4.0f * (curves[0] - .5f));
+    LCh[1] *= 2.f * curves[1];
+    LCh[2] += curves[2] - .5f;
 
     dt_LCH_2_Lab(LCh, out);
 
@@ -555,11 +574,14 @@ void process_v3(dt_iop_module_t *self,
         blend = powf(1.0f - C / 128.0f, 2.0f);
         break;
     }
-    const float Lm = (blend * .5f + (1.0f - blend) * lookup(d->lut[0], select)) - .5f;
-    const float hm = (blend * .5f + (1.0f - blend) * lookup(d->lut[2], select)) - .5f;
+    dt_aligned_pixel_t curves;
+    lookup4(d->lut4, select, curves);
+
+    const float Lm = (blend * .5f + (1.0f - blend) * curves[0]) - .5f;
+    const float hm = (blend * .5f + (1.0f - blend) * curves[2]) - .5f;
     blend *= blend; // saturation isn't as prone to artifacts:
-    // const float Cm = 2.0 * (blend*.5f + (1.0f-blend)*lookup(d->lut[1], select));
-    const float Cm = 2.0f * lookup(d->lut[1], select);
+    // const float Cm = 2.0 * (blend*.5f + (1.0f-blend)*curves[1]);
+    const float Cm = 2.0f * curves[1];
     const float L = in[0] * powf(2.0f, 4.0f * Lm);
     out[0] = L;
     out[1] = cosf(2.0f * M_PI_F * (h + hm)) * Cm * C;
@@ -2898,6 +2920,18 @@ void commit_params(dt_iop_module_t *self,
                                    p->channel == DT_IOP_COLORZONES_h);
     }
   }
+
+  // interleave the three tables so a pixel's lookups land in one cache
+  // line instead of gathering from three separate 256KiB tables. the
+  // planar tables are kept as they are what the OpenCL kernel and the
+  // display mask path consume.
+  for(int k = 0; k < DT_IOP_COLORZONES_LUT_RES; k++)
+  {
+    d->lut4[k][0] = d->lut[0][k];
+    d->lut4[k][1] = d->lut[1][k];
+    d->lut4[k][2] = d->lut[2][k];
+    d->lut4[k][3] = 0.f;
+  }
 }
 
 void init_pipe(dt_iop_module_t *self,
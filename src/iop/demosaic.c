@@ -903,6 +903,13 @@ void process(dt_iop_module_t *self,
     dt_iop_clip_and_zoom_roi((float *)o, out, roi_out, roi_in);
     dt_free_align(out);
   }
+
+  // dual demosaic is the most expensive head of the pixelpipe: two full
+  // demosaics plus the scharr blend mask. pin its output in the pipe
+  // cache so editing late-stack modules never re-pays that work.
+  if(dual && no_masking && (pipe->type & DT_DEV_PIXELPIPE_BASIC))
+    dt_dev_pixelpipe_important_cacheline(pipe, o,
+        sizeof(float) * 4 * roi_out->width * roi_out->height);
 }
 
 #ifdef HAVE_OPENCL
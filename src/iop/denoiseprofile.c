@@ -936,7 +936,11 @@ static inline void precondition(const float *const in,
   }
 }
 
+// residue may be NULL; if given, it is the coarsest wavelet scale and
+// gets added back here, fused into the inverse transform to save a full
+// sweep over the buffer
 static inline void backtransform(float *const buf,
+                                 const float *const restrict residue,
                                  const int wd,
                                  const int ht,
                                  const dt_aligned_pixel_t a,
@@ -955,7 +959,7 @@ static inline void backtransform(float *const buf,
   {
     for_each_channel(c,aligned(buf,sigma2_plus_1_8))
     {
-      const float x = buf[j+c], x2 = x * x;
+      const float x = residue ? buf[j+c] + residue[j+c] : buf[j+c], x2 = x * x;
       // closed form approximation to unbiased inverse (input range
       // was 0..200 for fit, not 0..1)
       buf[j+c] = (x < 0.5f)
@@ -1085,7 +1089,9 @@ static inline void precondition_v2(const float *const in,
 // control the bias:
 // we replace the 2 * p * constant / (2 - p) part of delta by user
 // defined bias controller.
+// residue as in backtransform() above
 static inline void backtransform_v2(float *const buf,
+                                    const float *const restrict residue,
                                     const int wd,
                                     const int ht,
                                     const float a,
@@ -1110,7 +1116,7 @@ static inline void backtransform_v2(float *const buf,
     dt_aligned_pixel_t z1;
     for_each_channel(c,aligned(buf,wb))
     {
-      const float x = MAX(buf[j+c], 0.0f);
+      const float x = MAX(residue ? buf[j+c] + residue[j+c] : buf[j+c], 0.0f);
       const float delta = x * x + bias;
       z1[c] = (x + sqrtf(MAX(delta, 0.0f))) / denom[c];
     }
@@ -1162,7 +1168,9 @@ static inline void precondition_Y0U0V0(const float *const in,
   dt_omploop_sfence(); // ensure that nontemporal writes complete before we read the output
 }
 
+// residue as in backtransform() above
 static inline void backtransform_Y0U0V0(float *const buf,
+                                        const float *const restrict residue,
                                         const int wd,
                                         const int ht,
                                         const float a,
@@ -1187,7 +1195,10 @@ static inline void backtransform_Y0U0V0(float *const buf,
   for(size_t j = 0; j < (size_t)4 * ht * wd; j += 4)
   {
     dt_aligned_pixel_t rgb = { 0.0f }; // "unused" fourth element enables vectorization
-    dt_apply_transposed_color_matrix(buf + j, toRGB_trans, rgb);
+    dt_aligned_pixel_t yuv;
+    for_each_channel(c,aligned(buf))
+      yuv[c] = residue ? buf[j+c] + residue[j+c] : buf[j+c];
+    dt_apply_transposed_color_matrix(yuv, toRGB_trans, rgb);
     dt_aligned_pixel_t z1;
     for_each_channel(c,aligned(buf))
     {
@@ -1580,23 +1591,20 @@ static void process_wavelets(dt_iop_module_t *self,
     buf1 = buf3;
   }
 
-  // add in the final residue
-  DT_OMP_SIMD(aligned(buf1, out : 64))
-  for(size_t k = 0; k < 4U * npixels; k++)
-    out[k] += buf1[k];
-
+  // the final residue in buf1 is added back inside the backtransform,
+  // saving a separate read-modify-write sweep over the output
   if(!d->use_new_vst)
   {
-    backtransform(out, width, height, aa, bb);
+    backtransform(out, buf1, width, height, aa, bb);
   }
   else if(d->wavelet_color_mode == MODE_RGB)
   {
-    backtransform_v2(out, width, height, d->a[1] * compensate_p,
+    backtransform_v2(out, buf1, width, height, d->a[1] * compensate_p,
                      p, d->b[1], d->bias - 0.5 * logf(in_scale), wb);
   }
   else
   {
-    backtransform_Y0U0V0(out, width, height, d->a[1] * compensate_p,
+    backtransform_Y0U0V0(out, buf1, width, height, d->a[1] * compensate_p,
                          p, d->b[1], d->bias - 0.5 * logf(in_scale), wb, toRGB_trans);
   }
 
@@ -1764,11 +1772,11 @@ static void nlmeans_backtransform(const dt_iop_denoiseprofile_data_t *const d,
 {
   if(!d->use_new_vst)
   {
-    backtransform((float *)ovoid, roi_in->width, roi_in->height, aa, bb);
+    backtransform((float *)ovoid, NULL, roi_in->width, roi_in->height, aa, bb);
   }
   else
   {
-    backtransform_v2((float *)ovoid, roi_in->width, roi_in->height,
+    backtransform_v2((float *)ovoid, NULL, roi_in->width, roi_in->height,
                      d->a[1] * compensate_p, p, d->b[1],
                      d->bias - 0.5 * logf(scale), wb);
   }
@@ -22,6 +22,7 @@
 #include "common/bspline.h"
 #include "common/darktable.h"
 #include "common/dwt.h"
+#include "common/fast_guided_filter.h"
 #include "common/gaussian.h"
 #include "common/image.h"
 #include "common/imagebuf.h"
@@ -43,7 +44,7 @@
 #include "gui/presets.h"
 #include "iop/iop_api.h"
 
-DT_MODULE_INTROSPECTION(2, dt_iop_diffuse_params_t)
+DT_MODULE_INTROSPECTION(3, dt_iop_diffuse_params_t)
 
 #define MAX_NUM_SCALES 10
 typedef struct dt_iop_diffuse_params_t
@@ -70,6 +71,9 @@ typedef struct dt_iop_diffuse_params_t
   // v2
   int radius_center;        // $MIN: 0    $MAX: 1024 $DEFAULT: 0  $DESCRIPTION: "central radius"
 
+  // v3
+  gboolean multigrid;       // $DEFAULT: FALSE $DESCRIPTION: "coarse-to-fine solver"
+
   // new versions add params mandatorily at the end, so we can memcpy old parameters at the beginning
 
 } dt_iop_diffuse_params_t;
@@ -78,7 +82,8 @@ typedef struct dt_iop_diffuse_params_t
 typedef struct dt_iop_diffuse_gui_data_t
 {
   GtkWidget *iterations, *fourth, *third, *second, *radius, *radius_center, *sharpness, *threshold, *regularization, *first,
-      *anisotropy_first, *anisotropy_second, *anisotropy_third, *anisotropy_fourth, *regularization_first, *variance_threshold;
+      *anisotropy_first, *anisotropy_second, *anisotropy_third, *anisotropy_fourth, *regularization_first, *variance_threshold,
+      *multigrid;
 } dt_iop_diffuse_gui_data_t;
 
 typedef struct dt_iop_diffuse_global_data_t
@@ -191,6 +196,51 @@ int legacy_params(dt_iop_module_t *self,
     int radius_center;
   } dt_iop_diffuse_params_v2_t;
 
+  typedef struct dt_iop_diffuse_params_v3_t
+  {
+    // global parameters
+    int iterations;
+    float sharpness;
+    int radius;
+    float regularization;
+    float variance_threshold;
+
+    float anisotropy_first;
+    float anisotropy_second;
+    float anisotropy_third;
+    float anisotropy_fourth;
+
+    float threshold;
+
+    float first;
+    float second;
+    float third;
+    float fourth;
+
+    // v2
+    int radius_center;
+
+    // v3
+    gboolean multigrid;
+  } dt_iop_diffuse_params_v3_t;
+
+  if(old_version == 2)
+  {
+    const dt_iop_diffuse_params_v2_t *o = (dt_iop_diffuse_params_v2_t *)old_params;
+    dt_iop_diffuse_params_v3_t *n = malloc(sizeof(dt_iop_diffuse_params_v3_t));
+
+    // copy common parameters
+    memcpy(n, o, sizeof(dt_iop_diffuse_params_v2_t));
+
+    // init only new parameters
+    n->multigrid = FALSE;
+
+    *new_params = n;
+    *new_params_size = sizeof(dt_iop_diffuse_params_v3_t);
+    *new_version = 3;
+    return 0;
+  }
+
   if(old_version == 1)
   {
     typedef struct dt_iop_diffuse_params_v1_t
@@ -774,6 +824,20 @@ void init_presets(dt_iop_module_so_t *self)
                              DEVELOP_BLEND_CS_RGB_SCENE);
 }
 
+// decide whether the coarse-to-fine solver should kick in: it needs enough
+// iterations to amortize the resampling steps and a grid that still holds a
+// few wavelet scales once halved.  inpainting relies on the full-resolution
+// mask, so it always runs on the fine grid only
+static inline gboolean _use_multigrid(const dt_iop_diffuse_data_t *const data,
+                                      const int iterations,
+                                      const gboolean has_mask,
+                                      const size_t width,
+                                      const size_t height)
+{
+  return data->multigrid && !has_mask && iterations >= 4
+         && width >= 256 && height >= 256;
+}
+
 void tiling_callback(dt_iop_module_t *self,
                      dt_dev_pixelpipe_iop_t *piece,
                      const dt_iop_roi_t *roi_in,
@@ -793,12 +857,21 @@ void tiling_callback(dt_iop_module_t *self,
   tiling->factor = 6.25f + scales;
   tiling->factor_cl = 6.25f + scales;
 
+  // the coarse-to-fine solver keeps an extra quarter-size copy of the
+  // temporaries and wavelet scales around
+  if(_use_multigrid(data, MAX(data->iterations, 1), data->threshold > 0.f,
+                    roi_out->width, roi_out->height))
+    tiling->factor += 0.25f * (4.f + scales);
+
   tiling->maxbuf = 1.0f;
   tiling->maxbuf_cl = 1.0f;
   tiling->overhead = 0;
   tiling->overlap = max_filter_radius;
   tiling->xalign = 1;
   tiling->yalign = 1;
+  // all temporaries are local to one process() call and we don't touch
+  // processed_maximum, so tiles may run concurrently
+  tiling->parallel = TRUE;
   return;
 }
 
@@ -1415,7 +1488,65 @@ void process(dt_iop_module_t *self,
     in = temp1;
   }
 
-  for(int it = 0; it < iterations; it++)
+  int fine_iterations = iterations;
+  if(_use_multigrid(data, iterations, has_mask, width, height))
+  {
+    // one sweep on a half-resolution grid advances the diffusion as far as
+    // four full-resolution sweeps (diffusion time goes with the square of
+    // the grid step), so run the bulk of the requested iterations on the
+    // coarse grid and keep a few full-resolution sweeps at the end to
+    // regenerate the finest scales
+    fine_iterations = MAX(iterations / 4, 1);
+    const int coarse_iterations = MAX((iterations - fine_iterations + 3) / 4, 1);
+
+    const size_t cwidth = (width + 1) / 2;
+    const size_t cheight = (height + 1) / 2;
+    // the coarse grid sees the same physical radii with one scale less
+    const float coarse_radius = final_radius / 2.f;
+    const int coarse_scales
+        = CLAMP(num_steps_to_reach_equivalent_sigma(B_SPLINE_SIGMA, coarse_radius), 1, MAX_NUM_SCALES);
+
+    float *restrict ctemp1 = dt_alloc_align_float(cwidth * cheight * 4);
+    float *restrict ctemp2 = dt_alloc_align_float(cwidth * cheight * 4);
+    float *restrict cLF_odd = dt_alloc_align_float(cwidth * cheight * 4);
+    float *restrict cLF_even = dt_alloc_align_float(cwidth * cheight * 4);
+    float *restrict cHF[MAX_NUM_SCALES] = { NULL };
+    gboolean coarse_oom = !ctemp1 || !ctemp2 || !cLF_odd || !cLF_even;
+    for(int s = 0; s < coarse_scales; s++)
+    {
+      cHF[s] = coarse_oom ? NULL : dt_alloc_align_float(cwidth * cheight * 4);
+      if(!cHF[s]) coarse_oom = TRUE;
+    }
+
+    if(!coarse_oom)
+    {
+      interpolate_bilinear(in, width, height, ctemp1, cwidth, cheight, 4);
+
+      for(int it = 0; it < coarse_iterations; it++)
+      {
+        float *const ci = (it % 2 == 0) ? ctemp1 : ctemp2;
+        float *const co = (it % 2 == 0) ? ctemp2 : ctemp1;
+        wavelets_process(ci, co, NULL, cwidth, cheight, data, coarse_radius, 2.f * scale,
+                         coarse_scales, FALSE, cHF, cLF_odd, cLF_even);
+      }
+
+      float *const coarse_result = (coarse_iterations % 2 == 0) ? ctemp1 : ctemp2;
+      interpolate_bilinear(coarse_result, cwidth, cheight, temp1, width, height, 4);
+      in = temp1;
+    }
+    else
+      // not enough memory for the coarse grid: solve on the fine grid only
+      fine_iterations = iterations;
+
+    dt_free_align(ctemp1);
+    dt_free_align(ctemp2);
+    dt_free_align(cLF_odd);
+    dt_free_align(cLF_even);
+    for(int s = 0; s < coarse_scales; s++)
+      if(cHF[s]) dt_free_align(cHF[s]);
+  }
+
+  for(int it = 0; it < fine_iterations; it++)
   {
     if(it == 0)
     {
@@ -1433,7 +1564,7 @@ void process(dt_iop_module_t *self,
       temp_out = temp1;
     }
 
-    if(it == iterations - 1)
+    if(it == fine_iterations - 1)
       temp_out = out;
 
     wavelets_process(temp_in, temp_out, mask,
@@ -1633,18 +1764,33 @@ int process_cl(dt_iop_module_t *self,
   if(fastmode)
     return dt_opencl_enqueue_copy_image(devid, dev_in, dev_out, origin, origin, region);
 
+  // the coarse-to-fine solver is implemented on the CPU code path only for
+  // now: hand the job back to the pixelpipe so it falls back to process()
+  if(_use_multigrid(data, MAX(data->iterations, 1), data->threshold > 0.f, width, height))
+    return DT_OPENCL_PROCESS_CL;
+
   size_t sizes[] = { ROUNDUPDWD(width, devid), ROUNDUPDHT(height, devid), 1 };
 
   cl_mem in = dev_in;
   cl_mem temp_in = NULL;
   cl_mem temp_out = NULL;
 
-  cl_mem temp1 = dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
-  cl_mem temp2 = dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
+  // opt-in: on the preview pipe the scratch buffers can be stored as
+  // half floats, halving the bandwidth of the hottest buffers here.
+  // the kernels still compute in float, the sampler converts
+  const gboolean fp16 = (piece->pipe->type & DT_DEV_PIXELPIPE_PREVIEW)
+                        && dt_conf_get_bool("opencl_preview_fp16");
+
+  cl_mem temp1 = fp16 ? dt_opencl_alloc_device_half(devid, sizes[0], sizes[1], sizeof(float) * 4)
+                      : dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
+  cl_mem temp2 = fp16 ? dt_opencl_alloc_device_half(devid, sizes[0], sizes[1], sizeof(float) * 4)
+                      : dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
   cl_mem mask = dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(uint8_t));
   // temp buffer for blurs. We will need to cycle between them for memory efficiency
-  cl_mem LF_even = dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
-  cl_mem LF_odd = dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
+  cl_mem LF_even = fp16 ? dt_opencl_alloc_device_half(devid, sizes[0], sizes[1], sizeof(float) * 4)
+                        : dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
+  cl_mem LF_odd = fp16 ? dt_opencl_alloc_device_half(devid, sizes[0], sizes[1], sizeof(float) * 4)
+                       : dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
 
   const float scale = fmaxf(piece->iscale / roi_in->scale, 1.f);
   const float final_radius = (data->radius + data->radius_center) * 2.f / scale;
@@ -1657,7 +1803,8 @@ int process_cl(dt_iop_module_t *self,
   cl_mem HF[MAX_NUM_SCALES];
   for(int s = 0; s < scales; s++)
   {
-    HF[s] = dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
+    HF[s] = fp16 ? dt_opencl_alloc_device_half(devid, sizes[0], sizes[1], sizeof(float) * 4)
+                 : dt_opencl_alloc_device(devid, sizes[0], sizes[1], sizeof(float) * 4);
     if(!HF[s]) out_of_memory = TRUE;
   }
 
@@ -1777,6 +1924,15 @@ void gui_init(dt_iop_module_t *self)
        "if you plan on sharpening or inpainting, \n"
        "more iterations help reconstruction."));
 
+  g->multigrid = dt_bauhaus_toggle_from_params(self, "multigrid");
+  gtk_widget_set_tooltip_text
+    (g->multigrid,
+     _("run most iterations on a half-resolution grid where the diffusion\n"
+       "converges four times faster, then refine at full resolution.\n"
+       "this is much faster for high iteration counts at the expense of\n"
+       "a slight loss of accuracy in the finest details.\n"
+       "inpainting always runs at full resolution."));
+
   g->radius_center = dt_bauhaus_slider_from_params(self, "radius_center");
   dt_bauhaus_slider_set_soft_range(g->radius_center, 0., 512.);
   dt_bauhaus_slider_set_format(g->radius_center, _(" px"));
@@ -587,32 +587,25 @@ static void _process_random(
 
   const float dither = powf(2.0f, data->random.damping / 10.0f);
 
-  unsigned int *const tea_states = alloc_tea_states(dt_get_num_threads());
-
-  DT_OMP_PRAGMA(parallel default(firstprivate))
+  DT_OMP_FOR()
+  for(int j = 0; j < height; j++)
   {
-    // get a pointer to each thread's private buffer *outside* the for loop, to avoid a function call per iteration
-    unsigned int *const tea_state = get_tea_state(tea_states,dt_get_thread_num());
-    DT_OMP_PRAGMA(for schedule(static))
-    for(int j = 0; j < height; j++)
+    const size_t k = (size_t)4 * width * j;
+    const float *const in = (const float *)ivoid + k;
+    float *const out = (float *)ovoid + k;
+    for(int i = 0; i < width; i++)
     {
-      const size_t k = (size_t)4 * width * j;
-      const float *const in = (const float *)ivoid + k;
-      float *const out = (float *)ovoid + k;
-      tea_state[0] = j * height; /* + dt_get_thread_num() -- do not include, makes results unreproducible */
-      for(int i = 0; i < width; i++)
-      {
-        encrypt_tea(tea_state);
-        float dith = dither * tpdf(tea_state[0]);
+      // counter-based generation from the pixel number keeps the result
+      // independent of how the rows are split across threads and lets
+      // the compiler vectorize adjacent pixels
+      const float dith = dither * tpdf(encrypt_tea_ctr((unsigned int)j * width + i));
 
-        for_each_channel(c,aligned(in,out:64))
-        {
-          out[4*i+c] = CLIP(in[4*i+c] + dith);
-        }
+      for_each_channel(c,aligned(in,out:64))
+      {
+        out[4*i+c] = CLIP(in[4*i+c] + dith);
       }
     }
   }
-  free_tea_states(tea_states);
 }
 
 static void _process_posterize(
@@ -155,8 +155,10 @@ static const int permutation[]
         181, 199, 106, 157, 184, 84,  204, 176, 115, 121, 50,  45,  127, 4,   150, 254, 138, 236, 205, 93,
         222, 114, 67,  29,  24,  72,  243, 141, 128, 195, 78,  66,  215, 61,  156, 180 };
 
-static size_t perm[512];	// permutation lookup table
-static size_t perm_mod[512];	// same as above, but all values mod 12 for selection from grad3
+// narrow types keep both tables within a handful of cache lines, which
+// matters as the hashed lookups below gather from effectively random spots
+static uint8_t perm[512];	// permutation lookup table
+static uint8_t perm_mod[512];	// same as above, but all values mod 12 for selection from grad3
 
 static void _simplex_noise_init()
 {
@@ -166,6 +168,7 @@ static void _simplex_noise_init()
     perm_mod[i] = perm[i] % 12;
   }
 }
+DT_OMP_DECLARE_SIMD()
 static double dot(const double g[], const double x, const double y, const double z)
 {
   return g[0] * x + g[1] * y + g[2] * z;
@@ -173,6 +176,7 @@ static double dot(const double g[], const double x, const double y, const double
 
 #define FASTFLOOR(x) (x > 0 ? (int)(x) : (int)(x)-1)
 
+DT_OMP_DECLARE_SIMD()
 static double _simplex_noise(double xin, double yin, double zin)
 {
   double n0, n1, n2, n3; // Noise contributions from the four corners
@@ -313,6 +317,7 @@ static double _simplex_noise(double xin, double yin, double zin)
   return 32.0 * (n0 + n1 + n2 + n3);
 }
 
+DT_OMP_DECLARE_SIMD()
 static double _simplex_2d_noise(double x, double y, double z)
 {
   double total = 0;
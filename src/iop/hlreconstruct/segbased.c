@@ -660,11 +660,17 @@ static void _process_segmentation(dt_dev_pixelpipe_iop_t *piece,
       _initial_gradients(pwidth, pheight, luminance, distance, recout);
       _masks_extend_border(recout, pwidth, pheight, segall->border);
 
-      // now we check for significant all-clipped-segments and reconstruct data
+      // measuring a segment only reads the distance plane, so all
+      // segments can be done concurrently
+      DT_OMP_PRAGMA(parallel for default(firstprivate) schedule(dynamic))
       for(uint32_t id = 2; id < segall->nr; id++)
-      {
         segall->val1[id] = _segment_maxdistance(distance, segall, id);
 
+      // now we check for significant all-clipped-segments and reconstruct data.
+      // this stays serial per segment as the gradients share the tmp scratch
+      // buffer and bounding boxes of neighbouring segments may overlap
+      for(uint32_t id = 2; id < segall->nr; id++)
+      {
         if(segall->val1[id] > 2.0f)
           _segment_gradients(distance, recout, tmp, recovery_mode, segall, id, recovery_close);
       }
@@ -674,6 +680,8 @@ static void _process_segmentation(dt_dev_pixelpipe_iop_t *piece,
       const float noise_level = d->noise_level;
       if(noise_level > 0.0f)
       {
+        // segments write disjoint locations so this is safe in parallel
+        DT_OMP_PRAGMA(parallel for default(firstprivate) schedule(dynamic))
         for(uint32_t id = 2; id < segall->nr; id++)
         {
           if(segall->val1[id] > 3.0f)
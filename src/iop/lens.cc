@@ -204,6 +204,15 @@ typedef struct dt_iop_lens_global_data_t
   int kernel_md_vignette;
   int kernel_md_correct;
   lfDatabase *db;
+  /* cached subpixel displacement grids, shared by all instances.  images
+     of a same-lens burst or timelapse use identical correction maths, so
+     the grid computed for one image can be re-used for the next.  two
+     slots as the full and preview pipes run interleaved with different
+     regions of interest */
+  dt_pthread_mutex_t distort_lock;
+  dt_hash_t distort_hash[2];
+  size_t distort_size[2];
+  float *distort_buf[2];
 } dt_iop_lens_global_data_t;
 
 typedef struct dt_iop_lens_data_t
@@ -996,6 +1005,81 @@ static lfModifier * _get_modifier(int *mods_done,
   return mod;
 }
 
+/* return the subpixel displacement field for roi_out, re-using the grid
+   cached in global data if the lens settings and the requested region
+   match the previous run.  the caller owns the returned buffer; NULL
+   means the grid would be too large to keep around and the caller should
+   fall back to the rowwise computation */
+static float *_get_distortion_grid(dt_iop_lens_global_data_t *gd,
+                                   dt_dev_pixelpipe_iop_t *piece,
+                                   const dt_iop_lens_data_t *d,
+                                   const lfModifier *modifier,
+                                   const int modflags,
+                                   const float orig_w,
+                                   const float orig_h,
+                                   const dt_iop_roi_t *const roi_out)
+{
+  const size_t bufsize = (size_t)roi_out->width * roi_out->height * 2 * 3;
+  if(bufsize * sizeof(float) > dt_get_singlebuffer_mem())
+    return NULL;
+
+  float *const buf = dt_alloc_align_float(bufsize);
+  if(!buf) return NULL;
+
+  /* hash everything the displacement depends on; inverse, scale, crop,
+     focal, aperture and distance are laid out contiguously */
+  dt_hash_t hash = dt_hash(DT_INITHASH, &d->modify_flags,
+                           sizeof(d->modify_flags));
+  hash = dt_hash(hash, &d->inverse, sizeof(int) + 5 * sizeof(float));
+  hash = dt_hash(hash, &d->target_geom, sizeof(d->target_geom));
+  hash = dt_hash(hash, &d->tca_override, sizeof(d->tca_override));
+  if(d->tca_override)
+    hash = dt_hash(hash, &d->custom_tca.Terms, sizeof(d->custom_tca.Terms));
+  if(d->lens->Maker)
+    hash = dt_hash(hash, d->lens->Maker, strlen(d->lens->Maker));
+  if(d->lens->Model)
+    hash = dt_hash(hash, d->lens->Model, strlen(d->lens->Model));
+  hash = dt_hash(hash, &modflags, sizeof(modflags));
+  const float orig[2] = { orig_w, orig_h };
+  hash = dt_hash(hash, orig, sizeof(orig));
+  hash = dt_hash(hash, roi_out, sizeof(*roi_out));
+
+  const int slot = (piece->pipe->type & (DT_DEV_PIXELPIPE_PREVIEW
+                                         | DT_DEV_PIXELPIPE_PREVIEW2
+                                         | DT_DEV_PIXELPIPE_THUMBNAIL)) ? 1 : 0;
+
+  dt_pthread_mutex_lock(&gd->distort_lock);
+  if(gd->distort_hash[slot] == hash && gd->distort_buf[slot])
+  {
+    memcpy(buf, gd->distort_buf[slot], bufsize * sizeof(float));
+    dt_pthread_mutex_unlock(&gd->distort_lock);
+    return buf;
+  }
+  dt_pthread_mutex_unlock(&gd->distort_lock);
+
+  DT_OMP_FOR(dt_omp_sharedconst(buf) shared(modifier))
+  for(int y = 0; y < roi_out->height; y++)
+    modifier->ApplySubpixelGeometryDistortion(roi_out->x, roi_out->y + y,
+                                              roi_out->width, 1,
+                                              buf + (size_t)y * roi_out->width * 6);
+
+  dt_pthread_mutex_lock(&gd->distort_lock);
+  if(gd->distort_size[slot] != bufsize)
+  {
+    dt_free_align(gd->distort_buf[slot]);
+    gd->distort_buf[slot] = dt_alloc_align_float(bufsize);
+    gd->distort_size[slot] = gd->distort_buf[slot] ? bufsize : 0;
+  }
+  if(gd->distort_buf[slot])
+  {
+    memcpy(gd->distort_buf[slot], buf, bufsize * sizeof(float));
+    gd->distort_hash[slot] = hash;
+  }
+  dt_pthread_mutex_unlock(&gd->distort_lock);
+
+  return buf;
+}
+
 static float _get_autoscale_lf(dt_iop_module_t *self,
                                dt_iop_lens_params_t *p,
                                const lfCamera *camera)
@@ -1049,6 +1133,7 @@ static void _process_lf(dt_iop_module_t *self,
                         const dt_iop_roi_t *const roi_out)
 {
   const dt_iop_lens_data_t *const d = (dt_iop_lens_data_t *)piece->data;
+  dt_iop_lens_global_data_t *gd = (dt_iop_lens_global_data_t *)self->global_data;
 
   const int ch = piece->colors;
   const int ch_width = ch * roi_in->width;
@@ -1085,6 +1170,14 @@ static void _process_lf(dt_iop_module_t *self,
 
   const dt_interpolation_t *const interpolation = dt_interpolation_new(DT_INTERPOLATION_USERPREF_WARP);
 
+  float *const grid = (modflags & (LF_MODIFY_TCA
+                                   | LF_MODIFY_DISTORTION
+                                   | LF_MODIFY_GEOMETRY
+                                   | LF_MODIFY_SCALE))
+    ? _get_distortion_grid(gd, piece, d, modifier, modflags,
+                           orig_w, orig_h, roi_out)
+    : NULL;
+
   if(d->inverse)
   {
     // reverse direction (useful for renderings)
@@ -1099,12 +1192,18 @@ static void _process_lf(dt_iop_module_t *self,
       size_t padded_bufsize;
       float *const buf = dt_alloc_perthread_float(bufsize, &padded_bufsize);
 
-      DT_OMP_FOR(dt_omp_sharedconst(buf) shared(modifier))
+      DT_OMP_FOR(dt_omp_sharedconst(buf, grid) shared(modifier))
       for(int y = 0; y < roi_out->height; y++)
       {
-        float *bufptr = (float*)dt_get_perthread(buf, padded_bufsize);
-        modifier->ApplySubpixelGeometryDistortion(roi_out->x, roi_out->y + y,
-                                                  roi_out->width, 1, bufptr);
+        float *bufptr;
+        if(grid)
+          bufptr = grid + (size_t)y * roi_out->width * 6;
+        else
+        {
+          bufptr = (float*)dt_get_perthread(buf, padded_bufsize);
+          modifier->ApplySubpixelGeometryDistortion(roi_out->x, roi_out->y + y,
+                                                    roi_out->width, 1, bufptr);
+        }
 
         // reverse transform the global coords from lf to our buffer
         float *out = ((float *)ovoid) + (size_t)y * roi_out->width * ch;
@@ -1209,14 +1308,20 @@ static void _process_lf(dt_iop_module_t *self,
       size_t padded_buf2size;
       float *const buf2 = dt_alloc_perthread_float(buf2size, &padded_buf2size);
 
-      DT_OMP_FOR(dt_omp_sharedconst(buf2) shared(buf, modifier))
+      DT_OMP_FOR(dt_omp_sharedconst(buf2, grid) shared(buf, modifier))
       for(int y = 0; y < roi_out->height; y++)
       {
-        float *buf2ptr = (float*)dt_get_perthread(buf2, padded_buf2size);
-        modifier->ApplySubpixelGeometryDistortion(roi_out->x,
-                                                  roi_out->y + y,
-                                                  roi_out->width,
-                                                  1, buf2ptr);
+        float *buf2ptr;
+        if(grid)
+          buf2ptr = grid + (size_t)y * roi_out->width * 6;
+        else
+        {
+          buf2ptr = (float*)dt_get_perthread(buf2, padded_buf2size);
+          modifier->ApplySubpixelGeometryDistortion(roi_out->x,
+                                                    roi_out->y + y,
+                                                    roi_out->width,
+                                                    1, buf2ptr);
+        }
         // reverse transform the global coords from lf to our buffer
         float *out = ((float *)ovoid) + (size_t)y * roi_out->width * ch;
         for(int x = 0; x < roi_out->width; x++, buf2ptr += 6, out += ch)
@@ -1274,6 +1379,7 @@ static void _process_lf(dt_iop_module_t *self,
     }
     dt_free_align(buf);
   }
+  dt_free_align(grid);
   delete modifier;
 }
 
@@ -1376,18 +1482,24 @@ static int _process_cl_lf(dt_iop_module_t *self,
                    | LF_MODIFY_GEOMETRY
                    | LF_MODIFY_SCALE))
     {
-      DT_OMP_FOR(dt_omp_sharedconst(raw_monochrome) shared(tmpbuf, d, modifier))
-      for(int y = 0; y < roi_out->height; y++)
+      float *const grid = _get_distortion_grid(gd, piece, d, modifier, modflags,
+                                               orig_w, orig_h, roi_out);
+      if(!grid)
       {
-        float *pi = tmpbuf + (size_t)y * tmpbufwidth;
-        modifier->ApplySubpixelGeometryDistortion(roi_out->x,
-                                                  roi_out->y + y,
-                                                  roi_out->width, 1, pi);
+        DT_OMP_FOR(dt_omp_sharedconst(raw_monochrome) shared(tmpbuf, d, modifier))
+        for(int y = 0; y < roi_out->height; y++)
+        {
+          float *pi = tmpbuf + (size_t)y * tmpbufwidth;
+          modifier->ApplySubpixelGeometryDistortion(roi_out->x,
+                                                    roi_out->y + y,
+                                                    roi_out->width, 1, pi);
+        }
       }
 
-      err = dt_opencl_write_buffer_to_device(devid, tmpbuf,
+      err = dt_opencl_write_buffer_to_device(devid, grid ? grid : tmpbuf,
                                              dev_tmpbuf, 0,
                                              tmpbufsize, CL_TRUE);
+      dt_free_align(grid);
       if(err != CL_SUCCESS) goto error;
 
       err = dt_opencl_enqueue_kernel_2d_args(devid, ldkernel, owidth, oheight,
@@ -1487,18 +1599,24 @@ static int _process_cl_lf(dt_iop_module_t *self,
                    | LF_MODIFY_GEOMETRY
                    | LF_MODIFY_SCALE))
     {
-      DT_OMP_FOR(dt_omp_sharedconst(raw_monochrome) shared(tmpbuf, d, modifier))
-      for(int y = 0; y < roi_out->height; y++)
+      float *const grid = _get_distortion_grid(gd, piece, d, modifier, modflags,
+                                               orig_w, orig_h, roi_out);
+      if(!grid)
       {
-        float *pi = tmpbuf + (size_t)y * tmpbufwidth;
-        modifier->ApplySubpixelGeometryDistortion(roi_out->x,
-                                                  roi_out->y + y,
-                                                  roi_out->width, 1, pi);
+        DT_OMP_FOR(dt_omp_sharedconst(raw_monochrome) shared(tmpbuf, d, modifier))
+        for(int y = 0; y < roi_out->height; y++)
+        {
+          float *pi = tmpbuf + (size_t)y * tmpbufwidth;
+          modifier->ApplySubpixelGeometryDistortion(roi_out->x,
+                                                    roi_out->y + y,
+                                                    roi_out->width, 1, pi);
+        }
       }
 
-      err = dt_opencl_write_buffer_to_device(devid, tmpbuf,
+      err = dt_opencl_write_buffer_to_device(devid, grid ? grid : tmpbuf,
                                              dev_tmpbuf, 0,
                                              tmpbufsize, CL_TRUE);
+      dt_free_align(grid);
       if(err != CL_SUCCESS) goto error;
 
       err = dt_opencl_enqueue_kernel_2d_args
@@ -3348,6 +3466,8 @@ void init_global(dt_iop_module_so_t *self)
   gd->kernel_md_correct =
     dt_opencl_create_kernel(program, "md_lens_correction");
 
+  dt_pthread_mutex_init(&gd->distort_lock, NULL);
+
   lfDatabase *dt_iop_lensfun_db = new lfDatabase;
   gd->db = (lfDatabase *)dt_iop_lensfun_db;
 
@@ -3596,6 +3716,9 @@ void cleanup_global(dt_iop_module_so_t *self)
   dt_opencl_free_kernel(gd->kernel_lens_man_vignette);
   dt_opencl_free_kernel(gd->kernel_md_vignette);
   dt_opencl_free_kernel(gd->kernel_md_correct);
+  dt_free_align(gd->distort_buf[0]);
+  dt_free_align(gd->distort_buf[1]);
+  dt_pthread_mutex_destroy(&gd->distort_lock);
   free(self->data);
   self->data = NULL;
 }
@@ -1173,6 +1173,138 @@ static float complex *create_global_distortion_map(const cairo_rectangle_int_t *
   return map;
 }
 
+// a group of warps with mutually overlapping stamp extents and the distortion map covering them
+typedef struct dt_liquify_cluster_t
+{
+  cairo_rectangle_int_t extent;  // bounding box of all stamps in the cluster
+  GSList *warps;                 // borrowed pointers into the interpolated warp list
+  float complex *map;            // distortion map covering extent, built once the cluster is complete
+} dt_liquify_cluster_t;
+
+static gboolean _rect_overlap(const cairo_rectangle_int_t *const a, const cairo_rectangle_int_t *const b)
+{
+  return a->x < b->x + b->width && b->x < a->x + a->width
+      && a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+static void _rect_union(cairo_rectangle_int_t *a, const cairo_rectangle_int_t *const b)
+{
+  const int x2 = MAX(a->x + a->width, b->x + b->width);
+  const int y2 = MAX(a->y + a->height, b->y + b->height);
+  a->x = MIN(a->x, b->x);
+  a->y = MIN(a->y, b->y);
+  a->width = x2 - a->x;
+  a->height = y2 - a->y;
+}
+
+/*
+  Group the warps into clusters of mutually overlapping stamp extents.
+
+  Warps from different clusters never influence the same pixel, so each
+  cluster can be splatted into its own small distortion map instead of
+  one map covering the bounding box of every warp.  With many nodes
+  spread over the image the single bounding box approaches the full
+  image size, and both building and applying the map then scan millions
+  of pixels which no stamp ever touches; per-cluster maps skip those
+  pixels entirely.
+*/
+static GSList *_cluster_warps(const GSList *warps)
+{
+  GSList *clusters = NULL;
+
+  for(const GSList *i = warps; i; i = g_slist_next(i))
+  {
+    dt_liquify_warp_t *const warp = (dt_liquify_warp_t *) i->data;
+    cairo_rectangle_int_t extent;
+    compute_round_stamp_extent(&extent, warp);
+
+    // find all clusters touched by this stamp; the first becomes its home and absorbs the others,
+    // since the stamp bridges them into a single connected group
+    dt_liquify_cluster_t *home = NULL;
+    GSList *c = clusters;
+    while(c)
+    {
+      GSList *const next = g_slist_next(c);
+      dt_liquify_cluster_t *const cluster = c->data;
+      if(_rect_overlap(&extent, &cluster->extent))
+      {
+        if(!home)
+          home = cluster;
+        else
+        {
+          _rect_union(&home->extent, &cluster->extent);
+          home->warps = g_slist_concat(home->warps, cluster->warps);
+          clusters = g_slist_remove(clusters, cluster);
+          free(cluster);
+        }
+      }
+      c = next;
+    }
+
+    if(!home)
+    {
+      home = calloc(1, sizeof(dt_liquify_cluster_t));
+      if(!home) continue;
+      home->extent = extent;
+      clusters = g_slist_prepend(clusters, home);
+    }
+    else
+      _rect_union(&home->extent, &extent);
+    home->warps = g_slist_prepend(home->warps, warp);
+  }
+
+  return clusters;
+}
+
+static void _free_clusters(GSList *clusters)
+{
+  for(GSList *c = clusters; c; c = g_slist_next(c))
+  {
+    dt_liquify_cluster_t *const cluster = c->data;
+    dt_free_align((void *) cluster->map);
+    g_slist_free(cluster->warps);
+    free(cluster);
+  }
+  g_slist_free(clusters);
+}
+
+/*
+  Build the distortion maps for all warps relevant to roi, one map per
+  cluster of overlapping stamps.  Returns the list of clusters with
+  their maps ready to apply; pixels outside every cluster extent are
+  not covered by any map and need no warp evaluation at all.
+*/
+static GSList *_build_clustered_distortion_maps(const dt_iop_module_t *self,
+                                                const dt_dev_pixelpipe_iop_t *piece,
+                                                const float scale,
+                                                const dt_iop_roi_t *roi)
+{
+  // copy params
+  dt_iop_liquify_params_t copy_params;
+  memcpy(&copy_params, piece->data, sizeof(dt_iop_liquify_params_t));
+
+  distort_paths_raw_to_piece(self, piece->pipe, scale, &copy_params);
+
+  GList *interpolated = interpolate_paths(&copy_params);
+  cairo_rectangle_int_t map_extent;
+  GSList *interpolated_in_roi = _get_map_extent(roi, interpolated, &map_extent);
+
+  GSList *clusters = _cluster_warps(interpolated_in_roi);
+  for(GSList *c = clusters; c; c = g_slist_next(c))
+  {
+    dt_liquify_cluster_t *const cluster = c->data;
+    cluster->map = create_global_distortion_map(&cluster->extent, cluster->warps, FALSE);
+    // the maps are built, so the borrowed warp pointers are no longer needed
+    g_slist_free(cluster->warps);
+    cluster->warps = NULL;
+  }
+
+  g_slist_free(interpolated_in_roi);
+  g_list_free_full(interpolated, free);
+
+  return clusters;
+}
+
 static void _build_global_distortion_map(const dt_iop_module_t *self,
                                          const dt_dev_pixelpipe_iop_t *piece,
                                          const float scale,
@@ -1366,24 +1498,21 @@ void distort_mask(dt_iop_module_t *self,
   // 1. copy the whole image (we'll change only a small part of it)
   dt_iop_copy_image_roi(out, in, 1, roi_in, roi_out);
 
-  // 2. build the distortion map
-  cairo_rectangle_int_t map_extent;
-  float complex *map = NULL;
-  _build_global_distortion_map(self, piece, roi_in->scale,
-                               roi_out, &map_extent, FALSE, &map);
-  if(map == NULL)
-    return;
+  // 2. build the distortion maps, one per cluster of overlapping warps
+  GSList *clusters = _build_clustered_distortion_maps(self, piece, roi_in->scale, roi_out);
 
-  // 3. apply the map
-  if(map_extent.width != 0 && map_extent.height != 0)
+  // 3. apply the maps
+  const int ch = piece->colors;
+  piece->colors = 1;
+  for(const GSList *c = clusters; c; c = g_slist_next(c))
   {
-    const int ch = piece->colors;
-    piece->colors = 1;
-    _apply_global_distortion_map(self, piece, in, out, roi_in, roi_out, map, &map_extent);
-    piece->colors = ch;
+    const dt_liquify_cluster_t *const cluster = c->data;
+    if(cluster->map)
+      _apply_global_distortion_map(self, piece, in, out, roi_in, roi_out, cluster->map, &cluster->extent);
   }
+  piece->colors = ch;
 
-  dt_free_align((void *) map);
+  _free_clusters(clusters);
 }
 
 void process(dt_iop_module_t *self,
@@ -1399,19 +1528,18 @@ void process(dt_iop_module_t *self,
   // 1. copy the whole image (we'll change only a small part of it)
   dt_iop_copy_image_roi(out, in, piece->colors, roi_in, roi_out);
 
-  // 2. build the distortion map
-  cairo_rectangle_int_t map_extent;
-  float complex *map = NULL;
-  _build_global_distortion_map(self, piece, roi_in->scale,
-                               roi_out, &map_extent, FALSE, &map);
-  if(map == NULL)
-    return;
+  // 2. build the distortion maps, one per cluster of overlapping warps
+  GSList *clusters = _build_clustered_distortion_maps(self, piece, roi_in->scale, roi_out);
 
-  // 3. apply the map
-  if(map_extent.width != 0 && map_extent.height != 0)
-    _apply_global_distortion_map(self, piece, in, out, roi_in, roi_out, map, &map_extent);
+  // 3. apply the maps
+  for(const GSList *c = clusters; c; c = g_slist_next(c))
+  {
+    const dt_liquify_cluster_t *const cluster = c->data;
+    if(cluster->map)
+      _apply_global_distortion_map(self, piece, in, out, roi_in, roi_out, cluster->map, &cluster->extent);
+  }
 
-  dt_free_align((void *)map);
+  _free_clusters(clusters);
 }
 
 #ifdef HAVE_OPENCL
@@ -1564,20 +1692,20 @@ int process_cl(dt_iop_module_t *self,
     if(err != CL_SUCCESS) return err;
   }
 
-  // 2. build the distortion map
-  cairo_rectangle_int_t map_extent;
-  float complex *map = NULL;
-  _build_global_distortion_map(self, piece, roi_in->scale,
-                               roi_out, &map_extent, FALSE, &map);
-
-  if(map == NULL)
-    return CL_SUCCESS;
+  // 2. build the distortion maps, one per cluster of overlapping warps
+  GSList *clusters = _build_clustered_distortion_maps(self, piece, roi_in->scale, roi_out);
 
-  // 3. apply the map
-  if(map_extent.width != 0 && map_extent.height != 0)
-    err = _apply_global_distortion_map_cl(self, piece, dev_in,
-                                          dev_out, roi_in, roi_out, map, &map_extent);
-  dt_free_align((void *) map);
+  // 3. apply the maps
+  err = CL_SUCCESS;
+  for(const GSList *c = clusters; c; c = g_slist_next(c))
+  {
+    const dt_liquify_cluster_t *const cluster = c->data;
+    if(cluster->map)
+      err = _apply_global_distortion_map_cl(self, piece, dev_in,
+                                            dev_out, roi_in, roi_out, cluster->map, &cluster->extent);
+    if(err != CL_SUCCESS) break;
+  }
+  _free_clusters(clusters);
   return err;
 }
 
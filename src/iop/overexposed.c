@@ -113,14 +113,6 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece, const void *c
 
   const int ch = 4;
 
-  float *restrict img_tmp = NULL;
-  if(!dt_iop_alloc_image_buffers(self, roi_in, roi_out, ch, &img_tmp, 0))
-  {
-    dt_iop_copy_image_roi(ovoid, ivoid, ch, roi_in, roi_out);
-    dt_control_log(_("module overexposed failed in buffer allocation"));
-    return;
-  }
-
   const float lower = exp2f(fminf(dev->overexposed.lower, -4.f));   // in EV
   const float upper = dev->overexposed.upper / 100.0f;              // in %
 
@@ -134,17 +126,36 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece, const void *c
   const dt_iop_order_iccprofile_info_t *const current_profile = dt_ioppr_get_pipe_current_profile_info(self, piece->pipe);
   const dt_iop_order_iccprofile_info_t *const work_profile = dt_ioppr_get_histogram_profile_info(dev);
 
-  // display mask using histogram profile as output
-  // FIXME: the histogram already does this work -- use that data instead?
-  if(current_profile && work_profile)
-    dt_ioppr_transform_image_colorspace_rgb(in, img_tmp, roi_out->width, roi_out->height, current_profile,
-                                            work_profile, self->op);
-  else
+  if(!current_profile || !work_profile)
   {
     dt_print(DT_DEBUG_ALWAYS, "[overexposed process] can't create transform profile");
     dt_iop_copy_image_roi(ovoid, ivoid, ch, roi_in, roi_out);
     dt_control_log(_("module overexposed failed in color conversion"));
-    goto process_finish;
+    return;
+  }
+
+  // if the image already is in the histogram profile the transform
+  // would just copy the buffer, so mark directly from the input and
+  // save the temporary buffer and the extra sweep over it
+  const gboolean same_profile = current_profile->type == work_profile->type
+    && strcmp(current_profile->filename, work_profile->filename) == 0;
+
+  float *restrict img_alloc = NULL;
+  const float *restrict img_tmp = in;
+  if(!same_profile)
+  {
+    if(!dt_iop_alloc_image_buffers(self, roi_in, roi_out, ch, &img_alloc, 0))
+    {
+      dt_iop_copy_image_roi(ovoid, ivoid, ch, roi_in, roi_out);
+      dt_control_log(_("module overexposed failed in buffer allocation"));
+      return;
+    }
+
+    // display mask using histogram profile as output
+    // FIXME: the histogram already does this work -- use that data instead?
+    dt_ioppr_transform_image_colorspace_rgb(in, img_alloc, roi_out->width, roi_out->height, current_profile,
+                                            work_profile, self->op);
+    img_tmp = img_alloc;
   }
   // flush denormals to zero to avoid performance penalty if there are a lot of near-zero values
   const unsigned int oldMode = dt_mm_enable_flush_zero();
@@ -298,8 +309,7 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece, const void *c
   if(piece->pipe->mask_display & DT_DEV_PIXELPIPE_DISPLAY_MASK)
     dt_iop_alpha_copy(ivoid, ovoid, roi_out->width, roi_out->height);
 
-process_finish:
-  dt_free_align(img_tmp);
+  dt_free_align(img_alloc);
 }
 
 #ifdef HAVE_OPENCL
@@ -321,23 +331,33 @@ int process_cl(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece, cl_mem dev_
   const dt_iop_order_iccprofile_info_t *const current_profile = dt_ioppr_get_pipe_current_profile_info(self, piece->pipe);
   const dt_iop_order_iccprofile_info_t *const work_profile = dt_ioppr_get_histogram_profile_info(dev);
 
-  // display mask using histogram profile as output
-  dev_tmp = dt_opencl_alloc_device(devid, width, height, sizeof(float) * ch);
-  if(dev_tmp == NULL)
+  if(!current_profile || !work_profile)
   {
-    err = CL_MEM_OBJECT_ALLOCATION_FAILURE;
-    dt_control_log(_("module overexposed failed in buffer allocation"));
+    dt_print(DT_DEBUG_ALWAYS, "[overexposed process_cl] can't create transform profile");
+    dt_control_log(_("module overexposed failed in color conversion"));
     goto error;
   }
 
-  if(current_profile && work_profile)
+  // as in the CPU path, skip the transform into a temporary buffer if
+  // the image already is in the histogram profile
+  const gboolean same_profile = current_profile->type == work_profile->type
+    && strcmp(current_profile->filename, work_profile->filename) == 0;
+
+  cl_mem dev_marker = dev_in;
+  if(!same_profile)
+  {
+    // display mask using histogram profile as output
+    dev_tmp = dt_opencl_alloc_device(devid, width, height, sizeof(float) * ch);
+    if(dev_tmp == NULL)
+    {
+      err = CL_MEM_OBJECT_ALLOCATION_FAILURE;
+      dt_control_log(_("module overexposed failed in buffer allocation"));
+      goto error;
+    }
+
     dt_ioppr_transform_image_colorspace_rgb_cl(devid, dev_in, dev_tmp, roi_out->width, roi_out->height,
                                                current_profile, work_profile, self->op);
-  else
-  {
-    dt_print(DT_DEBUG_ALWAYS, "[overexposed process_cl] can't create transform profile");
-    dt_control_log(_("module overexposed failed in color conversion"));
-    goto error;
+    dev_marker = dev_tmp;
   }
 
   const int use_work_profile = (work_profile == NULL) ? 0 : 1;
@@ -359,7 +379,7 @@ int process_cl(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece, cl_mem dev_
   const int mode = dev->overexposed.mode;
 
   err = dt_opencl_enqueue_kernel_2d_args(devid, gd->kernel_overexposed, width, height,
-    CLARG(dev_in), CLARG(dev_out), CLARG(dev_tmp), CLARG(width), CLARG(height), CLARG(lower), CLARG(upper),
+    CLARG(dev_in), CLARG(dev_out), CLARG(dev_marker), CLARG(width), CLARG(height), CLARG(lower), CLARG(upper),
     CLARRAY(4, lower_color), CLARRAY(4, upper_color),
     CLARG(dev_profile_info), CLARG(dev_profile_lut), CLARG(use_work_profile), CLARG(mode));
 
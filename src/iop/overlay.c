@@ -17,6 +17,7 @@
 */
 
 #include "bauhaus/bauhaus.h"
+#include "common/history.h"
 #include "common/math.h"
 #include "common/overlay.h"
 #include "control/control.h"
@@ -112,6 +113,7 @@ typedef struct dt_iop_overlay_global_data_t
   uint8_t *cache[MAX_OVERLAY];
   size_t cwidth[MAX_OVERLAY];
   size_t cheight[MAX_OVERLAY];
+  dt_hash_t ckey[MAX_OVERLAY]; // source image & history state the slot was rendered from
   dt_pthread_mutex_t overlay_threadsafe;
 } dt_iop_overlay_global_data_t;
 
@@ -247,6 +249,28 @@ static void _clear_cache_entry(const dt_iop_module_t *self, const int index)
 
   dt_free_align(gd->cache[index]);
   gd->cache[index] = NULL;
+  gd->ckey[index] = DT_INVALID_HASH;
+}
+
+/* key identifying a rendered overlay: the source image, its current
+   history state and the size the render was requested for. a cached
+   buffer is only served while this matches, so editing the overlay
+   source elsewhere invalidates the slot without any signal plumbing */
+static dt_hash_t _overlay_key(const dt_iop_module_t *self, const dt_imgid_t imgid)
+{
+  dt_history_hash_values_t hash = { 0 };
+  dt_history_hash_read(imgid, &hash);
+
+  dt_hash_t key = dt_hash(DT_INITHASH, &imgid, sizeof(imgid));
+  const size_t width = self->dev->image_storage.width;
+  key = dt_hash(key, &width, sizeof(width));
+  if(hash.current)
+    key = dt_hash(key, hash.current, hash.current_len);
+
+  g_free(hash.basic);
+  g_free(hash.auto_apply);
+  g_free(hash.current);
+  return key;
 }
 
 static void _module_remove_callback(gpointer instance,
@@ -361,6 +385,10 @@ void process(dt_iop_module_t *self,
   if(!dt_is_valid_imgid(data->imgid))
     _clear_cache_entry(self, index);
 
+  const dt_hash_t key = dt_is_valid_imgid(data->imgid)
+      ? _overlay_key(self, data->imgid)
+      : DT_INVALID_HASH;
+
   // scratch buffer data and dimension
   uint8_t *cbuf = NULL;
   size_t cwidth = 0;
@@ -370,11 +398,24 @@ void process(dt_iop_module_t *self,
   size_t *pwidth;
   size_t *pheight;
 
+  gboolean use_cacheline = FALSE;
+
   // if called from darkroom (the edited image is the one in
-  // darktable->develop) we use the cache, otherwise we just use a
-  // scratch buffer local to process for rendering.
-  if(self->dev->image_storage.id == darktable.develop->image_storage.id)
+  // darktable->develop) we use the cache. other pipes - exports and
+  // thumbnails - may also serve the cacheline when it was rendered from
+  // the very same overlay state, or claim it when it's still free, so a
+  // batch export of a composite renders its overlay only once. otherwise
+  // we just use a scratch buffer local to process for rendering.
+  if(self->dev->image_storage.id == darktable.develop->image_storage.id
+     || gd->ckey[index] == key
+     || !gd->cache[index])
   {
+    // drop the cacheline if it was rendered from another source image,
+    // history state or size
+    if(gd->cache[index] && gd->ckey[index] != key)
+      _clear_cache_entry(self, index);
+
+    use_cacheline = TRUE;
     pbuf = &gd->cache[index];
     pwidth = &gd->cwidth[index];
     pheight = &gd->cheight[index];
@@ -391,6 +432,8 @@ void process(dt_iop_module_t *self,
     // need the overlay - either because we use the scratch buffer or the cacheline
     // is still empty - create the buffer now and leave address dimension
     _setup_overlay(self, piece, pbuf, pwidth, pheight);
+    if(use_cacheline)
+      gd->ckey[index] = *pbuf ? key : DT_INVALID_HASH;
   }
 
   dt_pthread_mutex_unlock(&gd->overlay_threadsafe);
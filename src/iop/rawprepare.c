@@ -77,7 +77,7 @@ typedef struct dt_iop_rawprepare_data_t
 
   // image contains GainMaps that should be applied
   gboolean apply_gainmaps;
-  // GainMap for each filter of RGGB Bayer pattern
+  // GainMap for each filter of RGGB Bayer pattern, owned by the piece
   dt_dng_gain_map_t *gainmaps[4];
 } dt_iop_rawprepare_data_t;
 
@@ -628,15 +628,19 @@ static gboolean _check_gain_maps(dt_iop_module_t *self, dt_dng_gain_map_t **gain
   const dt_image_t *const image = &(self->dev->image_storage);
   dt_dng_gain_map_t *gainmaps[4] = {0};
 
-  if(g_list_length(image->dng_gain_maps) != 4)
-    return FALSE;
+  // the GainMaps are only parsed from the stashed OpcodeList2 blob once
+  // the pipe gets here, so loads that never reach this module don't pay
+  GList *maps = dt_dng_opcode_get_gain_maps(image);
+
+  if(g_list_length(maps) != 4)
+    goto error;
 
   // FIXME checks for width / height might be wrong
   for(int i = 0; i < 4; i++)
   {
     // check that each GainMap applies to one filter of a Bayer image,
     // covers the entire image, and is not a 1x1 no-op
-    dt_dng_gain_map_t *g = g_list_nth_data(image->dng_gain_maps, i);
+    dt_dng_gain_map_t *g = g_list_nth_data(maps, i);
     if(g == NULL
        || g->plane != 0
        || g->planes != 1
@@ -649,7 +653,7 @@ static gboolean _check_gain_maps(dt_iop_module_t *self, dt_dng_gain_map_t **gain
        || g->left > 1
        || g->bottom != image->height
        || g->right != image->width)
-      return FALSE;
+      goto error;
 
     const uint32_t filter = ((g->top & 1) << 1) + (g->left & 1);
     gainmaps[filter] = g;
@@ -657,7 +661,7 @@ static gboolean _check_gain_maps(dt_iop_module_t *self, dt_dng_gain_map_t **gain
 
   // check that there is a GainMap for each filter of the Bayer pattern
   if(gainmaps[0] == NULL || gainmaps[1] == NULL || gainmaps[2] == NULL || gainmaps[3] == NULL)
-    return FALSE;
+    goto error;
 
   // check that each GainMap has the same shape
   for(int i = 1; i < 4; i++)
@@ -668,13 +672,23 @@ static gboolean _check_gain_maps(dt_iop_module_t *self, dt_dng_gain_map_t **gain
        || gainmaps[i]->map_spacing_v != gainmaps[0]->map_spacing_v
        || gainmaps[i]->map_origin_h != gainmaps[0]->map_origin_h
        || gainmaps[i]->map_origin_v != gainmaps[0]->map_origin_v)
-      return FALSE;
+      goto error;
   }
 
   if(gainmaps_out)
+  {
+    // the caller takes ownership of the four maps, drop only the list cells
     memcpy(gainmaps_out, gainmaps, sizeof(gainmaps));
+    g_list_free(maps);
+  }
+  else
+    g_list_free_full(maps, g_free);
 
   return TRUE;
+
+error:
+  g_list_free_full(maps, g_free);
+  return FALSE;
 }
 
 void commit_params(dt_iop_module_t *self,
@@ -723,6 +737,11 @@ void commit_params(dt_iop_module_t *self,
   d->rawprepare.raw_black_level = (uint16_t)roundf(black / 4.0f);
   d->rawprepare.raw_white_point = p->raw_white_point;
 
+  for(int i = 0; i < 4; i++)
+  {
+    g_free(d->gainmaps[i]);
+    d->gainmaps[i] = NULL;
+  }
   if(p->flat_field == FLAT_FIELD_EMBEDDED)
     d->apply_gainmaps = _check_gain_maps(self, d->gainmaps);
   else
@@ -746,6 +765,9 @@ void init_pipe(dt_iop_module_t *self, dt_dev_pixelpipe_t *pipe, dt_dev_pixelpipe
 
 void cleanup_pipe(dt_iop_module_t *self, dt_dev_pixelpipe_t *pipe, dt_dev_pixelpipe_iop_t *piece)
 {
+  dt_iop_rawprepare_data_t *d = piece->data;
+  for(int i = 0; i < 4; i++)
+    g_free(d->gainmaps[i]);
   free(piece->data);
   piece->data = NULL;
 }
@@ -101,6 +101,7 @@ typedef struct dt_iop_rgbcurve_data_t
   dt_draw_curve_t *curve[DT_IOP_RGBCURVE_MAX_CHANNELS];    // curves for pipe piece and pixel processing
   float unbounded_coeffs[DT_IOP_RGBCURVE_MAX_CHANNELS][3]; // approximation for extrapolation
   gboolean curve_changed[DT_IOP_RGBCURVE_MAX_CHANNELS];    // curve type changed?
+  dt_hash_t curve_hash[DT_IOP_RGBCURVE_MAX_CHANNELS];      // hash of the curve each table was built from
   dt_colorspaces_color_profile_type_t type_work; // working color profile
   char filename_work[DT_IOP_COLOR_ICC_LEN];
 } dt_iop_rgbcurve_data_t;
@@ -1612,6 +1613,7 @@ void init_pipe(dt_iop_module_t *self,
     for(int k = 0; k < default_params->curve_num_nodes[ch]; k++)
       dt_draw_curve_add_point(d->curve[ch], default_params->curve_nodes[ch][k].x,
                                     default_params->curve_nodes[ch][k].y);
+    d->curve_hash[ch] = DT_INVALID_HASH;
   }
 
   for(int k = 0; k < 0x10000; k++)
@@ -1724,7 +1726,14 @@ static void _generate_curve_lut(dt_dev_pixelpipe_t *pipe,
       dt_draw_curve_set_point(d->curve[ch], k, curve_nodes[ch][k].x, curve_nodes[ch][k].y);
     d->curve[ch]->c.m_numAnchors = d->params.curve_num_nodes[ch];
 
-    dt_draw_curve_calc_values(d->curve[ch], 0.0f, 1.0f, 0x10000, NULL, d->table[ch]);
+    // only resample a curve whose anchors actually moved, so slider
+    // drags on one channel don't rebuild the other two tables
+    const dt_hash_t hash = dt_draw_curve_hash(d->curve[ch]);
+    if(hash != d->curve_hash[ch])
+    {
+      dt_draw_curve_calc_values(d->curve[ch], 0.0f, 1.0f, 0x10000, NULL, d->table[ch]);
+      d->curve_hash[ch] = hash;
+    }
   }
 
   // extrapolation for each curve (right hand side only):
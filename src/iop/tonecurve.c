@@ -133,6 +133,7 @@ typedef struct dt_iop_tonecurve_data_t
   dt_draw_curve_t *curve[3];     // curves for pipe piece and pixel processing
   int curve_nodes[3];            // number of nodes
   int curve_type[3];             // curve style (e.g. CUBIC_SPLINE)
+  dt_hash_t curve_hash[3];       // hash of the curve each table was built from
   float table[3][0x10000];       // precomputed look-up tables for tone curve
   float unbounded_coeffs_L[3];   // approximation for extrapolation of L
   float unbounded_coeffs_ab[12]; // approximation for extrapolation of ab (left and right)
@@ -752,43 +753,60 @@ void commit_params(dt_iop_module_t *self,
         dt_draw_curve_set_point(d->curve[ch], k,
                                 p->tonecurve[ch][k].x, p->tonecurve[ch][k].y);
     }
+
+    // each table holds the fully derived values for its channel, so it
+    // only has to be rebuilt when its own nodes moved - for the L table
+    // additionally when the autoscale mode it was derived for changed.
+    // this keeps slider drags from resampling the two untouched curves.
+    const dt_hash_t hash = dt_draw_curve_hash(d->curve[ch]);
+    if(hash == d->curve_hash[ch]
+       && !(ch == ch_L && p->tonecurve_autoscale_ab != d->autoscale_ab))
+      continue;
+    d->curve_hash[ch] = hash;
+
     dt_draw_curve_calc_values(d->curve[ch], 0.0f, 1.0f, 0x10000, NULL, d->table[ch]);
-  }
-  for(int k = 0; k < 0x10000; k++)
-  {
-    d->table[ch_L][k] *= 100.0f;
-    d->table[ch_a][k] = d->table[ch_a][k] * 256.0f - 128.0f;
-    d->table[ch_b][k] = d->table[ch_b][k] * 256.0f - 128.0f;
-  }
 
-  piece->process_cl_ready = TRUE;
-  if(p->tonecurve_autoscale_ab == DT_S_SCALE_AUTOMATIC_XYZ)
-  {
-    // derive curve for XYZ:
-    for(int k=0;k<0x10000;k++)
+    if(ch == ch_L)
     {
-      dt_aligned_pixel_t XYZ = {k/(float)0x10000, k/(float)0x10000, k/(float)0x10000};
-      dt_aligned_pixel_t Lab = {0.0};
-      dt_XYZ_to_Lab(XYZ, Lab);
-      Lab[0] = d->table[ch_L][CLAMP((int)(Lab[0]/100.0f * 0x10000), 0, 0xffff)];
-      dt_Lab_to_XYZ(Lab, XYZ);
-      d->table[ch_L][k] = XYZ[1]; // now mapping Y_in to Y_out
+      for(int k = 0; k < 0x10000; k++)
+        d->table[ch_L][k] *= 100.0f;
+
+      if(p->tonecurve_autoscale_ab == DT_S_SCALE_AUTOMATIC_XYZ)
+      {
+        // derive curve for XYZ:
+        for(int k=0;k<0x10000;k++)
+        {
+          dt_aligned_pixel_t XYZ = {k/(float)0x10000, k/(float)0x10000, k/(float)0x10000};
+          dt_aligned_pixel_t Lab = {0.0};
+          dt_XYZ_to_Lab(XYZ, Lab);
+          Lab[0] = d->table[ch_L][CLAMP((int)(Lab[0]/100.0f * 0x10000), 0, 0xffff)];
+          dt_Lab_to_XYZ(Lab, XYZ);
+          d->table[ch_L][k] = XYZ[1]; // now mapping Y_in to Y_out
+        }
+      }
+      else if(p->tonecurve_autoscale_ab == DT_S_SCALE_AUTOMATIC_RGB)
+      {
+        // derive curve for rgb:
+        for(int k=0;k<0x10000;k++)
+        {
+          dt_aligned_pixel_t rgb = {k/(float)0x10000, k/(float)0x10000, k/(float)0x10000};
+          dt_aligned_pixel_t Lab = {0.0};
+          dt_prophotorgb_to_Lab(rgb, Lab);
+          Lab[0] = d->table[ch_L][CLAMP((int)(Lab[0]/100.0f * 0x10000), 0, 0xffff)];
+          dt_Lab_to_prophotorgb(Lab, rgb);
+          d->table[ch_L][k] = rgb[1]; // now mapping G_in to G_out
+        }
+      }
     }
-  }
-  else if(p->tonecurve_autoscale_ab == DT_S_SCALE_AUTOMATIC_RGB)
-  {
-    // derive curve for rgb:
-    for(int k=0;k<0x10000;k++)
+    else
     {
-      dt_aligned_pixel_t rgb = {k/(float)0x10000, k/(float)0x10000, k/(float)0x10000};
-      dt_aligned_pixel_t Lab = {0.0};
-      dt_prophotorgb_to_Lab(rgb, Lab);
-      Lab[0] = d->table[ch_L][CLAMP((int)(Lab[0]/100.0f * 0x10000), 0, 0xffff)];
-      dt_Lab_to_prophotorgb(Lab, rgb);
-      d->table[ch_L][k] = rgb[1]; // now mapping G_in to G_out
+      for(int k = 0; k < 0x10000; k++)
+        d->table[ch][k] = d->table[ch][k] * 256.0f - 128.0f;
     }
   }
 
+  piece->process_cl_ready = TRUE;
+
   d->autoscale_ab = p->tonecurve_autoscale_ab;
   d->unbound_ab = p->tonecurve_unbound_ab;
   d->preserve_colors = p->preserve_colors;
@@ -861,6 +879,7 @@ void init_pipe(dt_iop_module_t *self,
     d->curve[ch] = dt_draw_curve_new(0.0, 1.0, default_params->tonecurve_type[ch]);
     d->curve_nodes[ch] = default_params->tonecurve_nodes[ch];
     d->curve_type[ch] = default_params->tonecurve_type[ch];
+    d->curve_hash[ch] = DT_INVALID_HASH;
     for(int k = 0; k < default_params->tonecurve_nodes[ch]; k++)
       (void)dt_draw_curve_add_point(d->curve[ch], default_params->tonecurve[ch][k].x,
                                     default_params->tonecurve[ch][k].y);
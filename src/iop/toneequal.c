@@ -938,6 +938,49 @@ static inline void compute_luminance_mask(const float *const restrict in,
   }
 }
 
+
+__DT_CLONE_TARGETS__
+static inline void compute_luminance_mask_fast(const float *const restrict in,
+                                               float *const restrict luminance,
+                                               const size_t width,
+                                               const size_t height,
+                                               const dt_iop_toneequalizer_data_t *const d)
+{
+  // Approximate mask for interactive feedback : run the estimator and the
+  // guided filter on a quarter-resolution copy and joint-upsample the result.
+  // The guided filters internally downsample once more, so the expensive
+  // variance analysis touches only 1/16th of the pixels.
+  const size_t ds_width = width / 4;
+  const size_t ds_height = height / 4;
+
+  float *const restrict ds_in = (ds_width < 8 || ds_height < 8)
+    ? NULL
+    : dt_alloc_align_float(ds_width * ds_height * 4);
+  float *const restrict ds_luminance = ds_in
+    ? dt_alloc_align_float(ds_width * ds_height)
+    : NULL;
+
+  if(!ds_in || !ds_luminance)
+  {
+    // image too small or not enough memory for the cheap path : compute the real thing
+    dt_free_align(ds_in);
+    dt_free_align(ds_luminance);
+    compute_luminance_mask(in, luminance, width, height, d);
+    return;
+  }
+
+  // keep the filter footprint invariant on the coarse grid
+  dt_iop_toneequalizer_data_t ds_d = *d;
+  ds_d.radius = MAX(d->radius / 4, 1);
+
+  interpolate_bilinear(in, width, height, ds_in, ds_width, ds_height, 4);
+  compute_luminance_mask(ds_in, ds_luminance, ds_width, ds_height, &ds_d);
+  interpolate_bilinear(ds_luminance, ds_width, ds_height, luminance, width, height, 1);
+
+  dt_free_align(ds_in);
+  dt_free_align(ds_luminance);
+}
+
 /***
  * Actual transfer functions
  **/
@@ -1108,9 +1151,20 @@ void toneeq_process(dt_iop_module_t *self,
 
       if(hash != saved_hash || !luminance_valid)
       {
-        /* compute only if upstream pipe state has changed */
-        compute_luminance_mask(in, luminance, width, height, d);
-        hash_set_get(&hash, &g->ui_preview_hash, &self->gui_lock);
+        if(piece->pipe->type & DT_DEV_PIXELPIPE_FAST)
+        {
+          // interactive scrubbing : trade mask accuracy for speed, and don't
+          // publish the hash so the next regular run redoes the mask at full
+          // quality. parameter changes that don't affect the mask keep
+          // hitting the full-quality cache above
+          compute_luminance_mask_fast(in, luminance, width, height, d);
+        }
+        else
+        {
+          /* compute only if upstream pipe state has changed */
+          compute_luminance_mask(in, luminance, width, height, d);
+          hash_set_get(&hash, &g->ui_preview_hash, &self->gui_lock);
+        }
       }
     }
     else if(piece->pipe->type & DT_DEV_PIXELPIPE_PREVIEW)
@@ -112,7 +112,13 @@ void process(dt_iop_module_t *self, dt_dev_pixelpipe_iop_t *piece, const void *c
   if(inv_sigma_s < 3.0) inv_sigma_s = 3.0;
   inv_sigma_s = 1.0 / inv_sigma_s;
 
-  PermutohedralLattice<3, 2> lattice(size, omp_get_max_threads());
+  // size the lattice's hash tables from the actual grid resolution instead
+  // of the worst case of one simplex per pixel; the range axis runs in log
+  // space from log(1e-6) to roughly log(8), i.e. about 16 log-units
+  const size_t grid_x = (size_t)ceilf(width * inv_sigma_s) + 1;
+  const size_t grid_y = (size_t)ceilf(height * inv_sigma_s) + 1;
+  const size_t grid_z = (size_t)ceilf(16.0f * inv_sigma_r) + 1;
+  PermutohedralLattice<3, 2> lattice(size, omp_get_max_threads(), grid_x * grid_y * grid_z);
 
 // Build I=log(L)
 // and splat into the lattice
@@ -35,6 +35,7 @@
 #include "gui/gtkentry.h"
 #include "iop/iop_api.h"
 #include <assert.h>
+#include <glib/gstdio.h>
 #include <gtk/gtk.h>
 #include <inttypes.h>
 #include <math.h>
@@ -125,6 +126,10 @@ typedef struct dt_iop_watermark_data_t
   char text[512];
   float color[3];
   char font[64];
+  // cached rasterized overlay; as long as parameters and ROI are
+  // unchanged only the composite pass has to run
+  guint8 *cache_image;
+  dt_hash_t cache_hash;
 } dt_iop_watermark_data_t;
 
 typedef struct dt_iop_watermark_gui_data_t
@@ -607,6 +612,29 @@ static gchar *_watermark_get_svgdoc(dt_iop_module_t *self, const dt_iop_watermar
   return svgdata;
 }
 
+/* composite the rasterized ARGB32 overlay over the input buffer */
+static void _composite_overlay(const float *const in,
+                               float *const out,
+                               const guint8 *const sd,
+                               const int ch,
+                               const size_t npixels,
+                               const float opacity)
+{
+  DT_OMP_FOR()
+  for(size_t j = 0; j < npixels; j++)
+  {
+    const float *const i = in + ch*j;
+    float *const o = out + ch*j;
+    const guint8 *const s = sd + 4*j;
+    const float alpha = (s[3] / 255.0f) * opacity;
+    /* svg uses a premultiplied alpha, so only use opacity for the blending */
+    o[0] = ((1.0f - alpha) * i[0]) + (opacity * (s[2] / 255.0f));
+    o[1] = ((1.0f - alpha) * i[1]) + (opacity * (s[1] / 255.0f));
+    o[2] = ((1.0f - alpha) * i[2]) + (opacity * (s[0] / 255.0f));
+    o[3] = in[3];
+  }
+}
+
 void process(dt_iop_module_t *self,
              dt_dev_pixelpipe_iop_t *piece,
              const void *const ivoid,
@@ -673,6 +701,44 @@ void process(dt_iop_module_t *self,
     }
   }
 
+  // hash everything the rasterized overlay depends on: the expanded svg
+  // document (which covers the marker content, parameter substitutions
+  // and per-image variables) resp. the png file identity, the layout
+  // parameters and the ROI. on a match we reuse the cached rendering and
+  // only run the composite pass -- the cairo/rsvg work below is
+  // serialized on the plugin lock and dominates exports otherwise.
+  dt_hash_t hash = dt_hash(DT_INITHASH,
+                           (const char *)data
+                             + offsetof(dt_iop_watermark_data_t, scale),
+                           offsetof(dt_iop_watermark_data_t, cache_image)
+                             - offsetof(dt_iop_watermark_data_t, scale));
+  if(svgdoc)
+    hash = dt_hash(hash, svgdoc, strlen(svgdoc));
+  else
+  {
+    // the png is re-read from disk on every rendering, key on its identity
+    GStatBuf st;
+    if(!g_stat(filename, &st))
+    {
+      hash = dt_hash(hash, &st.st_mtime, sizeof(st.st_mtime));
+      hash = dt_hash(hash, &st.st_size, sizeof(st.st_size));
+    }
+  }
+  const int32_t geometry[6] = { roi_out->width, roi_out->height,
+                                roi_in->x, roi_in->y,
+                                piece->buf_in.width, piece->buf_in.height };
+  hash = dt_hash(hash, geometry, sizeof(geometry));
+  hash = dt_hash(hash, &roi_out->scale, sizeof(roi_out->scale));
+
+  if(data->cache_image && data->cache_hash == hash)
+  {
+    g_free(svgdoc);
+    _composite_overlay(in, out, data->cache_image, ch,
+                       (size_t)roi_out->width * roi_out->height,
+                       data->opacity / 100.0f);
+    return;
+  }
+
   /* setup stride for performance */
   const int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, roi_out->width);
   if(stride == -1)
@@ -1029,26 +1095,17 @@ void process(dt_iop_module_t *self,
   cairo_surface_flush(surface);
 
   /* render surface on output */
-  guint8 *sd = image;
-  const float opacity = data->opacity / 100.0f;
-  DT_OMP_FOR()
-  for(int j = 0; j < roi_out->height * roi_out->width; j++)
-  {
-    float *const i = in + ch*j;
-    float *const o = out + ch*j;
-    guint8 *const s = sd + 4*j;
-    const float alpha = (s[3] / 255.0f) * opacity;
-    /* svg uses a premultiplied alpha, so only use opacity for the blending */
-    o[0] = ((1.0f - alpha) * i[0]) + (opacity * (s[2] / 255.0f));
-    o[1] = ((1.0f - alpha) * i[1]) + (opacity * (s[1] / 255.0f));
-    o[2] = ((1.0f - alpha) * i[2]) + (opacity * (s[0] / 255.0f));
-    o[3] = in[3];
-    }
+  _composite_overlay(in, out, image, ch,
+                     (size_t)roi_out->width * roi_out->height,
+                     data->opacity / 100.0f);
 
   /* clean up */
   cairo_surface_destroy(surface);
   cairo_surface_destroy(surface_two);
-  g_free(image);
+  /* keep the rasterization for the next run with the same setup */
+  g_free(data->cache_image);
+  data->cache_image = image;
+  data->cache_hash = hash;
   if(type == DT_WTM_SVG)
   {
     g_free(image_two);
@@ -1267,11 +1324,15 @@ void init_pipe(dt_iop_module_t *self,
                dt_dev_pixelpipe_t *pipe,
                dt_dev_pixelpipe_iop_t *piece)
 {
-  piece->data = malloc(sizeof(dt_iop_watermark_data_t));
+  // calloc so that the padding inside the struct is deterministic, the
+  // overlay cache hashes the parameter block as a whole
+  piece->data = calloc(1, sizeof(dt_iop_watermark_data_t));
 }
 
 void cleanup_pipe(dt_iop_module_t *self, dt_dev_pixelpipe_t *pipe, dt_dev_pixelpipe_iop_t *piece)
 {
+  dt_iop_watermark_data_t *d = piece->data;
+  g_free(d->cache_image);
   free(piece->data);
   piece->data = NULL;
 }
@@ -81,6 +81,9 @@ typedef struct dt_lib_collect_t
 
   GtkTreeView *view;
   int view_rule;
+  // signature of the data currently held in the tree store, used to
+  // skip identical rebuilds
+  dt_hash_t tree_hash;
 
   GtkTreeModel *treefilter;
   GtkTreeModel *listfilter;
@@ -1391,12 +1394,6 @@ static void _tree_view(dt_lib_collect_rule_t *dr)
     GtkTreeIter uncategorized = { 0 };
     GtkTreeIter temp;
 
-    g_object_ref(model);
-    g_object_unref(d->treefilter);
-    gtk_tree_view_set_model(GTK_TREE_VIEW(d->view), NULL);
-    gtk_tree_store_clear(GTK_TREE_STORE(model));
-    gtk_widget_hide(GTK_WIDGET(d->view));
-
     /* query construction */
     gchar *where_ext = dt_collection_get_extended_where(darktable.collection, dr->num);
     gchar *query = NULL;
@@ -1605,6 +1602,37 @@ static void _tree_view(dt_lib_collect_rule_t *dr)
     if(!sort_descend)
       sorted_names = g_list_reverse(sorted_names);
 
+    // signature of the data about to feed the tree. when it matches what
+    // the store already holds we keep the built tree instead of paying a
+    // full clear and reinsertion of possibly thousands of rows
+    dt_hash_t content_hash = dt_hash(DT_INITHASH, &property, sizeof(property));
+    content_hash = dt_hash(content_hash, &sort_descend, sizeof(sort_descend));
+    for(GList *names = sorted_names; names; names = g_list_next(names))
+    {
+      name_key_tuple_t *tuple = names->data;
+      if(tuple->name)
+        content_hash = dt_hash(content_hash, tuple->name, strlen(tuple->name));
+      content_hash = dt_hash(content_hash, &tuple->count, sizeof(tuple->count));
+      content_hash = dt_hash(content_hash, &tuple->status, sizeof(tuple->status));
+    }
+    const gboolean unchanged = content_hash == d->tree_hash;
+
+    if(unchanged)
+    {
+      // nothing to insert below, the existing store stays valid
+      g_list_free_full(sorted_names, free_tuple);
+      sorted_names = NULL;
+    }
+    else
+    {
+      g_object_ref(model);
+      g_object_unref(d->treefilter);
+      gtk_tree_view_set_model(GTK_TREE_VIEW(d->view), NULL);
+      gtk_tree_store_clear(GTK_TREE_STORE(model));
+      gtk_widget_hide(GTK_WIDGET(d->view));
+      d->tree_hash = content_hash;
+    }
+
     const gboolean no_uncategorized =
       (property == DT_COLLECTION_PROP_TAG)
       ? dt_conf_get_bool("plugins/lighttable/tagging/no_uncategorized")
@@ -1753,7 +1781,8 @@ static void _tree_view(dt_lib_collect_rule_t *dr)
 
     gtk_tree_view_set_tooltip_column(GTK_TREE_VIEW(d->view), DT_LIB_COLLECT_COL_TOOLTIP);
 
-    d->treefilter = _create_filtered_model(model, dr);
+    if(!unchanged)
+      d->treefilter = _create_filtered_model(model, dr);
 
     GtkTreeSelection *selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(d->view));
     if(property == DT_COLLECTION_PROP_DAY || _is_time_property(property))
@@ -1769,7 +1798,7 @@ static void _tree_view(dt_lib_collect_rule_t *dr)
     gtk_widget_set_no_show_all(GTK_WIDGET(d->view), FALSE);
     gtk_widget_show_all(GTK_WIDGET(d->view));
 
-    g_object_unref(model);
+    if(!unchanged) g_object_unref(model);
     g_strfreev(last_tokens);
     d->view_rule = property;
   }
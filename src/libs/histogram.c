@@ -179,6 +179,9 @@ typedef struct dt_lib_histogram_t
   dt_lib_histogram_scale_t hue_ring_scale;
   dt_lib_histogram_vectorscope_type_t hue_ring_colorspace;
   double vectorscope_radius;
+  // state of input and scope settings of the last recompute, lets us
+  // skip the work entirely when neither changed
+  dt_hash_t input_hash;
   dt_pthread_mutex_t lock;
   GtkWidget *scope_draw;               // GtkDrawingArea -- scope, scale, and draggable overlays
   GtkWidget *button_box_main;          // GtkBox -- contains scope control buttons
@@ -937,10 +940,42 @@ static void dt_lib_histogram_process
     memset(d->histogram, 0, sizeof(uint32_t) * 4 * HISTOGRAM_BINS);
     d->waveform_bins = 0;
     d->vectorscope_radius = 0.f;
+    d->input_hash = DT_INVALID_HASH;
     dt_pthread_mutex_unlock(&d->lock);
     return;
   }
 
+  // bound the number of samples feeding the scopes: beyond a couple of
+  // megapixels additional input only burns time in the colorspace
+  // transform and the binning without visibly changing the result
+  const size_t max_samples = 2000000;
+  int sample_step = 1;
+  while((size_t)(width / sample_step) * (height / sample_step) > max_samples)
+    sample_step++;
+  const float *in = input;
+  float *decimated = NULL;
+  if(sample_step > 1)
+  {
+    const int dec_width = width / sample_step;
+    const int dec_height = height / sample_step;
+    decimated = dt_alloc_align_float((size_t)4 * dec_width * dec_height);
+    if(decimated)
+    {
+      DT_OMP_FOR()
+      for(int y = 0; y < dec_height; y++)
+      {
+        const float *const restrict inrow =
+          input + (size_t)4 * width * y * sample_step;
+        float *const restrict outrow = decimated + (size_t)4 * dec_width * y;
+        for(int x = 0; x < dec_width; x++)
+          copy_pixel(outrow + 4 * x, inrow + (size_t)4 * x * sample_step);
+      }
+      in = decimated;
+      width = dec_width;
+      height = dec_height;
+    }
+  }
+
   // FIXME: scope goes black when click histogram lib colorpicker on
   // -- is this meant to happen?
   //
@@ -997,13 +1032,6 @@ static void dt_lib_histogram_process
     }
   }
 
-  // Convert pixelpipe output in display RGB to histogram profile. If
-  // in tether view, then the image is already converted by the
-  // caller.
-
-  float *img_display = dt_alloc_align_float((size_t)4 * width * height);
-  if(!img_display) return;
-
   // FIXME: we might get called with profile_info_to == NULL due to caller errors
   if(!profile_info_to)
   {
@@ -1019,7 +1047,41 @@ static void dt_lib_histogram_process
 
   const dt_iop_order_iccprofile_info_t *profile_info_out = !profile_info_to ? fallback : profile_info_to;
 
-  dt_ioppr_transform_image_colorspace_rgb(input, img_display, width, height,
+  // everything the scope depends on goes into the hash; if nothing
+  // changed since last time (e.g. the pipe re-ran from its cache) we
+  // skip the transform and the binning altogether
+  dt_hash_t hash = dt_hash(DT_INITHASH, &roi, sizeof(roi));
+  hash = dt_hash(hash, &d->scope_type, sizeof(d->scope_type));
+  hash = dt_hash(hash, &d->scope_orient, sizeof(d->scope_orient));
+  hash = dt_hash(hash, &d->vectorscope_type, sizeof(d->vectorscope_type));
+  hash = dt_hash(hash, &d->vectorscope_scale, sizeof(d->vectorscope_scale));
+  hash = dt_hash(hash, &profile_info_from, sizeof(profile_info_from));
+  hash = dt_hash(hash, &profile_info_out, sizeof(profile_info_out));
+  hash = dt_hash(hash, in, sizeof(float) * 4 * width * height);
+
+  dt_pthread_mutex_lock(&d->lock);
+  const gboolean unchanged = hash == d->input_hash;
+  dt_pthread_mutex_unlock(&d->lock);
+  if(unchanged)
+  {
+    if(decimated) dt_free_align(decimated);
+    dt_show_times_f(&start, "[histogram]", "unchanged %s",
+                    dt_lib_histogram_scope_type_names[d->scope_type]);
+    return;
+  }
+
+  // Convert pixelpipe output in display RGB to histogram profile. If
+  // in tether view, then the image is already converted by the
+  // caller.
+
+  float *img_display = dt_alloc_align_float((size_t)4 * width * height);
+  if(!img_display)
+  {
+    if(decimated) dt_free_align(decimated);
+    return;
+  }
+
+  dt_ioppr_transform_image_colorspace_rgb(in, img_display, width, height,
                                             profile_info_from, profile_info_out, "final histogram");
   dt_pthread_mutex_lock(&d->lock);
   switch(d->scope_type)
@@ -1040,8 +1102,10 @@ static void dt_lib_histogram_process
       dt_unreachable_codepath();
       break;
   }
+  d->input_hash = hash;
   dt_pthread_mutex_unlock(&d->lock);
   dt_free_align(img_display);
+  if(decimated) dt_free_align(decimated);
 
   dt_show_times_f(&start, "[histogram]", "final %s",
                   dt_lib_histogram_scope_type_names[d->scope_type]);
@@ -177,6 +177,9 @@ typedef struct dt_lib_import_t
 
   gboolean is_importing;
   GList *to_be_visited;
+  // set of "filename-datetime" ids of already imported images, fetched
+  // once per enumeration so every candidate file is a hash lookup
+  GHashTable *imported_ids;
 
 #ifdef USE_LUA
   GtkWidget *extra_lua_widgets;
@@ -459,12 +462,13 @@ static GdkPixbuf *_import_get_thumbnail(const gchar *filename)
 
   // Step 1: try to check whether the image contains embedded thumbnail
   // In case it has, we'll use that thumbnail to show on the dialog
+  dt_image_orientation_t orientation = ORIENTATION_NONE;
   if(!no_preview_fallback)
   {
     uint8_t *buffer = NULL;
     size_t size = 0;
     char *mime_type = NULL;
-    if(!dt_exif_get_thumbnail(filename, &buffer, &size, &mime_type))
+    if(!dt_exif_get_thumbnail(filename, &buffer, &size, &mime_type, &orientation))
     {
       // Scale the image to the correct size
       GdkPixbuf *tmp;
@@ -501,22 +505,20 @@ static GdkPixbuf *_import_get_thumbnail(const gchar *filename)
   // we need to find out the rotation as well
   if(have_preview && !no_preview_fallback)
   {
-    // get image orientation
-    dt_image_t img = { 0 };
-    (void)dt_exif_read(&img, filename);
-
-    // Rotate the image to the correct orientation
+    // Rotate the image to the correct orientation. We already got the
+    // orientation together with the thumbnail above, so there is no
+    // need to run the whole exif parser on the file a second time.
     GdkPixbuf *tmp = pixbuf;
 
-    if(img.orientation == ORIENTATION_ROTATE_CCW_90_DEG)
+    if(orientation == ORIENTATION_ROTATE_CCW_90_DEG)
     {
       tmp = gdk_pixbuf_rotate_simple(pixbuf, GDK_PIXBUF_ROTATE_COUNTERCLOCKWISE);
     }
-    else if(img.orientation == ORIENTATION_ROTATE_CW_90_DEG)
+    else if(orientation == ORIENTATION_ROTATE_CW_90_DEG)
     {
       tmp = gdk_pixbuf_rotate_simple(pixbuf, GDK_PIXBUF_ROTATE_CLOCKWISE);
     }
-    else if(img.orientation == ORIENTATION_ROTATE_180_DEG)
+    else if(orientation == ORIENTATION_ROTATE_180_DEG)
     {
       tmp = gdk_pixbuf_rotate_simple(pixbuf, GDK_PIXBUF_ROTATE_UPSIDEDOWN);
     }
@@ -785,6 +787,11 @@ static void _import_add_file_callback(GObject *direnum,
         count_sel = d->from.nb;
       }
       d->is_importing = FALSE;
+      if(d->imported_ids)
+      {
+        g_hash_table_destroy(d->imported_ids);
+        d->imported_ids = NULL;
+      }
       _import_active(self, TRUE, count_sel);
       _update_images_number(self, count_sel);
 
@@ -877,7 +884,10 @@ static void _import_add_file_callback(GObject *direnum,
             gchar *basename = g_path_get_basename(filename);
             char dtid[DT_DATETIME_EXIF_LENGTH];
             dt_datetime_unix_to_exif(dtid, sizeof(dtid), &datetime);
-            already_imported = dt_metadata_already_imported(basename, dtid);
+            gchar *id = g_strconcat(basename, "-", dtid, NULL);
+            already_imported = d->imported_ids
+                               && g_hash_table_contains(d->imported_ids, id);
+            g_free(id);
             g_free(basename);
           }
 
@@ -902,6 +912,10 @@ static void _import_add_file_callback(GObject *direnum,
     }
 
     g_free(folder);
+
+    // keep the dialog alive while enumeration streams in: show the
+    // growing number of found images after every block
+    _update_images_number(self, 0);
   }
   g_list_free(file_list);
 }
@@ -970,6 +984,13 @@ static void _import_set_file_list_start(const gchar *folder,
   d->to_be_visited = NULL;
   d->is_importing = TRUE;
 
+  // fetch the ids of already imported images in one pass up front
+  // instead of one database scan per enumerated file
+  if(d->imported_ids) g_hash_table_destroy(d->imported_ids);
+  d->imported_ids = d->import_case == DT_IMPORT_INPLACE
+                    ? NULL
+                    : dt_metadata_already_imported_set();
+
   // new selected folder, disable the thumb display button
   gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(d->from.thumbs), FALSE);
 
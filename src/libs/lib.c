@@ -871,6 +871,10 @@ void dt_lib_gui_update(dt_lib_module_t *module)
 static void dt_lib_init_module(void *m)
 {
   dt_lib_module_t *module = (dt_lib_module_t *)m;
+
+  dt_times_t start = { 0 };
+  dt_get_perf_times(&start);
+
   dt_lib_init_presets(module);
 
   // Calling the keyboard shortcut initialization callback if present
@@ -887,6 +891,10 @@ static void dt_lib_init_module(void *m)
                          G_CALLBACK(_lib_draw_callback), module);
     }
   }
+
+  // startup cost per panel module, helps spotting what delays the
+  // first window
+  dt_show_times_f(&start, "[dt_lib_init_module]", "'%s'", module->plugin_name);
 }
 
 void _lib_unload_module(dt_lib_module_t *module)
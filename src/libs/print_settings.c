@@ -565,12 +565,18 @@ static int _print_job_run(dt_job_t *job)
 
   for(int k=0; k<params->imgs.count; k++)
   {
+    if(dt_control_job_get_state(job) == DT_JOB_STATE_CANCELLED)
+      return 0;
+
     if(dt_is_valid_imgid(params->imgs.box[k].imgid))
     {
       if(!dt_is_valid_imgid(imgid)) imgid = params->imgs.box[k].imgid;
       if(_export_and_setup_pos(job, &params->imgs.box[k], k))
         return 1;
     }
+
+    // the export of the images is by far the longest part of the job
+    dt_control_job_set_progress(job, 0.05 + 0.85 * (k + 1) / params->imgs.count);
   }
 
   if(dt_control_job_get_state(job) == DT_JOB_STATE_CANCELLED)
@@ -59,6 +59,11 @@ typedef struct dt_lib_snapshot_t
   float scale;
   size_t width, height;
   dt_dev_zoom_pos_t zoom_pos;
+  // the snapshot composited for the current view context, so dragging
+  // the split line only blits instead of re-transforming the buffer
+  cairo_surface_t *surface;
+  dt_view_context_t surface_ctx;
+  int32_t surface_width, surface_height;
 } dt_lib_snapshot_t;
 
 typedef struct dt_lib_snapshots_t
@@ -169,6 +174,13 @@ static void _draw_sym(cairo_t *cr,
   g_object_unref(layout);
 }
 
+static void _invalidate_snapshot_surface(dt_lib_snapshot_t *s)
+{
+  if(s->surface) cairo_surface_destroy(s->surface);
+  s->surface = NULL;
+  s->surface_ctx = 0;
+}
+
 static gboolean _snap_expose_again(gpointer user_data)
 {
   dt_lib_snapshots_t *d = (dt_lib_snapshots_t *)user_data;
@@ -233,6 +245,7 @@ void gui_post_expose(dt_lib_module_t *self,
     {
       dt_free_align(snap->buf);
       snap->buf = NULL;
+      _invalidate_snapshot_surface(snap);
 
       // export image with proper size
       dt_dev_image(snap->imgid, width, height,
@@ -301,8 +314,43 @@ void gui_post_expose(dt_lib_module_t *self,
 
     if(snap->buf)
     {
-      dt_view_paint_surface(cri, width, height, &dev->full, DT_WINDOW_MAIN,
-                            snap->buf, snap->scale, snap->width, snap->height, snap->zoom_pos);
+      /* the painted snapshot only depends on the view context that
+         also keyed the buffer, so composite it once into an offscreen
+         surface and just blit that on further exposes; this keeps
+         dragging the split line fluid even on large canvases */
+      if(!snap->surface
+         || snap->surface_ctx != ctx
+         || snap->surface_width != width
+         || snap->surface_height != height)
+      {
+        _invalidate_snapshot_surface(snap);
+        cairo_surface_t *surface =
+          cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+        if(cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS)
+        {
+          cairo_t *cst = cairo_create(surface);
+          dt_view_paint_surface(cst, width, height, &dev->full, DT_WINDOW_MAIN,
+                                snap->buf, snap->scale,
+                                snap->width, snap->height, snap->zoom_pos);
+          cairo_destroy(cst);
+          snap->surface = surface;
+          snap->surface_ctx = ctx;
+          snap->surface_width = width;
+          snap->surface_height = height;
+        }
+        else
+          cairo_surface_destroy(surface);
+      }
+
+      if(snap->surface)
+      {
+        cairo_set_source_surface(cri, snap->surface, 0, 0);
+        cairo_paint(cri);
+      }
+      else
+        dt_view_paint_surface(cri, width, height, &dev->full, DT_WINDOW_MAIN,
+                              snap->buf, snap->scale,
+                              snap->width, snap->height, snap->zoom_pos);
     }
 
     cairo_restore(cri);
@@ -628,6 +676,7 @@ static void _clear_snapshot_entry(dt_lib_snapshot_t *s)
   g_free(s->module);
   g_free(s->label);
   dt_free_align(s->buf);
+  _invalidate_snapshot_surface(s);
   s->module = NULL;
   s->label = NULL;
   s->buf = NULL;
@@ -26,6 +26,35 @@
 #include "lua/image.h"
 
 
+typedef struct _event_timing_t
+{
+  guint count;
+  double total;
+  double max;
+} _event_timing_t;
+
+// per-event dispatch statistics; only touched with the lua lock held
+static GHashTable *_event_timings = NULL;
+
+static void _event_record_timing(const char *event, const double elapsed)
+{
+  if(!_event_timings)
+    _event_timings = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  _event_timing_t *timing = g_hash_table_lookup(_event_timings, event);
+  if(!timing)
+  {
+    timing = g_malloc0(sizeof(_event_timing_t));
+    g_hash_table_insert(_event_timings, g_strdup(event), timing);
+  }
+  timing->count++;
+  timing->total += elapsed;
+  timing->max = MAX(timing->max, elapsed);
+  dt_print(DT_DEBUG_LUA,
+           "[lua] event `%s' handled in %.3fs"
+           " (%u dispatches, %.3fs total, %.3fs max)",
+           event, elapsed, timing->count, timing->total, timing->max);
+}
+
 void dt_lua_event_trigger(lua_State *L, const char *event, int nargs)
 {
   // 1  event name
@@ -62,8 +91,10 @@ void dt_lua_event_trigger(lua_State *L, const char *event, int nargs)
   lua_pushstring(L, event);
   for(int i = 1; i <= nargs; i++) lua_pushvalue(L, -6 -nargs);
 
-  // call the event handler
+  // call the event handler, keeping track of how long the scripts took
+  const double start = dt_get_wtime();
   dt_lua_treated_pcall(L,nargs+2,0);
+  _event_record_timing(event, dt_get_wtime() - start);
 
   // clean up the stack
   lua_pop(L, nargs + 3);
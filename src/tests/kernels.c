@@ -0,0 +1,203 @@
+/*
+    This file is part of darktable,
+    Copyright (C) 2026 darktable developers.
+
+    darktable is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    darktable is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with darktable.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// microbenchmarks for the primitive kernels in src/common/, isolated
+// from the pixelpipe.  each kernel is warmed up once and then timed
+// over a number of repetitions (default 5, override with the first
+// commandline argument); the minimum and mean wall time plus the
+// throughput at the minimum are printed in a stable column format so
+// successive runs can be diffed or tracked over time.  the input data
+// is deterministic, so results are comparable between machines.
+
+#include "common/box_filters.h"
+#include "common/colorspaces_inline_conversions.h"
+#include "common/darktable.h"
+#include "common/dwt.h"
+#include "common/eaw.h"
+#include "common/gaussian.h"
+#include "common/imagebuf.h"
+#include "common/interpolation.h"
+#include "common/nlmeans_core.h"
+#include "develop/pixelpipe.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include "win/main_wrapper.h"
+#endif
+
+// 3:2 aspect, ~2.8 Mpix -- roughly a darkroom view of a 24 Mpix raw
+#define BENCH_WIDTH 2048
+#define BENCH_HEIGHT 1366
+
+static int reps = 5;
+
+typedef struct bench_buffers_t
+{
+  float *in;      // deterministic input data, never written by a benchmark
+  float *out;     // output and in-place working buffer
+  float *scratch; // secondary buffer for kernels needing a third plane
+} bench_buffers_t;
+
+typedef void (*bench_func)(bench_buffers_t *b);
+
+// deterministic pseudo-random fill so every run sees the same data
+static void _fill(float *const buf, const size_t count)
+{
+  uint32_t state = 0x2545f491u;
+  for(size_t i = 0; i < count; i++)
+  {
+    state = state * 1664525u + 1013904223u;
+    buf[i] = (float)(state >> 8) / (float)(1u << 24);
+  }
+}
+
+static void _run(const char *name, const double mpix, bench_func fn, bench_buffers_t *b)
+{
+  fn(b); // warm up caches and lazy initializations
+  double tmin = INFINITY;
+  double tsum = 0.0;
+  for(int r = 0; r < reps; r++)
+  {
+    const double start = dt_get_wtime();
+    fn(b);
+    const double wall = dt_get_wtime() - start;
+    tmin = MIN(tmin, wall);
+    tsum += wall;
+  }
+  printf("%-24s min=%9.3fms mean=%9.3fms %9.1f Mpix/s\n",
+         name, 1000.0 * tmin, 1000.0 * tsum / reps, mpix / tmin);
+}
+
+static void _bench_box_mean(bench_buffers_t *b)
+{
+  dt_iop_image_copy(b->out, b->in, (size_t)4 * BENCH_WIDTH * BENCH_HEIGHT);
+  dt_box_mean(b->out, BENCH_HEIGHT, BENCH_WIDTH, 4, 16, 2);
+}
+
+static void _bench_gaussian(bench_buffers_t *b)
+{
+  const float min[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+  const float max[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+  dt_gaussian_t *g = dt_gaussian_init(BENCH_WIDTH, BENCH_HEIGHT, 4, max, min, 5.0f, DT_IOP_GAUSSIAN_ZERO);
+  if(!g) return;
+  dt_gaussian_blur_4c(g, b->in, b->out);
+  dt_gaussian_free(g);
+}
+
+static void _bench_eaw(bench_buffers_t *b)
+{
+  const dt_aligned_pixel_t threshold = { 0.01f, 0.01f, 0.01f, 0.01f };
+  const dt_aligned_pixel_t boost = { 1.0f, 1.0f, 1.0f, 1.0f };
+  memset(b->scratch, 0, sizeof(float) * 4 * BENCH_WIDTH * BENCH_HEIGHT);
+  eaw_decompose_and_synthesize(b->out, b->in, b->scratch, 2, 0.0f, threshold, boost,
+                               FALSE, BENCH_WIDTH, BENCH_HEIGHT);
+}
+
+static void _bench_dwt(bench_buffers_t *b)
+{
+  dt_iop_image_copy(b->out, b->in, (size_t)4 * BENCH_WIDTH * BENCH_HEIGHT);
+  dwt_params_t *p = dt_dwt_init(b->out, BENCH_WIDTH, BENCH_HEIGHT, 4, 5, 0, 0, NULL, 1.0f);
+  if(!p) return;
+  dwt_decompose(p, NULL);
+  dt_dwt_free(p);
+}
+
+// non-local means is by far the slowest kernel, run it on a quarter image
+static void _bench_nlmeans(bench_buffers_t *b)
+{
+  const dt_iop_roi_t roi = { 0, 0, BENCH_WIDTH / 2, BENCH_HEIGHT / 2, 1.0f };
+  const float norm[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+  const dt_nlmeans_param_t params = { .scattering = 0.0f,
+                                      .scale = 1.0f,
+                                      .luma = 1.0f,
+                                      .chroma = 1.0f,
+                                      .center_weight = -1.0f,
+                                      .sharpness = 0.5f,
+                                      .patch_radius = 2,
+                                      .search_radius = 7,
+                                      .decimate = 0,
+                                      .norm = norm,
+                                      .pipetype = DT_DEV_PIXELPIPE_EXPORT };
+  nlmeans_denoise(b->in, b->out, &roi, &roi, &params);
+}
+
+static void _bench_resample(bench_buffers_t *b)
+{
+  const dt_interpolation_t *itor = dt_interpolation_new(DT_INTERPOLATION_LANCZOS3);
+  const dt_iop_roi_t roi_in = { 0, 0, BENCH_WIDTH, BENCH_HEIGHT, 1.0f };
+  const dt_iop_roi_t roi_out = { 0, 0, BENCH_WIDTH / 2, BENCH_HEIGHT / 2, 0.5f };
+  dt_interpolation_resample(itor, b->out, &roi_out, b->in, &roi_in);
+}
+
+static void _bench_xyz_to_lab(bench_buffers_t *b)
+{
+  const size_t npixels = (size_t)BENCH_WIDTH * BENCH_HEIGHT;
+  DT_OMP_FOR()
+  for(size_t i = 0; i < npixels; i++)
+    dt_XYZ_to_Lab(b->in + 4 * i, b->out + 4 * i);
+}
+
+int main(int argc, char *argv[])
+{
+  char *argv_override[] = {"darktable-bench-kernels", "--library", ":memory:", "--conf", "write_sidecar_files=never", NULL};
+  int argc_override = sizeof(argv_override) / sizeof(*argv_override) - 1;
+
+  // init dt without gui and without data.db:
+  if(dt_init(argc_override, argv_override, FALSE, FALSE, NULL)) exit(1);
+
+  if(argc > 1) reps = MAX(atoi(argv[1]), 1);
+
+  const size_t npixels = (size_t)BENCH_WIDTH * BENCH_HEIGHT;
+  bench_buffers_t b = { .in = dt_alloc_align_float(4 * npixels),
+                        .out = dt_alloc_align_float(4 * npixels),
+                        .scratch = dt_alloc_align_float(4 * npixels) };
+  if(!b.in || !b.out || !b.scratch)
+  {
+    fprintf(stderr, "can't allocate benchmark buffers\n");
+    exit(1);
+  }
+  _fill(b.in, 4 * npixels);
+
+  const double mpix = (double)npixels / 1e6;
+  printf("benchmarking %dx%d buffers, %d repetitions\n", BENCH_WIDTH, BENCH_HEIGHT, reps);
+
+  _run("box_mean r=16 it=2", mpix, _bench_box_mean, &b);
+  _run("gaussian_4c sigma=5", mpix, _bench_gaussian, &b);
+  _run("eaw_decompose s=2", mpix, _bench_eaw, &b);
+  _run("dwt_decompose 5 scales", mpix, _bench_dwt, &b);
+  _run("nlmeans p=2 s=7", mpix / 4.0, _bench_nlmeans, &b);
+  _run("resample lanczos3 0.5x", mpix, _bench_resample, &b);
+  _run("XYZ_to_Lab", mpix, _bench_xyz_to_lab, &b);
+
+  dt_free_align(b.in);
+  dt_free_align(b.out);
+  dt_free_align(b.scratch);
+
+  dt_cleanup();
+
+  return 0;
+}
+// clang-format off
+// modelines: These editor modelines have been set for all relevant files by tools/update_modelines.py
+// vim: shiftwidth=2 expandtab tabstop=2 cindent
+// kate: tab-indents: off; indent-width 2; replace-tabs on; indent-mode cstyle; remove-trailing-spaces modified;
+// clang-format on
@@ -29,6 +29,7 @@
 #include "common/history.h"
 #include "common/image_cache.h"
 #include "common/overlay.h"
+#include "common/resource_limits.h"
 #include "common/selection.h"
 #include "common/styles.h"
 #include "common/tags.h"
@@ -948,6 +949,39 @@ static void _fire_darkroom_image_loaded_event(const bool clean,
 
 static gboolean _dev_load_requested_image(gpointer user_data);
 
+/* speculatively decode the filmstrip neighbors of imgid into the mipmap
+   cache from a background job, so stepping through images with
+   space/arrow finds the full buffer already present and the pipes start
+   immediately instead of waiting for the raw decode. */
+static void _dev_prefetch_neighbors(const dt_imgid_t imgid)
+{
+  if(!dt_conf_get_bool("darkroom/ui/prefetch_neighbors")) return;
+
+  sqlite3_stmt *stmt;
+  // clang-format off
+  gchar *query =
+    g_strdup_printf("SELECT imgid "
+                    "FROM memory.collected_images "
+                    "WHERE rowid BETWEEN (SELECT rowid "
+                    "                       FROM memory.collected_images"
+                    "                       WHERE imgid=%d)-1 "
+                    "              AND (SELECT rowid "
+                    "                     FROM memory.collected_images"
+                    "                     WHERE imgid=%d)+1",
+                    imgid, imgid);
+  // clang-format on
+  DT_DEBUG_SQLITE3_PREPARE_V2(dt_database_get(darktable.db), query, -1, &stmt, NULL);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    const dt_imgid_t neighbor = sqlite3_column_int(stmt, 0);
+    if(neighbor != imgid && dt_is_valid_imgid(neighbor))
+      dt_control_add_job(DT_JOB_QUEUE_SYSTEM_BG,
+                         dt_image_load_job_create(neighbor, DT_MIPMAP_FULL));
+  }
+  g_free(query);
+  sqlite3_finalize(stmt);
+}
+
 static void _dev_change_image(dt_develop_t *dev,
                               const dt_imgid_t imgid)
 {
@@ -1041,6 +1075,9 @@ static void _dev_change_image(dt_develop_t *dev,
   darktable.develop->autosave_time = dt_get_wtime() + 10.0;
 
   g_idle_add(_dev_load_requested_image, dev);
+
+  // while the new image loads, warm the raw decodes of its neighbors
+  _dev_prefetch_neighbors(imgid);
 }
 
 static gboolean _dev_load_requested_image(gpointer user_data)
@@ -2999,6 +3036,9 @@ void enter(dt_view_t *self)
   // prevent accels_window to refresh
   darktable.view_manager->accels_window.prevent_refresh = TRUE;
 
+  // shift cache budget from thumbnails to the pixelpipes
+  dt_governor_set_focus(DT_GOVERNOR_FOCUS_PIPE);
+
   // clean the undo list
   dt_undo_clear(darktable.undo, DT_UNDO_DEVELOP);
 
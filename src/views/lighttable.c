@@ -29,6 +29,7 @@
 #include "common/history.h"
 #include "common/image_cache.h"
 #include "common/ratings.h"
+#include "common/resource_limits.h"
 #include "common/selection.h"
 #include "common/undo.h"
 #include "control/conf.h"
@@ -486,6 +487,8 @@ void enter(dt_view_t *self)
     dt_view_lighttable_get_layout(darktable.view_manager);
 
   dt_start_backthumbs_crawler();
+  // shift cache budget back to the thumbnails
+  dt_governor_set_focus(DT_GOVERNOR_FOCUS_THUMBS);
   // enable culling proxy
   darktable.view_manager->proxy.lighttable.culling_preview_refresh =
     _culling_preview_refresh;
@@ -1504,10 +1504,22 @@ static void _view_map_changed_callback_delayed(const gpointer user_data)
       dt_show_times(&start, "[map] dbscan calculation");
 
       // set the clusters
-      gboolean *processed = calloc(num_clusters+1,sizeof(gboolean));
       GList *sel_imgs = dt_act_on_get_images(FALSE, FALSE, FALSE);
-      int group = -1;
-      for(i = 0; i< img_count; i++)
+      // hashed selection lookup instead of a linear list search per image
+      GHashTable *sel_hash = NULL;
+      if(sel_imgs)
+      {
+        sel_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
+        for(GList *l = sel_imgs; l; l = g_list_next(l))
+          g_hash_table_add(sel_hash, l->data);
+      }
+
+      // aggregate every cluster in a single pass over the points instead
+      // of rescanning the whole list once per cluster
+      dt_map_image_t **clusters = calloc(MAX(num_clusters, 1), sizeof(dt_map_image_t *));
+      double *cl_x = calloc(MAX(num_clusters, 1), sizeof(double));
+      double *cl_y = calloc(MAX(num_clusters, 1), sizeof(double));
+      for(i = 0; i < img_count; i++)
       {
         if(p[i].cluster_id == NOISE)
         {
@@ -1520,53 +1532,53 @@ static void _view_map_changed_callback_delayed(const gpointer user_data)
             entry->longitude = rad2deg(p[i].x);
             entry->latitude = rad2deg(p[i].y);
             entry->group_same_loc = TRUE;
-            if(sel_imgs)
-              entry->selected_in_group = g_list_find((GList *)sel_imgs,
-                                                     GINT_TO_POINTER(entry->imgid))
-                                         ? TRUE : FALSE;
+            if(sel_hash)
+              entry->selected_in_group =
+                g_hash_table_contains(sel_hash, GINT_TO_POINTER(entry->imgid));
             lib->images = g_slist_prepend(lib->images, entry);
           }
         }
-        else if(!processed[p[i].cluster_id])
+        else if(clusters && cl_x && cl_y)
         {
-          processed[p[i].cluster_id] = TRUE;
-          group = p[i].cluster_id;
-          dt_map_image_t *entry = calloc(1, sizeof(dt_map_image_t));
-          if(entry)
+          const int group = p[i].cluster_id;
+          dt_map_image_t *entry = clusters[group];
+          if(!entry)
           {
+            entry = calloc(1, sizeof(dt_map_image_t));
+            if(!entry) continue;
+            clusters[group] = entry;
             entry->imgid = p[i].imgid;
-            entry->group = p[i].cluster_id;
+            entry->group = group;
             entry->group_same_loc = TRUE;
-            entry->selected_in_group = (sel_imgs && g_list_find((GList *)sel_imgs,
-                                                                GINT_TO_POINTER(p[i].imgid)))
-                                       ? TRUE : FALSE;
-            const double lon = p[i].x, lat = p[i].y;
-
-            for(int j = 0; j < img_count; j++)
-            {
-              if(p[j].cluster_id == group)
-              {
-                entry->group_count++;
-                entry->longitude += p[j].x;
-                entry->latitude += p[j].y;
-                if(entry->group_same_loc && (p[j].x != lon || p[j].y != lat))
-                {
-                  entry->group_same_loc = FALSE;
-                }
-                if(sel_imgs && !entry->selected_in_group)
-                {
-                  if(g_list_find((GList *)sel_imgs, GINT_TO_POINTER(p[j].imgid)))
-                    entry->selected_in_group = TRUE;
-                }
-              }
-            }
-            entry->latitude = rad2deg(entry->latitude) / entry->group_count;
-            entry->longitude = rad2deg(entry->longitude) / entry->group_count;
-            lib->images = g_slist_prepend(lib->images, entry);
+            // remember the first position to detect mixed locations
+            cl_x[group] = p[i].x;
+            cl_y[group] = p[i].y;
           }
+          entry->group_count++;
+          entry->longitude += p[i].x;
+          entry->latitude += p[i].y;
+          if(entry->group_same_loc && (p[i].x != cl_x[group] || p[i].y != cl_y[group]))
+            entry->group_same_loc = FALSE;
+          if(sel_hash && !entry->selected_in_group)
+            entry->selected_in_group =
+              g_hash_table_contains(sel_hash, GINT_TO_POINTER(p[i].imgid));
+        }
+      }
+      if(clusters)
+      {
+        for(int c = 0; c < num_clusters; c++)
+        {
+          dt_map_image_t *entry = clusters[c];
+          if(!entry) continue;
+          entry->latitude = rad2deg(entry->latitude) / entry->group_count;
+          entry->longitude = rad2deg(entry->longitude) / entry->group_count;
+          lib->images = g_slist_prepend(lib->images, entry);
         }
       }
-      free(processed);
+      free(clusters);
+      free(cl_x);
+      free(cl_y);
+      if(sel_hash) g_hash_table_destroy(sel_hash);
       g_list_free(sel_imgs);
     }
 
@@ -75,6 +75,7 @@ typedef struct dt_slideshow_t
   dt_pthread_mutex_t lock;
 
   gboolean auto_advance;
+  gboolean moving_back; // direction of the last manual step, drives prefetch order
   int exporting;
   int delay;
 
@@ -282,37 +283,33 @@ static int32_t _process_job_run(dt_job_t *job)
 {
   dt_slideshow_t *d = dt_control_job_get_params(job);
 
+  // fill the slots along the direction we are travelling first, so
+  // repeated steps never wait on a slide that was prefetched last
+  static const dt_slideshow_slot_t forward_order[S_SLOT_LAST]
+    = { S_CURRENT, S_RIGHT_M, S_RIGHT, S_LEFT_M, S_LEFT };
+  static const dt_slideshow_slot_t backward_order[S_SLOT_LAST]
+    = { S_CURRENT, S_LEFT_M, S_LEFT, S_RIGHT_M, S_RIGHT };
+
   dt_pthread_mutex_lock(&d->lock);
 
-  if(_is_slot_waiting(d,S_CURRENT))
-  {
-    dt_pthread_mutex_unlock(&d->lock);
-    _process_image(d, S_CURRENT);
-    dt_control_queue_redraw_center();
-  }
-  else if(_is_slot_waiting(d, S_RIGHT_M))
-  {
-    dt_pthread_mutex_unlock(&d->lock);
-    _process_image(d, S_RIGHT_M);
-  }
-  else if(_is_slot_waiting(d, S_RIGHT))
-  {
-    dt_pthread_mutex_unlock(&d->lock);
-    _process_image(d, S_RIGHT);
-  }
-  else if(_is_slot_waiting(d, S_LEFT_M))
-  {
-    dt_pthread_mutex_unlock(&d->lock);
-    _process_image(d, S_LEFT_M);
-  }
-  else if(_is_slot_waiting(d, S_LEFT))
+  const dt_slideshow_slot_t *order = d->moving_back ? backward_order : forward_order;
+  dt_slideshow_slot_t slot = -1;
+
+  for(int k = 0; k < S_SLOT_LAST; k++)
   {
-    dt_pthread_mutex_unlock(&d->lock);
-    _process_image(d, S_LEFT);
+    if(_is_slot_waiting(d, order[k]))
+    {
+      slot = order[k];
+      break;
+    }
   }
-  else
+
+  dt_pthread_mutex_unlock(&d->lock);
+
+  if(slot != -1)
   {
-    dt_pthread_mutex_unlock(&d->lock);
+    _process_image(d, slot);
+    if(slot == S_CURRENT) dt_control_queue_redraw_center();
   }
 
   // any other slot to fill?
@@ -339,6 +336,8 @@ static void _step_state(dt_slideshow_t *d,
 
   gboolean refresh_display = FALSE;
 
+  d->moving_back = (event == S_REQUEST_STEP_BACK);
+
   if(event == S_REQUEST_STEP)
   {
     if(d->buf[S_CURRENT].rank < d->col_count - 1)
@@ -501,6 +500,7 @@ void enter(dt_view_t *self)
   d->col_count = dt_collection_get_count(darktable.collection);
 
   d->auto_advance = FALSE;
+  d->moving_back = FALSE;
   d->delay = dt_conf_get_int("slideshow_delay");
   // restart from beginning, will first increment counter by step and then prefetch
   dt_pthread_mutex_unlock(&d->lock);
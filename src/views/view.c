@@ -709,11 +709,12 @@ void dt_view_set_scrollbar(dt_view_t *view,
   dt_ui_update_scrollbars(darktable.gui->ui);
 }
 
-dt_view_surface_value_t dt_view_image_get_surface(const dt_imgid_t imgid,
-                                                  const int32_t width,
-                                                  const int32_t height,
-                                                  cairo_surface_t **surface,
-                                                  const gboolean quality)
+static dt_view_surface_value_t _view_image_get_surface(const dt_imgid_t imgid,
+                                                       const int32_t width,
+                                                       const int32_t height,
+                                                       cairo_surface_t **surface,
+                                                       const gboolean quality,
+                                                       const gboolean cached_only)
 {
   const double tt = dt_get_debug_wtime();
 
@@ -732,7 +733,21 @@ dt_view_surface_value_t dt_view_image_get_surface(const dt_imgid_t imgid,
 
   // if needed, we load the mimap buffer
   dt_mipmap_buffer_t buf;
-  dt_mipmap_cache_get(&buf, imgid, mip, DT_MIPMAP_BEST_EFFORT, 'r');
+  if(cached_only)
+  {
+    // probe from the matching size downwards and take whatever is
+    // already there; never queue loading or generation jobs
+    buf.buf = NULL;
+    for(int k = mip; k >= DT_MIPMAP_0; k--)
+    {
+      dt_mipmap_cache_get(&buf, imgid, k, DT_MIPMAP_TESTLOCK, 'r');
+      if(buf.buf && buf.width > 0 && buf.height > 0) break;
+      dt_mipmap_cache_release(&buf);
+      buf.buf = NULL;
+    }
+  }
+  else
+    dt_mipmap_cache_get(&buf, imgid, mip, DT_MIPMAP_BEST_EFFORT, 'r');
 
   const int32_t buf_wd = buf.width;
   const int32_t buf_ht = buf.height;
@@ -904,6 +919,23 @@ dt_view_surface_value_t dt_view_image_get_surface(const dt_imgid_t imgid,
   return ret;
 }
 
+dt_view_surface_value_t dt_view_image_get_surface(const dt_imgid_t imgid,
+                                                  const int32_t width,
+                                                  const int32_t height,
+                                                  cairo_surface_t **surface,
+                                                  const gboolean quality)
+{
+  return _view_image_get_surface(imgid, width, height, surface, quality, FALSE);
+}
+
+dt_view_surface_value_t dt_view_image_get_surface_cached(const dt_imgid_t imgid,
+                                                         const int32_t width,
+                                                         const int32_t height,
+                                                         cairo_surface_t **surface)
+{
+  return _view_image_get_surface(imgid, width, height, surface, FALSE, TRUE);
+}
+
 char* dt_view_extend_modes_str(const char * name,
                                const gboolean is_hdr,
                                const gboolean is_bw,
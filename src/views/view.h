@@ -182,6 +182,13 @@ dt_view_surface_value_t dt_view_image_get_surface(const dt_imgid_t imgid,
                                                   cairo_surface_t **surface,
                                                   const gboolean quality);
 
+/** same but only serves mips already in the cache, never queueing loading or
+ * generation jobs. used for cheap placeholders while the thumbtable scrolls fast. */
+dt_view_surface_value_t dt_view_image_get_surface_cached(const dt_imgid_t imgid,
+                                                         const int32_t width,
+                                                         const int32_t height,
+                                                         cairo_surface_t **surface);
+
 
 /** Set the selection bit to a given value for the specified image */
 void dt_view_set_selection(const dt_imgid_t imgid,